@@ -16,6 +16,7 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 
 namespace nntile
 {
@@ -28,17 +29,159 @@ using Index = int64_t;
 using fp64_t = double;
 //! Single precision alias
 using fp32_t = float;
-//! Half precision FP16 mock type
+//! Half precision IEEE FP16 type
+/*! Arithmetics is performed in single precision through implicit
+ * conversions, while conversion back to fp16_t rounds to nearest even.
+ * */
 class fp16_t
 {
-private:
-    int16_t _;
+public:
+    //! Raw bits of the value
+    uint16_t value;
+    //! Default constructor leaves the value uninitialized
+    fp16_t() = default;
+    //! Round single precision value to nearest even fp16_t value
+    fp16_t(fp32_t x)
+        noexcept
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        uint16_t sign = static_cast<uint16_t>((bits>>16) & 0x8000u);
+        uint32_t abs = bits & 0x7fffffffu;
+        uint32_t exp = abs >> 23;
+        // Infinity or NaN, that is kept quiet
+        if(abs >= 0x7f800000u)
+        {
+            value = sign | 0x7c00u | (abs > 0x7f800000u ? 0x0200u : 0u);
+        }
+        // Values that round to infinity
+        else if(abs >= 0x477ff000u)
+        {
+            value = sign | 0x7c00u;
+        }
+        // Normal fp16_t values
+        else if(exp >= 113)
+        {
+            abs += 0x0fffu + ((abs>>13) & 1u);
+            value = sign | static_cast<uint16_t>((abs-0x38000000u) >> 13);
+        }
+        // Subnormal fp16_t values
+        else if(exp >= 102)
+        {
+            uint32_t mant = (abs & 0x007fffffu) | 0x00800000u;
+            uint32_t shift = 126 - exp;
+            uint32_t res = mant >> shift, rem = mant & ((1u<<shift)-1),
+                     half = 1u << (shift-1);
+            if(rem > half or (rem == half and (res & 1u)))
+            {
+                ++res;
+            }
+            value = sign | static_cast<uint16_t>(res);
+        }
+        // Values that round to zero
+        else
+        {
+            value = sign;
+        }
+    }
+    //! Exact conversion into single precision
+    operator fp32_t() const
+        noexcept
+    {
+        uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+        uint32_t exp = (value>>10) & 0x1fu, mant = value & 0x03ffu;
+        uint32_t bits;
+        if(exp == 0x1fu)
+        {
+            bits = sign | 0x7f800000u | (mant<<13);
+        }
+        else if(exp != 0)
+        {
+            bits = sign | ((exp+112) << 23) | (mant<<13);
+        }
+        // Zero or subnormal value
+        else
+        {
+            fp32_t x = static_cast<fp32_t>(mant) * 0x1p-24f;
+            return sign ? -x : x;
+        }
+        fp32_t x;
+        std::memcpy(&x, &bits, sizeof(x));
+        return x;
+    }
+};
+
+//! Brain floating point BF16 type
+/*! Stores upper 16 bits of a single precision value. All the arithmetics is
+ * performed in single precision through implicit conversions, while
+ * conversion back to bf16_t rounds to nearest even.
+ * */
+class bf16_t
+{
+public:
+    //! Raw bits of the value
+    uint16_t value;
+    //! Default constructor leaves the value uninitialized
+    bf16_t() = default;
+    //! Round single precision value to nearest even bf16_t value
+    bf16_t(fp32_t x)
+        noexcept
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        // Keep NaN quiet, as rounding may turn it into infinity
+        if((bits & 0x7fffffffu) > 0x7f800000u)
+        {
+            value = static_cast<uint16_t>((bits>>16) | 0x0040u);
+        }
+        else
+        {
+            bits += 0x7fffu + ((bits>>16) & 1u);
+            value = static_cast<uint16_t>(bits >> 16);
+        }
+    }
+    //! Exact conversion into single precision
+    operator fp32_t() const
+        noexcept
+    {
+        uint32_t bits = static_cast<uint32_t>(value) << 16;
+        fp32_t x;
+        std::memcpy(&x, &bits, sizeof(x));
+        return x;
+    }
+};
+
+//! Type for arithmetics on values of type T inside CPU kernels
+template<typename T>
+struct compute_type
+{
+    using type = T;
 };
 
+//! Values of fp16_t type are computed in single precision
+template<>
+struct compute_type<fp16_t>
+{
+    using type = fp32_t;
+};
+
+//! Values of bf16_t type are computed in single precision
+template<>
+struct compute_type<bf16_t>
+{
+    using type = fp32_t;
+};
+
+template<typename T>
+using compute_t = typename compute_type<T>::type;
+
 // Boolean type for mask
 using bool_t = bool;
 
-// Add more types like fp16_t, bf16_t and tf32_t in the future
+//! Signed 8-bit integer for quantized values
+using int8_t = std::int8_t;
+
+// Add more types like tf32_t in the future
 
 } // namespace nntile
 
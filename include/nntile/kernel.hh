@@ -30,6 +30,7 @@
 #include <nntile/kernel/dgelutanh.hh>
 #include <nntile/kernel/drelu.hh>
 #include <nntile/kernel/hypot.hh>
+#include <nntile/kernel/hypot_scalar_inverse.hh>
 #include <nntile/kernel/normalize.hh>
 #include <nntile/kernel/prod.hh>
 #include <nntile/kernel/randn.hh>
@@ -67,7 +68,19 @@
 #include <nntile/kernel/scal.hh>
 #include <nntile/kernel/adam_step.hh>
 #include <nntile/kernel/adamw_step.hh>
+#include <nntile/kernel/amp_unscale.hh>
+#include <nntile/kernel/cross_entropy_fwd_bwd.hh>
+#include <nntile/kernel/embedding_rows.hh>
+#include <nntile/kernel/clear_rows.hh>
+#include <nntile/kernel/sparse_adam_step.hh>
+#include <nntile/kernel/gemm_int8.hh>
 #include <nntile/kernel/transpose.hh>
+#include <nntile/kernel/flash_maxsumexp.hh>
+#include <nntile/kernel/flash_softmax_gemm.hh>
+#include <nntile/kernel/flash_softmax_gemm_backward_sumprod_slice.hh>
+#include <nntile/kernel/flash_softmax_gemm_backward_dq_dk.hh>
+#include <nntile/kernel/layer_norm_forward.hh>
+#include <nntile/kernel/layer_norm_backward.hh>
 
 namespace nntile
 {
@@ -29,6 +29,20 @@ void cpu(Index num_iter, Index num_elems, T beta_1, T beta_2, T eps, T lr, T wei
          T* grad, T* first_moment, T* second_moment, T* p)
     noexcept;
 
+// Fused Adam step on buffers with precomputed bias corrections on CPU
+template<typename T>
+void cpu_apply(Index num_elems, bool first_iter, T beta_1, T beta_2, T eps,
+        T alpha, T beta, T l2_decay, T p_scale, const T *grad,
+        T *first_moment, T *second_moment, T *p)
+    noexcept;
+
+// Fused Adam step on buffers with moments stored in bf16_t on CPU
+template<typename T>
+void cpu_apply(Index num_elems, bool first_iter, T beta_1, T beta_2, T eps,
+        T alpha, T beta, T l2_decay, T p_scale, Index seed, const T *grad,
+        bf16_t *first_moment, bf16_t *second_moment, T *p)
+    noexcept;
+
 } // namespace adam_step
 } // namespace kernel
 } // namespace nntile
\ No newline at end of file
@@ -31,6 +31,13 @@ void cuda(cudaStream_t stream, Index num_iter, Index num_elems, T beta_1, T beta
          T* grad, T* first_moment, T* second_moment, T* p)
     noexcept;
 
+// Fused Adam step on buffers with precomputed bias corrections on CUDA
+template<typename T>
+void cuda_apply(cudaStream_t stream, Index num_elems, bool first_iter,
+        T beta_1, T beta_2, T eps, T alpha, T beta, T l2_decay, T p_scale,
+        const T *grad, T *first_moment, T *second_moment, T *p)
+    noexcept;
+
 } // namespace adam_step
 } // namespace kernel
 } // namespace nntile
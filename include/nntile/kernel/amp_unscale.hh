@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/amp_unscale.hh
+ * Unscale gradients and check them for infinite and NaN values
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-19
+ * */
+
+#pragma once
+
+#include <nntile/kernel/amp_unscale/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/amp_unscale/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::amp_unscale
+/*! Low-level implementations of fused unscaling and inf/NaN check of
+ * gradients for mixed precision training with dynamic loss scaling
+ * */
+namespace amp_unscale
+{
+
+} // namespace amp_unscale
+} // namespace kernel
+} // namespace nntile
+
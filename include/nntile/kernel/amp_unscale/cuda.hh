@@ -0,0 +1,35 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/amp_unscale/cuda.hh
+ * Unscale gradients and check them for infinite and NaN values on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-19
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace amp_unscale
+{
+
+template<typename T>
+void cuda(cudaStream_t stream, Index nelems, T inv_scale, T *data,
+        bool_t *nonfinite)
+    noexcept;
+
+} // namespace amp_unscale
+} // namespace kernel
+} // namespace nntile
+
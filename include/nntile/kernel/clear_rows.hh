@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/clear_rows.hh
+ * Clear marked rows of a matrix
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#pragma once
+
+#include <nntile/kernel/clear_rows/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/clear_rows/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::clear_rows
+/*! Low-level implementations of clearing marked rows of a matrix, which is a
+ * sparse gradient of a table of embeddings
+ * */
+namespace clear_rows
+{
+
+} // namespace clear_rows
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,34 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/clear_rows/cuda.hh
+ * Clear marked rows of a matrix on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cuda_runtime.h>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace clear_rows
+{
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, const bool_t *rows, T *dst)
+    noexcept;
+
+} // namespace clear_rows
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,335 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/cpu_simd.hh
+ * Helpers for vectorized CPU kernels with runtime instruction set selection
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-04
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <cstdint>
+#include <cstring>
+
+//! Build a CPU kernel for several instruction sets and pick one at load time
+/*! On x86-64 ELF targets the compiler emits AVX-512, AVX2 and baseline clones
+ * of the marked function and resolves the call through an ifunc according to
+ * the CPU the library is actually running on. On all other targets the macro
+ * expands to nothing and the portable code is used. Marked functions must be
+ * defined in CPU translation units only, never in CUDA sources.
+ * */
+#if defined(__x86_64__) && defined(__ELF__) && !defined(__CUDACC__) \
+    && defined(__has_attribute)
+#   if __has_attribute(target_clones)
+#       define NNTILE_CPU_DISPATCH \
+            __attribute__((target_clones("avx512f", "avx2", "default")))
+#   endif
+#endif
+#ifndef NNTILE_CPU_DISPATCH
+#   define NNTILE_CPU_DISPATCH
+#endif
+
+//! Build an integer CPU kernel with an extra clone for AVX-512 VNNI
+/*! Dot products of 16-bit integers with 32-bit accumulation are recognized
+ * by the vectorizer only in plain loops (OpenMP SIMD reductions hide the
+ * pattern), so vectorization is requested explicitly. The VNNI clone turns
+ * such loops into vpdpwssd instructions, other clones use pmaddwd.
+ * */
+#if defined(__x86_64__) && defined(__ELF__) && !defined(__CUDACC__) \
+    && defined(__has_attribute)
+#   if __has_attribute(target_clones) && __has_attribute(optimize)
+#       define NNTILE_CPU_DISPATCH_VNNI \
+            __attribute__((target_clones("arch=cascadelake", "avx2", \
+                            "default"), optimize("tree-vectorize")))
+#   endif
+#endif
+#ifndef NNTILE_CPU_DISPATCH_VNNI
+#   define NNTILE_CPU_DISPATCH_VNNI
+#endif
+
+//! Ask the compiler to vectorize the following loop
+/*! Requires -fopenmp-simd (or -fopenmp), which is set up by the build system.
+ * Without it the hint is silently ignored. Loops marked this way must not
+ * carry dependencies between iterations.
+ * */
+#define NNTILE_SIMD _Pragma("omp simd")
+
+//! Vectorize the following loop, that accumulates var with operation op
+/*! Example: NNTILE_SIMD_REDUCTION(+, sum) or NNTILE_SIMD_REDUCTION(max, val)
+ * */
+#define NNTILE_PRAGMA(x) _Pragma(#x)
+#define NNTILE_SIMD_REDUCTION(op, var) \
+    NNTILE_PRAGMA(omp simd reduction(op:var))
+
+//! Force inlining of small helpers into vectorized loops
+#if defined(__GNUC__)
+#   define NNTILE_SIMD_INLINE inline __attribute__((always_inline))
+#else
+#   define NNTILE_SIMD_INLINE inline
+#endif
+
+namespace nntile
+{
+namespace kernel
+{
+namespace simd
+{
+
+//! Bit-level parameters of floating point types used by vectorized math
+template<typename T>
+struct fp_traits;
+
+template<>
+struct fp_traits<fp32_t>
+{
+    using uint_t = std::uint32_t;
+    using int_t = std::int32_t;
+    static constexpr int mantissa_bits = 23;
+    static constexpr int exponent_bias = 127;
+    // Adding and subtracting this value rounds to the nearest integer, that
+    // can be read from the lower bits of the sum
+    static constexpr fp32_t round_shifter = 12582912.0f; // 1.5*2^23
+    static constexpr fp32_t log2e = 1.44269504088896341f;
+    // ln(2) splitted into exactly representable high part and a remainder
+    static constexpr fp32_t ln2_hi = 0.693359375f;
+    static constexpr fp32_t ln2_lo = -2.12194440e-4f;
+    // Arguments outside this range produce zero or infinity anyway
+    static constexpr fp32_t exp_lo = -104.0f;
+    static constexpr fp32_t exp_hi = 89.0f;
+    // Taylor polynomial of exp(r) for |r| <= ln(2)/2
+    static NNTILE_SIMD_INLINE fp32_t exp_poly(fp32_t r)
+        noexcept
+    {
+        fp32_t p = 1.0f/5040.0f;
+        p = p*r + 1.0f/720.0f;
+        p = p*r + 1.0f/120.0f;
+        p = p*r + 1.0f/24.0f;
+        p = p*r + 1.0f/6.0f;
+        p = p*r + 0.5f;
+        p = p*r + 1.0f;
+        return p*r + 1.0f;
+    }
+    // Mantissa of sqrt(1/2), logarithm reduces its argument to
+    // [sqrt(1/2), sqrt(2))
+    static constexpr std::uint32_t log_sqrt_half = 0x3f3504f3;
+    static constexpr fp32_t log2_hi = 6.9313812256e-01f;
+    static constexpr fp32_t log2_lo = 9.0580006145e-06f;
+    // Polynomial of log(1+f) in terms of z=s^2 and w=s^4, where s=f/(2+f)
+    static NNTILE_SIMD_INLINE fp32_t log_poly(fp32_t z, fp32_t w)
+        noexcept
+    {
+        fp32_t t1 = w * (0.40000972152f+w*0.24279078841f);
+        fp32_t t2 = z * (0.66666662693f+w*0.28498786688f);
+        return t1 + t2;
+    }
+    // Polynomials of sin(x)/x-1 and cos(x)-1+x^2/2 in terms of z=x^2 for
+    // |x| <= pi/4
+    static NNTILE_SIMD_INLINE fp32_t sin_poly(fp32_t z)
+        noexcept
+    {
+        fp32_t p = 2.71831149e-06f;
+        p = p*z - 1.98393348e-04f;
+        p = p*z + 8.33332939e-03f;
+        p = p*z - 1.66666666e-01f;
+        return p * z;
+    }
+    static NNTILE_SIMD_INLINE fp32_t cos_poly(fp32_t z)
+        noexcept
+    {
+        fp32_t p = 2.43904487962e-05f;
+        p = p*z - 1.38867637746e-03f;
+        p = p*z + 4.16666233237e-02f;
+        return p * z * z;
+    }
+};
+
+template<>
+struct fp_traits<fp64_t>
+{
+    using uint_t = std::uint64_t;
+    using int_t = std::int64_t;
+    static constexpr int mantissa_bits = 52;
+    static constexpr int exponent_bias = 1023;
+    static constexpr fp64_t round_shifter = 6755399441055744.0; // 1.5*2^52
+    static constexpr fp64_t log2e = 1.44269504088896340736;
+    static constexpr fp64_t ln2_hi = 6.93147180369123816490e-01;
+    static constexpr fp64_t ln2_lo = 1.90821492927058770002e-10;
+    static constexpr fp64_t exp_lo = -746.0;
+    static constexpr fp64_t exp_hi = 710.0;
+    static NNTILE_SIMD_INLINE fp64_t exp_poly(fp64_t r)
+        noexcept
+    {
+        fp64_t p = 1.0/6227020800.0;
+        p = p*r + 1.0/479001600.0;
+        p = p*r + 1.0/39916800.0;
+        p = p*r + 1.0/3628800.0;
+        p = p*r + 1.0/362880.0;
+        p = p*r + 1.0/40320.0;
+        p = p*r + 1.0/5040.0;
+        p = p*r + 1.0/720.0;
+        p = p*r + 1.0/120.0;
+        p = p*r + 1.0/24.0;
+        p = p*r + 1.0/6.0;
+        p = p*r + 0.5;
+        p = p*r + 1.0;
+        return p*r + 1.0;
+    }
+    // Mantissa of sqrt(1/2), logarithm reduces its argument to
+    // [sqrt(1/2), sqrt(2))
+    static constexpr std::uint64_t log_sqrt_half = 0x3fe6a09e667f3bcdULL;
+    static constexpr fp64_t log2_hi = ln2_hi;
+    static constexpr fp64_t log2_lo = ln2_lo;
+    static NNTILE_SIMD_INLINE fp64_t log_poly(fp64_t z, fp64_t w)
+        noexcept
+    {
+        fp64_t t1 = w * (3.999999999940941908e-01 + w*(
+                    2.222219843214978396e-01 + w*1.531383769920937332e-01));
+        fp64_t t2 = z * (6.666666666666735130e-01 + w*(
+                    2.857142874366239149e-01 + w*(1.818357216161805012e-01
+                        + w*1.479819860511658591e-01)));
+        return t1 + t2;
+    }
+    static NNTILE_SIMD_INLINE fp64_t sin_poly(fp64_t z)
+        noexcept
+    {
+        fp64_t p = 1.58969099521155010221e-10;
+        p = p*z - 2.50507602534068634195e-08;
+        p = p*z + 2.75573137070700676789e-06;
+        p = p*z - 1.98412698298579493134e-04;
+        p = p*z + 8.33333333332248946124e-03;
+        p = p*z - 1.66666666666666324348e-01;
+        return p * z;
+    }
+    static NNTILE_SIMD_INLINE fp64_t cos_poly(fp64_t z)
+        noexcept
+    {
+        fp64_t p = -1.13596475577881948265e-11;
+        p = p*z + 2.08757232129817482790e-09;
+        p = p*z - 2.75573143513906633035e-07;
+        p = p*z + 2.48015872894767294178e-05;
+        p = p*z - 1.38888888888741095749e-03;
+        p = p*z + 4.16666666666666019037e-02;
+        return p * z * z;
+    }
+};
+
+template<typename T>
+NNTILE_SIMD_INLINE typename fp_traits<T>::uint_t as_uint(T x)
+    noexcept
+{
+    typename fp_traits<T>::uint_t y;
+    std::memcpy(&y, &x, sizeof(y));
+    return y;
+}
+
+template<typename T>
+NNTILE_SIMD_INLINE T as_fp(typename fp_traits<T>::uint_t x)
+    noexcept
+{
+    T y;
+    std::memcpy(&y, &x, sizeof(y));
+    return y;
+}
+
+//! Exponent that can be inlined into a vectorized loop
+/*! Uses Cody-Waite range reduction x = n*ln(2) + r, |r| <= ln(2)/2, and a
+ * Taylor polynomial for exp(r). The result is scaled by 2^n in two steps to
+ * support gradual underflow. Accuracy is within a few ulp of std::exp()
+ * over the whole range, overflow produces infinity and NaN propagates.
+ * */
+template<typename T>
+NNTILE_SIMD_INLINE T exp(T x)
+    noexcept
+{
+    using traits = fp_traits<T>;
+    using uint_t = typename traits::uint_t;
+    using int_t = typename traits::int_t;
+    // Clamp argument, that keeps n small enough for integer operations below
+    x = (x < traits::exp_lo) ? traits::exp_lo : x;
+    x = (x > traits::exp_hi) ? traits::exp_hi : x;
+    // Round x/ln(2) to the nearest integer n
+    T kn = x*traits::log2e + traits::round_shifter;
+    T n = kn - traits::round_shifter;
+    int_t n_int = static_cast<int_t>(as_uint(kn) - as_uint(
+                traits::round_shifter));
+    // Reduced argument
+    T r = x - n*traits::ln2_hi;
+    r = r - n*traits::ln2_lo;
+    T p = traits::exp_poly(r);
+    // Multiply by 2^n as 2^n1 * 2^n2, as 2^n alone may not be representable
+    int_t n1 = n_int >> 1;
+    int_t n2 = n_int - n1;
+    T s1 = as_fp<T>(static_cast<uint_t>(n1+traits::exponent_bias)
+            << traits::mantissa_bits);
+    T s2 = as_fp<T>(static_cast<uint_t>(n2+traits::exponent_bias)
+            << traits::mantissa_bits);
+    return p * s1 * s2;
+}
+
+//! Natural logarithm of a positive normal number in a vectorized loop
+/*! Reduces the argument to x = 2^k * (1+f) with 1+f in [sqrt(1/2), sqrt(2))
+ * and evaluates log(1+f) through s = f/(2+f) as in fdlibm. Zero, negative and
+ * subnormal arguments, infinity and NaN are not supported.
+ * */
+template<typename T>
+NNTILE_SIMD_INLINE T log(T x)
+    noexcept
+{
+    using traits = fp_traits<T>;
+    using uint_t = typename traits::uint_t;
+    using int_t = typename traits::int_t;
+    constexpr uint_t one = static_cast<uint_t>(traits::exponent_bias)
+        << traits::mantissa_bits;
+    constexpr uint_t mantissa_mask = (uint_t{1}<<traits::mantissa_bits) - 1;
+    // Shift the argument, so that the exponent is incremented for mantissa
+    // larger than sqrt(2)
+    uint_t ix = as_uint(x) + (one-traits::log_sqrt_half);
+    int_t k = static_cast<int_t>(ix>>traits::mantissa_bits)
+        - traits::exponent_bias;
+    ix = (ix&mantissa_mask) + traits::log_sqrt_half;
+    T f = as_fp<T>(ix) - T{1};
+    T hfsq = T{0.5} * f * f;
+    T s = f / (T{2}+f);
+    T z = s * s;
+    T w = z * z;
+    T r = traits::log_poly(z, w);
+    T dk = static_cast<T>(k);
+    return s*(hfsq+r) + dk*traits::log2_lo - hfsq + f + dk*traits::log2_hi;
+}
+
+//! Cosine of 2*pi*x in a vectorized loop
+/*! Range reduction is done on x itself, which is exact, so the result is
+ * accurate for any |x| < 2^20. The reduced angle 2*pi*r, |r| <= 1/8, goes into
+ * sine or cosine polynomial depending on the quadrant.
+ * */
+template<typename T>
+NNTILE_SIMD_INLINE T cos_2pi(T x)
+    noexcept
+{
+    using traits = fp_traits<T>;
+    using int_t = typename traits::int_t;
+    constexpr T twopi = 6.28318530717958647692528676655900577L;
+    // Quadrant n = round(4x) and reduced argument r = x - n/4
+    T kn = T{4}*x + traits::round_shifter;
+    T n = kn - traits::round_shifter;
+    int_t quadrant = static_cast<int_t>(as_uint(kn) - as_uint(
+                traits::round_shifter)) & 3;
+    T a = (x - T{0.25}*n) * twopi;
+    T z = a * a;
+    T sin_a = a + a*traits::sin_poly(z);
+    T cos_a = T{1} - T{0.5}*z + traits::cos_poly(z);
+    // cos(a + quadrant*pi/2)
+    T res = (quadrant & 1) ? sin_a : cos_a;
+    return ((quadrant+1) & 2) ? -res : res;
+}
+
+} // namespace simd
+} // namespace kernel
+} // namespace nntile
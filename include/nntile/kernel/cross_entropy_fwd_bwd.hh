@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/cross_entropy_fwd_bwd.hh
+ * Fused cross entropy loss and its gradient
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#pragma once
+
+#include <nntile/kernel/cross_entropy_fwd_bwd/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/cross_entropy_fwd_bwd/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::cross_entropy_fwd_bwd
+/*! Low-level implementations of cross entropy loss, that computes the loss
+ * value and the gradient over logits within a single pass
+ * */
+namespace cross_entropy_fwd_bwd
+{
+
+} // namespace cross_entropy_fwd_bwd
+} // namespace kernel
+} // namespace nntile
+
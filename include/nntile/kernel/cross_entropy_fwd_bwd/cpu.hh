@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/cross_entropy_fwd_bwd/cpu.hh
+ * Fused cross entropy loss and its gradient on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace cross_entropy_fwd_bwd
+{
+
+// Cross entropy loss and its gradient over a CPU buffer of logits
+template<typename T>
+void cpu(Index m, Index n, Index m_start, T scale, T grad_scale,
+        const T *maxsumexp, const T *src, const Index *labels, T *grad,
+        T *val)
+    noexcept;
+
+} // namespace cross_entropy_fwd_bwd
+} // namespace kernel
+} // namespace nntile
+
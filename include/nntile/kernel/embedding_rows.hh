@@ -0,0 +1,37 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/embedding_rows.hh
+ * Mark rows of embeddings, that are touched by tokens
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#pragma once
+
+#include <nntile/kernel/embedding_rows/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/embedding_rows/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::embedding_rows
+/*! Low-level implementations of marking rows of a table of embeddings, that
+ * are touched by tokens, for sparse gradients of embeddings
+ * */
+namespace embedding_rows
+{
+
+} // namespace embedding_rows
+} // namespace kernel
+} // namespace nntile
+
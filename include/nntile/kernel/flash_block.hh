@@ -0,0 +1,135 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/flash_block.hh
+ * Blocked attention scores for flash-like CPU kernels
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-06
+ * */
+
+#pragma once
+
+#include <nntile/kernel/cpu_simd.hh>
+#include <algorithm>
+#include <limits>
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::flash_block
+/*! Helpers shared by flash_maxsumexp, flash_softmax_gemm and its backward
+ *
+ * Attention scores of a seq-by-seq tile are never stored entirely. Instead,
+ * they are computed for a block of block_size keys and block_size queries at
+ * a time and consumed at once. For head size of 64 the block of scores and
+ * corresponding columns of K, Q and V take less than 100 KB in single
+ * precision, so the working set of a CPU worker stays in its L2 cache.
+ * */
+namespace flash_block
+{
+
+//! Number of keys and queries in a single block of scores
+constexpr Index block_size = 64;
+
+//! Compute a block of masked attention scores
+/*! S[k,q] = scale * dot(K[:,k], Q[:,q]) if mask[k,q] else -inf
+ *
+ * @param[in] head: Size of the head, that is the length of each column
+ * @param[in] seq: Leading dimension of the mask
+ * @param[in] nk: Number of keys in the block
+ * @param[in] nq: Number of queries in the block
+ * @param[in] K: First column of keys of the block
+ * @param[in] Q: First column of queries of the block
+ * @param[in] mask: Mask value for the first key and query of the block
+ * @param[in] scale: Multiplier for scores
+ * @param[out] S: Contiguous nk-by-nq block of scores
+ * */
+template<typename T>
+NNTILE_SIMD_INLINE void scores(Index head, Index seq, Index nk, Index nq,
+        const T *K, const T *Q, const bool_t *mask, T scale, T *S)
+    noexcept
+{
+    constexpr T neg_inf = -std::numeric_limits<T>::infinity();
+    // Keys are transposed by chunks of the head dimension, so that the inner
+    // loop goes contiguously over keys without horizontal reductions
+    T K_t[block_size*block_size];
+    for(Index i = 0; i < nk*nq; ++i)
+    {
+        S[i] = 0;
+    }
+    for(Index h0 = 0; h0 < head; h0 += block_size)
+    {
+        Index nh = std::min(block_size, head-h0);
+        for(Index k = 0; k < nk; ++k)
+        {
+            for(Index h = 0; h < nh; ++h)
+            {
+                K_t[h*nk+k] = K[k*head+h0+h];
+            }
+        }
+        for(Index q = 0; q < nq; ++q)
+        {
+            const T *Q_q = Q + q*head + h0;
+            T *S_q = S + q*nk;
+            for(Index h = 0; h < nh; ++h)
+            {
+                const T val = Q_q[h];
+                const T *K_h = K_t + h*nk;
+                NNTILE_SIMD
+                for(Index k = 0; k < nk; ++k)
+                {
+                    S_q[k] += K_h[k] * val;
+                }
+            }
+        }
+    }
+    for(Index q = 0; q < nq; ++q)
+    {
+        T *S_q = S + q*nk;
+        const bool_t *mask_q = mask + q*seq;
+        for(Index k = 0; k < nk; ++k)
+        {
+            S_q[k] = mask_q[k] ? scale*S_q[k] : neg_inf;
+        }
+    }
+}
+
+//! Turn a block of scores into softmax probabilities inplace
+/*! S[k,q] = exp(S[k,q]-maxsumexp[0,q]) / maxsumexp[1,q], masked out scores
+ * turn into zeros.
+ *
+ * @param[in] nk: Number of keys in the block
+ * @param[in] nq: Number of queries in the block
+ * @param[in] maxsumexp: Maximums and sums of exponents for the first query
+ *      of the block, stored interleaved
+ * @param[inout] S: Contiguous nk-by-nq block of scores
+ * */
+template<typename T>
+NNTILE_SIMD_INLINE void probs(Index nk, Index nq, const T *maxsumexp, T *S)
+    noexcept
+{
+    constexpr T neg_inf = -std::numeric_limits<T>::infinity();
+    for(Index q = 0; q < nq; ++q)
+    {
+        const T max = maxsumexp[2*q];
+        const T inv_sum = T{1} / maxsumexp[2*q+1];
+        T *S_q = S + q*nk;
+        NNTILE_SIMD
+        for(Index k = 0; k < nk; ++k)
+        {
+            T val = simd::exp(S_q[k]-max) * inv_sum;
+            S_q[k] = (S_q[k] == neg_inf) ? T{0} : val;
+        }
+    }
+}
+
+} // namespace flash_block
+} // namespace kernel
+} // namespace nntile
+
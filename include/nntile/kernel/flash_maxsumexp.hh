@@ -0,0 +1,32 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/flash_maxsumexp.hh
+ * Max and sum of exponents of attention scores without storing them
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-06
+ * */
+
+#pragma once
+
+#include <nntile/kernel/flash_maxsumexp/cpu.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::flash_maxsumexp
+/*! Low-level implementations of flash_maxsumexp operation
+ * */
+namespace flash_maxsumexp
+{
+
+} // namespace flash_maxsumexp
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,34 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/flash_maxsumexp/cpu.hh
+ * Max and sum of exponents of attention scores without storing them on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-06
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace flash_maxsumexp
+{
+
+template<typename T>
+void cpu(Index seq, Index head, Index batch, const T *K, const T *Q,
+        const bool_t *mask, T *maxsumexp)
+    noexcept;
+
+} // namespace flash_maxsumexp
+} // namespace kernel
+} // namespace nntile
+
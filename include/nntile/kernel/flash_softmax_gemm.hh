@@ -0,0 +1,32 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/flash_softmax_gemm.hh
+ * Fused softmax of attention scores and product by values
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-06
+ * */
+
+#pragma once
+
+#include <nntile/kernel/flash_softmax_gemm/cpu.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::flash_softmax_gemm
+/*! Low-level implementations of flash_softmax_gemm operation
+ * */
+namespace flash_softmax_gemm
+{
+
+} // namespace flash_softmax_gemm
+} // namespace kernel
+} // namespace nntile
+
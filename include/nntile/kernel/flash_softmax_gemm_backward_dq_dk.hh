@@ -0,0 +1,32 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/flash_softmax_gemm_backward_dq_dk.hh
+ * Flash attention backward to get gradients of Q and K
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-06
+ * */
+
+#pragma once
+
+#include <nntile/kernel/flash_softmax_gemm_backward_dq_dk/cpu.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::flash_softmax_gemm_backward_dq_dk
+/*! Low-level implementations of flash_softmax_gemm_backward_dq_dk operation
+ * */
+namespace flash_softmax_gemm_backward_dq_dk
+{
+
+} // namespace flash_softmax_gemm_backward_dq_dk
+} // namespace kernel
+} // namespace nntile
+
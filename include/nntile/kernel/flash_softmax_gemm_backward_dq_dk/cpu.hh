@@ -0,0 +1,35 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/flash_softmax_gemm_backward_dq_dk/cpu.hh
+ * Flash attention backward to get gradients of Q and K on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-06
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace flash_softmax_gemm_backward_dq_dk
+{
+
+template<typename T>
+void cpu(Index seq, Index head, Index batch, const T *K, const T *Q,
+        const bool_t *mask, const T *maxsumexp, const T *dA, const T *V,
+        const T *sumprod_slice, T *dQ, T *dK)
+    noexcept;
+
+} // namespace flash_softmax_gemm_backward_dq_dk
+} // namespace kernel
+} // namespace nntile
+
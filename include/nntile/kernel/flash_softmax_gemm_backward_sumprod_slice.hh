@@ -0,0 +1,33 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/flash_softmax_gemm_backward_sumprod_slice.hh
+ * Flash attention backward to get gradient of V and sumprod_slice
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-06
+ * */
+
+#pragma once
+
+#include <nntile/kernel/flash_softmax_gemm_backward_sumprod_slice/cpu.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::flash_softmax_gemm_backward_sumprod_slice
+/*! Low-level implementations of flash_softmax_gemm_backward_sumprod_slice
+ * operation
+ * */
+namespace flash_softmax_gemm_backward_sumprod_slice
+{
+
+} // namespace flash_softmax_gemm_backward_sumprod_slice
+} // namespace kernel
+} // namespace nntile
+
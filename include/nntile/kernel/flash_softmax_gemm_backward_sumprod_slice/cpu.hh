@@ -0,0 +1,35 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/flash_softmax_gemm_backward_sumprod_slice/cpu.hh
+ * Flash attention backward to get gradient of V and sumprod_slice on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-06
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace flash_softmax_gemm_backward_sumprod_slice
+{
+
+template<typename T>
+void cpu(Index seq, Index head, Index batch, const T *K, const T *Q,
+        const bool_t *mask, const T *maxsumexp, const T *dA, const T *V,
+        T *dV, T *sumprod_slice)
+    noexcept;
+
+} // namespace flash_softmax_gemm_backward_sumprod_slice
+} // namespace kernel
+} // namespace nntile
+
@@ -14,9 +14,9 @@
 
 #pragma once
 
+#include <nntile/kernel/fp16_to_fp32/cpu.hh>
 #include <nntile/defs.h>
 #ifdef NNTILE_USE_CUDA
-#include <nntile/kernel/fp16_to_fp32/cpu.hh>
 #include <nntile/kernel/fp16_to_fp32/cuda.hh>
 #endif // NNTILE_USE_CUDA
 
@@ -0,0 +1,33 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/gemm_int8.hh
+ * Matrix multiplication by per-channel quantized int8 weights
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-20
+ * */
+
+#pragma once
+
+#include <nntile/kernel/gemm_int8/cpu.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::gemm_int8
+/*! Low-level implementations of matrix multiplication by int8 weights with
+ * dynamically quantized activations and 32-bit integer accumulation
+ * */
+namespace gemm_int8
+{
+
+} // namespace gemm_int8
+} // namespace kernel
+} // namespace nntile
+
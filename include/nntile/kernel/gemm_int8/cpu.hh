@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/gemm_int8/cpu.hh
+ * Matrix multiplication by per-channel quantized int8 weights on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-20
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/constants.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace gemm_int8
+{
+
+// Multiply buffer by int8 weights, quantizing the buffer on the fly
+template<typename T>
+void cpu(const TransOp &trans, Index m, Index n, Index k, T alpha,
+        const int8_t *w, const T *w_scale, const T *x, T beta, T *y,
+        T *x_scale, std::int16_t *x_quant, std::int16_t *w_col,
+        std::int32_t *acc)
+    noexcept;
+
+} // namespace gemm_int8
+} // namespace kernel
+} // namespace nntile
+
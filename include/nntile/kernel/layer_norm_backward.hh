@@ -0,0 +1,32 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/layer_norm_backward.hh
+ * Fused backward pass of layer normalization
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-08
+ * */
+
+#pragma once
+
+#include <nntile/kernel/layer_norm_backward/cpu.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::layer_norm_backward
+/*! Low-level implementations of layer_norm_backward operation
+ * */
+namespace layer_norm_backward
+{
+
+} // namespace layer_norm_backward
+} // namespace kernel
+} // namespace nntile
+
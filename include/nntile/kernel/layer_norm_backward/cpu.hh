@@ -0,0 +1,35 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/layer_norm_backward/cpu.hh
+ * Fused backward pass of layer normalization on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-08
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace layer_norm_backward
+{
+
+template<typename T>
+void cpu(Index m, Index n, Index k, const T *src_normalized,
+        const T *dst_grad, const T *gamma, const T *inv_stddev, T *src_grad,
+        T *gamma_grad, T *beta_grad)
+    noexcept;
+
+} // namespace layer_norm_backward
+} // namespace kernel
+} // namespace nntile
+
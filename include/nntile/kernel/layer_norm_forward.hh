@@ -0,0 +1,32 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/layer_norm_forward.hh
+ * Fused forward pass of layer normalization
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-08
+ * */
+
+#pragma once
+
+#include <nntile/kernel/layer_norm_forward/cpu.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::layer_norm_forward
+/*! Low-level implementations of layer_norm_forward operation
+ * */
+namespace layer_norm_forward
+{
+
+} // namespace layer_norm_forward
+} // namespace kernel
+} // namespace nntile
+
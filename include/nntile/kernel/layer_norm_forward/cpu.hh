@@ -0,0 +1,34 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/layer_norm_forward/cpu.hh
+ * Fused forward pass of layer normalization on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-08
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace layer_norm_forward
+{
+
+template<typename T>
+void cpu(Index m, Index n, Index k, T eps, const T *src, const T *gamma,
+        const T *beta, T *mean, T *inv_stddev, T *src_normalized, T *dst)
+    noexcept;
+
+} // namespace layer_norm_forward
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/sparse_adam_step.hh
+ * Lazy Adam step over marked rows of a matrix
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#pragma once
+
+#include <nntile/kernel/sparse_adam_step/cpu.hh>
+#include <nntile/defs.h>
+#ifdef NNTILE_USE_CUDA
+#include <nntile/kernel/sparse_adam_step/cuda.hh>
+#endif // NNTILE_USE_CUDA
+
+namespace nntile
+{
+namespace kernel
+{
+//! @namespace nntile::kernel::sparse_adam_step
+/*! Low-level implementations of lazy Adam and AdamW steps over rows of a
+ * matrix, that are marked as touched by sparse gradient, with per-row step
+ * counters
+ * */
+namespace sparse_adam_step
+{
+
+} // namespace sparse_adam_step
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,36 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/kernel/sparse_adam_step/cpu.hh
+ * Lazy Adam step over marked rows of a matrix on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace sparse_adam_step
+{
+
+// Lazy Adam step over marked rows of a matrix on CPU
+template<typename T>
+void cpu(Index m, Index n, T beta_1, T beta_2, T eps, T lr, T weight_decay,
+        int decoupled, const bool_t *rows, Index *row_step, const T *grad,
+        T *first_moment, T *second_moment, T *p)
+    noexcept;
+
+} // namespace sparse_adam_step
+} // namespace kernel
+} // namespace nntile
+
@@ -62,6 +62,12 @@
 #include <nntile/starpu/flash_softmax_gemm.hh>
 #include <nntile/starpu/flash_softmax_gemm_backward_sumprod_slice.hh>
 #include <nntile/starpu/flash_softmax_gemm_backward_dq_dk.hh>
+#include <nntile/starpu/layer_norm_forward.hh>
+#include <nntile/starpu/layer_norm_backward.hh>
+#include <nntile/starpu/from_array.hh>
+#include <nntile/starpu/to_array.hh>
+#include <nntile/starpu/write_tile.hh>
+#include <nntile/starpu/read_tile.hh>
 #include <nntile/starpu/softmax_inplace.hh>
 #include <nntile/starpu/sqrt.hh>
 #include <nntile/starpu/sqrt_inplace.hh>
@@ -85,6 +91,13 @@
 #include <nntile/starpu/mask_scalar.hh>
 #include <nntile/starpu/adam_step.hh>
 #include <nntile/starpu/adamw_step.hh>
+#include <nntile/starpu/amp_unscale.hh>
+#include <nntile/starpu/cross_entropy_fwd_bwd.hh>
+#include <nntile/starpu/embedding_rows.hh>
+#include <nntile/starpu/clear_rows.hh>
+#include <nntile/starpu/sparse_adam_step.hh>
+#include <nntile/starpu/multi_adam_step.hh>
+#include <nntile/starpu/gemm_int8.hh>
 #include <nntile/starpu/transpose.hh>
 
 namespace nntile
@@ -140,6 +153,12 @@ void init()
     flash_softmax_gemm_backward_sumprod_slice::init();
     flash_softmax_gemm_backward_dq_dk::init();
     flash_maxsumexp::init();
+    layer_norm_forward::init();
+    layer_norm_backward::init();
+    from_array::init();
+    to_array::init();
+    write_tile::init();
+    read_tile::init();
     maxsumexp::init();
     sqrt::init();
     sqrt_inplace::init();
@@ -163,6 +182,13 @@ void init()
     mask_scalar::init();
     adam_step::init();
     adamw_step::init();
+    amp_unscale::init();
+    cross_entropy_fwd_bwd::init();
+    embedding_rows::init();
+    clear_rows::init();
+    sparse_adam_step::init();
+    multi_adam_step::init();
+    gemm_int8::init();
     transpose::init();
 }
 
@@ -211,6 +237,12 @@ void restrict_where(uint32_t where)
     flash_softmax_gemm_backward_sumprod_slice::restrict_where(where);
     flash_softmax_gemm_backward_dq_dk::restrict_where(where);
     flash_maxsumexp::restrict_where(where);
+    layer_norm_forward::restrict_where(where);
+    layer_norm_backward::restrict_where(where);
+    from_array::restrict_where(where);
+    to_array::restrict_where(where);
+    write_tile::restrict_where(where);
+    read_tile::restrict_where(where);
     maxsumexp::restrict_where(where);
     sqrt::restrict_where(where);
     sqrt_inplace::restrict_where(where);
@@ -234,6 +266,13 @@ void restrict_where(uint32_t where)
     mask_scalar::restrict_where(where);
     adam_step::restrict_where(where);
     adamw_step::restrict_where(where);
+    amp_unscale::restrict_where(where);
+    cross_entropy_fwd_bwd::restrict_where(where);
+    embedding_rows::restrict_where(where);
+    clear_rows::restrict_where(where);
+    sparse_adam_step::restrict_where(where);
+    multi_adam_step::restrict_where(where);
+    gemm_int8::restrict_where(where);
     transpose::restrict_where(where);
 }
 
@@ -282,6 +321,12 @@ void restore_where()
     flash_softmax_gemm_backward_sumprod_slice::restore_where();
     flash_softmax_gemm_backward_dq_dk::restore_where();
     flash_maxsumexp::restore_where();
+    layer_norm_forward::restore_where();
+    layer_norm_backward::restore_where();
+    from_array::restore_where();
+    to_array::restore_where();
+    write_tile::restore_where();
+    read_tile::restore_where();
     maxsumexp::restore_where();
     sqrt::restore_where();
     sqrt_inplace::restore_where();
@@ -305,6 +350,13 @@ void restore_where()
     mask_scalar::restore_where();
     adam_step::restore_where();
     adamw_step::restore_where();
+    amp_unscale::restore_where();
+    cross_entropy_fwd_bwd::restore_where();
+    embedding_rows::restore_where();
+    clear_rows::restore_where();
+    sparse_adam_step::restore_where();
+    multi_adam_step::restore_where();
+    gemm_int8::restore_where();
     transpose::restore_where();
 }
 
@@ -37,7 +37,7 @@ void cuda(void *buffers[], void *cl_args)
     noexcept;
 #endif // NNTILE_USE_CUDA
 
-extern Codelet codelet_fp32, codelet_fp64;
+extern Codelet codelet_fp32, codelet_fp64, codelet_bf16;
 
 template<typename T>
 constexpr Codelet *codelet()
@@ -58,6 +58,12 @@ constexpr Codelet *codelet<fp64_t>()
     return &codelet_fp64;
 }
 
+template<>
+constexpr Codelet *codelet<bf16_t>()
+{
+    return &codelet_bf16;
+}
+
 void init();
 
 void restrict_where(uint32_t where);
@@ -0,0 +1,82 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/amp_unscale.hh
+ * Unscale gradients and check them for infinite and NaN values on StarPU
+ * buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-19
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+#include <nntile/defs.h>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace amp_unscale
+{
+
+//! Structure for arguments
+template<typename T>
+struct args_t
+{
+    Index nelems;
+    T inv_scale;
+};
+
+// Unscale StarPU buffer and check it for inf and NaN values on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+#ifdef NNTILE_USE_CUDA
+// Unscale StarPU buffer and check it for inf and NaN values on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CUDA
+
+extern Codelet codelet_fp32, codelet_fp64;
+
+template<typename T>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_t>()
+{
+    return &codelet_fp32;
+}
+
+template<>
+constexpr Codelet *codelet<fp64_t>()
+{
+    return &codelet_fp64;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename T>
+void submit(Index nelems, T inv_scale, Handle data, Handle nonfinite);
+
+} // namespace amp_unscale
+} // namespace starpu
+} // namespace nntile
+
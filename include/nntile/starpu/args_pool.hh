@@ -0,0 +1,98 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/args_pool.hh
+ * Pooled allocation of codelet arguments
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-07
+ * */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <initializer_list>
+
+namespace nntile
+{
+namespace starpu
+{
+//! @namespace nntile::starpu::args_pool
+/*! Arguments of a codelet live from task submission till the end of task
+ * execution, which usually happens on another thread. Allocating them with
+ * std::malloc and letting StarPU free them serializes all the submitting and
+ * executing threads on the global heap. Instead, every thread owns a pool of
+ * fixed-size blocks. A block is taken from the pool of the submitting thread
+ * without any synchronization, and it is returned to the same pool by the
+ * callback of the task through a lock-free list.
+ *
+ * Tasks shall be submitted with the following arguments:
+ *      STARPU_CL_ARGS_NFREE, args, size,
+ *      STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
+ * so that StarPU neither frees the arguments itself nor touches them after
+ * the callback.
+ * */
+namespace args_pool
+{
+
+//! Allocate a block of at least size bytes aligned for any scalar type
+void *alloc(std::size_t size);
+
+//! Return a block to its pool, can be called from any thread
+/*! Signature fits StarPU callbacks. Does nothing for nullptr.
+ * */
+void release(void *ptr)
+    noexcept;
+
+//! Check submission of a task with pooled arguments
+/*! Callback of a task, that was not submitted, is never called, so the
+ * arguments are returned to the pool here before an exception is thrown.
+ *
+ * @param[in] ret: Return value of the task submission
+ * @param[in] args: Arguments of the task, allocated from the pool
+ * @param[in] msg: Message of the exception
+ * */
+void check_submit(int ret, void *args, const char *msg);
+
+//! Allocate an object of a trivially destructible type
+/*! Without arguments the object is left uninitialized, as with std::malloc,
+ * and its fields shall be set by the caller. Otherwise it is constructed
+ * from the given arguments.
+ * */
+template<typename T, typename... Ts>
+T *alloc(Ts &&...args)
+{
+    static_assert(std::is_trivially_destructible<T>::value,
+            "Destructors of pooled codelet arguments are never called");
+    if constexpr(sizeof...(Ts) == 0)
+    {
+        return static_cast<T *>(alloc(sizeof(T)));
+    }
+    else
+    {
+        return new(alloc(sizeof(T))) T{std::forward<Ts>(args)...};
+    }
+}
+
+//! Pack arguments into a single block in the STARPU_VALUE format
+/*! The block is read by starpu_codelet_unpack_args() or by
+ * Config::unpack_args_ptr() the same way as if the arguments were passed one
+ * by one with STARPU_VALUE.
+ *
+ * @param[in] args: Pointers to arguments with their sizes in bytes
+ * @param[out] size: Total size of the block
+ * */
+void *pack(std::initializer_list<std::pair<const void *, std::size_t>> args,
+        std::size_t &size);
+
+} // namespace args_pool
+} // namespace starpu
+} // namespace nntile
+
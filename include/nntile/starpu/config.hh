@@ -20,16 +20,23 @@
 #include <cstring>
 #include <iostream>
 #include <starpu.h>
-// Disabled MPI for now
-//#include <starpu_mpi.h>
 #include <nntile/defs.h>
+#include <nntile/starpu/args_pool.hh>
+#include <nntile/starpu/task_graph.hh>
+
+#ifdef NNTILE_USE_MPI
+#   include <starpu_mpi.h>
+#else // NNTILE_USE_MPI
+// Fake StarPU-MPI definitions for a single-process build
+#   define MPI_COMM_WORLD 0
+#   define starpu_mpi_tag_t int64_t
+#endif // NNTILE_USE_MPI
 
 namespace nntile
 {
 
+#ifndef NNTILE_USE_MPI
 // Fake STARPU functions
-#define MPI_COMM_WORLD 0
-
 static int starpu_mpi_world_size()
 {
     return 1;
@@ -49,6 +56,7 @@ static int starpu_mpi_barrier(int comm)
 {
     return 0;
 }
+#endif // NNTILE_USE_MPI
 
 namespace starpu
 {
@@ -78,17 +86,30 @@ public:
         sched_policy_name = "dmda";
         // Save initial value
         cublas = cublas_;
+#ifdef NNTILE_USE_MPI
+        // Init StarPU together with MPI
+        ret = starpu_mpi_init_conf(nullptr, nullptr, 1, MPI_COMM_WORLD, this);
+        if(ret != 0)
+        {
+            throw std::runtime_error("Error in starpu_mpi_init_conf()");
+        }
+#else // NNTILE_USE_MPI
         // Init StarPU (master-slave)
         ret = starpu_init(this);
         if(ret != 0)
         {
             throw std::runtime_error("Error in starpu_initialize()");
         }
+#endif // NNTILE_USE_MPI
         else
         {
             int ncpus_ = starpu_worker_get_count_by_type(STARPU_CPU_WORKER);
             int ncuda_ = starpu_worker_get_count_by_type(STARPU_CUDA_WORKER);
             std::cout << "Initialized NCPU=" << ncpus_ << " NCUDA=" << ncuda_
+#ifdef NNTILE_USE_MPI
+                << " MPI_RANK=" << starpu_mpi_world_rank() << "/"
+                << starpu_mpi_world_size()
+#endif // NNTILE_USE_MPI
                 << "\n";
         }
 #ifdef NNTILE_USE_CUDA
@@ -112,7 +133,11 @@ public:
             std::cout << "Shutdown cuBLAS\n";
         }
 #endif // NNTILE_USE_CUDA
+#ifdef NNTILE_USE_MPI
+        starpu_mpi_shutdown();
+#else // NNTILE_USE_MPI
         starpu_shutdown();
+#endif // NNTILE_USE_MPI
         std::cout << "Shutdown StarPU\n";
     }
     //! StarPU commute data access mode
@@ -177,6 +202,10 @@ class Handle
         // All the tasks using given starpu data handle shall be finished
         // before unregistering the handle
         //std::cerr << "[nntile] unregister\n";
+        if(TaskGraph::capturing())
+        {
+            TaskGraph::capturing()->forget(ptr);
+        }
         starpu_data_unregister(ptr);
     }
     static void _deleter_no_coherency(starpu_data_handle_t ptr)
@@ -185,6 +214,10 @@ class Handle
         // All the tasks using given starpu data handle shall be finished
         // before unregistering the handle
         //std::cerr << "[nntile] unregister_no_coherency\n";
+        if(TaskGraph::capturing())
+        {
+            TaskGraph::capturing()->forget(ptr);
+        }
         starpu_data_unregister_no_coherency(ptr);
     }
     static void _deleter_temporary(starpu_data_handle_t ptr)
@@ -194,6 +227,12 @@ class Handle
         // starpu as it will be deallocated during actual unregistering and at
         // the time of submission.
         //std::cerr << "[nntile] unregister_submit\n";
+        // Captured task graph may use this data later
+        if(TaskGraph::capturing())
+        {
+            TaskGraph::capturing()->keep(ptr);
+            return;
+        }
         starpu_data_unregister_submit(ptr);
     }
     static std::shared_ptr<_starpu_data_state> _get_shared_ptr(
@@ -253,40 +292,56 @@ public:
     {
         handle.reset();
     }
+    //! Register handle within StarPU-MPI with a given tag and owner
+    /*! Does nothing in a single-process build */
+    void mpi_register(starpu_mpi_tag_t tag, int rank) const
+    {
+#ifdef NNTILE_USE_MPI
+        starpu_mpi_data_register(handle.get(), tag, rank);
+#endif // NNTILE_USE_MPI
+    }
     //! Get rank of the MPI node owning the data handle
     int mpi_get_rank() const
     {
+#ifdef NNTILE_USE_MPI
+        return starpu_mpi_data_get_rank(handle.get());
+#else // NNTILE_USE_MPI
         return 0;
-        //return starpu_mpi_data_get_rank(handle.get());
+#endif // NNTILE_USE_MPI
     }
     //! Get tag of the data handle
-    int mpi_get_tag() const
+    starpu_mpi_tag_t mpi_get_tag() const
     {
+#ifdef NNTILE_USE_MPI
+        return starpu_mpi_data_get_tag(handle.get());
+#else // NNTILE_USE_MPI
         return 0;
-        //return starpu_mpi_data_get_tag(handle.get());
+#endif // NNTILE_USE_MPI
     }
     //! Transfer data to a provided node rank
     void mpi_transfer(int dst_rank, int mpi_rank) const
     {
-        //if(mpi_rank == dst_rank or mpi_rank == mpi_get_rank())
-        //{
-        //    // This function shall be removed in near future, all data
-        //    // transfers shall be initiated by starpu_mpi_task_build and others
-        //    starpu_mpi_get_data_on_node_detached(MPI_COMM_WORLD,
-        //            handle.get(), dst_rank, nullptr, nullptr);
-        //    //int ret = starpu_mpi_get_data_on_node_detached(MPI_COMM_WORLD,
-        //    //        handle.get(), dst_rank, nullptr, nullptr);
-        //    //if(ret != 0)
-        //    //{
-        //    //    throw std::runtime_error("Error in starpu_mpi_get_data_on_"
-        //    //            "node_detached");
-        //    //}
-        //}
+#ifdef NNTILE_USE_MPI
+        if(mpi_rank == dst_rank or mpi_rank == mpi_get_rank())
+        {
+            // This function shall be removed in near future, all data
+            // transfers shall be initiated by starpu_mpi_task_build and others
+            int ret = starpu_mpi_get_data_on_node_detached(MPI_COMM_WORLD,
+                    handle.get(), dst_rank, nullptr, nullptr);
+            if(ret != 0)
+            {
+                throw std::runtime_error("Error in starpu_mpi_get_data_on_"
+                        "node_detached");
+            }
+        }
+#endif // NNTILE_USE_MPI
     }
     //! Flush cached data
     void mpi_flush() const
     {
-        //starpu_mpi_cache_flush(MPI_COMM_WORLD, handle.get());
+#ifdef NNTILE_USE_MPI
+        starpu_mpi_cache_flush(MPI_COMM_WORLD, handle.get());
+#endif // NNTILE_USE_MPI
     }
 };
 
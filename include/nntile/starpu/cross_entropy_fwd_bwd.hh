@@ -0,0 +1,86 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/cross_entropy_fwd_bwd.hh
+ * Fused cross entropy loss and its gradient on StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+#include <nntile/defs.h>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace cross_entropy_fwd_bwd
+{
+
+//! Structure for arguments
+template<typename T>
+struct args_t
+{
+    Index m;
+    Index n;
+    Index m_start;
+    T scale;
+    T grad_scale;
+};
+
+// Cross entropy loss and its gradient over StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+#ifdef NNTILE_USE_CUDA
+// Cross entropy loss and its gradient over StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CUDA
+
+extern Codelet codelet_fp32, codelet_fp64;
+
+template<typename T>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_t>()
+{
+    return &codelet_fp32;
+}
+
+template<>
+constexpr Codelet *codelet<fp64_t>()
+{
+    return &codelet_fp64;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename T>
+void submit(Index m, Index n, Index m_start, T scale, T grad_scale,
+        Handle maxsumexp, Handle src, Handle labels, Handle grad, Handle val,
+        int redux=0);
+
+} // namespace cross_entropy_fwd_bwd
+} // namespace starpu
+} // namespace nntile
+
@@ -40,7 +40,7 @@ template<typename T>
 void cpu(void *buffers[], void *cl_args)
     noexcept;
 
-extern Codelet codelet_fp32, codelet_fp64;
+extern Codelet codelet_fp32, codelet_fp64, codelet_bf16;
 
 template<typename T>
 constexpr Codelet *codelet()
@@ -61,6 +61,12 @@ constexpr Codelet *codelet<fp64_t>()
     return &codelet_fp64;
 }
 
+template<>
+constexpr Codelet *codelet<bf16_t>()
+{
+    return &codelet_bf16;
+}
+
 void init();
 
 void restrict_where(uint32_t where);
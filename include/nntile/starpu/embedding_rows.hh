@@ -0,0 +1,51 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/embedding_rows.hh
+ * Mark rows of embeddings, that are touched by tokens, on StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+#include <nntile/defs.h>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace embedding_rows
+{
+
+// Mark rows of embeddings, that are touched by tokens, on CPU
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+#ifdef NNTILE_USE_CUDA
+// Mark rows of embeddings, that are touched by tokens, on CUDA
+void cuda(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CUDA
+
+extern Codelet codelet;
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+void submit(Index nelems, Handle index, Handle rows);
+
+} // namespace embedding_rows
+} // namespace starpu
+} // namespace nntile
+
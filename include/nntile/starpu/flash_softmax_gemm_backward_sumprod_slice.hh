@@ -32,11 +32,9 @@ struct args_t
     Index batch;
 };
 
-#ifdef NNTILE_USE_CBLAS
 template<typename T>
 void cpu(void *buffers[], void *cl_args)
     noexcept;
-#endif // NNTILE_USE_CBLAS
 
 #ifdef NNTILE_USE_CUDA
 template<typename T>
@@ -25,8 +25,8 @@ namespace starpu
 namespace fp16_to_fp32
 {
 
-//void cpu(void *buffers[], void *cl_args)
-//    noexcept;
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
 
 #ifdef NNTILE_USE_CUDA
 void cuda(void *buffers[], void *cl_args)
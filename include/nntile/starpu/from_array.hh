@@ -0,0 +1,100 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/from_array.hh
+ * Copy a subarray of a contiguous host array into a StarPU buffer
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-12
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace from_array
+{
+
+// Copying from a host array is available only on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+extern Codelet codelet_fp16, codelet_bf16, codelet_fp32, codelet_fp64,
+       codelet_int64, codelet_bool, codelet_int8;
+
+template<typename T>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<fp16_t>()
+{
+    return &codelet_fp16;
+}
+
+template<>
+constexpr Codelet *codelet<bf16_t>()
+{
+    return &codelet_bf16;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_t>()
+{
+    return &codelet_fp32;
+}
+
+template<>
+constexpr Codelet *codelet<fp64_t>()
+{
+    return &codelet_fp64;
+}
+
+template<>
+constexpr Codelet *codelet<Index>()
+{
+    return &codelet_int64;
+}
+
+template<>
+constexpr Codelet *codelet<bool_t>()
+{
+    return &codelet_bool;
+}
+
+template<>
+constexpr Codelet *codelet<int8_t>()
+{
+    return &codelet_int8;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename T>
+void submit(Index ndim, const T *array, const std::vector<Index> &array_start,
+        const std::vector<Index> &array_stride,
+        const std::vector<Index> &tile_shape,
+        const std::vector<Index> &tile_stride, Handle tile,
+        Handle tmp_index);
+
+} // namespace from_array
+} // namespace starpu
+} // namespace nntile
+
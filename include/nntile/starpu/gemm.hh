@@ -44,6 +44,10 @@ struct args_t
 template<typename T>
 void cpu(void *buffers[], void *cl_args)
     noexcept;
+
+template<typename T>
+void cpu_half(void *buffers[], void *cl_args)
+    noexcept;
 #endif // NNTILE_USE_CBLAS
 
 #ifdef NNTILE_USE_CUDA
@@ -60,6 +64,9 @@ extern Codelet codelet_NN_fp32, codelet_NN_fp64,
 extern Codelet codelet_NN_fp16, codelet_NT_fp16,
        codelet_TN_fp16, codelet_TT_fp16;
 
+extern Codelet codelet_NN_bf16, codelet_NT_bf16,
+       codelet_TN_bf16, codelet_TT_bf16;
+
 template<typename T>
 static
 Codelet *codelet(TransOp transA, TransOp transB)
@@ -158,6 +165,36 @@ Codelet *codelet<fp16_t>(TransOp transA, TransOp transB)
     }
 }
 
+template<>
+Codelet *codelet<bf16_t>(TransOp transA, TransOp transB)
+{
+    switch(transA.value)
+    {
+        case TransOp::NoTrans:
+            switch(transB.value)
+            {
+                case TransOp::NoTrans:
+                    return &codelet_NN_bf16;
+                default:
+                // This parameter was already checked in gemm_check_opA_opB
+                //case TransOp::Trans:
+                    return &codelet_NT_bf16;
+            }
+        // This parameter was already checked in gemm_check_opA_opB
+        //case TransOp::Trans:
+        default:
+            switch(transB.value)
+            {
+                case TransOp::NoTrans:
+                    return &codelet_TN_bf16;
+                // This parameter was already checked in gemm_check_opA_opB
+                //case TransOp::Trans:
+                default:
+                    return &codelet_TT_bf16;
+            }
+    }
+}
+
 void init();
 
 void restrict_where(uint32_t where);
@@ -0,0 +1,82 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/gemm_int8.hh
+ * Matrix multiplication by per-channel quantized int8 weights on StarPU
+ * buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-20
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/constants.hh>
+#include <nntile/starpu/config.hh>
+#include <nntile/defs.h>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace gemm_int8
+{
+
+//! Structure for arguments
+template<typename T>
+struct args_t
+{
+    TransOp trans; // layout of input and output buffers
+    Index m; // number of output channels
+    Index n; // number of input vectors
+    Index k; // number of input channels
+    T alpha;
+    T beta;
+};
+
+//! Size of a scratch buffer in bytes for given sizes of a task
+template<typename T>
+constexpr Index scratch_size(Index n, Index k)
+{
+    return n*(sizeof(T)+sizeof(std::int32_t)) + (n+1)*k*sizeof(std::int16_t);
+}
+
+// Multiply StarPU buffer by int8 weights on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+extern Codelet codelet_fp32;
+
+template<typename T>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_t>()
+{
+    return &codelet_fp32;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename T>
+void submit(const TransOp &trans, Index m, Index n, Index k, T alpha,
+        Handle w, Handle w_scale, Handle x, T beta, Handle y, Handle scratch);
+
+} // namespace gemm_int8
+} // namespace starpu
+} // namespace nntile
+
@@ -0,0 +1,76 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/layer_norm_backward.hh
+ * Fused backward pass of layer normalization on StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-08
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace layer_norm_backward
+{
+
+//! Structure for arguments
+template<typename T>
+struct args_t
+{
+    Index m;
+    Index n;
+    Index k;
+};
+
+// StarPU wrapper for kernel::layer_norm_backward::cpu<T>
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+extern Codelet codelet_fp32, codelet_fp64;
+
+template<typename T>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_t>()
+{
+    return &codelet_fp32;
+}
+
+template<>
+constexpr Codelet *codelet<fp64_t>()
+{
+    return &codelet_fp64;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename T>
+void submit(Index m, Index n, Index k, Handle src_normalized,
+        Handle dst_grad, Handle gamma, Handle inv_stddev, Handle src_grad,
+        Handle gamma_grad, Handle beta_grad, int redux=0);
+
+} // namespace layer_norm_backward
+} // namespace starpu
+} // namespace nntile
+
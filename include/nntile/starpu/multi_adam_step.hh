@@ -0,0 +1,107 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/multi_adam_step.hh
+ * Fused Adam step over many tiles within a single StarPU task
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#pragma once
+
+#include <nntile/base_types.hh>
+#include <nntile/starpu/config.hh>
+#include <vector>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace multi_adam_step
+{
+
+//! Structure for arguments
+/*! Bias corrections are computed once at submission. Seed is used only for
+ * stochastic rounding of moments, stored in bf16_t. */
+template<typename T>
+struct args_t
+{
+    Index ntiles;
+    Index seed;
+    bool first_iter;
+    T beta_1;
+    T beta_2;
+    T eps;
+    T alpha;
+    T beta;
+    T l2_decay;
+    T p_scale;
+};
+
+// Apply Adam step to many tiles of StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+// Apply Adam step to many tiles with moments in bf16_t on CPU
+template<typename T>
+void cpu_bf16(void *buffers[], void *cl_args)
+    noexcept;
+
+#ifdef NNTILE_USE_CUDA
+// Apply Adam step to many tiles of StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept;
+#endif // NNTILE_USE_CUDA
+
+extern Codelet codelet_fp32, codelet_fp64, codelet_fp32_bf16;
+
+//! Codelet for parameters of type T and moments of type M
+template<typename T, typename M=T>
+constexpr Codelet *codelet()
+{
+    throw std::runtime_error("Non-supported type");
+    return nullptr;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_t>()
+{
+    return &codelet_fp32;
+}
+
+template<>
+constexpr Codelet *codelet<fp64_t>()
+{
+    return &codelet_fp64;
+}
+
+template<>
+constexpr Codelet *codelet<fp32_t, bf16_t>()
+{
+    return &codelet_fp32_bf16;
+}
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+template<typename T, typename M=T>
+void submit(Index num_iter, T beta_1, T beta_2, T eps, T lr, T weight_decay,
+        int decoupled, Index seed, const std::vector<Handle> &grad,
+        const std::vector<Handle> &first_moment,
+        const std::vector<Handle> &second_moment,
+        const std::vector<Handle> &p);
+
+} // namespace multi_adam_step
+} // namespace starpu
+} // namespace nntile
+
@@ -0,0 +1,48 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/read_tile.hh
+ * Read a StarPU buffer from a memory mapped file at a given offset
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-13
+ * */
+
+#pragma once
+
+#include <nntile/starpu/config.hh>
+#include <string>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace read_tile
+{
+
+// Read a StarPU buffer from a file on CPU
+void cpu(void *buffers[], void *cl_args)
+    noexcept;
+
+extern Codelet codelet;
+
+void init();
+
+void restrict_where(uint32_t where);
+
+void restore_where();
+
+//! Insert task to read buffer from a file
+void submit(Handle data, const std::string &filename, Index offset);
+
+//! Total number of read tasks, that failed
+Index nfailed();
+
+} // namespace read_tile
+} // namespace starpu
+} // namespace nntile
+
@@ -0,0 +1,152 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/task_graph.hh
+ * Capture of submitted StarPU tasks and their later replay
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-11
+ * */
+
+#pragma once
+
+#include <starpu.h>
+#include <nntile/base_types.hh>
+#include <nntile/starpu/tracer.hh>
+#include <atomic>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace nntile
+{
+namespace starpu
+{
+
+//! Recording of a sequence of submitted tasks, that can be submitted again
+/*! All tasks, submitted through task_insert(), task_submit() and data_cpy()
+ * by the capturing thread between begin_capture() and end_capture(), are
+ * executed as usual and also recorded together with their codelets, data
+ * handles, access modes, copies of codelet arguments and restrictions of
+ * tasks to architectures or workers. A call to replay() submits the same
+ * tasks again without going through the code, that produced them. Data
+ * handles can be substituted at replay, which allows to feed a new input
+ * into a recorded training step.
+ *
+ * Temporary handles, that are unregistered during capture, are kept alive
+ * until the graph is destroyed. All the other handles, used by the recorded
+ * tasks, must outlive the graph. Capture is supported only for a single MPI
+ * process, as data transfers between nodes are not tasks.
+ * */
+class TaskGraph
+{
+    //! Kind of a recorded operation
+    enum class OpKind
+    {
+        task,
+        data_cpy
+    };
+    //! Recorded operation
+    struct Op
+    {
+        OpKind kind;
+        starpu_codelet *cl;
+        // Offsets of the first handle and of the codelet arguments
+        Index handle_offset;
+        Index nbuffers;
+        Index args_offset;
+        std::size_t args_size;
+        double flops;
+        int priority;
+        // Restriction of the task to architectures or to a single worker
+        int32_t where;
+        unsigned execute_on_a_specific_worker;
+        unsigned workerid;
+    };
+    std::vector<Op> ops;
+    std::vector<starpu_data_handle_t> handles;
+    std::vector<starpu_data_access_mode> modes;
+    // Copies of codelet arguments, aligned as if allocated by malloc
+    std::vector<std::max_align_t> args;
+    // Temporary handles, whose unregistration is delayed till destruction
+    std::vector<starpu_data_handle_t> kept_handles;
+    // Handle substitutions for replay
+    std::unordered_map<starpu_data_handle_t, starpu_data_handle_t>
+        substitutions;
+    // Number of replayed tasks, that are not yet finished
+    std::atomic<Index> ninflight{0};
+    // Whether a handle of a recorded task was unregistered during capture
+    bool broken = false;
+    //! Graph, that records submissions of the current thread
+    static thread_local TaskGraph *capturing_graph;
+    static void _task_done(void *graph);
+    starpu_data_handle_t _substitute(starpu_data_handle_t handle) const;
+public:
+    TaskGraph() = default;
+    TaskGraph(const TaskGraph &) = delete;
+    TaskGraph &operator=(const TaskGraph &) = delete;
+    //! Waits for replayed tasks and unregisters kept temporary handles
+    ~TaskGraph();
+    //! Start recording of tasks, submitted by the current thread
+    void begin_capture();
+    //! Stop recording
+    void end_capture();
+    //! Remove all recorded tasks
+    void clear();
+    //! Replace a data handle of recorded tasks with another one at replay
+    /*! Substitution of a handle by itself cancels it. */
+    void substitute(starpu_data_handle_t from, starpu_data_handle_t to);
+    //! Submit all recorded tasks again
+    void replay();
+    //! Number of recorded operations
+    Index size() const
+    {
+        return ops.size();
+    }
+    //! Graph, that records submissions of the current thread, if any
+    static TaskGraph *capturing()
+    {
+        return capturing_graph;
+    }
+    //! Record a task, that is about to be submitted
+    void record(starpu_task *task);
+    //! Record an asynchronous copy of data
+    void record_data_cpy(starpu_data_handle_t dst, starpu_data_handle_t src);
+    //! Keep a temporary handle, that is unregistered during capture
+    void keep(starpu_data_handle_t handle);
+    //! Notify that a handle is unregistered during capture
+    void forget(starpu_data_handle_t handle);
+};
+
+//! Submit a task, recording and tracing it if needed
+int task_submit(starpu_task *task);
+
+//! Insert a task just like starpu_task_insert, recording and tracing it if
+//! needed
+/*! Arguments are the same as for starpu_task_insert() */
+template<typename... Args>
+int task_insert(starpu_codelet *cl, Args... args)
+{
+    // Fast path without capture and tracing
+    if(TaskGraph::capturing() == nullptr and Tracer::active() == nullptr)
+    {
+        return starpu_task_insert(cl, args...);
+    }
+    starpu_task *task = starpu_task_build(cl, args...);
+    if(task == nullptr)
+    {
+        return -1;
+    }
+    return task_submit(task);
+}
+
+//! Asynchronous copy of data, recording it if capture is active
+int data_cpy(starpu_data_handle_t dst, starpu_data_handle_t src);
+
+} // namespace starpu
+} // namespace nntile
+
@@ -0,0 +1,132 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/starpu/tracer.hh
+ * Lightweight tracer of StarPU tasks with Chrome/Perfetto JSON output
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#pragma once
+
+#include <starpu.h>
+#include <nntile/base_types.hh>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace nntile
+{
+namespace starpu
+{
+
+//! Recording of timings of submitted StarPU tasks
+/*! While a tracer is active, every task, submitted through task_insert() or
+ * task_submit() or replayed by a TaskGraph, gets an event with its codelet
+ * name, times of submission, start and end, worker and accessed tiles. Start
+ * and end times are taken from StarPU profiling information, which does not
+ * require a StarPU build with FxT, so StarPU profiling is enabled while a
+ * tracer is active. Events are marked by the current scope, that is a path
+ * of names, pushed by the submitting thread, like "forward/Linear_3". Every
+ * thread has its own stack of scopes, so tasks, submitted by a background
+ * thread, are not marked by scopes of the main thread.
+ * Copies of data through data_cpy() are not traced, as they are not tasks
+ * of NNTile.
+ *
+ * Events are written in Chrome trace event JSON format, that can be opened
+ * by Perfetto UI or chrome://tracing.
+ * */
+class Tracer
+{
+    //! Recorded task
+    struct Event
+    {
+        const char *name;
+        Index scope;
+        int workerid;
+        double submit;
+        double start;
+        double end;
+        // Access modes and identifiers of tiles
+        std::string tiles;
+    };
+    //! Link between a traced task and its original callback
+    struct Pending
+    {
+        Tracer *tracer;
+        Index event;
+        void (*callback_func)(void *);
+        void *callback_arg;
+        unsigned callback_arg_free;
+    };
+    //! Stack of names of scopes of a thread and its current scope
+    struct ThreadScope
+    {
+        std::vector<std::string> stack;
+        Index current = 0;
+    };
+    std::vector<Event> events;
+    // Guards events and scopes, as tasks are submitted and finish in
+    // different threads
+    std::mutex mutex;
+    // Paths of all scopes and scopes of submitting threads
+    std::vector<std::string> scopes;
+    std::unordered_map<std::string, Index> scope_ids;
+    std::unordered_map<std::thread::id, ThreadScope> thread_scopes;
+    // Starting time of tracing in microseconds
+    double time0;
+    // Number of traced tasks, that are not yet finished
+    std::atomic<Index> ninflight{0};
+    // Whether StarPU profiling was enabled before start()
+    int prev_profiling;
+    //! Tracer, that records all submitted tasks
+    static std::atomic<Tracer *> active_tracer;
+    static void _task_done(void *pending);
+    void _wait();
+public:
+    Tracer();
+    Tracer(const Tracer &) = delete;
+    Tracer &operator=(const Tracer &) = delete;
+    //! Stops tracing and waits for traced tasks
+    ~Tracer();
+    //! Start recording of tasks
+    void start();
+    //! Stop recording
+    void stop();
+    //! Remove all recorded events
+    void clear();
+    //! Enter a named scope, nested into the current one of the thread
+    void push_scope(const std::string &name);
+    //! Leave the current scope of the thread
+    void pop_scope();
+    //! Number of recorded events
+    Index size() const
+    {
+        return events.size();
+    }
+    //! Write recorded events as Chrome trace event JSON
+    void save(const std::string &filename);
+    //! Total execution time of tasks of each scope in microseconds
+    std::map<std::string, double> scope_totals();
+    //! Tracer, that records all submitted tasks, if any
+    static Tracer *active()
+    {
+        return active_tracer.load(std::memory_order_acquire);
+    }
+    //! Attach an event to a task, that is about to be submitted
+    void trace(starpu_task *task);
+    //! Detach event from a task, whose submission failed
+    void cancel(starpu_task *task);
+};
+
+} // namespace starpu
+} // namespace nntile
@@ -85,7 +85,19 @@
 #include <nntile/tensor/hypot_scalar_inverse.hh>
 #include <nntile/tensor/adam_step.hh>
 #include <nntile/tensor/adamw_step.hh>
+#include <nntile/tensor/amp_unscale.hh>
+#include <nntile/tensor/cross_entropy_fwd_bwd.hh>
+#include <nntile/tensor/embedding_rows.hh>
+#include <nntile/tensor/clear_rows.hh>
+#include <nntile/tensor/sparse_adam_step.hh>
+#include <nntile/tensor/multi_adam_step.hh>
+#include <nntile/tensor/gemm_int8.hh>
 #include <nntile/tensor/transpose.hh>
+#include <nntile/tensor/layer_norm_forward.hh>
+#include <nntile/tensor/layer_norm_backward.hh>
+#include <nntile/tensor/from_array.hh>
+#include <nntile/tensor/to_array.hh>
+#include <nntile/tensor/checkpoint.hh>
 
 namespace nntile
 {
@@ -0,0 +1,39 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/amp_unscale.hh
+ * Unscale gradient tensor and check it for infinite and NaN values
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-19
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous tensor-wise unscale with inf/NaN check
+template<typename T>
+void amp_unscale_async(T inv_scale, const Tensor<T> &data,
+        const Tensor<bool_t> &nonfinite);
+
+// Blocking version of tensor-wise unscale with inf/NaN check
+template<typename T>
+void amp_unscale(T inv_scale, const Tensor<T> &data,
+        const Tensor<bool_t> &nonfinite);
+
+// Check if any flag, set by amp_unscale_async(), is set on any node
+bool amp_nonfinite(const Tensor<bool_t> &nonfinite);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,48 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/checkpoint.hh
+ * Save and load Tensor<T> in a tile-aligned binary file
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-13
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <string>
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Alignment of data of every tile in a checkpoint file
+/*! Tiles are aligned to a page, so that each of them can be mapped into
+ * memory on its own. */
+constexpr Index checkpoint_alignment = 4096;
+
+// Asynchronous save of tiles of a tensor into a checkpoint file
+template<typename T>
+void save_async(const Tensor<T> &src, const std::string &filename);
+
+// Blocking version of save of tiles of a tensor into a checkpoint file
+template<typename T>
+void save(const Tensor<T> &src, const std::string &filename);
+
+// Asynchronous load of tiles of a tensor from a checkpoint file
+template<typename T>
+void load_async(const Tensor<T> &dst, const std::string &filename);
+
+// Blocking version of load of tiles of a tensor from a checkpoint file
+template<typename T>
+void load(const Tensor<T> &dst, const std::string &filename);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,34 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/clear_rows.hh
+ * Clear marked rows of a matrix for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous tensor-wise clear of marked rows
+template<typename T>
+void clear_rows_async(const Tensor<bool_t> &rows, const Tensor<T> &dst);
+
+// Blocking version of tensor-wise clear of marked rows
+template<typename T>
+void clear_rows(const Tensor<bool_t> &rows, const Tensor<T> &dst);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,40 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/cross_entropy_fwd_bwd.hh
+ * Fused cross entropy loss and its gradient for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous tensor-wise cross entropy loss and its gradient
+template<typename T>
+void cross_entropy_fwd_bwd_async(T scale, T grad_scale,
+        const Tensor<T> &maxsumexp, const Tensor<T> &src,
+        const Tensor<Index> &labels, const Tensor<T> &grad,
+        const Tensor<T> &val, int redux=0, Index start=0);
+
+// Blocking version of tensor-wise cross entropy loss and its gradient
+template<typename T>
+void cross_entropy_fwd_bwd(T scale, T grad_scale,
+        const Tensor<T> &maxsumexp, const Tensor<T> &src,
+        const Tensor<Index> &labels, const Tensor<T> &grad,
+        const Tensor<T> &val, int redux=0, Index start=0);
+
+} // namespace tensor
+} // namespace nntile
+
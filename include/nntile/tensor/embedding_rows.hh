@@ -0,0 +1,33 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/embedding_rows.hh
+ * Mark rows of embeddings, that are touched by tokens, for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous tensor-wise marking of rows of embeddings
+void embedding_rows_async(const Tensor<Index> &index,
+        const Tensor<bool_t> &rows);
+
+// Blocking version of tensor-wise marking of rows of embeddings
+void embedding_rows(const Tensor<Index> &index, const Tensor<bool_t> &rows);
+
+} // namespace tensor
+} // namespace nntile
+
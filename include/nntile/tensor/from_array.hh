@@ -0,0 +1,34 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/from_array.hh
+ * Copy a contiguous host array into Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-12
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous copy of a host array into tiles of a tensor
+template<typename T>
+void from_array_async(const T *array, const Tensor<T> &dst);
+
+// Blocking version of copy of a host array into tiles of a tensor
+template<typename T>
+void from_array(const T *array, const Tensor<T> &dst);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,44 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/gemm_int8.hh
+ * Multiplication of Tensor<T> by per-channel quantized int8 weights
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-20
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <nntile/constants.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Check if tensors match gemm_int8
+void gemm_int8_check(const TransOp &trans, const TensorTraits &w,
+        const TensorTraits &w_scale, const TensorTraits &x,
+        const TensorTraits &y, Index ndim);
+
+// Asynchronous tensor-wise multiplication by int8 weights
+template<typename T>
+void gemm_int8_async(T alpha, const TransOp &trans, const Tensor<int8_t> &w,
+        const Tensor<T> &w_scale, const Tensor<T> &x, T beta,
+        const Tensor<T> &y, Index ndim);
+
+// Blocking version of tensor-wise multiplication by int8 weights
+template<typename T>
+void gemm_int8(T alpha, const TransOp &trans, const Tensor<int8_t> &w,
+        const Tensor<T> &w_scale, const Tensor<T> &x, T beta,
+        const Tensor<T> &y, Index ndim);
+
+} // namespace tensor
+} // namespace nntile
+
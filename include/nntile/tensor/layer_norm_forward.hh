@@ -0,0 +1,38 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/layer_norm_forward.hh
+ * Fused forward pass of layer normalization for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-08
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void layer_norm_forward_async(T eps, const Tensor<T> &src,
+        const Tensor<T> &gamma, const Tensor<T> &beta, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &src_normalized,
+        const Tensor<T> &dst, Index axis);
+
+template<typename T>
+void layer_norm_forward(T eps, const Tensor<T> &src, const Tensor<T> &gamma,
+        const Tensor<T> &beta, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &src_normalized,
+        const Tensor<T> &dst, Index axis);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,44 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/multi_adam_step.hh
+ * Fused Adam step over many tensors with packing of small tiles
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+#include <vector>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous fused Adam step over many tensors with moments of type M,
+// that is either T or bf16_t
+template<typename T, typename M=T>
+void multi_adam_step_async(Index num_iter, T beta_1, T beta_2, T eps, T lr,
+        T weight_decay, int decoupled, const std::vector<Tensor<T>> &grad,
+        const std::vector<Tensor<M>> &first_moment,
+        const std::vector<Tensor<M>> &second_moment,
+        const std::vector<Tensor<T>> &p, Index pack_nelems);
+
+// Blocking version of fused Adam step over many tensors
+template<typename T, typename M=T>
+void multi_adam_step(Index num_iter, T beta_1, T beta_2, T eps, T lr,
+        T weight_decay, int decoupled, const std::vector<Tensor<T>> &grad,
+        const std::vector<Tensor<M>> &first_moment,
+        const std::vector<Tensor<M>> &second_moment,
+        const std::vector<Tensor<T>> &p, Index pack_nelems);
+
+} // namespace tensor
+} // namespace nntile
+
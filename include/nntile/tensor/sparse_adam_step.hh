@@ -0,0 +1,42 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/sparse_adam_step.hh
+ * Lazy Adam step over marked rows of a matrix for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous tensor-wise lazy Adam step over marked rows
+template<typename T>
+void sparse_adam_step_async(T beta_1, T beta_2, T eps, T lr, T weight_decay,
+        int decoupled, const Tensor<bool_t> &rows,
+        const Tensor<Index> &row_step, const Tensor<T> &grad,
+        const Tensor<T> &first_moment, const Tensor<T> &second_moment,
+        const Tensor<T> &p);
+
+// Blocking version of tensor-wise lazy Adam step over marked rows
+template<typename T>
+void sparse_adam_step(T beta_1, T beta_2, T eps, T lr, T weight_decay,
+        int decoupled, const Tensor<bool_t> &rows,
+        const Tensor<Index> &row_step, const Tensor<T> &grad,
+        const Tensor<T> &first_moment, const Tensor<T> &second_moment,
+        const Tensor<T> &p);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -17,15 +17,12 @@
 #include <cstdlib>
 #include <nntile/tensor/traits.hh>
 #include <nntile/tile/tile.hh>
-//#include <starpu_mpi.h>
 #include <starpu.h>
 #include <nntile/starpu/accumulate.hh>
 #include <nntile/starpu/accumulate_hypot.hh>
 #include <nntile/starpu/accumulate_maxsumexp.hh>
 #include <nntile/starpu/clear.hh>
 
-#define starpu_mpi_tag_t int64_t
-
 namespace nntile
 {
 namespace tensor
@@ -38,6 +35,15 @@ static std::ostream &operator<<(std::ostream &cout, fp16_t val)
     return cout;
 }
 
+//! Kind of reduction methods, set for all tiles of a tensor
+enum class TensorReduction: int
+{
+    none = 0,
+    add,
+    hypot,
+    maxsumexp
+};
+
 //! Many-dimensional tensor, presented by a set of subtensors (tiles)
 //
 // This is the main data storage class, that assumes a tensor as a set of
@@ -54,6 +60,8 @@ public:
     std::vector<int> tile_distr;
     //! Next tag to be used
     starpu_mpi_tag_t next_tag;
+    //! Reduction methods of tiles
+    TensorReduction reduction = TensorReduction::none;
     //! Constructor
     explicit Tensor(const TensorTraits &traits,
             const std::vector<int> &distribution,
@@ -81,11 +89,9 @@ public:
             // Set StarPU-managed handle
             tile_handles.emplace_back(sizeof(T)*tile_traits[i].nelems,
                     STARPU_R);
-            // Register tile with MPI
-            //starpu_mpi_data_register(
-            //        static_cast<starpu_data_handle_t>(tile_handles[i]),
-            //        last_tag, distribution[i]);
-            //++last_tag;
+            // Register tile with MPI, so that every node knows its owner
+            tile_handles[i].mpi_register(last_tag, distribution[i]);
+            ++last_tag;
         }
         next_tag = last_tag;
     }
@@ -132,6 +138,37 @@ public:
             tile_handles[i].unregister();
         }
     }
+    //! Store tiles in the given handles instead of own ones
+    /*! Current values of tiles are lost. A handle may be shared by tiles of
+     * several tensors as long as their values are never alive at the same
+     * time, as StarPU orders all the tasks, that access a handle. Size of
+     * every handle shall match size of its tile, as starpu_data_cpy() copies
+     * entire handles, and the handle shall be owned by the same MPI node as
+     * the tile. Handles of tensors with reduction methods shall be shared
+     * only by tensors of the same type and the same kind of reduction.
+     * */
+    void alias_tiles(const std::vector<starpu::VariableHandle> &handles)
+    {
+        if(handles.size() != grid.nelems)
+        {
+            throw std::runtime_error("Wrong number of handles");
+        }
+        for(Index i = 0; i < grid.nelems; ++i)
+        {
+            auto tmp = static_cast<starpu_data_handle_t>(handles[i]);
+            if(starpu_variable_get_elemsize(tmp)
+                    != sizeof(T)*tile_traits[i].nelems)
+            {
+                throw std::runtime_error("Handle size does not match tile");
+            }
+            if(handles[i].mpi_get_rank() != tile_distr[i])
+            {
+                throw std::runtime_error("Handle is owned by a wrong node");
+            }
+        }
+        tile_handles = handles;
+        _set_reduction_methods();
+    }
     //! Invalidate tensor values
     void invalidate_submit() const
     {
@@ -142,6 +179,19 @@ public:
             //starpu_data_invalidate_submit(tmp);
         }
     }
+    //! Drop tensor values, so that StarPU can reuse their memory
+    /*! Unlike invalidate_submit(), this is always active. It is meant for
+     * tensors, that are fully recomputed before their next use, like
+     * activations dropped by activation checkpointing.
+     * */
+    void discard_submit() const
+    {
+        for(Index i = 0; i < grid.nelems; ++i)
+        {
+            auto tmp = static_cast<starpu_data_handle_t>(get_tile_handle(i));
+            starpu_data_invalidate_submit(tmp);
+        }
+    }
     //! Advice to evict data from GPU
     void wont_use() const
     {
@@ -157,40 +207,49 @@ public:
     {
         for(Index i = 0; i < grid.nelems; ++i)
         {
-            auto tmp = static_cast<starpu_data_handle_t>(get_tile_handle(i));
-            //starpu_mpi_cache_flush(MPI_COMM_WORLD, tmp);
+            tile_handles[i].mpi_flush();
         }
     }
     //! Set reduction function for addition
-    void set_reduction_add() const
+    void set_reduction_add()
     {
-        for(Index i = 0; i < grid.nelems; ++i)
-        {
-            auto tmp = static_cast<starpu_data_handle_t>(get_tile_handle(i));
-            starpu_data_set_reduction_methods(tmp,
-                    nntile::starpu::accumulate::codelet<T>(),
-                    &nntile::starpu::clear::codelet);
-        }
+        reduction = TensorReduction::add;
+        _set_reduction_methods();
     }
     //! Set reduction function for hypot
-    void set_reduction_hypot() const
+    void set_reduction_hypot()
     {
-        for(Index i = 0; i < grid.nelems; ++i)
-        {
-            auto tmp = static_cast<starpu_data_handle_t>(get_tile_handle(i));
-            starpu_data_set_reduction_methods(tmp,
-                    nntile::starpu::accumulate_hypot::codelet<T>(),
-                    &nntile::starpu::clear::codelet);
-        }
+        reduction = TensorReduction::hypot;
+        _set_reduction_methods();
     }
     //! Set reduction function for maxsumexp
-    void set_reduction_maxsumexp() const
+    void set_reduction_maxsumexp()
     {
+        reduction = TensorReduction::maxsumexp;
+        _set_reduction_methods();
+    }
+    //! Set reduction methods of all tiles according to reduction kind
+    void _set_reduction_methods() const
+    {
+        starpu_codelet *redux_cl;
+        switch(reduction)
+        {
+            case TensorReduction::add:
+                redux_cl = nntile::starpu::accumulate::codelet<T>();
+                break;
+            case TensorReduction::hypot:
+                redux_cl = nntile::starpu::accumulate_hypot::codelet<T>();
+                break;
+            case TensorReduction::maxsumexp:
+                redux_cl = nntile::starpu::accumulate_maxsumexp::codelet<T>();
+                break;
+            default:
+                return;
+        }
         for(Index i = 0; i < grid.nelems; ++i)
         {
             auto tmp = static_cast<starpu_data_handle_t>(get_tile_handle(i));
-            starpu_data_set_reduction_methods(tmp,
-                    nntile::starpu::accumulate_maxsumexp::codelet<T>(),
+            starpu_data_set_reduction_methods(tmp, redux_cl,
                     &nntile::starpu::clear::codelet);
         }
     }
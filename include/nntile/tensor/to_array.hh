@@ -0,0 +1,34 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file include/nntile/tensor/to_array.hh
+ * Copy Tensor<T> into a contiguous host array
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-12
+ * */
+
+#pragma once
+
+#include <nntile/tensor/tensor.hh>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Asynchronous copy of tiles of a tensor into a host array
+template<typename T>
+void to_array_async(const Tensor<T> &src, T *array);
+
+// Blocking version of copy of tiles of a tensor into a host array
+template<typename T>
+void to_array(const Tensor<T> &src, T *array);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -35,27 +35,30 @@ void cpu(Index nelems, const T* src, T* dst)
  * @param[inout] dst: Destination of the maxsumexp accumulation
  * */
 {
-    constexpr T zero = 0.0;
+    using Y = compute_t<T>;
+    constexpr Y zero = 0.0;
     for(Index i = 0; i < nelems; ++i)
     {
+        const Y src_max = src[2*i], src_sum = src[2*i+1];
         // Do nothing if sum of exponents of source is zero
-        if(src[2*i+1] != zero)
+        if(src_sum != zero)
         {
+            const Y dst_max = dst[2*i], dst_sum = dst[2*i+1];
             // Overwrite if old value of sum is zero
-            if(dst[2*i+1] == zero)
+            if(dst_sum == zero)
             {
                 dst[2*i] = src[2*i];
                 dst[2*i+1] = src[2*i+1];
             }
             // Otherwise update based on maximum
-            else if(dst[2*i] < src[2*i])
+            else if(dst_max < src_max)
             {
-                dst[2*i+1] = src[2*i+1] + dst[2*i+1]*std::exp(dst[2*i]-src[2*i]);
+                dst[2*i+1] = src_sum + dst_sum*std::exp(dst_max-src_max);
                 dst[2*i] = src[2*i];
             }
             else
             {
-                dst[2*i+1] += src[2*i+1]*std::exp(src[2*i]-dst[2*i]);
+                dst[2*i+1] = dst_sum + src_sum*std::exp(src_max-dst_max);
             }
         }
     }
@@ -70,6 +73,10 @@ template
 void cpu<fp64_t>(Index nelems, const fp64_t* src, fp64_t* dst)
     noexcept;
 
+template
+void cpu<bf16_t>(Index nelems, const bf16_t* src, bf16_t* dst)
+    noexcept;
+
 } // namespace accumulate_maxsumexp
 } // namespace kernel
 } // namespace nntile
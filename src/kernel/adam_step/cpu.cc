@@ -14,7 +14,10 @@
  * */
 
 #include "nntile/kernel/adam_step/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 #include <cmath>
+#include <cstring>
+#include <type_traits>
 
 namespace nntile
 {
@@ -43,44 +46,228 @@ void cpu(Index num_iter, Index num_elems, T beta_1, T beta_2, T eps, T lr, T wei
  * @param[inout] p: Input buffers with parameter that are updated in the end
  * */
 {
-    T alpha = lr / (1 - ::pow(beta_1, num_iter));
-    T beta = 1.0 / std::sqrt(1 - std::pow(beta_2, num_iter));
-    // Cycle over buffers
+    // Bias corrections depend only on the iteration number
+    T alpha = lr / (1 - std::pow(beta_1, num_iter));
+    T beta = 1 / std::sqrt(1 - std::pow(beta_2, num_iter));
+    cpu_apply<T>(num_elems, num_iter == 1, beta_1, beta_2, eps, alpha, beta,
+            weight_decay, T(1), grad, first_moment, second_moment, p);
+}
+
+// Mix bits of a 32-bit integer, so that consecutive integers produce
+// independent pseudo-random numbers
+static NNTILE_SIMD_INLINE
+uint32_t hash32(uint32_t x)
+    noexcept
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+// Store moment in the same type as parameters
+template<typename T>
+static NNTILE_SIMD_INLINE
+void store_moment(T *dst, T val, uint32_t rand)
+    noexcept
+{
+    *dst = val;
+}
+
+// Store moment in bf16_t with stochastic rounding: the value is rounded up
+// with probability, equal to the distance to the lower neighbour divided by
+// the distance between neighbours. Therefore, rounding is unbiased, and small
+// updates of moments are not lost, as it happens with rounding to nearest.
+// NaN is kept quiet.
+static NNTILE_SIMD_INLINE
+void store_moment(bf16_t *dst, fp32_t val, uint32_t rand)
+    noexcept
+{
+    uint32_t bits;
+    std::memcpy(&bits, &val, sizeof(bits));
+    if((bits & 0x7fffffffu) > 0x7f800000u)
+    {
+        bits |= 0x00400000u;
+    }
+    else
+    {
+        bits += rand & 0xffffu;
+    }
+    dst->value = static_cast<uint16_t>(bits >> 16);
+}
+
+// Loop of the fused Adam step without branches inside. Moments are stored in
+// type M and updated in type T.
+template<typename T, typename M, bool first_iter, bool use_l2>
+static NNTILE_SIMD_INLINE
+void cpu_apply_loop(Index num_elems, T beta_1, T beta_2, T eps, T alpha,
+        T beta, T l2_decay, T p_scale, uint32_t seed, const T *grad,
+        M *first_moment, M *second_moment, T *p)
+    noexcept
+{
+    constexpr bool round_moments = std::is_same<M, bf16_t>::value;
+    const T one_beta_1 = 1 - beta_1, one_beta_2 = 1 - beta_2;
+    const T sqrt_one_beta_2 = std::sqrt(one_beta_2);
+    NNTILE_SIMD
     for(Index i = 0; i < num_elems; ++i)
     {
         // Read values (param+grad) from RAM only once
         T p_val = p[i], grad_val = grad[i];
-        if (weight_decay != 0)
+        if(use_l2)
         {
-            grad_val += weight_decay * p_val;
+            grad_val += l2_decay * p_val;
         }
+        p_val *= p_scale;
         // Read values (first+second moments) from RAM no more than once and
         // update them in the RAM immediately
         T f_val, s_val;
-        if(num_iter == 1)
+        if(first_iter)
         {
-            f_val = (1. - beta_1) * grad_val;
-            first_moment[i] = f_val;
-            s_val = std::sqrt(1-beta_2) * std::fabs(grad_val);
-            second_moment[i] = s_val;
+            f_val = one_beta_1 * grad_val;
+            s_val = sqrt_one_beta_2 * std::fabs(grad_val);
         }
         else
         {
-            f_val = first_moment[i];
-            s_val = second_moment[i];
-            f_val = beta_1*f_val + (1-beta_1)*grad_val;
-            first_moment[i] = f_val;
-            s_val = std::hypot(std::sqrt(beta_2)*s_val,
-                    std::sqrt(1-beta_2)*grad_val);
-            second_moment[i] = s_val;
+            f_val = beta_1*T(first_moment[i]) + one_beta_1*grad_val;
+            // Square root of the sum of squares instead of std::hypot, as
+            // it vectorizes
+            T s_old = second_moment[i];
+            s_val = std::sqrt(beta_2*s_old*s_old
+                    + one_beta_2*grad_val*grad_val);
         }
-        // Update parameters using only data in registers
-        T denom = s_val*beta + eps;
-        //T denom = ::sqrt(s_val * beta) + eps;
-        p[i] = p_val - alpha*f_val/denom;
+        // Lower and upper halves of a random number are used for rounding
+        // of the first and the second moments
+        uint32_t rand = 0;
+        if(round_moments)
+        {
+            rand = hash32(seed+static_cast<uint32_t>(i));
+        }
+        store_moment(first_moment+i, f_val, rand);
+        store_moment(second_moment+i, s_val, rand>>16);
+        // Update parameters using only data in registers, that are not
+        // rounded
+        p[i] = p_val - alpha*f_val/(s_val*beta+eps);
     }
 }
 
+// Choose the loop of the fused Adam step by the first iteration flag and the
+// l2 regularizer
+template<typename T, typename M>
+static NNTILE_SIMD_INLINE
+void cpu_apply_select(Index num_elems, bool first_iter, T beta_1, T beta_2,
+        T eps, T alpha, T beta, T l2_decay, T p_scale, uint32_t seed,
+        const T *grad, M *first_moment, M *second_moment, T *p)
+    noexcept
+{
+    if(first_iter)
+    {
+        if(l2_decay != 0)
+        {
+            cpu_apply_loop<T, M, true, true>(num_elems, beta_1, beta_2, eps,
+                    alpha, beta, l2_decay, p_scale, seed, grad, first_moment,
+                    second_moment, p);
+        }
+        else
+        {
+            cpu_apply_loop<T, M, true, false>(num_elems, beta_1, beta_2, eps,
+                    alpha, beta, l2_decay, p_scale, seed, grad, first_moment,
+                    second_moment, p);
+        }
+    }
+    else
+    {
+        if(l2_decay != 0)
+        {
+            cpu_apply_loop<T, M, false, true>(num_elems, beta_1, beta_2, eps,
+                    alpha, beta, l2_decay, p_scale, seed, grad, first_moment,
+                    second_moment, p);
+        }
+        else
+        {
+            cpu_apply_loop<T, M, false, false>(num_elems, beta_1, beta_2,
+                    eps, alpha, beta, l2_decay, p_scale, seed, grad,
+                    first_moment, second_moment, p);
+        }
+    }
+}
+
+template<typename T>
+NNTILE_CPU_DISPATCH
+void cpu_apply(Index num_elems, bool first_iter, T beta_1, T beta_2, T eps,
+        T alpha, T beta, T l2_decay, T p_scale, const T *grad,
+        T *first_moment, T *second_moment, T *p)
+    noexcept
+//! Fused Adam step on buffers with precomputed bias corrections on CPU
+/*! Bias corrections of both moments depend only on the iteration number, so
+ * they are computed once by the caller, that can apply the same step to many
+ * buffers. Both Adam (l2_decay=weight_decay, p_scale=1) and AdamW
+ * (l2_decay=0, p_scale=1-lr*weight_decay) are covered:
+ *      g = grad + l2_decay*p,
+ *      p *= p_scale,
+ *      first_moment = beta_1*first_moment + (1-beta_1)*g,
+ *      second_moment = sqrt(beta_2*second_moment^2 + (1-beta_2)*g^2),
+ *      p -= alpha*first_moment / (beta*second_moment+eps).
+ * Moments are not read at the first iteration.
+ *
+ * @param[in] num_elems: Number of elements in buffers
+ * @param[in] first_iter: Whether this is the first iteration
+ * @param[in] beta_1: parameter for moving average of first moments
+ * @param[in] beta_2: parameter for moving average of second moments
+ * @param[in] eps: small scalar to avoid division by zero
+ * @param[in] alpha: learning rate divided by 1-beta_1^num_iter
+ * @param[in] beta: 1/sqrt(1-beta_2^num_iter)
+ * @param[in] l2_decay: coefficient for l2 regularizer
+ * @param[in] p_scale: multiplier for decoupled weight decay
+ * @param[in] grad: Input buffer stored gradient
+ * @param[inout] first_moment: Buffer stored first moments
+ * @param[inout] second_moment: Buffer stored square root of second moments
+ * @param[inout] p: Parameters that are updated
+ * */
+{
+    cpu_apply_select<T, T>(num_elems, first_iter, beta_1, beta_2, eps, alpha,
+            beta, l2_decay, p_scale, 0, grad, first_moment, second_moment, p);
+}
+
+template<typename T>
+NNTILE_CPU_DISPATCH
+void cpu_apply(Index num_elems, bool first_iter, T beta_1, T beta_2, T eps,
+        T alpha, T beta, T l2_decay, T p_scale, Index seed, const T *grad,
+        bf16_t *first_moment, bf16_t *second_moment, T *p)
+    noexcept
+//! Fused Adam step on buffers with moments stored in bf16_t on CPU
+/*! The same step as above, but moments are stored in bf16_t to halve their
+ * memory footprint in comparison with fp32_t. Moments are updated in type T
+ * and rounded to bf16_t stochastically, while parameters are updated with
+ * the moments before rounding. Random numbers are generated by a hash of
+ * the seed and the index of an element, so the result is reproducible. A
+ * buffer shall get its own seed, otherwise roundings of different buffers
+ * are correlated.
+ *
+ * @param[in] num_elems: Number of elements in buffers
+ * @param[in] first_iter: Whether this is the first iteration
+ * @param[in] beta_1: parameter for moving average of first moments
+ * @param[in] beta_2: parameter for moving average of second moments
+ * @param[in] eps: small scalar to avoid division by zero
+ * @param[in] alpha: learning rate divided by 1-beta_1^num_iter
+ * @param[in] beta: 1/sqrt(1-beta_2^num_iter)
+ * @param[in] l2_decay: coefficient for l2 regularizer
+ * @param[in] p_scale: multiplier for decoupled weight decay
+ * @param[in] seed: Seed for stochastic rounding of moments
+ * @param[in] grad: Input buffer stored gradient
+ * @param[inout] first_moment: Buffer stored first moments
+ * @param[inout] second_moment: Buffer stored square root of second moments
+ * @param[inout] p: Parameters that are updated
+ * */
+{
+    uint32_t seed32 = hash32(static_cast<uint32_t>(seed)
+            ^ hash32(static_cast<uint32_t>(seed>>32)));
+    cpu_apply_select<T, bf16_t>(num_elems, first_iter, beta_1, beta_2, eps,
+            alpha, beta, l2_decay, p_scale, seed32, grad, first_moment,
+            second_moment, p);
+}
+
 // Explicit instantiation
 template
 void cpu<fp32_t>(Index num_iter, Index num_elems, fp32_t beta_1, fp32_t beta_2, fp32_t eps,
@@ -94,6 +281,28 @@ void cpu<fp64_t>(Index num_iter, Index num_elems, fp64_t beta_1, fp64_t beta_2,
          fp64_t* grad, fp64_t* first_moment, fp64_t* second_moment, fp64_t* p)
     noexcept;
 
+// Explicit instantiation
+template
+void cpu_apply<fp32_t>(Index num_elems, bool first_iter, fp32_t beta_1,
+        fp32_t beta_2, fp32_t eps, fp32_t alpha, fp32_t beta, fp32_t l2_decay,
+        fp32_t p_scale, const fp32_t *grad, fp32_t *first_moment,
+        fp32_t *second_moment, fp32_t *p)
+    noexcept;
+
+template
+void cpu_apply<fp64_t>(Index num_elems, bool first_iter, fp64_t beta_1,
+        fp64_t beta_2, fp64_t eps, fp64_t alpha, fp64_t beta, fp64_t l2_decay,
+        fp64_t p_scale, const fp64_t *grad, fp64_t *first_moment,
+        fp64_t *second_moment, fp64_t *p)
+    noexcept;
+
+template
+void cpu_apply<fp32_t>(Index num_elems, bool first_iter, fp32_t beta_1,
+        fp32_t beta_2, fp32_t eps, fp32_t alpha, fp32_t beta, fp32_t l2_decay,
+        fp32_t p_scale, Index seed, const fp32_t *grad, bf16_t *first_moment,
+        bf16_t *second_moment, fp32_t *p)
+    noexcept;
+
 } // namespace adam_step
 } // namespace kernel
 } // namespace nntile
@@ -24,44 +24,71 @@ namespace adam_step
 
 template<typename T>
 static __global__
-void cuda_kernel(Index num_iter, Index num_elems, T beta_1, T beta_2, T eps,
-        T lr, T weight_decay, T* grad, T* first_moment, T* second_moment,
-        T* p, T alpha, T beta)
+void cuda_kernel(Index num_elems, bool first_iter, T beta_1, T beta_2, T eps,
+        T alpha, T beta, T l2_decay, T p_scale, const T *grad,
+        T *first_moment, T *second_moment, T *p)
 {
     int i = threadIdx.x + blockIdx.x*blockDim.x;
     if(i < num_elems)
     {
         // Read values (param+grad) from RAM only once
         T p_val = p[i], grad_val = grad[i];
-        if (weight_decay != 0)
+        if(l2_decay != 0)
         {
-            grad_val += weight_decay * p_val;
+            grad_val += l2_decay * p_val;
         }
+        p_val *= p_scale;
         // Read values (first+second moments) from RAM no more than once and
         // update them in the RAM immediately
         T f_val, s_val;
-        if(num_iter == 1)
+        if(first_iter)
         {
             f_val = (1-beta_1) * grad_val;
-            first_moment[i] = f_val;
             s_val = ::sqrt(1-beta_2) * ::fabs(grad_val);
-            second_moment[i] = s_val;
         }
         else
         {
-            f_val = first_moment[i];
-            s_val = second_moment[i];
-            f_val = beta_1*f_val + (1-beta_1)*grad_val;
-            first_moment[i] = f_val;
-            s_val = ::hypot(::sqrt(beta_2)*s_val, ::sqrt(1-beta_2)*grad_val);
-            second_moment[i] = s_val;
+            f_val = beta_1*first_moment[i] + (1-beta_1)*grad_val;
+            s_val = ::hypot(::sqrt(beta_2)*second_moment[i],
+                    ::sqrt(1-beta_2)*grad_val);
         }
+        first_moment[i] = f_val;
+        second_moment[i] = s_val;
         // Update parameters using only data in registers
         T denom = s_val*beta + eps;
         p[i] = p_val - alpha*f_val/denom;
     }
 }
 
+template<typename T>
+void cuda_apply(cudaStream_t stream, Index num_elems, bool first_iter,
+        T beta_1, T beta_2, T eps, T alpha, T beta, T l2_decay, T p_scale,
+        const T *grad, T *first_moment, T *second_moment, T *p)
+    noexcept
+//! Fused Adam step on buffers with precomputed bias corrections on CUDA
+/*! See kernel::adam_step::cpu_apply() for the details.
+ *
+ * @param[in] num_elems: Number of elements in buffers
+ * @param[in] first_iter: Whether this is the first iteration
+ * @param[in] beta_1: parameter for moving average of first moments
+ * @param[in] beta_2: parameter for moving average of second moments
+ * @param[in] eps: small scalar to avoid division by zero
+ * @param[in] alpha: learning rate divided by 1-beta_1^num_iter
+ * @param[in] beta: 1/sqrt(1-beta_2^num_iter)
+ * @param[in] l2_decay: coefficient for l2 regularizer
+ * @param[in] p_scale: multiplier for decoupled weight decay
+ * @param[in] grad: Input buffer stored gradient
+ * @param[inout] first_moment: Buffer stored first moments
+ * @param[inout] second_moment: Buffer stored square root of second moments
+ * @param[inout] p: Parameters that are updated
+ * */
+{
+    dim3 blocks((num_elems+255)/256), threads(256);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(num_elems, first_iter,
+            beta_1, beta_2, eps, alpha, beta, l2_decay, p_scale, grad,
+            first_moment, second_moment, p);
+}
+
 template<typename T>
 void cuda(cudaStream_t stream, Index num_iter, Index num_elems, T beta_1, T beta_2, T eps, T lr, T weight_decay,
           T* grad, T* first_moment, T* second_moment, T* p)
@@ -81,12 +108,11 @@ void cuda(cudaStream_t stream, Index num_iter, Index num_elems, T beta_1, T beta
 * @param[inout] p: Input buffers with parameter that are updated in the end
  * */
 {
-    dim3 blocks((num_elems+255)/256), threads(256);
     T alpha = lr / (1-::pow(beta_1, num_iter));
     T beta = 1 / ::sqrt(1 - ::pow(beta_2, num_iter));
-    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(num_iter, num_elems,
-            beta_1, beta_2, eps, lr, weight_decay, grad, first_moment,
-            second_moment, p, alpha, beta);
+    cuda_apply<T>(stream, num_elems, num_iter == 1, beta_1, beta_2, eps,
+            alpha, beta, weight_decay, T(1), grad, first_moment,
+            second_moment, p);
 }
 
 // Explicit instantiation
@@ -102,6 +128,21 @@ void cuda<fp64_t>(cudaStream_t stream, Index num_iter, Index num_elems, fp64_t b
                   fp64_t* second_moment, fp64_t* p)
     noexcept;
 
+// Explicit instantiation
+template
+void cuda_apply<fp32_t>(cudaStream_t stream, Index num_elems, bool first_iter,
+        fp32_t beta_1, fp32_t beta_2, fp32_t eps, fp32_t alpha, fp32_t beta,
+        fp32_t l2_decay, fp32_t p_scale, const fp32_t *grad,
+        fp32_t *first_moment, fp32_t *second_moment, fp32_t *p)
+    noexcept;
+
+template
+void cuda_apply<fp64_t>(cudaStream_t stream, Index num_elems, bool first_iter,
+        fp64_t beta_1, fp64_t beta_2, fp64_t eps, fp64_t alpha, fp64_t beta,
+        fp64_t l2_decay, fp64_t p_scale, const fp64_t *grad,
+        fp64_t *first_moment, fp64_t *second_moment, fp64_t *p)
+    noexcept;
+
 } // namespace adam_step
 } // namespace kernel
 } // namespace nntile
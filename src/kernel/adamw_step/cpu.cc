@@ -14,6 +14,7 @@
  * */
 
 #include "nntile/kernel/adamw_step/cpu.hh"
+#include "nntile/kernel/adam_step/cpu.hh"
 #include <cmath>
 
 namespace nntile
@@ -43,42 +44,13 @@ void cpu(Index num_iter, Index num_elems, T beta_1, T beta_2, T eps, T lr, T wei
  * @param[inout] p: Input buffers with parameter that are updated in the end
  * */
 {
-    T alpha = lr / (1 - ::pow(beta_1, num_iter));
-    T beta = 1.0 / std::sqrt(1 - std::pow(beta_2, num_iter));
-    // Cycle over buffers
-    for(Index i = 0; i < num_elems; ++i)
-    {
-        // Read values (param+grad) from RAM only once
-        T p_val = p[i], grad_val = grad[i];
-        if (weight_decay != 0)
-        {
-            p_val *= 1 - lr*weight_decay;
-        }
-        // Read values (first+second moments) from RAM no more than once and
-        // update them in the RAM immediately
-        T f_val, s_val;
-        if(num_iter == 1)
-        {
-            f_val = (1. - beta_1) * grad_val;
-            first_moment[i] = f_val;
-            s_val = std::sqrt(1-beta_2) * std::fabs(grad_val);
-            second_moment[i] = s_val;
-        }
-        else
-        {
-            f_val = first_moment[i];
-            s_val = second_moment[i];
-            f_val = beta_1*f_val + (1-beta_1)*grad_val;
-            first_moment[i] = f_val;
-            s_val = std::hypot(std::sqrt(beta_2)*s_val,
-                    std::sqrt(1-beta_2)*grad_val);
-            second_moment[i] = s_val;
-        }
-        // Update parameters using only data in registers
-        T denom = s_val*beta + eps;
-        //T denom = ::sqrt(s_val * beta) + eps;
-        p[i] = p_val - alpha*f_val/denom;
-    }
+    // Decoupled weight decay only scales parameters, the rest is the same
+    // as in the Adam step
+    T alpha = lr / (1 - std::pow(beta_1, num_iter));
+    T beta = 1 / std::sqrt(1 - std::pow(beta_2, num_iter));
+    adam_step::cpu_apply<T>(num_elems, num_iter == 1, beta_1, beta_2, eps,
+            alpha, beta, T(0), 1-lr*weight_decay, grad, first_moment,
+            second_moment, p);
 }
 
 // Explicit instantiation
@@ -14,6 +14,7 @@
  * */
 
 #include "nntile/kernel/add/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 
 namespace nntile
 {
@@ -23,6 +24,7 @@ namespace add
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index nelems, T alpha, const T* src, T beta, T* dst)
     noexcept
 //! Add of two buffers on CPU
@@ -37,6 +39,7 @@ void cpu(Index nelems, T alpha, const T* src, T beta, T* dst)
  * @param[inout] dst: Destination of the add operation
  * */
 {
+    NNTILE_SIMD
     for(Index i = 0; i < nelems; ++i)
     {
         dst[i] = alpha*src[i] + beta*dst[i];
@@ -54,6 +57,11 @@ void cpu<fp64_t>(Index nelems, fp64_t alpha, const fp64_t* src, fp64_t beta,
         fp64_t* dst)
     noexcept;
 
+template
+void cpu<bf16_t>(Index nelems, bf16_t alpha, const bf16_t* src, bf16_t beta,
+        bf16_t* dst)
+    noexcept;
+
 } // namespace add
 } // namespace kernel
 } // namespace nntile
@@ -13,7 +13,8 @@
  * @date 2023-05-09
  * */
 
-#include "nntile/kernel/add/cpu.hh"
+#include "nntile/kernel/add_scalar/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 
 namespace nntile
 {
@@ -23,6 +24,7 @@ namespace add_scalar
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index num_elements, T alpha, T beta, T* dst)
     noexcept
 //! Add scalar to buffer buffers on CPU
@@ -34,7 +36,8 @@ void cpu(Index num_elements, T alpha, T beta, T* dst)
  * @param[inout] dst: Destination of the add_scalar operation
  * */
 {
-    for (Index i = 0; i < num_elements; ++i)
+    NNTILE_SIMD
+    for(Index i = 0; i < num_elements; ++i)
     {
         dst[i] = alpha + beta * dst[i];
     }
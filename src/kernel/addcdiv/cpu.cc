@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/addcdiv/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 
 namespace nntile
 {
@@ -22,6 +23,7 @@ namespace addcdiv
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(T val, T eps, Index nelems, const T *nom, const T* denom, T *res)
     noexcept
 //! Per-element addcdiv operation of buffers
@@ -36,6 +38,7 @@ void cpu(T val, T eps, Index nelems, const T *nom, const T* denom, T *res)
  * */
 {
     // Cycle over buffers
+    NNTILE_SIMD
     for(Index i = 0; i < nelems; ++i)
     {
         res[i] += val * nom[i] / (denom[i] + eps);
@@ -0,0 +1,71 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/amp_unscale/cpu.cc
+ * Unscale gradients and check them for infinite and NaN values on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-19
+ * */
+
+#include "nntile/kernel/amp_unscale/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace amp_unscale
+{
+
+template<typename T>
+NNTILE_CPU_DISPATCH
+void cpu(Index nelems, T inv_scale, T *data, bool_t *nonfinite)
+    noexcept
+//! Unscale buffer and check it for infinite and NaN values on CPU
+/*! Performs the following operations within a single pass over data:
+ *      nonfinite = nonfinite or any(not isfinite(data[i])),
+ *      data[i] = inv_scale * data[i].
+ * The flag is never cleared, so it accumulates status of many buffers.
+ *
+ * @param[in] nelems: Number of elements in the buffer
+ * @param[in] inv_scale: Inverse of the loss scale
+ * @param[inout] data: Buffer with scaled gradient, that is unscaled in-place
+ * @param[inout] nonfinite: Flag, that is set if data has inf or NaN values
+ * */
+{
+    // Difference x-x is zero for finite x and NaN otherwise, so the sum of
+    // such differences is a branch-free vectorizable finiteness check
+    T check = 0;
+    NNTILE_SIMD_REDUCTION(+, check)
+    for(Index i = 0; i < nelems; ++i)
+    {
+        T val = data[i];
+        check += val - val;
+        data[i] = inv_scale * val;
+    }
+    if(check != T{0})
+    {
+        *nonfinite = true;
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index nelems, fp32_t inv_scale, fp32_t *data,
+        bool_t *nonfinite)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index nelems, fp64_t inv_scale, fp64_t *data,
+        bool_t *nonfinite)
+    noexcept;
+
+} // namespace amp_unscale
+} // namespace kernel
+} // namespace nntile
+
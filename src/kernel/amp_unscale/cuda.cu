@@ -0,0 +1,76 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/amp_unscale/cuda.cu
+ * Unscale gradients and check them for infinite and NaN values on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-19
+ * */
+
+#include "nntile/kernel/amp_unscale/cuda.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace amp_unscale
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(Index nelems, T inv_scale, T *data, bool_t *nonfinite)
+{
+    int i = threadIdx.x + blockIdx.x*blockDim.x;
+    if(i < nelems)
+    {
+        T val = data[i];
+        // All threads write the same value, so the race is benign
+        if(not isfinite(val))
+        {
+            *nonfinite = true;
+        }
+        data[i] = inv_scale * val;
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index nelems, T inv_scale, T *data,
+        bool_t *nonfinite)
+    noexcept
+//! Unscale buffer and check it for infinite and NaN values on CUDA
+/*! Performs the following operations within a single pass over data:
+ *      nonfinite = nonfinite or any(not isfinite(data[i])),
+ *      data[i] = inv_scale * data[i].
+ * The flag is never cleared, so it accumulates status of many buffers.
+ *
+ * @param[in] nelems: Number of elements in the buffer
+ * @param[in] inv_scale: Inverse of the loss scale
+ * @param[inout] data: Buffer with scaled gradient, that is unscaled in-place
+ * @param[inout] nonfinite: Flag, that is set if data has inf or NaN values
+ * */
+{
+    dim3 blocks((nelems+255)/256), threads(256);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(nelems, inv_scale, data,
+            nonfinite);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index nelems, fp32_t inv_scale,
+        fp32_t *data, bool_t *nonfinite)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index nelems, fp64_t inv_scale,
+        fp64_t *data, bool_t *nonfinite)
+    noexcept;
+
+} // namespace amp_unscale
+} // namespace kernel
+} // namespace nntile
+
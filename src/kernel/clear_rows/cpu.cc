@@ -0,0 +1,63 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/clear_rows/cpu.cc
+ * Clear marked rows of a matrix on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/kernel/clear_rows/cpu.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace clear_rows
+{
+
+template<typename T>
+void cpu(Index m, Index n, const bool_t *rows, T *dst)
+    noexcept
+//! Clear marked rows of a matrix on CPU
+/*! A row of a table of embeddings is a contiguous column of the matrix, as
+ * the matrix is stored in Fortran order. Does the following operation:
+ *      dst[:, j] = 0 for all j, such that rows[j] is true.
+ *
+ * @param[in] m: Size of every row
+ * @param[in] n: Number of rows
+ * @param[in] rows: Marks of rows to clear
+ * @param[inout] dst: Matrix of size m by n stored in Fortran order
+ * */
+{
+    for(Index j = 0; j < n; ++j)
+    {
+        if(rows[j])
+        {
+            T *dst_row = dst + j*m;
+            for(Index i = 0; i < m; ++i)
+            {
+                dst_row[i] = T{0};
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, const bool_t *rows, fp32_t *dst)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, const bool_t *rows, fp64_t *dst)
+    noexcept;
+
+} // namespace clear_rows
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,72 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/clear_rows/cuda.cu
+ * Clear marked rows of a matrix on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/kernel/clear_rows/cuda.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace clear_rows
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(Index m, Index n, const bool_t *rows, T *dst)
+{
+    // A single block of threads per row
+    Index j = blockIdx.x;
+    if(rows[j])
+    {
+        T *dst_row = dst + j*m;
+        for(Index i = threadIdx.x; i < m; i += blockDim.x)
+        {
+            dst_row[i] = T{0};
+        }
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, const bool_t *rows, T *dst)
+    noexcept
+//! Clear marked rows of a matrix on CUDA
+/*! A row of a table of embeddings is a contiguous column of the matrix, as
+ * the matrix is stored in Fortran order. Does the following operation:
+ *      dst[:, j] = 0 for all j, such that rows[j] is true.
+ *
+ * @param[in] m: Size of every row
+ * @param[in] n: Number of rows
+ * @param[in] rows: Marks of rows to clear
+ * @param[inout] dst: Matrix of size m by n stored in Fortran order
+ * */
+{
+    dim3 blocks(n), threads(std::min(int(m), 256));
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, n, rows, dst);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, const bool_t *rows,
+        fp32_t *dst)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, const bool_t *rows,
+        fp64_t *dst)
+    noexcept;
+
+} // namespace clear_rows
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,824 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/cpu_bench.cc
+ * Micro-benchmark of all CPU kernels against a roofline estimate
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/kernel.hh"
+#include "nntile/kernel/cpu_simd.hh"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace nntile;
+
+using clock_type = std::chrono::steady_clock;
+
+//! Shape of a benchmark
+/*! Kernels over 3-dimensional arrays use m-by-k-by-n arrays, m-by-n slices
+ * and fibers of k elements. Elementwise kernels process m*k*n elements.
+ * Flash attention kernels use head=m, seq=k and batch=n, GEMM with int8
+ * weights multiplies m-by-k and k-by-n matrices.
+ * */
+struct Shape
+{
+    Index m, n, k;
+};
+
+//! Single kernel call with its traffic and work
+/*! Traffic counts every array read once and every array written once, so
+ * read-write arrays count twice. Work counts additions and multiplications,
+ * while every division, square root or exponent counts as a single flop.
+ * That said, roofline of kernels with transcendental functions is
+ * optimistic.
+ * */
+struct Case
+{
+    std::string name;
+    double bytes;
+    double flops;
+    // Restores inputs, that are changed by previous cases
+    std::function<void()> setup;
+    std::function<void()> run;
+};
+
+void add_case(std::vector<Case> &cases, const std::string &name,
+        double bytes, double flops, const std::function<void()> &setup,
+        const std::function<void()> &run)
+{
+    cases.push_back({name, bytes, flops, setup, run});
+}
+
+//! Result of a benchmark with its roofline estimate
+struct Result
+{
+    std::string name;
+    const char *dtype;
+    Shape shape;
+    double time;
+    double bytes;
+    double flops;
+    double roofline;
+    bool memory_bound;
+};
+
+//! Peak performance of a single core
+/*! Bandwidth is measured for several sizes of data, so that tiles, that fit
+ * into caches, are compared against bandwidth of caches rather than of the
+ * main memory.
+ * */
+struct Roofline
+{
+    // Sizes of data in bytes and bandwidths in bytes per second
+    std::vector<double> sizes, bandwidth;
+    // Floating point operations per second for fp32 and fp64
+    double peak_fp32, peak_fp64;
+    // Bandwidth for the smallest measured size, that holds given data
+    double get_bandwidth(double bytes) const
+    {
+        for(std::size_t i = 0; i < sizes.size(); ++i)
+        {
+            if(bytes <= sizes[i])
+            {
+                return bandwidth[i];
+            }
+        }
+        return bandwidth.back();
+    }
+};
+
+// Time of a single call in seconds, best of several repetitions, each taking
+// at least min_time seconds
+double measure(const std::function<void()> &func, double min_time)
+{
+    // Warm up caches and estimate number of calls
+    auto start = clock_type::now();
+    func();
+    std::chrono::duration<double> first = clock_type::now() - start;
+    Index ncalls = std::max(Index{1}, Index(min_time/first.count()));
+    double best = 1e300;
+    for(int rep = 0; rep < 3; ++rep)
+    {
+        start = clock_type::now();
+        for(Index i = 0; i < ncalls; ++i)
+        {
+            func();
+        }
+        std::chrono::duration<double> time = clock_type::now() - start;
+        best = std::min(best, time.count() / ncalls);
+    }
+    return best;
+}
+
+// Triad over arrays, that do not fit into caches
+NNTILE_CPU_DISPATCH
+static void triad(Index n, fp64_t alpha, const fp64_t *a, const fp64_t *b,
+        fp64_t *c)
+{
+    NNTILE_SIMD
+    for(Index i = 0; i < n; ++i)
+    {
+        c[i] = a[i] + alpha*b[i];
+    }
+}
+
+// Independent chains of multiply-adds, that are enough to hide latency
+template<typename T>
+static NNTILE_SIMD_INLINE void fma_chains(Index niter, T *acc)
+{
+    constexpr Index nchains = 128;
+    T local[nchains];
+    std::memcpy(local, acc, sizeof(local));
+    const T a = T{0.999999}, b = T{1e-6};
+    for(Index iter = 0; iter < niter; ++iter)
+    {
+        NNTILE_SIMD
+        for(Index i = 0; i < nchains; ++i)
+        {
+            local[i] = local[i]*a + b;
+        }
+    }
+    std::memcpy(acc, local, sizeof(local));
+}
+
+NNTILE_CPU_DISPATCH
+static void fma_chains_fp32(Index niter, fp32_t *acc)
+{
+    fma_chains<fp32_t>(niter, acc);
+}
+
+NNTILE_CPU_DISPATCH
+static void fma_chains_fp64(Index niter, fp64_t *acc)
+{
+    fma_chains<fp64_t>(niter, acc);
+}
+
+// Measure bandwidth of caches and main memory and peak performance of a single
+// core
+Roofline measure_roofline(double min_time)
+{
+    Roofline roof;
+    // Triads over 16 KiB to 384 MiB of data
+    for(Index n = 1<<9; n <= Index{1}<<24; n *= 4)
+    {
+        std::vector<fp64_t> a(n, 1.0), b(n, 1.0), c(n, 0.0);
+        double time = measure([&](){triad(n, 0.5, a.data(), b.data(),
+                    c.data());}, min_time);
+        double bytes = 3.0 * n * sizeof(fp64_t);
+        roof.sizes.push_back(bytes);
+        roof.bandwidth.push_back(bytes / time);
+    }
+    Index niter = 1 << 16;
+    std::vector<fp32_t> acc32(128, 1.0f);
+    double time = measure([&](){fma_chains_fp32(niter, acc32.data());},
+            min_time);
+    roof.peak_fp32 = 2.0 * 128 * niter / time;
+    std::vector<fp64_t> acc64(128, 1.0);
+    time = measure([&](){fma_chains_fp64(niter, acc64.data());},
+            min_time);
+    roof.peak_fp64 = 2.0 * 128 * niter / time;
+    return roof;
+}
+
+//! Buffers of a benchmark with their pristine copies
+template<typename T>
+struct Buffers
+{
+    Index nelems, nslice, nfiber;
+    // Random values in [0.1, 2)
+    std::vector<T> a, b, c, d, e, f;
+    // Values, that are almost fixed points of in-place GeLU
+    std::vector<T> big;
+    std::vector<T> ones;
+    // Slices and fibers
+    std::vector<T> slice, slice2, fiber, fiber2, fiber3;
+    std::vector<T> pristine;
+    std::vector<T> pristine_slice;
+    std::vector<T> pristine_fiber;
+    std::vector<T> scalars;
+    std::unique_ptr<bool_t[]> mask, flag;
+    std::vector<Index> index, tmp_index;
+    // Marks of rows of a row-sparse matrix, touched rows of a vocabulary and
+    // numbers of steps of rows of the sparse Adam
+    std::unique_ptr<bool_t[]> row_mask, vocab_rows;
+    std::vector<Index> row_step;
+    // Vocabulary of embeddings, labels of outputs and shape of a tile
+    std::vector<T> vocab;
+    std::vector<Index> labels, tile;
+    // Mask, maximums and sums of exponents and sums of products of flash
+    // attention
+    std::unique_ptr<bool_t[]> flash_mask;
+    std::vector<T> flash_maxsumexp, flash_sumprod;
+    // Single precision only data
+    std::vector<fp16_t> half;
+    std::vector<std::int8_t> weights;
+    std::vector<fp32_t> w_scale, x_scale;
+    std::vector<std::int16_t> x_quant, w_col;
+    std::vector<std::int32_t> acc;
+    Buffers(const Shape &shape):
+        nelems(shape.m*shape.n*shape.k),
+        nslice(shape.m*shape.n),
+        nfiber(shape.k)
+    {
+        std::mt19937_64 gen(nelems);
+        std::uniform_real_distribution<T> dist(T{0.1}, T{2});
+        auto random = [&](Index size){
+            std::vector<T> v(size);
+            for(auto &x: v)
+            {
+                x = dist(gen);
+            }
+            return v;
+        };
+        pristine = random(nelems);
+        pristine_slice = random(2*nslice);
+        pristine_fiber = random(nfiber);
+        a = random(nelems);
+        b = pristine;
+        c = random(nelems);
+        d = random(nelems);
+        e = random(nelems);
+        f = random(nelems);
+        big = random(nelems);
+        for(auto &x: big)
+        {
+            x += T{5};
+        }
+        ones.assign(nelems, T{1});
+        slice = pristine_slice;
+        slice2 = pristine_slice;
+        fiber = pristine_fiber;
+        fiber2 = pristine_fiber;
+        fiber3 = pristine_fiber;
+        scalars.assign(2, T{0});
+        flag.reset(new bool_t[1]);
+        flag[0] = false;
+        tmp_index.assign(6, 0);
+        flash_maxsumexp.resize(2*shape.k*shape.n);
+        flash_sumprod.resize(shape.k*shape.n);
+    }
+    // Restore values of arrays, that are updated in place
+    void restore()
+    {
+        std::copy(pristine.begin(), pristine.end(), b.begin());
+        std::copy(pristine.begin(), pristine.end(), c.begin());
+        std::copy(pristine.begin(), pristine.end(), d.begin());
+        std::copy(pristine_slice.begin(), pristine_slice.end(),
+                slice.begin());
+        std::copy(pristine_slice.begin(), pristine_slice.end(),
+                slice2.begin());
+        std::copy(pristine_fiber.begin(), pristine_fiber.end(),
+                fiber2.begin());
+        std::copy(pristine_fiber.begin(), pristine_fiber.end(),
+                fiber3.begin());
+    }
+};
+
+// Kernels on elementwise and 3-dimensional arrays of any floating point type
+template<typename T>
+void add_cases(std::vector<Case> &cases, Buffers<T> &buf, const Shape &shape)
+{
+    Index m = shape.m, n = shape.n, k = shape.k;
+    Index N = buf.nelems, S = buf.nslice, K = buf.nfiber;
+    double s = sizeof(T);
+    T *A = buf.a.data(), *B = buf.b.data(), *C = buf.c.data(),
+      *D = buf.d.data(), *E = buf.e.data(), *F = buf.f.data(),
+      *G = buf.big.data(), *one = buf.ones.data(), *S1 = buf.slice.data(),
+      *S2 = buf.slice2.data(), *F1 = buf.fiber.data(),
+      *F2 = buf.fiber2.data(), *F3 = buf.fiber3.data(),
+      *scalar = buf.scalars.data();
+    auto restore = [&buf](){buf.restore();};
+    // Every operation is applied many times to the same data, so parameters
+    // are chosen to avoid exponential growth or decay of values
+    add_case(cases, "accumulate_maxsumexp", 3*N*s, 3*N, restore,
+            [=](){kernel::accumulate_maxsumexp::cpu<T>(N/2, A, B);});
+    add_case(cases, "adam_step", 7*N*s, 13*N, restore,
+            [=](){kernel::adam_step::cpu<T>(10, N, 0.9, 0.999, 1e-8, 1e-3,
+                    0, A, B, C, D);});
+    add_case(cases, "adamw_step", 7*N*s, 14*N, restore,
+            [=](){kernel::adamw_step::cpu<T>(10, N, 0.9, 0.999, 1e-8, 1e-3,
+                    0.01, A, B, C, D);});
+    add_case(cases, "add", 3*N*s, 3*N, restore,
+            [=](){kernel::add::cpu<T>(N, 1, A, 1, B);});
+    add_case(cases, "add_fiber", (2*N+K)*s, 3*N, restore,
+            [=](){kernel::add_fiber::cpu<T>(m, n, k, 1, 1, F1, 1, B);});
+    add_case(cases, "add_scalar", 2*N*s, 2*N, restore,
+            [=](){kernel::add_scalar::cpu<T>(N, 1, 1, B);});
+    add_case(cases, "add_slice", (2*N+S)*s, 3*N, restore,
+            [=](){kernel::add_slice::cpu<T>(m, n, k, 1, S1, 1, B);});
+    add_case(cases, "add_slice3", (2*N+S)*s, 3*N, restore,
+            [=](){kernel::add_slice3::cpu<T>(m, n, k, 1, S1, 1, A, B);});
+    add_case(cases, "addcdiv", 4*N*s, 4*N, restore,
+            [=](){kernel::addcdiv::cpu<T>(1e-3, 1, N, A, E, B);});
+    bool_t *flag = buf.flag.get();
+    add_case(cases, "amp_unscale", 2*N*s, N, restore,
+            [=](){kernel::amp_unscale::cpu<T>(N, 1, B, flag);});
+    // Row-sparse kernels treat arrays as k*n rows of m elements, half of
+    // rows are marked
+    Index R = k * n;
+    buf.row_mask.reset(new bool_t[R]);
+    for(Index j = 0; j < R; ++j)
+    {
+        buf.row_mask[j] = j % 2;
+    }
+    const bool_t *row_mask = buf.row_mask.get();
+    add_case(cases, "clear_rows", 0.5*N*s+R, 0, restore,
+            [=](){kernel::clear_rows::cpu<T>(m, R, row_mask, B);});
+    add_case(cases, "dgelu", 2*N*s, 8*N, restore,
+            [=](){kernel::dgelu::cpu<T>(N, B);});
+    add_case(cases, "dgelutanh", 2*N*s, 12*N, restore,
+            [=](){kernel::dgelutanh::cpu<T>(N, B);});
+    add_case(cases, "drelu", 2*N*s, N, restore,
+            [=](){kernel::drelu::cpu<T>(N, B);});
+    // Embeddings are gathered from a vocabulary of 1024 tokens
+    Index vocab_size = 1024;
+    buf.index.resize(S);
+    std::mt19937_64 gen(S);
+    for(auto &i: buf.index)
+    {
+        i = gen() % vocab_size;
+    }
+    buf.vocab.assign(k*vocab_size, T{1});
+    const Index *index = buf.index.data();
+    T *V = buf.vocab.data();
+    add_case(cases, "embedding", N*s+k*vocab_size*s+S*sizeof(Index), 0,
+            restore, [=](){kernel::embedding::cpu<T>(m, n, k, 0, k, index,
+                    V, B);});
+    add_case(cases, "embedding_backward", N*s+2*k*vocab_size*s
+            +S*sizeof(Index), N, restore,
+            [=](){kernel::embedding_backward::cpu<T>(m, n, k, 0, k, index,
+                    A, V);});
+    buf.vocab_rows.reset(new bool_t[vocab_size]);
+    std::fill(buf.vocab_rows.get(), buf.vocab_rows.get()+vocab_size,
+            false);
+    bool_t *vocab_rows = buf.vocab_rows.get();
+    add_case(cases, "embedding_rows", S*sizeof(Index)+2*vocab_size, 0,
+            restore, [=](){kernel::embedding_rows::cpu(S, index,
+                    vocab_rows);});
+    add_case(cases, "fill", N*s, 0, restore,
+            [=](){kernel::fill::cpu<T>(N, 1, B);});
+    add_case(cases, "gelu", 2*N*s, 8*N, restore,
+            [=](){kernel::gelu::cpu<T>(N, G);});
+    add_case(cases, "gelu_backward", 4*N*s, 10*N, restore,
+            [=](){kernel::gelu_backward::cpu<T>(N, A, E, B);});
+    add_case(cases, "gelutanh", 2*N*s, 7*N, restore,
+            [=](){kernel::gelutanh::cpu<T>(N, A, B);});
+    add_case(cases, "gelutanh_backward", 4*N*s, 14*N, restore,
+            [=](){kernel::gelutanh_backward::cpu<T>(N, A, E, B);});
+    add_case(cases, "gelutanh_inplace", 2*N*s, 7*N, restore,
+            [=](){kernel::gelutanh_inplace::cpu<T>(N, G);});
+    add_case(cases, "hypot", 3*N*s, 5*N, restore,
+            [=](){kernel::hypot::cpu<T>(N, 1, A, 1, B);});
+    add_case(cases, "hypot_scalar_inverse", 2*N*s, 5*N, restore,
+            [=](){kernel::hypot_scalar_inverse::cpu<T>(N, 1, 1, B);});
+    add_case(cases, "layer_norm_forward", (3*N+2*K+2*S)*s, 7*N, restore,
+            [=](){kernel::layer_norm_forward::cpu<T>(m, n, k, 1e-5, A, F1,
+                    F1, S1, S2, C, D);});
+    // Backward pass needs outputs of the forward pass
+    add_case(cases, "layer_norm_backward", (4*N+S+3*K)*s, 10*N,
+            [=, &buf](){buf.restore();
+                kernel::layer_norm_forward::cpu<T>(m, n, k, 1e-5, A, F1, F1,
+                    S1, S2, C, D);},
+            [=](){kernel::layer_norm_backward::cpu<T>(m, n, k, C, E, F1, S2,
+                    B, F2, F3);});
+    add_case(cases, "logsumexp", 1.5*N*s, N, restore,
+            [=](){kernel::logsumexp::cpu<T>(N/2, A, B);});
+    // Half of rows are masked
+    buf.mask.reset(new bool_t[m*k]);
+    for(Index i = 0; i < m*k; ++i)
+    {
+        buf.mask[i] = i % 2;
+    }
+    const bool_t *mask = buf.mask.get();
+    add_case(cases, "mask_scalar", m*k+0.5*N*s, 0, restore,
+            [=](){kernel::mask_scalar::cpu<T>(m*k, n, mask, -1, B);});
+    add_case(cases, "maximum", 3*N*s, N, restore,
+            [=](){kernel::maximum::cpu<T>(N, A, B);});
+    add_case(cases, "maxsumexp", (N+4*S)*s, 3*N, restore,
+            [=](){kernel::maxsumexp::cpu<T>(m, n, k, A, S1);});
+    add_case(cases, "norm_slice", (N+2*S)*s, 2*N, restore,
+            [=](){kernel::norm_slice::cpu<T>(m, n, k, 1, A, 1, S1);});
+    // Large eps keeps repeated normalization contracting
+    T *gamma_beta = buf.scalars.data();
+    add_case(cases, "normalize", (2*N+2*S)*s, 4*N,
+            [=, &buf](){buf.restore(); gamma_beta[0] = 0.5;
+                gamma_beta[1] = 1; std::fill(S1, S1+2*S, T{0});
+                kernel::sumnorm::cpu<T>(m, n, k, B, S1);},
+            [=](){kernel::normalize::cpu<T>(m, n, k, k, 1, gamma_beta,
+                    gamma_beta+1, S1, B);});
+    add_case(cases, "pow", 2*N*s, 2*N, restore,
+            [=](){kernel::pow::cpu<T>(N, 1, 2, one);});
+    add_case(cases, "prod", 3*N*s, N, restore,
+            [=](){kernel::prod::cpu<T>(N, one, B);});
+    add_case(cases, "prod_fiber", (2*N+K)*s, 2*N, restore,
+            [=](){kernel::prod_fiber::cpu<T>(m, n, k, 1, one, B);});
+    add_case(cases, "prod_fiber3", (2*N+K)*s, 2*N, restore,
+            [=](){kernel::prod_fiber3::cpu<T>(m, n, k, 1, F1, A, B);});
+    add_case(cases, "prod_slice", (2*N+S)*s, 2*N, restore,
+            [=](){kernel::prod_slice::cpu<T>(m, n, k, 1, one, B);});
+    // Random numbers are generated for a 3-dimensional tile
+    buf.tile = {0, 0, 0, m, k, n, 1, m, m*k};
+    const Index *start = buf.tile.data(), *dims = start+3, *stride = start+6;
+    Index *tmp_index = buf.tmp_index.data();
+    add_case(cases, "randn", N*s, 0, restore,
+            [=](){kernel::randn::cpu<T>(3, N, 1, 0, 1, start, dims, dims, B,
+                    stride, tmp_index);});
+    add_case(cases, "relu", 2*N*s, N, restore,
+            [=](){kernel::relu::cpu<T>(N, B);});
+    add_case(cases, "relu_backward", 4*N*s, N, restore,
+            [=](){kernel::relu_backward::cpu<T>(N, A, E, B);});
+    add_case(cases, "relu_forward", 2*N*s, N, restore,
+            [=](){kernel::relu_forward::cpu<T>(N, A, B);});
+    add_case(cases, "scal", 2*N*s, N, restore,
+            [=](){kernel::scal::cpu<T>(N, 2, A, B);});
+    add_case(cases, "softmax", (2*N+2*S)*s, 4*N, restore,
+            [=](){kernel::softmax::cpu<T>(m, n, k, S1, A, 1, B);});
+    add_case(cases, "softmax_inplace", (2*N+2*S)*s, 4*N, restore,
+            [=](){kernel::softmax_inplace::cpu<T>(m, n, k, S1, 1, B);});
+    // Every marked row is updated as by the dense Adam step
+    buf.row_step.resize(R);
+    Index *row_step = buf.row_step.data();
+    add_case(cases, "sparse_adam_step", 3.5*N*s+R*(1+sizeof(Index)), 6.5*N,
+            [=, &buf](){buf.restore(); std::fill(row_step, row_step+R,
+                    Index{10});},
+            [=](){kernel::sparse_adam_step::cpu<T>(m, R, 0.9, 0.999, 1e-8,
+                    1e-3, 0, 0, row_mask, row_step, A, B, C, D);});
+    add_case(cases, "sqrt", 2*N*s, N, restore,
+            [=](){kernel::sqrt::cpu<T>(N, A, B);});
+    add_case(cases, "sqrt_inplace", 2*N*s, N, restore,
+            [=](){kernel::sqrt_inplace::cpu<T>(N, B);});
+    add_case(cases, "subcopy", 2*N*s, 0, restore,
+            [=](){kernel::subcopy::cpu<T>(3, start, stride, dims, A, start,
+                    stride, B, tmp_index);});
+    // Logits of m labels for k*n outputs
+    buf.labels.resize(k*n);
+    for(auto &i: buf.labels)
+    {
+        i = gen() % m;
+    }
+    const Index *label = buf.labels.data();
+    add_case(cases, "cross_entropy_fwd_bwd",
+            (2*N+2*k*n)*s+k*n*sizeof(Index), 4*N, restore,
+            [=](){kernel::cross_entropy_fwd_bwd::cpu<T>(m, k*n, 0, 1, 1, F,
+                    A, label, B, scalar);});
+    add_case(cases, "subtract_indexed_outputs", k*n*(2*s+sizeof(Index)),
+            k*n, restore,
+            [=](){kernel::subtract_indexed_outputs::cpu<T>(m, k*n, 1e-3,
+                    label, B);});
+    add_case(cases, "sum_fiber", (N+2*K)*s, N, restore,
+            [=](){kernel::sum_fiber::cpu<T>(m, n, k, 1, 1, A, 1, F2);});
+    add_case(cases, "sum_slice", (N+2*S)*s, N, restore,
+            [=](){kernel::sum_slice::cpu<T>(m, n, k, 1, A, 1, S1);});
+    add_case(cases, "sumnorm", (N+4*S)*s, 3*N, restore,
+            [=](){kernel::sumnorm::cpu<T>(m, n, k, A, S1);});
+    add_case(cases, "sumprod_fiber", (2*N+2*K)*s, 2*N, restore,
+            [=](){kernel::sumprod_fiber::cpu<T>(m, n, k, 1, A, E, 1, F2);});
+    add_case(cases, "sumprod_slice", (2*N+2*S)*s, 2*N, restore,
+            [=](){kernel::sumprod_slice::cpu<T>(m, n, k, 1, A, E, 1, S1);});
+    add_case(cases, "total_sum_accum", k*n*(2*s+sizeof(Index)), 3*k*n,
+            restore,
+            [=](){kernel::total_sum_accum::cpu<T>(1, m, k*n, F, A, label,
+                    scalar);});
+    add_case(cases, "transpose", 2*N*s, N, restore,
+            [=](){kernel::transpose::cpu<T>(m, n*k, 1, A, B);});
+    // Flash attention with head=m, seq=k and batch=n. All scores are used,
+    // as the roofline counts all of them.
+    buf.flash_mask.reset(new bool_t[k*k]);
+    std::fill(buf.flash_mask.get(), buf.flash_mask.get()+k*k, true);
+    const bool_t *fmask = buf.flash_mask.get();
+    T *MS = buf.flash_maxsumexp.data(), *SP = buf.flash_sumprod.data();
+    double attn = double(k) * k * m * n;
+    double flash_bytes = 2*k*n*s + k*k;
+    auto flash_setup = [=, &buf](){buf.restore();
+        std::fill(MS, MS+2*k*n, T{0});
+        kernel::flash_maxsumexp::cpu<T>(k, m, n, A, C, fmask, MS);
+        std::fill(SP, SP+k*n, T{0});
+        kernel::flash_softmax_gemm_backward_sumprod_slice::cpu<T>(k, m, n,
+                A, C, fmask, MS, E, F, B, SP);};
+    add_case(cases, "flash_maxsumexp", 2*N*s+flash_bytes, 2*attn,
+            flash_setup,
+            [=](){kernel::flash_maxsumexp::cpu<T>(k, m, n, A, C, fmask,
+                    MS);});
+    add_case(cases, "flash_softmax_gemm", 5*N*s+flash_bytes, 4*attn,
+            flash_setup,
+            [=](){kernel::flash_softmax_gemm::cpu<T>(k, m, n, A, C, fmask,
+                    MS, F, D);});
+    add_case(cases, "flash_softmax_gemm_backward_sumprod_slice",
+            6*N*s+flash_bytes+2*k*n*s, 6*attn, flash_setup,
+            [=](){kernel::flash_softmax_gemm_backward_sumprod_slice::cpu<T>(
+                    k, m, n, A, C, fmask, MS, E, F, B, SP);});
+    add_case(cases, "flash_softmax_gemm_backward_dq_dk",
+            8*N*s+flash_bytes+k*n*s, 8*attn, flash_setup,
+            [=](){kernel::flash_softmax_gemm_backward_dq_dk::cpu<T>(k, m, n,
+                    A, C, fmask, MS, E, F, SP, B, D);});
+}
+
+// Kernels, that exist only for single precision
+void add_fp32_cases(std::vector<Case> &cases, Buffers<fp32_t> &buf,
+        const Shape &shape)
+{
+    Index m = shape.m, n = shape.n, k = shape.k;
+    Index N = buf.nelems;
+    buf.half.resize(N);
+    fp16_t *H = buf.half.data();
+    fp32_t *A = buf.a.data(), *B = buf.b.data(), *S1 = buf.slice.data();
+    auto restore = [&buf](){buf.restore();};
+    add_case(cases, "fp32_to_fp16", 6.0*N, 0, restore,
+            [=](){kernel::fp32_to_fp16::cpu(N, A, H);});
+    add_case(cases, "fp16_to_fp32", 6.0*N, 0,
+            [=, &buf](){buf.restore(); kernel::fp32_to_fp16::cpu(N, A, H);},
+            [=](){kernel::fp16_to_fp32::cpu(N, H, B);});
+    // Weights of m output channels with k input channels and n inputs
+    buf.weights.resize(k*m);
+    std::mt19937_64 gen(k*m);
+    for(auto &w: buf.weights)
+    {
+        w = static_cast<std::int8_t>(int(gen()%255) - 127);
+    }
+    buf.w_scale.assign(m, 1e-2f);
+    buf.x_scale.resize(n);
+    buf.x_quant.resize(k*n);
+    buf.w_col.resize(k);
+    buf.acc.resize(n);
+    const std::int8_t *W = buf.weights.data();
+    const fp32_t *W_scale = buf.w_scale.data();
+    fp32_t *X_scale = buf.x_scale.data();
+    std::int16_t *X_quant = buf.x_quant.data(), *W_col = buf.w_col.data();
+    std::int32_t *Acc = buf.acc.data();
+    add_case(cases, "gemm_int8", k*m+4.0*(m+k*n+2*m*n), 2.0*m*n*k, restore,
+            [=](){kernel::gemm_int8::cpu<fp32_t>(TransOp(TransOp::NoTrans),
+                    m, n, k, 1, W, W_scale, A, 1, S1, X_scale, X_quant,
+                    W_col, Acc);});
+}
+
+template<typename T>
+void bench(const char *dtype, const Shape &shape, const Roofline &roof,
+        const std::string &filter, double min_time,
+        const std::function<void(const Result &)> &report)
+{
+    Buffers<T> buf(shape);
+    std::vector<Case> cases;
+    add_cases<T>(cases, buf, shape);
+    if constexpr(std::is_same<T, fp32_t>::value)
+    {
+        add_fp32_cases(cases, buf, shape);
+    }
+    double peak = std::is_same<T, fp32_t>::value ? roof.peak_fp32
+        : roof.peak_fp64;
+    for(const auto &c: cases)
+    {
+        if(!filter.empty() and c.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+        c.setup();
+        Result r;
+        r.name = c.name;
+        r.dtype = dtype;
+        r.shape = shape;
+        r.time = measure(c.run, min_time);
+        r.bytes = c.bytes;
+        r.flops = c.flops;
+        double memory_time = c.bytes / roof.get_bandwidth(c.bytes);
+        double compute_time = c.flops / peak;
+        r.memory_bound = memory_time >= compute_time;
+        r.roofline = std::max(memory_time, compute_time);
+        report(r);
+    }
+}
+
+// Parse shape in format MxNxK
+Shape parse_shape(const std::string &str)
+{
+    Shape shape;
+    long m, n, k;
+    if(std::sscanf(str.c_str(), "%ldx%ldx%ld", &m, &n, &k) != 3 or m <= 0
+            or n <= 0 or k <= 0)
+    {
+        throw std::runtime_error("Invalid shape " + str);
+    }
+    shape.m = m;
+    shape.n = n;
+    shape.k = k;
+    return shape;
+}
+
+void usage(const char *prog)
+{
+    std::printf("Usage: %s [options]\n"
+            "  --shape MxNxK      Shape to benchmark, can be repeated\n"
+            "  --dtype fp32|fp64  Type to benchmark, can be repeated\n"
+            "  --kernel NAME      Only kernels, whose names contain NAME\n"
+            "  --format table|csv|json\n"
+            "  --output FILE      Write results into FILE instead of stdout\n"
+            "  --min-time SEC     Minimal time of a repetition\n"
+            "  --bandwidth GB/s   Memory bandwidth instead of measured ones\n"
+            "  --peak GFLOP/s     Peak fp32 performance instead of measured "
+            "one,\n"
+            "                     peak fp64 performance is a half of it\n",
+            prog);
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<Shape> shapes;
+    std::vector<std::string> dtypes;
+    std::string filter, format = "table", output;
+    double min_time = 0.02, bandwidth = 0, peak = 0;
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if(arg == "--help")
+        {
+            usage(argv[0]);
+            return 0;
+        }
+        if(i+1 == argc)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+        if(arg == "--shape")
+        {
+            shapes.push_back(parse_shape(value));
+        }
+        else if(arg == "--dtype")
+        {
+            if(value != "fp32" and value != "fp64")
+            {
+                throw std::runtime_error("Unsupported dtype " + value);
+            }
+            dtypes.push_back(value);
+        }
+        else if(arg == "--kernel")
+        {
+            filter = value;
+        }
+        else if(arg == "--format")
+        {
+            if(value != "table" and value != "csv" and value != "json")
+            {
+                throw std::runtime_error("Unsupported format " + value);
+            }
+            format = value;
+        }
+        else if(arg == "--output")
+        {
+            output = value;
+        }
+        else if(arg == "--min-time")
+        {
+            min_time = std::stod(value);
+        }
+        else if(arg == "--bandwidth")
+        {
+            bandwidth = std::stod(value) * 1e9;
+        }
+        else if(arg == "--peak")
+        {
+            peak = std::stod(value) * 1e9;
+        }
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    // Tiles of small models by default: a square one, attention with head
+    // size 64 and sequence of 1024 tokens, and wide embeddings
+    if(shapes.empty())
+    {
+        shapes = {{64, 64, 64}, {64, 16, 1024}, {1024, 16, 64}};
+    }
+    if(dtypes.empty())
+    {
+        dtypes = {"fp32", "fp64"};
+    }
+    FILE *out = stdout;
+    if(!output.empty())
+    {
+        out = std::fopen(output.c_str(), "w");
+        if(out == nullptr)
+        {
+            throw std::runtime_error("Cannot open " + output);
+        }
+    }
+    Roofline roof = measure_roofline(min_time);
+    if(bandwidth > 0)
+    {
+        roof.bandwidth.assign(roof.sizes.size(), bandwidth);
+    }
+    if(peak > 0)
+    {
+        roof.peak_fp32 = peak;
+        roof.peak_fp64 = peak / 2;
+    }
+    bool first = true;
+    auto report = [&](const Result &r){
+        double gbs = r.bytes / r.time * 1e-9;
+        double gflops = r.flops / r.time * 1e-9;
+        double efficiency = r.roofline / r.time * 100;
+        const char *bound = r.memory_bound ? "memory" : "compute";
+        if(format == "table")
+        {
+            std::fprintf(out, "%-42s %-4s %5ld %5ld %5ld %11.3f %9.2f %9.2f "
+                    "%7.1f%% %s\n", r.name.c_str(), r.dtype, long(r.shape.m),
+                    long(r.shape.n), long(r.shape.k), r.time*1e6, gbs, gflops,
+                    efficiency, bound);
+        }
+        else if(format == "csv")
+        {
+            std::fprintf(out, "%s,%s,%ld,%ld,%ld,%.6e,%.6e,%.6e,%.6e,%.6e,"
+                    "%.6e,%s\n", r.name.c_str(), r.dtype, long(r.shape.m),
+                    long(r.shape.n), long(r.shape.k), r.time, r.bytes,
+                    r.flops, gbs, gflops, r.roofline, bound);
+        }
+        else
+        {
+            std::fprintf(out, "%s\n    {\"kernel\": \"%s\", "
+                    "\"dtype\": \"%s\", \"m\": %ld, \"n\": %ld, \"k\": %ld, "
+                    "\"time\": %.6e, "
+                    "\"bytes\": %.6e, \"flops\": %.6e, \"gbps\": %.6e, "
+                    "\"gflops\": %.6e, \"roofline_time\": %.6e, "
+                    "\"bound\": \"%s\"}", first ? "" : ",", r.name.c_str(),
+                    r.dtype, long(r.shape.m), long(r.shape.n),
+                    long(r.shape.k), r.time, r.bytes, r.flops, gbs, gflops,
+                    r.roofline, bound);
+        }
+        first = false;
+        std::fflush(out);
+    };
+    if(format == "table")
+    {
+        std::fprintf(out, "# Roofline: %.2f GFLOP/s fp32, %.2f GFLOP/s fp64, "
+                "bandwidth", roof.peak_fp32*1e-9, roof.peak_fp64*1e-9);
+        for(std::size_t i = 0; i < roof.sizes.size(); ++i)
+        {
+            std::fprintf(out, " %.0fKiB:%.1fGB/s", roof.sizes[i]/1024,
+                    roof.bandwidth[i]*1e-9);
+        }
+        std::fprintf(out, "\n");
+        std::fprintf(out, "# %-40s %-4s %5s %5s %5s %11s %9s %9s %8s %s\n",
+                "kernel", "type", "m", "n", "k", "time,us", "GB/s",
+                "GFLOP/s", "roofline", "bound");
+    }
+    else if(format == "csv")
+    {
+        std::fprintf(out, "kernel,dtype,m,n,k,time,bytes,flops,gbps,gflops,"
+                "roofline_time,bound\n");
+    }
+    else
+    {
+        std::fprintf(out, "{\"peak_fp32\": %.6e, \"peak_fp64\": %.6e,\n"
+                "\"bandwidth\": [", roof.peak_fp32, roof.peak_fp64);
+        for(std::size_t i = 0; i < roof.sizes.size(); ++i)
+        {
+            std::fprintf(out, "%s{\"bytes\": %.6e, \"bandwidth\": %.6e}",
+                    i == 0 ? "" : ", ", roof.sizes[i], roof.bandwidth[i]);
+        }
+        std::fprintf(out, "],\n\"results\": [");
+    }
+    for(const auto &shape: shapes)
+    {
+        for(const auto &dtype: dtypes)
+        {
+            if(dtype == "fp32")
+            {
+                bench<fp32_t>("fp32", shape, roof, filter, min_time,
+                        report);
+            }
+            else
+            {
+                bench<fp64_t>("fp64", shape, roof, filter, min_time,
+                        report);
+            }
+        }
+    }
+    if(format == "json")
+    {
+        std::fprintf(out, "\n]}\n");
+    }
+    if(out != stdout)
+    {
+        std::fclose(out);
+    }
+    return 0;
+}
@@ -0,0 +1,267 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/cpu_simd_bench.cc
+ * Benchmark of vectorized elementwise CPU kernels against scalar loops
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-04
+ * */
+
+#include "nntile/kernel/add.hh"
+#include "nntile/kernel/addcdiv.hh"
+#include "nntile/kernel/gelutanh.hh"
+#include "nntile/kernel/gelutanh_backward.hh"
+#include "nntile/kernel/maximum.hh"
+#include "nntile/kernel/pow.hh"
+#include "nntile/kernel/prod.hh"
+#include "nntile/kernel/relu_forward.hh"
+#include "nntile/kernel/scal.hh"
+#include "nntile/kernel/sqrt.hh"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace nntile;
+
+// Reference loops shall stay scalar regardless of optimization flags
+#if defined(__GNUC__) && !defined(__clang__)
+#   define SCALAR_LOOP __attribute__((noinline, optimize("no-tree-vectorize")))
+#else
+#   define SCALAR_LOOP __attribute__((noinline))
+#endif
+
+template<typename T>
+SCALAR_LOOP
+void add_ref(Index n, T alpha, const T *src, T beta, T *dst)
+{
+    for(Index i = 0; i < n; ++i)
+    {
+        dst[i] = alpha*src[i] + beta*dst[i];
+    }
+}
+
+template<typename T>
+SCALAR_LOOP
+void prod_ref(Index n, const T *src, T *dst)
+{
+    for(Index i = 0; i < n; ++i)
+    {
+        dst[i] *= src[i];
+    }
+}
+
+template<typename T>
+SCALAR_LOOP
+void scal_ref(Index n, T alpha, const T *src, T *dst)
+{
+    for(Index i = 0; i < n; ++i)
+    {
+        dst[i] = alpha * src[i];
+    }
+}
+
+template<typename T>
+SCALAR_LOOP
+void relu_forward_ref(Index n, const T *src, T *dst)
+{
+    for(Index i = 0; i < n; ++i)
+    {
+        dst[i] = std::fmax(src[i], T{0});
+    }
+}
+
+template<typename T>
+SCALAR_LOOP
+void sqrt_ref(Index n, const T *src, T *dst)
+{
+    for(Index i = 0; i < n; ++i)
+    {
+        dst[i] = std::sqrt(src[i]);
+    }
+}
+
+template<typename T>
+SCALAR_LOOP
+void maximum_ref(Index n, const T *src, T *dst)
+{
+    for(Index i = 0; i < n; ++i)
+    {
+        dst[i] = std::fmax(src[i], dst[i]);
+    }
+}
+
+template<typename T>
+SCALAR_LOOP
+void pow_ref(Index n, T alpha, T exp, T *data)
+{
+    for(Index i = 0; i < n; ++i)
+    {
+        data[i] = alpha * std::pow(data[i], exp);
+    }
+}
+
+template<typename T>
+SCALAR_LOOP
+void addcdiv_ref(T val, T eps, Index n, const T *nom, const T *denom, T *res)
+{
+    for(Index i = 0; i < n; ++i)
+    {
+        res[i] += val * nom[i] / (denom[i] + eps);
+    }
+}
+
+template<typename T>
+SCALAR_LOOP
+void gelutanh_ref(Index n, const T *src, T *dst)
+{
+    const T f3 = -T{2}*std::sqrt(T{2}/T{M_PI}), f4 = f3*T{0.044715};
+    for(Index i = 0; i < n; ++i)
+    {
+        T z = src[i];
+        dst[i] = z / (T{1}+std::exp(z*(f3+f4*z*z)));
+    }
+}
+
+template<typename T>
+SCALAR_LOOP
+void gelutanh_backward_ref(Index n, const T *x, const T *dy, T *dx)
+{
+    const T f3 = -T{2}*std::sqrt(T{2}/T{M_PI}), f4 = f3*T{0.044715},
+        f5 = T{3}*f4, one = 1;
+    for(Index i = 0; i < n; ++i)
+    {
+        T z2 = x[i] * x[i];
+        T y1 = x[i] * (f3 + f4*z2);
+        T y2 = x[i] * (f3 + f5*z2);
+        T expy1 = std::exp(y1);
+        if(not std::isinf(expy1))
+        {
+            T inv_expy1p1 = one / (expy1 + one);
+            dx[i] += (one-y2*(one-inv_expy1p1)) * inv_expy1p1 * dy[i];
+        }
+    }
+}
+
+// Time of a single call in seconds, best of several repetitions
+double measure(const std::function<void()> &func, Index nelems)
+{
+    using clock = std::chrono::steady_clock;
+    // Warm up caches
+    func();
+    // Number of calls per repetition is chosen to touch around 2^24 elements
+    Index ncalls = std::max(Index{1}, (Index{1}<<24) / nelems);
+    double best = 1e300;
+    for(int rep = 0; rep < 3; ++rep)
+    {
+        auto start = clock::now();
+        for(Index i = 0; i < ncalls; ++i)
+        {
+            func();
+        }
+        std::chrono::duration<double> time = clock::now() - start;
+        best = std::min(best, time.count() / ncalls);
+    }
+    return best;
+}
+
+template<typename T>
+void bench(const char *dtype, Index nelems)
+{
+    std::vector<T> a(nelems), b(nelems), c(nelems), ones(nelems, T{1});
+    std::mt19937_64 gen(nelems);
+    std::uniform_real_distribution<T> dist(T{0.1}, T{2});
+    for(Index i = 0; i < nelems; ++i)
+    {
+        a[i] = dist(gen);
+        b[i] = dist(gen);
+        c[i] = dist(gen);
+    }
+    T *pa = a.data(), *pb = b.data(), *pc = c.data(), *p1 = ones.data();
+    // Repeated calls must not drift into overflow or denormals, so in-place
+    // operations are set up to be idempotent
+    struct Case
+    {
+        const char *name;
+        int nbuffers;
+        std::function<void()> scalar, simd;
+    };
+    std::vector<Case> cases = {
+        {"add", 2,
+            [=](){add_ref<T>(nelems, 1, pa, 0, pb);},
+            [=](){kernel::add::cpu<T>(nelems, 1, pa, 0, pb);}},
+        {"prod", 2,
+            [=](){prod_ref<T>(nelems, p1, pc);},
+            [=](){kernel::prod::cpu<T>(nelems, p1, pc);}},
+        {"scal", 2,
+            [=](){scal_ref<T>(nelems, 2, pa, pb);},
+            [=](){kernel::scal::cpu<T>(nelems, 2, pa, pb);}},
+        {"relu_forward", 2,
+            [=](){relu_forward_ref<T>(nelems, pa, pb);},
+            [=](){kernel::relu_forward::cpu<T>(nelems, pa, pb);}},
+        {"sqrt", 2,
+            [=](){sqrt_ref<T>(nelems, pa, pb);},
+            [=](){kernel::sqrt::cpu<T>(nelems, pa, pb);}},
+        {"maximum", 2,
+            [=](){maximum_ref<T>(nelems, pa, pb);},
+            [=](){kernel::maximum::cpu<T>(nelems, pa, pb);}},
+        {"pow(2)", 1,
+            [=](){pow_ref<T>(nelems, 1, 2, p1);},
+            [=](){kernel::pow::cpu<T>(nelems, 1, 2, p1);}},
+        {"addcdiv", 3,
+            [=](){addcdiv_ref<T>(0, 1, nelems, pa, pb, pc);},
+            [=](){kernel::addcdiv::cpu<T>(0, 1, nelems, pa, pb, pc);}},
+        {"gelutanh", 2,
+            [=](){gelutanh_ref<T>(nelems, pa, pb);},
+            [=](){kernel::gelutanh::cpu<T>(nelems, pa, pb);}},
+        {"gelutanh_backward", 3,
+            [=](){gelutanh_backward_ref<T>(nelems, pa, pb, pc);},
+            [=](){kernel::gelutanh_backward::cpu<T>(nelems, pa, pb, pc);}},
+    };
+    for(const auto &c: cases)
+    {
+        double t_scalar = measure(c.scalar, nelems);
+        double t_simd = measure(c.simd, nelems);
+        double bytes = double(c.nbuffers) * nelems * sizeof(T);
+        std::printf("%-18s %-5s %9ld %10.3f %10.3f %8.2f %9.2f\n", c.name,
+                dtype, long(nelems), t_scalar*1e9/nelems,
+                t_simd*1e9/nelems, t_scalar/t_simd, bytes/t_simd*1e-9);
+        std::fflush(stdout);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    // Tile sizes in elements, can be overridden by command line arguments
+    std::vector<Index> sizes = {1<<10, 1<<14, 1<<18, 1<<22};
+    if(argc > 1)
+    {
+        sizes.clear();
+        for(int i = 1; i < argc; ++i)
+        {
+            sizes.push_back(std::stol(argv[i]));
+        }
+    }
+#if defined(__x86_64__) && defined(__GNUC__)
+    const char *isa = __builtin_cpu_supports("avx512f") ? "avx512f" :
+        (__builtin_cpu_supports("avx2") ? "avx2" : "default");
+    std::printf("# Dispatched instruction set: %s\n", isa);
+#endif
+    std::printf("# %-16s %-5s %9s %10s %10s %8s %9s\n", "kernel", "type",
+            "nelems", "scalar,ns", "simd,ns", "speedup", "simd,GB/s");
+    for(Index nelems: sizes)
+    {
+        bench<fp32_t>("fp32", nelems);
+        bench<fp64_t>("fp64", nelems);
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/cross_entropy_fwd_bwd/cpu.cc
+ * Fused cross entropy loss and its gradient on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/kernel/cross_entropy_fwd_bwd/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace cross_entropy_fwd_bwd
+{
+
+template<typename T>
+NNTILE_CPU_DISPATCH
+void cpu(Index m, Index n, Index m_start, T scale, T grad_scale,
+        const T *maxsumexp, const T *src, const Index *labels, T *grad,
+        T *val)
+    noexcept
+//! Cross entropy loss and its gradient over a tile of logits on CPU
+/*! Logits of all classes are split into tiles of m rows, and this tile
+ * starts from class m_start. Maximums and sums of exponents of all the
+ * classes are already accumulated in maxsumexp. Mnemonically, the following
+ * operations are performed for every j in [0, n):
+ *      lse = maxsumexp[0,j] + log(maxsumexp[1,j]),
+ *      grad[i,j] = grad_scale * exp(src[i,j]-lse),
+ *      grad[labels[j]-m_start,j] -= grad_scale,
+ *      val += scale * ((m_start==0 ? lse : 0) - src[labels[j]-m_start,j]),
+ * where operations with labels[j]-m_start are skipped if the label does not
+ * belong to this tile. So the logsumexp term of the loss is added by the
+ * first tile only, and every term of the loss is added exactly once when
+ * the kernel is applied to all tiles.
+ *
+ * @param[in] m: Number of classes in this tile
+ * @param[in] n: Number of outputs
+ * @param[in] m_start: Index of the first class of this tile
+ * @param[in] scale: Scalar multiplier for the loss value
+ * @param[in] grad_scale: Scalar multiplier for the gradient
+ * @param[in] maxsumexp: Maximums and sums of exponents of logits of all
+ *      classes, array of size 2 by n
+ * @param[in] src: Logits, matrix of size m by n stored in Fortran order
+ * @param[in] labels: Array of size n with correct classes
+ * @param[out] grad: Gradient of the loss over logits, matrix of size m by n
+ *      stored in Fortran order. It may coincide with src.
+ * @param[inout] val: Scalar that accumulates the loss value
+ * */
+{
+    constexpr T zero = 0.0;
+    T sum = zero, c = zero, y, t;
+    for(Index j = 0; j < n; ++j)
+    {
+        const T max = maxsumexp[2*j];
+        const T sumexp = maxsumexp[2*j+1];
+        const T *src_j = src + j*m;
+        T *grad_j = grad + j*m;
+        // Label is read before the gradient overwrites logits in-place
+        Index label = labels[j] - m_start;
+        bool has_label = label >= 0 and label < m;
+        T loss = has_label ? -src_j[label] : zero;
+        if(m_start == 0)
+        {
+            loss += max + std::log(sumexp);
+        }
+        // Softmax multiplied by grad_scale
+        const T factor = grad_scale / sumexp;
+        NNTILE_SIMD
+        for(Index i = 0; i < m; ++i)
+        {
+            grad_j[i] = factor * simd::exp(src_j[i]-max);
+        }
+        if(has_label)
+        {
+            grad_j[label] -= grad_scale;
+        }
+        // Compensated summation of the loss
+        y = loss - c;
+        t = sum + y;
+        c = (t-sum) - y;
+        sum = t;
+    }
+    *val = (*val-scale*c) + scale*sum;
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index m_start, fp32_t scale,
+        fp32_t grad_scale, const fp32_t *maxsumexp, const fp32_t *src,
+        const Index *labels, fp32_t *grad, fp32_t *val)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index m_start, fp64_t scale,
+        fp64_t grad_scale, const fp64_t *maxsumexp, const fp64_t *src,
+        const Index *labels, fp64_t *grad, fp64_t *val)
+    noexcept;
+
+} // namespace cross_entropy_fwd_bwd
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,103 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/cross_entropy_fwd_bwd/cuda.cu
+ * Fused cross entropy loss and its gradient on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/kernel/cross_entropy_fwd_bwd/cuda.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace cross_entropy_fwd_bwd
+{
+
+template<typename T>
+static __global__
+void cuda_kernel(Index m, Index n, Index m_start, T scale, T grad_scale,
+        const T *maxsumexp, const T *src, const Index *labels, T *grad,
+        T *val)
+{
+    Index j = blockIdx.x;
+    Index i = threadIdx.x + blockIdx.y*blockDim.x;
+    if(i < m)
+    {
+        const T max = maxsumexp[2*j];
+        const T sumexp = maxsumexp[2*j+1];
+        T src_val = src[i+j*m];
+        T grad_val = grad_scale / sumexp * ::exp(src_val-max);
+        // The same thread reads and writes an element, so grad may coincide
+        // with src
+        if(i == labels[j]-m_start)
+        {
+            grad_val -= grad_scale;
+            atomicAdd(val, -scale*src_val);
+        }
+        if(m_start == 0 and i == 0)
+        {
+            atomicAdd(val, scale*(max+::log(sumexp)));
+        }
+        grad[i+j*m] = grad_val;
+    }
+}
+
+template<typename T>
+void cuda(cudaStream_t stream, Index m, Index n, Index m_start, T scale,
+        T grad_scale, const T *maxsumexp, const T *src, const Index *labels,
+        T *grad, T *val)
+    noexcept
+//! Cross entropy loss and its gradient over a tile of logits on CUDA
+/*! Mnemonically, the following operations are performed for every j in
+ * [0, n):
+ *      lse = maxsumexp[0,j] + log(maxsumexp[1,j]),
+ *      grad[i,j] = grad_scale * exp(src[i,j]-lse),
+ *      grad[labels[j]-m_start,j] -= grad_scale,
+ *      val += scale * ((m_start==0 ? lse : 0) - src[labels[j]-m_start,j]),
+ * where operations with labels[j]-m_start are skipped if the label does not
+ * belong to this tile.
+ *
+ * @param[in] m: Number of classes in this tile
+ * @param[in] n: Number of outputs
+ * @param[in] m_start: Index of the first class of this tile
+ * @param[in] scale: Scalar multiplier for the loss value
+ * @param[in] grad_scale: Scalar multiplier for the gradient
+ * @param[in] maxsumexp: Maximums and sums of exponents of logits of all
+ *      classes, array of size 2 by n
+ * @param[in] src: Logits, matrix of size m by n stored in Fortran order
+ * @param[in] labels: Array of size n with correct classes
+ * @param[out] grad: Gradient of the loss over logits, matrix of size m by n
+ *      stored in Fortran order. It may coincide with src.
+ * @param[inout] val: Scalar that accumulates the loss value
+ * */
+{
+    dim3 blocks(n, (m+255)/256), threads(256);
+    (cuda_kernel<T>)<<<blocks, threads, 0, stream>>>(m, n, m_start, scale,
+            grad_scale, maxsumexp, src, labels, grad, val);
+}
+
+// Explicit instantiation
+template
+void cuda<fp32_t>(cudaStream_t stream, Index m, Index n, Index m_start,
+        fp32_t scale, fp32_t grad_scale, const fp32_t *maxsumexp,
+        const fp32_t *src, const Index *labels, fp32_t *grad, fp32_t *val)
+    noexcept;
+
+template
+void cuda<fp64_t>(cudaStream_t stream, Index m, Index n, Index m_start,
+        fp64_t scale, fp64_t grad_scale, const fp64_t *maxsumexp,
+        const fp64_t *src, const Index *labels, fp64_t *grad, fp64_t *val)
+    noexcept;
+
+} // namespace cross_entropy_fwd_bwd
+} // namespace kernel
+} // namespace nntile
+
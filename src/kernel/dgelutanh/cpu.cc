@@ -13,7 +13,9 @@
  * */
 
 #include "nntile/kernel/dgelutanh/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 #include <cmath>
+#include <limits>
 
 namespace nntile
 {
@@ -23,6 +25,7 @@ namespace dgelutanh
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index nelems, T *data)
     noexcept
 //! Derivative of approximate GeLU operation on CPU
@@ -44,14 +47,16 @@ void cpu(Index nelems, T *data)
     // Square root is not constexpr by standard, proceed with a static const
     static const T sqrt_pi = std::sqrt(pi), sqrt_2 = std::sqrt(T{2}),
         f2 = sqrt_2/sqrt_pi, f3 = -T{2}*f2, f4 = f3*f1, f5 = T{3}*f4;
+    constexpr T inf = std::numeric_limits<T>::infinity();
+    NNTILE_SIMD
     for(Index i = 0; i < nelems; ++i)
     {
         T z = data[i];
         T z2 = z * z;
         T y1 = z * (f3 + f4*z2);
         T y2 = z * (f3 + f5*z2);
-        T expy1 = std::exp(y1);
-        if(std::isinf(expy1))
+        T expy1 = simd::exp(y1);
+        if(expy1 == inf)
         {
             data[i] = zero;
         }
@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/drelu/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 #include <cmath>
 
 namespace nntile
@@ -23,6 +24,7 @@ namespace drelu
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index nelems, T *data)
     noexcept
 //! Inplace derivative of ReLU operation performed on CPU
@@ -31,6 +33,7 @@ void cpu(Index nelems, T *data)
  * */
 {
     constexpr T one = 1.0, zero = 0.0;
+    NNTILE_SIMD
     for(Index i = 0; i < nelems; ++i)
     {
         T &z = data[i];
@@ -70,6 +70,11 @@ void cpu<fp64_t>(Index m, Index n, Index k, Index k_start, Index k_size,
         const Index *index, const fp64_t *vocab, fp64_t *embed)
     noexcept;
 
+template
+void cpu<bf16_t>(Index m, Index n, Index k, Index k_start, Index k_size,
+        const Index *index, const bf16_t *vocab, bf16_t *embed)
+    noexcept;
+
 } // namespace embedding
 } // namespace kernel
 } // namespace nntile
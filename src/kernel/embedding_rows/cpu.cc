@@ -0,0 +1,45 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/embedding_rows/cpu.cc
+ * Mark rows of embeddings, that are touched by tokens, on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/kernel/embedding_rows/cpu.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace embedding_rows
+{
+
+void cpu(Index nelems, const Index *index, bool_t *rows)
+    noexcept
+//! Mark rows of embeddings, that are touched by tokens, on CPU
+/*! Does the following operation:
+ *      rows[index[i]] = true
+ * Marks are never cleared, so they accumulate tokens of many buffers.
+ *
+ * @param[in] nelems: Number of tokens
+ * @param[in] index: Tokens (indices of embeddings)
+ * @param[inout] rows: Marks of touched rows of the table of embeddings
+ * */
+{
+    for(Index i = 0; i < nelems; ++i)
+    {
+        rows[index[i]] = true;
+    }
+}
+
+} // namespace embedding_rows
+} // namespace kernel
+} // namespace nntile
+
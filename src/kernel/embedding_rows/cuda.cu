@@ -0,0 +1,55 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/embedding_rows/cuda.cu
+ * Mark rows of embeddings, that are touched by tokens, on CUDA
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/kernel/embedding_rows/cuda.hh"
+
+namespace nntile
+{
+namespace kernel
+{
+namespace embedding_rows
+{
+
+static __global__
+void cuda_kernel(Index nelems, const Index *index, bool_t *rows)
+{
+    Index i = threadIdx.x + blockIdx.x*blockDim.x;
+    // Threads with the same token write the same value
+    if(i < nelems)
+    {
+        rows[index[i]] = true;
+    }
+}
+
+void cuda(cudaStream_t stream, Index nelems, const Index *index,
+        bool_t *rows)
+    noexcept
+//! Mark rows of embeddings, that are touched by tokens, on CUDA
+/*! Does the following operation:
+ *      rows[index[i]] = true
+ * Marks are never cleared, so they accumulate tokens of many buffers.
+ *
+ * @param[in] nelems: Number of tokens
+ * @param[in] index: Tokens (indices of embeddings)
+ * @param[inout] rows: Marks of touched rows of the table of embeddings
+ * */
+{
+    dim3 blocks((nelems+255)/256), threads(256);
+    (cuda_kernel)<<<blocks, threads, 0, stream>>>(nelems, index, rows);
+}
+
+} // namespace embedding_rows
+} // namespace kernel
+} // namespace nntile
+
@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/fill/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 
 namespace nntile
 {
@@ -22,6 +23,7 @@ namespace fill
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index nelems, T val, T *data)
     noexcept
 //! Fill operation on CPU
@@ -31,6 +33,7 @@ void cpu(Index nelems, T val, T *data)
  * @params[out] data: Output buffer
  * */
 {
+    NNTILE_SIMD
     for(Index i = 0; i < nelems; ++i)
     {
         data[i] = val;
@@ -0,0 +1,135 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/flash_maxsumexp/cpu.cc
+ * Max and sum of exponents of attention scores without storing them on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-06
+ * */
+
+#include "nntile/kernel/flash_maxsumexp/cpu.hh"
+#include "nntile/kernel/flash_block.hh"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace flash_maxsumexp
+{
+
+template<typename T>
+NNTILE_CPU_DISPATCH
+void cpu(Index seq, Index head, Index batch, const T *K, const T *Q,
+        const bool_t *mask, T *maxsumexp)
+    noexcept
+//! Max and sum of exponents of masked attention scores on CPU
+/*! Scores S = K^T Q / sqrt(head) are computed by blocks of
+ * flash_block::block_size keys and queries, and each block is immediately
+ * merged into the running maximums and sums of exponents (so-called online
+ * softmax). That said, a seq-by-seq buffer of scores is never needed.
+ *
+ * Mnemonically, the following operations are performed:
+ *      S[:,:,b] = mask ? K[:,:,b]^T Q[:,:,b] / sqrt(head) : -inf
+ *      old[0,q,b] = maxsumexp[0,q,b]
+ *      old[1,q,b] = maxsumexp[1,q,b]
+ *      maxsumexp[0,q,b] = max(old[0,q,b], max(S[:,q,b]))
+ *      maxsumexp[1,q,b] = old[1,q,b]*exp(old[0,q,b]-maxsumexp[0,q,b])
+ *          + sum(exp(S[:,q,b]-maxsumexp[0,q,b]))
+ *
+ * @param[in] seq: Number of keys and queries
+ * @param[in] head: Head size
+ * @param[in] batch: Number of independent attention problems
+ * @param[in] K: Keys as a contiguous head-by-seq-by-batch array
+ * @param[in] Q: Queries as a contiguous head-by-seq-by-batch array
+ * @param[in] mask: Contiguous seq-by-seq array, scores are only taken into
+ *      account where mask is true
+ * @param[inout] maxsumexp: Contiguous 2-by-seq-by-batch array, that
+ *      accumulates maximums and sums of exponents. Zero sum means there is
+ *      no accumulated value yet.
+ * */
+{
+    using flash_block::block_size;
+    constexpr T zero = 0, neg_inf = -std::numeric_limits<T>::infinity();
+    const T scale = T{1} / std::sqrt(T(head));
+    T S[block_size*block_size];
+    for(Index b = 0; b < batch; ++b)
+    {
+        const T *K_b = K + b*head*seq, *Q_b = Q + b*head*seq;
+        T *maxsumexp_b = maxsumexp + 2*b*seq;
+        for(Index q0 = 0; q0 < seq; q0 += block_size)
+        {
+            Index nq = std::min(block_size, seq-q0);
+            for(Index k0 = 0; k0 < seq; k0 += block_size)
+            {
+                Index nk = std::min(block_size, seq-k0);
+                flash_block::scores<T>(head, seq, nk, nq, K_b+k0*head,
+                        Q_b+q0*head, mask+q0*seq+k0, scale, S);
+                for(Index q = 0; q < nq; ++q)
+                {
+                    const T *S_q = S + q*nk;
+                    // Maximum over the block
+                    T max = neg_inf;
+                    NNTILE_SIMD_REDUCTION(max, max)
+                    for(Index k = 0; k < nk; ++k)
+                    {
+                        max = (S_q[k] > max) ? S_q[k] : max;
+                    }
+                    // Skip block, where everything is masked out
+                    if(max == neg_inf)
+                    {
+                        continue;
+                    }
+                    // Sum of exponents over the block
+                    T sum = zero;
+                    NNTILE_SIMD_REDUCTION(+, sum)
+                    for(Index k = 0; k < nk; ++k)
+                    {
+                        T val = simd::exp(S_q[k]-max);
+                        sum += (S_q[k] == neg_inf) ? zero : val;
+                    }
+                    // Merge with accumulated values
+                    T &max_old = maxsumexp_b[2*(q0+q)];
+                    T &sum_old = maxsumexp_b[2*(q0+q)+1];
+                    if(sum_old == zero)
+                    {
+                        max_old = max;
+                        sum_old = sum;
+                    }
+                    else if(max_old < max)
+                    {
+                        sum_old = sum_old*std::exp(max_old-max) + sum;
+                        max_old = max;
+                    }
+                    else
+                    {
+                        sum_old += sum*std::exp(max-max_old);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index seq, Index head, Index batch, const fp32_t *K,
+        const fp32_t *Q, const bool_t *mask, fp32_t *maxsumexp)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index seq, Index head, Index batch, const fp64_t *K,
+        const fp64_t *Q, const bool_t *mask, fp64_t *maxsumexp)
+    noexcept;
+
+} // namespace flash_maxsumexp
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,114 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/flash_softmax_gemm/cpu.cc
+ * Fused softmax of attention scores and product by values on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-06
+ * */
+
+#include "nntile/kernel/flash_softmax_gemm/cpu.hh"
+#include "nntile/kernel/flash_block.hh"
+#include <algorithm>
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace flash_softmax_gemm
+{
+
+template<typename T>
+NNTILE_CPU_DISPATCH
+void cpu(Index seq, Index head, Index batch, const T *K, const T *Q,
+        const bool_t *mask, const T *maxsumexp, const T *V, T *A)
+    noexcept
+//! Fused softmax of attention scores and product by values on CPU
+/*! Scores are rematerialized by blocks of flash_block::block_size keys and
+ * queries, turned into probabilities with help of precomputed maximums and
+ * sums of exponents, and immediately applied to values.
+ *
+ * Mnemonically, the following operations are performed:
+ *      S[:,:,b] = mask ? K[:,:,b]^T Q[:,:,b] / sqrt(head) : -inf
+ *      P[:,q,b] = exp(S[:,q,b]-maxsumexp[0,q,b]) / maxsumexp[1,q,b]
+ *      A[:,:,b] += V[:,:,b] P[:,:,b]
+ *
+ * @param[in] seq: Number of keys and queries
+ * @param[in] head: Head size
+ * @param[in] batch: Number of independent attention problems
+ * @param[in] K: Keys as a contiguous head-by-seq-by-batch array
+ * @param[in] Q: Queries as a contiguous head-by-seq-by-batch array
+ * @param[in] mask: Contiguous seq-by-seq array of mask values
+ * @param[in] maxsumexp: Contiguous 2-by-seq-by-batch array of maximums and
+ *      sums of exponents of scores over all the keys
+ * @param[in] V: Values as a contiguous head-by-seq-by-batch array
+ * @param[inout] A: Contiguous head-by-seq-by-batch array, that accumulates
+ *      the result
+ * */
+{
+    using flash_block::block_size;
+    constexpr T zero = 0;
+    const T scale = T{1} / std::sqrt(T(head));
+    T P[block_size*block_size];
+    for(Index b = 0; b < batch; ++b)
+    {
+        const Index offset = b * head * seq;
+        const T *K_b = K + offset, *Q_b = Q + offset, *V_b = V + offset;
+        const T *maxsumexp_b = maxsumexp + 2*b*seq;
+        T *A_b = A + offset;
+        for(Index q0 = 0; q0 < seq; q0 += block_size)
+        {
+            Index nq = std::min(block_size, seq-q0);
+            for(Index k0 = 0; k0 < seq; k0 += block_size)
+            {
+                Index nk = std::min(block_size, seq-k0);
+                flash_block::scores<T>(head, seq, nk, nq, K_b+k0*head,
+                        Q_b+q0*head, mask+q0*seq+k0, scale, P);
+                flash_block::probs<T>(nk, nq, maxsumexp_b+2*q0, P);
+                // A[:,q] += sum_k P[k,q] V[:,k]
+                for(Index q = 0; q < nq; ++q)
+                {
+                    T *A_q = A_b + (q0+q)*head;
+                    for(Index k = 0; k < nk; ++k)
+                    {
+                        const T p = P[q*nk+k];
+                        if(p == zero)
+                        {
+                            continue;
+                        }
+                        const T *V_k = V_b + (k0+k)*head;
+                        NNTILE_SIMD
+                        for(Index h = 0; h < head; ++h)
+                        {
+                            A_q[h] += p * V_k[h];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index seq, Index head, Index batch, const fp32_t *K,
+        const fp32_t *Q, const bool_t *mask, const fp32_t *maxsumexp,
+        const fp32_t *V, fp32_t *A)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index seq, Index head, Index batch, const fp64_t *K,
+        const fp64_t *Q, const bool_t *mask, const fp64_t *maxsumexp,
+        const fp64_t *V, fp64_t *A)
+    noexcept;
+
+} // namespace flash_softmax_gemm
+} // namespace kernel
+} // namespace nntile
+
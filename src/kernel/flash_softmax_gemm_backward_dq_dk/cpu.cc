@@ -0,0 +1,167 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/flash_softmax_gemm_backward_dq_dk/cpu.cc
+ * Flash attention backward to get gradients of Q and K on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-06
+ * */
+
+#include "nntile/kernel/flash_softmax_gemm_backward_dq_dk/cpu.hh"
+#include "nntile/kernel/flash_block.hh"
+#include <algorithm>
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace flash_softmax_gemm_backward_dq_dk
+{
+
+template<typename T>
+NNTILE_CPU_DISPATCH
+void cpu(Index seq, Index head, Index batch, const T *K, const T *Q,
+        const bool_t *mask, const T *maxsumexp, const T *dA, const T *V,
+        const T *sumprod_slice, T *dQ, T *dK)
+    noexcept
+//! Gradients of Q and K of flash attention on CPU
+/*! Probabilities and their gradients are rematerialized by blocks of
+ * flash_block::block_size keys and queries and consumed at once.
+ *
+ * Mnemonically, the following operations are performed:
+ *      S[:,:,b] = mask ? K[:,:,b]^T Q[:,:,b] / sqrt(head) : -inf
+ *      P[:,q,b] = exp(S[:,q,b]-maxsumexp[0,q,b]) / maxsumexp[1,q,b]
+ *      dS[k,q,b] = P[k,q,b] * (dot(V[:,k,b], dA[:,q,b])-sumprod_slice[q,b])
+ *      dQ[:,:,b] += K[:,:,b] dS[:,:,b] / sqrt(head)
+ *      dK[:,:,b] += Q[:,:,b] dS[:,:,b]^T / sqrt(head)
+ *
+ * @param[in] seq: Number of keys and queries
+ * @param[in] head: Head size
+ * @param[in] batch: Number of independent attention problems
+ * @param[in] K: Keys as a contiguous head-by-seq-by-batch array
+ * @param[in] Q: Queries as a contiguous head-by-seq-by-batch array
+ * @param[in] mask: Contiguous seq-by-seq array of mask values
+ * @param[in] maxsumexp: Contiguous 2-by-seq-by-batch array of maximums and
+ *      sums of exponents of scores over all the keys
+ * @param[in] dA: Gradient of output as a contiguous head-by-seq-by-batch
+ *      array
+ * @param[in] V: Values as a contiguous head-by-seq-by-batch array
+ * @param[in] sumprod_slice: Contiguous seq-by-batch array of sums of
+ *      products over all the keys
+ * @param[inout] dQ: Contiguous head-by-seq-by-batch array, that accumulates
+ *      gradient of queries
+ * @param[inout] dK: Contiguous head-by-seq-by-batch array, that accumulates
+ *      gradient of keys
+ * */
+{
+    using flash_block::block_size;
+    constexpr T zero = 0;
+    const T scale = T{1} / std::sqrt(T(head));
+    T dS[block_size*block_size];
+    for(Index b = 0; b < batch; ++b)
+    {
+        const Index offset = b * head * seq;
+        const T *K_b = K + offset, *Q_b = Q + offset, *V_b = V + offset,
+              *dA_b = dA + offset;
+        const T *maxsumexp_b = maxsumexp + 2*b*seq,
+              *sumprod_slice_b = sumprod_slice + b*seq;
+        T *dQ_b = dQ + offset, *dK_b = dK + offset;
+        for(Index q0 = 0; q0 < seq; q0 += block_size)
+        {
+            Index nq = std::min(block_size, seq-q0);
+            for(Index k0 = 0; k0 < seq; k0 += block_size)
+            {
+                Index nk = std::min(block_size, seq-k0);
+                flash_block::scores<T>(head, seq, nk, nq, K_b+k0*head,
+                        Q_b+q0*head, mask+q0*seq+k0, scale, dS);
+                flash_block::probs<T>(nk, nq, maxsumexp_b+2*q0, dS);
+                // Gradient of scores with scaling factor applied
+                for(Index q = 0; q < nq; ++q)
+                {
+                    const T *dA_q = dA_b + (q0+q)*head;
+                    const T sumprod = sumprod_slice_b[q0+q];
+                    for(Index k = 0; k < nk; ++k)
+                    {
+                        T &val = dS[q*nk+k];
+                        if(val == zero)
+                        {
+                            continue;
+                        }
+                        const T *V_k = V_b + (k0+k)*head;
+                        T dot = zero;
+                        NNTILE_SIMD_REDUCTION(+, dot)
+                        for(Index h = 0; h < head; ++h)
+                        {
+                            dot += V_k[h] * dA_q[h];
+                        }
+                        val *= scale * (dot-sumprod);
+                    }
+                }
+                // dQ[:,q] += sum_k dS[k,q] K[:,k]
+                for(Index q = 0; q < nq; ++q)
+                {
+                    T *dQ_q = dQ_b + (q0+q)*head;
+                    for(Index k = 0; k < nk; ++k)
+                    {
+                        const T ds = dS[q*nk+k];
+                        if(ds == zero)
+                        {
+                            continue;
+                        }
+                        const T *K_k = K_b + (k0+k)*head;
+                        NNTILE_SIMD
+                        for(Index h = 0; h < head; ++h)
+                        {
+                            dQ_q[h] += ds * K_k[h];
+                        }
+                    }
+                }
+                // dK[:,k] += sum_q dS[k,q] Q[:,q]
+                for(Index k = 0; k < nk; ++k)
+                {
+                    T *dK_k = dK_b + (k0+k)*head;
+                    for(Index q = 0; q < nq; ++q)
+                    {
+                        const T ds = dS[q*nk+k];
+                        if(ds == zero)
+                        {
+                            continue;
+                        }
+                        const T *Q_q = Q_b + (q0+q)*head;
+                        NNTILE_SIMD
+                        for(Index h = 0; h < head; ++h)
+                        {
+                            dK_k[h] += ds * Q_q[h];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index seq, Index head, Index batch, const fp32_t *K,
+        const fp32_t *Q, const bool_t *mask, const fp32_t *maxsumexp,
+        const fp32_t *dA, const fp32_t *V, const fp32_t *sumprod_slice,
+        fp32_t *dQ, fp32_t *dK)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index seq, Index head, Index batch, const fp64_t *K,
+        const fp64_t *Q, const bool_t *mask, const fp64_t *maxsumexp,
+        const fp64_t *dA, const fp64_t *V, const fp64_t *sumprod_slice,
+        fp64_t *dQ, fp64_t *dK)
+    noexcept;
+
+} // namespace flash_softmax_gemm_backward_dq_dk
+} // namespace kernel
+} // namespace nntile
+
@@ -0,0 +1,143 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/flash_softmax_gemm_backward_sumprod_slice/cpu.cc
+ * Flash attention backward to get gradient of V and sumprod_slice on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-06
+ * */
+
+#include "nntile/kernel/flash_softmax_gemm_backward_sumprod_slice/cpu.hh"
+#include "nntile/kernel/flash_block.hh"
+#include <algorithm>
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace flash_softmax_gemm_backward_sumprod_slice
+{
+
+template<typename T>
+NNTILE_CPU_DISPATCH
+void cpu(Index seq, Index head, Index batch, const T *K, const T *Q,
+        const bool_t *mask, const T *maxsumexp, const T *dA, const T *V,
+        T *dV, T *sumprod_slice)
+    noexcept
+//! Gradient of V and sums of products of probabilities and their gradients
+/*! Probabilities are rematerialized by blocks of flash_block::block_size keys
+ * and queries and consumed at once.
+ *
+ * Mnemonically, the following operations are performed:
+ *      S[:,:,b] = mask ? K[:,:,b]^T Q[:,:,b] / sqrt(head) : -inf
+ *      P[:,q,b] = exp(S[:,q,b]-maxsumexp[0,q,b]) / maxsumexp[1,q,b]
+ *      dV[:,:,b] += dA[:,:,b] P[:,:,b]^T
+ *      sumprod_slice[q,b] += sum_k P[k,q,b] * dot(V[:,k,b], dA[:,q,b])
+ *
+ * @param[in] seq: Number of keys and queries
+ * @param[in] head: Head size
+ * @param[in] batch: Number of independent attention problems
+ * @param[in] K: Keys as a contiguous head-by-seq-by-batch array
+ * @param[in] Q: Queries as a contiguous head-by-seq-by-batch array
+ * @param[in] mask: Contiguous seq-by-seq array of mask values
+ * @param[in] maxsumexp: Contiguous 2-by-seq-by-batch array of maximums and
+ *      sums of exponents of scores over all the keys
+ * @param[in] dA: Gradient of output as a contiguous head-by-seq-by-batch
+ *      array
+ * @param[in] V: Values as a contiguous head-by-seq-by-batch array
+ * @param[inout] dV: Contiguous head-by-seq-by-batch array, that accumulates
+ *      gradient of values
+ * @param[inout] sumprod_slice: Contiguous seq-by-batch array, that
+ *      accumulates sums of products
+ * */
+{
+    using flash_block::block_size;
+    constexpr T zero = 0;
+    const T scale = T{1} / std::sqrt(T(head));
+    T P[block_size*block_size];
+    for(Index b = 0; b < batch; ++b)
+    {
+        const Index offset = b * head * seq;
+        const T *K_b = K + offset, *Q_b = Q + offset, *V_b = V + offset,
+              *dA_b = dA + offset;
+        const T *maxsumexp_b = maxsumexp + 2*b*seq;
+        T *dV_b = dV + offset, *sumprod_slice_b = sumprod_slice + b*seq;
+        for(Index q0 = 0; q0 < seq; q0 += block_size)
+        {
+            Index nq = std::min(block_size, seq-q0);
+            for(Index k0 = 0; k0 < seq; k0 += block_size)
+            {
+                Index nk = std::min(block_size, seq-k0);
+                flash_block::scores<T>(head, seq, nk, nq, K_b+k0*head,
+                        Q_b+q0*head, mask+q0*seq+k0, scale, P);
+                flash_block::probs<T>(nk, nq, maxsumexp_b+2*q0, P);
+                // dV[:,k] += sum_q P[k,q] dA[:,q]
+                for(Index k = 0; k < nk; ++k)
+                {
+                    T *dV_k = dV_b + (k0+k)*head;
+                    for(Index q = 0; q < nq; ++q)
+                    {
+                        const T p = P[q*nk+k];
+                        if(p == zero)
+                        {
+                            continue;
+                        }
+                        const T *dA_q = dA_b + (q0+q)*head;
+                        NNTILE_SIMD
+                        for(Index h = 0; h < head; ++h)
+                        {
+                            dV_k[h] += p * dA_q[h];
+                        }
+                    }
+                }
+                // sumprod_slice[q] += sum_k P[k,q] dot(V[:,k], dA[:,q])
+                for(Index q = 0; q < nq; ++q)
+                {
+                    const T *dA_q = dA_b + (q0+q)*head;
+                    T sum = zero;
+                    for(Index k = 0; k < nk; ++k)
+                    {
+                        const T p = P[q*nk+k];
+                        if(p == zero)
+                        {
+                            continue;
+                        }
+                        const T *V_k = V_b + (k0+k)*head;
+                        T dot = zero;
+                        NNTILE_SIMD_REDUCTION(+, dot)
+                        for(Index h = 0; h < head; ++h)
+                        {
+                            dot += V_k[h] * dA_q[h];
+                        }
+                        sum += p * dot;
+                    }
+                    sumprod_slice_b[q0+q] += sum;
+                }
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index seq, Index head, Index batch, const fp32_t *K,
+        const fp32_t *Q, const bool_t *mask, const fp32_t *maxsumexp,
+        const fp32_t *dA, const fp32_t *V, fp32_t *dV, fp32_t *sumprod_slice)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index seq, Index head, Index batch, const fp64_t *K,
+        const fp64_t *Q, const bool_t *mask, const fp64_t *maxsumexp,
+        const fp64_t *dA, const fp64_t *V, fp64_t *dV, fp64_t *sumprod_slice)
+    noexcept;
+
+} // namespace flash_softmax_gemm_backward_sumprod_slice
+} // namespace kernel
+} // namespace nntile
+
@@ -13,7 +13,6 @@
  * */
 
 #include "nntile/kernel/fp16_to_fp32/cpu.hh"
-#include <cuda_fp16.h>
 
 namespace nntile
 {
@@ -30,10 +29,9 @@ void cpu(Index nelems, const fp16_t *src, fp32_t *dst)
  * @params[out] dst: Output array
  * */
 {
-    const __half *src_half = reinterpret_cast<const __half *>(src);
     for(Index i = 0; i < nelems; ++i)
     {
-        dst[i] = __half2float(src_half[i]);
+        dst[i] = src[i];
     }
 }
 
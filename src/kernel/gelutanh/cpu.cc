@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/gelutanh/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 #include <cmath>
 
 namespace nntile
@@ -23,6 +24,7 @@ namespace gelutanh
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index nelems, const T *src, T *dst)
     noexcept
 //! Approximate GeLU operation on CPU
@@ -38,23 +40,25 @@ void cpu(Index nelems, const T *src, T *dst)
  * @params[out] dst: Output buffer to apply GeLU
  * */
 {
+    using Y = compute_t<T>;
     // Constants
-    constexpr T pi = 3.141592653589793238462643383279502884L,
-        one = 1, pt5 = 0.5, f1 = T{0.044715};
+    constexpr Y pi = 3.141592653589793238462643383279502884L,
+        one = 1, pt5 = 0.5, f1 = Y{0.044715};
     // Square root is not constexpr by standard, proceed with a static const
-    static const T sqrt_pi = std::sqrt(pi), sqrt_2 = std::sqrt(T{2}),
-        f2 = sqrt_2/sqrt_pi, f3 = -T{2}*f2, f4 = f3*f1;
+    static const Y sqrt_pi = std::sqrt(pi), sqrt_2 = std::sqrt(Y{2}),
+        f2 = sqrt_2/sqrt_pi, f3 = -Y{2}*f2, f4 = f3*f1;
+    NNTILE_SIMD
     for(Index i = 0; i < nelems; ++i)
     {
-        T z = src[i];
-        //T y = z * (f3 + f4*z*z);
+        Y z = src[i];
+        //Y y = z * (f3 + f4*z*z);
         //dst[i] = z / (one+std::exp(y));
-        T y1 = f4 * z * z;
-        T y2 = f3 + y1;
-        T c = y1 - (y2-f3);
+        Y y1 = f4 * z * z;
+        Y y2 = f3 + y1;
+        Y c = y1 - (y2-f3);
         y2 *= z;
         c *= z;
-        T y3 = one + std::exp(c)*std::exp(y2);
+        Y y3 = one + simd::exp(c)*simd::exp(y2);
         dst[i] = z / y3;
     }
 }
@@ -68,6 +72,10 @@ template
 void cpu<fp64_t>(Index nelems, const fp64_t *src, fp64_t *dst)
     noexcept;
 
+template
+void cpu<bf16_t>(Index nelems, const bf16_t *src, bf16_t *dst)
+    noexcept;
+
 } // namespace gelutanh
 } // namespace kernel
 } // namespace nntile
@@ -14,7 +14,9 @@
  * */
 
 #include "nntile/kernel/gelutanh_backward/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 #include <cmath>
+#include <limits>
 
 namespace nntile
 {
@@ -24,6 +26,7 @@ namespace gelutanh_backward
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index nelems, const T *x, const T *dy, T *dx)
     noexcept
 //! Backward of approximate GeLU operation on CPU
@@ -43,14 +46,17 @@ void cpu(Index nelems, const T *x, const T *dy, T *dx)
     // Square root is not constexpr by standard, proceed with a static const
     static const T sqrt_pi = std::sqrt(pi), sqrt_2 = std::sqrt(T{2}),
         f2 = sqrt_2/sqrt_pi, f3 = -T{2}*f2, f4 = f3*f1, f5 = T{3}*f4;
+    constexpr T inf = std::numeric_limits<T>::infinity();
+    NNTILE_SIMD
     for(Index i = 0; i < nelems; ++i)
     {
         // T z = x[i];
         T z2 = x[i] * x[i];
         T y1 = x[i] * (f3 + f4*z2);
         T y2 = x[i] * (f3 + f5*z2);
-        T expy1 = std::exp(y1);
-        if(not std::isinf(expy1))
+        T expy1 = simd::exp(y1);
+        // Overflow of exponent means zero derivative, skip such elements
+        if(expy1 != inf)
         {
             T inv_expy1p1 = one / (expy1 + one);
             dx[i] += (one-y2*(one-inv_expy1p1)) * inv_expy1p1 * dy[i];
@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/gelutanh_inplace/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 #include <cmath>
 
 namespace nntile
@@ -23,6 +24,7 @@ namespace gelutanh_inplace
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index nelems, T *data)
     noexcept
 //! Approximate GeLU operation on CPU
@@ -43,11 +45,12 @@ void cpu(Index nelems, T *data)
     // Square root is not constexpr by standard, proceed with a static const
     static const T sqrt_pi = std::sqrt(pi), sqrt_2 = std::sqrt(T{2}),
         f2 = sqrt_2/sqrt_pi, f3 = -T{2}*f2, f4 = f3*f1;
+    NNTILE_SIMD
     for(Index i = 0; i < nelems; ++i)
     {
         T z = data[i];
         T y = z * (f3 + f4*z*z);
-        data[i] = z / (one+std::exp(y));
+        data[i] = z / (one+simd::exp(y));
     }
 }
 
@@ -0,0 +1,153 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/gemm_int8/cpu.cc
+ * Matrix multiplication by per-channel quantized int8 weights on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-20
+ * */
+
+#include "nntile/kernel/gemm_int8/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
+#include <algorithm>
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace gemm_int8
+{
+
+//! Products of a single output channel by all the quantized input vectors
+/*! Computes acc[j] = sum_p w_i[p]*x_quant[p,j] in 32-bit integers. This is
+ * not a template, as the compiler ignores optimization attributes of
+ * template instantiations.
+ * */
+static NNTILE_CPU_DISPATCH_VNNI
+void channel_dots(Index n, Index k, const int8_t *w_i,
+        const std::int16_t *x_quant, std::int16_t *w_col, std::int32_t *acc)
+    noexcept
+{
+    for(Index p = 0; p < k; ++p)
+    {
+        w_col[p] = w_i[p];
+    }
+    for(Index j = 0; j < n; ++j)
+    {
+        const std::int16_t *x_quant_j = x_quant + j*k;
+        std::int32_t sum = 0;
+        for(Index p = 0; p < k; ++p)
+        {
+            sum += w_col[p] * x_quant_j[p];
+        }
+        acc[j] = sum;
+    }
+}
+
+template<typename T>
+NNTILE_CPU_DISPATCH
+void cpu(const TransOp &trans, Index m, Index n, Index k, T alpha,
+        const int8_t *w, const T *w_scale, const T *x, T beta, T *y,
+        T *x_scale, std::int16_t *x_quant, std::int16_t *w_col,
+        std::int32_t *acc)
+    noexcept
+//! Multiply buffer by int8 weights, quantizing the buffer on the fly
+/*! Weights W of shape [m,k] are stored transposed, as int8 matrix w of shape
+ * [k,m] with scales w_scale of shape [m], so that W[i,p] is
+ * w_scale[i]*w[p,i] and every output channel is contiguous. Every column
+ * x[:,j] of shape [k] is quantized symmetrically with its own scale
+ * x_scale[j]=max(abs(x[:,j]))/127, and the output is computed as
+ *      y[i,j] = alpha*w_scale[i]*x_scale[j]*sum_p w[p,i]*x_quant[p,j]
+ *          + beta*y[i,j],
+ * where the sum is accumulated in 32-bit integers. Quantized values fit into
+ * 8 bits, but are kept as 16-bit integers for the vectorized dot products.
+ * If trans is TransOp::Trans, then x and y are stored transposed, i.e.
+ * their shapes are [n,k] and [n,m] correspondingly.
+ *
+ * @param[in] trans: Whether x and y are stored transposed
+ * @param[in] m: Number of output channels
+ * @param[in] n: Number of input vectors
+ * @param[in] k: Number of input channels
+ * @param[in] alpha: Scalar multiplier for the product
+ * @param[in] w: Quantized weights of shape [k,m]
+ * @param[in] w_scale: Scales of output channels of shape [m]
+ * @param[in] x: Input buffer of shape [k,n] or [n,k]
+ * @param[in] beta: Scalar multiplier for y. If it is zero, then y is only
+ *      written
+ * @param[inout] y: Output buffer of shape [m,n] or [n,m]
+ * @param[out] x_scale: Scratch for scales of input vectors of shape [n]
+ * @param[out] x_quant: Scratch for quantized input of shape [k,n]
+ * @param[out] w_col: Scratch for a single output channel of shape [k]
+ * @param[out] acc: Scratch for integer dot products of shape [n]
+ * */
+{
+    constexpr T qmax = 127, zero = 0;
+    // Strides of x and y along their dimensions
+    Index x_stride_k = 1, x_stride_n = k, y_stride_m = 1, y_stride_n = m;
+    if(trans.value == TransOp::Trans)
+    {
+        x_stride_k = n;
+        x_stride_n = 1;
+        y_stride_m = n;
+        y_stride_n = 1;
+    }
+    // Quantize input vectors one by one
+    for(Index j = 0; j < n; ++j)
+    {
+        const T *x_j = x + j*x_stride_n;
+        std::int16_t *x_quant_j = x_quant + j*k;
+        T amax = zero;
+        NNTILE_SIMD_REDUCTION(max, amax)
+        for(Index p = 0; p < k; ++p)
+        {
+            amax = std::max(amax, std::abs(x_j[p*x_stride_k]));
+        }
+        x_scale[j] = amax / qmax;
+        T inv_scale = (amax > zero) ? qmax/amax : zero;
+        NNTILE_SIMD
+        for(Index p = 0; p < k; ++p)
+        {
+            x_quant_j[p] = static_cast<std::int16_t>(
+                    std::nearbyint(inv_scale*x_j[p*x_stride_k]));
+        }
+    }
+    // Weights are read only once, as every output channel is multiplied by
+    // all the quantized input vectors, that reside in cache
+    for(Index i = 0; i < m; ++i)
+    {
+        channel_dots(n, k, w+i*k, x_quant, w_col, acc);
+        T scale_i = alpha * w_scale[i];
+        for(Index j = 0; j < n; ++j)
+        {
+            T val = scale_i * x_scale[j] * static_cast<T>(acc[j]);
+            T &dst = y[i*y_stride_m+j*y_stride_n];
+            if(beta == zero)
+            {
+                dst = val;
+            }
+            else
+            {
+                dst = beta*dst + val;
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(const TransOp &trans, Index m, Index n, Index k,
+        fp32_t alpha, const int8_t *w, const fp32_t *w_scale, const fp32_t *x,
+        fp32_t beta, fp32_t *y, fp32_t *x_scale, std::int16_t *x_quant,
+        std::int16_t *w_col, std::int32_t *acc)
+    noexcept;
+
+} // namespace gemm_int8
+} // namespace kernel
+} // namespace nntile
+
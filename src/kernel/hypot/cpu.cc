@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/hypot/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 #include <cmath>
 
 namespace nntile
@@ -23,6 +24,7 @@ namespace hypot
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index nelems, T alpha, const T* src, T beta, T* dst)
     noexcept
 //! hypot of two buffers on CPU
@@ -42,6 +44,7 @@ void cpu(Index nelems, T alpha, const T* src, T beta, T* dst)
     {
         if(beta == zero)
         {
+            NNTILE_SIMD
             for(Index i = 0; i < nelems; ++i)
             {
                 dst[i] = zero;
@@ -49,6 +52,7 @@ void cpu(Index nelems, T alpha, const T* src, T beta, T* dst)
         }
         else
         {
+            NNTILE_SIMD
             for(Index i = 0; i < nelems; ++i)
             {
                 dst[i] = std::fabs(beta * dst[i]);
@@ -59,6 +63,7 @@ void cpu(Index nelems, T alpha, const T* src, T beta, T* dst)
     {
         if(beta == zero)
         {
+            NNTILE_SIMD
             for(Index i = 0; i < nelems; ++i)
             {
                 dst[i] = std::fabs(alpha * src[i]);
@@ -0,0 +1,167 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/layer_norm_backward/cpu.cc
+ * Fused backward pass of layer normalization on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-08
+ * */
+
+#include "nntile/kernel/layer_norm_backward/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace layer_norm_backward
+{
+
+template<typename T>
+NNTILE_CPU_DISPATCH
+void cpu(Index m, Index n, Index k, const T *src_normalized,
+        const T *dst_grad, const T *gamma, const T *inv_stddev, T *src_grad,
+        T *gamma_grad, T *beta_grad)
+    noexcept
+//! Gradients of layer normalization over fibers along middle axis on CPU
+/*! Replaces sum_fiber, sumprod_fiber, prod_fiber3, sumprod_slice,
+ * prod_slice, axpy, sum_slice, add_slice, prod_slice and axpy operations of
+ * the backward pass. Inputs are read twice, and the second read of an m-by-k
+ * slab usually hits cache.
+ * Mnemonically, the following operations are performed:
+ *      beta_grad[l] += sum(dst_grad[:,l,:])
+ *      gamma_grad[l] += sum(dst_grad[:,l,:]*src_normalized[:,l,:])
+ *      g[i,l,j] = gamma[l] * dst_grad[i,l,j]
+ *      src_grad[i,l,j] += inv_stddev[i,j] * (g[i,l,j] - mean(g[i,:,j])
+ *          - src_normalized[i,l,j]*mean(g[i,:,j]*src_normalized[i,:,j]))
+ *
+ * @param[in] m: Size of the first mode of input arrays
+ * @param[in] n: Size of the last mode of input arrays
+ * @param[in] k: Size of the middle mode of input arrays
+ * @param[in] src_normalized: Normalized input of the forward pass as a
+ *      contiguous m-by-k-by-n array
+ * @param[in] dst_grad: Gradient of output as a contiguous m-by-k-by-n array
+ * @param[in] gamma: Scaling factors as a contiguous array of size k
+ * @param[in] inv_stddev: Inverse standard deviations as a contiguous m-by-n
+ *      array
+ * @param[inout] src_grad: Contiguous m-by-k-by-n array, that accumulates
+ *      gradient of input
+ * @param[inout] gamma_grad: Contiguous array of size k, that accumulates
+ *      gradient of gamma
+ * @param[inout] beta_grad: Contiguous array of size k, that accumulates
+ *      gradient of beta
+ * */
+{
+    const Index mk = m * k;
+    const T inv_k = T{1} / T(k);
+    // Fibers are contiguous, so reductions are vectorized along them
+    if(m == 1)
+    {
+        for(Index i2 = 0; i2 < n; ++i2)
+        {
+            const T *x = src_normalized + i2*k, *dy = dst_grad + i2*k;
+            T *dx = src_grad + i2*k;
+            T sum_g = 0, sum_gx = 0;
+            NNTILE_SIMD_REDUCTION(+, sum_g)
+            for(Index i0 = 0; i0 < k; ++i0)
+            {
+                sum_g += gamma[i0] * dy[i0];
+            }
+            NNTILE_SIMD_REDUCTION(+, sum_gx)
+            for(Index i0 = 0; i0 < k; ++i0)
+            {
+                T dyx = dy[i0] * x[i0];
+                sum_gx += gamma[i0] * dyx;
+                gamma_grad[i0] += dyx;
+                beta_grad[i0] += dy[i0];
+            }
+            const T inv = inv_stddev[i2];
+            const T mean_g = sum_g * inv_k, mean_gx = sum_gx * inv_k;
+            NNTILE_SIMD
+            for(Index i0 = 0; i0 < k; ++i0)
+            {
+                dx[i0] += inv * (gamma[i0]*dy[i0]-mean_g-x[i0]*mean_gx);
+            }
+        }
+        return;
+    }
+    // Otherwise, fibers are processed by chunks along the first mode, and
+    // reductions are accumulated in small buffers on stack
+    constexpr Index chunk = 256;
+    T sum_g[chunk], sum_gx[chunk];
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        const T *x_slab = src_normalized + i2*mk, *dy_slab = dst_grad + i2*mk;
+        T *dx_slab = src_grad + i2*mk;
+        const T *inv_slice = inv_stddev + i2*m;
+        for(Index i1_start = 0; i1_start < m; i1_start += chunk)
+        {
+            const Index nrows = std::min(chunk, m-i1_start);
+            for(Index i1 = 0; i1 < nrows; ++i1)
+            {
+                sum_g[i1] = 0;
+                sum_gx[i1] = 0;
+            }
+            for(Index i0 = 0; i0 < k; ++i0)
+            {
+                const T *x = x_slab + i0*m + i1_start;
+                const T *dy = dy_slab + i0*m + i1_start;
+                const T gamma_val = gamma[i0];
+                T sum_dy = 0, sum_dyx = 0;
+                NNTILE_SIMD_REDUCTION(+, sum_dy)
+                for(Index i1 = 0; i1 < nrows; ++i1)
+                {
+                    sum_dy += dy[i1];
+                }
+                NNTILE_SIMD_REDUCTION(+, sum_dyx)
+                for(Index i1 = 0; i1 < nrows; ++i1)
+                {
+                    T dyx = dy[i1] * x[i1];
+                    sum_dyx += dyx;
+                    sum_g[i1] += gamma_val * dy[i1];
+                    sum_gx[i1] += gamma_val * dyx;
+                }
+                beta_grad[i0] += sum_dy;
+                gamma_grad[i0] += sum_dyx;
+            }
+            for(Index i0 = 0; i0 < k; ++i0)
+            {
+                const T *x = x_slab + i0*m + i1_start;
+                const T *dy = dy_slab + i0*m + i1_start;
+                const T *inv = inv_slice + i1_start;
+                T *dx = dx_slab + i0*m + i1_start;
+                const T gamma_val = gamma[i0];
+                NNTILE_SIMD
+                for(Index i1 = 0; i1 < nrows; ++i1)
+                {
+                    dx[i1] += inv[i1] * (gamma_val*dy[i1]-sum_g[i1]*inv_k
+                            -x[i1]*sum_gx[i1]*inv_k);
+                }
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index k, const fp32_t *src_normalized,
+        const fp32_t *dst_grad, const fp32_t *gamma, const fp32_t *inv_stddev,
+        fp32_t *src_grad, fp32_t *gamma_grad, fp32_t *beta_grad)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index k, const fp64_t *src_normalized,
+        const fp64_t *dst_grad, const fp64_t *gamma, const fp64_t *inv_stddev,
+        fp64_t *src_grad, fp64_t *gamma_grad, fp64_t *beta_grad)
+    noexcept;
+
+} // namespace layer_norm_backward
+} // namespace kernel
+} // namespace nntile
+
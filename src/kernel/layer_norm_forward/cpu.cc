@@ -0,0 +1,173 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/layer_norm_forward/cpu.cc
+ * Fused forward pass of layer normalization on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-08
+ * */
+
+#include "nntile/kernel/layer_norm_forward/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace layer_norm_forward
+{
+
+template<typename T>
+NNTILE_CPU_DISPATCH
+void cpu(Index m, Index n, Index k, T eps, const T *src, const T *gamma,
+        const T *beta, T *mean, T *inv_stddev, T *src_normalized, T *dst)
+    noexcept
+//! Layer normalization over fibers along middle axis on CPU
+/*! For a provided m-by-k-by-n input array src normalize fibers along the
+ * second axis and apply elementwise affine transformation. This replaces
+ * sum_slice, add_slice3, norm_slice, hypot_scalar_inverse, prod_slice,
+ * prod_fiber3 and add_fiber operations, that read and write the entire input
+ * several times. Here, the input is read three times, and every m-by-k slab
+ * is usually still in cache after the first read.
+ * Mnemonically, the following operations are performed:
+ *      mean[i,j] = sum(src[i,:,j]) / k
+ *      inv_stddev[i,j] = 1 / sqrt(sum((src[i,:,j]-mean[i,j])^2)/k + eps^2)
+ *      src_normalized[i,l,j] = (src[i,l,j]-mean[i,j]) * inv_stddev[i,j]
+ *      dst[i,l,j] = gamma[l]*src_normalized[i,l,j] + beta[l]
+ *
+ * @param[in] m: Size of the first mode of src and dst arrays
+ * @param[in] n: Size of the last mode of src and dst arrays
+ * @param[in] k: Size of the middle mode of src and dst arrays
+ * @param[in] eps: Regularization of the standard deviation
+ * @param[in] src: Input contiguous m-by-k-by-n array
+ * @param[in] gamma: Input scaling factors as a contiguous array of size k
+ * @param[in] beta: Input shifts as a contiguous array of size k
+ * @param[out] mean: Output contiguous m-by-n array of means
+ * @param[out] inv_stddev: Output contiguous m-by-n array of inverse
+ *      standard deviations
+ * @param[out] src_normalized: Output contiguous m-by-k-by-n array of
+ *      normalized input, that is required by the backward pass
+ * @param[out] dst: Output contiguous m-by-k-by-n array
+ * */
+{
+    const Index mk = m * k;
+    const T inv_k = T{1} / T(k);
+    const T eps2 = eps * eps;
+    // Fibers are contiguous, so reductions are vectorized along them
+    if(m == 1)
+    {
+        for(Index i2 = 0; i2 < n; ++i2)
+        {
+            const T *src_fiber = src + i2*k;
+            T *src_normalized_fiber = src_normalized + i2*k;
+            T *dst_fiber = dst + i2*k;
+            T sum = 0;
+            NNTILE_SIMD_REDUCTION(+, sum)
+            for(Index i0 = 0; i0 < k; ++i0)
+            {
+                sum += src_fiber[i0];
+            }
+            const T avg = sum * inv_k;
+            T ssq = 0;
+            NNTILE_SIMD_REDUCTION(+, ssq)
+            for(Index i0 = 0; i0 < k; ++i0)
+            {
+                T diff = src_fiber[i0] - avg;
+                ssq += diff * diff;
+            }
+            const T inv = T{1} / std::sqrt(ssq*inv_k+eps2);
+            mean[i2] = avg;
+            inv_stddev[i2] = inv;
+            NNTILE_SIMD
+            for(Index i0 = 0; i0 < k; ++i0)
+            {
+                T val = (src_fiber[i0]-avg) * inv;
+                src_normalized_fiber[i0] = val;
+                dst_fiber[i0] = gamma[i0]*val + beta[i0];
+            }
+        }
+        return;
+    }
+    // Otherwise, m fibers are processed at once, vectorized along the first
+    // mode, while output slices serve as accumulators
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        const T *src_slab = src + i2*mk;
+        T *src_normalized_slab = src_normalized + i2*mk;
+        T *dst_slab = dst + i2*mk;
+        T *mean_slice = mean + i2*m;
+        T *inv_stddev_slice = inv_stddev + i2*m;
+        for(Index i1 = 0; i1 < m; ++i1)
+        {
+            mean_slice[i1] = 0;
+            inv_stddev_slice[i1] = 0;
+        }
+        for(Index i0 = 0; i0 < k; ++i0)
+        {
+            const T *src_row = src_slab + i0*m;
+            NNTILE_SIMD
+            for(Index i1 = 0; i1 < m; ++i1)
+            {
+                mean_slice[i1] += src_row[i1];
+            }
+        }
+        NNTILE_SIMD
+        for(Index i1 = 0; i1 < m; ++i1)
+        {
+            mean_slice[i1] *= inv_k;
+        }
+        for(Index i0 = 0; i0 < k; ++i0)
+        {
+            const T *src_row = src_slab + i0*m;
+            NNTILE_SIMD
+            for(Index i1 = 0; i1 < m; ++i1)
+            {
+                T diff = src_row[i1] - mean_slice[i1];
+                inv_stddev_slice[i1] += diff * diff;
+            }
+        }
+        for(Index i1 = 0; i1 < m; ++i1)
+        {
+            inv_stddev_slice[i1] = T{1}
+                / std::sqrt(inv_stddev_slice[i1]*inv_k+eps2);
+        }
+        for(Index i0 = 0; i0 < k; ++i0)
+        {
+            const T *src_row = src_slab + i0*m;
+            T *src_normalized_row = src_normalized_slab + i0*m;
+            T *dst_row = dst_slab + i0*m;
+            const T gamma_val = gamma[i0], beta_val = beta[i0];
+            NNTILE_SIMD
+            for(Index i1 = 0; i1 < m; ++i1)
+            {
+                T val = (src_row[i1]-mean_slice[i1]) * inv_stddev_slice[i1];
+                src_normalized_row[i1] = val;
+                dst_row[i1] = gamma_val*val + beta_val;
+            }
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, Index k, fp32_t eps, const fp32_t *src,
+        const fp32_t *gamma, const fp32_t *beta, fp32_t *mean,
+        fp32_t *inv_stddev, fp32_t *src_normalized, fp32_t *dst)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, Index k, fp64_t eps, const fp64_t *src,
+        const fp64_t *gamma, const fp64_t *beta, fp64_t *mean,
+        fp64_t *inv_stddev, fp64_t *src_normalized, fp64_t *dst)
+    noexcept;
+
+} // namespace layer_norm_forward
+} // namespace kernel
+} // namespace nntile
+
@@ -14,6 +14,7 @@
  * */
 
 #include "nntile/kernel/mask_scalar/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 
 namespace nntile
 {
@@ -23,6 +24,7 @@ namespace mask_scalar
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index nrows, Index ncols, const bool_t *mask, T val, T *data)
     noexcept
 //! Set certain matrix entries to a given value by mask on CPU
@@ -36,14 +38,17 @@ void cpu(Index nrows, Index ncols, const bool_t *mask, T val, T *data)
  * @params[in,out] data: nrows by ncols matrix, whose elements are updated
  * */
 {
-    for(Index i = 0; i < nrows; ++i)
+    // Read mask as bytes, compilers fail to vectorize loads of bool values
+    const unsigned char *mask_u8 = reinterpret_cast<const unsigned char *>(
+            mask);
+    // Traverse data contiguously, column by column
+    for(Index j = 0; j < ncols; ++j)
     {
-        if(!mask[i])
+        T *data_col = data + j*nrows;
+        NNTILE_SIMD
+        for(Index i = 0; i < nrows; ++i)
         {
-            for(Index j = 0; j < ncols; ++j)
-            {
-                data[j*nrows+i] = val;
-            }
+            data_col[i] = (mask_u8[i] != 0) ? data_col[i] : val;
         }
     }
 }
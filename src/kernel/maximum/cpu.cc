@@ -14,6 +14,7 @@
  * */
 
 #include "nntile/kernel/maximum/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 #include <cmath>
 
 namespace nntile
@@ -24,6 +25,7 @@ namespace maximum
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index nelems, const T *src, T *dst)
     noexcept
 //! Per-element maximum of two buffers
@@ -34,10 +36,14 @@ void cpu(Index nelems, const T *src, T *dst)
  * @param[inout] dst: Input buffers that contains output in the end
  * */
 {
-    // Cycle over buffers
+    // Cycle over buffers. Explicit comparisons follow std::fmax(), i.e.,
+    // NaN is ignored if the other value is a number, but unlike std::fmax()
+    // they can be vectorized
+    NNTILE_SIMD
     for(Index i = 0; i < nelems; ++i)
     {
-        dst[i] = std::fmax(src[i], dst[i]);
+        T a = src[i], b = dst[i];
+        dst[i] = (a > b or b != b) ? a : b;
     }
 }
 
@@ -46,9 +46,10 @@ void cpu(Index m, Index n, Index k, const T *src, T *maxsumexp)
  *      accumulates maximums and sums of exponents of slices along middle axis.
  * */
 {
+    using Y = compute_t<T>;
     const Index mk = m * k;
     Index dst_offset = 0;
-    constexpr T zero = 0, one = 1;
+    constexpr Y zero = 0, one = 1;
     // Cycle over row of output buffer
     for(Index i2 = 0; i2 < n; ++i2)
     {
@@ -58,13 +59,13 @@ void cpu(Index m, Index n, Index k, const T *src, T *maxsumexp)
             // Get max and sum of exponents of a corresponding slice
             const T *src_slice = src + i2*mk + i1;
             // Init max and sum with the first value
-            T max = src_slice[0];
-            T sum = one, c = zero, y, t;
+            Y max = src_slice[0];
+            Y sum = one, c = zero, y, t;
             // Cycle over slice of input buffer
             for(Index i0 = 1; i0 < k; ++i0)
             {
                 // Read value from source
-                T val = src_slice[i0*m];
+                Y val = src_slice[i0*m];
                 // Ignore -inf value, which comes from mask
                 if(std::isinf(val))
                 {
@@ -74,7 +75,7 @@ void cpu(Index m, Index n, Index k, const T *src, T *maxsumexp)
                 if(max < val)
                 {
                     //sum = sum*std::exp(max-val) + one;
-                    T tmp = std::exp(max-val);
+                    Y tmp = std::exp(max-val);
                     y = one - c*tmp;
                     sum *= tmp;
                     t = sum + y;
@@ -94,7 +95,7 @@ void cpu(Index m, Index n, Index k, const T *src, T *maxsumexp)
             // Save result, do nothing if all elements are masked out
             if(not std::isinf(max))
             {
-                T sum_old = maxsumexp[dst_offset+1];
+                Y sum_old = maxsumexp[dst_offset+1];
                 // If old sum is zero then just overwrite it with current sum
                 if(sum_old == zero)
                 {
@@ -104,7 +105,7 @@ void cpu(Index m, Index n, Index k, const T *src, T *maxsumexp)
                 // Update non-zero initial sum
                 else
                 {
-                    T max_old = maxsumexp[dst_offset];
+                    Y max_old = maxsumexp[dst_offset];
                     if(max_old < max)
                     {
                         maxsumexp[dst_offset] = max;
@@ -117,7 +118,7 @@ void cpu(Index m, Index n, Index k, const T *src, T *maxsumexp)
                     {
                         maxsumexp[dst_offset+1] = sum*std::exp(max-max_old)
                             + sum_old;
-                        T tmp = std::exp(max-max_old);
+                        Y tmp = std::exp(max-max_old);
                         y = sum_old - c*tmp;
                         sum *= tmp;
                         maxsumexp[dst_offset+1] = sum + y;
@@ -140,6 +141,11 @@ void cpu<fp64_t>(Index m, Index n, Index k, const fp64_t *src,
         fp64_t *maxsumexp)
     noexcept;
 
+template
+void cpu<bf16_t>(Index m, Index n, Index k, const bf16_t *src,
+        bf16_t *maxsumexp)
+    noexcept;
+
 } // namespace maxsumexp
 } // namespace kernel
 } // namespace nntile
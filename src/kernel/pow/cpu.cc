@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/pow/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 #include <cmath>
 
 namespace nntile
@@ -23,6 +24,7 @@ namespace pow
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index nelems, T alpha, T exp, T *data)
     noexcept
 //! Inplace power operation on CPU
@@ -33,16 +35,29 @@ void cpu(Index nelems, T alpha, T exp, T *data)
  * @params[inout] data: Buffer to apply power function
  * */
 {
-    for(Index i = 0; i < nelems; ++i)
+    // Branch over exponent outside of loops, so that common cases vectorize
+    if(exp == -1)
     {
-        T z = data[i];
-        if(exp == -1)
+        NNTILE_SIMD
+        for(Index i = 0; i < nelems; ++i)
         {
-            data[i] = alpha / z;
+            data[i] = alpha / data[i];
         }
-        else
+    }
+    else if(exp == 2)
+    {
+        NNTILE_SIMD
+        for(Index i = 0; i < nelems; ++i)
+        {
+            T z = data[i];
+            data[i] = alpha * (z*z);
+        }
+    }
+    else
+    {
+        for(Index i = 0; i < nelems; ++i)
         {
-            data[i] = alpha * std::pow(z, exp);
+            data[i] = alpha * std::pow(data[i], exp);
         }
     }
 }
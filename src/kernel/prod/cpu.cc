@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/prod/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 
 namespace nntile
 {
@@ -22,6 +23,7 @@ namespace prod
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index nelems, const T *src, T *dst)
     noexcept
 //! Per-element product of two buffers
@@ -32,10 +34,12 @@ void cpu(Index nelems, const T *src, T *dst)
  * @param[inout] dst: Input buffers that contains output in the end
  * */
 {
+    using Y = compute_t<T>;
     // Cycle over buffers
+    NNTILE_SIMD
     for(Index i = 0; i < nelems; ++i)
     {
-        dst[i] *= src[i];
+        dst[i] = static_cast<Y>(dst[i]) * static_cast<Y>(src[i]);
     }
 }
 
@@ -48,6 +52,10 @@ template
 void cpu<fp64_t>(Index nelems, const fp64_t *src, fp64_t *dst)
     noexcept;
 
+template
+void cpu<bf16_t>(Index nelems, const bf16_t *src, bf16_t *dst)
+    noexcept;
+
 } // namespace prod
 } // namespace kernel
 } // namespace nntile
@@ -13,9 +13,10 @@
  * */
 
 #include "nntile/kernel/randn/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
+#include <algorithm>
 #include <cmath>
-#include <iostream>
-#include "../external/random.h" // from external
+#include <cstdint>
 
 namespace nntile
 {
@@ -24,27 +25,119 @@ namespace kernel
 namespace randn
 {
 
-static inline fp32_t chameleon_randn(unsigned long long &seed, fp32_t mean,
-        fp32_t stddev)
+//! Maximal number of normal numbers, generated at once by a vectorized loop
+/*! Values do not depend on whether they are computed by vector or scalar
+ * instructions, as this file is compiled without contraction of floating
+ * point operations, so they do not depend on tiling either. */
+static constexpr Index block_size = 64;
+
+//! Single round of Philox4x32 generator
+static NNTILE_SIMD_INLINE void philox_round(std::uint32_t &ctr0,
+        std::uint32_t &ctr1, std::uint32_t &ctr2, std::uint32_t &ctr3,
+        std::uint32_t key0, std::uint32_t key1)
+    noexcept
 {
-    constexpr fp32_t two=2.0, twopi=6.2831853071795864769252867663;
-    fp32_t t1 = CORE_slaran(&seed);
-    fp32_t t2 = CORE_slaran(&seed) * twopi;
-    fp32_t t3 = std::sqrt(-two*std::log(t1)) * std::cos(t2);
-    return stddev*t3 + mean;
+    constexpr std::uint64_t mul0 = 0xD2511F53, mul1 = 0xCD9E8D57;
+    std::uint64_t prod0 = mul0 * ctr0, prod1 = mul1 * ctr2;
+    std::uint32_t new0 = static_cast<std::uint32_t>(prod1>>32) ^ ctr1 ^ key0;
+    std::uint32_t new2 = static_cast<std::uint32_t>(prod0>>32) ^ ctr3 ^ key1;
+    ctr1 = static_cast<std::uint32_t>(prod1);
+    ctr3 = static_cast<std::uint32_t>(prod0);
+    ctr0 = new0;
+    ctr2 = new2;
 }
 
-static inline fp64_t chameleon_randn(unsigned long long &seed, fp64_t mean,
-        fp64_t stddev)
+//! Philox4x32-10 counter-based generator
+/*! Encrypts a 128-bit counter (ctr0, ctr1, ctr2, ctr3) with a 64-bit key.
+ * Every element of the underlying array uses its linear offset as a counter
+ * and the seed as a key, so any part of the array is generated independently
+ * of other parts. Rounds are written out explicitly, as a loop over them
+ * prevents vectorization of the outer loop.
+ * */
+static NNTILE_SIMD_INLINE void philox(std::uint32_t &ctr0,
+        std::uint32_t &ctr1, std::uint32_t &ctr2, std::uint32_t &ctr3,
+        std::uint32_t key0, std::uint32_t key1)
+    noexcept
 {
-    constexpr fp64_t two=2.0, twopi=6.2831853071795864769252867663;
-    fp64_t t1 = CORE_dlaran(&seed);
-    fp64_t t2 = CORE_dlaran(&seed) * twopi;
-    fp64_t t3 = std::sqrt(-two*std::log(t1)) * std::cos(t2);
-    return stddev*t3 + mean;
+    constexpr std::uint32_t weyl0 = 0x9E3779B9, weyl1 = 0xBB67AE85;
+    philox_round(ctr0, ctr1, ctr2, ctr3, key0, key1);
+    philox_round(ctr0, ctr1, ctr2, ctr3, key0+weyl0, key1+weyl1);
+    philox_round(ctr0, ctr1, ctr2, ctr3, key0+2*weyl0, key1+2*weyl1);
+    philox_round(ctr0, ctr1, ctr2, ctr3, key0+3*weyl0, key1+3*weyl1);
+    philox_round(ctr0, ctr1, ctr2, ctr3, key0+4*weyl0, key1+4*weyl1);
+    philox_round(ctr0, ctr1, ctr2, ctr3, key0+5*weyl0, key1+5*weyl1);
+    philox_round(ctr0, ctr1, ctr2, ctr3, key0+6*weyl0, key1+6*weyl1);
+    philox_round(ctr0, ctr1, ctr2, ctr3, key0+7*weyl0, key1+7*weyl1);
+    philox_round(ctr0, ctr1, ctr2, ctr3, key0+8*weyl0, key1+8*weyl1);
+    philox_round(ctr0, ctr1, ctr2, ctr3, key0+9*weyl0, key1+9*weyl1);
 }
 
+//! Uniform numbers in (0,1] and [0,1) from random bits
+static NNTILE_SIMD_INLINE void uniform(std::uint32_t x0, std::uint32_t x1,
+        std::uint32_t x2, std::uint32_t x3, fp32_t &u1, fp32_t &u2)
+    noexcept
+{
+    constexpr fp32_t scale = 1.0f / 16777216.0f; // 2^-24
+    u1 = static_cast<fp32_t>(static_cast<std::int32_t>((x0>>8)+1)) * scale;
+    u2 = static_cast<fp32_t>(static_cast<std::int32_t>(x1>>8)) * scale;
+}
+
+static NNTILE_SIMD_INLINE void uniform(std::uint32_t x0, std::uint32_t x1,
+        std::uint32_t x2, std::uint32_t x3, fp64_t &u1, fp64_t &u2)
+    noexcept
+{
+    constexpr fp64_t scale = 1.0 / 9007199254740992.0; // 2^-53
+    std::uint64_t y1 = ((static_cast<std::uint64_t>(x0)<<32) | x1) >> 11;
+    std::uint64_t y2 = ((static_cast<std::uint64_t>(x2)<<32) | x3) >> 11;
+    u1 = static_cast<fp64_t>(static_cast<std::int64_t>(y1+1)) * scale;
+    u2 = static_cast<fp64_t>(static_cast<std::int64_t>(y2)) * scale;
+}
+
+//! Generate up to block_size normal numbers for consecutive offsets
+/*! Box-Muller transform of two uniform numbers, produced by Philox from the
+ * offset of an element within the underlying array. */
 template<typename T>
+static NNTILE_SIMD_INLINE void generate_block(unsigned long long seed,
+        Index offset, Index n, T mean, T stddev, T *block)
+    noexcept
+{
+    constexpr T minus_two = -2.0;
+    std::uint32_t key0 = static_cast<std::uint32_t>(seed),
+        key1 = static_cast<std::uint32_t>(seed>>32);
+    NNTILE_SIMD
+    for(Index i = 0; i < n; ++i)
+    {
+        std::uint64_t counter = offset + i;
+        std::uint32_t x0 = static_cast<std::uint32_t>(counter),
+            x1 = static_cast<std::uint32_t>(counter>>32), x2 = 0, x3 = 0;
+        philox(x0, x1, x2, x3, key0, key1);
+        T u1, u2;
+        uniform(x0, x1, x2, x3, u1, u2);
+        T radius = std::sqrt(minus_two*simd::log(u1));
+        block[i] = stddev*radius*simd::cos_2pi(u2) + mean;
+    }
+}
+
+//! Generate normal numbers for a contiguous range of offsets
+template<typename T>
+static NNTILE_SIMD_INLINE void generate(unsigned long long seed,
+        Index offset, Index nelems, T mean, T stddev, T *data, Index stride)
+    noexcept
+{
+    T block[block_size];
+    for(Index i = 0; i < nelems; i += block_size)
+    {
+        Index n = std::min(block_size, nelems-i);
+        generate_block<T>(seed, offset+i, n, mean, stddev, block);
+        for(Index j = 0; j < n; ++j)
+        {
+            data[(i+j)*stride] = block[j];
+        }
+    }
+}
+
+template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index ndim, Index nelems, unsigned long long seed,
         T mean, T stddev, const Index *start, const Index *shape,
         const Index *underlying_shape, T *data, const Index *stride,
@@ -64,6 +157,11 @@ void cpu(Index ndim, Index nelems, unsigned long long seed,
  * underlying array was at first generated with a provided seed and then copied
  * output=underlying[start:start+shape].
  *
+ * Each element is produced by a Philox4x32-10 counter-based generator from
+ * its linear offset within the underlying array, followed by the Box-Muller
+ * transform. Therefore, the elements are generated by vectorized blocks and
+ * any part of the output can be generated by a separate thread.
+ *
  * @param[in] ndim: Number of dimensions of the output array
  * @param[in] nelems: Number of elements of the output array
  * @param[in] seed: Random seed for the entire underlying array
@@ -80,21 +178,16 @@ void cpu(Index ndim, Index nelems, unsigned long long seed,
  *      ndim values.
  * */
 {
-    // Jump to the first element to generate
-    Index shift = start[ndim-1];
+    // Offset of the first element to generate within the underlying array
+    Index offset = start[ndim-1];
     for(Index i = ndim-2; i >= 0; --i)
     {
-        shift = start[i] + shift*underlying_shape[i];
+        offset = start[i] + offset*underlying_shape[i];
     }
-    seed = CORE_rnd64_jump(shift, seed);
     // View tile as a matrix of shape (shape[0], prod(shape[1:ndim]))
     Index nrows = shape[0], ncols = nelems / nrows;
     // Generate the first column
-    for(Index i = 0; i < nrows; ++i)
-    {
-        *data = chameleon_randn(seed, mean, stddev);
-        data += stride[0];
-    }
+    generate<T>(seed, offset, nrows, mean, stddev, data, stride[0]);
     // Init temporary index
     for(Index i = 0; i < ndim; ++i)
     {
@@ -104,16 +197,17 @@ void cpu(Index ndim, Index nelems, unsigned long long seed,
     for(Index j = 1; j < ncols; ++j)
     {
         // Get index of the first element of the current column as well as a
-        // shift to it from the last generated element. Init the index by
-        // incrementing it properly (ignore 0 dimension, as it is a row index).
+        // shift to it from the first element of the previous column. Init the
+        // index by incrementing it properly (ignore 0 dimension, as it is a
+        // row index).
         ++tmp_index[1];
         Index k = 1;
         // Init shift
-        Index shift = underlying_shape[0] - nrows;
+        Index shift = underlying_shape[0];
         // Init stride for the current dimension
         Index underlying_stride = underlying_shape[0];
         // Update pointer to the current buffer element
-        data += stride[1] - stride[0]*nrows;
+        data += stride[1];
         // Check if currently stored index is out-of-bounds
         while(tmp_index[k] == shape[k])
         {
@@ -130,14 +224,9 @@ void cpu(Index ndim, Index nelems, unsigned long long seed,
             data += stride[k] - stride[k-1]*shape[k-1];
         }
         // Now both the index of the first element of the current column and
-        // the shift are ready. At first jump random generator shift times.
-        seed = CORE_rnd64_jump(shift, seed);
-        // Generate the current column
-        for(Index i = 0; i < nrows; ++i)
-        {
-            *data = chameleon_randn(seed, mean, stddev);
-            data += stride[0];
-        }
+        // the shift are ready. Generate the current column.
+        offset += shift;
+        generate<T>(seed, offset, nrows, mean, stddev, data, stride[0]);
     }
 }
 
@@ -157,11 +246,12 @@ void cpu<fp64_t>(Index ndim, Index nelems, unsigned long long seed,
     noexcept;
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu_ndim0(unsigned long long seed, T mean, T stddev, T *data)
     noexcept
 {
     // 0-dimensional tensor is just a scalar
-    *data = chameleon_randn(seed, mean, stddev);
+    generate<T>(seed, 0, 1, mean, stddev, data, 1);
 }
 
 // Explicit instantiation
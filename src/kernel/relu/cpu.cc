@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/relu/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 #include <cmath>
 
 namespace nntile
@@ -23,6 +24,7 @@ namespace relu
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index nelems, T *data)
     noexcept
 //! Inplace ReLU operation on CPU
@@ -33,11 +35,14 @@ void cpu(Index nelems, T *data)
  * @params[inout] data: Buffer to apply ReLU
  * */
 {
-    constexpr T zero = 0;;
+    constexpr T zero = 0;
+    // Comparison instead of std::fmax() keeps the loop vectorizable and maps
+    // NaN to zero exactly as std::fmax() does
+    NNTILE_SIMD
     for(Index i = 0; i < nelems; ++i)
     {
         T z = data[i];
-        data[i] = std::fmax(z, zero);
+        data[i] = (z > zero) ? z : zero;
     }
 }
 
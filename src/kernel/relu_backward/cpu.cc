@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/relu_backward/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 #include <cmath>
 
 namespace nntile
@@ -23,6 +24,7 @@ namespace relu_backward
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index nelems, const T *x, const T *dy, T *dx)
     noexcept
 //! Backward ReLU operation on CPU
@@ -36,6 +38,7 @@ void cpu(Index nelems, const T *x, const T *dy, T *dx)
  * */
 {
     constexpr T zero = 0;
+    NNTILE_SIMD
     for(Index i = 0; i < nelems; ++i)
     {
         if(x[i] > zero)
@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/kernel/scal/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 
 namespace nntile
 {
@@ -22,6 +23,7 @@ namespace scal
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index nelems, T alpha, const T* src, T* dst)
     noexcept
 //! Set one buffer as a scaled version of another
@@ -35,6 +37,7 @@ void cpu(Index nelems, T alpha, const T* src, T* dst)
  *      ignored, its content is overwritten on exit.
  * */
 {
+    NNTILE_SIMD
     for(Index i = 0; i < nelems; ++i)
     {
         dst[i] = alpha * src[i];
@@ -50,6 +53,10 @@ template
 void cpu<fp64_t>(Index nelems, fp64_t alpha, const fp64_t* src, fp64_t* dst)
     noexcept;
 
+template
+void cpu<bf16_t>(Index nelems, bf16_t alpha, const bf16_t* src, bf16_t* dst)
+    noexcept;
+
 } // namespace scal
 } // namespace kernel
 } // namespace nntile
@@ -38,8 +38,9 @@ void cpu(Index m, Index n, Index k, const T *maxsumexp, const T *src, T alpha,
  * @param[out] dst: Contiguous output array
  * */
 {
+    using Y = compute_t<T>;
     Index src_dst_offset = 0;
-    constexpr T zero = 0.0;
+    constexpr Y zero = 0.0;
     // Outer loop by the last mode of dst and sumnorm arrays
     for(Index i2 = 0; i2 < n; ++i2)
     {
@@ -51,14 +52,14 @@ void cpu(Index m, Index n, Index k, const T *maxsumexp, const T *src, T alpha,
             for(Index i0 = 0; i0 < m; ++i0)
             {
                 // Value-to-update
-                T val = src[src_dst_offset];
+                Y val = src[src_dst_offset];
                 // Max and sum of exponents
-                const T max = maxsumexp[maxsumexp_offset];
-                const T sum = maxsumexp[maxsumexp_offset+1];
+                const Y max = maxsumexp[maxsumexp_offset];
+                const Y sum = maxsumexp[maxsumexp_offset+1];
                 // Update value
                 if(not std::isinf(val))
                 {
-                    dst[src_dst_offset] = alpha * std::exp(val-max) / sum;
+                    dst[src_dst_offset] = Y{alpha} * std::exp(val-max) / sum;
                 }
                 else
                 {
@@ -83,6 +84,11 @@ void cpu<fp64_t>(Index m, Index n, Index k, const fp64_t *maxsumexp,
         const fp64_t *src, fp64_t alpha, fp64_t *dst)
     noexcept;
 
+template
+void cpu<bf16_t>(Index m, Index n, Index k, const bf16_t *maxsumexp,
+        const bf16_t *src, bf16_t alpha, bf16_t *dst)
+    noexcept;
+
 } // namespace softmax
 } // namespace kernel
 } // namespace nntile
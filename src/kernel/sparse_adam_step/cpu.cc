@@ -0,0 +1,136 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/kernel/sparse_adam_step/cpu.cc
+ * Lazy Adam step over marked rows of a matrix on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/kernel/sparse_adam_step/cpu.hh"
+#include <cmath>
+
+namespace nntile
+{
+namespace kernel
+{
+namespace sparse_adam_step
+{
+
+template<typename T>
+void cpu(Index m, Index n, T beta_1, T beta_2, T eps, T lr, T weight_decay,
+        int decoupled, const bool_t *rows, Index *row_step, const T *grad,
+        T *first_moment, T *second_moment, T *p)
+    noexcept
+//! Lazy Adam step over marked rows of a matrix on CPU
+/*!
+ * A row of a table of embeddings is a contiguous column of the matrix, as
+ * the matrix is stored in Fortran order. Only rows, marked as touched by the
+ * sparse gradient, are updated. Moments of other rows are not decayed and
+ * their step counters stay the same, so bias correction of a row uses the
+ * number of steps, that actually updated it. Update of a marked row j with
+ * t = row_step[j]+1 mirrors the dense Adam step:
+ *      g = grad[:,j] + (decoupled ? 0 : weight_decay*p[:,j]),
+ *      p[:,j] *= (decoupled ? 1-lr*weight_decay : 1),
+ *      first_moment[:,j] = beta_1*first_moment[:,j] + (1-beta_1)*g,
+ *      second_moment[:,j] = hypot(sqrt(beta_2)*second_moment[:,j],
+ *              sqrt(1-beta_2)*g),
+ *      p[:,j] -= lr/(1-beta_1^t) * first_moment[:,j]
+ *              / (second_moment[:,j]/sqrt(1-beta_2^t)+eps),
+ *      row_step[j] = t,
+ * where moments are assumed zero for t=1. Square root of the second moment
+ * is stored as in the dense Adam step.
+ *
+ * @param[in] m: Size of every row
+ * @param[in] n: Number of rows
+ * @param[in] beta_1: parameter for moving average of first moments
+ * @param[in] beta_2: parameter for moving average of second moments
+ * @param[in] eps: small scalar to avoid division by zero
+ * @param[in] lr: learning rate
+ * @param[in] weight_decay: coefficient for weight decay
+ * @param[in] decoupled: Whether weight decay is decoupled as in AdamW
+ * @param[in] rows: Marks of touched rows
+ * @param[inout] row_step: Numbers of steps, that updated each row
+ * @param[in] grad: Gradient, which is zero outside of marked rows
+ * @param[inout] first_moment: First moments
+ * @param[inout] second_moment: Square roots of second moments
+ * @param[inout] p: Parameters
+ * */
+{
+    const T sqrt_beta_2 = std::sqrt(beta_2);
+    const T sqrt_1_beta_2 = std::sqrt(1-beta_2);
+    T p_scale = 1;
+    if(decoupled != 0)
+    {
+        p_scale = 1 - lr*weight_decay;
+    }
+    for(Index j = 0; j < n; ++j)
+    {
+        if(not rows[j])
+        {
+            continue;
+        }
+        Index step = row_step[j] + 1;
+        row_step[j] = step;
+        T alpha = lr / (1 - std::pow(beta_1, step));
+        T beta = 1 / std::sqrt(1 - std::pow(beta_2, step));
+        const T *grad_row = grad + j*m;
+        T *first_row = first_moment + j*m, *second_row = second_moment + j*m;
+        T *p_row = p + j*m;
+        for(Index i = 0; i < m; ++i)
+        {
+            T p_val = p_row[i], grad_val = grad_row[i];
+            if(weight_decay != 0)
+            {
+                if(decoupled != 0)
+                {
+                    p_val *= p_scale;
+                }
+                else
+                {
+                    grad_val += weight_decay * p_val;
+                }
+            }
+            T f_val, s_val;
+            if(step == 1)
+            {
+                f_val = (1-beta_1) * grad_val;
+                s_val = sqrt_1_beta_2 * std::fabs(grad_val);
+            }
+            else
+            {
+                f_val = beta_1*first_row[i] + (1-beta_1)*grad_val;
+                s_val = std::hypot(sqrt_beta_2*second_row[i],
+                        sqrt_1_beta_2*grad_val);
+            }
+            first_row[i] = f_val;
+            second_row[i] = s_val;
+            p_row[i] = p_val - alpha*f_val/(s_val*beta+eps);
+        }
+    }
+}
+
+// Explicit instantiation
+template
+void cpu<fp32_t>(Index m, Index n, fp32_t beta_1, fp32_t beta_2, fp32_t eps,
+        fp32_t lr, fp32_t weight_decay, int decoupled, const bool_t *rows,
+        Index *row_step, const fp32_t *grad, fp32_t *first_moment,
+        fp32_t *second_moment, fp32_t *p)
+    noexcept;
+
+template
+void cpu<fp64_t>(Index m, Index n, fp64_t beta_1, fp64_t beta_2, fp64_t eps,
+        fp64_t lr, fp64_t weight_decay, int decoupled, const bool_t *rows,
+        Index *row_step, const fp64_t *grad, fp64_t *first_moment,
+        fp64_t *second_moment, fp64_t *p)
+    noexcept;
+
+} // namespace sparse_adam_step
+} // namespace kernel
+} // namespace nntile
+
@@ -14,6 +14,7 @@
  * */
 
 #include "nntile/kernel/sqrt/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 #include <cmath>
 
 namespace nntile
@@ -24,6 +25,7 @@ namespace sqrt
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index nelems, const T *src, T *dst)
     noexcept
 //! Sqrt operation on CPU
@@ -33,6 +35,7 @@ void cpu(Index nelems, const T *src, T *dst)
  * @params[out] dst: Output buffer to apply sqrt
  * */
 {
+    NNTILE_SIMD
     for(Index i = 0; i < nelems; ++i)
     {
         dst[i] = std::sqrt(src[i]);
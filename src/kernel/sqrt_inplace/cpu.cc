@@ -14,6 +14,7 @@
  * */
 
 #include "nntile/kernel/sqrt_inplace/cpu.hh"
+#include "nntile/kernel/cpu_simd.hh"
 #include <cmath>
 
 namespace nntile
@@ -24,6 +25,7 @@ namespace sqrt_inplace
 {
 
 template<typename T>
+NNTILE_CPU_DISPATCH
 void cpu(Index nelems, T *data)
     noexcept
 //! Inplace sqrt operation on CPU
@@ -32,6 +34,7 @@ void cpu(Index nelems, T *data)
  * @params[inout] data: Buffer to apply sqrt
  * */
 {
+    NNTILE_SIMD
     for(Index i = 0; i < nelems; ++i)
     {
         data[i] = std::sqrt(data[i]);
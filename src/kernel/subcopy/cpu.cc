@@ -28,11 +28,11 @@ void cpu(Index ndim, const Index *src_start, const Index *src_stride,
         const Index *dst_stride, T *dst, Index *tmp_index)
     noexcept
 //! Complex copying of one multidimensional array into another
-/*! This function is not meant for a performant implementation, as its sole
- * purpose is an easy data redistribution. It helps, for example, in case of
+/*! This function is meant for data redistribution, for example, in case of
  * converting between a single contiguous array on a single node (e.g., a
  * Python numpy or torch array) and a distributed allocation on many nodes
- * (e.g., nntile data distribution).
+ * (e.g., nntile data distribution). Both arrays have unit stride along the
+ * first dimension, so the copy is done by contiguous runs along it.
  * A simple memory copy shall be treated with a help of starpu_data_cpy()
  * function.
  *
@@ -51,59 +51,63 @@ void cpu(Index ndim, const Index *src_start, const Index *src_stride,
  *      values.
  * */
 {
-    // Map temporary buffer into source index and destination index
-    Index *src_index = tmp_index;
-    Index *dst_index = tmp_index + ndim;
-    // Get number of elements to copy and init source and target indexes for
-    // the first element to copy
-    Index nelems = 1;
-    for(Index i = 0; i < ndim; ++i)
+    // Treat special case of a scalar
+    if(ndim == 0)
     {
-        nelems *= copy_shape[i];
-        src_index[i] = src_start[i];
-        dst_index[i] = dst_start[i];
+        dst[0] = src[0];
+        return;
+    }
+    // Get number of contiguous runs along the first dimension and init index
+    // of the current run relative to the start of copied subarray
+    Index *index = tmp_index;
+    Index nruns = 1;
+    for(Index i = 1; i < ndim; ++i)
+    {
+        nruns *= copy_shape[i];
+        index[i] = 0;
+    }
+    const Index run_size = copy_shape[0];
+    if(nruns == 0 or run_size == 0)
+    {
+        return;
     }
     // Get offsets for both source and target elements
     Index src_offset = src_start[0]; // src_stride[0] = 1
-    Index dst_offset = dst_start[0]; // src_stride[0] = 1
+    Index dst_offset = dst_start[0]; // dst_stride[0] = 1
     for(Index i = 1; i < ndim; ++i)
     {
         src_offset += src_start[i] * src_stride[i];
         dst_offset += dst_start[i] * dst_stride[i];
     }
-    // Copy source into destination
-    dst[dst_offset] = src[src_offset];
-    // Get source and target offsets for the next element to copy
-    ++src_offset;
-    ++dst_offset;
-    for(Index i = 1; i < nelems; ++i)
+    for(Index run = 0; run < nruns; ++run)
     {
-        // Update indexes of source and target positions
-        ++src_index[0];
-        ++dst_index[0];
-        // Get index and offset of the next source
-        Index j = 0;
-        while(src_index[j] == src_start[j]+copy_shape[j])
+        // Copy contiguous run
+        const T *src_run = src + src_offset;
+        T *dst_run = dst + dst_offset;
+        for(Index i = 0; i < run_size; ++i)
         {
-            src_index[j] = src_start[j];
-            ++j;
-            ++src_index[j];
-            src_offset += src_stride[j] - copy_shape[j-1]*src_stride[j-1];
+            dst_run[i] = src_run[i];
+        }
+        // Get out if it was the last run
+        if(run == nruns-1)
+        {
+            break;
         }
-        // Get index and offset of the next target
-        j = 0;
-        while(dst_index[j] == dst_start[j]+copy_shape[j])
+        // Get index and offsets of the next run
+        Index j = 1;
+        ++index[j];
+        src_offset += src_stride[j];
+        dst_offset += dst_stride[j];
+        while(index[j] == copy_shape[j])
         {
-            dst_index[j] = dst_start[j];
+            index[j] = 0;
+            src_offset -= copy_shape[j] * src_stride[j];
+            dst_offset -= copy_shape[j] * dst_stride[j];
             ++j;
-            ++dst_index[j];
-            dst_offset += dst_stride[j] - copy_shape[j-1]*dst_stride[j-1];
+            ++index[j];
+            src_offset += src_stride[j];
+            dst_offset += dst_stride[j];
         }
-        // Copy source into destination
-        dst[dst_offset] = src[src_offset];
-        // Update offsets for the next copy
-        ++src_offset;
-        ++dst_offset;
     }
 }
 
@@ -126,6 +130,12 @@ void cpu<fp64_t>(Index ndim, const Index *src_start, const Index *src_stride,
         const Index *dst_stride, fp64_t *dst, Index *tmp_index)
     noexcept;
 
+template
+void cpu<bf16_t>(Index ndim, const Index *src_start, const Index *src_stride,
+        const Index *copy_shape, const bf16_t *src, const Index *dst_start,
+        const Index *dst_stride, bf16_t *dst, Index *tmp_index)
+    noexcept;
+
 template
 void cpu<Index>(Index ndim, const Index *src_start, const Index *src_stride,
         const Index *copy_shape, const Index *src, const Index *dst_start,
@@ -138,6 +148,12 @@ void cpu<bool_t>(Index ndim, const Index *src_start, const Index *src_stride,
         const Index *dst_stride, bool_t *dst, Index *tmp_index)
     noexcept;
 
+template
+void cpu<int8_t>(Index ndim, const Index *src_start, const Index *src_stride,
+        const Index *copy_shape, const int8_t *src, const Index *dst_start,
+        const Index *dst_stride, int8_t *dst, Index *tmp_index)
+    noexcept;
+
 } // namespace subcopy
 } // namespace kernel
 } // namespace nntile
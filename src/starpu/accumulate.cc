@@ -56,7 +56,7 @@ void cuda(void *buffers[], void *cl_args)
 }
 #endif // NNTILE_USE_CUDA
 
-Codelet codelet_fp32, codelet_fp64;
+Codelet codelet_fp32, codelet_fp64, codelet_bf16;
 
 void init()
 {
@@ -88,18 +88,30 @@ void init()
             //STARPU_RW | STARPU_COMMUTE);
             STARPU_RW);
     codelet_fp64.modes[1] = STARPU_R;
+    codelet_bf16.init("nntile_accumulate_bf16",
+            nullptr,
+            {cpu<bf16_t>},
+            {}
+            );
+    codelet_bf16.nbuffers = 2;
+    codelet_bf16.modes[0] = static_cast<starpu_data_access_mode>(
+            //STARPU_RW | STARPU_COMMUTE);
+            STARPU_RW);
+    codelet_bf16.modes[1] = STARPU_R;
 }
 
 void restrict_where(uint32_t where)
 {
     codelet_fp32.restrict_where(where);
     codelet_fp64.restrict_where(where);
+    codelet_bf16.restrict_where(where);
 }
 
 void restore_where()
 {
     codelet_fp32.restore_where();
     codelet_fp64.restore_where();
+    codelet_bf16.restore_where();
 }
 
 template<typename T>
@@ -111,7 +123,7 @@ void submit(Handle src, Handle dst)
  * */
 {
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             //STARPU_RW|STARPU_COMMUTE, static_cast<starpu_data_handle_t>(dst),
             STARPU_RW, static_cast<starpu_data_handle_t>(dst),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
@@ -131,6 +143,9 @@ void submit<fp32_t>(Handle src, Handle dst);
 template
 void submit<fp64_t>(Handle src, Handle dst);
 
+template
+void submit<bf16_t>(Handle src, Handle dst);
+
 } // namespace accumulate
 } // namespace starpu
 } // namespace nntile
@@ -111,7 +111,7 @@ void submit(Handle src, Handle dst)
  * */
 {
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             //STARPU_RW|STARPU_COMMUTE, static_cast<starpu_data_handle_t>(dst),
             STARPU_RW, static_cast<starpu_data_handle_t>(dst),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
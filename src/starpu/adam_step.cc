@@ -106,7 +106,7 @@ void submit(Index num_iter, Index num_elems, T beta_1, T beta_2, T eps, T lr, T
             Handle grad, Handle first_moment, Handle second_moment, Handle p)
 {
     // Codelet arguments
-    args_t<T>* args = (args_t<T>*)std::malloc(sizeof(*args));
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
     args->num_iter = num_iter;
     args->num_elems = num_elems;
     args->beta_1 = beta_1;
@@ -125,18 +125,16 @@ void submit(Index num_iter, Index num_elems, T beta_1, T beta_2, T eps, T lr, T
     {
         moments_mode = STARPU_RW;
     }
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(grad),
             moments_mode, static_cast<starpu_data_handle_t>(first_moment),
             moments_mode, static_cast<starpu_data_handle_t>(second_moment),
             STARPU_RW, static_cast<starpu_data_handle_t>(p),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in adam_step task submission");
-    }
+    args_pool::check_submit(ret, args, "Error in adam_step task submission");
 }
 
 // Explicit instantiaion
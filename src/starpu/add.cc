@@ -76,7 +76,7 @@ uint32_t footprint(struct starpu_task *task)
     return hash;
 }
 
-Codelet codelet_fp32, codelet_fp64;
+Codelet codelet_fp32, codelet_fp64, codelet_bf16;
 
 void init()
 {
@@ -98,18 +98,25 @@ void init()
             {}
 #endif // NNTILE_USE_CUDA
             );
+    codelet_bf16.init("nntile_add_bf16",
+            footprint<bf16_t>,
+            {cpu<bf16_t>},
+            {}
+            );
 }
 
 void restrict_where(uint32_t where)
 {
     codelet_fp32.restrict_where(where);
     codelet_fp64.restrict_where(where);
+    codelet_bf16.restrict_where(where);
 }
 
 void restore_where()
 {
     codelet_fp32.restore_where();
     codelet_fp64.restore_where();
+    codelet_bf16.restore_where();
 }
 
 template<typename T>
@@ -120,7 +127,8 @@ void submit(Index nelems, T alpha, Handle src, T beta, Handle dst)
  * throws an std::runtime_error() exception.
  * */
 {
-    constexpr T zero = 0, one = 1;
+    using Y = compute_t<T>;
+    constexpr Y zero = 0, one = 1;
     // If beta is zero this function reduces to scal
     if(beta == zero)
     {
@@ -144,21 +152,19 @@ void submit(Index nelems, T alpha, Handle src, T beta, Handle dst)
         dst_mode = STARPU_RW;
     }
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
     args->nelems = nelems;
     args->alpha = alpha;
     args->beta = beta;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             dst_mode, static_cast<starpu_data_handle_t>(dst), 0);
             // STARPU_FLOPS, nflops);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in add task submission");
-    }
+    args_pool::check_submit(ret, args, "Error in add task submission");
 }
 
 // Explicit instantiation
@@ -170,6 +176,10 @@ template
 void submit<fp64_t>(Index nelems, fp64_t alpha, Handle src, fp64_t beta,
         Handle dst);
 
+template
+void submit<bf16_t>(Index nelems, bf16_t alpha, Handle src, bf16_t beta,
+        Handle dst);
+
 } // namespace add
 } // namespace starpu
 } // namespace nntile
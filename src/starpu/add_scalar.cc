@@ -116,20 +116,18 @@ void submit(Index num_elements, T alpha, T beta, Handle dst)
  * */
 {
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
     args->num_elements = num_elements;
     args->alpha = alpha;
     args->beta = beta;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
-            STARPU_CL_ARGS, args, sizeof(*args),
+    int ret = task_insert(codelet<T>(),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             STARPU_RW, static_cast<starpu_data_handle_t>(dst), 0);
             // STARPU_FLOPS, nflops);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in add_scalar task submission");
-    }
+    args_pool::check_submit(ret, args, "Error in add_scalar task submission");
 }
 
 // Explicit instantiation
@@ -103,24 +103,22 @@ template<typename T>
 void submit(T val, T eps, Index nelems, Handle nom, Handle denom, Handle src)
 {
     // Codelet arguments
-    args_t<T>* args = (args_t<T>*)std::malloc(sizeof(*args));
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
     args->val = val;
     args->eps = eps;
     args->nelems = nelems;
     //fp64_t nflops = 5 * nelems;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(nom),
             STARPU_R, static_cast<starpu_data_handle_t>(denom),
             STARPU_RW, static_cast<starpu_data_handle_t>(src),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             //STARPU_FLOPS, nflops,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in addcdiv task submission");
-    }
+    args_pool::check_submit(ret, args, "Error in addcdiv task submission");
 }
 
 // Explicit instantiaion
@@ -0,0 +1,148 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/amp_unscale.cc
+ * Unscale gradients and check them for infinite and NaN values on StarPU
+ * buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-19
+ * */
+
+#include "nntile/starpu/amp_unscale.hh"
+#include "nntile/kernel/amp_unscale.hh"
+
+namespace nntile
+{
+namespace starpu
+{
+namespace amp_unscale
+{
+
+//! Unscale StarPU buffer and check it for inf and NaN values on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    T *data = interfaces[0]->get_ptr<T>();
+    bool_t *nonfinite = interfaces[1]->get_ptr<bool_t>();
+    // Launch kernel
+    kernel::amp_unscale::cpu<T>(args->nelems, args->inv_scale, data,
+            nonfinite);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Unscale StarPU buffer and check it for inf and NaN values on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    T *data = interfaces[0]->get_ptr<T>();
+    bool_t *nonfinite = interfaces[1]->get_ptr<bool_t>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::amp_unscale::cuda<T>(stream, args->nelems, args->inv_scale, data,
+            nonfinite);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for amp_unscale tasks
+template<typename T>
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(task->cl_arg);
+    // Apply hash over parameter nelems
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->nelems, sizeof(args->nelems), hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_amp_unscale_fp32",
+            footprint<fp32_t>,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_amp_unscale_fp64",
+            footprint<fp64_t>,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index nelems, T inv_scale, Handle data, Handle nonfinite)
+//! Insert amp_unscale task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception. The flag is only set by tasks,
+ * so tasks on different buffers sharing the same flag commute.
+ * */
+{
+    // Codelet arguments
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
+    args->nelems = nelems;
+    args->inv_scale = inv_scale;
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_RW, static_cast<starpu_data_handle_t>(data),
+            Config::STARPU_RW_COMMUTE,
+            static_cast<starpu_data_handle_t>(nonfinite),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
+            0);
+    // Check submission
+    args_pool::check_submit(ret, args, "Error in amp_unscale task submission");
+}
+
+// Explicit instantiaion
+template
+void submit<fp32_t>(Index nelems, fp32_t inv_scale, Handle data,
+        Handle nonfinite);
+
+template
+void submit<fp64_t>(Index nelems, fp64_t inv_scale, Handle data,
+        Handle nonfinite);
+
+} // namespace amp_unscale
+} // namespace starpu
+} // namespace nntile
+
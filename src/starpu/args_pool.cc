@@ -0,0 +1,259 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/args_pool.cc
+ * Pooled allocation of codelet arguments
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-07
+ * */
+
+#include "nntile/starpu/args_pool.hh"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace args_pool
+{
+
+namespace
+{
+
+struct Pool;
+
+// Every block starts with a header, that tells where to return it. While the
+// block is free, its payload keeps a pointer to the next free block.
+struct Block
+{
+    Pool *owner;
+    std::size_t size_class;
+    Block *next;
+};
+
+// Header is padded to keep payload aligned for any scalar type
+constexpr std::size_t header_size = alignof(std::max_align_t);
+static_assert(offsetof(Block, next) >= header_size,
+        "Header of a block overlaps its payload");
+
+// Sizes of blocks including headers. Larger arguments fall back to
+// std::malloc, they are only packed coordinates of high-dimensional tiles.
+constexpr int nclasses = 4;
+constexpr std::size_t class_size[nclasses] = {64, 128, 256, 512};
+// Blocks are multiples of cache line to avoid false sharing between tasks
+constexpr std::size_t cache_line = 64;
+// Number of blocks allocated by a pool at once
+constexpr std::size_t chunk_blocks = 64;
+
+struct Pool
+{
+    // Free blocks, accessed only by the owning thread
+    Block *local[nclasses] = {};
+    // Blocks returned by other threads, a lock-free stack. Other threads only
+    // push, while the owning thread takes the entire stack at once, so the
+    // stack does not suffer from the ABA problem.
+    std::atomic<Block *> remote[nclasses] = {};
+    // Memory of all the blocks of the pool
+    std::vector<void *> chunks;
+    // Cut a new chunk into free blocks
+    Block *refill(int size_class)
+    {
+        const std::size_t size = class_size[size_class];
+        char *chunk = static_cast<char *>(std::aligned_alloc(cache_line,
+                    size*chunk_blocks));
+        if(chunk == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        chunks.push_back(chunk);
+        Block *head = nullptr;
+        for(std::size_t i = chunk_blocks; i > 0; --i)
+        {
+            Block *block = reinterpret_cast<Block *>(chunk + (i-1)*size);
+            block->owner = this;
+            block->size_class = size_class;
+            block->next = head;
+            head = block;
+        }
+        return head;
+    }
+};
+
+// Pools are never destroyed, as callbacks of tasks may return blocks after
+// the submitting thread is gone. Pools of finished threads are handed over
+// to new threads instead.
+class Registry
+{
+    std::mutex mutex;
+    std::vector<Pool *> unused;
+public:
+    Pool *acquire()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(unused.empty())
+        {
+            return new Pool;
+        }
+        Pool *pool = unused.back();
+        unused.pop_back();
+        return pool;
+    }
+    void put(Pool *pool)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        unused.push_back(pool);
+    }
+};
+
+Registry &registry()
+{
+    // Intentionally leaked to outlive threads, that exit after main()
+    static Registry *instance = new Registry;
+    return *instance;
+}
+
+// Pool of the current thread, that is handed over to the registry at exit
+struct ThreadPool
+{
+    Pool *pool = nullptr;
+    ~ThreadPool()
+    {
+        if(pool != nullptr)
+        {
+            registry().put(pool);
+        }
+    }
+};
+
+thread_local ThreadPool thread_pool;
+
+Pool &get_pool()
+{
+    if(thread_pool.pool == nullptr)
+    {
+        thread_pool.pool = registry().acquire();
+    }
+    return *thread_pool.pool;
+}
+
+} // namespace
+
+void *alloc(std::size_t size)
+{
+    // Find size class
+    int size_class = 0;
+    while(size_class < nclasses
+            and class_size[size_class]-header_size < size)
+    {
+        ++size_class;
+    }
+    // Large arguments are not pooled
+    if(size_class == nclasses)
+    {
+        Block *block = static_cast<Block *>(std::malloc(header_size+size));
+        if(block == nullptr)
+        {
+            throw std::bad_alloc();
+        }
+        block->owner = nullptr;
+        return reinterpret_cast<char *>(block) + header_size;
+    }
+    // Take a free block from the pool, then from the blocks returned by other
+    // threads and only then allocate new ones
+    Pool &pool = get_pool();
+    Block *block = pool.local[size_class];
+    if(block == nullptr)
+    {
+        block = pool.remote[size_class].exchange(nullptr,
+                std::memory_order_acquire);
+        if(block == nullptr)
+        {
+            block = pool.refill(size_class);
+        }
+    }
+    pool.local[size_class] = block->next;
+    return reinterpret_cast<char *>(block) + header_size;
+}
+
+void release(void *ptr)
+    noexcept
+{
+    if(ptr == nullptr)
+    {
+        return;
+    }
+    Block *block = reinterpret_cast<Block *>(static_cast<char *>(ptr)
+            - header_size);
+    Pool *owner = block->owner;
+    if(owner == nullptr)
+    {
+        std::free(block);
+        return;
+    }
+    const std::size_t size_class = block->size_class;
+    // No synchronization is needed within the owning thread
+    if(owner == thread_pool.pool)
+    {
+        block->next = owner->local[size_class];
+        owner->local[size_class] = block;
+        return;
+    }
+    // Push to the lock-free stack of the owner
+    Block *head = owner->remote[size_class].load(std::memory_order_relaxed);
+    do
+    {
+        block->next = head;
+    } while(not owner->remote[size_class].compare_exchange_weak(head, block,
+                std::memory_order_release, std::memory_order_relaxed));
+}
+
+void check_submit(int ret, void *args, const char *msg)
+{
+    if(ret != 0)
+    {
+        release(args);
+        throw std::runtime_error(msg);
+    }
+}
+
+void *pack(std::initializer_list<std::pair<const void *, std::size_t>> args,
+        std::size_t &size)
+{
+    // Layout: number of arguments, followed by size and data of each argument
+    size = sizeof(int);
+    for(const auto &arg: args)
+    {
+        size += sizeof(std::size_t) + arg.second;
+    }
+    char *buffer = static_cast<char *>(alloc(size));
+    int nargs = args.size();
+    std::memcpy(buffer, &nargs, sizeof(nargs));
+    char *ptr = buffer + sizeof(nargs);
+    for(const auto &arg: args)
+    {
+        std::memcpy(ptr, &arg.second, sizeof(arg.second));
+        ptr += sizeof(arg.second);
+        // Empty arguments (e.g., shape of a scalar) may have no data pointer
+        if(arg.second > 0)
+        {
+            std::memcpy(ptr, arg.first, arg.second);
+            ptr += arg.second;
+        }
+    }
+    return buffer;
+}
+
+} // namespace args_pool
+} // namespace starpu
+} // namespace nntile
+
@@ -88,7 +88,7 @@ void restore_where()
 void submit(Handle data)
 {
     // Submit task
-    int ret = starpu_task_insert(&codelet,
+    int ret = task_insert(&codelet,
             STARPU_W, static_cast<starpu_data_handle_t>(data),
             0);
     // Check submission
@@ -0,0 +1,142 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/clear_rows.cc
+ * Clear marked rows of a matrix on StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/starpu/clear_rows.hh"
+#include "nntile/kernel/clear_rows.hh"
+
+namespace nntile
+{
+namespace starpu
+{
+namespace clear_rows
+{
+
+//! Clear marked rows of StarPU buffer on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const bool_t *rows = interfaces[0]->get_ptr<bool_t>();
+    T *dst = interfaces[1]->get_ptr<T>();
+    // Launch kernel
+    kernel::clear_rows::cpu<T>(args->m, args->n, rows, dst);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Clear marked rows of StarPU buffer on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const bool_t *rows = interfaces[0]->get_ptr<bool_t>();
+    T *dst = interfaces[1]->get_ptr<T>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::clear_rows::cuda<T>(stream, args->m, args->n, rows, dst);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for clear_rows tasks
+template<typename T>
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t *>(task->cl_arg);
+    // Apply hash over parameters m and n
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->m, sizeof(args->m), hash);
+    hash = starpu_hash_crc32c_be_n(&args->n, sizeof(args->n), hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_clear_rows_fp32",
+            footprint<fp32_t>,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_clear_rows_fp64",
+            footprint<fp64_t>,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index m, Index n, Handle rows, Handle dst)
+//! Insert clear_rows task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Codelet arguments
+    args_t *args = args_pool::alloc<args_t>();
+    args->m = m;
+    args->n = n;
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(rows),
+            STARPU_RW, static_cast<starpu_data_handle_t>(dst),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
+            0);
+    // Check submission
+    args_pool::check_submit(ret, args, "Error in clear_rows task submission");
+}
+
+// Explicit instantiaion
+template
+void submit<fp32_t>(Index m, Index n, Handle rows, Handle dst);
+
+template
+void submit<fp64_t>(Index m, Index n, Handle rows, Handle dst);
+
+} // namespace clear_rows
+} // namespace starpu
+} // namespace nntile
+
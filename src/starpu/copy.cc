@@ -88,7 +88,7 @@ void submit(Handle src, Handle dst)
  * */
 {
     // Submit task
-    int ret = starpu_task_insert(&codelet,
+    int ret = task_insert(&codelet,
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_W, static_cast<starpu_data_handle_t>(dst),
             0);
@@ -0,0 +1,175 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/cross_entropy_fwd_bwd.cc
+ * Fused cross entropy loss and its gradient on StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/starpu/cross_entropy_fwd_bwd.hh"
+#include "nntile/kernel/cross_entropy_fwd_bwd.hh"
+
+namespace nntile
+{
+namespace starpu
+{
+namespace cross_entropy_fwd_bwd
+{
+
+//! Cross entropy loss and its gradient over StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *maxsumexp = interfaces[0]->get_ptr<T>();
+    const T *src = interfaces[1]->get_ptr<T>();
+    const Index *labels = interfaces[2]->get_ptr<Index>();
+    T *grad = interfaces[3]->get_ptr<T>();
+    T *val = interfaces[4]->get_ptr<T>();
+    // Launch kernel
+    kernel::cross_entropy_fwd_bwd::cpu<T>(args->m, args->n, args->m_start,
+            args->scale, args->grad_scale, maxsumexp, src, labels, grad, val);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Cross entropy loss and its gradient over StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *maxsumexp = interfaces[0]->get_ptr<T>();
+    const T *src = interfaces[1]->get_ptr<T>();
+    const Index *labels = interfaces[2]->get_ptr<Index>();
+    T *grad = interfaces[3]->get_ptr<T>();
+    T *val = interfaces[4]->get_ptr<T>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::cross_entropy_fwd_bwd::cuda<T>(stream, args->m, args->n,
+            args->m_start, args->scale, args->grad_scale, maxsumexp, src,
+            labels, grad, val);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for cross_entropy_fwd_bwd tasks
+template<typename T>
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(task->cl_arg);
+    // Apply hash over parameters m and n
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->m, sizeof(args->m), hash);
+    hash = starpu_hash_crc32c_be_n(&args->n, sizeof(args->n), hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_cross_entropy_fwd_bwd_fp32",
+            footprint<fp32_t>,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_cross_entropy_fwd_bwd_fp64",
+            footprint<fp64_t>,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index m, Index n, Index m_start, T scale, T grad_scale,
+        Handle maxsumexp, Handle src, Handle labels, Handle grad, Handle val,
+        int redux)
+//! Insert cross_entropy_fwd_bwd task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception. Tasks of different tiles of
+ * logits only add to the loss value, so they commute or use reduction.
+ * */
+{
+    // Codelet arguments
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
+    args->m = m;
+    args->n = n;
+    args->m_start = m_start;
+    args->scale = scale;
+    args->grad_scale = grad_scale;
+    // Access mode for the val handle
+    enum starpu_data_access_mode val_mode;
+    if(redux != 0)
+    {
+        val_mode = STARPU_REDUX;
+    }
+    else
+    {
+        val_mode = Config::STARPU_RW_COMMUTE;
+    }
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(maxsumexp),
+            STARPU_R, static_cast<starpu_data_handle_t>(src),
+            STARPU_R, static_cast<starpu_data_handle_t>(labels),
+            STARPU_W, static_cast<starpu_data_handle_t>(grad),
+            val_mode, static_cast<starpu_data_handle_t>(val),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
+            0);
+    // Check submission
+    args_pool::check_submit(ret, args,
+            "Error in cross_entropy_fwd_bwd task submission");
+}
+
+// Explicit instantiaion
+template
+void submit<fp32_t>(Index m, Index n, Index m_start, fp32_t scale,
+        fp32_t grad_scale, Handle maxsumexp, Handle src, Handle labels,
+        Handle grad, Handle val, int redux);
+
+template
+void submit<fp64_t>(Index m, Index n, Index m_start, fp64_t scale,
+        fp64_t grad_scale, Handle maxsumexp, Handle src, Handle labels,
+        Handle grad, Handle val, int redux);
+
+} // namespace cross_entropy_fwd_bwd
+} // namespace starpu
+} // namespace nntile
+
@@ -94,18 +94,16 @@ void restore_where()
 template<typename T>
 void submit(Index nelems, Handle data)
 {
-    Index *nelems_ = new Index{nelems};
+    Index *nelems_ = args_pool::alloc<Index>(nelems);
     //fp64_t nflops = 5 * nelems;
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_RW, static_cast<starpu_data_handle_t>(data),
-            STARPU_CL_ARGS, nelems_, sizeof(*nelems_),
+            STARPU_CL_ARGS_NFREE, nelems_, sizeof(*nelems_),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, nelems_,
             //STARPU_FLOPS, nflops,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in dgelu task submission");
-    }
+    args_pool::check_submit(ret, nelems_, "Error in dgelu task submission");
 }
 
 // Explicit instantiaion
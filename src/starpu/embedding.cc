@@ -75,7 +75,7 @@ uint32_t footprint(struct starpu_task *task)
     return hash;
 }
 
-Codelet codelet_fp32, codelet_fp64;
+Codelet codelet_fp32, codelet_fp64, codelet_bf16;
 
 void init()
 {
@@ -97,18 +97,25 @@ void init()
             {}
 #endif // NNTILE_USE_CUDA
             );
+    codelet_bf16.init("nntile_embedding_bf16",
+            footprint,
+            {cpu<bf16_t>},
+            {}
+            );
 }
 
 void restrict_where(uint32_t where)
 {
     codelet_fp32.restrict_where(where);
     codelet_fp64.restrict_where(where);
+    codelet_bf16.restrict_where(where);
 }
 
 void restore_where()
 {
     codelet_fp32.restore_where();
     codelet_fp64.restore_where();
+    codelet_bf16.restore_where();
 }
 
 template<typename T>
@@ -121,7 +128,7 @@ void submit(Index m, Index n, Index k, Index k_start, Index k_size,
  * */
 {
     // Codelet arguments
-    args_t *args = (args_t *)std::malloc(sizeof(*args));
+    args_t *args = args_pool::alloc<args_t>();
     args->m = m;
     args->n = n;
     args->k = k;
@@ -129,19 +136,17 @@ void submit(Index m, Index n, Index k, Index k_start, Index k_size,
     args->k_size = k_size;
     fp64_t nflops = m * n * k_size;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(index),
             STARPU_R, static_cast<starpu_data_handle_t>(vocab),
             STARPU_RW, static_cast<starpu_data_handle_t>(embed),
             //Config::STARPU_RW_COMMUTE, static_cast<starpu_data_handle_t>(embed),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             STARPU_FLOPS, nflops,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in embedding task submission");
-    }
+    args_pool::check_submit(ret, args, "Error in embedding task submission");
 }
 
 // Explicit instantiation
@@ -153,6 +158,10 @@ template
 void submit<fp64_t>(Index m, Index n, Index k, Index k_start, Index k_size,
         Handle index, Handle vocab, Handle embed);
 
+template
+void submit<bf16_t>(Index m, Index n, Index k, Index k_start, Index k_size,
+        Handle index, Handle vocab, Handle embed);
+
 } // namespace embedding
 } // namespace starpu
 } // namespace nntile
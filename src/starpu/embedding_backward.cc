@@ -121,7 +121,7 @@ void submit(Index m, Index n, Index k, Index k_start, Index k_size,
  * */
 {
     // Codelet arguments
-    args_t *args = (args_t *)std::malloc(sizeof(*args));
+    args_t *args = args_pool::alloc<args_t>();
     args->m = m;
     args->n = n;
     args->k = k;
@@ -140,19 +140,17 @@ void submit(Index m, Index n, Index k, Index k_start, Index k_size,
         vocab_mode = Config::STARPU_RW_COMMUTE;
     }
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(index),
             STARPU_R, static_cast<starpu_data_handle_t>(embed),
             vocab_mode, static_cast<starpu_data_handle_t>(vocab),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             STARPU_FLOPS, nflops,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in embedding_backward task "
-                "submission");
-    }
+    args_pool::check_submit(ret, args,
+            "Error in embedding_backward task submission");
 }
 
 // Explicit instantiation
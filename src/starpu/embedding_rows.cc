@@ -0,0 +1,105 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/embedding_rows.cc
+ * Mark rows of embeddings, that are touched by tokens, on StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/starpu/embedding_rows.hh"
+#include "nntile/kernel/embedding_rows.hh"
+
+namespace nntile
+{
+namespace starpu
+{
+namespace embedding_rows
+{
+
+//! Mark rows of embeddings on StarPU buffers on CPU
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    Index nelems = reinterpret_cast<Index *>(cl_args)[0];
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const Index *index = interfaces[0]->get_ptr<Index>();
+    bool_t *rows = interfaces[1]->get_ptr<bool_t>();
+    // Launch kernel
+    kernel::embedding_rows::cpu(nelems, index, rows);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Mark rows of embeddings on StarPU buffers on CUDA
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    Index nelems = reinterpret_cast<Index *>(cl_args)[0];
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const Index *index = interfaces[0]->get_ptr<Index>();
+    bool_t *rows = interfaces[1]->get_ptr<bool_t>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::embedding_rows::cuda(stream, nelems, index, rows);
+}
+#endif // NNTILE_USE_CUDA
+
+Codelet codelet;
+
+void init()
+{
+    codelet.init("nntile_embedding_rows",
+            nullptr,
+            {cpu},
+#ifdef NNTILE_USE_CUDA
+            {cuda}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet.restore_where();
+}
+
+void submit(Index nelems, Handle index, Handle rows)
+//! Insert embedding_rows task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception. Marks are only set by tasks, so
+ * tasks on different tiles of tokens commute.
+ * */
+{
+    Index *nelems_ = args_pool::alloc<Index>(nelems);
+    int ret = task_insert(&codelet,
+            STARPU_R, static_cast<starpu_data_handle_t>(index),
+            Config::STARPU_RW_COMMUTE, static_cast<starpu_data_handle_t>(rows),
+            STARPU_CL_ARGS_NFREE, nelems_, sizeof(*nelems_),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, nelems_,
+            0);
+    // Check submission
+    args_pool::check_submit(ret, nelems_,
+            "Error in embedding_rows task submission");
+}
+
+} // namespace embedding_rows
+} // namespace starpu
+} // namespace nntile
+
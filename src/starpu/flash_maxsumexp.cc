@@ -4,7 +4,7 @@
  * NNTile is software framework for fast training of big neural networks on
  * distributed-memory heterogeneous systems based on StarPU runtime system.
  *
- * @file src/starpu/flash_maxsumexp.cc.in
+ * @file src/starpu/flash_maxsumexp.cc
  * Fused materialization and maxsumexp for StarPU buffer
  *
  * @version 1.0.0
@@ -13,19 +13,13 @@
  * */
 
 #include "nntile/starpu/flash_maxsumexp.hh"
+#include "nntile/kernel/flash_maxsumexp.hh"
 #include "nntile/kernel/maxsumexp.hh"
 #include "nntile/kernel/mask_scalar.hh"
 #include <cstdlib>
 #include <cmath>
 #include <limits>
 
-#ifdef NNTILE_USE_CBLAS
-#   include <@CBLAS_H_NAME@>
-#   ifndef CBLAS_INT
-#       define CBLAS_INT @CBLAS_INT_TYPE@
-#   endif // CBLAS_INT
-#endif // NNTILE_USE_CBLAS
-
 #ifdef NNTILE_USE_CUDA
 #   include <cublas_v2.h>
 #   include <starpu_cublas_v2.h>
@@ -39,32 +33,7 @@ namespace starpu
 namespace flash_maxsumexp
 {
 
-#ifdef NNTILE_USE_CBLAS
-// Overloaded call to CBLAS GEMM
-static inline
-void cblas(CBLAS_TRANSPOSE transA, CBLAS_TRANSPOSE transB,
-        CBLAS_INT M, CBLAS_INT N, CBLAS_INT K, fp32_t alpha, const fp32_t *A,
-        CBLAS_INT ldA, const fp32_t *B, CBLAS_INT ldB, fp32_t beta, fp32_t *C,
-        CBLAS_INT ldC)
-    noexcept
-{
-    cblas_sgemm(CblasColMajor, transA, transB, M, N, K, alpha, A, ldA, B, ldB,
-            beta, C, ldC);
-}
-
-// Overloaded call to CBLAS GEMM
-static inline
-void cblas(CBLAS_TRANSPOSE transA, CBLAS_TRANSPOSE transB,
-        CBLAS_INT M, CBLAS_INT N, CBLAS_INT K, fp64_t alpha, const fp64_t *A,
-        CBLAS_INT ldA, const fp64_t *B, CBLAS_INT ldB, fp64_t beta, fp64_t *C,
-        CBLAS_INT ldC)
-    noexcept
-{
-    cblas_dgemm(CblasColMajor, transA, transB, M, N, K, alpha, A, ldA, B, ldB,
-            beta, C, ldC);
-}
-
-//! Rematerialize and compute maxsumexp along middle axis of StarPU buffer on CPU
+//! Max and sum of exponents of attention scores on CPU
 template<typename T>
 void cpu(void *buffers[], void *cl_args)
     noexcept
@@ -77,28 +46,10 @@ void cpu(void *buffers[], void *cl_args)
     const T *Q = interfaces[1]->get_ptr<T>();
     const bool_t *mask = interfaces[2]->get_ptr<bool_t>();
     T *maxsumexp = interfaces[3]->get_ptr<T>();
-    T *tmp = interfaces[4]->get_ptr<T>();
-    // Launch kernels
-    Index K_offset = args->head * args->seq;
-    Index Q_offset = K_offset;
-    Index tmp_offset = args->seq * args->seq;
-    const T *K_local = K, *Q_local = Q;
-    T *tmp_local = tmp;
-    for(Index i = 0; i < args->batch; ++i)
-    {
-        cblas(CblasTrans, CblasNoTrans, args->seq, args->seq, args->head,
-                1.0/std::sqrt(T(args->head)), K_local, args->head, Q_local,
-                args->head, 0.0, tmp_local, args->seq);
-        K_local += K_offset;
-        Q_local += Q_offset;
-        tmp_local += tmp_offset;
-    }
-    kernel::mask_scalar::cpu<T>(args->seq*args->seq, args->batch, mask,
-            -std::numeric_limits<T>::infinity(), tmp);
-    kernel::maxsumexp::cpu<T>(1, args->seq*args->batch, args->seq, tmp,
-            maxsumexp);
+    // Launch kernel
+    kernel::flash_maxsumexp::cpu<T>(args->seq, args->head, args->batch, K, Q,
+            mask, maxsumexp);
 }
-#endif // NNTILE_USE_CBLAS
 
 #ifdef NNTILE_USE_CUDA
 // Overloaded call to batched cuBLAS gemm
@@ -228,11 +179,7 @@ void init()
 {
     codelet_fp32.init("nntile_flash_maxsumexp_fp32",
             footprint,
-#ifdef NNTILE_USE_CBLAS
             {cpu<fp32_t>},
-#else // NNTILE_USE_CBLAS
-            {},
-#endif // NNTILE_USE_CBLAS
 #ifdef NNTILE_USE_CUDA
             {cuda<fp32_t>}
 #else // NNTILE_USE_CUDA
@@ -241,11 +188,7 @@ void init()
             );
     codelet_fp64.init("nntile_flash_maxsumexp_fp64",
             footprint,
-#ifdef NNTILE_USE_CBLAS
             {cpu<fp64_t>},
-#else // NNTILE_USE_CBLAS
-            {},
-#endif // NNTILE_USE_CBLAS
 #ifdef NNTILE_USE_CUDA
             {cuda<fp64_t>}
 #else // NNTILE_USE_CUDA
@@ -254,11 +197,7 @@ void init()
             );
     codelet_fp32_fast_tf32.init("nntile_flash_maxsumexp_fp32_fast_tf32",
             footprint,
-#ifdef NNTILE_USE_CBLAS
             {},
-#else // NNTILE_USE_CBLAS
-            {},
-#endif // NNTILE_USE_CBLAS
 #ifdef NNTILE_USE_CUDA
             {cuda_fp32_fast_tf32}
 #else // NNTILE_USE_CUDA
@@ -287,11 +226,13 @@ void submit(Index seq, Index head, Index batch, Handle K, Handle Q,
 //! Insert flash_maxsumexp task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
- * throws an std::runtime_error() exception.
+ * throws an std::runtime_error() exception. Scratch handle tmp is only used by
+ * CUDA implementation and can be empty, in which case the task is executed
+ * on CPU.
  * */
 {
     // Codelet arguments
-    args_t *args = (args_t *)std::malloc(sizeof(*args));
+    args_t *args = args_pool::alloc<args_t>();
     args->seq = seq;
     args->head = head;
     args->batch = batch;
@@ -313,20 +254,41 @@ void submit(Index seq, Index head, Index batch, Handle K, Handle Q,
         chosen_codelet = &codelet_fp32_fast_tf32;
     }
     fp64_t nflops = 2 * seq * seq * head * batch;
-    int ret = starpu_task_insert(chosen_codelet,
-            STARPU_R, static_cast<starpu_data_handle_t>(K),
-            STARPU_R, static_cast<starpu_data_handle_t>(Q),
-            STARPU_R, static_cast<starpu_data_handle_t>(mask),
-            maxsumexp_mode, static_cast<starpu_data_handle_t>(maxsumexp),
-            STARPU_SCRATCH, static_cast<starpu_data_handle_t>(tmp),
-            STARPU_CL_ARGS, args, sizeof(*args),
-            STARPU_FLOPS, nflops,
-            0);
-    // Check submission
-    if(ret != 0)
+    // CPU implementation rematerializes scores by small blocks and does not
+    // need scratch buffers. If the task can not be executed by a CUDA worker,
+    // they are not passed to StarPU at all, so they are never allocated.
+    int ret;
+    if(static_cast<starpu_data_handle_t>(tmp) == nullptr
+            or starpu_cuda_worker_get_count() == 0)
+    {
+        ret = task_insert(codelet<T>(),
+                STARPU_R, static_cast<starpu_data_handle_t>(K),
+                STARPU_R, static_cast<starpu_data_handle_t>(Q),
+                STARPU_R, static_cast<starpu_data_handle_t>(mask),
+                maxsumexp_mode, static_cast<starpu_data_handle_t>(maxsumexp),
+                STARPU_EXECUTE_WHERE,
+                static_cast<unsigned long long>(STARPU_CPU),
+                STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+                STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
+                STARPU_FLOPS, nflops,
+                0);
+    }
+    else
     {
-        throw std::runtime_error("Error in flash_maxsumexp task submission");
+        ret = task_insert(chosen_codelet,
+                STARPU_R, static_cast<starpu_data_handle_t>(K),
+                STARPU_R, static_cast<starpu_data_handle_t>(Q),
+                STARPU_R, static_cast<starpu_data_handle_t>(mask),
+                maxsumexp_mode, static_cast<starpu_data_handle_t>(maxsumexp),
+                STARPU_SCRATCH, static_cast<starpu_data_handle_t>(tmp),
+                STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+                STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
+                STARPU_FLOPS, nflops,
+                0);
     }
+    // Check submission
+    args_pool::check_submit(ret, args,
+            "Error in flash_maxsumexp task submission");
 }
 
 // Explicit instantiation
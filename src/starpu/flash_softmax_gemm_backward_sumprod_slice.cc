@@ -4,7 +4,7 @@
  * NNTile is software framework for fast training of big neural networks on
  * distributed-memory heterogeneous systems based on StarPU runtime system.
  *
- * @file src/starpu/flash_softmax_gemm_backward_sumprod_slice.cc.in
+ * @file src/starpu/flash_softmax_gemm_backward_sumprod_slice.cc
  * Flash Attention backward to get sumprod_slice result
  *
  * @version 1.0.0
@@ -13,6 +13,7 @@
  * */
 
 #include "nntile/starpu/flash_softmax_gemm_backward_sumprod_slice.hh"
+#include "nntile/kernel/flash_softmax_gemm_backward_sumprod_slice.hh"
 #include "nntile/kernel/mask_scalar.hh"
 #include "nntile/kernel/softmax_inplace.hh"
 #include "nntile/kernel/sumprod_slice.hh"
@@ -20,13 +21,6 @@
 #include <cmath>
 #include <limits>
 
-#ifdef NNTILE_USE_CBLAS
-#   include <@CBLAS_H_NAME@>
-#   ifndef CBLAS_INT
-#       define CBLAS_INT @CBLAS_INT_TYPE@
-#   endif // CBLAS_INT
-#endif // NNTILE_USE_CBLAS
-
 #ifdef NNTILE_USE_CUDA
 #   include <cublas_v2.h>
 #   include <starpu_cublas_v2.h>
@@ -40,32 +34,7 @@ namespace starpu
 namespace flash_softmax_gemm_backward_sumprod_slice
 {
 
-#ifdef NNTILE_USE_CBLAS
-// Overloaded call to CBLAS GEMM
-static inline
-void cblas(CBLAS_TRANSPOSE transA, CBLAS_TRANSPOSE transB,
-        CBLAS_INT M, CBLAS_INT N, CBLAS_INT K, fp32_t alpha, const fp32_t *A,
-        CBLAS_INT ldA, const fp32_t *B, CBLAS_INT ldB, fp32_t beta, fp32_t *C,
-        CBLAS_INT ldC)
-    noexcept
-{
-    cblas_sgemm(CblasColMajor, transA, transB, M, N, K, alpha, A, ldA, B, ldB,
-            beta, C, ldC);
-}
-
-// Overloaded call to CBLAS GEMM
-static inline
-void cblas(CBLAS_TRANSPOSE transA, CBLAS_TRANSPOSE transB,
-        CBLAS_INT M, CBLAS_INT N, CBLAS_INT K, fp64_t alpha, const fp64_t *A,
-        CBLAS_INT ldA, const fp64_t *B, CBLAS_INT ldB, fp64_t beta, fp64_t *C,
-        CBLAS_INT ldC)
-    noexcept
-{
-    cblas_dgemm(CblasColMajor, transA, transB, M, N, K, alpha, A, ldA, B, ldB,
-            beta, C, ldC);
-}
-
-//! Rematerialize and compute maxsumexp along middle axis of StarPU buffer on CPU
+//! Gradient of V and sumprod_slice of flash attention on CPU
 template<typename T>
 void cpu(void *buffers[], void *cl_args)
     noexcept
@@ -82,59 +51,11 @@ void cpu(void *buffers[], void *cl_args)
     const T *V = interfaces[5]->get_ptr<T>();
     T *dV = interfaces[6]->get_ptr<T>();
     T *sumprod_slice = interfaces[7]->get_ptr<T>();
-    T *tmp = interfaces[8]->get_ptr<T>();
-    T *tmp_grad = interfaces[9]->get_ptr<T>();
-    // Launch kernels
-    Index K_offset = args->head * args->seq;
-    Index Q_offset = K_offset;
-    Index tmp_offset = args->seq * args->seq;
-    const T *K_local = K, *Q_local = Q;
-    T *tmp_local = tmp;
-    for(Index i = 0; i < args->batch; ++i)
-    {
-        cblas(CblasTrans, CblasNoTrans, args->seq, args->seq, args->head,
-                1.0/std::sqrt(args->head), K_local, args->head, Q_local,
-                args->head, 0.0, tmp_local, args->seq);
-        K_local += K_offset;
-        Q_local += Q_offset;
-        tmp_local += tmp_offset;
-    }
-    kernel::mask_scalar::cpu<T>(args->seq*args->seq, args->batch, mask,
-            -std::numeric_limits<T>::infinity(), tmp);
-    kernel::softmax_inplace::cpu<T>(1, args->seq*args->batch, args->seq,
-            maxsumexp, 1.0, tmp);
-    Index dA_offset = K_offset;
-    Index dV_offset = K_offset;
-    const T *dA_local = dA;
-    T *dV_local = dV;
-    tmp_local = tmp;
-    for(Index i = 0; i < args->batch; ++i)
-    {
-        cblas(CblasNoTrans, CblasTrans, args->head, args->seq, args->seq,
-                1.0, dA_local, args->head, tmp_local, args->seq, 1.0, dV_local,
-                args->head);
-        dA_local += dA_offset;
-        tmp_local += tmp_offset;
-        dV_local += dV_offset;
-    }
-    Index V_offset = K_offset;
-    Index tmp_grad_offset = tmp_offset;
-    dA_local = dA;
-    const T *V_local = V;
-    T *tmp_grad_local = tmp_grad;
-    for(Index i = 0; i < args->batch; ++i)
-    {
-        cblas(CblasTrans, CblasNoTrans, args->seq, args->seq, args->head,
-                1.0, V_local, args->head, dA_local, args->head, 0.0,
-                tmp_grad_local, args->seq);
-        V_local += V_offset;
-        dA_local += dA_offset;
-        tmp_grad_local += tmp_grad_offset;
-    }
-    kernel::sumprod_slice::cpu<T>(1, args->seq*args->batch, args->seq,
-            1.0, tmp_grad, tmp, 1.0, sumprod_slice);
+    // Launch kernel
+    kernel::flash_softmax_gemm_backward_sumprod_slice::cpu<T>(args->seq,
+            args->head, args->batch, K, Q, mask, maxsumexp, dA, V, dV,
+            sumprod_slice);
 }
-#endif // NNTILE_USE_CBLAS
 
 #ifdef NNTILE_USE_CUDA
 // Overloaded call to batched cuBLAS gemm
@@ -301,11 +222,7 @@ void init()
 {
     codelet_fp32.init("nntile_flash_softmax_gemm_backward_sumprod_slice_fp32",
             footprint,
-#ifdef NNTILE_USE_CBLAS
             {cpu<fp32_t>},
-#else // NNTILE_USE_CBLAS
-            {},
-#endif // NNTILE_USE_CBLAS
 #ifdef NNTILE_USE_CUDA
             {cuda<fp32_t>}
 #else // NNTILE_USE_CUDA
@@ -314,11 +231,7 @@ void init()
             );
     codelet_fp64.init("nntile_flash_softmax_gemm_backward_sumprod_slice_fp64",
             footprint,
-#ifdef NNTILE_USE_CBLAS
             {cpu<fp64_t>},
-#else // NNTILE_USE_CBLAS
-            {},
-#endif // NNTILE_USE_CBLAS
 #ifdef NNTILE_USE_CUDA
             {cuda<fp64_t>}
 #else // NNTILE_USE_CUDA
@@ -327,11 +240,7 @@ void init()
             );
     codelet_fp32_fast_tf32.init("nntile_flash_softmax_gemm_backward_sumprod_slice_fp32_fast_tf32",
             footprint,
-#ifdef NNTILE_USE_CBLAS
             {},
-#else // NNTILE_USE_CBLAS
-            {},
-#endif // NNTILE_USE_CBLAS
 #ifdef NNTILE_USE_CUDA
             {cuda_fp32_fast_tf32}
 #else // NNTILE_USE_CUDA
@@ -362,11 +271,13 @@ void submit(Index seq, Index head, Index batch, Handle K, Handle Q,
 //! Insert flash_maxsumexp task into StarPU pool of tasks
 /*! No argument checking is performed. All the inputs are packed and passed to
  * starpu_task_insert() function. If task submission fails, this routines
- * throws an std::runtime_error() exception.
+ * throws an std::runtime_error() exception. Scratch handles tmp and tmp_grad
+ * are only used by CUDA implementation and can be empty, in which case the
+ * task is executed on CPU.
  * */
 {
     // Codelet arguments
-    args_t *args = (args_t *)std::malloc(sizeof(*args));
+    args_t *args = args_pool::alloc<args_t>();
     args->seq = seq;
     args->head = head;
     args->batch = batch;
@@ -388,26 +299,51 @@ void submit(Index seq, Index head, Index batch, Handle K, Handle Q,
         chosen_codelet = &codelet_fp32_fast_tf32;
     }
     fp64_t nflops = 6 * seq * seq * head * batch;
-    int ret = starpu_task_insert(chosen_codelet,
-            STARPU_R, static_cast<starpu_data_handle_t>(K),
-            STARPU_R, static_cast<starpu_data_handle_t>(Q),
-            STARPU_R, static_cast<starpu_data_handle_t>(mask),
-            STARPU_R, static_cast<starpu_data_handle_t>(maxsumexp),
-            STARPU_R, static_cast<starpu_data_handle_t>(dA),
-            STARPU_R, static_cast<starpu_data_handle_t>(V),
-            rw_mode, static_cast<starpu_data_handle_t>(dV),
-            rw_mode, static_cast<starpu_data_handle_t>(sumprod_slice),
-            STARPU_SCRATCH, static_cast<starpu_data_handle_t>(tmp),
-            STARPU_SCRATCH, static_cast<starpu_data_handle_t>(tmp_grad),
-            STARPU_CL_ARGS, args, sizeof(*args),
-            STARPU_FLOPS, nflops,
-            0);
-    // Check submission
-    if(ret != 0)
+    // CPU implementation rematerializes scores by small blocks and does not
+    // need scratch buffers. If the task can not be executed by a CUDA worker,
+    // they are not passed to StarPU at all, so they are never allocated.
+    int ret;
+    if(static_cast<starpu_data_handle_t>(tmp) == nullptr
+            or static_cast<starpu_data_handle_t>(tmp_grad) == nullptr
+            or starpu_cuda_worker_get_count() == 0)
     {
-        throw std::runtime_error("Error in flash_softmax_gemm_backward_"
-                "sumprod_slice task submission");
+        ret = task_insert(codelet<T>(),
+                STARPU_R, static_cast<starpu_data_handle_t>(K),
+                STARPU_R, static_cast<starpu_data_handle_t>(Q),
+                STARPU_R, static_cast<starpu_data_handle_t>(mask),
+                STARPU_R, static_cast<starpu_data_handle_t>(maxsumexp),
+                STARPU_R, static_cast<starpu_data_handle_t>(dA),
+                STARPU_R, static_cast<starpu_data_handle_t>(V),
+                rw_mode, static_cast<starpu_data_handle_t>(dV),
+                rw_mode, static_cast<starpu_data_handle_t>(sumprod_slice),
+                STARPU_EXECUTE_WHERE,
+                static_cast<unsigned long long>(STARPU_CPU),
+                STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+                STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
+                STARPU_FLOPS, nflops,
+                0);
     }
+    else
+    {
+        ret = task_insert(chosen_codelet,
+                STARPU_R, static_cast<starpu_data_handle_t>(K),
+                STARPU_R, static_cast<starpu_data_handle_t>(Q),
+                STARPU_R, static_cast<starpu_data_handle_t>(mask),
+                STARPU_R, static_cast<starpu_data_handle_t>(maxsumexp),
+                STARPU_R, static_cast<starpu_data_handle_t>(dA),
+                STARPU_R, static_cast<starpu_data_handle_t>(V),
+                rw_mode, static_cast<starpu_data_handle_t>(dV),
+                rw_mode, static_cast<starpu_data_handle_t>(sumprod_slice),
+                STARPU_SCRATCH, static_cast<starpu_data_handle_t>(tmp),
+                STARPU_SCRATCH, static_cast<starpu_data_handle_t>(tmp_grad),
+                STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+                STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
+                STARPU_FLOPS, nflops,
+                0);
+    }
+    // Check submission
+    args_pool::check_submit(ret, args, "Error in "
+            "flash_softmax_gemm_backward_sumprod_slice task submission");
 }
 
 // Explicit instantiation
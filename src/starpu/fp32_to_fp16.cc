@@ -22,7 +22,6 @@ namespace starpu
 namespace fp32_to_fp16
 {
 
-#ifdef NNTILE_USE_CUDA
 //! StarPU wrapper for kernel::fp32_to_fp16::cpu<T>
 void cpu(void *buffers[], void *cl_args)
     noexcept
@@ -37,6 +36,7 @@ void cpu(void *buffers[], void *cl_args)
     kernel::fp32_to_fp16::cpu(nelems, src, dst);
 }
 
+#ifdef NNTILE_USE_CUDA
 //! StarPU wrapper for kernel::fp32_to_fp16::cuda<T>
 void cuda(void *buffers[], void *cl_args)
     noexcept
@@ -60,11 +60,10 @@ void init()
 {
     codelet.init("nntile_fp32_to_fp16",
             nullptr,
-#ifdef NNTILE_USE_CUDA
             {cpu},
+#ifdef NNTILE_USE_CUDA
             {cuda}
 #else // NNTILE_USE_CUDA
-            {},
             {}
 #endif // NNTILE_USE_CUDA
             );
@@ -82,19 +81,18 @@ void restore_where()
 
 void submit(Index nelems, Handle src, Handle dst)
 {
-    Index *nelems_ = new Index{nelems};
+    Index *nelems_ = args_pool::alloc<Index>(nelems);
     //fp64_t nflops = 5 * nelems;
-    int ret = starpu_task_insert(&codelet,
+    int ret = task_insert(&codelet,
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_W, static_cast<starpu_data_handle_t>(dst),
-            STARPU_CL_ARGS, nelems_, sizeof(*nelems_),
+            STARPU_CL_ARGS_NFREE, nelems_, sizeof(*nelems_),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, nelems_,
             //STARPU_FLOPS, nflops,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in fp32_to_fp16 task submission");
-    }
+    args_pool::check_submit(ret, nelems_,
+            "Error in fp32_to_fp16 task submission");
 }
 
 } // namespace fp32_to_fp16
@@ -57,7 +57,7 @@ void cuda(void *buffers[], void *cl_args)
 }
 #endif // NNTILE_USE_CUDA
 
-Codelet codelet_fp32, codelet_fp64;
+Codelet codelet_fp32, codelet_fp64, codelet_bf16;
 
 void init()
 {
@@ -79,38 +79,42 @@ void init()
             {}
 #endif // NNTILE_USE_CUDA
             );
+    codelet_bf16.init("nntile_gelutanh_bf16",
+            nullptr,
+            {cpu<bf16_t>},
+            {}
+            );
 }
 
 void restrict_where(uint32_t where)
 {
     codelet_fp32.restrict_where(where);
     codelet_fp64.restrict_where(where);
+    codelet_bf16.restrict_where(where);
 }
 
 void restore_where()
 {
     codelet_fp32.restore_where();
     codelet_fp64.restore_where();
+    codelet_bf16.restore_where();
 }
 
 template<typename T>
 void submit(Index nelems, Handle src, Handle dst)
 {
     // Codelet arguments
-    Index *nelems_ = (Index *)std::malloc(sizeof(*nelems_));
-    *nelems_ = nelems;
+    Index *nelems_ = args_pool::alloc<Index>(nelems);
     //fp64_t nflops = 5 * nelems;
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_W, static_cast<starpu_data_handle_t>(dst),
-            STARPU_CL_ARGS, nelems_, sizeof(*nelems_),
+            STARPU_CL_ARGS_NFREE, nelems_, sizeof(*nelems_),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, nelems_,
             //STARPU_FLOPS, nflops,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in gelutanh task submission");
-    }
+    args_pool::check_submit(ret, nelems_, "Error in gelutanh task submission");
 }
 
 // Explicit instantiaion
@@ -120,6 +124,9 @@ void submit<fp32_t>(Index nelems, Handle src, Handle dst);
 template
 void submit<fp64_t>(Index nelems, Handle src, Handle dst);
 
+template
+void submit<bf16_t>(Index nelems, Handle src, Handle dst);
+
 } // namespace gelutanh
 } // namespace starpu
 } // namespace nntile
@@ -99,19 +99,17 @@ void restore_where()
 template<typename T>
 void submit(Index nelems, Handle x, Handle dy, Handle dx)
 {
-    Index *nelems_ = (Index *)std::malloc(sizeof(*nelems_));
-    *nelems_ = nelems;
-    int ret = starpu_task_insert(codelet<T>(),
+    Index *nelems_ = args_pool::alloc<Index>(nelems);
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(x),
             STARPU_R, static_cast<starpu_data_handle_t>(dy),
             STARPU_RW, static_cast<starpu_data_handle_t>(dx),
-            STARPU_CL_ARGS, nelems_, sizeof(*nelems_),
+            STARPU_CL_ARGS_NFREE, nelems_, sizeof(*nelems_),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, nelems_,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in gelutanh_backward task submission");
-    }
+    args_pool::check_submit(ret, nelems_,
+            "Error in gelutanh_backward task submission");
 }
 
 // Explicit instantiaion
@@ -135,20 +133,18 @@ void submit_mpi(Index nelems, Handle x, Handle dy, Handle dx, int exec_rank)
     if(task)
     {
         // Define codelet arguments
-        Index *nelems_ = (Index *)std::malloc(sizeof(*nelems_));
+        Index *nelems_ = args_pool::alloc<Index>(nelems);
         task->cl_arg = nelems_;
         task->cl_arg_size = sizeof(*nelems_);
-        task->cl_arg_free = 1;
-        // Set codelet arguments
-        *nelems_ = nelems;
+        task->cl_arg_free = 0;
+        // Return arguments to the pool after execution
+        task->callback_func = args_pool::release;
+        task->callback_arg = nelems_;
         // Submit task to the DAG
-        int ret = starpu_task_submit(task);
+        int ret = task_submit(task);
         // Check submission
-        if(ret != 0)
-        {
-            throw std::runtime_error("Error in gelutanh_backward MPI task "
-                    "submission");
-        }
+        args_pool::check_submit(ret, nelems_,
+                "Error in gelutanh_backward MPI task submission");
     }
     // Data transfers after the task
 //    starpu_mpi_task_post_build(MPI_COMM_WORLD,
@@ -240,31 +240,29 @@ void submit(const TransOp &transA, const TransOp &transB, Index m, Index n,
         C_mode = STARPU_RW;
     }
     // Codelet arguments
-    auto args = new args_t<T>
-    {
-        .transA = transA,
-        .transB = transB,
-        .m = m,
-        .n = n,
-        .k = k,
-        .batch = batch,
-        .alpha = alpha,
-        .beta = beta
-    };
+    auto args = args_pool::alloc<args_t<T>>(args_t<T>
+        {
+            .transA = transA,
+            .transB = transB,
+            .m = m,
+            .n = n,
+            .k = k,
+            .batch = batch,
+            .alpha = alpha,
+            .beta = beta
+        });
     fp64_t nflops = 2 * m * n * k;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(transA, transB),
+    int ret = task_insert(codelet<T>(transA, transB),
             STARPU_R, static_cast<starpu_data_handle_t>(A),
             STARPU_R, static_cast<starpu_data_handle_t>(B),
             C_mode, static_cast<starpu_data_handle_t>(C),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             STARPU_FLOPS, nflops,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in gemm_ex task submission");
-    }
+    args_pool::check_submit(ret, args, "Error in gemm_ex task submission");
 }
 
 // Explicit instantiation
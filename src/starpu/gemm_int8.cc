@@ -0,0 +1,144 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/gemm_int8.cc
+ * Matrix multiplication by per-channel quantized int8 weights on StarPU
+ * buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-20
+ * */
+
+#include "nntile/starpu/gemm_int8.hh"
+#include "nntile/kernel/gemm_int8.hh"
+
+namespace nntile
+{
+namespace starpu
+{
+namespace gemm_int8
+{
+
+//! Multiply StarPU buffer by int8 weights on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const int8_t *w = interfaces[0]->get_ptr<int8_t>();
+    const T *w_scale = interfaces[1]->get_ptr<T>();
+    const T *x = interfaces[2]->get_ptr<T>();
+    T *y = interfaces[3]->get_ptr<T>();
+    // Split scratch buffer, starting from the widest type
+    T *x_scale = interfaces[4]->get_ptr<T>();
+    auto acc = reinterpret_cast<std::int32_t *>(x_scale + args->n);
+    auto x_quant = reinterpret_cast<std::int16_t *>(acc + args->n);
+    std::int16_t *w_col = x_quant + args->k*args->n;
+    // Launch kernel
+    kernel::gemm_int8::cpu<T>(args->trans, args->m, args->n, args->k,
+            args->alpha, w, w_scale, x, args->beta, y, x_scale, x_quant,
+            w_col, acc);
+}
+
+//! Footprint for gemm_int8 tasks
+template<typename T>
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(task->cl_arg);
+    // Apply hash over parameters M, N and K
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->m, sizeof(args->m), hash);
+    hash = starpu_hash_crc32c_be_n(&args->n, sizeof(args->n), hash);
+    hash = starpu_hash_crc32c_be_n(&args->k, sizeof(args->k), hash);
+    return hash;
+}
+
+Codelet codelet_fp32;
+
+void init()
+{
+    // There is no CUDA implementation, as int8 weights target CPU inference
+    codelet_fp32.init("nntile_gemm_int8_fp32",
+            footprint<fp32_t>,
+            {cpu<fp32_t>},
+            {}
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+}
+
+template<typename T>
+void submit(const TransOp &trans, Index m, Index n, Index k, T alpha,
+        Handle w, Handle w_scale, Handle x, T beta, Handle y, Handle scratch)
+//! Insert gemm_int8 task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception. Scratch buffer must hold at least
+ * scratch_size<T>(n, k) bytes.
+ * */
+{
+    constexpr T zero = 0, one = 1;
+    enum starpu_data_access_mode y_mode;
+    if(beta == zero)
+    {
+        y_mode = STARPU_W;
+    }
+    else if(beta == one)
+    {
+        y_mode = Config::STARPU_RW_COMMUTE;
+    }
+    else
+    {
+        y_mode = STARPU_RW;
+    }
+    // Codelet arguments
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
+    args->trans = trans;
+    args->m = m;
+    args->n = n;
+    args->k = k;
+    args->alpha = alpha;
+    args->beta = beta;
+    fp64_t nflops = 2 * m * n * k;
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(w),
+            STARPU_R, static_cast<starpu_data_handle_t>(w_scale),
+            STARPU_R, static_cast<starpu_data_handle_t>(x),
+            y_mode, static_cast<starpu_data_handle_t>(y),
+            STARPU_SCRATCH, static_cast<starpu_data_handle_t>(scratch),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    args_pool::check_submit(ret, args, "Error in gemm_int8 task submission");
+}
+
+// Explicit instantiaion
+template
+void submit<fp32_t>(const TransOp &trans, Index m, Index n, Index k,
+        fp32_t alpha, Handle w, Handle w_scale, Handle x, fp32_t beta,
+        Handle y, Handle scratch);
+
+} // namespace gemm_int8
+} // namespace starpu
+} // namespace nntile
+
@@ -137,21 +137,19 @@ void submit(Index nelems, T alpha, Handle src, T beta, Handle dst)
         dst_mode = STARPU_RW;
     }
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
     args->nelems = nelems;
     args->alpha = alpha;
     args->beta = beta;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             dst_mode, static_cast<starpu_data_handle_t>(dst), 0);
             // STARPU_FLOPS, nflops);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in hypot task submission");
-    }
+    args_pool::check_submit(ret, args, "Error in hypot task submission");
 }
 
 // Explicit instantiation
@@ -103,20 +103,19 @@ void submit(Index nelems, T eps, T alpha, Handle dst)
  * */
 {
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
     args->nelems = nelems;
     args->eps = eps;
     args->alpha = alpha;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_RW, static_cast<starpu_data_handle_t>(dst),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in hypot_scalar_inverse task submission");
-    }
+    args_pool::check_submit(ret, args,
+            "Error in hypot_scalar_inverse task submission");
 }
 
 // Explicit instantiation
@@ -0,0 +1,150 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/layer_norm_backward.cc
+ * Fused backward pass of layer normalization on StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-08
+ * */
+
+#include "nntile/starpu/layer_norm_backward.hh"
+#include "nntile/kernel/layer_norm_backward.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for layer_norm_backward operation
+namespace layer_norm_backward
+{
+
+//! StarPU wrapper for kernel::layer_norm_backward::cpu<T>
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *src_normalized = interfaces[0]->get_ptr<T>();
+    const T *dst_grad = interfaces[1]->get_ptr<T>();
+    const T *gamma = interfaces[2]->get_ptr<T>();
+    const T *inv_stddev = interfaces[3]->get_ptr<T>();
+    T *src_grad = interfaces[4]->get_ptr<T>();
+    T *gamma_grad = interfaces[5]->get_ptr<T>();
+    T *beta_grad = interfaces[6]->get_ptr<T>();
+    // Launch kernel
+    kernel::layer_norm_backward::cpu<T>(args->m, args->n, args->k,
+            src_normalized, dst_grad, gamma, inv_stddev, src_grad, gamma_grad,
+            beta_grad);
+}
+
+//! Footprint for layer_norm_backward tasks
+template<typename T>
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(task->cl_arg);
+    // Apply hash over parameters m, n and k
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->m, sizeof(args->m), hash);
+    hash = starpu_hash_crc32c_be_n(&args->n, sizeof(args->n), hash);
+    hash = starpu_hash_crc32c_be_n(&args->k, sizeof(args->k), hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_layer_norm_backward_fp32",
+            footprint<fp32_t>,
+            {cpu<fp32_t>},
+            {}
+            );
+    codelet_fp64.init("nntile_layer_norm_backward_fp64",
+            footprint<fp64_t>,
+            {cpu<fp64_t>},
+            {}
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index m, Index n, Index k, Handle src_normalized,
+        Handle dst_grad, Handle gamma, Handle inv_stddev, Handle src_grad,
+        Handle gamma_grad, Handle beta_grad, int redux)
+//! Insert layer_norm_backward task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Gradients of gamma and beta accumulate contributions of many tasks
+    enum starpu_data_access_mode grad_mode;
+    if(redux != 0)
+    {
+        grad_mode = STARPU_REDUX;
+    }
+    else
+    {
+        grad_mode = Config::STARPU_RW_COMMUTE;
+    }
+    // Codelet arguments
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
+    args->m = m;
+    args->n = n;
+    args->k = k;
+    fp64_t nflops = 14 * m * n * k;
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(src_normalized),
+            STARPU_R, static_cast<starpu_data_handle_t>(dst_grad),
+            STARPU_R, static_cast<starpu_data_handle_t>(gamma),
+            STARPU_R, static_cast<starpu_data_handle_t>(inv_stddev),
+            STARPU_RW, static_cast<starpu_data_handle_t>(src_grad),
+            grad_mode, static_cast<starpu_data_handle_t>(gamma_grad),
+            grad_mode, static_cast<starpu_data_handle_t>(beta_grad),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    args_pool::check_submit(ret, args,
+            "Error in layer_norm_backward task submission");
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index m, Index n, Index k, Handle src_normalized,
+        Handle dst_grad, Handle gamma, Handle inv_stddev, Handle src_grad,
+        Handle gamma_grad, Handle beta_grad, int redux);
+
+template
+void submit<fp64_t>(Index m, Index n, Index k, Handle src_normalized,
+        Handle dst_grad, Handle gamma, Handle inv_stddev, Handle src_grad,
+        Handle gamma_grad, Handle beta_grad, int redux);
+
+} // namespace layer_norm_backward
+} // namespace starpu
+} // namespace nntile
+
@@ -0,0 +1,140 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/layer_norm_forward.cc
+ * Fused forward pass of layer normalization on StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-08
+ * */
+
+#include "nntile/starpu/layer_norm_forward.hh"
+#include "nntile/kernel/layer_norm_forward.hh"
+#include <cstdlib>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for layer_norm_forward operation
+namespace layer_norm_forward
+{
+
+//! StarPU wrapper for kernel::layer_norm_forward::cpu<T>
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *src = interfaces[0]->get_ptr<T>();
+    const T *gamma = interfaces[1]->get_ptr<T>();
+    const T *beta = interfaces[2]->get_ptr<T>();
+    T *mean = interfaces[3]->get_ptr<T>();
+    T *inv_stddev = interfaces[4]->get_ptr<T>();
+    T *src_normalized = interfaces[5]->get_ptr<T>();
+    T *dst = interfaces[6]->get_ptr<T>();
+    // Launch kernel
+    kernel::layer_norm_forward::cpu<T>(args->m, args->n, args->k, args->eps,
+            src, gamma, beta, mean, inv_stddev, src_normalized, dst);
+}
+
+//! Footprint for layer_norm_forward tasks
+template<typename T>
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(task->cl_arg);
+    // Apply hash over parameters m, n and k
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->m, sizeof(args->m), hash);
+    hash = starpu_hash_crc32c_be_n(&args->n, sizeof(args->n), hash);
+    hash = starpu_hash_crc32c_be_n(&args->k, sizeof(args->k), hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_layer_norm_forward_fp32",
+            footprint<fp32_t>,
+            {cpu<fp32_t>},
+            {}
+            );
+    codelet_fp64.init("nntile_layer_norm_forward_fp64",
+            footprint<fp64_t>,
+            {cpu<fp64_t>},
+            {}
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index m, Index n, Index k, T eps, Handle src, Handle gamma,
+        Handle beta, Handle mean, Handle inv_stddev, Handle src_normalized,
+        Handle dst)
+//! Insert layer_norm_forward task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Codelet arguments
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
+    args->m = m;
+    args->n = n;
+    args->k = k;
+    args->eps = eps;
+    fp64_t nflops = 8 * m * n * k;
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(src),
+            STARPU_R, static_cast<starpu_data_handle_t>(gamma),
+            STARPU_R, static_cast<starpu_data_handle_t>(beta),
+            STARPU_W, static_cast<starpu_data_handle_t>(mean),
+            STARPU_W, static_cast<starpu_data_handle_t>(inv_stddev),
+            STARPU_W, static_cast<starpu_data_handle_t>(src_normalized),
+            STARPU_W, static_cast<starpu_data_handle_t>(dst),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
+            STARPU_FLOPS, nflops,
+            0);
+    // Check submission
+    args_pool::check_submit(ret, args,
+            "Error in layer_norm_forward task submission");
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t>(Index m, Index n, Index k, fp32_t eps, Handle src,
+        Handle gamma, Handle beta, Handle mean, Handle inv_stddev,
+        Handle src_normalized, Handle dst);
+
+template
+void submit<fp64_t>(Index m, Index n, Index k, fp64_t eps, Handle src,
+        Handle gamma, Handle beta, Handle mean, Handle inv_stddev,
+        Handle src_normalized, Handle dst);
+
+} // namespace layer_norm_forward
+} // namespace starpu
+} // namespace nntile
+
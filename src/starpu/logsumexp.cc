@@ -101,20 +101,18 @@ void submit(Index nelems, Handle maxsumexp, Handle logsumexp)
  * */
 {
     // Codelet arguments
-    Index *nelems_ = (Index *)std::malloc(sizeof(*nelems_));
-    *nelems_ = nelems;
+    Index *nelems_ = args_pool::alloc<Index>(nelems);
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(maxsumexp),
-            STARPU_CL_ARGS, nelems_, sizeof(*nelems_),
+            STARPU_CL_ARGS_NFREE, nelems_, sizeof(*nelems_),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, nelems_,
             STARPU_W, static_cast<starpu_data_handle_t>(logsumexp),
             //STARPU_FLOPS, nflops,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in logsumexp task submission");
-    }
+    args_pool::check_submit(ret, nelems_,
+            "Error in logsumexp task submission");
 }
 
 // Explicit instantiation
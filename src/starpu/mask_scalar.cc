@@ -118,21 +118,19 @@ void submit(Index nrows, Index ncols, Handle mask, T val, Handle data)
  * */
 {
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
     args->nrows = nrows;
     args->ncols = ncols;
     args->val = val;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_RW, static_cast<starpu_data_handle_t>(data),
             STARPU_R, static_cast<starpu_data_handle_t>(mask),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in mask_scalar task submission");
-    }
+    args_pool::check_submit(ret, args, "Error in mask_scalar task submission");
 }
 
 // Explicit instantiaion
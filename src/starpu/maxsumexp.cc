@@ -73,7 +73,7 @@ uint32_t footprint(struct starpu_task *task)
     return hash;
 }
 
-Codelet codelet_fp32, codelet_fp64;
+Codelet codelet_fp32, codelet_fp64, codelet_bf16;
 
 void init()
 {
@@ -95,18 +95,25 @@ void init()
             {}
 #endif // NNTILE_USE_CUDA
             );
+    codelet_bf16.init("nntile_maxsumexp_bf16",
+            footprint,
+            {cpu<bf16_t>},
+            {}
+            );
 }
 
 void restrict_where(uint32_t where)
 {
     codelet_fp32.restrict_where(where);
     codelet_fp64.restrict_where(where);
+    codelet_bf16.restrict_where(where);
 }
 
 void restore_where()
 {
     codelet_fp32.restore_where();
     codelet_fp64.restore_where();
+    codelet_bf16.restore_where();
 }
 
 template<typename T>
@@ -118,7 +125,7 @@ void submit(Index m, Index n, Index k, Handle src, Handle dst, int redux)
  * */
 {
     // Codelet arguments
-    args_t *args = (args_t *)std::malloc(sizeof(*args));
+    args_t *args = args_pool::alloc<args_t>();
     args->m = m;
     args->n = n;
     args->k = k;
@@ -135,17 +142,15 @@ void submit(Index m, Index n, Index k, Handle src, Handle dst, int redux)
         dst_mode = Config::STARPU_RW_COMMUTE;
     }
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             dst_mode, static_cast<starpu_data_handle_t>(dst),
             //STARPU_FLOPS, nflops,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in maxsumexp task submission");
-    }
+    args_pool::check_submit(ret, args, "Error in maxsumexp task submission");
 }
 
 // Explicit instantiation
@@ -157,6 +162,10 @@ template
 void submit<fp64_t>(Index m, Index n, Index k, Handle src, Handle dst,
         int redux);
 
+template
+void submit<bf16_t>(Index m, Index n, Index k, Handle src, Handle dst,
+        int redux);
+
 } // namespace maxsumexp
 } // namespace starpu
 } // namespace nntile
@@ -0,0 +1,254 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/multi_adam_step.cc
+ * Fused Adam step over many tiles within a single StarPU task
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/starpu/multi_adam_step.hh"
+#include "nntile/kernel/adam_step.hh"
+#include <cmath>
+
+namespace nntile
+{
+namespace starpu
+{
+//! StarPU wrappers for one step of Adam optimizer over many tiles
+namespace multi_adam_step
+{
+
+//! Apply Adam step to many tiles of StarPU buffers on CPU
+/*! Buffers are grouped by tiles: gradient, first moment, second moment and
+ * parameters of the first tile, then the same for the second tile and so on.
+ * */
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    for(Index i = 0; i < args->ntiles; ++i)
+    {
+        auto tile_interfaces = interfaces + 4*i;
+        Index num_elems = tile_interfaces[0]->elemsize / sizeof(T);
+        const T *grad = tile_interfaces[0]->get_ptr<T>();
+        T *first_moment = tile_interfaces[1]->get_ptr<T>();
+        T *second_moment = tile_interfaces[2]->get_ptr<T>();
+        T *p = tile_interfaces[3]->get_ptr<T>();
+        // Launch kernel
+        kernel::adam_step::cpu_apply<T>(num_elems, args->first_iter,
+                args->beta_1, args->beta_2, args->eps, args->alpha,
+                args->beta, args->l2_decay, args->p_scale, grad,
+                first_moment, second_moment, p);
+    }
+}
+
+//! Apply Adam step to many tiles with moments in bf16_t on CPU
+/*! Buffers are grouped by tiles as above. Every tile gets its own seed for
+ * stochastic rounding of moments.
+ * */
+template<typename T>
+void cpu_bf16(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    for(Index i = 0; i < args->ntiles; ++i)
+    {
+        auto tile_interfaces = interfaces + 4*i;
+        Index num_elems = tile_interfaces[0]->elemsize / sizeof(T);
+        const T *grad = tile_interfaces[0]->get_ptr<T>();
+        bf16_t *first_moment = tile_interfaces[1]->get_ptr<bf16_t>();
+        bf16_t *second_moment = tile_interfaces[2]->get_ptr<bf16_t>();
+        T *p = tile_interfaces[3]->get_ptr<T>();
+        // Launch kernel
+        kernel::adam_step::cpu_apply<T>(num_elems, args->first_iter,
+                args->beta_1, args->beta_2, args->eps, args->alpha,
+                args->beta, args->l2_decay, args->p_scale, args->seed+i,
+                grad, first_moment, second_moment, p);
+    }
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Apply Adam step to many tiles of StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Kernels for all the tiles are launched into the same stream
+    for(Index i = 0; i < args->ntiles; ++i)
+    {
+        auto tile_interfaces = interfaces + 4*i;
+        Index num_elems = tile_interfaces[0]->elemsize / sizeof(T);
+        const T *grad = tile_interfaces[0]->get_ptr<T>();
+        T *first_moment = tile_interfaces[1]->get_ptr<T>();
+        T *second_moment = tile_interfaces[2]->get_ptr<T>();
+        T *p = tile_interfaces[3]->get_ptr<T>();
+        // Launch kernel
+        kernel::adam_step::cuda_apply<T>(stream, num_elems, args->first_iter,
+                args->beta_1, args->beta_2, args->eps, args->alpha,
+                args->beta, args->l2_decay, args->p_scale, grad,
+                first_moment, second_moment, p);
+    }
+}
+#endif // NNTILE_USE_CUDA
+
+Codelet codelet_fp32, codelet_fp64, codelet_fp32_bf16;
+
+void init()
+{
+    codelet_fp32.init("nntile_multi_adam_step_fp32",
+            nullptr,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_multi_adam_step_fp64",
+            nullptr,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp32_bf16.init("nntile_multi_adam_step_fp32_bf16",
+            nullptr,
+            {cpu_bf16<fp32_t>},
+            {}
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+    codelet_fp32_bf16.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+    codelet_fp32_bf16.restore_where();
+}
+
+//! Submit a single task, that applies Adam or AdamW step to many tiles
+/*! Decoupled weight decay (AdamW) only scales parameters, so both variants
+ * are served by the same kernel. All the lists of handles must be of the
+ * same size. Moments are stored in type M, that is either T or bf16_t. In the
+ * latter case moments are rounded stochastically, and tile i of the task
+ * uses seed+i.
+ * */
+template<typename T, typename M>
+void submit(Index num_iter, T beta_1, T beta_2, T eps, T lr, T weight_decay,
+        int decoupled, Index seed, const std::vector<Handle> &grad,
+        const std::vector<Handle> &first_moment,
+        const std::vector<Handle> &second_moment,
+        const std::vector<Handle> &p)
+{
+    Index ntiles = p.size();
+    // Codelet arguments
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
+    args->ntiles = ntiles;
+    args->seed = seed;
+    args->first_iter = (num_iter == 1);
+    args->beta_1 = beta_1;
+    args->beta_2 = beta_2;
+    args->eps = eps;
+    args->alpha = lr / (1 - std::pow(beta_1, num_iter));
+    args->beta = 1 / std::sqrt(1 - std::pow(beta_2, num_iter));
+    if(decoupled != 0)
+    {
+        args->l2_decay = 0;
+        args->p_scale = 1 - lr*weight_decay;
+    }
+    else
+    {
+        args->l2_decay = weight_decay;
+        args->p_scale = 1;
+    }
+    // Moments are not read at the first iteration
+    enum starpu_data_access_mode moments_mode;
+    if(num_iter == 1)
+    {
+        moments_mode = STARPU_W;
+    }
+    else
+    {
+        moments_mode = STARPU_RW;
+    }
+    std::vector<starpu_data_descr> descrs(4*ntiles);
+    for(Index i = 0; i < ntiles; ++i)
+    {
+        descrs[4*i].handle = static_cast<starpu_data_handle_t>(grad[i]);
+        descrs[4*i].mode = STARPU_R;
+        descrs[4*i+1].handle = static_cast<starpu_data_handle_t>(
+                first_moment[i]);
+        descrs[4*i+1].mode = moments_mode;
+        descrs[4*i+2].handle = static_cast<starpu_data_handle_t>(
+                second_moment[i]);
+        descrs[4*i+2].mode = moments_mode;
+        descrs[4*i+3].handle = static_cast<starpu_data_handle_t>(p[i]);
+        descrs[4*i+3].mode = STARPU_RW;
+    }
+    // Submit task
+    int ret = task_insert(codelet<T, M>(),
+            STARPU_DATA_MODE_ARRAY, descrs.data(), int(descrs.size()),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
+            0);
+    // Check submission
+    args_pool::check_submit(ret, args,
+            "Error in multi_adam_step task submission");
+}
+
+// Explicit instantiation
+template
+void submit<fp32_t, fp32_t>(Index num_iter, fp32_t beta_1, fp32_t beta_2,
+        fp32_t eps, fp32_t lr, fp32_t weight_decay, int decoupled, Index seed,
+        const std::vector<Handle> &grad,
+        const std::vector<Handle> &first_moment,
+        const std::vector<Handle> &second_moment,
+        const std::vector<Handle> &p);
+
+template
+void submit<fp64_t, fp64_t>(Index num_iter, fp64_t beta_1, fp64_t beta_2,
+        fp64_t eps, fp64_t lr, fp64_t weight_decay, int decoupled, Index seed,
+        const std::vector<Handle> &grad,
+        const std::vector<Handle> &first_moment,
+        const std::vector<Handle> &second_moment,
+        const std::vector<Handle> &p);
+
+template
+void submit<fp32_t, bf16_t>(Index num_iter, fp32_t beta_1, fp32_t beta_2,
+        fp32_t eps, fp32_t lr, fp32_t weight_decay, int decoupled, Index seed,
+        const std::vector<Handle> &grad,
+        const std::vector<Handle> &first_moment,
+        const std::vector<Handle> &second_moment,
+        const std::vector<Handle> &p);
+
+} // namespace multi_adam_step
+} // namespace starpu
+} // namespace nntile
+
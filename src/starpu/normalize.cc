@@ -125,28 +125,26 @@ void submit(Index m, Index n, Index k, Index l, T eps, Handle gamma_beta,
  * */
 {
     // Codelet arguments
-    auto args = new args_t<T>
-    {
-        .m = m,
-        .n = n,
-        .k = k,
-        .l = l,
-        .eps = eps
-    };
+    auto args = args_pool::alloc<args_t<T>>(args_t<T>
+        {
+            .m = m,
+            .n = n,
+            .k = k,
+            .l = l,
+            .eps = eps
+        });
     fp64_t nflops = 14 * m * n * k;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(gamma_beta),
             STARPU_R, static_cast<starpu_data_handle_t>(sumnorm),
             STARPU_RW, static_cast<starpu_data_handle_t>(dst),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             STARPU_FLOPS, nflops,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in normalize task submission");
-    }
+    args_pool::check_submit(ret, args, "Error in normalize task submission");
 }
 
 // Explicit instantiation
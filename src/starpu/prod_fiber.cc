@@ -120,24 +120,22 @@ void submit(Index m, Index n, Index k, T alpha, Handle src, Handle dst)
  * */
 {
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
     args->m = m;
     args->n = n;
     args->k = k;
     args->alpha = alpha;
     fp64_t nflops = m * n * k;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             STARPU_RW, static_cast<starpu_data_handle_t>(dst),
             STARPU_FLOPS, nflops,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in prod_fiber task submission");
-    }
+    args_pool::check_submit(ret, args, "Error in prod_fiber task submission");
 }
 
 // Explicit instantiation
@@ -126,19 +126,24 @@ void submit(Index ndim, Index nelems, unsigned long long seed,
     fp64_t nflops = 2 * nelems;
     // Submit task
     int ret;
+    std::size_t args_size;
     if(ndim > 0)
     {
-        ret = starpu_task_insert(codelet<T>(),
-                STARPU_VALUE, &ndim, sizeof(ndim),
-                STARPU_VALUE, &nelems, sizeof(nelems),
-                STARPU_VALUE, &seed, sizeof(seed),
-                STARPU_VALUE, &mean, sizeof(mean),
-                STARPU_VALUE, &stddev, sizeof(stddev),
-                STARPU_VALUE, &start[0], ndim*sizeof(start[0]),
-                STARPU_VALUE, &shape[0], ndim*sizeof(shape[0]),
-                STARPU_VALUE, &stride[0], ndim*sizeof(stride[0]),
-                STARPU_VALUE, &underlying_shape[0],
-                ndim*sizeof(underlying_shape[0]),
+        // Pack codelet arguments in the same format as STARPU_VALUE does
+        void *args = args_pool::pack({
+                {&ndim, sizeof(ndim)},
+                {&nelems, sizeof(nelems)},
+                {&seed, sizeof(seed)},
+                {&mean, sizeof(mean)},
+                {&stddev, sizeof(stddev)},
+                {&start[0], ndim*sizeof(start[0])},
+                {&shape[0], ndim*sizeof(shape[0])},
+                {&stride[0], ndim*sizeof(stride[0])},
+                {&underlying_shape[0], ndim*sizeof(underlying_shape[0])}},
+                args_size);
+        ret = task_insert(codelet<T>(),
+                STARPU_CL_ARGS_NFREE, args, args_size,
+                STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
                 STARPU_W, static_cast<starpu_data_handle_t>(data),
                 STARPU_SCRATCH, static_cast<starpu_data_handle_t>(tmp_index),
                 STARPU_FLOPS, nflops,
@@ -146,19 +151,19 @@ void submit(Index ndim, Index nelems, unsigned long long seed,
     }
     else
     {
-        ret = starpu_task_insert(codelet_ndim0<T>(),
-                STARPU_VALUE, &seed, sizeof(seed),
-                STARPU_VALUE, &mean, sizeof(mean),
-                STARPU_VALUE, &stddev, sizeof(stddev),
+        void *args = args_pool::pack({
+                {&seed, sizeof(seed)},
+                {&mean, sizeof(mean)},
+                {&stddev, sizeof(stddev)}}, args_size);
+        ret = task_insert(codelet_ndim0<T>(),
+                STARPU_CL_ARGS_NFREE, args, args_size,
+                STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
                 STARPU_W, static_cast<starpu_data_handle_t>(data),
                 STARPU_FLOPS, nflops,
                 0);
     }
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in randn task submission");
-    }
+    args_pool::check_submit(ret, args, "Error in randn task submission");
 }
 
 // Explicit instantiation
@@ -0,0 +1,124 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/read_tile.cc
+ * Read a StarPU buffer from a memory mapped file at a given offset
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-13
+ * */
+
+#include "nntile/starpu/read_tile.hh"
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace read_tile
+{
+
+//! Number of failed tasks, as codelets cannot throw exceptions
+static std::atomic<Index> nfailed_tasks{0};
+
+//! Read a StarPU buffer from a file on CPU
+/*! Only the part of the file, that corresponds to the buffer, is mapped into
+ * memory. Every task opens the file on its own, so that tasks of different
+ * tiles read in parallel without any shared state.
+ * */
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    const Index *offset;
+    const char *filename;
+    Config::unpack_args_ptr(cl_args, offset, filename);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    std::size_t size = interfaces[0]->elemsize;
+    char *data = interfaces[0]->get_ptr<char>();
+    // Map the file starting from a page boundary
+    int fd = open(filename, O_RDONLY);
+    if(fd == -1)
+    {
+        ++nfailed_tasks;
+        return;
+    }
+    Index page_size = sysconf(_SC_PAGESIZE);
+    Index shift = *offset % page_size;
+    void *map = mmap(nullptr, size+shift, PROT_READ, MAP_PRIVATE, fd,
+            *offset-shift);
+    close(fd);
+    if(map == MAP_FAILED)
+    {
+        ++nfailed_tasks;
+        return;
+    }
+    madvise(map, size+shift, MADV_SEQUENTIAL);
+    std::memcpy(data, reinterpret_cast<char *>(map)+shift, size);
+    munmap(map, size+shift);
+}
+
+Codelet codelet;
+
+void init()
+{
+    codelet.init("nntile_read_tile",
+            nullptr,
+            {cpu},
+            {}
+            );
+    codelet.nbuffers = 1;
+    codelet.modes[0] = STARPU_W;
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet.restore_where();
+}
+
+//! Insert task to read buffer from a file
+/*! @param[out] data: Buffer to read
+ * @param[in] filename: Name of the file
+ * @param[in] offset: Offset in bytes of the buffer in the file
+ * */
+void submit(Handle data, const std::string &filename, Index offset)
+{
+    // Pack codelet arguments in the same format as STARPU_VALUE does
+    std::size_t args_size;
+    void *args = args_pool::pack({
+            {&offset, sizeof(offset)},
+            {filename.c_str(), filename.size()+1}}, args_size);
+    // Submit task
+    int ret = task_insert(&codelet,
+            STARPU_CL_ARGS_NFREE, args, args_size,
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
+            STARPU_W, static_cast<starpu_data_handle_t>(data),
+            0);
+    // Check submission
+    args_pool::check_submit(ret, args, "Error in read_tile task submission");
+}
+
+//! Total number of read tasks, that failed
+Index nfailed()
+{
+    return nfailed_tasks.load();
+}
+
+} // namespace read_tile
+} // namespace starpu
+} // namespace nntile
+
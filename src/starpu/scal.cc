@@ -59,7 +59,7 @@ void cuda(void *buffers[], void *cl_args)
 }
 #endif // NNTILE_USE_CUDA
 
-Codelet codelet_fp32, codelet_fp64;
+Codelet codelet_fp32, codelet_fp64, codelet_bf16;
 
 void init()
 {
@@ -81,18 +81,25 @@ void init()
             {}
 #endif // NNTILE_USE_CUDA
             );
+    codelet_bf16.init("nntile_scal_bf16",
+            nullptr,
+            {cpu<bf16_t>},
+            {}
+            );
 }
 
 void restrict_where(uint32_t where)
 {
     codelet_fp32.restrict_where(where);
     codelet_fp64.restrict_where(where);
+    codelet_bf16.restrict_where(where);
 }
 
 void restore_where()
 {
     codelet_fp32.restore_where();
     codelet_fp64.restore_where();
+    codelet_bf16.restore_where();
 }
 
 template<typename T>
@@ -103,7 +110,8 @@ void submit(Index nelems, T alpha, Handle src, Handle dst)
  * throws an std::runtime_error() exception.
  * */
 {
-    constexpr T zero = 0.0;
+    using Y = compute_t<T>;
+    constexpr Y zero = 0.0;
     // if alpha is zero,sfunction reduces to clear
     if(alpha == zero)
     {
@@ -111,21 +119,19 @@ void submit(Index nelems, T alpha, Handle src, Handle dst)
         return;
     }
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
     args->nelems = nelems;
     args->alpha = alpha;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_W, static_cast<starpu_data_handle_t>(dst),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             // STARPU_FLOPS, nflops,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in scal task submission");
-    }
+    args_pool::check_submit(ret, args, "Error in scal task submission");
 }
 
 // Explicit instantiation
@@ -135,6 +141,9 @@ void submit<fp32_t>(Index nelems, fp32_t alpha, Handle src, Handle dst);
 template
 void submit<fp64_t>(Index nelems, fp64_t alpha, Handle src, Handle dst);
 
+template
+void submit<bf16_t>(Index nelems, bf16_t alpha, Handle src, Handle dst);
+
 } // namespace scal
 } // namespace starpu
 } // namespace nntile
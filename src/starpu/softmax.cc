@@ -78,7 +78,7 @@ uint32_t footprint(struct starpu_task *task)
     return hash;
 }
 
-Codelet codelet_fp32, codelet_fp64;
+Codelet codelet_fp32, codelet_fp64, codelet_bf16;
 
 void init()
 {
@@ -100,18 +100,25 @@ void init()
             {}
 #endif // NNTILE_USE_CUDA
             );
+    codelet_bf16.init("nntile_softmax_bf16",
+            footprint<bf16_t>,
+            {cpu<bf16_t>},
+            {}
+            );
 }
 
 void restrict_where(uint32_t where)
 {
     codelet_fp32.restrict_where(where);
     codelet_fp64.restrict_where(where);
+    codelet_bf16.restrict_where(where);
 }
 
 void restore_where()
 {
     codelet_fp32.restore_where();
     codelet_fp64.restore_where();
+    codelet_bf16.restore_where();
 }
 
 template<typename T>
@@ -124,24 +131,22 @@ void submit(Index m, Index n, Index k, Handle maxsumexp, Handle src, T alpha,
  * */
 {
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
     args->m = m;
     args->n = n;
     args->k = k;
     args->alpha = alpha;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(maxsumexp),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_W, static_cast<starpu_data_handle_t>(dst),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             //STARPU_FLOPS, nflops,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in softmax task submission");
-    }
+    args_pool::check_submit(ret, args, "Error in softmax task submission");
 }
 
 // Explicit instantiation
@@ -153,6 +158,10 @@ template
 void submit<fp64_t>(Index m, Index n, Index k, Handle maxsumexp, Handle src,
         fp64_t alpha, Handle dst);
 
+template
+void submit<bf16_t>(Index m, Index n, Index k, Handle maxsumexp, Handle src,
+        bf16_t alpha, Handle dst);
+
 } // namespace softmax
 } // namespace starpu
 } // namespace nntile
@@ -0,0 +1,175 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/sparse_adam_step.cc
+ * Lazy Adam step over marked rows of a matrix on StarPU buffers
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/starpu/sparse_adam_step.hh"
+#include "nntile/kernel/sparse_adam_step.hh"
+
+namespace nntile
+{
+namespace starpu
+{
+namespace sparse_adam_step
+{
+
+//! Lazy Adam step over marked rows of StarPU buffers on CPU
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const bool_t *rows = interfaces[0]->get_ptr<bool_t>();
+    Index *row_step = interfaces[1]->get_ptr<Index>();
+    const T *grad = interfaces[2]->get_ptr<T>();
+    T *first_moment = interfaces[3]->get_ptr<T>();
+    T *second_moment = interfaces[4]->get_ptr<T>();
+    T *p = interfaces[5]->get_ptr<T>();
+    // Launch kernel
+    kernel::sparse_adam_step::cpu<T>(args->m, args->n, args->beta_1,
+            args->beta_2, args->eps, args->lr, args->weight_decay,
+            args->decoupled, rows, row_step, grad, first_moment,
+            second_moment, p);
+}
+
+#ifdef NNTILE_USE_CUDA
+//! Lazy Adam step over marked rows of StarPU buffers on CUDA
+template<typename T>
+void cuda(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(cl_args);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const bool_t *rows = interfaces[0]->get_ptr<bool_t>();
+    Index *row_step = interfaces[1]->get_ptr<Index>();
+    const T *grad = interfaces[2]->get_ptr<T>();
+    T *first_moment = interfaces[3]->get_ptr<T>();
+    T *second_moment = interfaces[4]->get_ptr<T>();
+    T *p = interfaces[5]->get_ptr<T>();
+    // Get CUDA stream
+    cudaStream_t stream = starpu_cuda_get_local_stream();
+    // Launch kernel
+    kernel::sparse_adam_step::cuda<T>(stream, args->m, args->n,
+            args->beta_1, args->beta_2, args->eps, args->lr,
+            args->weight_decay, args->decoupled, rows, row_step, grad,
+            first_moment, second_moment, p);
+}
+#endif // NNTILE_USE_CUDA
+
+//! Footprint for sparse_adam_step tasks
+template<typename T>
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    auto args = reinterpret_cast<args_t<T> *>(task->cl_arg);
+    // Apply hash over parameters m and n
+    uint32_t hash = 0;
+    hash = starpu_hash_crc32c_be_n(&args->m, sizeof(args->m), hash);
+    hash = starpu_hash_crc32c_be_n(&args->n, sizeof(args->n), hash);
+    return hash;
+}
+
+Codelet codelet_fp32, codelet_fp64;
+
+void init()
+{
+    codelet_fp32.init("nntile_sparse_adam_step_fp32",
+            footprint<fp32_t>,
+            {cpu<fp32_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp32_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+    codelet_fp64.init("nntile_sparse_adam_step_fp64",
+            footprint<fp64_t>,
+            {cpu<fp64_t>},
+#ifdef NNTILE_USE_CUDA
+            {cuda<fp64_t>}
+#else // NNTILE_USE_CUDA
+            {}
+#endif // NNTILE_USE_CUDA
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+}
+
+template<typename T>
+void submit(Index m, Index n, T beta_1, T beta_2, T eps, T lr,
+        T weight_decay, int decoupled, Handle rows, Handle row_step,
+        Handle grad, Handle first_moment, Handle second_moment, Handle p)
+//! Insert sparse_adam_step task into StarPU pool of tasks
+/*! No argument checking is performed. All the inputs are packed and passed to
+ * starpu_task_insert() function. If task submission fails, this routines
+ * throws an std::runtime_error() exception.
+ * */
+{
+    // Codelet arguments
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
+    args->m = m;
+    args->n = n;
+    args->beta_1 = beta_1;
+    args->beta_2 = beta_2;
+    args->eps = eps;
+    args->lr = lr;
+    args->weight_decay = weight_decay;
+    args->decoupled = decoupled;
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_R, static_cast<starpu_data_handle_t>(rows),
+            STARPU_RW, static_cast<starpu_data_handle_t>(row_step),
+            STARPU_R, static_cast<starpu_data_handle_t>(grad),
+            STARPU_RW, static_cast<starpu_data_handle_t>(first_moment),
+            STARPU_RW, static_cast<starpu_data_handle_t>(second_moment),
+            STARPU_RW, static_cast<starpu_data_handle_t>(p),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
+            0);
+    // Check submission
+    args_pool::check_submit(ret, args,
+            "Error in sparse_adam_step task submission");
+}
+
+// Explicit instantiaion
+template
+void submit<fp32_t>(Index m, Index n, fp32_t beta_1, fp32_t beta_2,
+        fp32_t eps, fp32_t lr, fp32_t weight_decay, int decoupled,
+        Handle rows, Handle row_step, Handle grad, Handle first_moment,
+        Handle second_moment, Handle p);
+
+template
+void submit<fp64_t>(Index m, Index n, fp64_t beta_1, fp64_t beta_2,
+        fp64_t eps, fp64_t lr, fp64_t weight_decay, int decoupled,
+        Handle rows, Handle row_step, Handle grad, Handle first_moment,
+        Handle second_moment, Handle p);
+
+} // namespace sparse_adam_step
+} // namespace starpu
+} // namespace nntile
+
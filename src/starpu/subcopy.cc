@@ -116,24 +116,26 @@ void submit(Index ndim, const std::vector<Index> &src_start,
         Handle tmp_index, starpu_data_access_mode mode)
 {
     constexpr fp64_t zero_flops = 0;
+    // Pack codelet arguments in the same format as STARPU_VALUE does
+    std::size_t args_size;
+    void *args = args_pool::pack({
+            {&ndim, sizeof(ndim)},
+            {&src_start[0], ndim*sizeof(src_start[0])},
+            {&src_stride[0], ndim*sizeof(src_stride[0])},
+            {&copy_shape[0], ndim*sizeof(copy_shape[0])},
+            {&dst_start[0], ndim*sizeof(dst_start[0])},
+            {&dst_stride[0], ndim*sizeof(dst_stride[0])}}, args_size);
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
-            STARPU_VALUE, &(ndim), sizeof(ndim),
-            STARPU_VALUE, &(src_start[0]), ndim*sizeof(src_start[0]),
-            STARPU_VALUE, &(src_stride[0]), ndim*sizeof(src_stride[0]),
-            STARPU_VALUE, &(copy_shape[0]), ndim*sizeof(copy_shape[0]),
-            STARPU_VALUE, &(dst_start[0]), ndim*sizeof(dst_start[0]),
-            STARPU_VALUE, &(dst_stride[0]), ndim*sizeof(dst_stride[0]),
+    int ret = task_insert(codelet<T>(),
+            STARPU_CL_ARGS_NFREE, args, args_size,
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             mode, static_cast<starpu_data_handle_t>(dst),
             STARPU_SCRATCH, static_cast<starpu_data_handle_t>(tmp_index),
             STARPU_FLOPS, zero_flops, // No floating point operations
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in subcopy task submission");
-    }
+    args_pool::check_submit(ret, args, "Error in subcopy task submission");
 }
 
 // Explicit instantiation
@@ -0,0 +1,174 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/submit_bench.cc
+ * Benchmark of task submission throughput with different codelet arguments
+ *
+ * Usage: nntile.starpu.submit-bench [ntasks [ncpus]]
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-07
+ * */
+
+#include "nntile/starpu/config.hh"
+#include "nntile/starpu/fill.hh"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <thread>
+#include <vector>
+
+using namespace nntile;
+using namespace nntile::starpu;
+
+using clock_type = std::chrono::steady_clock;
+
+double seconds_since(clock_type::time_point start)
+{
+    std::chrono::duration<double> time = clock_type::now() - start;
+    return time.count();
+}
+
+// Arguments are allocated by one thread and freed by another one, as it
+// happens with submitting thread and StarPU workers
+double alloc_handover(Index nallocs, const std::function<void *()> &alloc,
+        const std::function<void(void *)> &release)
+{
+    constexpr Index ring_size = 1024;
+    std::vector<std::atomic<void *>> ring(ring_size);
+    for(auto &slot: ring)
+    {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+    std::thread consumer([&]()
+    {
+        for(Index i = 0; i < nallocs; ++i)
+        {
+            auto &slot = ring[i%ring_size];
+            void *ptr;
+            while((ptr = slot.exchange(nullptr, std::memory_order_acquire))
+                    == nullptr)
+            {
+                std::this_thread::yield();
+            }
+            release(ptr);
+        }
+    });
+    auto start = clock_type::now();
+    for(Index i = 0; i < nallocs; ++i)
+    {
+        void *ptr = alloc();
+        auto &slot = ring[i%ring_size];
+        while(slot.load(std::memory_order_relaxed) != nullptr)
+        {
+            std::this_thread::yield();
+        }
+        slot.store(ptr, std::memory_order_release);
+    }
+    consumer.join();
+    return seconds_since(start);
+}
+
+// Submit tasks round-robin over small buffers and return time of submission
+// and total time till completion
+template<typename F>
+void submit_tasks(Index ntasks, std::vector<VariableHandle> &handles,
+        F &&submit, double &submit_time, double &total_time)
+{
+    auto start = clock_type::now();
+    for(Index i = 0; i < ntasks; ++i)
+    {
+        submit(handles[i%handles.size()]);
+    }
+    submit_time = seconds_since(start);
+    starpu_task_wait_for_all();
+    total_time = seconds_since(start);
+}
+
+int main(int argc, char **argv)
+{
+    Index ntasks = 100000;
+    int ncpus = -1;
+    if(argc > 1)
+    {
+        ntasks = std::atol(argv[1]);
+    }
+    if(argc > 2)
+    {
+        ncpus = std::atoi(argv[2]);
+    }
+    // Allocator alone
+    std::printf("# %-22s %14s\n", "allocator", "M allocs/s");
+    constexpr std::size_t args_size = sizeof(fill::args_t<fp32_t>);
+    double time = alloc_handover(ntasks,
+            [](){return std::malloc(args_size);}, std::free);
+    std::printf("%-24s %14.3f\n", "malloc+free", 1e-6*ntasks/time);
+    time = alloc_handover(ntasks,
+            [](){return args_pool::alloc(args_size);}, args_pool::release);
+    std::printf("%-24s %14.3f\n", "args_pool", 1e-6*ntasks/time);
+    // Actual task submission
+    Config starpu(ncpus, 0, 0);
+    fill::init();
+    fill::restrict_where(STARPU_CPU);
+    constexpr Index nelems = 16, nhandles = 256;
+    std::vector<fp32_t> data(nelems*nhandles);
+    std::vector<VariableHandle> handles;
+    for(Index i = 0; i < nhandles; ++i)
+    {
+        handles.emplace_back(&data[i*nelems], nelems*sizeof(fp32_t),
+                STARPU_RW);
+    }
+    std::printf("# %d CPU workers, %ld tasks on %ld buffers of %ld floats\n",
+            starpu_worker_get_count(), ntasks, nhandles, nelems);
+    std::printf("# %-22s %14s %14s\n", "arguments", "submit Ktask/s",
+            "total Ktask/s");
+    struct Case
+    {
+        const char *name;
+        std::function<void(VariableHandle &)> submit;
+    };
+    std::vector<Case> cases = {
+        // Arguments are allocated with std::malloc and freed by StarPU
+        {"STARPU_CL_ARGS", [](VariableHandle &handle)
+            {
+                auto args = static_cast<fill::args_t<fp32_t> *>(
+                        std::malloc(args_size));
+                args->nelems = nelems;
+                args->val = 1;
+                int ret = starpu_task_insert(fill::codelet<fp32_t>(),
+                        STARPU_W, static_cast<starpu_data_handle_t>(handle),
+                        STARPU_CL_ARGS, args, args_size,
+                        0);
+                if(ret != 0)
+                {
+                    throw std::runtime_error("Error in task submission");
+                }
+            }},
+        // Arguments are taken from the pool, as fill::submit does
+        {"args_pool", [](VariableHandle &handle)
+            {
+                fill::submit<fp32_t>(nelems, 1, handle);
+            }},
+    };
+    for(const auto &c: cases)
+    {
+        double submit_time, total_time;
+        // Warm up StarPU and pools
+        submit_tasks(ntasks/10, handles, c.submit, submit_time, total_time);
+        submit_tasks(ntasks, handles, c.submit, submit_time, total_time);
+        std::printf("%-24s %14.1f %14.1f\n", c.name,
+                1e-3*ntasks/submit_time, 1e-3*ntasks/total_time);
+    }
+    for(auto &handle: handles)
+    {
+        handle.unregister();
+    }
+    return 0;
+}
+
@@ -120,24 +120,22 @@ template<typename T>
 void submit(Index n_labels, Index n_outputs, T val, Handle labels, Handle dst)
 {
     // Codelet arguments
-    args_t<T>* args = (args_t<T>*)malloc(sizeof(args_t<T>));
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
     args->n_labels = n_labels;
     args->n_outputs = n_outputs;
     args->value = val;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(labels),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             STARPU_RW, static_cast<starpu_data_handle_t>(dst),
             //Config::STARPU_RW_COMMUTE, static_cast<starpu_data_handle_t>(dst),
             //STARPU_FLOPS, nflops,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in subtract_indexed_outputs task "
-                "submission");
-    }
+    args_pool::check_submit(ret, args,
+            "Error in subtract_indexed_outputs task submission");
 }
 
 // Explicit instantiation
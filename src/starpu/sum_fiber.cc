@@ -144,7 +144,7 @@ void submit(Index m, Index n, Index k, Index batch, T alpha, Handle src,
         dst_mode = STARPU_RW;
     }
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
     args->m = m;
     args->n = n;
     args->k = k;
@@ -152,16 +152,14 @@ void submit(Index m, Index n, Index k, Index batch, T alpha, Handle src,
     args->alpha = alpha;
     args->beta = beta;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             dst_mode, static_cast<starpu_data_handle_t>(dst),
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in sum_fiber task submission");
-    }
+    args_pool::check_submit(ret, args, "Error in sum_fiber task submission");
 }
 
 // Explicit instantiation
@@ -117,25 +117,23 @@ void submit(Index m, Index n, Index k, Handle src, Handle dst)
  * */
 {
     // Codelet arguments
-    auto args = new args_t
-    {
-        .m = m,
-        .n = n,
-        .k = k
-    };
+    auto args = args_pool::alloc<args_t>(args_t
+        {
+            .m = m,
+            .n = n,
+            .k = k
+        });
     //fp64_t nflops = m * n * k;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             Config::STARPU_RW_COMMUTE, static_cast<starpu_data_handle_t>(dst),
             //STARPU_FLOPS, nflops,
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in sumnorm task submission");
-    }
+    args_pool::check_submit(ret, args, "Error in sumnorm task submission");
 }
 
 // Explicit instantiation
@@ -146,7 +146,7 @@ void submit(Index m, Index n, Index k, T alpha, Handle src1, Handle src2,
         dst_mode = STARPU_RW;
     }
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
     args->m = m;
     args->n = n;
     args->k = k;
@@ -154,18 +154,17 @@ void submit(Index m, Index n, Index k, T alpha, Handle src1, Handle src2,
     args->beta = beta;
     fp64_t nflops = k * (2*m*n);
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
         STARPU_R, static_cast<starpu_data_handle_t>(src1),
         STARPU_R, static_cast<starpu_data_handle_t>(src2),
-        STARPU_CL_ARGS, args, sizeof(*args),
+        STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+        STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
         dst_mode, static_cast<starpu_data_handle_t>(dst),
         STARPU_FLOPS, nflops,
         0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in sumprod_fiber task submission");
-    }
+    args_pool::check_submit(ret, args,
+            "Error in sumprod_fiber task submission");
 }
 
 // Explicit instantiation
@@ -0,0 +1,297 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/task_graph.cc
+ * Capture of submitted StarPU tasks and their later replay
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-11
+ * */
+
+#include "nntile/starpu/task_graph.hh"
+#include "nntile/starpu/config.hh"
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+namespace nntile
+{
+namespace starpu
+{
+
+thread_local TaskGraph *TaskGraph::capturing_graph = nullptr;
+
+//! Callback of a replayed task
+void TaskGraph::_task_done(void *graph)
+{
+    reinterpret_cast<TaskGraph *>(graph)->ninflight.fetch_sub(1,
+            std::memory_order_release);
+}
+
+TaskGraph::~TaskGraph()
+{
+    if(capturing_graph == this)
+    {
+        capturing_graph = nullptr;
+    }
+    clear();
+}
+
+void TaskGraph::begin_capture()
+{
+    if(capturing_graph != nullptr)
+    {
+        throw std::runtime_error("Another task graph is being captured");
+    }
+    if(starpu_mpi_world_size() != 1)
+    {
+        throw std::runtime_error("Task graph capture is not supported for "
+                "several MPI processes");
+    }
+    clear();
+    capturing_graph = this;
+}
+
+void TaskGraph::end_capture()
+{
+    if(capturing_graph != this)
+    {
+        throw std::runtime_error("Task graph is not being captured");
+    }
+    capturing_graph = nullptr;
+}
+
+void TaskGraph::clear()
+{
+    // Recorded arguments may still be read by replayed tasks
+    while(ninflight.load(std::memory_order_acquire) > 0)
+    {
+        std::this_thread::yield();
+    }
+    ops.clear();
+    handles.clear();
+    modes.clear();
+    args.clear();
+    substitutions.clear();
+    for(auto handle: kept_handles)
+    {
+        starpu_data_unregister_submit(handle);
+    }
+    kept_handles.clear();
+    broken = false;
+}
+
+void TaskGraph::substitute(starpu_data_handle_t from, starpu_data_handle_t to)
+{
+    if(from == to)
+    {
+        substitutions.erase(from);
+    }
+    else
+    {
+        substitutions[from] = to;
+    }
+}
+
+starpu_data_handle_t TaskGraph::_substitute(starpu_data_handle_t handle)
+    const
+{
+    auto it = substitutions.find(handle);
+    if(it == substitutions.end())
+    {
+        return handle;
+    }
+    return it->second;
+}
+
+void TaskGraph::record(starpu_task *task)
+{
+    Op op;
+    op.kind = OpKind::task;
+    op.cl = task->cl;
+    op.handle_offset = handles.size();
+    op.nbuffers = STARPU_TASK_GET_NBUFFERS(task);
+    for(Index i = 0; i < op.nbuffers; ++i)
+    {
+        handles.push_back(STARPU_TASK_GET_HANDLE(task, i));
+        modes.push_back(STARPU_TASK_GET_MODE(task, i));
+    }
+    // Arguments of the task are freed after its execution, so they are
+    // copied
+    op.args_offset = args.size();
+    op.args_size = task->cl_arg_size;
+    if(task->cl_arg != nullptr and op.args_size > 0)
+    {
+        constexpr std::size_t align = sizeof(std::max_align_t);
+        args.resize(op.args_offset + (op.args_size+align-1)/align);
+        std::memcpy(&args[op.args_offset], task->cl_arg, op.args_size);
+    }
+    else
+    {
+        op.args_size = 0;
+    }
+    op.flops = task->flops;
+    op.priority = task->priority;
+    op.where = task->where;
+    op.execute_on_a_specific_worker = task->execute_on_a_specific_worker;
+    op.workerid = task->workerid;
+    ops.push_back(op);
+}
+
+void TaskGraph::record_data_cpy(starpu_data_handle_t dst,
+        starpu_data_handle_t src)
+{
+    Op op;
+    op.kind = OpKind::data_cpy;
+    op.cl = nullptr;
+    op.handle_offset = handles.size();
+    op.nbuffers = 2;
+    handles.push_back(dst);
+    modes.push_back(STARPU_W);
+    handles.push_back(src);
+    modes.push_back(STARPU_R);
+    op.args_offset = args.size();
+    op.args_size = 0;
+    op.flops = 0;
+    op.priority = 0;
+    op.where = -1;
+    op.execute_on_a_specific_worker = 0;
+    op.workerid = 0;
+    ops.push_back(op);
+}
+
+void TaskGraph::keep(starpu_data_handle_t handle)
+{
+    kept_handles.push_back(handle);
+}
+
+void TaskGraph::forget(starpu_data_handle_t handle)
+{
+    if(std::find(handles.begin(), handles.end(), handle) != handles.end())
+    {
+        broken = true;
+    }
+}
+
+void TaskGraph::replay()
+{
+    if(capturing_graph == this)
+    {
+        throw std::runtime_error("Task graph is being captured");
+    }
+    if(broken)
+    {
+        throw std::runtime_error("Task graph uses a data handle, that was "
+                "unregistered during capture");
+    }
+    bool substitute = !substitutions.empty();
+    for(const auto &op: ops)
+    {
+        const starpu_data_handle_t *op_handles = &handles[op.handle_offset];
+        const starpu_data_access_mode *op_modes = &modes[op.handle_offset];
+        int ret;
+        ninflight.fetch_add(1, std::memory_order_relaxed);
+        if(op.kind == OpKind::data_cpy)
+        {
+            starpu_data_handle_t dst = op_handles[0], src = op_handles[1];
+            if(substitute)
+            {
+                dst = _substitute(dst);
+                src = _substitute(src);
+            }
+            ret = starpu_data_cpy(dst, src, 1, _task_done, this);
+        }
+        else
+        {
+            starpu_task *task = starpu_task_create();
+            task->cl = op.cl;
+            task->nbuffers = op.nbuffers;
+            if(op.nbuffers > STARPU_NMAXBUFS)
+            {
+                // Freed by StarPU together with the task
+                task->dyn_handles = static_cast<starpu_data_handle_t *>(
+                        std::malloc(op.nbuffers*sizeof(*task->dyn_handles)));
+                task->dyn_modes = static_cast<starpu_data_access_mode *>(
+                        std::malloc(op.nbuffers*sizeof(*task->dyn_modes)));
+            }
+            for(Index i = 0; i < op.nbuffers; ++i)
+            {
+                starpu_data_handle_t handle = op_handles[i];
+                if(substitute)
+                {
+                    handle = _substitute(handle);
+                }
+                STARPU_TASK_SET_HANDLE(task, handle, i);
+                STARPU_TASK_SET_MODE(task, op_modes[i], i);
+            }
+            // Recorded arguments are shared by all replays
+            if(op.args_size > 0)
+            {
+                task->cl_arg = &args[op.args_offset];
+                task->cl_arg_size = op.args_size;
+            }
+            task->cl_arg_free = 0;
+            task->flops = op.flops;
+            task->priority = op.priority;
+            task->where = op.where;
+            task->execute_on_a_specific_worker =
+                op.execute_on_a_specific_worker;
+            task->workerid = op.workerid;
+            task->callback_func = _task_done;
+            task->callback_arg = this;
+            Tracer *tracer = Tracer::active();
+            if(tracer != nullptr)
+            {
+                tracer->trace(task);
+            }
+            ret = starpu_task_submit(task);
+            if(ret != 0 and tracer != nullptr)
+            {
+                tracer->cancel(task);
+            }
+        }
+        if(ret != 0)
+        {
+            ninflight.fetch_sub(1, std::memory_order_relaxed);
+            throw std::runtime_error("Error in replay of a task graph");
+        }
+    }
+}
+
+int task_submit(starpu_task *task)
+{
+    TaskGraph *graph = TaskGraph::capturing();
+    if(graph != nullptr)
+    {
+        graph->record(task);
+    }
+    Tracer *tracer = Tracer::active();
+    if(tracer != nullptr)
+    {
+        tracer->trace(task);
+    }
+    int ret = starpu_task_submit(task);
+    if(ret != 0 and tracer != nullptr)
+    {
+        tracer->cancel(task);
+    }
+    return ret;
+}
+
+int data_cpy(starpu_data_handle_t dst, starpu_data_handle_t src)
+{
+    TaskGraph *graph = TaskGraph::capturing();
+    if(graph != nullptr)
+    {
+        graph->record_data_cpy(dst, src);
+    }
+    return starpu_data_cpy(dst, src, 1, nullptr, nullptr);
+}
+
+} // namespace starpu
+} // namespace nntile
+
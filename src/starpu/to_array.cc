@@ -0,0 +1,234 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/to_array.cc
+ * Copy a StarPU buffer into a subarray of a contiguous host array
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-12
+ * */
+
+#include "nntile/starpu/to_array.hh"
+#include "nntile/kernel/subcopy.hh"
+
+namespace nntile
+{
+namespace starpu
+{
+namespace to_array
+{
+
+//! Copying into a host array is available only on CPU
+/*! The host array is not registered in StarPU, only its pointer is passed
+ * through codelet arguments. This way several tasks write different parts of
+ * the same array in parallel.
+ * */
+template<typename T>
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    const Index *ndim_ptr, *array_start, *array_stride, *tile_shape,
+          *tile_stride;
+    T * const *array_ptr;
+    Config::unpack_args_ptr(cl_args, ndim_ptr, array_ptr, array_start,
+            array_stride, tile_shape, tile_stride);
+    Index ndim = *ndim_ptr;
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    const T *tile = interfaces[0]->get_ptr<T>();
+    // Scratch buffer holds start of the tile and indices for the kernel
+    Index *tile_start = interfaces[1]->get_ptr<Index>();
+    for(Index i = 0; i < ndim; ++i)
+    {
+        tile_start[i] = 0;
+    }
+    // Launch kernel
+    kernel::subcopy::cpu<T>(ndim, tile_start, tile_stride, tile_shape, tile,
+            array_start, array_stride, *array_ptr, tile_start+ndim);
+}
+
+//! Footprint for copy tasks that depend on shape of the tile
+static
+uint32_t footprint(struct starpu_task *task)
+{
+    // Get arguments
+    const Index *ndim_ptr, *array_start, *array_stride, *tile_shape;
+    const void *array_ptr;
+    Config::unpack_args_ptr(task->cl_arg, ndim_ptr, array_ptr, array_start,
+            array_stride, tile_shape);
+    std::size_t tile_shape_size = *ndim_ptr * sizeof(*tile_shape);
+    // Apply hash over parameter tile_shape
+    return starpu_hash_crc32c_be_n(tile_shape, tile_shape_size, 0);
+}
+
+Codelet codelet_fp16, codelet_bf16, codelet_fp32, codelet_fp64,
+        codelet_int64, codelet_bool, codelet_int8;
+
+void init()
+{
+    codelet_fp16.init("nntile_to_array_fp16",
+            footprint,
+            {cpu<fp16_t>},
+            {}
+            );
+    codelet_bf16.init("nntile_to_array_bf16",
+            footprint,
+            {cpu<bf16_t>},
+            {}
+            );
+    codelet_fp32.init("nntile_to_array_fp32",
+            footprint,
+            {cpu<fp32_t>},
+            {}
+            );
+    codelet_fp64.init("nntile_to_array_fp64",
+            footprint,
+            {cpu<fp64_t>},
+            {}
+            );
+    codelet_int64.init("nntile_to_array_int64",
+            footprint,
+            {cpu<Index>},
+            {}
+            );
+    codelet_bool.init("nntile_to_array_bool",
+            footprint,
+            {cpu<bool_t>},
+            {}
+            );
+    codelet_int8.init("nntile_to_array_int8",
+            footprint,
+            {cpu<int8_t>},
+            {}
+            );
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet_fp16.restrict_where(where);
+    codelet_bf16.restrict_where(where);
+    codelet_fp32.restrict_where(where);
+    codelet_fp64.restrict_where(where);
+    codelet_int64.restrict_where(where);
+    codelet_bool.restrict_where(where);
+    codelet_int8.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet_fp16.restore_where();
+    codelet_bf16.restore_where();
+    codelet_fp32.restore_where();
+    codelet_fp64.restore_where();
+    codelet_int64.restore_where();
+    codelet_bool.restore_where();
+    codelet_int8.restore_where();
+}
+
+//! Submit a copy of a tile into a subarray of a host array
+/*! The host array must stay alive until the task is finished.
+ *
+ * @param[in] ndim: Dimensionality of the array and of the tile
+ * @param[inout] array: Pointer to the host array
+ * @param[in] array_start: Coordinates of the first copied element of array
+ * @param[in] array_stride: Strides of the host array
+ * @param[in] tile_shape: Shape of the tile
+ * @param[in] tile_stride: Strides of the tile
+ * @param[in] tile: Handle of the tile
+ * @param[in] tmp_index: Scratch handle for 3*ndim indices
+ * */
+template<typename T>
+void submit(Index ndim, T *array, const std::vector<Index> &array_start,
+        const std::vector<Index> &array_stride,
+        const std::vector<Index> &tile_shape,
+        const std::vector<Index> &tile_stride, Handle tile,
+        Handle tmp_index)
+{
+    constexpr fp64_t zero_flops = 0;
+    // Pack codelet arguments in the same format as STARPU_VALUE does
+    std::size_t args_size;
+    void *args = args_pool::pack({
+            {&ndim, sizeof(ndim)},
+            {&array, sizeof(array)},
+            {array_start.data(), ndim*sizeof(array_start[0])},
+            {array_stride.data(), ndim*sizeof(array_stride[0])},
+            {tile_shape.data(), ndim*sizeof(tile_shape[0])},
+            {tile_stride.data(), ndim*sizeof(tile_stride[0])}}, args_size);
+    // Submit task
+    int ret = task_insert(codelet<T>(),
+            STARPU_CL_ARGS_NFREE, args, args_size,
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
+            STARPU_R, static_cast<starpu_data_handle_t>(tile),
+            STARPU_SCRATCH, static_cast<starpu_data_handle_t>(tmp_index),
+            STARPU_FLOPS, zero_flops, // No floating point operations
+            0);
+    // Check submission
+    args_pool::check_submit(ret, args, "Error in to_array task submission");
+}
+
+// Explicit instantiation
+template
+void submit<fp16_t>(Index ndim, fp16_t *array,
+        const std::vector<Index> &array_start,
+        const std::vector<Index> &array_stride,
+        const std::vector<Index> &tile_shape,
+        const std::vector<Index> &tile_stride, Handle tile,
+        Handle tmp_index);
+
+template
+void submit<bf16_t>(Index ndim, bf16_t *array,
+        const std::vector<Index> &array_start,
+        const std::vector<Index> &array_stride,
+        const std::vector<Index> &tile_shape,
+        const std::vector<Index> &tile_stride, Handle tile,
+        Handle tmp_index);
+
+template
+void submit<fp32_t>(Index ndim, fp32_t *array,
+        const std::vector<Index> &array_start,
+        const std::vector<Index> &array_stride,
+        const std::vector<Index> &tile_shape,
+        const std::vector<Index> &tile_stride, Handle tile,
+        Handle tmp_index);
+
+template
+void submit<fp64_t>(Index ndim, fp64_t *array,
+        const std::vector<Index> &array_start,
+        const std::vector<Index> &array_stride,
+        const std::vector<Index> &tile_shape,
+        const std::vector<Index> &tile_stride, Handle tile,
+        Handle tmp_index);
+
+template
+void submit<Index>(Index ndim, Index *array,
+        const std::vector<Index> &array_start,
+        const std::vector<Index> &array_stride,
+        const std::vector<Index> &tile_shape,
+        const std::vector<Index> &tile_stride, Handle tile,
+        Handle tmp_index);
+
+template
+void submit<bool_t>(Index ndim, bool_t *array,
+        const std::vector<Index> &array_start,
+        const std::vector<Index> &array_stride,
+        const std::vector<Index> &tile_shape,
+        const std::vector<Index> &tile_stride, Handle tile,
+        Handle tmp_index);
+
+template
+void submit<int8_t>(Index ndim, int8_t *array,
+        const std::vector<Index> &array_start,
+        const std::vector<Index> &array_stride,
+        const std::vector<Index> &tile_shape,
+        const std::vector<Index> &tile_stride, Handle tile,
+        Handle tmp_index);
+
+} // namespace to_array
+} // namespace starpu
+} // namespace nntile
+
@@ -125,23 +125,22 @@ void submit(T alpha, Index n_labels, Index n_outputs, Handle logsumexp, Handle s
         Handle class_labels, Handle val)
 {
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
     args->alpha = alpha;
     args->n_labels = n_labels;
     args->n_outputs = n_outputs;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(logsumexp),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_R, static_cast<starpu_data_handle_t>(class_labels),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             STARPU_RW | STARPU_COMMUTE, static_cast<starpu_data_handle_t>(val),
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in total_sum_accum task submission");
-    }
+    args_pool::check_submit(ret, args,
+            "Error in total_sum_accum task submission");
 }
 
 // Explicit instantiation
@@ -0,0 +1,354 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/tracer.cc
+ * Lightweight tracer of StarPU tasks with Chrome/Perfetto JSON output
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/starpu/tracer.hh"
+#include "nntile/starpu/config.hh"
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace nntile
+{
+namespace starpu
+{
+
+std::atomic<Tracer *> Tracer::active_tracer{nullptr};
+
+//! Write a string as a JSON string literal
+static void _json_string(std::ostream &out, const std::string &str)
+{
+    out << '"';
+    for(char c: str)
+    {
+        if(c == '"' or c == '\\')
+        {
+            out << '\\' << c;
+        }
+        else if(static_cast<unsigned char>(c) < 0x20)
+        {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                << static_cast<int>(c) << std::dec << std::setfill(' ');
+        }
+        else
+        {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+//! Short name of a data access mode
+static const char *_mode_name(starpu_data_access_mode mode)
+{
+    if(mode & STARPU_REDUX)
+    {
+        return "REDUX";
+    }
+    if(mode & STARPU_SCRATCH)
+    {
+        return "SCRATCH";
+    }
+    if((mode & STARPU_RW) == STARPU_RW)
+    {
+        return "RW";
+    }
+    if(mode & STARPU_W)
+    {
+        return "W";
+    }
+    return "R";
+}
+
+Tracer::Tracer():
+    time0(0),
+    prev_profiling(STARPU_PROFILING_DISABLE)
+{
+    // The root scope has an empty path
+    scopes.emplace_back();
+    scope_ids[scopes[0]] = 0;
+}
+
+Tracer::~Tracer()
+{
+    if(active() == this)
+    {
+        stop();
+    }
+    _wait();
+}
+
+void Tracer::_wait()
+{
+    while(ninflight.load(std::memory_order_acquire) > 0)
+    {
+        std::this_thread::yield();
+    }
+}
+
+void Tracer::start()
+{
+    if(active() != nullptr)
+    {
+        throw std::runtime_error("Another tracer is active");
+    }
+    if(events.empty())
+    {
+        time0 = starpu_timing_now();
+    }
+    prev_profiling = starpu_profiling_status_get();
+    starpu_profiling_status_set(STARPU_PROFILING_ENABLE);
+    Tracer *expected = nullptr;
+    if(!active_tracer.compare_exchange_strong(expected, this,
+                std::memory_order_acq_rel))
+    {
+        starpu_profiling_status_set(prev_profiling);
+        throw std::runtime_error("Another tracer is active");
+    }
+}
+
+void Tracer::stop()
+{
+    Tracer *expected = this;
+    if(!active_tracer.compare_exchange_strong(expected, nullptr,
+                std::memory_order_acq_rel))
+    {
+        throw std::runtime_error("Tracer is not active");
+    }
+    starpu_profiling_status_set(prev_profiling);
+}
+
+void Tracer::clear()
+{
+    _wait();
+    events.clear();
+    time0 = starpu_timing_now();
+}
+
+void Tracer::push_scope(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &thread_scope = thread_scopes[std::this_thread::get_id()];
+    thread_scope.stack.push_back(name);
+    std::string path = scopes[thread_scope.current];
+    if(!path.empty())
+    {
+        path += "/";
+    }
+    path += name;
+    auto it = scope_ids.find(path);
+    if(it == scope_ids.end())
+    {
+        thread_scope.current = scopes.size();
+        scope_ids[path] = thread_scope.current;
+        scopes.push_back(path);
+    }
+    else
+    {
+        thread_scope.current = it->second;
+    }
+}
+
+void Tracer::pop_scope()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = thread_scopes.find(std::this_thread::get_id());
+    if(it == thread_scopes.end() or it->second.stack.empty())
+    {
+        throw std::runtime_error("No scope to pop");
+    }
+    auto &thread_scope = it->second;
+    thread_scope.stack.pop_back();
+    // Path of the parent scope is a prefix of the current one
+    std::string path;
+    for(const auto &name: thread_scope.stack)
+    {
+        if(!path.empty())
+        {
+            path += "/";
+        }
+        path += name;
+    }
+    thread_scope.current = scope_ids[path];
+}
+
+void Tracer::trace(starpu_task *task)
+{
+    Event event;
+    event.name = task->cl != nullptr ? task->cl->name : nullptr;
+    event.workerid = -1;
+    event.submit = starpu_timing_now() - time0;
+    event.start = event.end = -1;
+    std::ostringstream tiles;
+    Index nbuffers = STARPU_TASK_GET_NBUFFERS(task);
+    for(Index i = 0; i < nbuffers; ++i)
+    {
+        starpu_data_handle_t handle = STARPU_TASK_GET_HANDLE(task, i);
+        if(i > 0)
+        {
+            tiles << " ";
+        }
+        tiles << _mode_name(STARPU_TASK_GET_MODE(task, i)) << ":";
+        // Tiles of tensors are identified by their MPI tags
+#ifdef NNTILE_USE_MPI
+        tiles << starpu_mpi_data_get_tag(handle);
+#else // NNTILE_USE_MPI
+        tiles << handle;
+#endif // NNTILE_USE_MPI
+    }
+    event.tiles = tiles.str();
+    auto *pending = new Pending;
+    pending->tracer = this;
+    pending->callback_func = task->callback_func;
+    pending->callback_arg = task->callback_arg;
+    pending->callback_arg_free = task->callback_arg_free;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // Threads without scopes submit into the root scope
+        auto it = thread_scopes.find(std::this_thread::get_id());
+        event.scope = it != thread_scopes.end() ? it->second.current : 0;
+        pending->event = events.size();
+        events.push_back(std::move(event));
+    }
+    task->callback_func = _task_done;
+    task->callback_arg = pending;
+    task->callback_arg_free = 0;
+    ninflight.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Tracer::cancel(starpu_task *task)
+{
+    auto *pending = reinterpret_cast<Pending *>(task->callback_arg);
+    task->callback_func = pending->callback_func;
+    task->callback_arg = pending->callback_arg;
+    task->callback_arg_free = pending->callback_arg_free;
+    delete pending;
+    ninflight.fetch_sub(1, std::memory_order_release);
+}
+
+//! Callback of a traced task, that calls the original one
+void Tracer::_task_done(void *pending_)
+{
+    auto *pending = reinterpret_cast<Pending *>(pending_);
+    Tracer *tracer = pending->tracer;
+    starpu_task *task = starpu_task_get_current();
+    starpu_profiling_task_info *info = nullptr;
+    if(task != nullptr)
+    {
+        info = task->profiling_info;
+    }
+    {
+        std::lock_guard<std::mutex> lock(tracer->mutex);
+        Event &event = tracer->events[pending->event];
+        if(info != nullptr)
+        {
+            event.start = starpu_timing_timespec_to_us(&info->start_time)
+                - tracer->time0;
+            event.end = starpu_timing_timespec_to_us(&info->end_time)
+                - tracer->time0;
+            event.workerid = info->workerid;
+        }
+        else
+        {
+            // Profiling was disabled by someone else
+            event.end = starpu_timing_now() - tracer->time0;
+            event.start = event.end;
+            event.workerid = starpu_worker_get_id();
+        }
+    }
+    if(pending->callback_func != nullptr)
+    {
+        pending->callback_func(pending->callback_arg);
+    }
+    if(pending->callback_arg_free)
+    {
+        std::free(pending->callback_arg);
+    }
+    delete pending;
+    tracer->ninflight.fetch_sub(1, std::memory_order_release);
+}
+
+void Tracer::save(const std::string &filename)
+{
+    _wait();
+    std::ofstream out(filename);
+    if(!out)
+    {
+        throw std::runtime_error("Cannot open trace file " + filename);
+    }
+    int pid = starpu_mpi_world_rank();
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    // Names of tracks of workers
+    std::set<int> workers;
+    for(const auto &event: events)
+    {
+        workers.insert(event.workerid);
+    }
+    bool first = true;
+    for(int workerid: workers)
+    {
+        char name[64] = "unknown";
+        if(workerid >= 0)
+        {
+            starpu_worker_get_name(workerid, name, sizeof(name));
+        }
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << pid
+            << ",\"tid\":" << workerid << ",\"args\":{\"name\":";
+        _json_string(out, name);
+        out << "}}";
+    }
+    for(const auto &event: events)
+    {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "{\"ph\":\"X\",\"name\":";
+        _json_string(out, event.name != nullptr ? event.name : "unnamed");
+        out << ",\"cat\":";
+        _json_string(out, scopes[event.scope].empty() ? "none"
+                : scopes[event.scope]);
+        out << ",\"pid\":" << pid << ",\"tid\":" << event.workerid
+            << ",\"ts\":" << event.start << ",\"dur\":"
+            << event.end-event.start << ",\"args\":{\"scope\":";
+        _json_string(out, scopes[event.scope]);
+        out << ",\"submit_us\":" << event.submit << ",\"wait_us\":"
+            << event.start-event.submit << ",\"tiles\":";
+        _json_string(out, event.tiles);
+        out << "}}";
+    }
+    out << "\n]}\n";
+    if(!out)
+    {
+        throw std::runtime_error("Error writing trace file " + filename);
+    }
+}
+
+std::map<std::string, double> Tracer::scope_totals()
+{
+    _wait();
+    std::map<std::string, double> totals;
+    for(const auto &event: events)
+    {
+        totals[scopes[event.scope]] += event.end - event.start;
+    }
+    return totals;
+}
+
+} // namespace starpu
+} // namespace nntile
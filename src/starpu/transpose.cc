@@ -117,22 +117,20 @@ void submit(Index m, Index n, T alpha, Handle src, Handle dst)
  * */
 {
     // Codelet arguments
-    args_t<T> *args = (args_t<T> *)std::malloc(sizeof(*args));
+    args_t<T> *args = args_pool::alloc<args_t<T>>();
     args->m = m;
     args->n = n;
     args->alpha = alpha;
     // Submit task
-    int ret = starpu_task_insert(codelet<T>(),
+    int ret = task_insert(codelet<T>(),
             STARPU_R, static_cast<starpu_data_handle_t>(src),
             STARPU_W, static_cast<starpu_data_handle_t>(dst),
-            STARPU_CL_ARGS, args, sizeof(*args),
+            STARPU_CL_ARGS_NFREE, args, sizeof(*args),
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
             // STARPU_FLOPS, nflops);
             0);
     // Check submission
-    if(ret != 0)
-    {
-        throw std::runtime_error("Error in transpose task submission");
-    }
+    args_pool::check_submit(ret, args, "Error in transpose task submission");
 }
 
 // Explicit instantiation
@@ -0,0 +1,127 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/starpu/write_tile.cc
+ * Write a StarPU buffer into a file at a given offset
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-13
+ * */
+
+#include "nntile/starpu/write_tile.hh"
+#include <atomic>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace nntile
+{
+namespace starpu
+{
+namespace write_tile
+{
+
+//! Number of failed tasks, as codelets cannot throw exceptions
+static std::atomic<Index> nfailed_tasks{0};
+
+//! Write a StarPU buffer into a file on CPU
+/*! Every task opens the file on its own, so that tasks of different tiles
+ * write in parallel without any shared state.
+ * */
+void cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    // Get arguments
+    const Index *offset;
+    const char *filename;
+    Config::unpack_args_ptr(cl_args, offset, filename);
+    // Get interfaces
+    auto interfaces = reinterpret_cast<VariableInterface **>(buffers);
+    std::size_t size = interfaces[0]->elemsize;
+    const char *data = interfaces[0]->get_ptr<char>();
+    // Write buffer, that is possibly done in several chunks
+    int fd = open(filename, O_WRONLY | O_CREAT, 0644);
+    if(fd == -1)
+    {
+        ++nfailed_tasks;
+        return;
+    }
+    std::size_t done = 0;
+    while(done < size)
+    {
+        ssize_t ret = pwrite(fd, data+done, size-done, *offset+done);
+        if(ret == -1 and errno == EINTR)
+        {
+            continue;
+        }
+        if(ret <= 0)
+        {
+            ++nfailed_tasks;
+            break;
+        }
+        done += ret;
+    }
+    close(fd);
+}
+
+Codelet codelet;
+
+void init()
+{
+    codelet.init("nntile_write_tile",
+            nullptr,
+            {cpu},
+            {}
+            );
+    codelet.nbuffers = 1;
+    codelet.modes[0] = STARPU_R;
+}
+
+void restrict_where(uint32_t where)
+{
+    codelet.restrict_where(where);
+}
+
+void restore_where()
+{
+    codelet.restore_where();
+}
+
+//! Insert task to write buffer into a file
+/*! The file is created if needed and it is never truncated.
+ *
+ * @param[in] data: Buffer to write
+ * @param[in] filename: Name of the file
+ * @param[in] offset: Offset in bytes of the buffer in the file
+ * */
+void submit(Handle data, const std::string &filename, Index offset)
+{
+    // Pack codelet arguments in the same format as STARPU_VALUE does
+    std::size_t args_size;
+    void *args = args_pool::pack({
+            {&offset, sizeof(offset)},
+            {filename.c_str(), filename.size()+1}}, args_size);
+    // Submit task
+    int ret = task_insert(&codelet,
+            STARPU_CL_ARGS_NFREE, args, args_size,
+            STARPU_CALLBACK_WITH_ARG_NFREE, args_pool::release, args,
+            STARPU_R, static_cast<starpu_data_handle_t>(data),
+            0);
+    // Check submission
+    args_pool::check_submit(ret, args, "Error in write_tile task submission");
+}
+
+//! Total number of write tasks, that failed
+Index nfailed()
+{
+    return nfailed_tasks.load();
+}
+
+} // namespace write_tile
+} // namespace starpu
+} // namespace nntile
+
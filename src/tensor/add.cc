@@ -89,6 +89,10 @@ template
 void add_async<fp64_t>(fp64_t alpha, const Tensor<fp64_t> &src, fp64_t beta,
         const Tensor<fp64_t> &dst);
 
+template
+void add_async<bf16_t>(bf16_t alpha, const Tensor<bf16_t> &src, bf16_t beta,
+        const Tensor<bf16_t> &dst);
+
 // Explicit instantiation of template
 template
 void add<fp32_t>(fp32_t alpha, const Tensor<fp32_t> &src, fp32_t beta,
@@ -98,5 +102,9 @@ template
 void add<fp64_t>(fp64_t alpha, const Tensor<fp64_t> &src, fp64_t beta,
         const Tensor<fp64_t> &dst);
 
+template
+void add<bf16_t>(bf16_t alpha, const Tensor<bf16_t> &src, bf16_t beta,
+        const Tensor<bf16_t> &dst);
+
 } // namespace tensor
 } // namespace nntile
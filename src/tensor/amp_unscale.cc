@@ -0,0 +1,152 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/amp_unscale.cc
+ * Unscale gradient tensor and check it for infinite and NaN values
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-19
+ * */
+
+#include "nntile/tensor/amp_unscale.hh"
+#include "nntile/starpu/amp_unscale.hh"
+#include <map>
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous tensor-wise unscale with inf/NaN check
+/*! Every tile of data is multiplied by inv_scale and checked for infinite and
+ * NaN values within a single pass. The flag is only set, never cleared, so
+ * one flag can gather status of all gradients of a model. Clearing the flag
+ * is up to the caller.
+ *
+ * Updates of a flag on different MPI nodes can not be merged by tasks, so
+ * the flag tensor holds a tile per node, see amp_nonfinite(). Every tile of
+ * data updates the first flag tile, that resides on the same node.
+ *
+ * @param[in] inv_scale: Inverse of the loss scale
+ * @param[inout] data: Gradient tensor, that is unscaled in-place
+ * @param[inout] nonfinite: Flags, that are set if any tile of data on the
+ *      same node has infinite or NaN values. Single-element tiles.
+ * */
+template<typename T>
+void amp_unscale_async(T inv_scale, const Tensor<T> &data,
+        const Tensor<bool_t> &nonfinite)
+{
+    // Check dimensions
+    if(nonfinite.nelems != nonfinite.grid.nelems)
+    {
+        throw std::runtime_error("nonfinite.nelems != "
+                "nonfinite.grid.nelems");
+    }
+    // Find flag tile on every node, that has tiles of data
+    int mpi_rank = starpu_mpi_world_rank();
+    std::map<int, Index> flag_tiles;
+    for(Index i = nonfinite.grid.nelems-1; i >= 0; --i)
+    {
+        flag_tiles[nonfinite.get_tile_handle(i).mpi_get_rank()] = i;
+    }
+    for(Index i = 0; i < data.grid.nelems; ++i)
+    {
+        int data_tile_rank = data.get_tile_handle(i).mpi_get_rank();
+        if(flag_tiles.count(data_tile_rank) == 0)
+        {
+            throw std::runtime_error("No nonfinite flag tile on the node of "
+                    "a data tile");
+        }
+    }
+    auto it = flag_tiles.find(mpi_rank);
+    if(it == flag_tiles.end())
+    {
+        return;
+    }
+    auto flag_tile_handle = nonfinite.get_tile_handle(it->second);
+    for(Index i = 0; i < data.grid.nelems; ++i)
+    {
+        auto data_tile_handle = data.get_tile_handle(i);
+        if(data_tile_handle.mpi_get_rank() != mpi_rank)
+        {
+            continue;
+        }
+        auto data_tile_traits = data.get_tile_traits(i);
+        starpu::amp_unscale::submit<T>(data_tile_traits.nelems, inv_scale,
+                data_tile_handle, flag_tile_handle);
+    }
+}
+
+//! Check if any flag, set by amp_unscale_async(), is set
+/*! Every node waits only for tasks, that update its own flag tiles, and the
+ * result is then reduced over all the nodes, so that all of them take the
+ * same decision.
+ *
+ * @param[in] nonfinite: Flags with single-element tiles
+ * @return True on all nodes if any of flags is set on any node
+ * */
+bool amp_nonfinite(const Tensor<bool_t> &nonfinite)
+{
+    int mpi_rank = starpu_mpi_world_rank();
+    int result = 0;
+    for(Index i = 0; i < nonfinite.grid.nelems; ++i)
+    {
+        auto tile = nonfinite.get_tile(i);
+        if(tile.mpi_get_rank() != mpi_rank)
+        {
+            continue;
+        }
+        auto tile_local = tile.acquire(STARPU_R);
+        if(tile_local[0])
+        {
+            result = 1;
+        }
+        tile_local.release();
+    }
+#ifdef NNTILE_USE_MPI
+    MPI_Allreduce(MPI_IN_PLACE, &result, 1, MPI_INT, MPI_LOR,
+            MPI_COMM_WORLD);
+#endif // NNTILE_USE_MPI
+    return result != 0;
+}
+
+//! Blocking version of tensor-wise unscale with inf/NaN check
+/*! @param[in] inv_scale: Inverse of the loss scale
+ * @param[inout] data: Gradient tensor, that is unscaled in-place
+ * @param[inout] nonfinite: Scalar flag, that is set if any tile of data has
+ *      infinite or NaN values
+ * */
+template<typename T>
+void amp_unscale(T inv_scale, const Tensor<T> &data,
+        const Tensor<bool_t> &nonfinite)
+{
+    amp_unscale_async<T>(inv_scale, data, nonfinite);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void amp_unscale_async<fp32_t>(fp32_t inv_scale, const Tensor<fp32_t> &data,
+        const Tensor<bool_t> &nonfinite);
+
+template
+void amp_unscale_async<fp64_t>(fp64_t inv_scale, const Tensor<fp64_t> &data,
+        const Tensor<bool_t> &nonfinite);
+
+// Explicit instantiation
+template
+void amp_unscale<fp32_t>(fp32_t inv_scale, const Tensor<fp32_t> &data,
+        const Tensor<bool_t> &nonfinite);
+
+template
+void amp_unscale<fp64_t>(fp64_t inv_scale, const Tensor<fp64_t> &data,
+        const Tensor<bool_t> &nonfinite);
+
+} // namespace tensor
+} // namespace nntile
+
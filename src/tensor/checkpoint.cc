@@ -0,0 +1,355 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/checkpoint.cc
+ * Save and load Tensor<T> in a tile-aligned binary file
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-13
+ * */
+
+#include "nntile/tensor/checkpoint.hh"
+#include "nntile/starpu/write_tile.hh"
+#include "nntile/starpu/read_tile.hh"
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace nntile
+{
+namespace tensor
+{
+
+// Layout of a checkpoint file:
+//      magic (8 bytes), version, dtype, size of element, alignment, ndim,
+//      shape (ndim values), basetile_shape (ndim values),
+// where all the values after magic are of Index type. The header is padded
+// to the alignment and followed by tiles in the order of the grid, each of
+// them is stored as is and padded to the alignment.
+static const char checkpoint_magic[8] = {'N', 'N', 'T', 'I', 'L', 'E', 'C',
+    'K'};
+static constexpr Index checkpoint_version = 1;
+
+//! Code of a type, stored in a checkpoint file
+template<typename T>
+constexpr Index checkpoint_dtype()
+{
+    throw std::runtime_error("Non-supported type");
+    return 0;
+}
+
+template<>
+constexpr Index checkpoint_dtype<fp32_t>()
+{
+    return 1;
+}
+
+template<>
+constexpr Index checkpoint_dtype<fp64_t>()
+{
+    return 2;
+}
+
+template<>
+constexpr Index checkpoint_dtype<fp16_t>()
+{
+    return 3;
+}
+
+template<>
+constexpr Index checkpoint_dtype<Index>()
+{
+    return 4;
+}
+
+template<>
+constexpr Index checkpoint_dtype<bool_t>()
+{
+    return 5;
+}
+
+template<>
+constexpr Index checkpoint_dtype<bf16_t>()
+{
+    return 6;
+}
+
+//! Round size up to the checkpoint alignment
+static Index checkpoint_align(Index size)
+{
+    return (size+checkpoint_alignment-1) / checkpoint_alignment
+        * checkpoint_alignment;
+}
+
+//! Header of a checkpoint file for a given tensor
+template<typename T>
+static std::vector<Index> checkpoint_header(const TensorTraits &traits)
+{
+    std::vector<Index> header{checkpoint_version, checkpoint_dtype<T>(),
+        sizeof(T), checkpoint_alignment, traits.ndim};
+    header.insert(header.end(), traits.shape.begin(), traits.shape.end());
+    header.insert(header.end(), traits.basetile_shape.begin(),
+            traits.basetile_shape.end());
+    return header;
+}
+
+//! Offsets of tiles in a checkpoint file and the total size of the file
+template<typename T>
+static std::vector<Index> checkpoint_offsets(const Tensor<T> &tensor)
+{
+    std::vector<Index> offsets(tensor.grid.nelems+1);
+    offsets[0] = checkpoint_align(sizeof(checkpoint_magic)
+            + sizeof(Index)*(5+2*tensor.ndim));
+    for(Index i = 0; i < tensor.grid.nelems; ++i)
+    {
+        Index tile_size = tensor.get_tile_traits(i).nelems * sizeof(T);
+        offsets[i+1] = offsets[i] + checkpoint_align(tile_size);
+    }
+    return offsets;
+}
+
+//! Asynchronous save of tiles of a tensor into a checkpoint file
+/*! The header is written by MPI node 0 before the function returns, while
+ * every tile is written by a separate task on the node, that owns the tile.
+ * Tile writes are submitted after an MPI barrier, so they never race the
+ * header write and resize of the file on node 0.
+ * Tasks only read tiles, so computations, that read the same tensor, are not
+ * blocked. The file must be accessible from all the nodes.
+ *
+ * @param[in] src: Tensor to save
+ * @param[in] filename: Name of the checkpoint file
+ * */
+template<typename T>
+void save_async(const Tensor<T> &src, const std::string &filename)
+{
+    int mpi_rank = starpu_mpi_world_rank();
+    auto offsets = checkpoint_offsets<T>(src);
+    // Write header and set size of the file on the root node
+    if(mpi_rank == 0)
+    {
+        auto header = checkpoint_header<T>(src);
+        int fd = open(filename.c_str(), O_WRONLY | O_CREAT, 0644);
+        if(fd == -1)
+        {
+            throw std::runtime_error("Cannot open checkpoint file " +
+                    filename);
+        }
+        bool failed = pwrite(fd, checkpoint_magic, sizeof(checkpoint_magic),
+                0) != sizeof(checkpoint_magic);
+        Index header_size = header.size() * sizeof(Index);
+        failed = failed or pwrite(fd, &header[0], header_size,
+                sizeof(checkpoint_magic)) != header_size;
+        failed = failed or ftruncate(fd, offsets.back()) != 0;
+        close(fd);
+        if(failed)
+        {
+            throw std::runtime_error("Cannot write header of checkpoint "
+                    "file " + filename);
+        }
+    }
+    // Tiles are written only after the root node created and sized the file
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    // Write tiles on their owners
+    for(Index i = 0; i < src.grid.nelems; ++i)
+    {
+        auto src_tile_handle = src.get_tile_handle(i);
+        if(mpi_rank == src_tile_handle.mpi_get_rank())
+        {
+            starpu::write_tile::submit(src_tile_handle, filename,
+                    offsets[i]);
+        }
+    }
+}
+
+//! Blocking version of save of tiles of a tensor into a checkpoint file
+/*! @param[in] src: Tensor to save
+ * @param[in] filename: Name of the checkpoint file
+ * */
+template<typename T>
+void save(const Tensor<T> &src, const std::string &filename)
+{
+    Index nfailed = starpu::write_tile::nfailed();
+    save_async<T>(src, filename);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+    if(starpu::write_tile::nfailed() != nfailed)
+    {
+        throw std::runtime_error("Cannot write tiles into checkpoint file " +
+                filename);
+    }
+}
+
+//! Asynchronous load of tiles of a tensor from a checkpoint file
+/*! The header is read and checked against the tensor before the function
+ * returns. The tensor must have the same shape, basetile shape and type as
+ * the saved one. Every tile is read by a separate task on the node, that
+ * owns the tile, from a memory mapping of its part of the file.
+ *
+ * @param[out] dst: Tensor to load
+ * @param[in] filename: Name of the checkpoint file
+ * */
+template<typename T>
+void load_async(const Tensor<T> &dst, const std::string &filename)
+{
+    int mpi_rank = starpu_mpi_world_rank();
+    auto offsets = checkpoint_offsets<T>(dst);
+    // Read and check header
+    auto header = checkpoint_header<T>(dst);
+    std::vector<Index> file_header(header.size());
+    char magic[sizeof(checkpoint_magic)];
+    int fd = open(filename.c_str(), O_RDONLY);
+    if(fd == -1)
+    {
+        throw std::runtime_error("Cannot open checkpoint file " + filename);
+    }
+    bool failed = pread(fd, magic, sizeof(magic), 0) != sizeof(magic);
+    Index header_size = header.size() * sizeof(Index);
+    failed = failed or pread(fd, &file_header[0], header_size,
+            sizeof(magic)) != header_size;
+    off_t file_size = lseek(fd, 0, SEEK_END);
+    close(fd);
+    if(failed or std::memcmp(magic, checkpoint_magic, sizeof(magic)) != 0)
+    {
+        throw std::runtime_error("File " + filename + " is not a checkpoint");
+    }
+    if(file_header[0] != checkpoint_version)
+    {
+        throw std::runtime_error("Unsupported version of checkpoint file " +
+                filename);
+    }
+    if(file_header != header)
+    {
+        throw std::runtime_error("Type, shape or basetile shape of tensor "
+                "does not match checkpoint file " + filename);
+    }
+    if(file_size < offsets.back())
+    {
+        throw std::runtime_error("Checkpoint file " + filename +
+                " is truncated");
+    }
+    // Read tiles on their owners
+    for(Index i = 0; i < dst.grid.nelems; ++i)
+    {
+        auto dst_tile_handle = dst.get_tile_handle(i);
+        if(mpi_rank == dst_tile_handle.mpi_get_rank())
+        {
+            starpu::read_tile::submit(dst_tile_handle, filename, offsets[i]);
+        }
+        // Flush cache for the output tile on every node
+        dst_tile_handle.mpi_flush();
+    }
+}
+
+//! Blocking version of load of tiles of a tensor from a checkpoint file
+/*! @param[out] dst: Tensor to load
+ * @param[in] filename: Name of the checkpoint file
+ * */
+template<typename T>
+void load(const Tensor<T> &dst, const std::string &filename)
+{
+    Index nfailed = starpu::read_tile::nfailed();
+    load_async<T>(dst, filename);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+    if(starpu::read_tile::nfailed() != nfailed)
+    {
+        throw std::runtime_error("Cannot read tiles from checkpoint file " +
+                filename);
+    }
+}
+
+// Explicit instantiation
+template
+void save_async<fp16_t>(const Tensor<fp16_t> &src,
+        const std::string &filename);
+
+template
+void save_async<bf16_t>(const Tensor<bf16_t> &src,
+        const std::string &filename);
+
+template
+void save_async<fp32_t>(const Tensor<fp32_t> &src,
+        const std::string &filename);
+
+template
+void save_async<fp64_t>(const Tensor<fp64_t> &src,
+        const std::string &filename);
+
+template
+void save_async<Index>(const Tensor<Index> &src,
+        const std::string &filename);
+
+template
+void save_async<bool_t>(const Tensor<bool_t> &src,
+        const std::string &filename);
+
+// Explicit instantiation
+template
+void save<fp16_t>(const Tensor<fp16_t> &src, const std::string &filename);
+
+template
+void save<bf16_t>(const Tensor<bf16_t> &src, const std::string &filename);
+
+template
+void save<fp32_t>(const Tensor<fp32_t> &src, const std::string &filename);
+
+template
+void save<fp64_t>(const Tensor<fp64_t> &src, const std::string &filename);
+
+template
+void save<Index>(const Tensor<Index> &src, const std::string &filename);
+
+template
+void save<bool_t>(const Tensor<bool_t> &src, const std::string &filename);
+
+// Explicit instantiation
+template
+void load_async<fp16_t>(const Tensor<fp16_t> &dst,
+        const std::string &filename);
+
+template
+void load_async<bf16_t>(const Tensor<bf16_t> &dst,
+        const std::string &filename);
+
+template
+void load_async<fp32_t>(const Tensor<fp32_t> &dst,
+        const std::string &filename);
+
+template
+void load_async<fp64_t>(const Tensor<fp64_t> &dst,
+        const std::string &filename);
+
+template
+void load_async<Index>(const Tensor<Index> &dst,
+        const std::string &filename);
+
+template
+void load_async<bool_t>(const Tensor<bool_t> &dst,
+        const std::string &filename);
+
+// Explicit instantiation
+template
+void load<fp16_t>(const Tensor<fp16_t> &dst, const std::string &filename);
+
+template
+void load<bf16_t>(const Tensor<bf16_t> &dst, const std::string &filename);
+
+template
+void load<fp32_t>(const Tensor<fp32_t> &dst, const std::string &filename);
+
+template
+void load<fp64_t>(const Tensor<fp64_t> &dst, const std::string &filename);
+
+template
+void load<Index>(const Tensor<Index> &dst, const std::string &filename);
+
+template
+void load<bool_t>(const Tensor<bool_t> &dst, const std::string &filename);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -55,6 +55,15 @@ void clear_async<fp64_t>(const Tensor<fp64_t> &dst);
 template
 void clear_async<fp16_t>(const Tensor<fp16_t> &dst);
 
+template
+void clear_async<bf16_t>(const Tensor<bf16_t> &dst);
+
+template
+void clear_async<bool_t>(const Tensor<bool_t> &dst);
+
+template
+void clear_async<Index>(const Tensor<Index> &dst);
+
 // Explicit instantiation
 template
 void clear<fp32_t>(const Tensor<fp32_t> &dst);
@@ -65,6 +74,15 @@ void clear<fp64_t>(const Tensor<fp64_t> &dst);
 template
 void clear<fp16_t>(const Tensor<fp16_t> &dst);
 
+template
+void clear<bf16_t>(const Tensor<bf16_t> &dst);
+
+template
+void clear<bool_t>(const Tensor<bool_t> &dst);
+
+template
+void clear<Index>(const Tensor<Index> &dst);
+
 } // namespace tensor
 } // namespace nntile
 
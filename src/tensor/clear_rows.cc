@@ -0,0 +1,108 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/clear_rows.cc
+ * Clear marked rows of a matrix for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/tensor/clear_rows.hh"
+#include "nntile/starpu/clear_rows.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous tensor-wise clear of marked rows
+/*! Rows of a table of embeddings of shape [embed, vocab] are indexed by its
+ * last axis. Only the marked rows are cleared, so that a sparse gradient of
+ * the table, which is zero outside of the marked rows, is cleared at the cost
+ * of the marked rows only.
+ *
+ * @param[in] rows: Marks of rows to clear
+ * @param[inout] dst: Matrix, whose marked rows are cleared
+ * */
+template<typename T>
+void clear_rows_async(const Tensor<bool_t> &rows, const Tensor<T> &dst)
+{
+    // Check dimensions
+    if(rows.ndim != 1)
+    {
+        throw std::runtime_error("rows.ndim != 1");
+    }
+    if(dst.ndim != 2)
+    {
+        throw std::runtime_error("dst.ndim != 2");
+    }
+    // Check shapes
+    if(rows.shape[0] != dst.shape[1])
+    {
+        throw std::runtime_error("rows.shape[0] != dst.shape[1]");
+    }
+    if(rows.basetile_shape[0] != dst.basetile_shape[1])
+    {
+        throw std::runtime_error("rows.basetile_shape[0] != "
+                "dst.basetile_shape[1]");
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < dst.grid.nelems; ++i)
+    {
+        auto dst_tile_handle = dst.get_tile_handle(i);
+        int dst_tile_rank = dst_tile_handle.mpi_get_rank();
+        auto dst_tile_index = dst.grid.linear_to_index(i);
+        auto rows_tile_handle = rows.get_tile_handle(dst_tile_index[1]);
+        // Transfer marks to the node, that owns the output tile
+        rows_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == dst_tile_rank)
+        {
+            auto dst_tile_traits = dst.get_tile_traits(i);
+            starpu::clear_rows::submit<T>(dst_tile_traits.shape[0],
+                    dst_tile_traits.shape[1], rows_tile_handle,
+                    dst_tile_handle);
+        }
+        // Flush cache for the output tile on every node
+        dst_tile_handle.mpi_flush();
+    }
+}
+
+//! Blocking version of tensor-wise clear of marked rows
+/*! @param[in] rows: Marks of rows to clear
+ * @param[inout] dst: Matrix, whose marked rows are cleared
+ * */
+template<typename T>
+void clear_rows(const Tensor<bool_t> &rows, const Tensor<T> &dst)
+{
+    clear_rows_async<T>(rows, dst);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void clear_rows_async<fp32_t>(const Tensor<bool_t> &rows,
+        const Tensor<fp32_t> &dst);
+
+template
+void clear_rows_async<fp64_t>(const Tensor<bool_t> &rows,
+        const Tensor<fp64_t> &dst);
+
+// Explicit instantiation
+template
+void clear_rows<fp32_t>(const Tensor<bool_t> &rows,
+        const Tensor<fp32_t> &dst);
+
+template
+void clear_rows<fp64_t>(const Tensor<bool_t> &rows,
+        const Tensor<fp64_t> &dst);
+
+} // namespace tensor
+} // namespace nntile
+
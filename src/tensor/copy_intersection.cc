@@ -64,10 +64,9 @@ void copy_intersection_async(const Tensor<T> &src,
         // Execute on destination node
         if(mpi_rank == dst_tile_rank)
         {
-            ret = starpu_data_cpy(
+            ret = starpu::data_cpy(
                     static_cast<starpu_data_handle_t>(dst_tile_handle),
-                    static_cast<starpu_data_handle_t>(src_tile_handle),
-                    1, nullptr, nullptr);
+                    static_cast<starpu_data_handle_t>(src_tile_handle));
             if(ret != 0)
             {
                 throw std::runtime_error("Error in starpu_data_cpy");
@@ -91,10 +90,9 @@ void copy_intersection_async(const Tensor<T> &src,
             // Execute on destination node
             if(mpi_rank == dst_tile_rank)
             {
-                ret = starpu_data_cpy(
+                ret = starpu::data_cpy(
                         static_cast<starpu_data_handle_t>(dst_tile_handle),
-                        static_cast<starpu_data_handle_t>(src_tile_handle),
-                        1, nullptr, nullptr);
+                        static_cast<starpu_data_handle_t>(src_tile_handle));
                 if(ret != 0)
                 {
                     throw std::runtime_error("Error in starpu_data_cpy");
@@ -267,11 +265,10 @@ void copy_intersection_async(const Tensor<T> &src,
             // Execute on destination node
             if(mpi_rank == dst_tile_rank)
             {
-                ret = starpu_data_cpy(
+                ret = starpu::data_cpy(
                         static_cast<starpu_data_handle_t>(dst_tile_handle),
                         static_cast<starpu_data_handle_t>(
-                            src_first_tile_handle),
-                        1, nullptr, nullptr);
+                            src_first_tile_handle));
                 if(ret != 0)
                 {
                     throw std::runtime_error("Error in starpu_data_cpy");
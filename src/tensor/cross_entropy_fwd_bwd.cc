@@ -0,0 +1,246 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/cross_entropy_fwd_bwd.cc
+ * Fused cross entropy loss and its gradient for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/tensor/cross_entropy_fwd_bwd.hh"
+#include "nntile/starpu/cross_entropy_fwd_bwd.hh"
+#include <map>
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous tensor-wise cross entropy loss and its gradient
+/*! Logits are stored with classes along the first axis, that can be split
+ * into several tiles. Maximums and sums of exponents along the first axis
+ * must be computed beforehand, e.g., by maxsumexp_async(). Then every tile
+ * of logits is read only once to write the corresponding tile of gradient
+ * and to add its contribution to the loss value:
+ *      val += scale * sum_j (log(sum_i exp(src[i,j])) - src[labels[j],j]),
+ *      grad = grad_scale * (softmax(src) - onehot(labels)).
+ * The loss value is accumulated, so it shall be cleared by the caller. Logits
+ * may be only a slice of all classes, that starts at a given class, as long
+ * as maxsumexp covers all the classes. Then labels outside of the slice are
+ * skipped and the log-sum-exp term is added only by the slice of the first
+ * class, so that slices can be processed one after another.
+ *
+ * Every tile of gradient is written on its owner node. Updates of the loss
+ * value on different MPI nodes can not be merged by tasks, so the loss value
+ * can be a vector of single-element tiles, e.g., a tile per node. Then every
+ * tile of gradient updates the first tile of the loss value, that resides on
+ * the same node, and partial values are to be summed up by the caller, e.g.,
+ * by sum_slice_async(). A scalar loss value is allowed if it resides on the
+ * same node as all the tiles of gradient.
+ *
+ * @param[in] scale: Scalar multiplier for the loss value
+ * @param[in] grad_scale: Scalar multiplier for the gradient
+ * @param[in] maxsumexp: Maximums and sums of exponents of logits along the
+ *      first axis
+ * @param[in] src: Logits
+ * @param[in] labels: Correct classes
+ * @param[out] grad: Gradient of the loss over logits
+ * @param[inout] val: Scalar loss value or partial loss values with
+ *      single-element tiles
+ * @param[in] redux: Whether to use StarPU reduction for the loss value
+ * @param[in] start: Index of the first class of src, if src is only a slice
+ *      of all logits along the first axis
+ * */
+template<typename T>
+void cross_entropy_fwd_bwd_async(T scale, T grad_scale,
+        const Tensor<T> &maxsumexp, const Tensor<T> &src,
+        const Tensor<Index> &labels, const Tensor<T> &grad,
+        const Tensor<T> &val, int redux, Index start)
+{
+    // Check dimensions
+    if(src.ndim == 0)
+    {
+        throw std::runtime_error("src.ndim == 0");
+    }
+    if(maxsumexp.ndim != src.ndim)
+    {
+        throw std::runtime_error("maxsumexp.ndim != src.ndim");
+    }
+    if(labels.ndim != src.ndim-1)
+    {
+        throw std::runtime_error("labels.ndim != src.ndim-1");
+    }
+    if(grad.ndim != src.ndim)
+    {
+        throw std::runtime_error("grad.ndim != src.ndim");
+    }
+    if(val.nelems != val.grid.nelems)
+    {
+        throw std::runtime_error("val.nelems != val.grid.nelems");
+    }
+    if(start < 0)
+    {
+        throw std::runtime_error("start < 0");
+    }
+    // Check shapes
+    if(maxsumexp.shape[0] != 2)
+    {
+        throw std::runtime_error("maxsumexp.shape[0] != 2");
+    }
+    if(maxsumexp.basetile_shape[0] != 2)
+    {
+        throw std::runtime_error("maxsumexp.basetile_shape[0] != 2");
+    }
+    for(Index i = 0; i < src.ndim; ++i)
+    {
+        if(grad.shape[i] != src.shape[i])
+        {
+            throw std::runtime_error("grad.shape[i] != src.shape[i]");
+        }
+        if(grad.basetile_shape[i] != src.basetile_shape[i])
+        {
+            throw std::runtime_error("grad.basetile_shape[i] != "
+                    "src.basetile_shape[i]");
+        }
+    }
+    for(Index i = 1; i < src.ndim; ++i)
+    {
+        if(maxsumexp.shape[i] != src.shape[i])
+        {
+            throw std::runtime_error("maxsumexp.shape[i] != src.shape[i]");
+        }
+        if(maxsumexp.basetile_shape[i] != src.basetile_shape[i])
+        {
+            throw std::runtime_error("maxsumexp.basetile_shape[i] != "
+                    "src.basetile_shape[i]");
+        }
+        if(labels.shape[i-1] != src.shape[i])
+        {
+            throw std::runtime_error("labels.shape[i-1] != src.shape[i]");
+        }
+        if(labels.basetile_shape[i-1] != src.basetile_shape[i])
+        {
+            throw std::runtime_error("labels.basetile_shape[i-1] != "
+                    "src.basetile_shape[i]");
+        }
+    }
+    // Find tile of loss value on every node, that has tiles of gradient
+    int mpi_rank = starpu_mpi_world_rank();
+    std::map<int, Index> val_tiles;
+    for(Index i = val.grid.nelems-1; i >= 0; --i)
+    {
+        val_tiles[val.get_tile_handle(i).mpi_get_rank()] = i;
+    }
+    for(Index i = 0; i < grad.grid.nelems; ++i)
+    {
+        int grad_tile_rank = grad.get_tile_handle(i).mpi_get_rank();
+        if(val_tiles.count(grad_tile_rank) == 0)
+        {
+            throw std::runtime_error("No loss value tile on the node of a "
+                    "gradient tile");
+        }
+    }
+    std::vector<Index> labels_tile_index(labels.ndim),
+        maxsumexp_tile_index(maxsumexp.ndim);
+    maxsumexp_tile_index[0] = 0;
+    for(Index i = 0; i < src.grid.nelems; ++i)
+    {
+        auto src_tile_index = src.grid.linear_to_index(i);
+        for(Index j = 1; j < src.ndim; ++j)
+        {
+            labels_tile_index[j-1] = src_tile_index[j];
+            maxsumexp_tile_index[j] = src_tile_index[j];
+        }
+        auto src_tile_handle = src.get_tile_handle(i);
+        auto labels_tile_handle = labels.get_tile_handle(
+                labels_tile_index);
+        auto maxsumexp_tile_handle = maxsumexp.get_tile_handle(
+                maxsumexp_tile_index);
+        auto grad_tile_handle = grad.get_tile_handle(i);
+        int grad_tile_rank = grad_tile_handle.mpi_get_rank();
+        // Transfer data to the node, that owns the tile of gradient
+        src_tile_handle.mpi_transfer(grad_tile_rank, mpi_rank);
+        labels_tile_handle.mpi_transfer(grad_tile_rank, mpi_rank);
+        maxsumexp_tile_handle.mpi_transfer(grad_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == grad_tile_rank)
+        {
+            auto src_tile_traits = src.get_tile_traits(i);
+            Index m = src_tile_traits.shape[0];
+            Index n = src_tile_traits.nelems / m;
+            Index m_start = start + src_tile_index[0]*src.basetile_shape[0];
+            auto val_tile_handle = val.get_tile_handle(
+                    val_tiles[grad_tile_rank]);
+            starpu::cross_entropy_fwd_bwd::submit<T>(m, n, m_start, scale,
+                    grad_scale, maxsumexp_tile_handle, src_tile_handle,
+                    labels_tile_handle, grad_tile_handle, val_tile_handle,
+                    redux);
+        }
+        // Flush cache for the output tile on every node
+        grad_tile_handle.mpi_flush();
+    }
+    for(Index i = 0; i < val.grid.nelems; ++i)
+    {
+        val.get_tile_handle(i).mpi_flush();
+    }
+}
+
+//! Blocking version of tensor-wise cross entropy loss and its gradient
+/*! @param[in] scale: Scalar multiplier for the loss value
+ * @param[in] grad_scale: Scalar multiplier for the gradient
+ * @param[in] maxsumexp: Maximums and sums of exponents of logits along the
+ *      first axis
+ * @param[in] src: Logits
+ * @param[in] labels: Correct classes
+ * @param[out] grad: Gradient of the loss over logits
+ * @param[inout] val: Scalar loss value
+ * @param[in] redux: Whether to use StarPU reduction for the loss value
+ * @param[in] start: Index of the first class of src, if src is only a slice
+ *      of all logits along the first axis
+ * */
+template<typename T>
+void cross_entropy_fwd_bwd(T scale, T grad_scale,
+        const Tensor<T> &maxsumexp, const Tensor<T> &src,
+        const Tensor<Index> &labels, const Tensor<T> &grad,
+        const Tensor<T> &val, int redux, Index start)
+{
+    cross_entropy_fwd_bwd_async<T>(scale, grad_scale, maxsumexp, src, labels,
+            grad, val, redux, start);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void cross_entropy_fwd_bwd_async<fp32_t>(fp32_t scale, fp32_t grad_scale,
+        const Tensor<fp32_t> &maxsumexp, const Tensor<fp32_t> &src,
+        const Tensor<Index> &labels, const Tensor<fp32_t> &grad,
+        const Tensor<fp32_t> &val, int redux, Index start);
+
+template
+void cross_entropy_fwd_bwd_async<fp64_t>(fp64_t scale, fp64_t grad_scale,
+        const Tensor<fp64_t> &maxsumexp, const Tensor<fp64_t> &src,
+        const Tensor<Index> &labels, const Tensor<fp64_t> &grad,
+        const Tensor<fp64_t> &val, int redux, Index start);
+
+// Explicit instantiation
+template
+void cross_entropy_fwd_bwd<fp32_t>(fp32_t scale, fp32_t grad_scale,
+        const Tensor<fp32_t> &maxsumexp, const Tensor<fp32_t> &src,
+        const Tensor<Index> &labels, const Tensor<fp32_t> &grad,
+        const Tensor<fp32_t> &val, int redux, Index start);
+
+template
+void cross_entropy_fwd_bwd<fp64_t>(fp64_t scale, fp64_t grad_scale,
+        const Tensor<fp64_t> &maxsumexp, const Tensor<fp64_t> &src,
+        const Tensor<Index> &labels, const Tensor<fp64_t> &grad,
+        const Tensor<fp64_t> &val, int redux, Index start);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -136,6 +136,10 @@ template
 void embedding_async<fp64_t>(const Tensor<Index> &index,
         const Tensor<fp64_t> &vocab, const Tensor<fp64_t> &embed, Index axis);
 
+template
+void embedding_async<bf16_t>(const Tensor<Index> &index,
+        const Tensor<bf16_t> &vocab, const Tensor<bf16_t> &embed, Index axis);
+
 // Explicit instantiation
 template
 void embedding<fp32_t>(const Tensor<Index> &index, const Tensor<fp32_t> &vocab,
@@ -145,6 +149,10 @@ template
 void embedding<fp64_t>(const Tensor<Index> &index, const Tensor<fp64_t> &vocab,
         const Tensor<fp64_t> &embed, Index axis);
 
+template
+void embedding<bf16_t>(const Tensor<Index> &index, const Tensor<bf16_t> &vocab,
+        const Tensor<bf16_t> &embed, Index axis);
+
 } // namespace tensor
 } // namespace nntile
 
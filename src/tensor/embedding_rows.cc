@@ -0,0 +1,78 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/embedding_rows.cc
+ * Mark rows of embeddings, that are touched by tokens, for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/tensor/embedding_rows.hh"
+#include "nntile/starpu/embedding_rows.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous tensor-wise marking of rows of embeddings
+/*! Rows of a table of embeddings, that are touched by given tokens, are
+ * marked. Marks are never cleared, so they accumulate tokens of several
+ * minibatches and shall be cleared by the caller. The table of embeddings is
+ * not split into tiles along rows, so marks are stored in a single tile.
+ *
+ * @param[in] index: Tokens (indices of embeddings)
+ * @param[inout] rows: Marks of touched rows
+ * */
+void embedding_rows_async(const Tensor<Index> &index,
+        const Tensor<bool_t> &rows)
+{
+    // Check dimensions
+    if(rows.ndim != 1)
+    {
+        throw std::runtime_error("rows.ndim != 1");
+    }
+    // Check shapes
+    if(rows.basetile_shape[0] != rows.shape[0])
+    {
+        throw std::runtime_error("rows.basetile_shape[0] != rows.shape[0]");
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    auto rows_tile_handle = rows.get_tile_handle(0);
+    int rows_tile_rank = rows_tile_handle.mpi_get_rank();
+    for(Index i = 0; i < index.grid.nelems; ++i)
+    {
+        auto index_tile_handle = index.get_tile_handle(i);
+        // Transfer tokens to the node, that owns marks
+        index_tile_handle.mpi_transfer(rows_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == rows_tile_rank)
+        {
+            auto index_tile_traits = index.get_tile_traits(i);
+            starpu::embedding_rows::submit(index_tile_traits.nelems,
+                    index_tile_handle, rows_tile_handle);
+        }
+    }
+    // Flush cache for the output tile on every node
+    rows_tile_handle.mpi_flush();
+}
+
+//! Blocking version of tensor-wise marking of rows of embeddings
+/*! @param[in] index: Tokens (indices of embeddings)
+ * @param[inout] rows: Marks of touched rows
+ * */
+void embedding_rows(const Tensor<Index> &index, const Tensor<bool_t> &rows)
+{
+    embedding_rows_async(index, rows);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+} // namespace tensor
+} // namespace nntile
+
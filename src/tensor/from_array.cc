@@ -0,0 +1,179 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/from_array.cc
+ * Copy a contiguous host array into Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-12
+ * */
+
+#include "nntile/tensor/from_array.hh"
+#include "nntile/starpu/from_array.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous copy of a host array into tiles of a tensor
+/*! Each tile is filled by its own task directly from the array, so no
+ * intermediate single-tile tensor is needed and tiles are filled in
+ * parallel. The array is read only on MPI node 0, tiles of other nodes are
+ * filled on node 0 and then sent to their owners. The array must stay alive
+ * until all the tasks are finished.
+ *
+ * @param[in] array: Contiguous array in Fortran order of the same shape as
+ *      the tensor
+ * @param[inout] dst: Destination tensor
+ * */
+template<typename T>
+void from_array_async(const T *array, const Tensor<T> &dst)
+{
+    constexpr int root_rank = 0;
+    int mpi_rank = starpu_mpi_world_rank();
+    // Strides of the array
+    Index ndim = dst.ndim;
+    std::vector<Index> array_stride(ndim), array_start(ndim);
+    if(ndim > 0)
+    {
+        array_stride[0] = 1;
+    }
+    for(Index k = 1; k < ndim; ++k)
+    {
+        array_stride[k] = array_stride[k-1] * dst.shape[k-1];
+    }
+    // Temporary buffer for indexing, that is allocated per-worker when needed.
+    // Scalar tensors need no indexing, but StarPU needs a non-empty buffer.
+    starpu::VariableHandle scratch(std::max(3*ndim, Index(1))*sizeof(Index),
+            STARPU_SCRATCH);
+    // Cycle through all destination tiles
+    for(Index i = 0; i < dst.grid.nelems; ++i)
+    {
+        auto dst_tile_handle = dst.get_tile_handle(i);
+        int dst_tile_rank = dst_tile_handle.mpi_get_rank();
+        // Flush cache for the output tile on every node
+        dst_tile_handle.mpi_flush();
+        // Execute on root node and then send result
+        if(mpi_rank == root_rank)
+        {
+            auto dst_tile_index = dst.grid.linear_to_index(i);
+            auto dst_tile_traits = dst.get_tile_traits(i);
+            for(Index k = 0; k < ndim; ++k)
+            {
+                array_start[k] = dst_tile_index[k] * dst.basetile_shape[k];
+            }
+            starpu::from_array::submit<T>(ndim, array, array_start,
+                    array_stride, dst_tile_traits.shape,
+                    dst_tile_traits.stride, dst_tile_handle, scratch);
+            // Perform MPI copy only if destination node is different
+            if(mpi_rank != dst_tile_rank)
+            {
+                // No need to check for cached send, as output was just updated
+#ifdef NNTILE_USE_MPI
+                int ret = starpu_mpi_isend_detached(
+                        static_cast<starpu_data_handle_t>(dst_tile_handle),
+                        dst_tile_rank, dst_tile_handle.mpi_get_tag(),
+                        MPI_COMM_WORLD, nullptr, nullptr);
+                if(ret != 0)
+                {
+                    throw std::runtime_error("Error in starpu_mpi_isend_"
+                            "detached");
+                }
+#endif // NNTILE_USE_MPI
+            }
+        }
+        // Init receive of the tile for its owner
+        else if(mpi_rank == dst_tile_rank)
+        {
+            // No need to check for cached recv, as output was just updated
+#ifdef NNTILE_USE_MPI
+            int ret = starpu_mpi_irecv_detached(
+                    static_cast<starpu_data_handle_t>(dst_tile_handle),
+                    root_rank, dst_tile_handle.mpi_get_tag(),
+                    MPI_COMM_WORLD, nullptr, nullptr);
+            if(ret != 0)
+            {
+                throw std::runtime_error("Error in starpu_mpi_irecv_"
+                        "detached");
+            }
+#endif // NNTILE_USE_MPI
+        }
+    }
+}
+
+//! Blocking version of copy of a host array into tiles of a tensor
+/*! Each tile is filled by its own task directly from the array, so no
+ * intermediate single-tile tensor is needed and tiles are filled in
+ * parallel. The array is read only on MPI node 0.
+ *
+ * @param[in] array: Contiguous array in Fortran order of the same shape as
+ *      the tensor
+ * @param[inout] dst: Destination tensor
+ * */
+template<typename T>
+void from_array(const T *array, const Tensor<T> &dst)
+{
+    from_array_async<T>(array, dst);
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+    starpu_task_wait_for_all();
+}
+
+// Explicit instantiation
+template
+void from_array_async<fp16_t>(const fp16_t *array,
+        const Tensor<fp16_t> &dst);
+
+template
+void from_array_async<bf16_t>(const bf16_t *array,
+        const Tensor<bf16_t> &dst);
+
+template
+void from_array_async<fp32_t>(const fp32_t *array,
+        const Tensor<fp32_t> &dst);
+
+template
+void from_array_async<fp64_t>(const fp64_t *array,
+        const Tensor<fp64_t> &dst);
+
+template
+void from_array_async<Index>(const Index *array, const Tensor<Index> &dst);
+
+template
+void from_array_async<bool_t>(const bool_t *array,
+        const Tensor<bool_t> &dst);
+
+template
+void from_array_async<int8_t>(const int8_t *array,
+        const Tensor<int8_t> &dst);
+
+// Explicit instantiation
+template
+void from_array<fp16_t>(const fp16_t *array, const Tensor<fp16_t> &dst);
+
+template
+void from_array<bf16_t>(const bf16_t *array, const Tensor<bf16_t> &dst);
+
+template
+void from_array<fp32_t>(const fp32_t *array, const Tensor<fp32_t> &dst);
+
+template
+void from_array<fp64_t>(const fp64_t *array, const Tensor<fp64_t> &dst);
+
+template
+void from_array<Index>(const Index *array, const Tensor<Index> &dst);
+
+template
+void from_array<bool_t>(const bool_t *array, const Tensor<bool_t> &dst);
+
+template
+void from_array<int8_t>(const int8_t *array, const Tensor<int8_t> &dst);
+
+} // namespace tensor
+} // namespace nntile
+
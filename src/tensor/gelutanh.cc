@@ -87,6 +87,10 @@ template
 void gelutanh_async<fp64_t>(const Tensor<fp64_t> &src,
         const Tensor<fp64_t> &dst);
 
+template
+void gelutanh_async<bf16_t>(const Tensor<bf16_t> &src,
+        const Tensor<bf16_t> &dst);
+
 // Explicit instantiation
 template
 void gelutanh<fp32_t>(const Tensor<fp32_t> &src, const Tensor<fp32_t> &dst);
@@ -94,6 +98,9 @@ void gelutanh<fp32_t>(const Tensor<fp32_t> &src, const Tensor<fp32_t> &dst);
 template
 void gelutanh<fp64_t>(const Tensor<fp64_t> &src, const Tensor<fp64_t> &dst);
 
+template
+void gelutanh<bf16_t>(const Tensor<bf16_t> &src, const Tensor<bf16_t> &dst);
+
 } // namespace tensor
 } // namespace nntile
 
@@ -515,6 +515,12 @@ void gemm_async<fp16_t, fp32_t>(fp32_t alpha, const TransOp &transA,
         const TransOp &transB, const Tensor<fp16_t> &B, fp32_t beta,
         const Tensor<fp16_t> &C, Index ndim, Index batch_ndim, int redux);
 
+template
+void gemm_async<bf16_t, fp32_t>(fp32_t alpha, const TransOp &transA,
+        const Tensor<bf16_t> &A,
+        const TransOp &transB, const Tensor<bf16_t> &B, fp32_t beta,
+        const Tensor<bf16_t> &C, Index ndim, Index batch_ndim, int redux);
+
 // Explicit instantiation
 template
 void gemm<fp32_t, fp32_t>(fp32_t alpha, const TransOp &transA,
@@ -534,6 +540,12 @@ void gemm<fp16_t, fp32_t>(fp32_t alpha, const TransOp &transA,
         const TransOp &transB, const Tensor<fp16_t> &B, fp32_t beta,
         const Tensor<fp16_t> &C, Index ndim, Index batch_ndim, int redux);
 
+template
+void gemm<bf16_t, fp32_t>(fp32_t alpha, const TransOp &transA,
+        const Tensor<bf16_t> &A,
+        const TransOp &transB, const Tensor<bf16_t> &B, fp32_t beta,
+        const Tensor<bf16_t> &C, Index ndim, Index batch_ndim, int redux);
+
 } // namespace tensor
 } // namespace nntile
 
@@ -0,0 +1,209 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/gemm_int8.cc
+ * Multiplication of Tensor<T> by per-channel quantized int8 weights
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-20
+ * */
+
+#include "nntile/tensor/gemm_int8.hh"
+#include "nntile/tensor/gemm.hh"
+#include "nntile/starpu/gemm_int8.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Check if tensors match gemm_int8
+/*! Weights are stored as w[in..., out...], so the product is checked as
+ * gemm(w^T, x) for TransOp::NoTrans and as gemm(x, w) for TransOp::Trans.
+ * */
+void gemm_int8_check(const TransOp &trans, const TensorTraits &w,
+        const TensorTraits &w_scale, const TensorTraits &x,
+        const TensorTraits &y, Index ndim)
+{
+    constexpr TransOp opN(TransOp::NoTrans), opT(TransOp::Trans);
+    switch(trans.value)
+    {
+        case TransOp::NoTrans:
+            gemm_check(opT, w, opN, x, y, ndim, 0);
+            break;
+        case TransOp::Trans:
+            gemm_check(opN, x, opN, w, y, ndim, 0);
+            break;
+        default:
+            throw std::runtime_error("Wrong value of trans");
+    }
+    // Scales correspond to output channels of weights
+    if(w_scale.ndim != w.ndim-ndim)
+    {
+        throw std::runtime_error("w_scale.ndim != w.ndim-ndim");
+    }
+    for(Index i = 0; i < w_scale.ndim; ++i)
+    {
+        if(w_scale.shape[i] != w.shape[ndim+i])
+        {
+            throw std::runtime_error("w_scale.shape != w.shape[ndim:]");
+        }
+        if(w_scale.basetile_shape[i] != w.basetile_shape[ndim+i])
+        {
+            throw std::runtime_error("w_scale.basetile_shape != "
+                    "w.basetile_shape[ndim:]");
+        }
+    }
+}
+
+//! Asynchronous tensor-wise multiplication by int8 weights
+/*! Computes y = alpha*W*x + beta*y for TransOp::NoTrans and
+ * y = alpha*x*W^T + beta*y for TransOp::Trans, where W is a dequantized
+ * weight matrix of shape [out..., in...]. Quantized weights w are stored
+ * transposed, i.e. with shape [in..., out...], together with per-channel
+ * scales w_scale of shape [out...]. Input x is quantized dynamically by
+ * every task, each of its vectors (columns for TransOp::NoTrans and rows for
+ * TransOp::Trans) gets its own scale. Products are accumulated in 32-bit
+ * integers within a tile and in type T across tiles.
+ *
+ * @param[in] alpha: Scalar multiplier for the product
+ * @param[in] trans: Layout of x and y. x is [in..., batch...] and y is
+ *      [out..., batch...] for TransOp::NoTrans, while x is [batch..., in...]
+ *      and y is [batch..., out...] for TransOp::Trans
+ * @param[in] w: Quantized weights
+ * @param[in] w_scale: Scales of output channels of weights
+ * @param[in] x: Input tensor
+ * @param[in] beta: Scalar multiplier for y
+ * @param[inout] y: Output tensor
+ * @param[in] ndim: Number of input channel dimensions
+ * */
+template<typename T>
+void gemm_int8_async(T alpha, const TransOp &trans, const Tensor<int8_t> &w,
+        const Tensor<T> &w_scale, const Tensor<T> &x, T beta,
+        const Tensor<T> &y, Index ndim)
+{
+    // Check inputs (throw exception in case of an error)
+    gemm_int8_check(trans, w, w_scale, x, y, ndim);
+    int mpi_rank = starpu_mpi_world_rank();
+    constexpr T one = 1;
+    Index batch_ndim = x.ndim - ndim;
+    // Sizes of tensors as grids of tiles
+    Index m = w.grid.matrix_shape[ndim][1];
+    Index k = w.grid.matrix_shape[ndim][0];
+    Index n;
+    // Strides of grids of x and y in terms of (k,n) and (m,n) coordinates
+    std::array<Index, 2> x_stride, y_stride;
+    switch(trans.value)
+    {
+        case TransOp::NoTrans:
+            n = x.grid.matrix_shape[ndim][1];
+            x_stride = {1, k};
+            y_stride = {1, m};
+            break;
+        // This parameter was already checked
+        //case TransOp::Trans:
+        default:
+            n = x.grid.matrix_shape[batch_ndim][0];
+            x_stride = {n, 1};
+            y_stride = {n, 1};
+            break;
+    }
+    // Scratch for the largest tile
+    Index batch_start = (trans.value == TransOp::NoTrans) ? ndim : 0;
+    Index scratch_n = 1, scratch_k = 1;
+    for(Index i = 0; i < ndim; ++i)
+    {
+        scratch_k *= w.basetile_shape[i];
+    }
+    for(Index i = 0; i < batch_ndim; ++i)
+    {
+        scratch_n *= x.basetile_shape[batch_start+i];
+    }
+    starpu::VariableHandle scratch(
+            starpu::gemm_int8::scratch_size<T>(scratch_n, scratch_k),
+            STARPU_SCRATCH);
+    for(Index j = 0; j < n; ++j)
+    {
+        for(Index i = 0; i < m; ++i)
+        {
+            Index y_tile_offset = i*y_stride[0] + j*y_stride[1];
+            auto y_tile_handle = y.get_tile_handle(y_tile_offset);
+            auto y_tile_traits = y.get_tile_traits(y_tile_offset);
+            int y_tile_rank = y_tile_handle.mpi_get_rank();
+            auto w_scale_tile_handle = w_scale.get_tile_handle(i);
+            w_scale_tile_handle.mpi_transfer(y_tile_rank, mpi_rank);
+            for(Index l = 0; l < k; ++l)
+            {
+                // y(i,j) = alpha*W(i,l)*x(l,j) + beta*y(i,j) for l=0 and
+                // y(i,j) += alpha*W(i,l)*x(l,j) for all other l
+                Index w_tile_offset = l + i*k;
+                Index x_tile_offset = l*x_stride[0] + j*x_stride[1];
+                auto w_tile_handle = w.get_tile_handle(w_tile_offset);
+                auto x_tile_handle = x.get_tile_handle(x_tile_offset);
+                // Transfer tiles of w and x on node with tile y
+                w_tile_handle.mpi_transfer(y_tile_rank, mpi_rank);
+                x_tile_handle.mpi_transfer(y_tile_rank, mpi_rank);
+                // Execute on node with tile y
+                if(mpi_rank == y_tile_rank)
+                {
+                    auto w_tile_traits = w.get_tile_traits(w_tile_offset);
+                    Index tile_m = w_tile_traits.matrix_shape[ndim][1];
+                    Index tile_k = w_tile_traits.matrix_shape[ndim][0];
+                    Index tile_n = y_tile_traits.nelems / tile_m;
+                    starpu::gemm_int8::submit<T>(trans, tile_m, tile_n,
+                            tile_k, alpha, w_tile_handle, w_scale_tile_handle,
+                            x_tile_handle, l == 0 ? beta : one, y_tile_handle,
+                            scratch);
+                }
+            }
+            // Flush cache for the output tile on every node
+            y_tile_handle.mpi_flush();
+        }
+    }
+}
+
+//! Blocking version of tensor-wise multiplication by int8 weights
+/*! Computes y = alpha*W*x + beta*y for TransOp::NoTrans and
+ * y = alpha*x*W^T + beta*y for TransOp::Trans, where W is a dequantized
+ * weight matrix of shape [out..., in...].
+ *
+ * @param[in] alpha: Scalar multiplier for the product
+ * @param[in] trans: Layout of x and y
+ * @param[in] w: Quantized weights of shape [in..., out...]
+ * @param[in] w_scale: Scales of output channels of weights
+ * @param[in] x: Input tensor
+ * @param[in] beta: Scalar multiplier for y
+ * @param[inout] y: Output tensor
+ * @param[in] ndim: Number of input channel dimensions
+ * */
+template<typename T>
+void gemm_int8(T alpha, const TransOp &trans, const Tensor<int8_t> &w,
+        const Tensor<T> &w_scale, const Tensor<T> &x, T beta,
+        const Tensor<T> &y, Index ndim)
+{
+    gemm_int8_async<T>(alpha, trans, w, w_scale, x, beta, y, ndim);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void gemm_int8_async<fp32_t>(fp32_t alpha, const TransOp &trans,
+        const Tensor<int8_t> &w, const Tensor<fp32_t> &w_scale,
+        const Tensor<fp32_t> &x, fp32_t beta, const Tensor<fp32_t> &y,
+        Index ndim);
+
+// Explicit instantiation
+template
+void gemm_int8<fp32_t>(fp32_t alpha, const TransOp &trans,
+        const Tensor<int8_t> &w, const Tensor<fp32_t> &w_scale,
+        const Tensor<fp32_t> &x, fp32_t beta, const Tensor<fp32_t> &y,
+        Index ndim);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,271 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/layer_norm_backward.cc
+ * Fused backward pass of layer normalization for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-08
+ * */
+
+#include "nntile/tensor/layer_norm_backward.hh"
+#include "nntile/starpu/layer_norm_backward.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void layer_norm_backward_async(const Tensor<T> &src_normalized,
+        const Tensor<T> &dst_grad, const Tensor<T> &gamma,
+        const Tensor<T> &inv_stddev, const Tensor<T> &src_grad,
+        const Tensor<T> &gamma_grad, const Tensor<T> &beta_grad, Index axis,
+        int redux)
+//! Tensor<T> gradients of layer normalization along a given axis
+/*! Fused version of the backward sequence of sum_fiber, sumprod_fiber,
+ * prod_fiber3, sumprod_slice, prod_slice, axpy, sum_slice and add_slice
+ * operations. Reshapes tensors into 3-dimensional arrays and performs the
+ * following operations:
+ *      beta_grad[l] += sum(dst_grad[:,l,:])
+ *      gamma_grad[l] += sum(dst_grad[:,l,:]*src_normalized[:,l,:])
+ *      g[i,l,j] = gamma[l] * dst_grad[i,l,j]
+ *      src_grad[i,l,j] += inv_stddev[i,j] * (g[i,l,j] - mean(g[i,:,j])
+ *          - src_normalized[i,l,j]*mean(g[i,:,j]*src_normalized[i,:,j]))
+ *
+ * Normalized axis must not be split into several tiles. Tiles of gamma_grad
+ * and beta_grad are updated by all the tasks, so they must be owned by the
+ * same MPI node as tiles of src_grad.
+ *
+ * @param[in] src_normalized: Normalized input of the forward pass
+ * @param[in] dst_grad: Gradient of output
+ * @param[in] gamma: Scaling factors, a fiber along axis
+ * @param[in] inv_stddev: Inverse standard deviations of the forward pass,
+ *      a slice without axis
+ * @param[inout] src_grad: Accumulated gradient of input
+ * @param[inout] gamma_grad: Accumulated gradient of gamma
+ * @param[inout] beta_grad: Accumulated gradient of beta
+ * @param[in] axis: Normalized axis
+ * @param[in] redux: Whether to use STARPU_REDUX for gamma_grad and beta_grad
+ * */
+{
+    // Check dimensions
+    if(src_normalized.ndim == 0)
+    {
+        throw std::runtime_error("Scalar input makes no sense");
+    }
+    if(src_normalized.ndim-1 != inv_stddev.ndim)
+    {
+        throw std::runtime_error("src_normalized.ndim-1 != inv_stddev.ndim");
+    }
+    if(gamma.ndim != 1)
+    {
+        throw std::runtime_error("gamma.ndim != 1");
+    }
+    // Check axis
+    if(axis < 0)
+    {
+        throw std::runtime_error("axis < 0");
+    }
+    if(axis >= src_normalized.ndim)
+    {
+        throw std::runtime_error("axis >= src_normalized.ndim");
+    }
+    if(src_normalized.grid.shape[axis] != 1)
+    {
+        throw std::runtime_error("src_normalized.grid.shape[axis] != 1");
+    }
+    // Check shapes of tensors
+    if(src_normalized.shape != dst_grad.shape)
+    {
+        throw std::runtime_error("src_normalized.shape != dst_grad.shape");
+    }
+    if(src_normalized.basetile_shape != dst_grad.basetile_shape)
+    {
+        throw std::runtime_error("src_normalized.basetile_shape != "
+                "dst_grad.basetile_shape");
+    }
+    if(src_normalized.shape != src_grad.shape)
+    {
+        throw std::runtime_error("src_normalized.shape != src_grad.shape");
+    }
+    if(src_normalized.basetile_shape != src_grad.basetile_shape)
+    {
+        throw std::runtime_error("src_normalized.basetile_shape != "
+                "src_grad.basetile_shape");
+    }
+    if(gamma.shape[0] != src_normalized.shape[axis])
+    {
+        throw std::runtime_error("gamma.shape[0] != "
+                "src_normalized.shape[axis]");
+    }
+    if(gamma.basetile_shape[0] != src_normalized.basetile_shape[axis])
+    {
+        throw std::runtime_error("gamma.basetile_shape[0] != "
+                "src_normalized.basetile_shape[axis]");
+    }
+    if(gamma.shape != gamma_grad.shape or gamma.shape != beta_grad.shape)
+    {
+        throw std::runtime_error("gamma.shape != gamma_grad.shape or "
+                "gamma.shape != beta_grad.shape");
+    }
+    if(gamma.basetile_shape != gamma_grad.basetile_shape
+            or gamma.basetile_shape != beta_grad.basetile_shape)
+    {
+        throw std::runtime_error("gamma.basetile_shape != "
+                "gamma_grad.basetile_shape or gamma.basetile_shape != "
+                "beta_grad.basetile_shape");
+    }
+    for(Index i = 0; i < axis; i++)
+    {
+        if(src_normalized.shape[i] != inv_stddev.shape[i])
+        {
+            throw std::runtime_error("src_normalized.shape[i] != "
+                    "inv_stddev.shape[i]");
+        }
+        if(src_normalized.basetile_shape[i] != inv_stddev.basetile_shape[i])
+        {
+            throw std::runtime_error("src_normalized.basetile_shape[i] != "
+                    "inv_stddev.basetile_shape[i]");
+        }
+    }
+    for(Index i = axis+1; i < src_normalized.ndim; i++)
+    {
+        if(src_normalized.shape[i] != inv_stddev.shape[i-1])
+        {
+            throw std::runtime_error("src_normalized.shape[i] != "
+                    "inv_stddev.shape[i-1]");
+        }
+        if(src_normalized.basetile_shape[i]
+                != inv_stddev.basetile_shape[i-1])
+        {
+            throw std::runtime_error("src_normalized.basetile_shape[i] != "
+                    "inv_stddev.basetile_shape[i-1]");
+        }
+    }
+    // Apply per-tile layer_norm_backward asynchronously
+    int mpi_rank = starpu_mpi_world_rank();
+    auto gamma_tile_handle = gamma.get_tile_handle(0);
+    auto gamma_grad_tile_handle = gamma_grad.get_tile_handle(0);
+    auto beta_grad_tile_handle = beta_grad.get_tile_handle(0);
+    int grad_tile_rank = gamma_grad_tile_handle.mpi_get_rank();
+    if(beta_grad_tile_handle.mpi_get_rank() != grad_tile_rank)
+    {
+        throw std::runtime_error("gamma_grad and beta_grad are owned by "
+                "different MPI nodes");
+    }
+    for(Index i = 0; i < inv_stddev.grid.nelems; ++i)
+    {
+        // Index of a tile of src is the same as of inv_stddev with 0
+        // inserted at axis position
+        auto inv_stddev_tile_index = inv_stddev.grid.linear_to_index(i);
+        std::vector<Index> src_tile_index(src_normalized.ndim);
+        for(Index j = 0, k = 0; j < src_normalized.ndim; ++j)
+        {
+            if(j == axis)
+            {
+                src_tile_index[j] = 0;
+                continue;
+            }
+            src_tile_index[j] = inv_stddev_tile_index[k];
+            ++k;
+        }
+        Index src_tile_offset = src_normalized.grid.index_to_linear(
+                src_tile_index);
+        auto src_normalized_tile_handle = src_normalized.get_tile_handle(
+                src_tile_offset);
+        auto dst_grad_tile_handle = dst_grad.get_tile_handle(
+                src_tile_offset);
+        auto src_grad_tile_handle = src_grad.get_tile_handle(
+                src_tile_offset);
+        auto inv_stddev_tile_handle = inv_stddev.get_tile_handle(i);
+        int src_grad_tile_rank = src_grad_tile_handle.mpi_get_rank();
+        if(src_grad_tile_rank != grad_tile_rank)
+        {
+            throw std::runtime_error("src_grad and gamma_grad tiles are "
+                    "owned by different MPI nodes");
+        }
+        // Transfer data
+        src_normalized_tile_handle.mpi_transfer(src_grad_tile_rank,
+                mpi_rank);
+        dst_grad_tile_handle.mpi_transfer(src_grad_tile_rank, mpi_rank);
+        gamma_tile_handle.mpi_transfer(src_grad_tile_rank, mpi_rank);
+        inv_stddev_tile_handle.mpi_transfer(src_grad_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == src_grad_tile_rank)
+        {
+            // Reshape inputs: src_tile -> (m,k,n), inv_stddev_tile -> (m,n)
+            auto src_tile_traits = src_normalized.get_tile_traits(
+                    src_tile_offset);
+            Index m, n, k;
+            m = src_tile_traits.stride[axis];
+            n = src_tile_traits.matrix_shape[axis+1][1];
+            k = src_tile_traits.shape[axis];
+            // Insert corresponding task
+            starpu::layer_norm_backward::submit<T>(m, n, k,
+                    src_normalized_tile_handle, dst_grad_tile_handle,
+                    gamma_tile_handle, inv_stddev_tile_handle,
+                    src_grad_tile_handle, gamma_grad_tile_handle,
+                    beta_grad_tile_handle, redux);
+        }
+        // Flush cache for the output tile on every node
+        src_grad_tile_handle.mpi_flush();
+    }
+    // Flush cache for the accumulated gradients on every node
+    gamma_grad_tile_handle.mpi_flush();
+    beta_grad_tile_handle.mpi_flush();
+}
+
+template<typename T>
+void layer_norm_backward(const Tensor<T> &src_normalized,
+        const Tensor<T> &dst_grad, const Tensor<T> &gamma,
+        const Tensor<T> &inv_stddev, const Tensor<T> &src_grad,
+        const Tensor<T> &gamma_grad, const Tensor<T> &beta_grad, Index axis,
+        int redux)
+//! Tensor<T> gradients of layer normalization along a given axis
+/*! Blocking version of layer_norm_backward_async<T>.
+ * */
+{
+    layer_norm_backward_async<T>(src_normalized, dst_grad, gamma, inv_stddev,
+            src_grad, gamma_grad, beta_grad, axis, redux);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation of template
+template
+void layer_norm_backward_async<fp32_t>(const Tensor<fp32_t> &src_normalized,
+        const Tensor<fp32_t> &dst_grad, const Tensor<fp32_t> &gamma,
+        const Tensor<fp32_t> &inv_stddev, const Tensor<fp32_t> &src_grad,
+        const Tensor<fp32_t> &gamma_grad, const Tensor<fp32_t> &beta_grad,
+        Index axis, int redux);
+
+template
+void layer_norm_backward_async<fp64_t>(const Tensor<fp64_t> &src_normalized,
+        const Tensor<fp64_t> &dst_grad, const Tensor<fp64_t> &gamma,
+        const Tensor<fp64_t> &inv_stddev, const Tensor<fp64_t> &src_grad,
+        const Tensor<fp64_t> &gamma_grad, const Tensor<fp64_t> &beta_grad,
+        Index axis, int redux);
+
+// Explicit instantiation of template
+template
+void layer_norm_backward<fp32_t>(const Tensor<fp32_t> &src_normalized,
+        const Tensor<fp32_t> &dst_grad, const Tensor<fp32_t> &gamma,
+        const Tensor<fp32_t> &inv_stddev, const Tensor<fp32_t> &src_grad,
+        const Tensor<fp32_t> &gamma_grad, const Tensor<fp32_t> &beta_grad,
+        Index axis, int redux);
+
+template
+void layer_norm_backward<fp64_t>(const Tensor<fp64_t> &src_normalized,
+        const Tensor<fp64_t> &dst_grad, const Tensor<fp64_t> &gamma,
+        const Tensor<fp64_t> &inv_stddev, const Tensor<fp64_t> &src_grad,
+        const Tensor<fp64_t> &gamma_grad, const Tensor<fp64_t> &beta_grad,
+        Index axis, int redux);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,259 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/layer_norm_forward.cc
+ * Fused forward pass of layer normalization for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-08
+ * */
+
+#include "nntile/tensor/layer_norm_forward.hh"
+#include "nntile/starpu/layer_norm_forward.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+template<typename T>
+void layer_norm_forward_async(T eps, const Tensor<T> &src,
+        const Tensor<T> &gamma, const Tensor<T> &beta, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &src_normalized,
+        const Tensor<T> &dst, Index axis)
+//! Tensor<T> layer normalization along a given axis
+/*! Fused version of the sum_slice, add_slice3, norm_slice,
+ * hypot_scalar_inverse, prod_slice, prod_fiber3 and add_fiber sequence.
+ * Reshapes src into 3-dimensional array and performs the following
+ * operations:
+ *      mean[i,j] = sum(src[i,:,j]) / src.shape[axis]
+ *      inv_stddev[i,j] = 1 / sqrt(variance(src[i,:,j]) + eps^2)
+ *      src_normalized[i,l,j] = (src[i,l,j]-mean[i,j]) * inv_stddev[i,j]
+ *      dst[i,l,j] = gamma[l]*src_normalized[i,l,j] + beta[l]
+ *
+ * Normalized axis must not be split into several tiles, as each task
+ * processes entire fibers at once. Tiles of all the outputs, related to the
+ * same tile of src, must be owned by the same MPI node.
+ *
+ * @param[in] eps: Regularization of the standard deviation
+ * @param[in] src: Input tensor
+ * @param[in] gamma: Scaling factors, a fiber along axis
+ * @param[in] beta: Shifts, a fiber along axis
+ * @param[out] mean: Means of fibers, a slice without axis
+ * @param[out] inv_stddev: Inverse standard deviations of fibers, a slice
+ *      without axis
+ * @param[out] src_normalized: Normalized input, that is required by the
+ *      backward pass
+ * @param[out] dst: Output tensor
+ * @param[in] axis: Normalized axis
+ * */
+{
+    // Check dimensions
+    if(src.ndim == 0)
+    {
+        throw std::runtime_error("Scalar input makes no sense");
+    }
+    if(src.ndim-1 != mean.ndim)
+    {
+        throw std::runtime_error("src.ndim-1 != mean.ndim");
+    }
+    if(gamma.ndim != 1)
+    {
+        throw std::runtime_error("gamma.ndim != 1");
+    }
+    // Check axis
+    if(axis < 0)
+    {
+        throw std::runtime_error("axis < 0");
+    }
+    if(axis >= src.ndim)
+    {
+        throw std::runtime_error("axis >= src.ndim");
+    }
+    if(src.grid.shape[axis] != 1)
+    {
+        throw std::runtime_error("src.grid.shape[axis] != 1");
+    }
+    // Check shapes of tensors
+    if(src.shape != dst.shape)
+    {
+        throw std::runtime_error("src.shape != dst.shape");
+    }
+    if(src.basetile_shape != dst.basetile_shape)
+    {
+        throw std::runtime_error("src.basetile_shape != dst.basetile_shape");
+    }
+    if(src.shape != src_normalized.shape)
+    {
+        throw std::runtime_error("src.shape != src_normalized.shape");
+    }
+    if(src.basetile_shape != src_normalized.basetile_shape)
+    {
+        throw std::runtime_error("src.basetile_shape != "
+                "src_normalized.basetile_shape");
+    }
+    if(gamma.shape[0] != src.shape[axis])
+    {
+        throw std::runtime_error("gamma.shape[0] != src.shape[axis]");
+    }
+    if(gamma.basetile_shape[0] != src.basetile_shape[axis])
+    {
+        throw std::runtime_error("gamma.basetile_shape[0] != "
+                "src.basetile_shape[axis]");
+    }
+    if(gamma.shape != beta.shape)
+    {
+        throw std::runtime_error("gamma.shape != beta.shape");
+    }
+    if(gamma.basetile_shape != beta.basetile_shape)
+    {
+        throw std::runtime_error("gamma.basetile_shape != "
+                "beta.basetile_shape");
+    }
+    if(mean.shape != inv_stddev.shape)
+    {
+        throw std::runtime_error("mean.shape != inv_stddev.shape");
+    }
+    if(mean.basetile_shape != inv_stddev.basetile_shape)
+    {
+        throw std::runtime_error("mean.basetile_shape != "
+                "inv_stddev.basetile_shape");
+    }
+    for(Index i = 0; i < axis; i++)
+    {
+        if(src.shape[i] != mean.shape[i])
+        {
+            throw std::runtime_error("src.shape[i] != mean.shape[i]");
+        }
+        if(src.basetile_shape[i] != mean.basetile_shape[i])
+        {
+            throw std::runtime_error("src.basetile_shape[i] != "
+                    "mean.basetile_shape[i]");
+        }
+    }
+    for(Index i = axis+1; i < src.ndim; i++)
+    {
+        if(src.shape[i] != mean.shape[i-1])
+        {
+            throw std::runtime_error("src.shape[i] != mean.shape[i-1]");
+        }
+        if(src.basetile_shape[i] != mean.basetile_shape[i-1])
+        {
+            throw std::runtime_error("src.basetile_shape[i] != "
+                    "mean.basetile_shape[i-1]");
+        }
+    }
+    // Apply per-tile layer_norm_forward asynchronously
+    int mpi_rank = starpu_mpi_world_rank();
+    auto gamma_tile_handle = gamma.get_tile_handle(0);
+    auto beta_tile_handle = beta.get_tile_handle(0);
+    for(Index i = 0; i < mean.grid.nelems; ++i)
+    {
+        // Index of a tile of src is the same as of mean with 0 inserted at
+        // axis position
+        auto mean_tile_index = mean.grid.linear_to_index(i);
+        std::vector<Index> src_tile_index(src.ndim);
+        for(Index j = 0, k = 0; j < src.ndim; ++j)
+        {
+            if(j == axis)
+            {
+                src_tile_index[j] = 0;
+                continue;
+            }
+            src_tile_index[j] = mean_tile_index[k];
+            ++k;
+        }
+        Index src_tile_offset = src.grid.index_to_linear(src_tile_index);
+        auto src_tile_handle = src.get_tile_handle(src_tile_offset);
+        auto dst_tile_handle = dst.get_tile_handle(src_tile_offset);
+        auto src_normalized_tile_handle = src_normalized.get_tile_handle(
+                src_tile_offset);
+        auto mean_tile_handle = mean.get_tile_handle(i);
+        auto inv_stddev_tile_handle = inv_stddev.get_tile_handle(i);
+        int dst_tile_rank = dst_tile_handle.mpi_get_rank();
+        if(src_normalized_tile_handle.mpi_get_rank() != dst_tile_rank
+                or mean_tile_handle.mpi_get_rank() != dst_tile_rank
+                or inv_stddev_tile_handle.mpi_get_rank() != dst_tile_rank)
+        {
+            throw std::runtime_error("Output tiles of layer_norm_forward "
+                    "are owned by different MPI nodes");
+        }
+        // Transfer data
+        src_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        gamma_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        beta_tile_handle.mpi_transfer(dst_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == dst_tile_rank)
+        {
+            // Reshape inputs: src_tile -> (m,k,n), mean_tile -> (m,n)
+            auto src_tile_traits = src.get_tile_traits(src_tile_offset);
+            Index m, n, k;
+            m = src_tile_traits.stride[axis];
+            n = src_tile_traits.matrix_shape[axis+1][1];
+            k = src_tile_traits.shape[axis];
+            // Insert corresponding task
+            starpu::layer_norm_forward::submit<T>(m, n, k, eps,
+                    src_tile_handle, gamma_tile_handle, beta_tile_handle,
+                    mean_tile_handle, inv_stddev_tile_handle,
+                    src_normalized_tile_handle, dst_tile_handle);
+        }
+        // Flush cache for the output tiles on every node
+        mean_tile_handle.mpi_flush();
+        inv_stddev_tile_handle.mpi_flush();
+        src_normalized_tile_handle.mpi_flush();
+        dst_tile_handle.mpi_flush();
+    }
+}
+
+template<typename T>
+void layer_norm_forward(T eps, const Tensor<T> &src, const Tensor<T> &gamma,
+        const Tensor<T> &beta, const Tensor<T> &mean,
+        const Tensor<T> &inv_stddev, const Tensor<T> &src_normalized,
+        const Tensor<T> &dst, Index axis)
+//! Tensor<T> layer normalization along a given axis
+/*! Blocking version of layer_norm_forward_async<T>.
+ * */
+{
+    layer_norm_forward_async<T>(eps, src, gamma, beta, mean, inv_stddev,
+            src_normalized, dst, axis);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation of template
+template
+void layer_norm_forward_async<fp32_t>(fp32_t eps, const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &gamma, const Tensor<fp32_t> &beta,
+        const Tensor<fp32_t> &mean, const Tensor<fp32_t> &inv_stddev,
+        const Tensor<fp32_t> &src_normalized, const Tensor<fp32_t> &dst,
+        Index axis);
+
+template
+void layer_norm_forward_async<fp64_t>(fp64_t eps, const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &gamma, const Tensor<fp64_t> &beta,
+        const Tensor<fp64_t> &mean, const Tensor<fp64_t> &inv_stddev,
+        const Tensor<fp64_t> &src_normalized, const Tensor<fp64_t> &dst,
+        Index axis);
+
+// Explicit instantiation of template
+template
+void layer_norm_forward<fp32_t>(fp32_t eps, const Tensor<fp32_t> &src,
+        const Tensor<fp32_t> &gamma, const Tensor<fp32_t> &beta,
+        const Tensor<fp32_t> &mean, const Tensor<fp32_t> &inv_stddev,
+        const Tensor<fp32_t> &src_normalized, const Tensor<fp32_t> &dst,
+        Index axis);
+
+template
+void layer_norm_forward<fp64_t>(fp64_t eps, const Tensor<fp64_t> &src,
+        const Tensor<fp64_t> &gamma, const Tensor<fp64_t> &beta,
+        const Tensor<fp64_t> &mean, const Tensor<fp64_t> &inv_stddev,
+        const Tensor<fp64_t> &src_normalized, const Tensor<fp64_t> &dst,
+        Index axis);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -146,6 +146,10 @@ template
 void maxsumexp_async<fp64_t>(const Tensor<fp64_t> &src,
         const Tensor<fp64_t> &dst, Index axis, int redux);
 
+template
+void maxsumexp_async<bf16_t>(const Tensor<bf16_t> &src,
+        const Tensor<bf16_t> &dst, Index axis, int redux);
+
 // Explicit instantiation
 template
 void maxsumexp<fp32_t>(const Tensor<fp32_t> &src, const Tensor<fp32_t> &dst,
@@ -155,6 +159,10 @@ template
 void maxsumexp<fp64_t>(const Tensor<fp64_t> &src, const Tensor<fp64_t> &dst,
         Index axis, int redux);
 
+template
+void maxsumexp<bf16_t>(const Tensor<bf16_t> &src, const Tensor<bf16_t> &dst,
+        Index axis, int redux);
+
 } // namespace tensor
 } // namespace nntile
 
@@ -0,0 +1,261 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/multi_adam_step.cc
+ * Fused Adam step over many tensors with packing of small tiles
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/tensor/multi_adam_step.hh"
+#include "nntile/starpu/multi_adam_step.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous fused Adam step over many tensors
+/*! Tiles of all the parameters are processed in order and packed into
+ * StarPU tasks: a task gets consecutive tiles until their total number of
+ * elements exceeds pack_nelems or the number of tiles reaches the limit on
+ * buffers of a task. A tile, that is larger than pack_nelems, gets its own
+ * task. This way thousands of tiny tiles of biases and normalization
+ * parameters are updated by a few tasks instead of a task per tile. Only
+ * tiles, owned by the same node, are packed together. Moments are stored
+ * either in type T or in bf16_t. The latter halves memory footprint of
+ * moments for fp32_t parameters, while stochastic rounding keeps them
+ * unbiased. Seeds for the rounding depend on the iteration number and the
+ * order of a tile on its node, so the result is reproducible.
+ *
+ * @param[in] num_iter: current iteration number
+ * @param[in] beta_1: parameter for moving average of first moments
+ * @param[in] beta_2: parameter for moving average of second moments
+ * @param[in] eps: small scalar to avoid division by zero
+ * @param[in] lr: learning rate
+ * @param[in] weight_decay: coefficient for weight decay
+ * @param[in] decoupled: Whether weight decay is decoupled as in AdamW
+ * @param[in] grad: Gradients of parameters
+ * @param[inout] first_moment: First moments
+ * @param[inout] second_moment: Square roots of second moments
+ * @param[inout] p: Parameters
+ * @param[in] pack_nelems: Maximal total number of elements of tiles, that
+ *      are packed into a single task
+ * */
+template<typename T, typename M>
+void multi_adam_step_async(Index num_iter, T beta_1, T beta_2, T eps, T lr,
+        T weight_decay, int decoupled, const std::vector<Tensor<T>> &grad,
+        const std::vector<Tensor<M>> &first_moment,
+        const std::vector<Tensor<M>> &second_moment,
+        const std::vector<Tensor<T>> &p, Index pack_nelems)
+{
+    // Limit number of buffers of a single task
+    constexpr Index pack_ntiles = 64;
+    // Check inputs
+    if(num_iter <= 0)
+    {
+        throw std::runtime_error("num_iter <= 0");
+    }
+    if(pack_nelems < 0)
+    {
+        throw std::runtime_error("pack_nelems < 0");
+    }
+    if(grad.size() != p.size())
+    {
+        throw std::runtime_error("grad.size() != p.size()");
+    }
+    if(first_moment.size() != p.size())
+    {
+        throw std::runtime_error("first_moment.size() != p.size()");
+    }
+    if(second_moment.size() != p.size())
+    {
+        throw std::runtime_error("second_moment.size() != p.size()");
+    }
+    for(std::size_t k = 0; k < p.size(); ++k)
+    {
+        if(p[k].shape != grad[k].shape)
+        {
+            throw std::runtime_error("p.shape != grad.shape");
+        }
+        if(p[k].basetile_shape != grad[k].basetile_shape)
+        {
+            throw std::runtime_error("p.basetile_shape != "
+                    "grad.basetile_shape");
+        }
+        if(p[k].shape != first_moment[k].shape)
+        {
+            throw std::runtime_error("p.shape != first_moment.shape");
+        }
+        if(p[k].basetile_shape != first_moment[k].basetile_shape)
+        {
+            throw std::runtime_error("p.basetile_shape != "
+                    "first_moment.basetile_shape");
+        }
+        if(p[k].shape != second_moment[k].shape)
+        {
+            throw std::runtime_error("p.shape != second_moment.shape");
+        }
+        if(p[k].basetile_shape != second_moment[k].basetile_shape)
+        {
+            throw std::runtime_error("p.basetile_shape != "
+                    "second_moment.basetile_shape");
+        }
+    }
+    int mpi_rank = starpu_mpi_world_rank();
+    // Tiles of the current pack of this node
+    std::vector<starpu::Handle> pack_grad, pack_first_moment,
+        pack_second_moment, pack_p;
+    Index pack_size = 0;
+    // Seed for stochastic rounding of the first tile of the pack
+    Index seed = num_iter << 32;
+    auto submit_pack = [&]()
+    {
+        if(pack_p.empty())
+        {
+            return;
+        }
+        starpu::multi_adam_step::submit<T, M>(num_iter, beta_1, beta_2, eps,
+                lr, weight_decay, decoupled, seed, pack_grad,
+                pack_first_moment, pack_second_moment, pack_p);
+        seed += pack_p.size();
+        pack_grad.clear();
+        pack_first_moment.clear();
+        pack_second_moment.clear();
+        pack_p.clear();
+        pack_size = 0;
+    };
+    for(std::size_t k = 0; k < p.size(); ++k)
+    {
+        for(Index i = 0; i < p[k].grid.nelems; ++i)
+        {
+            auto p_tile_handle = p[k].get_tile_handle(i);
+            auto grad_tile_handle = grad[k].get_tile_handle(i);
+            auto first_moment_tile_handle = first_moment[k].get_tile_handle(
+                    i);
+            auto second_moment_tile_handle =
+                second_moment[k].get_tile_handle(i);
+            int p_tile_rank = p_tile_handle.mpi_get_rank();
+            // Transfer data to the node, that owns parameters
+            grad_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+            first_moment_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+            second_moment_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+            // Add tile to the pack on destination node
+            if(mpi_rank == p_tile_rank)
+            {
+                Index tile_nelems = p[k].get_tile_traits(i).nelems;
+                if(pack_size+tile_nelems > pack_nelems)
+                {
+                    submit_pack();
+                }
+                pack_grad.push_back(grad_tile_handle);
+                pack_first_moment.push_back(first_moment_tile_handle);
+                pack_second_moment.push_back(second_moment_tile_handle);
+                pack_p.push_back(p_tile_handle);
+                pack_size += tile_nelems;
+                if(pack_size >= pack_nelems
+                        or Index(pack_p.size()) == pack_ntiles)
+                {
+                    submit_pack();
+                }
+            }
+        }
+    }
+    submit_pack();
+    // Flush cache for the output tiles on every node
+    for(std::size_t k = 0; k < p.size(); ++k)
+    {
+        for(Index i = 0; i < p[k].grid.nelems; ++i)
+        {
+            p[k].get_tile_handle(i).mpi_flush();
+        }
+    }
+}
+
+//! Blocking version of fused Adam step over many tensors
+/*! @param[in] num_iter: current iteration number
+ * @param[in] beta_1: parameter for moving average of first moments
+ * @param[in] beta_2: parameter for moving average of second moments
+ * @param[in] eps: small scalar to avoid division by zero
+ * @param[in] lr: learning rate
+ * @param[in] weight_decay: coefficient for weight decay
+ * @param[in] decoupled: Whether weight decay is decoupled as in AdamW
+ * @param[in] grad: Gradients of parameters
+ * @param[inout] first_moment: First moments
+ * @param[inout] second_moment: Square roots of second moments
+ * @param[inout] p: Parameters
+ * @param[in] pack_nelems: Maximal total number of elements of tiles, that
+ *      are packed into a single task
+ * */
+template<typename T, typename M>
+void multi_adam_step(Index num_iter, T beta_1, T beta_2, T eps, T lr,
+        T weight_decay, int decoupled, const std::vector<Tensor<T>> &grad,
+        const std::vector<Tensor<M>> &first_moment,
+        const std::vector<Tensor<M>> &second_moment,
+        const std::vector<Tensor<T>> &p, Index pack_nelems)
+{
+    multi_adam_step_async<T, M>(num_iter, beta_1, beta_2, eps, lr,
+            weight_decay, decoupled, grad, first_moment, second_moment, p,
+            pack_nelems);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void multi_adam_step_async<fp32_t>(Index num_iter, fp32_t beta_1,
+        fp32_t beta_2, fp32_t eps, fp32_t lr, fp32_t weight_decay,
+        int decoupled, const std::vector<Tensor<fp32_t>> &grad,
+        const std::vector<Tensor<fp32_t>> &first_moment,
+        const std::vector<Tensor<fp32_t>> &second_moment,
+        const std::vector<Tensor<fp32_t>> &p, Index pack_nelems);
+
+template
+void multi_adam_step_async<fp64_t>(Index num_iter, fp64_t beta_1,
+        fp64_t beta_2, fp64_t eps, fp64_t lr, fp64_t weight_decay,
+        int decoupled, const std::vector<Tensor<fp64_t>> &grad,
+        const std::vector<Tensor<fp64_t>> &first_moment,
+        const std::vector<Tensor<fp64_t>> &second_moment,
+        const std::vector<Tensor<fp64_t>> &p, Index pack_nelems);
+
+template
+void multi_adam_step_async<fp32_t, bf16_t>(Index num_iter, fp32_t beta_1,
+        fp32_t beta_2, fp32_t eps, fp32_t lr, fp32_t weight_decay,
+        int decoupled, const std::vector<Tensor<fp32_t>> &grad,
+        const std::vector<Tensor<bf16_t>> &first_moment,
+        const std::vector<Tensor<bf16_t>> &second_moment,
+        const std::vector<Tensor<fp32_t>> &p, Index pack_nelems);
+
+// Explicit instantiation
+template
+void multi_adam_step<fp32_t>(Index num_iter, fp32_t beta_1, fp32_t beta_2,
+        fp32_t eps, fp32_t lr, fp32_t weight_decay, int decoupled,
+        const std::vector<Tensor<fp32_t>> &grad,
+        const std::vector<Tensor<fp32_t>> &first_moment,
+        const std::vector<Tensor<fp32_t>> &second_moment,
+        const std::vector<Tensor<fp32_t>> &p, Index pack_nelems);
+
+template
+void multi_adam_step<fp64_t>(Index num_iter, fp64_t beta_1, fp64_t beta_2,
+        fp64_t eps, fp64_t lr, fp64_t weight_decay, int decoupled,
+        const std::vector<Tensor<fp64_t>> &grad,
+        const std::vector<Tensor<fp64_t>> &first_moment,
+        const std::vector<Tensor<fp64_t>> &second_moment,
+        const std::vector<Tensor<fp64_t>> &p, Index pack_nelems);
+
+template
+void multi_adam_step<fp32_t, bf16_t>(Index num_iter, fp32_t beta_1,
+        fp32_t beta_2, fp32_t eps, fp32_t lr, fp32_t weight_decay,
+        int decoupled, const std::vector<Tensor<fp32_t>> &grad,
+        const std::vector<Tensor<bf16_t>> &first_moment,
+        const std::vector<Tensor<bf16_t>> &second_moment,
+        const std::vector<Tensor<fp32_t>> &p, Index pack_nelems);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -185,6 +185,11 @@ void softmax_async<fp64_t>(const Tensor<fp64_t> &maxsumexp,
         const Tensor<fp64_t> &src, fp64_t alpha, const Tensor<fp64_t> &dst,
         Index axis);
 
+template
+void softmax_async<bf16_t>(const Tensor<bf16_t> &maxsumexp,
+        const Tensor<bf16_t> &src, bf16_t alpha, const Tensor<bf16_t> &dst,
+        Index axis);
+
 // Explicit instantiation
 template
 void softmax<fp32_t>(const Tensor<fp32_t> &maxsumexp,
@@ -196,6 +201,11 @@ void softmax<fp64_t>(const Tensor<fp64_t> &maxsumexp,
         const Tensor<fp64_t> &src, fp64_t alpha, const Tensor<fp64_t> &dst,
         Index axis);
 
+template
+void softmax<bf16_t>(const Tensor<bf16_t> &maxsumexp,
+        const Tensor<bf16_t> &src, bf16_t alpha, const Tensor<bf16_t> &dst,
+        Index axis);
+
 } // namespace tensor
 } // namespace nntile
 
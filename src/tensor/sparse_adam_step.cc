@@ -0,0 +1,215 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/sparse_adam_step.cc
+ * Lazy Adam step over marked rows of a matrix for Tensor<T>
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/tensor/sparse_adam_step.hh"
+#include "nntile/starpu/sparse_adam_step.hh"
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous tensor-wise lazy Adam step over marked rows
+/*! Parameters are a table of embeddings of shape [embed, vocab], whose rows
+ * are indexed by the last axis. Only marked rows are updated, see
+ * kernel::sparse_adam_step::cpu() for the details. Every tile of parameters
+ * keeps its own counters of steps for its rows, so row_step is of shape
+ * [p.grid.shape[0], p.shape[1]] with base tile [1, p.basetile_shape[1]],
+ * and every tile of row_step is owned by the same node as the corresponding
+ * tile of parameters.
+ *
+ * @param[in] beta_1: parameter for moving average of first moments
+ * @param[in] beta_2: parameter for moving average of second moments
+ * @param[in] eps: small scalar to avoid division by zero
+ * @param[in] lr: learning rate
+ * @param[in] weight_decay: coefficient for weight decay
+ * @param[in] decoupled: Whether weight decay is decoupled as in AdamW
+ * @param[in] rows: Marks of touched rows
+ * @param[inout] row_step: Numbers of steps, that updated each row
+ * @param[in] grad: Gradient, which is zero outside of marked rows
+ * @param[inout] first_moment: First moments
+ * @param[inout] second_moment: Square roots of second moments
+ * @param[inout] p: Parameters
+ * */
+template<typename T>
+void sparse_adam_step_async(T beta_1, T beta_2, T eps, T lr, T weight_decay,
+        int decoupled, const Tensor<bool_t> &rows,
+        const Tensor<Index> &row_step, const Tensor<T> &grad,
+        const Tensor<T> &first_moment, const Tensor<T> &second_moment,
+        const Tensor<T> &p)
+{
+    // Check dimensions
+    if(p.ndim != 2)
+    {
+        throw std::runtime_error("p.ndim != 2");
+    }
+    if(rows.ndim != 1)
+    {
+        throw std::runtime_error("rows.ndim != 1");
+    }
+    if(row_step.ndim != 2)
+    {
+        throw std::runtime_error("row_step.ndim != 2");
+    }
+    // Check shapes
+    if(p.shape != grad.shape)
+    {
+        throw std::runtime_error("p.shape != grad.shape");
+    }
+    if(p.basetile_shape != grad.basetile_shape)
+    {
+        throw std::runtime_error("p.basetile_shape != grad.basetile_shape");
+    }
+    if(p.shape != first_moment.shape)
+    {
+        throw std::runtime_error("p.shape != first_moment.shape");
+    }
+    if(p.basetile_shape != first_moment.basetile_shape)
+    {
+        throw std::runtime_error("p.basetile_shape != "
+                "first_moment.basetile_shape");
+    }
+    if(p.shape != second_moment.shape)
+    {
+        throw std::runtime_error("p.shape != second_moment.shape");
+    }
+    if(p.basetile_shape != second_moment.basetile_shape)
+    {
+        throw std::runtime_error("p.basetile_shape != "
+                "second_moment.basetile_shape");
+    }
+    if(rows.shape[0] != p.shape[1])
+    {
+        throw std::runtime_error("rows.shape[0] != p.shape[1]");
+    }
+    if(rows.basetile_shape[0] != p.basetile_shape[1])
+    {
+        throw std::runtime_error("rows.basetile_shape[0] != "
+                "p.basetile_shape[1]");
+    }
+    if(row_step.shape[0] != p.grid.shape[0])
+    {
+        throw std::runtime_error("row_step.shape[0] != p.grid.shape[0]");
+    }
+    if(row_step.shape[1] != p.shape[1])
+    {
+        throw std::runtime_error("row_step.shape[1] != p.shape[1]");
+    }
+    if(row_step.basetile_shape[0] != 1)
+    {
+        throw std::runtime_error("row_step.basetile_shape[0] != 1");
+    }
+    if(row_step.basetile_shape[1] != p.basetile_shape[1])
+    {
+        throw std::runtime_error("row_step.basetile_shape[1] != "
+                "p.basetile_shape[1]");
+    }
+    // Apply per-tile
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < p.grid.nelems; ++i)
+    {
+        auto p_tile_handle = p.get_tile_handle(i);
+        int p_tile_rank = p_tile_handle.mpi_get_rank();
+        auto p_tile_index = p.grid.linear_to_index(i);
+        // Counters of steps are updated on the node, that owns parameters
+        auto row_step_tile_handle = row_step.get_tile_handle(p_tile_index);
+        if(row_step_tile_handle.mpi_get_rank() != p_tile_rank)
+        {
+            throw std::runtime_error("row_step_tile_rank != p_tile_rank");
+        }
+        auto rows_tile_handle = rows.get_tile_handle(p_tile_index[1]);
+        auto grad_tile_handle = grad.get_tile_handle(i);
+        auto first_moment_tile_handle = first_moment.get_tile_handle(i);
+        auto second_moment_tile_handle = second_moment.get_tile_handle(i);
+        // Transfer data to the node, that owns parameters
+        rows_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        grad_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        first_moment_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        second_moment_tile_handle.mpi_transfer(p_tile_rank, mpi_rank);
+        // Execute on destination node
+        if(mpi_rank == p_tile_rank)
+        {
+            auto p_tile_traits = p.get_tile_traits(i);
+            starpu::sparse_adam_step::submit<T>(p_tile_traits.shape[0],
+                    p_tile_traits.shape[1], beta_1, beta_2, eps, lr,
+                    weight_decay, decoupled, rows_tile_handle,
+                    row_step_tile_handle, grad_tile_handle,
+                    first_moment_tile_handle, second_moment_tile_handle,
+                    p_tile_handle);
+        }
+        // Flush cache for the output tile on every node
+        p_tile_handle.mpi_flush();
+    }
+}
+
+//! Blocking version of tensor-wise lazy Adam step over marked rows
+/*! @param[in] beta_1: parameter for moving average of first moments
+ * @param[in] beta_2: parameter for moving average of second moments
+ * @param[in] eps: small scalar to avoid division by zero
+ * @param[in] lr: learning rate
+ * @param[in] weight_decay: coefficient for weight decay
+ * @param[in] decoupled: Whether weight decay is decoupled as in AdamW
+ * @param[in] rows: Marks of touched rows
+ * @param[inout] row_step: Numbers of steps, that updated each row
+ * @param[in] grad: Gradient, which is zero outside of marked rows
+ * @param[inout] first_moment: First moments
+ * @param[inout] second_moment: Square roots of second moments
+ * @param[inout] p: Parameters
+ * */
+template<typename T>
+void sparse_adam_step(T beta_1, T beta_2, T eps, T lr, T weight_decay,
+        int decoupled, const Tensor<bool_t> &rows,
+        const Tensor<Index> &row_step, const Tensor<T> &grad,
+        const Tensor<T> &first_moment, const Tensor<T> &second_moment,
+        const Tensor<T> &p)
+{
+    sparse_adam_step_async<T>(beta_1, beta_2, eps, lr, weight_decay,
+            decoupled, rows, row_step, grad, first_moment, second_moment, p);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void sparse_adam_step_async<fp32_t>(fp32_t beta_1, fp32_t beta_2, fp32_t eps,
+        fp32_t lr, fp32_t weight_decay, int decoupled,
+        const Tensor<bool_t> &rows, const Tensor<Index> &row_step,
+        const Tensor<fp32_t> &grad, const Tensor<fp32_t> &first_moment,
+        const Tensor<fp32_t> &second_moment, const Tensor<fp32_t> &p);
+
+template
+void sparse_adam_step_async<fp64_t>(fp64_t beta_1, fp64_t beta_2, fp64_t eps,
+        fp64_t lr, fp64_t weight_decay, int decoupled,
+        const Tensor<bool_t> &rows, const Tensor<Index> &row_step,
+        const Tensor<fp64_t> &grad, const Tensor<fp64_t> &first_moment,
+        const Tensor<fp64_t> &second_moment, const Tensor<fp64_t> &p);
+
+// Explicit instantiation
+template
+void sparse_adam_step<fp32_t>(fp32_t beta_1, fp32_t beta_2, fp32_t eps,
+        fp32_t lr, fp32_t weight_decay, int decoupled,
+        const Tensor<bool_t> &rows, const Tensor<Index> &row_step,
+        const Tensor<fp32_t> &grad, const Tensor<fp32_t> &first_moment,
+        const Tensor<fp32_t> &second_moment, const Tensor<fp32_t> &p);
+
+template
+void sparse_adam_step<fp64_t>(fp64_t beta_1, fp64_t beta_2, fp64_t eps,
+        fp64_t lr, fp64_t weight_decay, int decoupled,
+        const Tensor<bool_t> &rows, const Tensor<Index> &row_step,
+        const Tensor<fp64_t> &grad, const Tensor<fp64_t> &first_moment,
+        const Tensor<fp64_t> &second_moment, const Tensor<fp64_t> &p);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -0,0 +1,140 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file src/tensor/to_array.cc
+ * Copy Tensor<T> into a contiguous host array
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-12
+ * */
+
+#include "nntile/tensor/to_array.hh"
+#include "nntile/starpu/to_array.hh"
+#include <algorithm>
+
+namespace nntile
+{
+namespace tensor
+{
+
+//! Asynchronous copy of tiles of a tensor into a host array
+/*! Each tile is copied by its own task directly into the array, so no
+ * intermediate single-tile tensor is needed and tiles are copied in
+ * parallel. The array is written only on MPI node 0, tiles of other nodes are
+ * transferred to node 0 first. The array must stay alive until all the tasks
+ * are finished.
+ *
+ * @param[in] src: Source tensor
+ * @param[out] array: Contiguous array in Fortran order of the same shape as
+ *      the tensor
+ * */
+template<typename T>
+void to_array_async(const Tensor<T> &src, T *array)
+{
+    constexpr int root_rank = 0;
+    int mpi_rank = starpu_mpi_world_rank();
+    // Strides of the array
+    Index ndim = src.ndim;
+    std::vector<Index> array_stride(ndim), array_start(ndim);
+    if(ndim > 0)
+    {
+        array_stride[0] = 1;
+    }
+    for(Index k = 1; k < ndim; ++k)
+    {
+        array_stride[k] = array_stride[k-1] * src.shape[k-1];
+    }
+    // Temporary buffer for indexing, that is allocated per-worker when needed.
+    // Scalar tensors need no indexing, but StarPU needs a non-empty buffer.
+    starpu::VariableHandle scratch(std::max(3*ndim, Index(1))*sizeof(Index),
+            STARPU_SCRATCH);
+    // Cycle through all source tiles
+    for(Index i = 0; i < src.grid.nelems; ++i)
+    {
+        auto src_tile_handle = src.get_tile_handle(i);
+        // Transfer source tile to root node
+        src_tile_handle.mpi_transfer(root_rank, mpi_rank);
+        // Execute on root node
+        if(mpi_rank == root_rank)
+        {
+            auto src_tile_index = src.grid.linear_to_index(i);
+            auto src_tile_traits = src.get_tile_traits(i);
+            for(Index k = 0; k < ndim; ++k)
+            {
+                array_start[k] = src_tile_index[k] * src.basetile_shape[k];
+            }
+            starpu::to_array::submit<T>(ndim, array, array_start,
+                    array_stride, src_tile_traits.shape,
+                    src_tile_traits.stride, src_tile_handle, scratch);
+        }
+    }
+}
+
+//! Blocking version of copy of tiles of a tensor into a host array
+/*! Each tile is copied by its own task directly into the array, so no
+ * intermediate single-tile tensor is needed and tiles are copied in
+ * parallel. The array is written only on MPI node 0.
+ *
+ * @param[in] src: Source tensor
+ * @param[out] array: Contiguous array in Fortran order of the same shape as
+ *      the tensor
+ * */
+template<typename T>
+void to_array(const Tensor<T> &src, T *array)
+{
+    to_array_async<T>(src, array);
+    starpu_task_wait_for_all();
+    starpu_mpi_wait_for_all(MPI_COMM_WORLD);
+}
+
+// Explicit instantiation
+template
+void to_array_async<fp16_t>(const Tensor<fp16_t> &src, fp16_t *array);
+
+template
+void to_array_async<bf16_t>(const Tensor<bf16_t> &src, bf16_t *array);
+
+template
+void to_array_async<fp32_t>(const Tensor<fp32_t> &src, fp32_t *array);
+
+template
+void to_array_async<fp64_t>(const Tensor<fp64_t> &src, fp64_t *array);
+
+template
+void to_array_async<Index>(const Tensor<Index> &src, Index *array);
+
+template
+void to_array_async<bool_t>(const Tensor<bool_t> &src, bool_t *array);
+
+template
+void to_array_async<int8_t>(const Tensor<int8_t> &src, int8_t *array);
+
+// Explicit instantiation
+template
+void to_array<fp16_t>(const Tensor<fp16_t> &src, fp16_t *array);
+
+template
+void to_array<bf16_t>(const Tensor<bf16_t> &src, bf16_t *array);
+
+template
+void to_array<fp32_t>(const Tensor<fp32_t> &src, fp32_t *array);
+
+template
+void to_array<fp64_t>(const Tensor<fp64_t> &src, fp64_t *array);
+
+template
+void to_array<Index>(const Tensor<Index> &src, Index *array);
+
+template
+void to_array<bool_t>(const Tensor<bool_t> &src, bool_t *array);
+
+template
+void to_array<int8_t>(const Tensor<int8_t> &src, int8_t *array);
+
+} // namespace tensor
+} // namespace nntile
+
@@ -63,8 +63,8 @@ void copy_intersection_async(const Tile<T> &src,
     // Treat special case of ndim=0
     if(ndim == 0)
     {
-        ret = starpu_data_cpy(static_cast<starpu_data_handle_t>(dst),
-                static_cast<starpu_data_handle_t>(src), 1, nullptr, nullptr);
+        ret = starpu::data_cpy(static_cast<starpu_data_handle_t>(dst),
+                static_cast<starpu_data_handle_t>(src));
         if(ret != 0)
         {
             throw std::runtime_error("Error in starpu_data_cpy");
@@ -74,8 +74,8 @@ void copy_intersection_async(const Tile<T> &src,
     // Treat easy case of full copy
     if(src_offset == dst_offset and src.shape == dst.shape)
     {
-        ret = starpu_data_cpy(static_cast<starpu_data_handle_t>(dst),
-                static_cast<starpu_data_handle_t>(src), 1, nullptr, nullptr);
+        ret = starpu::data_cpy(static_cast<starpu_data_handle_t>(dst),
+                static_cast<starpu_data_handle_t>(src));
         if(ret != 0)
         {
             throw std::runtime_error("Error in starpu_data_cpy");
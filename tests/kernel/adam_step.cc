@@ -12,12 +12,260 @@
  * @date 2023-11-26
  * */
 
+#include "nntile/kernel/adam_step.hh"
+#include "nntile/kernel/adamw_step.hh"
+#include "../testing.hh"
+#include <vector>
+#include <limits>
+#include <cmath>
 #include <iostream>
 
+using namespace nntile;
+using namespace nntile::kernel::adam_step;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index num_iter, Index num_elems, T beta_1, T beta_2, T eps,
+        T lr, T weight_decay, const std::vector<T> &grad,
+        std::vector<T> &first_moment, std::vector<T> &second_moment,
+        std::vector<T> &p)
+{
+    // Alloc on device
+    T *dev_grad, *dev_first_moment, *dev_second_moment, *dev_p;
+    cudaError_t cuda_err = cudaMalloc(&dev_grad, sizeof(T)*num_elems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_first_moment, sizeof(T)*num_elems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_second_moment, sizeof(T)*num_elems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_p, sizeof(T)*num_elems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy to device
+    cuda_err = cudaMemcpy(dev_grad, &grad[0], sizeof(T)*num_elems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_first_moment, &first_moment[0],
+            sizeof(T)*num_elems, cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_second_moment, &second_moment[0],
+            sizeof(T)*num_elems, cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_p, &p[0], sizeof(T)*num_elems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, num_iter, num_elems, beta_1, beta_2, eps, lr,
+            weight_decay, dev_grad, dev_first_moment, dev_second_moment,
+            dev_p);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&first_moment[0], dev_first_moment,
+            sizeof(T)*num_elems, cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&second_moment[0], dev_second_moment,
+            sizeof(T)*num_elems, cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&p[0], dev_p, sizeof(T)*num_elems,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_grad);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_first_moment);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_second_moment);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_p);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check results against reference in max-norm, as moments may lose relative
+// accuracy due to cancellation
+template<typename T>
+void check(const std::vector<T> &val, const std::vector<T> &val_ref)
+{
+    constexpr T tol = 100 * std::numeric_limits<T>::epsilon();
+    T diff = 0, norm = 0;
+    for(Index i = 0; i < Index(val.size()); ++i)
+    {
+        diff = std::max(diff, std::abs(val[i]-val_ref[i]));
+        norm = std::max(norm, std::abs(val_ref[i]));
+    }
+    TEST_ASSERT(diff <= tol*norm);
+}
+
+// Templated validation
+template<typename T>
+void validate(Index num_elems, T weight_decay, int decoupled)
+{
+    T beta_1 = 0.9, beta_2 = 0.999, eps = 1e-8, lr = 1e-2;
+    constexpr Index nsteps = 3;
+    // Scalar reference with the same formulas as the kernel
+    std::vector<T> p_ref(num_elems), first_ref(num_elems),
+        second_ref(num_elems);
+    for(Index i = 0; i < num_elems; ++i)
+    {
+        p_ref[i] = T(std::cos(T(i+1)));
+    }
+    std::vector<T> p(p_ref), first_moment(num_elems),
+        second_moment(num_elems);
+#ifdef NNTILE_USE_CUDA
+    std::vector<T> p_cuda(p_ref), first_cuda(num_elems),
+        second_cuda(num_elems);
+#endif // NNTILE_USE_CUDA
+    std::cout << "Run kernel::adam_step::cpu<T>\n";
+    for(Index num_iter = 1; num_iter <= nsteps; ++num_iter)
+    {
+        std::vector<T> grad(num_elems);
+        for(Index i = 0; i < num_elems; ++i)
+        {
+            grad[i] = T(std::sin(T(i*nsteps+num_iter)));
+        }
+        T alpha = lr / (1-std::pow(beta_1, num_iter));
+        T beta = 1 / std::sqrt(1-std::pow(beta_2, num_iter));
+        for(Index i = 0; i < num_elems; ++i)
+        {
+            T g = grad[i];
+            if(decoupled != 0)
+            {
+                p_ref[i] *= 1 - lr*weight_decay;
+            }
+            else
+            {
+                g += weight_decay * p_ref[i];
+            }
+            first_ref[i] = beta_1*first_ref[i] + (1-beta_1)*g;
+            second_ref[i] = std::hypot(std::sqrt(beta_2)*second_ref[i],
+                    std::sqrt(1-beta_2)*g);
+            p_ref[i] -= alpha * first_ref[i] / (second_ref[i]*beta+eps);
+        }
+        if(decoupled != 0)
+        {
+            nntile::kernel::adamw_step::cpu<T>(num_iter, num_elems, beta_1,
+                    beta_2, eps, lr, weight_decay, &grad[0],
+                    &first_moment[0], &second_moment[0], &p[0]);
+        }
+        else
+        {
+            cpu<T>(num_iter, num_elems, beta_1, beta_2, eps, lr,
+                    weight_decay, &grad[0], &first_moment[0],
+                    &second_moment[0], &p[0]);
+        }
+#ifdef NNTILE_USE_CUDA
+        if(decoupled == 0)
+        {
+            run_cuda<T>(num_iter, num_elems, beta_1, beta_2, eps, lr,
+                    weight_decay, grad, first_cuda, second_cuda, p_cuda);
+        }
+#endif // NNTILE_USE_CUDA
+    }
+    check<T>(p, p_ref);
+    check<T>(first_moment, first_ref);
+    check<T>(second_moment, second_ref);
+    std::cout << "OK: kernel::adam_step::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    if(decoupled == 0)
+    {
+        std::cout << "Run kernel::adam_step::cuda<T>\n";
+        check<T>(p_cuda, p_ref);
+        check<T>(first_cuda, first_ref);
+        check<T>(second_cuda, second_ref);
+        std::cout << "OK: kernel::adam_step::cuda<T>\n";
+    }
+#endif // NNTILE_USE_CUDA
+}
+
+// Validation of moments stored in bf16_t with stochastic rounding
+void validate_bf16(Index num_elems)
+{
+    using T = fp32_t;
+    T beta_1 = 0.9, beta_2 = 0.999, eps = 1e-8, lr = 1e-2,
+      weight_decay = 0.1;
+    constexpr Index nsteps = 3;
+    std::vector<T> p(num_elems), first_moment(num_elems),
+        second_moment(num_elems);
+    for(Index i = 0; i < num_elems; ++i)
+    {
+        p[i] = T(std::cos(T(i+1)));
+    }
+    std::vector<T> p_bf16(p), first_bf16_ref(num_elems),
+        second_bf16_ref(num_elems);
+    std::vector<bf16_t> first_bf16(num_elems), second_bf16(num_elems);
+    std::cout << "Run kernel::adam_step::cpu_apply<T> with bf16_t moments\n";
+    for(Index num_iter = 1; num_iter <= nsteps; ++num_iter)
+    {
+        std::vector<T> grad(num_elems);
+        for(Index i = 0; i < num_elems; ++i)
+        {
+            grad[i] = T(std::sin(T(i*nsteps+num_iter)));
+        }
+        T alpha = lr / (1-std::pow(beta_1, num_iter));
+        T beta = 1 / std::sqrt(1-std::pow(beta_2, num_iter));
+        // Reference step starts from the same rounded moments
+        for(Index i = 0; i < num_elems; ++i)
+        {
+            first_moment[i] = first_bf16[i];
+            second_moment[i] = second_bf16[i];
+        }
+        p = p_bf16;
+        cpu_apply<T>(num_elems, num_iter == 1, beta_1, beta_2, eps, alpha,
+                beta, weight_decay, T(1), &grad[0], &first_moment[0],
+                &second_moment[0], &p[0]);
+        cpu_apply<T>(num_elems, num_iter == 1, beta_1, beta_2, eps, alpha,
+                beta, weight_decay, T(1), num_iter, &grad[0],
+                &first_bf16[0], &second_bf16[0], &p_bf16[0]);
+        // Parameters are updated with moments before rounding
+        check<T>(p_bf16, p);
+        // Moments are rounded either up or down
+        for(Index i = 0; i < num_elems; ++i)
+        {
+            T first_val = first_bf16[i], second_val = second_bf16[i];
+            T ulp = T(1) / T(128);
+            TEST_ASSERT(std::abs(first_val-first_moment[i])
+                    <= ulp*std::abs(first_moment[i]));
+            TEST_ASSERT(std::abs(second_val-second_moment[i])
+                    <= ulp*second_moment[i]);
+        }
+    }
+    // Rounding is unbiased: the mean of rounded values of the same moment is
+    // much closer to it than half of the distance between bf16_t neighbours
+    constexpr Index nsamples = 10000;
+    std::vector<T> grad(nsamples, T(1)/T(3)), p_samples(nsamples);
+    std::vector<bf16_t> first_samples(nsamples), second_samples(nsamples);
+    cpu_apply<T>(nsamples, true, beta_1, beta_2, eps, lr, T(1), T(0), T(1),
+            Index(1), &grad[0], &first_samples[0], &second_samples[0],
+            &p_samples[0]);
+    T first_ref = (1-beta_1) * grad[0];
+    T first_mean = 0;
+    for(Index i = 0; i < nsamples; ++i)
+    {
+        first_mean += T(first_samples[i]);
+    }
+    first_mean /= nsamples;
+    T first_ulp = std::ldexp(T(1), std::ilogb(first_ref)-7);
+    TEST_ASSERT(std::abs(first_mean-first_ref) <= T(0.05)*first_ulp);
+    std::cout << "OK: kernel::adam_step::cpu_apply<T> with bf16_t moments\n";
+}
+
 int main(int argc, char **argv)
 {
-    // Not implemented
-    std::cout << "This test is not yet implemented\n";
-    return -1;
+    validate<fp32_t>(1, 0, 0);
+    validate<fp32_t>(1000, 0, 0);
+    validate<fp32_t>(1000, 0.1, 0);
+    validate<fp32_t>(1000, 0.1, 1);
+    validate<fp64_t>(1, 0, 0);
+    validate<fp64_t>(1000, 0, 0);
+    validate<fp64_t>(1000, 0.1, 0);
+    validate<fp64_t>(1000, 0.1, 1);
+    validate_bf16(1);
+    validate_bf16(10000);
+    return 0;
 }
 
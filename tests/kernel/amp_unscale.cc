@@ -0,0 +1,143 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/amp_unscale.cc
+ * Unscale gradients and check them for infinite and NaN values
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-19
+ * */
+
+#include "nntile/kernel/amp_unscale.hh"
+#include "../testing.hh"
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::kernel::amp_unscale;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index nelems, T inv_scale, std::vector<T> &data,
+        bool_t &nonfinite)
+{
+    // Alloc on device
+    T *dev_data;
+    bool_t *dev_nonfinite;
+    cudaError_t cuda_err = cudaMalloc(&dev_data, sizeof(T)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_nonfinite, sizeof(bool_t));
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy to device
+    cuda_err = cudaMemcpy(dev_data, &data[0], sizeof(T)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_nonfinite, &nonfinite, sizeof(bool_t),
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, nelems, inv_scale, dev_data, dev_nonfinite);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&data[0], dev_data, sizeof(T)*nelems,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&nonfinite, dev_nonfinite, sizeof(bool_t),
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_data);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_nonfinite);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Run kernel on a copy of data and check result against reference
+template<typename T>
+void check(Index nelems, T inv_scale, const std::vector<T> &data,
+        bool_t nonfinite_ref)
+{
+    std::vector<T> data2(data);
+    bool_t nonfinite = false;
+    std::cout << "Run kernel::amp_unscale::cpu<T>\n";
+    cpu<T>(nelems, inv_scale, &data2[0], &nonfinite);
+    TEST_ASSERT(nonfinite == nonfinite_ref);
+    // Data is unscaled even if there are non-finite values
+    for(Index i = 0; i < nelems; ++i)
+    {
+        if(std::isfinite(data[i]))
+        {
+            TEST_ASSERT(data2[i] == inv_scale*data[i]);
+        }
+    }
+    // Flag is never cleared
+    nonfinite = true;
+    data2 = data;
+    cpu<T>(nelems, inv_scale, &data2[0], &nonfinite);
+    TEST_ASSERT(nonfinite);
+    std::cout << "OK: kernel::amp_unscale::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    data2 = data;
+    nonfinite = false;
+    std::cout << "Run kernel::amp_unscale::cuda<T>\n";
+    run_cuda<T>(nelems, inv_scale, data2, nonfinite);
+    TEST_ASSERT(nonfinite == nonfinite_ref);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        if(std::isfinite(data[i]))
+        {
+            TEST_ASSERT(data2[i] == inv_scale*data[i]);
+        }
+    }
+    std::cout << "OK: kernel::amp_unscale::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+// Templated validation
+template<typename T>
+void validate(Index nelems)
+{
+    T inv_scale = 1.0 / 1024;
+    // Init test input
+    std::vector<T> data(nelems);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        data[i] = T(2*i+1-nelems) * T{1000};
+    }
+    check<T>(nelems, inv_scale, data, false);
+    // Single non-finite value at different positions
+    constexpr T inf = std::numeric_limits<T>::infinity(),
+              nan = std::numeric_limits<T>::quiet_NaN();
+    for(Index i: {Index(0), nelems/2, nelems-1})
+    {
+        for(T val: {inf, -inf, nan})
+        {
+            std::vector<T> data2(data);
+            data2[i] = val;
+            check<T>(nelems, inv_scale, data2, true);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1);
+    validate<fp32_t>(1000);
+    validate<fp64_t>(1);
+    validate<fp64_t>(1000);
+    return 0;
+}
+
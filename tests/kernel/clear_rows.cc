@@ -0,0 +1,111 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/clear_rows.cc
+ * Clear marked rows of a matrix
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/kernel/clear_rows.hh"
+#include "../testing.hh"
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::kernel::clear_rows;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index n, const bool_t *rows,
+        std::vector<T> &dst)
+{
+    // Alloc on device
+    bool_t *dev_rows;
+    T *dev_dst;
+    cudaError_t cuda_err = cudaMalloc(&dev_rows, sizeof(bool_t)*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_dst, sizeof(T)*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy to device
+    cuda_err = cudaMemcpy(dev_rows, rows, sizeof(bool_t)*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_dst, &dst[0], sizeof(T)*m*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, m, n, dev_rows, dev_dst);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&dst[0], dev_dst, sizeof(T)*m*n,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_rows);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_dst);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n)
+{
+    // Init test input
+    std::unique_ptr<bool_t[]> rows(new bool_t[n]);
+    std::vector<T> dst_init(m*n), dst_ref(m*n);
+    for(Index j = 0; j < n; ++j)
+    {
+        rows[j] = bool_t(j%3 == 1);
+        for(Index i = 0; i < m; ++i)
+        {
+            dst_init[i+j*m] = T(std::cos(T(i*n+j+1)));
+            dst_ref[i+j*m] = rows[j] ? T(0) : dst_init[i+j*m];
+        }
+    }
+    std::cout << "Run kernel::clear_rows::cpu<T>\n";
+    std::vector<T> dst(dst_init);
+    cpu<T>(m, n, &rows[0], &dst[0]);
+    for(Index i = 0; i < m*n; ++i)
+    {
+        TEST_ASSERT(dst[i] == dst_ref[i]);
+    }
+    std::cout << "OK: kernel::clear_rows::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    std::cout << "Run kernel::clear_rows::cuda<T>\n";
+    dst = dst_init;
+    run_cuda<T>(m, n, &rows[0], dst);
+    for(Index i = 0; i < m*n; ++i)
+    {
+        TEST_ASSERT(dst[i] == dst_ref[i]);
+    }
+    std::cout << "OK: kernel::clear_rows::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1, 1);
+    validate<fp32_t>(100, 20);
+    validate<fp32_t>(300, 7);
+    validate<fp64_t>(1, 1);
+    validate<fp64_t>(100, 20);
+    validate<fp64_t>(300, 7);
+    return 0;
+}
+
@@ -0,0 +1,192 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/cross_entropy_fwd_bwd.cc
+ * Fused cross entropy loss and its gradient
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/kernel/cross_entropy_fwd_bwd.hh"
+#include "../testing.hh"
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::kernel::cross_entropy_fwd_bwd;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index n, T scale, T grad_scale,
+        const std::vector<T> &maxsumexp, const std::vector<T> &src,
+        const std::vector<Index> &labels, std::vector<T> &grad, T &val)
+{
+    // Alloc on device
+    T *dev_maxsumexp, *dev_src, *dev_grad, *dev_val;
+    Index *dev_labels;
+    cudaError_t cuda_err = cudaMalloc(&dev_maxsumexp, sizeof(T)*2*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_src, sizeof(T)*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_labels, sizeof(Index)*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_grad, sizeof(T)*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_val, sizeof(T));
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy to device
+    cuda_err = cudaMemcpy(dev_maxsumexp, &maxsumexp[0], sizeof(T)*2*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_src, &src[0], sizeof(T)*m*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_labels, &labels[0], sizeof(Index)*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_val, &val, sizeof(T), cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, m, n, 0, scale, grad_scale, dev_maxsumexp, dev_src,
+            dev_labels, dev_grad, dev_val);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&grad[0], dev_grad, sizeof(T)*m*n,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&val, dev_val, sizeof(T), cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_maxsumexp);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_src);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_labels);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_grad);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_val);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check gradient and loss value against reference
+template<typename T>
+void check(const std::vector<T> &grad, const std::vector<T> &grad_ref,
+        T val, T val_ref)
+{
+    constexpr T eps = 10 * std::numeric_limits<T>::epsilon();
+    for(Index i = 0; i < Index(grad.size()); ++i)
+    {
+        TEST_ASSERT(std::abs(grad[i]-grad_ref[i]) <= eps);
+    }
+    TEST_ASSERT(std::abs(val-val_ref) <= eps*std::abs(val_ref));
+}
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index m_tile)
+{
+    T scale = 0.5, grad_scale = 2.0, val_init = 1.0;
+    // Init test input
+    std::vector<T> src(m*n);
+    std::vector<Index> labels(n);
+    for(Index j = 0; j < n; ++j)
+    {
+        for(Index i = 0; i < m; ++i)
+        {
+            src[i+j*m] = T(std::cos(T(i*n+j+1))) * T(5);
+        }
+        labels[j] = (j*7+3) % m;
+    }
+    // Reference maxsumexp, loss and gradient
+    std::vector<T> maxsumexp(2*n), grad_ref(m*n);
+    T val_ref = val_init;
+    for(Index j = 0; j < n; ++j)
+    {
+        T max = src[j*m];
+        for(Index i = 1; i < m; ++i)
+        {
+            max = std::max(max, src[i+j*m]);
+        }
+        T sum = 0;
+        for(Index i = 0; i < m; ++i)
+        {
+            sum += std::exp(src[i+j*m]-max);
+        }
+        maxsumexp[2*j] = max;
+        maxsumexp[2*j+1] = sum;
+        for(Index i = 0; i < m; ++i)
+        {
+            grad_ref[i+j*m] = grad_scale * std::exp(src[i+j*m]-max) / sum;
+        }
+        grad_ref[labels[j]+j*m] -= grad_scale;
+        val_ref += scale * (max+std::log(sum)-src[labels[j]+j*m]);
+    }
+    // Apply kernel to tiles of m_tile rows
+    std::cout << "Run kernel::cross_entropy_fwd_bwd::cpu<T>\n";
+    std::vector<T> grad(m*n);
+    T val = val_init;
+    for(Index m_start = 0; m_start < m; m_start += m_tile)
+    {
+        Index m_size = std::min(m_tile, m-m_start);
+        // Tiles of logits and gradient are contiguous buffers
+        std::vector<T> src_tile(m_size*n), grad_tile(m_size*n);
+        for(Index j = 0; j < n; ++j)
+        {
+            for(Index i = 0; i < m_size; ++i)
+            {
+                src_tile[i+j*m_size] = src[m_start+i+j*m];
+            }
+        }
+        cpu<T>(m_size, n, m_start, scale, grad_scale, &maxsumexp[0],
+                &src_tile[0], &labels[0], &grad_tile[0], &val);
+        for(Index j = 0; j < n; ++j)
+        {
+            for(Index i = 0; i < m_size; ++i)
+            {
+                grad[m_start+i+j*m] = grad_tile[i+j*m_size];
+            }
+        }
+    }
+    check<T>(grad, grad_ref, val, val_ref);
+    // Gradient may overwrite logits
+    grad = src;
+    val = val_init;
+    cpu<T>(m, n, 0, scale, grad_scale, &maxsumexp[0], &grad[0], &labels[0],
+            &grad[0], &val);
+    check<T>(grad, grad_ref, val, val_ref);
+    std::cout << "OK: kernel::cross_entropy_fwd_bwd::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    std::cout << "Run kernel::cross_entropy_fwd_bwd::cuda<T>\n";
+    val = val_init;
+    run_cuda<T>(m, n, scale, grad_scale, maxsumexp, src, labels, grad, val);
+    check<T>(grad, grad_ref, val, val_ref);
+    std::cout << "OK: kernel::cross_entropy_fwd_bwd::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1, 1, 1);
+    validate<fp32_t>(100, 20, 100);
+    validate<fp32_t>(100, 20, 30);
+    validate<fp64_t>(1, 1, 1);
+    validate<fp64_t>(100, 20, 100);
+    validate<fp64_t>(100, 20, 30);
+    return 0;
+}
+
@@ -0,0 +1,116 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/embedding_rows.cc
+ * Mark rows of embeddings, that are touched by tokens
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/kernel/embedding_rows.hh"
+#include "../testing.hh"
+#include <vector>
+#include <memory>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::kernel::embedding_rows;
+
+#ifdef NNTILE_USE_CUDA
+void run_cuda(Index nelems, Index vocab, const std::vector<Index> &index,
+        bool_t *rows)
+{
+    // Alloc on device
+    Index *dev_index;
+    bool_t *dev_rows;
+    cudaError_t cuda_err = cudaMalloc(&dev_index, sizeof(Index)*nelems);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_rows, sizeof(bool_t)*vocab);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy to device
+    cuda_err = cudaMemcpy(dev_index, &index[0], sizeof(Index)*nelems,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_rows, rows, sizeof(bool_t)*vocab,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda(stream, nelems, dev_index, dev_rows);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(rows, dev_rows, sizeof(bool_t)*vocab,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_index);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_rows);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Validation
+void validate(Index nelems, Index vocab)
+{
+    // Init test input, where some of tokens are repeated
+    std::vector<Index> index(nelems);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        index[i] = (i*i+3) % vocab;
+    }
+    // The first row is marked beforehand and shall stay marked
+    std::unique_ptr<bool_t[]> rows(new bool_t[vocab]),
+        rows_ref(new bool_t[vocab]);
+    for(Index i = 0; i < vocab; ++i)
+    {
+        rows_ref[i] = bool_t(i == 0);
+    }
+    for(Index i = 0; i < nelems; ++i)
+    {
+        rows_ref[index[i]] = bool_t(true);
+    }
+    std::cout << "Run kernel::embedding_rows::cpu\n";
+    for(Index i = 0; i < vocab; ++i)
+    {
+        rows[i] = bool_t(i == 0);
+    }
+    cpu(nelems, &index[0], &rows[0]);
+    for(Index i = 0; i < vocab; ++i)
+    {
+        TEST_ASSERT(rows[i] == rows_ref[i]);
+    }
+    std::cout << "OK: kernel::embedding_rows::cpu\n";
+#ifdef NNTILE_USE_CUDA
+    std::cout << "Run kernel::embedding_rows::cuda\n";
+    for(Index i = 0; i < vocab; ++i)
+    {
+        rows[i] = bool_t(i == 0);
+    }
+    run_cuda(nelems, vocab, index, &rows[0]);
+    for(Index i = 0; i < vocab; ++i)
+    {
+        TEST_ASSERT(rows[i] == rows_ref[i]);
+    }
+    std::cout << "OK: kernel::embedding_rows::cuda\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate(1, 1);
+    validate(10, 100);
+    validate(1000, 50);
+    return 0;
+}
+
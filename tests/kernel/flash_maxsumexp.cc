@@ -0,0 +1,120 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/flash_maxsumexp.cc
+ * Max and sum of exponents of attention scores on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-06
+ * */
+
+#include "nntile/kernel/flash_maxsumexp.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+using namespace nntile;
+using namespace nntile::kernel::flash_maxsumexp;
+
+// Templated validation
+template<typename T>
+void validate(Index seq, Index head, Index batch)
+{
+    constexpr T epsilon = std::numeric_limits<T>::epsilon();
+    // Init test input, query 1 is fully masked out
+    std::vector<T> K(head*seq*batch), Q(head*seq*batch);
+    for(Index i = 0; i < head*seq*batch; ++i)
+    {
+        K[i] = T(Index(i*37)%101-50) / T{20};
+        Q[i] = T(Index(i*53)%103-51) / T{20};
+    }
+    std::unique_ptr<bool_t[]> mask(new bool_t[seq*seq]);
+    for(Index q = 0; q < seq; ++q)
+    {
+        for(Index k = 0; k < seq; ++k)
+        {
+            mask[q*seq+k] = (k <= q) and (q != 1);
+        }
+    }
+    // Reference maximums and sums of exponents of scores
+    std::vector<T> ref(2*seq*batch, T{0});
+    for(Index b = 0; b < batch; ++b)
+    {
+        for(Index q = 0; q < seq; ++q)
+        {
+            std::vector<T> S(seq);
+            T max = -std::numeric_limits<T>::infinity();
+            for(Index k = 0; k < seq; ++k)
+            {
+                T dot = 0;
+                for(Index h = 0; h < head; ++h)
+                {
+                    dot += K[(b*seq+k)*head+h] * Q[(b*seq+q)*head+h];
+                }
+                S[k] = dot / std::sqrt(T(head));
+                if(mask[q*seq+k] and max < S[k])
+                {
+                    max = S[k];
+                }
+            }
+            T sum = 0;
+            for(Index k = 0; k < seq; ++k)
+            {
+                if(mask[q*seq+k])
+                {
+                    sum += std::exp(S[k]-max);
+                }
+            }
+            if(sum != T{0})
+            {
+                ref[2*(b*seq+q)] = max;
+                ref[2*(b*seq+q)+1] = sum;
+            }
+        }
+    }
+    // Check low-level kernel
+    std::cout << "Run kernel::flash_maxsumexp::cpu<T>\n";
+    std::vector<T> maxsumexp(2*seq*batch, T{0});
+    cpu<T>(seq, head, batch, &K[0], &Q[0], mask.get(), &maxsumexp[0]);
+    for(Index i = 0; i < seq*batch; ++i)
+    {
+        T max_diff = std::abs(maxsumexp[2*i]-ref[2*i]);
+        TEST_ASSERT(max_diff <= 10*epsilon*(T{1}+std::abs(ref[2*i])));
+        T sum_diff = std::abs(maxsumexp[2*i+1]-ref[2*i+1]);
+        TEST_ASSERT(sum_diff <= 10*epsilon*seq*ref[2*i+1]);
+    }
+    // Accumulating the same scores once again shall double the sums
+    cpu<T>(seq, head, batch, &K[0], &Q[0], mask.get(), &maxsumexp[0]);
+    for(Index i = 0; i < seq*batch; ++i)
+    {
+        T max_diff = std::abs(maxsumexp[2*i]-ref[2*i]);
+        TEST_ASSERT(max_diff <= 10*epsilon*(T{1}+std::abs(ref[2*i])));
+        T sum_diff = std::abs(maxsumexp[2*i+1]-2*ref[2*i+1]);
+        TEST_ASSERT(sum_diff <= 20*epsilon*seq*ref[2*i+1]);
+    }
+    std::cout << "OK: kernel::flash_maxsumexp::cpu<T>\n";
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1, 1, 1);
+    validate<fp32_t>(7, 5, 3);
+    validate<fp32_t>(64, 64, 1);
+    validate<fp32_t>(130, 16, 2);
+    validate<fp32_t>(70, 80, 1);
+    validate<fp64_t>(1, 1, 1);
+    validate<fp64_t>(7, 5, 3);
+    validate<fp64_t>(64, 64, 1);
+    validate<fp64_t>(130, 16, 2);
+    validate<fp64_t>(70, 80, 1);
+    return 0;
+}
+
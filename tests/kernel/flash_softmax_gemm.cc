@@ -0,0 +1,126 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/flash_softmax_gemm.cc
+ * Fused softmax of attention scores and product by values on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-06
+ * */
+
+#include "nntile/kernel/flash_softmax_gemm.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+using namespace nntile;
+using namespace nntile::kernel::flash_softmax_gemm;
+
+// Templated validation
+template<typename T>
+void validate(Index seq, Index head, Index batch)
+{
+    constexpr T epsilon = std::numeric_limits<T>::epsilon();
+    // Init test input, query 1 is fully masked out
+    std::vector<T> K(head*seq*batch), Q(head*seq*batch), V(head*seq*batch),
+        A(head*seq*batch);
+    for(Index i = 0; i < head*seq*batch; ++i)
+    {
+        K[i] = T(Index(i*37)%101-50) / T{20};
+        Q[i] = T(Index(i*53)%103-51) / T{20};
+        V[i] = T(Index(i*29)%97-48) / T{10};
+        A[i] = T(Index(i*17)%89-44) / T{10};
+    }
+    std::unique_ptr<bool_t[]> mask(new bool_t[seq*seq]);
+    for(Index q = 0; q < seq; ++q)
+    {
+        for(Index k = 0; k < seq; ++k)
+        {
+            mask[q*seq+k] = (k <= q) and (q != 1);
+        }
+    }
+    // Reference probabilities and result, that are computed with entire
+    // matrix of scores
+    std::vector<T> maxsumexp(2*seq*batch, T{0}), A_ref(A);
+    for(Index b = 0; b < batch; ++b)
+    {
+        for(Index q = 0; q < seq; ++q)
+        {
+            std::vector<T> S(seq);
+            T max = -std::numeric_limits<T>::infinity();
+            for(Index k = 0; k < seq; ++k)
+            {
+                T dot = 0;
+                for(Index h = 0; h < head; ++h)
+                {
+                    dot += K[(b*seq+k)*head+h] * Q[(b*seq+q)*head+h];
+                }
+                S[k] = dot / std::sqrt(T(head));
+                if(mask[q*seq+k] and max < S[k])
+                {
+                    max = S[k];
+                }
+            }
+            T sum = 0;
+            for(Index k = 0; k < seq; ++k)
+            {
+                if(mask[q*seq+k])
+                {
+                    sum += std::exp(S[k]-max);
+                }
+            }
+            if(sum == T{0})
+            {
+                continue;
+            }
+            maxsumexp[2*(b*seq+q)] = max;
+            maxsumexp[2*(b*seq+q)+1] = sum;
+            for(Index k = 0; k < seq; ++k)
+            {
+                if(not mask[q*seq+k])
+                {
+                    continue;
+                }
+                T p = std::exp(S[k]-max) / sum;
+                for(Index h = 0; h < head; ++h)
+                {
+                    A_ref[(b*seq+q)*head+h] += p * V[(b*seq+k)*head+h];
+                }
+            }
+        }
+    }
+    // Check low-level kernel
+    std::cout << "Run kernel::flash_softmax_gemm::cpu<T>\n";
+    cpu<T>(seq, head, batch, &K[0], &Q[0], mask.get(), &maxsumexp[0], &V[0],
+            &A[0]);
+    for(Index i = 0; i < head*seq*batch; ++i)
+    {
+        T diff = std::abs(A[i]-A_ref[i]);
+        TEST_ASSERT(diff <= 100*epsilon*(T{1}+std::abs(A_ref[i])));
+    }
+    std::cout << "OK: kernel::flash_softmax_gemm::cpu<T>\n";
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1, 1, 1);
+    validate<fp32_t>(7, 5, 3);
+    validate<fp32_t>(64, 64, 1);
+    validate<fp32_t>(130, 16, 2);
+    validate<fp32_t>(70, 80, 1);
+    validate<fp64_t>(1, 1, 1);
+    validate<fp64_t>(7, 5, 3);
+    validate<fp64_t>(64, 64, 1);
+    validate<fp64_t>(130, 16, 2);
+    validate<fp64_t>(70, 80, 1);
+    return 0;
+}
+
@@ -0,0 +1,116 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/gemm_int8.cc
+ * Matrix multiplication by per-channel quantized int8 weights
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-20
+ * */
+
+#include "nntile/kernel/gemm_int8.hh"
+#include "../testing.hh"
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::kernel::gemm_int8;
+
+// Templated validation
+template<typename T>
+void validate(const TransOp &trans, Index m, Index n, Index k)
+{
+    // Weights are integers with per-channel scales, that are powers of 2
+    std::vector<int8_t> w(k*m);
+    std::vector<T> w_scale(m);
+    for(Index i = 0; i < m; ++i)
+    {
+        w_scale[i] = std::ldexp(T{1}, -Index(i%3));
+        for(Index p = 0; p < k; ++p)
+        {
+            w[p+i*k] = int8_t((3*p+5*i)%255 - 127);
+        }
+    }
+    // Every input vector is a multiple of its own integer vector, so that
+    // quantization is exact. The last vector is zero.
+    std::vector<T> x(k*n), x_int(k*n);
+    for(Index j = 0; j < n; ++j)
+    {
+        T x_scale = (j == n-1) ? T{0} : T(j+1) / T{127};
+        for(Index p = 0; p < k; ++p)
+        {
+            Index val = (7*p+11*j) % 255 - 127;
+            // Make sure absolute maximum of the vector is 127
+            if(p == j%k)
+            {
+                val = (j%2 == 0) ? 127 : -127;
+            }
+            x_int[p+j*k] = T(val);
+            Index x_offset = (trans.value == TransOp::NoTrans) ? p+j*k
+                : j+p*n;
+            x[x_offset] = x_scale * T(val);
+        }
+    }
+    // Init output and compute reference
+    T alpha = -2, beta = 0.5;
+    std::vector<T> y(m*n), y_ref(m*n);
+    for(Index j = 0; j < n; ++j)
+    {
+        T x_scale = (j == n-1) ? T{0} : T(j+1) / T{127};
+        for(Index i = 0; i < m; ++i)
+        {
+            Index y_offset = (trans.value == TransOp::NoTrans) ? i+j*m
+                : j+i*n;
+            y[y_offset] = T(i+j);
+            T sum = 0;
+            for(Index p = 0; p < k; ++p)
+            {
+                sum += T(w[p+i*k]) * x_int[p+j*k];
+            }
+            y_ref[y_offset] = alpha*w_scale[i]*x_scale*sum + beta*y[y_offset];
+        }
+    }
+    // Scratch buffers
+    std::vector<T> x_scale(n);
+    std::vector<std::int16_t> x_quant(k*n), w_col(k);
+    std::vector<std::int32_t> acc(n);
+    std::cout << "Run kernel::gemm_int8::cpu<T>\n";
+    cpu<T>(trans, m, n, k, alpha, &w[0], &w_scale[0], &x[0], beta, &y[0],
+            &x_scale[0], &x_quant[0], &w_col[0], &acc[0]);
+    for(Index i = 0; i < m*n; ++i)
+    {
+        T diff = std::abs(y[i] - y_ref[i]);
+        T norm = std::abs(y_ref[i]) + T{1};
+        TEST_ASSERT(diff <= 10*std::numeric_limits<T>::epsilon()*norm);
+    }
+    // Output is only written with zero beta
+    for(Index i = 0; i < m*n; ++i)
+    {
+        y[i] = std::numeric_limits<T>::quiet_NaN();
+    }
+    cpu<T>(trans, m, n, k, T{1}, &w[0], &w_scale[0], &x[0], T{0}, &y[0],
+            &x_scale[0], &x_quant[0], &w_col[0], &acc[0]);
+    for(Index i = 0; i < m*n; ++i)
+    {
+        TEST_ASSERT(std::isfinite(y[i]));
+    }
+    std::cout << "OK: kernel::gemm_int8::cpu<T>\n";
+}
+
+int main(int argc, char **argv)
+{
+    for(auto trans: {TransOp(TransOp::NoTrans), TransOp(TransOp::Trans)})
+    {
+        validate<fp32_t>(trans, 1, 1, 1);
+        validate<fp32_t>(trans, 5, 3, 100);
+        validate<fp32_t>(trans, 17, 8, 1000);
+    }
+    return 0;
+}
+
@@ -0,0 +1,111 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/layer_norm_backward.cc
+ * Fused backward pass of layer normalization on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-08
+ * */
+
+#include "nntile/kernel/layer_norm_backward.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::kernel::layer_norm_backward;
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index k)
+{
+    constexpr T epsilon = std::numeric_limits<T>::epsilon();
+    // Init test input
+    std::vector<T> src_normalized(m*k*n), dst_grad(m*k*n), src_grad(m*k*n),
+        gamma(k), inv_stddev(m*n), gamma_grad(k), beta_grad(k);
+    for(Index i = 0; i < m*k*n; ++i)
+    {
+        src_normalized[i] = T(Index(i*37)%101-50) / T{20};
+        dst_grad[i] = T(Index(i*53)%103-51) / T{20};
+        src_grad[i] = T(Index(i*17)%89-44) / T{10};
+    }
+    for(Index i = 0; i < k; ++i)
+    {
+        gamma[i] = T(Index(i*29)%97-48) / T{10};
+        gamma_grad[i] = T(i%7) - T{3};
+        beta_grad[i] = T(i%5) - T{2};
+    }
+    for(Index i = 0; i < m*n; ++i)
+    {
+        inv_stddev[i] = T{1} + T(i%11)/T{4};
+    }
+    // Reference result, computed in double precision
+    std::vector<double> src_grad_ref(src_grad.begin(), src_grad.end()),
+        gamma_grad_ref(gamma_grad.begin(), gamma_grad.end()),
+        beta_grad_ref(beta_grad.begin(), beta_grad.end());
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        for(Index i1 = 0; i1 < m; ++i1)
+        {
+            double sum_g = 0, sum_gx = 0;
+            for(Index i0 = 0; i0 < k; ++i0)
+            {
+                Index idx = (i2*k+i0)*m + i1;
+                double g = double(gamma[i0]) * dst_grad[idx];
+                sum_g += g;
+                sum_gx += g * src_normalized[idx];
+                gamma_grad_ref[i0] += double(dst_grad[idx])
+                    * src_normalized[idx];
+                beta_grad_ref[i0] += dst_grad[idx];
+            }
+            for(Index i0 = 0; i0 < k; ++i0)
+            {
+                Index idx = (i2*k+i0)*m + i1;
+                double g = double(gamma[i0]) * dst_grad[idx];
+                src_grad_ref[idx] += inv_stddev[i2*m+i1] * (g - sum_g/k
+                        - src_normalized[idx]*sum_gx/k);
+            }
+        }
+    }
+    // Check low-level kernel
+    std::cout << "Run kernel::layer_norm_backward::cpu<T>\n";
+    cpu<T>(m, n, k, &src_normalized[0], &dst_grad[0], &gamma[0],
+            &inv_stddev[0], &src_grad[0], &gamma_grad[0], &beta_grad[0]);
+    for(Index i = 0; i < m*k*n; ++i)
+    {
+        TEST_ASSERT(std::abs(src_grad[i]-src_grad_ref[i])
+                <= 100*epsilon*(1+std::abs(src_grad_ref[i])));
+    }
+    for(Index i = 0; i < k; ++i)
+    {
+        TEST_ASSERT(std::abs(gamma_grad[i]-gamma_grad_ref[i])
+                <= 10*epsilon*m*n*(1+std::abs(gamma_grad_ref[i])));
+        TEST_ASSERT(std::abs(beta_grad[i]-beta_grad_ref[i])
+                <= 10*epsilon*m*n*(1+std::abs(beta_grad_ref[i])));
+    }
+    std::cout << "OK: kernel::layer_norm_backward::cpu<T>\n";
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1, 5, 7);
+    validate<fp32_t>(1, 3, 1000);
+    validate<fp32_t>(20, 1, 30);
+    validate<fp32_t>(300, 2, 5);
+    validate<fp32_t>(4, 3, 1);
+    validate<fp64_t>(1, 5, 7);
+    validate<fp64_t>(1, 3, 1000);
+    validate<fp64_t>(20, 1, 30);
+    validate<fp64_t>(300, 2, 5);
+    validate<fp64_t>(4, 3, 1);
+    return 0;
+}
+
@@ -0,0 +1,110 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/layer_norm_forward.cc
+ * Fused forward pass of layer normalization on CPU
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-08
+ * */
+
+#include "nntile/kernel/layer_norm_forward.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::kernel::layer_norm_forward;
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, Index k)
+{
+    constexpr T epsilon = std::numeric_limits<T>::epsilon();
+    const T eps = 1e-2;
+    // Init test input with a large shift to check numerical stability
+    std::vector<T> src(m*k*n), gamma(k), beta(k);
+    for(Index i = 0; i < m*k*n; ++i)
+    {
+        src[i] = T(Index(i*37)%101-50)/T{20} + T{100};
+    }
+    for(Index i = 0; i < k; ++i)
+    {
+        gamma[i] = T(Index(i*53)%103-51) / T{20};
+        beta[i] = T(Index(i*29)%97-48) / T{10};
+    }
+    // Reference result, computed in double precision
+    std::vector<double> mean_ref(m*n), inv_stddev_ref(m*n),
+        src_normalized_ref(m*k*n), dst_ref(m*k*n);
+    for(Index i2 = 0; i2 < n; ++i2)
+    {
+        for(Index i1 = 0; i1 < m; ++i1)
+        {
+            double sum = 0;
+            for(Index i0 = 0; i0 < k; ++i0)
+            {
+                sum += src[(i2*k+i0)*m+i1];
+            }
+            double avg = sum / k, ssq = 0;
+            for(Index i0 = 0; i0 < k; ++i0)
+            {
+                double diff = src[(i2*k+i0)*m+i1] - avg;
+                ssq += diff * diff;
+            }
+            double inv = 1.0 / std::sqrt(ssq/k+double(eps)*eps);
+            mean_ref[i2*m+i1] = avg;
+            inv_stddev_ref[i2*m+i1] = inv;
+            for(Index i0 = 0; i0 < k; ++i0)
+            {
+                Index idx = (i2*k+i0)*m + i1;
+                src_normalized_ref[idx] = (src[idx]-avg) * inv;
+                dst_ref[idx] = gamma[i0]*src_normalized_ref[idx] + beta[i0];
+            }
+        }
+    }
+    // Check low-level kernel
+    std::cout << "Run kernel::layer_norm_forward::cpu<T>\n";
+    std::vector<T> mean(m*n), inv_stddev(m*n), src_normalized(m*k*n),
+        dst(m*k*n);
+    cpu<T>(m, n, k, eps, &src[0], &gamma[0], &beta[0], &mean[0],
+            &inv_stddev[0], &src_normalized[0], &dst[0]);
+    // Input values are around 100, so the mean has an absolute error of
+    // several ulp of 100, that grows by inv_stddev in normalized values
+    for(Index i = 0; i < m*n; ++i)
+    {
+        TEST_ASSERT(std::abs(mean[i]-mean_ref[i])
+                <= 10*epsilon*std::abs(mean_ref[i]));
+        TEST_ASSERT(std::abs(inv_stddev[i]-inv_stddev_ref[i])
+                <= 1000*epsilon*inv_stddev_ref[i]);
+    }
+    for(Index i = 0; i < m*k*n; ++i)
+    {
+        T tol = 1000 * epsilon * (1+std::abs(dst_ref[i]));
+        TEST_ASSERT(std::abs(src_normalized[i]-src_normalized_ref[i]) <= tol);
+        TEST_ASSERT(std::abs(dst[i]-dst_ref[i]) <= 10*tol);
+    }
+    std::cout << "OK: kernel::layer_norm_forward::cpu<T>\n";
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1, 5, 7);
+    validate<fp32_t>(1, 3, 1000);
+    validate<fp32_t>(20, 1, 30);
+    validate<fp32_t>(300, 2, 5);
+    validate<fp32_t>(4, 3, 1);
+    validate<fp64_t>(1, 5, 7);
+    validate<fp64_t>(1, 3, 1000);
+    validate<fp64_t>(20, 1, 30);
+    validate<fp64_t>(300, 2, 5);
+    validate<fp64_t>(4, 3, 1);
+    return 0;
+}
+
@@ -123,6 +123,28 @@ void validate(Index nelems)
 #endif // NNTILE_USE_CUDA
 }
 
+// Validation of bf16_t, computed in single precision and rounded once
+void validate_bf16(Index nelems)
+{
+    // Init test input
+    std::vector<bf16_t> src(nelems), dst(nelems);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        src[i] = fp32_t(2*i+1-nelems) / fp32_t{1000};
+        dst[i] = fp32_t(nelems-i) / fp32_t{1000};
+    }
+    std::vector<bf16_t> dst_save(dst);
+    // Check low-level CPU kernel
+    std::cout << "Run kernel::prod::cpu<bf16_t>\n";
+    cpu<bf16_t>(nelems, &src[0], &dst[0]);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        bf16_t val_ref = fp32_t(src[i]) * fp32_t(dst_save[i]);
+        TEST_ASSERT(dst[i].value == val_ref.value);
+    }
+    std::cout << "OK: kernel::prod::cpu<bf16_t>\n";
+}
+
 int main(int argc, char **argv)
 {
     validate<fp32_t>(0);
@@ -131,6 +153,9 @@ int main(int argc, char **argv)
     validate<fp64_t>(0);
     validate<fp64_t>(1);
     validate<fp64_t>(80000);
+    validate_bf16(0);
+    validate_bf16(1);
+    validate_bf16(80000);
     return 0;
 }
 
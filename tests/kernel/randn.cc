@@ -13,7 +13,6 @@
  * */
 
 #include "nntile/kernel/randn.hh"
-#include "../external/random.h" // external
 #include "../testing.hh"
 #include <array>
 #include <vector>
@@ -21,28 +20,61 @@
 #include <limits>
 #include <iostream>
 #include <cmath>
+#include <cstdint>
 
 using namespace nntile;
 using namespace nntile::kernel::randn;
 
-static inline fp32_t chameleon_randn(unsigned long long &seed, fp32_t mean,
-        fp32_t stddev)
+// Reference Philox4x32-10 generator
+static void philox(std::uint32_t ctr[4], std::uint32_t key0,
+        std::uint32_t key1)
 {
-    constexpr fp32_t two=2.0, twopi=6.2831853071795864769252867663;
-    fp32_t t1 = CORE_slaran(&seed);
-    fp32_t t2 = CORE_slaran(&seed) * twopi;
-    fp32_t t3 = std::sqrt(-two*std::log(t1)) * std::cos(t2);
-    return stddev*t3 + mean;
+    for(int round = 0; round < 10; ++round)
+    {
+        std::uint64_t prod0 = std::uint64_t{0xD2511F53} * ctr[0];
+        std::uint64_t prod1 = std::uint64_t{0xCD9E8D57} * ctr[2];
+        std::uint32_t new0 = (prod1>>32) ^ ctr[1] ^ key0;
+        std::uint32_t new2 = (prod0>>32) ^ ctr[3] ^ key1;
+        ctr[1] = prod1;
+        ctr[3] = prod0;
+        ctr[0] = new0;
+        ctr[2] = new2;
+        key0 += 0x9E3779B9;
+        key1 += 0xBB67AE85;
+    }
 }
 
-static inline fp64_t chameleon_randn(unsigned long long &seed, fp64_t mean,
-        fp64_t stddev)
+// Reference normal number for a given offset within the underlying array
+template<typename T>
+static T randn_ref(unsigned long long seed, Index offset, T mean, T stddev)
 {
-    constexpr fp64_t two=2.0, twopi=6.2831853071795864769252867663;
-    fp64_t t1 = CORE_dlaran(&seed);
-    fp64_t t2 = CORE_dlaran(&seed) * twopi;
-    fp64_t t3 = std::sqrt(-two*std::log(t1)) * std::cos(t2);
-    return stddev*t3 + mean;
+    std::uint32_t ctr[4] = {std::uint32_t(offset),
+        std::uint32_t(std::uint64_t(offset)>>32), 0, 0};
+    philox(ctr, std::uint32_t(seed), std::uint32_t(seed>>32));
+    long double u1, u2;
+    if(sizeof(T) == 4)
+    {
+        u1 = std::ldexp((long double)((ctr[0]>>8)+1), -24);
+        u2 = std::ldexp((long double)(ctr[1]>>8), -24);
+    }
+    else
+    {
+        u1 = std::ldexp((long double)((((std::uint64_t(ctr[0])<<32)
+                            | ctr[1])>>11)+1), -53);
+        u2 = std::ldexp((long double)(((std::uint64_t(ctr[2])<<32)
+                        | ctr[3])>>11), -53);
+    }
+    constexpr long double twopi = 6.28318530717958647692528676655900577L;
+    long double z = std::sqrt(-2*std::log(u1)) * std::cos(twopi*u2);
+    return T(stddev*z + mean);
+}
+
+// Check that generated value is close to the reference one
+template<typename T>
+static bool is_close(T val, T ref)
+{
+    constexpr T eps = std::numeric_limits<T>::epsilon();
+    return std::abs(val-ref) <= 16 * eps * (1+std::abs(ref));
 }
 
 template<typename T>
@@ -50,20 +82,18 @@ void validate_empty_shape()
 {
     // Set default values for tests
     T mean = 0, stddev = 1;
-    unsigned long long seed = CORE_rnd64_jump(1000, -1);
+    unsigned long long seed = 0x3a6c2f5e7d1b9840ULL;
     // Init reference array
-    T data_ref;
-    unsigned long long seed2 = seed;
-    data_ref = chameleon_randn(seed2, mean, stddev);
+    T data_ref = randn_ref<T>(seed, 0, mean, stddev);
     // Run kernel
     T data;
     std::cout << "Run kernel::randn::cpu_ndim0<T>\n";
     cpu_ndim0<T>(seed, mean, stddev, &data);
     // Check if the result is the same as the reference one
-    TEST_ASSERT(data == data_ref);
+    TEST_ASSERT(is_close(data, data_ref));
     std::cout << "OK: kernel::randn::cpu_ndim0<T>\n";
     // Run kernel with a different seed that shall generate different result
-    seed2 = seed + std::numeric_limits<unsigned long long>::max()/2;
+    unsigned long long seed2 = seed + std::numeric_limits<unsigned long long>::max()/2;
     // Launch kernel
     std::cout << "Run kernel::randn::cpu_ndim0<T>\n";
     cpu_ndim0<T>(seed2, mean, stddev, &data);
@@ -95,7 +125,7 @@ void validate_full(std::array<Index, NDIM> shape)
 {
     // Set default values for tests
     T mean = 0, stddev = 1;
-    unsigned long long seed = CORE_rnd64_jump(1000, -1);
+    unsigned long long seed = 0x3a6c2f5e7d1b9840ULL;
     // Init strides
     std::array<Index, NDIM> stride, start, tmp_index;
     stride[0] = 1;
@@ -108,10 +138,9 @@ void validate_full(std::array<Index, NDIM> shape)
     Index nelems = stride[NDIM-1] * shape[NDIM-1];
     // Init reference array
     std::vector<T> data_ref(nelems);
-    unsigned long long seed2 = seed;
     for(Index i = 0; i < nelems; ++i)
     {
-        data_ref[i] = chameleon_randn(seed2, mean, stddev);
+        data_ref[i] = randn_ref<T>(seed, i, mean, stddev);
     }
     // Run kernel
     std::vector<T> data(nelems);
@@ -121,11 +150,11 @@ void validate_full(std::array<Index, NDIM> shape)
     // Check if the result is the same as the reference one
     for(Index i = 0; i < nelems; ++i)
     {
-        TEST_ASSERT(data[i] == data_ref[i]);
+        TEST_ASSERT(is_close(data[i], data_ref[i]));
     }
     std::cout << "OK: kernel::randn::cpu<T>\n";
     // Run kernel with a different seed that shall generate different result
-    seed2 = seed + std::numeric_limits<unsigned long long>::max()/2;
+    unsigned long long seed2 = seed + std::numeric_limits<unsigned long long>::max()/2;
     // Launch kernel
     std::cout << "Run kernel::randn::cpu<T>\n";
     cpu<T>(NDIM, nelems, seed2, mean, stddev, &start[0], &shape[0],
@@ -159,7 +188,7 @@ void validate_full(std::array<Index, 0> shape_)
 {
     // Set default values for tests
     T mean = 0, stddev = 1;
-    unsigned long long seed = CORE_rnd64_jump(1000, -1);
+    unsigned long long seed = 0x3a6c2f5e7d1b9840ULL;
     // 0-dimensional arrays are not referenced, so we just init them with null
     // pointers
     Index *start = nullptr, *shape = nullptr, *stride = nullptr,
@@ -167,18 +196,17 @@ void validate_full(std::array<Index, 0> shape_)
     // Init nelems
     Index nelems = 1;
     // Init reference array
-    unsigned long long seed2 = seed;
-    T data_ref = chameleon_randn(seed2, mean, stddev);
+    T data_ref = randn_ref<T>(seed, 0, mean, stddev);
     // Run kernel
     T data;
     std::cout << "Run kernel::randn::cpu<T>\n";
     cpu<T>(0, nelems, seed, mean, stddev, start, shape, shape, &data,
             stride, tmp_index);
     // Check if the result is the same as the reference one
-    TEST_ASSERT(data == data_ref);
+    TEST_ASSERT(is_close(data, data_ref));
     std::cout << "OK: kernel::randn::cpu<T>\n";
     // Run kernel with a different seed that shall generate different result
-    seed2 = seed + std::numeric_limits<unsigned long long>::max()/2;
+    unsigned long long seed2 = seed + std::numeric_limits<unsigned long long>::max()/2;
     // Launch kernel
     std::cout << "Run kernel::randn::cpu<T>\n";
     cpu<T>(0, nelems, seed2, mean, stddev, start, shape, shape, &data,
@@ -214,7 +242,7 @@ void validate_part(std::array<Index, NDIM> underlying_shape,
 {
     // Set default values for tests
     T mean = 0, stddev = 1;
-    unsigned long long seed = CORE_rnd64_jump(1000, -1);
+    unsigned long long seed = 0x3a6c2f5e7d1b9840ULL;
     // Init strides
     std::array<Index, NDIM> stride, tmp_index;
     stride[0] = 2;
@@ -228,13 +256,20 @@ void validate_part(std::array<Index, NDIM> underlying_shape,
         nelems *= shape[i];
         size += (shape[i]-1) * stride[i];
     }
-    // Init reference array
+    // Init reference array by generating the entire underlying array, as
+    // the generated values shall not depend on the part being generated
     std::vector<T> underlying_array(underlying_nelems);
-    unsigned long long seed2 = seed;
-    for(Index i = 0; i < underlying_nelems; ++i)
+    std::array<Index, NDIM> underlying_start, underlying_stride;
+    underlying_stride[0] = 1;
+    underlying_start[0] = 0;
+    for(Index i = 1; i < NDIM; ++i)
     {
-        underlying_array[i] = chameleon_randn(seed2, mean, stddev);
+        underlying_stride[i] = underlying_stride[i-1] * underlying_shape[i-1];
+        underlying_start[i] = 0;
     }
+    cpu<T>(NDIM, underlying_nelems, seed, mean, stddev, &underlying_start[0],
+            &underlying_shape[0], &underlying_shape[0], &underlying_array[0],
+            &underlying_stride[0], &tmp_index[0]);
     // Run kernel
     std::vector<T> data(size);
     std::cout << "Run kernel::randn::cpu<T>\n";
@@ -0,0 +1,228 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/kernel/sparse_adam_step.cc
+ * Lazy Adam step over marked rows of a matrix
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/kernel/sparse_adam_step.hh"
+#include "nntile/kernel/adam_step.hh"
+#include "nntile/kernel/adamw_step.hh"
+#include "../testing.hh"
+#include <vector>
+#include <memory>
+#include <limits>
+#include <cmath>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::kernel::sparse_adam_step;
+
+#ifdef NNTILE_USE_CUDA
+template<typename T>
+void run_cuda(Index m, Index n, T beta_1, T beta_2, T eps, T lr,
+        T weight_decay, int decoupled, const bool_t *rows,
+        std::vector<Index> &row_step, const std::vector<T> &grad,
+        std::vector<T> &first_moment, std::vector<T> &second_moment,
+        std::vector<T> &p)
+{
+    // Alloc on device
+    bool_t *dev_rows;
+    Index *dev_row_step;
+    T *dev_grad, *dev_first_moment, *dev_second_moment, *dev_p;
+    cudaError_t cuda_err = cudaMalloc(&dev_rows, sizeof(bool_t)*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_row_step, sizeof(Index)*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_grad, sizeof(T)*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_first_moment, sizeof(T)*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_second_moment, sizeof(T)*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMalloc(&dev_p, sizeof(T)*m*n);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy to device
+    cuda_err = cudaMemcpy(dev_rows, rows, sizeof(bool_t)*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_row_step, &row_step[0], sizeof(Index)*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_grad, &grad[0], sizeof(T)*m*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_first_moment, &first_moment[0], sizeof(T)*m*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_second_moment, &second_moment[0],
+            sizeof(T)*m*n, cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(dev_p, &p[0], sizeof(T)*m*n,
+            cudaMemcpyHostToDevice);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Init stream
+    cudaStream_t stream;
+    cuda_err = cudaStreamCreate(&stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Launch low-level kernel
+    cuda<T>(stream, m, n, beta_1, beta_2, eps, lr, weight_decay, decoupled,
+            dev_rows, dev_row_step, dev_grad, dev_first_moment,
+            dev_second_moment, dev_p);
+    cuda_err = cudaStreamSynchronize(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    // Copy result and deallocate device memory
+    cuda_err = cudaMemcpy(&row_step[0], dev_row_step, sizeof(Index)*n,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&first_moment[0], dev_first_moment, sizeof(T)*m*n,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&second_moment[0], dev_second_moment,
+            sizeof(T)*m*n, cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaMemcpy(&p[0], dev_p, sizeof(T)*m*n,
+            cudaMemcpyDeviceToHost);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_rows);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_row_step);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_grad);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_first_moment);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_second_moment);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaFree(dev_p);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+    cuda_err = cudaStreamDestroy(stream);
+    TEST_ASSERT(cuda_err == cudaSuccess);
+}
+#endif // NNTILE_USE_CUDA
+
+// Check results against reference in max-norm, as moments may lose relative
+// accuracy due to cancellation
+template<typename T>
+void check(const std::vector<T> &val, const std::vector<T> &val_ref)
+{
+    constexpr T tol = 100 * std::numeric_limits<T>::epsilon();
+    T diff = 0, norm = 0;
+    for(Index i = 0; i < Index(val.size()); ++i)
+    {
+        diff = std::max(diff, std::abs(val[i]-val_ref[i]));
+        norm = std::max(norm, std::abs(val_ref[i]));
+    }
+    TEST_ASSERT(diff <= tol*norm);
+}
+
+// Templated validation
+template<typename T>
+void validate(Index m, Index n, int decoupled)
+{
+    T beta_1 = 0.9, beta_2 = 0.999, eps = 1e-8, lr = 1e-2;
+    T weight_decay = 0.1;
+    constexpr Index nsteps = 4;
+    // Rows of the reference are updated one by one by the dense Adam step
+    // with the number of steps, that actually touched the row
+    std::vector<T> p_init(m*n);
+    for(Index i = 0; i < m*n; ++i)
+    {
+        p_init[i] = T(std::cos(T(i+1)));
+    }
+    std::vector<T> p_ref(p_init), first_ref(m*n), second_ref(m*n);
+    std::vector<Index> row_step_ref(n);
+    std::vector<T> p(p_init), first_moment(m*n), second_moment(m*n);
+    std::vector<Index> row_step(n);
+#ifdef NNTILE_USE_CUDA
+    std::vector<T> p_cuda(p_init), first_cuda(m*n), second_cuda(m*n);
+    std::vector<Index> row_step_cuda(n);
+#endif // NNTILE_USE_CUDA
+    std::cout << "Run kernel::sparse_adam_step::cpu<T>\n";
+    for(Index step = 0; step < nsteps; ++step)
+    {
+        // Different rows are touched on different steps, gradient is zero
+        // outside of touched rows
+        std::unique_ptr<bool_t[]> rows(new bool_t[n]);
+        std::vector<T> grad(m*n);
+        for(Index j = 0; j < n; ++j)
+        {
+            rows[j] = bool_t((j+step)%3 != 0);
+            if(not rows[j])
+            {
+                continue;
+            }
+            for(Index i = 0; i < m; ++i)
+            {
+                grad[i+j*m] = T(std::sin(T(i*n+j+step)));
+            }
+        }
+        for(Index j = 0; j < n; ++j)
+        {
+            if(not rows[j])
+            {
+                continue;
+            }
+            ++row_step_ref[j];
+            std::vector<T> grad_row(&grad[j*m], &grad[j*m]+m);
+            if(decoupled != 0)
+            {
+                nntile::kernel::adamw_step::cpu<T>(row_step_ref[j], m,
+                        beta_1, beta_2, eps, lr, weight_decay, &grad_row[0],
+                        &first_ref[j*m], &second_ref[j*m], &p_ref[j*m]);
+            }
+            else
+            {
+                nntile::kernel::adam_step::cpu<T>(row_step_ref[j], m,
+                        beta_1, beta_2, eps, lr, weight_decay, &grad_row[0],
+                        &first_ref[j*m], &second_ref[j*m], &p_ref[j*m]);
+            }
+        }
+        cpu<T>(m, n, beta_1, beta_2, eps, lr, weight_decay, decoupled,
+                &rows[0], &row_step[0], &grad[0], &first_moment[0],
+                &second_moment[0], &p[0]);
+#ifdef NNTILE_USE_CUDA
+        run_cuda<T>(m, n, beta_1, beta_2, eps, lr, weight_decay, decoupled,
+                &rows[0], row_step_cuda, grad, first_cuda, second_cuda,
+                p_cuda);
+#endif // NNTILE_USE_CUDA
+    }
+    for(Index j = 0; j < n; ++j)
+    {
+        TEST_ASSERT(row_step[j] == row_step_ref[j]);
+    }
+    check<T>(p, p_ref);
+    check<T>(first_moment, first_ref);
+    check<T>(second_moment, second_ref);
+    std::cout << "OK: kernel::sparse_adam_step::cpu<T>\n";
+#ifdef NNTILE_USE_CUDA
+    std::cout << "Run kernel::sparse_adam_step::cuda<T>\n";
+    for(Index j = 0; j < n; ++j)
+    {
+        TEST_ASSERT(row_step_cuda[j] == row_step_ref[j]);
+    }
+    check<T>(p_cuda, p_ref);
+    check<T>(first_cuda, first_ref);
+    check<T>(second_cuda, second_ref);
+    std::cout << "OK: kernel::sparse_adam_step::cuda<T>\n";
+#endif // NNTILE_USE_CUDA
+}
+
+int main(int argc, char **argv)
+{
+    validate<fp32_t>(1, 1, 0);
+    validate<fp32_t>(100, 20, 0);
+    validate<fp32_t>(100, 20, 1);
+    validate<fp64_t>(1, 1, 0);
+    validate<fp64_t>(100, 20, 0);
+    validate<fp64_t>(100, 20, 1);
+    return 0;
+}
+
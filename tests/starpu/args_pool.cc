@@ -0,0 +1,178 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/starpu/args_pool.cc
+ * Pooled allocation of codelet arguments
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-07
+ * */
+
+#include "nntile/starpu/config.hh"
+#include "nntile/starpu/fill.hh"
+#include "../testing.hh"
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::starpu;
+
+// Allocate and release blocks of different sizes within a single thread
+void validate_local()
+{
+    std::cout << "Run starpu::args_pool within a thread\n";
+    std::vector<std::size_t> sizes = {1, 8, 47, 48, 49, 100, 240, 496, 497,
+        10000};
+    std::vector<char *> ptrs;
+    for(Index iter = 0; iter < 200; ++iter)
+    {
+        std::size_t size = sizes[iter%sizes.size()];
+        char *ptr = static_cast<char *>(args_pool::alloc(size));
+        TEST_ASSERT(reinterpret_cast<std::uintptr_t>(ptr)
+                % alignof(std::max_align_t) == 0);
+        std::memset(ptr, iter, size);
+        ptrs.push_back(ptr);
+    }
+    // Check that blocks do not overlap
+    for(Index iter = 0; iter < 200; ++iter)
+    {
+        std::size_t size = sizes[iter%sizes.size()];
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            TEST_ASSERT(ptrs[iter][i] == static_cast<char>(iter));
+        }
+        args_pool::release(ptrs[iter]);
+    }
+    args_pool::release(nullptr);
+    // Released block is reused at once
+    void *ptr = args_pool::alloc(16);
+    args_pool::release(ptr);
+    TEST_ASSERT(args_pool::alloc(16) == ptr);
+    args_pool::release(ptr);
+    // Typed allocation
+    Index *nelems = args_pool::alloc<Index>(Index{123});
+    TEST_ASSERT(*nelems == 123);
+    args_pool::release(nelems);
+    // Arguments of a failed submission are returned to the pool
+    ptr = args_pool::alloc(16);
+    args_pool::check_submit(0, ptr, "Not thrown");
+    TEST_THROW(args_pool::check_submit(-1, ptr, "Error"));
+    TEST_ASSERT(args_pool::alloc(16) == ptr);
+    args_pool::release(ptr);
+    std::cout << "OK: starpu::args_pool within a thread\n";
+}
+
+// Blocks are allocated by one thread and released by others, as it happens
+// with codelet arguments and task callbacks
+void validate_remote()
+{
+    std::cout << "Run starpu::args_pool across threads\n";
+    constexpr Index nthreads = 4, nblocks = 10000;
+    std::vector<void *> ptrs(nthreads*nblocks);
+    for(auto &ptr: ptrs)
+    {
+        ptr = args_pool::alloc(32);
+    }
+    std::vector<std::thread> threads;
+    for(Index i = 0; i < nthreads; ++i)
+    {
+        threads.emplace_back([&ptrs, i]()
+        {
+            for(Index j = 0; j < nblocks; ++j)
+            {
+                args_pool::release(ptrs[i*nblocks+j]);
+                // Allocations of this thread do not interfere
+                args_pool::release(args_pool::alloc(32));
+            }
+        });
+    }
+    for(auto &thread: threads)
+    {
+        thread.join();
+    }
+    // All the returned blocks are reused by the owning thread
+    std::vector<void *> new_ptrs(ptrs.size());
+    for(auto &ptr: new_ptrs)
+    {
+        ptr = args_pool::alloc(32);
+    }
+    std::sort(ptrs.begin(), ptrs.end());
+    std::sort(new_ptrs.begin(), new_ptrs.end());
+    TEST_ASSERT(ptrs == new_ptrs);
+    for(auto ptr: new_ptrs)
+    {
+        args_pool::release(ptr);
+    }
+    std::cout << "OK: starpu::args_pool across threads\n";
+}
+
+// Packed arguments are unpacked the same way as STARPU_VALUE ones
+void validate_pack()
+{
+    std::cout << "Run starpu::args_pool::pack\n";
+    int ndim = 3;
+    fp64_t val = 1.5;
+    std::vector<Index> shape = {2, 3, 4};
+    std::size_t size;
+    void *args = args_pool::pack({
+            {&ndim, sizeof(ndim)},
+            {&val, sizeof(val)},
+            {&shape[0], ndim*sizeof(shape[0])}}, size);
+    TEST_ASSERT(size == sizeof(int)+3*sizeof(std::size_t)+sizeof(ndim)
+            +sizeof(val)+ndim*sizeof(shape[0]));
+    const int *ndim_ptr;
+    const fp64_t *val_ptr;
+    const Index *shape_ptr;
+    Config::unpack_args_ptr(args, ndim_ptr, val_ptr, shape_ptr);
+    TEST_ASSERT(*ndim_ptr == ndim);
+    TEST_ASSERT(*val_ptr == val);
+    for(Index i = 0; i < ndim; ++i)
+    {
+        TEST_ASSERT(shape_ptr[i] == shape[i]);
+    }
+    args_pool::release(args);
+    std::cout << "OK: starpu::args_pool::pack\n";
+}
+
+// Pooled arguments survive many actual tasks
+void validate_tasks()
+{
+    std::cout << "Run starpu::args_pool with tasks\n";
+    std::vector<fp32_t> data(16, -1);
+    VariableHandle data_handle(&data[0], sizeof(data[0])*data.size(),
+            STARPU_RW);
+    fill::restrict_where(STARPU_CPU);
+    for(Index i = 0; i < 1000; ++i)
+    {
+        fill::submit<fp32_t>(data.size(), fp32_t(i), data_handle);
+    }
+    starpu_task_wait_for_all();
+    data_handle.unregister();
+    for(auto val: data)
+    {
+        TEST_ASSERT(val == fp32_t(999));
+    }
+    std::cout << "OK: starpu::args_pool with tasks\n";
+}
+
+int main(int argc, char **argv)
+{
+    validate_local();
+    validate_remote();
+    validate_pack();
+    // Init StarPU for testing
+    Config starpu(1, 0, 0);
+    // Init codelet
+    fill::init();
+    validate_tasks();
+    return 0;
+}
+
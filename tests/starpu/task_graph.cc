@@ -0,0 +1,174 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/starpu/task_graph.cc
+ * Capture and replay of submitted tasks
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-11
+ * */
+
+#include "nntile/starpu/config.hh"
+#include "nntile/starpu/copy.hh"
+#include "nntile/starpu/scal_inplace.hh"
+#include "nntile/starpu/add.hh"
+#include "../testing.hh"
+#include <vector>
+#include <stdexcept>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::starpu;
+
+// Codelet, that stores ID of the worker, that executed it
+void worker_id_cpu(void *buffers[], void *cl_args)
+    noexcept
+{
+    auto ptr = reinterpret_cast<int *>(STARPU_VARIABLE_GET_PTR(buffers[0]));
+    *ptr = starpu_worker_get_id();
+}
+
+starpu_codelet worker_id_codelet;
+
+void validate_restrictions()
+{
+    // Pin a task, restricted to CPU, to the last CPU worker
+    int nworkers = starpu_cpu_worker_get_count();
+    int workerid = starpu_worker_get_by_type(STARPU_CPU_WORKER, nworkers-1);
+    int id = -1;
+    VariableHandle id_handle(&id, sizeof(id), STARPU_RW);
+    std::cout << "Run starpu::TaskGraph::replay with restricted task\n";
+    TaskGraph graph;
+    graph.begin_capture();
+    int ret = task_insert(&worker_id_codelet,
+            STARPU_W, static_cast<starpu_data_handle_t>(id_handle),
+            STARPU_EXECUTE_WHERE, static_cast<unsigned long long>(STARPU_CPU),
+            STARPU_EXECUTE_ON_WORKER, workerid,
+            0);
+    graph.end_capture();
+    TEST_ASSERT(ret == 0);
+    starpu_task_wait_for_all();
+    auto check = [&]()
+    {
+        auto id_local = id_handle.acquire(STARPU_RW);
+        auto id_ptr = reinterpret_cast<int *>(id_local.get_ptr());
+        TEST_ASSERT(*id_ptr == workerid);
+        *id_ptr = -1;
+        id_local.release();
+    };
+    check();
+    for(Index i = 0; i < 4; ++i)
+    {
+        graph.replay();
+        starpu_task_wait_for_all();
+        check();
+    }
+    std::cout << "OK: starpu::TaskGraph::replay with restricted task\n";
+}
+
+template<typename T>
+void validate(Index nelems)
+{
+    std::vector<T> x(nelems), x2(nelems), y(nelems), z(nelems, 1),
+        w(nelems);
+    for(Index i = 0; i < nelems; ++i)
+    {
+        x[i] = T(i+1);
+        x2[i] = T(-i);
+    }
+    VariableHandle x_handle(&x[0], sizeof(T)*nelems, STARPU_RW),
+        x2_handle(&x2[0], sizeof(T)*nelems, STARPU_RW),
+        y_handle(&y[0], sizeof(T)*nelems, STARPU_RW),
+        z_handle(&z[0], sizeof(T)*nelems, STARPU_RW),
+        w_handle(&w[0], sizeof(T)*nelems, STARPU_RW);
+    // Capture a sequence of tasks, that are executed at the same time
+    std::cout << "Run starpu::TaskGraph::begin_capture\n";
+    TaskGraph graph;
+    graph.begin_capture();
+    TEST_ASSERT(TaskGraph::capturing() == &graph);
+    copy::submit(x_handle, y_handle);
+    scal_inplace::submit<T>(2, nelems, y_handle);
+    add::submit<T>(nelems, 1, y_handle, 1, z_handle);
+    data_cpy(static_cast<starpu_data_handle_t>(w_handle),
+            static_cast<starpu_data_handle_t>(y_handle));
+    {
+        // Temporary handle is kept alive by the graph
+        VariableHandle tmp(sizeof(T)*nelems, STARPU_SCRATCH);
+    }
+    graph.end_capture();
+    TEST_ASSERT(TaskGraph::capturing() == nullptr);
+    TEST_ASSERT(graph.size() == 4);
+    starpu_task_wait_for_all();
+    auto check = [&](const std::vector<T> &src, Index nreplays)
+    {
+        auto y_local = y_handle.acquire(STARPU_R);
+        auto z_local = z_handle.acquire(STARPU_R);
+        auto w_local = w_handle.acquire(STARPU_R);
+        auto y_ptr = reinterpret_cast<const T *>(y_local.get_ptr());
+        auto z_ptr = reinterpret_cast<const T *>(z_local.get_ptr());
+        auto w_ptr = reinterpret_cast<const T *>(w_local.get_ptr());
+        for(Index i = 0; i < nelems; ++i)
+        {
+            TEST_ASSERT(y_ptr[i] == 2*src[i]);
+            TEST_ASSERT(w_ptr[i] == 2*src[i]);
+            T z_ref = 1 + 2*T(i+1) + (nreplays-1)*2*src[i];
+            TEST_ASSERT(z_ptr[i] == z_ref);
+        }
+        y_local.release();
+        z_local.release();
+        w_local.release();
+    };
+    check(x, 1);
+    std::cout << "OK: starpu::TaskGraph capture\n";
+    // Replay with another input
+    std::cout << "Run starpu::TaskGraph::replay\n";
+    graph.substitute(static_cast<starpu_data_handle_t>(x_handle),
+            static_cast<starpu_data_handle_t>(x2_handle));
+    graph.replay();
+    graph.replay();
+    starpu_task_wait_for_all();
+    check(x2, 3);
+    std::cout << "OK: starpu::TaskGraph::replay\n";
+    // Unregistration of a recorded handle during capture breaks the graph
+    std::cout << "Run starpu::TaskGraph with unregistered handle\n";
+    std::vector<T> tmp_data(nelems);
+    graph.begin_capture();
+    {
+        VariableHandle tmp(&tmp_data[0], sizeof(T)*nelems, STARPU_RW);
+        scal_inplace::submit<T>(3, nelems, tmp);
+    }
+    graph.end_capture();
+    TEST_THROW(graph.replay());
+    graph.clear();
+    TEST_ASSERT(graph.size() == 0);
+    std::cout << "OK: starpu::TaskGraph with unregistered handle\n";
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing
+    Config starpu(2, 0, 0);
+    // Init codelets
+    starpu_codelet_init(&worker_id_codelet);
+    worker_id_codelet.cpu_funcs[0] = worker_id_cpu;
+    worker_id_codelet.nbuffers = 1;
+    worker_id_codelet.modes[0] = STARPU_W;
+    worker_id_codelet.name = "worker_id";
+    copy::init();
+    scal_inplace::init();
+    add::init();
+    copy::restrict_where(STARPU_CPU);
+    scal_inplace::restrict_where(STARPU_CPU);
+    add::restrict_where(STARPU_CPU);
+    // Launch all tests
+    validate<fp32_t>(1);
+    validate<fp32_t>(1000);
+    validate<fp64_t>(1000);
+    validate_restrictions();
+    return 0;
+}
+
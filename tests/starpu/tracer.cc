@@ -0,0 +1,131 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/starpu/tracer.cc
+ * Tracing of submitted tasks
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-21
+ * */
+
+#include "nntile/starpu/config.hh"
+#include "nntile/starpu/copy.hh"
+#include "nntile/starpu/scal_inplace.hh"
+#include "../testing.hh"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+#include <iostream>
+
+using namespace nntile;
+using namespace nntile::starpu;
+
+template<typename T>
+void validate(Index nelems)
+{
+    std::vector<T> x(nelems, T(1)), y(nelems);
+    VariableHandle x_handle(&x[0], sizeof(T)*nelems, STARPU_RW),
+        y_handle(&y[0], sizeof(T)*nelems, STARPU_RW);
+    // Tasks are traced only while tracer is active
+    std::cout << "Run starpu::Tracer\n";
+    Tracer tracer;
+    copy::submit(x_handle, y_handle);
+    tracer.start();
+    TEST_ASSERT(Tracer::active() == &tracer);
+    Tracer tracer2;
+    TEST_THROW(tracer2.start());
+    tracer.push_scope("forward");
+    tracer.push_scope("Linear_0");
+    copy::submit(x_handle, y_handle);
+    tracer.pop_scope();
+    tracer.push_scope("Act_1");
+    scal_inplace::submit<T>(2, nelems, y_handle);
+    tracer.pop_scope();
+    tracer.pop_scope();
+    // Every thread has its own stack of scopes
+    tracer.push_scope("backward");
+    std::thread thread([&](){
+            tracer.push_scope("loader");
+            scal_inplace::submit<T>(1, nelems, x_handle);
+            tracer.pop_scope();
+            TEST_THROW(tracer.pop_scope());
+            });
+    thread.join();
+    tracer.pop_scope();
+    TEST_THROW(tracer.pop_scope());
+    // Replayed tasks are traced as well
+    TaskGraph graph;
+    graph.begin_capture();
+    scal_inplace::submit<T>(2, nelems, x_handle);
+    graph.end_capture();
+    graph.replay();
+    tracer.stop();
+    TEST_ASSERT(Tracer::active() == nullptr);
+    TEST_THROW(tracer.stop());
+    scal_inplace::submit<T>(2, nelems, x_handle);
+    starpu_task_wait_for_all();
+    TEST_ASSERT(tracer.size() == 5);
+    auto totals = tracer.scope_totals();
+    TEST_ASSERT(totals.size() == 4);
+    TEST_ASSERT(totals.count("loader") == 1);
+    TEST_ASSERT(totals.count("forward/Linear_0") == 1);
+    TEST_ASSERT(totals.count("forward/Act_1") == 1);
+    TEST_ASSERT(totals.count("") == 1);
+    for(const auto &kv: totals)
+    {
+        TEST_ASSERT(kv.second >= 0);
+    }
+    // Original callbacks of tasks are still called
+    auto x_local = x_handle.acquire(STARPU_R);
+    auto y_local = y_handle.acquire(STARPU_R);
+    auto x_ptr = reinterpret_cast<const T *>(x_local.get_ptr());
+    auto y_ptr = reinterpret_cast<const T *>(y_local.get_ptr());
+    for(Index i = 0; i < nelems; ++i)
+    {
+        TEST_ASSERT(x_ptr[i] == T(8));
+        TEST_ASSERT(y_ptr[i] == T(2));
+    }
+    x_local.release();
+    y_local.release();
+    std::cout << "OK: starpu::Tracer\n";
+    // Check output file
+    std::cout << "Run starpu::Tracer::save\n";
+    const char *filename = "nntile_test_tracer.json";
+    tracer.save(filename);
+    std::ifstream in(filename);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string trace = buffer.str();
+    in.close();
+    std::remove(filename);
+    TEST_ASSERT(trace.find("\"traceEvents\"") != std::string::npos);
+    TEST_ASSERT(trace.find("\"cat\":\"forward/Linear_0\"")
+            != std::string::npos);
+    TEST_ASSERT(trace.find(copy::codelet.name) != std::string::npos);
+    tracer.clear();
+    TEST_ASSERT(tracer.size() == 0);
+    std::cout << "OK: starpu::Tracer::save\n";
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing
+    Config starpu(1, 0, 0);
+    // Init codelets
+    copy::init();
+    scal_inplace::init();
+    copy::restrict_where(STARPU_CPU);
+    scal_inplace::restrict_where(STARPU_CPU);
+    // Launch all tests
+    validate<fp32_t>(1);
+    validate<fp64_t>(1000);
+    return 0;
+}
@@ -0,0 +1,135 @@
+/*! @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+ *                           (Skoltech). All rights reserved.
+ *
+ * NNTile is software framework for fast training of big neural networks on
+ * distributed-memory heterogeneous systems based on StarPU runtime system.
+ *
+ * @file tests/tensor/checkpoint.cc
+ * Save and load Tensor<T> in a tile-aligned binary file
+ *
+ * @version 1.0.0
+ * @author Aleksandr Mikhalev
+ * @date 2023-12-13
+ * */
+
+#include "nntile/tensor/checkpoint.hh"
+#include "nntile/starpu/write_tile.hh"
+#include "nntile/starpu/read_tile.hh"
+#include "../testing.hh"
+#include <cstdio>
+
+using namespace nntile;
+using namespace nntile::tensor;
+
+template<typename T>
+void check(const std::vector<Index> &shape,
+        const std::vector<Index> &basetile)
+{
+    // Barrier to wait for cleanup of previously used tags
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    // Some preparation
+    starpu_mpi_tag_t last_tag = 0;
+    int mpi_size = starpu_mpi_world_size();
+    int mpi_rank = starpu_mpi_world_rank();
+    const std::string filename = "test_checkpoint.nntile";
+    TensorTraits traits(shape, basetile);
+    Index ntiles = traits.grid.nelems;
+    std::vector<int> src_distr(ntiles), dst_distr(ntiles);
+    for(Index i = 0; i < ntiles; ++i)
+    {
+        src_distr[i] = (i+1) % mpi_size;
+        dst_distr[i] = (i+2) % mpi_size;
+    }
+    // Init source tensor
+    Tensor<T> src(traits, src_distr, last_tag);
+    for(Index i = 0; i < ntiles; ++i)
+    {
+        if(src_distr[i] == mpi_rank)
+        {
+            auto tile_handle = src.get_tile_handle(i);
+            auto tile_local = tile_handle.acquire(STARPU_W);
+            T *tile_local_ptr = reinterpret_cast<T *>(tile_local.get_ptr());
+            auto tile_traits = src.get_tile_traits(i);
+            for(Index j = 0; j < tile_traits.nelems; ++j)
+            {
+                tile_local_ptr[j] = T(i*j+1);
+            }
+            tile_local.release();
+        }
+    }
+    // Save and load into a tensor with another distribution
+    save<T>(src, filename);
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    Tensor<T> dst(traits, dst_distr, last_tag);
+    load<T>(dst, filename);
+    for(Index i = 0; i < ntiles; ++i)
+    {
+        if(dst_distr[i] == mpi_rank)
+        {
+            auto tile_handle = dst.get_tile_handle(i);
+            auto tile_local = tile_handle.acquire(STARPU_R);
+            T *tile_local_ptr = reinterpret_cast<T *>(tile_local.get_ptr());
+            auto tile_traits = dst.get_tile_traits(i);
+            for(Index j = 0; j < tile_traits.nelems; ++j)
+            {
+                TEST_ASSERT(tile_local_ptr[j] == T(i*j+1));
+            }
+            tile_local.release();
+        }
+    }
+    // Tensor of another shape or another type cannot be loaded
+    if(shape.size() > 0)
+    {
+        std::vector<Index> shape2(shape), basetile2(basetile);
+        ++shape2[0];
+        ++basetile2[0];
+        TensorTraits traits2(shape2, basetile), traits3(shape, basetile2);
+        std::vector<int> distr2(traits2.grid.nelems),
+            distr3(traits3.grid.nelems);
+        Tensor<T> dst2(traits2, distr2, last_tag),
+            dst3(traits3, distr3, last_tag);
+        TEST_THROW(load<T>(dst2, filename));
+        TEST_THROW(load<T>(dst3, filename));
+    }
+    Tensor<Index> dst_int(traits, dst_distr, last_tag);
+    TEST_THROW(load<Index>(dst_int, filename));
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    if(mpi_rank == 0)
+    {
+        std::remove(filename.c_str());
+    }
+}
+
+template<typename T>
+void validate()
+{
+    check<T>({}, {});
+    check<T>({2, 3, 4}, {2, 3, 4});
+    check<T>({11, 12, 13}, {2, 3, 4});
+    check<T>({768, 1000}, {384, 500});
+    // Missing file cannot be loaded
+    starpu_mpi_barrier(MPI_COMM_WORLD);
+    starpu_mpi_tag_t last_tag = 0;
+    std::vector<Index> sh23 = {2, 3};
+    std::vector<int> dist0 = {0};
+    TensorTraits trA(sh23, sh23);
+    Tensor<T> A(trA, dist0, last_tag);
+    TEST_THROW(load<T>(A, "test_checkpoint_missing.nntile"));
+}
+
+int main(int argc, char **argv)
+{
+    // Init StarPU for testing on CPU only
+    starpu::Config starpu(1, 0, 0);
+    // Init codelet
+    starpu::write_tile::init();
+    starpu::read_tile::init();
+    starpu::write_tile::restrict_where(STARPU_CPU);
+    starpu::read_tile::restrict_where(STARPU_CPU);
+    // Launch all tests
+    validate<fp32_t>();
+    validate<fp64_t>();
+    validate<bf16_t>();
+    return 0;
+}
+
@@ -0,0 +1,106 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/examples/gpt2_autotune.py
+# Recommend tile shapes of a GPT2 model for gpt2_custom_training.py
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2023-12-21
+
+# Imports
+import nntile
+from nntile.autotune import Calibration, GPT2TileTuner, save_tile_config
+from nntile.model.gpt2 import GPT2Config as GPT2Config_nntile
+import argparse
+import json
+import os
+import time
+
+# Create argument parser
+parser = argparse.ArgumentParser(prog="GPT2 tile autotuner", \
+        description="This example calibrates timings of tasks on available " \
+        "workers and recommends tile shapes of a GPT2 model, that minimize " \
+        "predicted time of a training step within a memory budget. The " \
+        "output can be passed to gpt2_custom_training.py with " \
+        "--tile-config.")
+parser.add_argument("--config-path")
+parser.add_argument("--minibatch", type=int, default=1)
+parser.add_argument("--seq-len", type=int, default=-1)
+parser.add_argument("--restrict", choices=["cpu", "cuda", None], \
+        default=None)
+parser.add_argument("--flashattention", action="store_true")
+parser.add_argument("--inference", action="store_true")
+parser.add_argument("--memory-budget", type=float, default=None, \
+        help="Memory budget in GiB")
+parser.add_argument("--calibration", help="Cache of calibration results")
+parser.add_argument("--output", default="gpt2_tiles.json")
+parser.add_argument("--top", type=int, default=5)
+
+# Parse arguments
+args = parser.parse_args()
+print(args, flush=True)
+
+# Load Huggingface config of a model
+with open(args.config_path, "r") as fd:
+    conf_dict = json.load(fd)
+n_inner = conf_dict.get("n_inner")
+if n_inner is None:
+    n_inner = 4 * conf_dict["n_embd"]
+if args.seq_len == -1:
+    args.seq_len = conf_dict["n_positions"]
+assert args.minibatch > 0
+assert args.seq_len > 0
+config = GPT2Config_nntile(conf_dict["vocab_size"], conf_dict["n_embd"], \
+        conf_dict["n_embd"], conf_dict["n_embd"], conf_dict["n_positions"], \
+        n_inner, n_inner, conf_dict["layer_norm_epsilon"], \
+        conf_dict["n_layer"], conf_dict["n_head"], conf_dict["n_head"], \
+        "gelutanh", args.flashattention)
+
+# Set up StarPU and init codelets
+nntile_config = nntile.starpu.Config(-1, -1, 1)
+nntile.starpu.init()
+if args.restrict == "cuda":
+    nntile.starpu.restrict_cuda()
+    nworkers = nntile.starpu.cuda_worker_count()
+elif args.restrict == "cpu":
+    nntile.starpu.restrict_cpu()
+    nworkers = nntile.starpu.cpu_worker_count()
+else:
+    nworkers = nntile.starpu.cpu_worker_count() \
+            + nntile.starpu.cuda_worker_count()
+next_tag = 0
+
+# Calibrate or load cached calibration
+if args.calibration is not None and os.path.exists(args.calibration):
+    calib = Calibration.load(args.calibration)
+    if calib.nworkers != nworkers:
+        raise ValueError("Calibration was done for {} workers, but {} " \
+                "workers are available".format(calib.nworkers, nworkers))
+    print("Loaded calibration from {}".format(args.calibration), flush=True)
+else:
+    time0 = time.time()
+    calib = Calibration(nworkers)
+    next_tag = calib.run(next_tag)
+    print("Calibration in {} seconds".format(time.time()-time0), flush=True)
+    if args.calibration is not None:
+        calib.save(args.calibration)
+
+# Rank tiles
+memory_budget = None
+if args.memory_budget is not None:
+    memory_budget = int(args.memory_budget * 1024**3)
+tuner = GPT2TileTuner(config, args.seq_len, args.minibatch, \
+        not args.inference)
+results = tuner.rank(calib, memory_budget)
+if len(results) == 0:
+    raise ValueError("No tiles fit into memory budget")
+print("Best tiles of {} candidates:".format(len(results)))
+for result in results[:args.top]:
+    print("  {} time {:.4f} s memory {:.2f} GiB".format(result["tiles"], \
+            result["time"], result["memory"]/1024**3))
+save_tile_config(results[0], args.output)
+print("Saved tiles to {}".format(args.output), flush=True)
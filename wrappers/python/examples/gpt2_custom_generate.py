@@ -60,6 +60,7 @@ parser.add_argument("--nwarmup", type=int, default=0)
 parser.add_argument("--input", choices=["text"], default="text")
 parser.add_argument("--input-path", default="input.txt")
 parser.add_argument("--ntokens", type=int, default=10)
+parser.add_argument("--kv-cache", action="store_true")
 
 # Parse arguments
 args = parser.parse_args()
@@ -133,6 +134,15 @@ nflops_seq_fwd = config.num_hidden_layers*nflops_seq_block_fwd \
         + 2*config.n_positions*config.n_embd*config.vocab_size
 nflops_seq = nflops_seq_fwd
 
+# FLOPs of a single step of incremental decoding at a given position. Only
+# the filled tiles of key-value caches take part in attention.
+def nflops_kv_step(pos):
+    n_kv = (pos//args.seq_tile+1) * args.seq_tile
+    nflops_block = 4*config.n_embd*config.n_inner + 8*config.n_embd**2 \
+            + 4*n_kv*config.n_embd
+    return config.num_hidden_layers*nflops_block \
+            + 2*config.n_embd*config.vocab_size
+
 # Initialize NNTile and StarPU
 time0 = time.time()
 # Set up StarPU+MPI and init codelets
@@ -155,19 +165,32 @@ model_nntile_config = GPT2Config_nntile(config.vocab_size, args.embd_tile, \
         config.n_inner, args.inner_tile, config.layer_norm_epsilon, \
         config.num_hidden_layers, config.n_head, args.head_tile, \
         "gelutanh", args.flashattention, args.redux)
-model_nntile, next_tag = GPT2Model_nntile.from_torch(model_torch, \
-        args.minibatch, args.minibatch_tile, config.n_positions, \
-        args.seq_tile, model_nntile_config, next_tag, args.fp32_fast_tf32)
+# With key-value cache the model processes a single new token per step
+if args.kv_cache:
+    model_nntile, next_tag = GPT2Model_nntile.from_torch(model_torch, \
+            args.minibatch, args.minibatch_tile, 1, 1, model_nntile_config, \
+            next_tag, args.fp32_fast_tf32, config.n_positions, args.seq_tile)
+else:
+    model_nntile, next_tag = GPT2Model_nntile.from_torch(model_torch, \
+            args.minibatch, args.minibatch_tile, config.n_positions, \
+            args.seq_tile, model_nntile_config, next_tag, \
+            args.fp32_fast_tf32)
 #model_torch.eval()
 del model_torch
 
 # Warmup
 if args.nwarmup > 0:
+    input_len = model_nntile.activations[0].value.shape[0]
     input_value = torch.randint(config.vocab_size, \
-            (1, config.n_positions), dtype=torch.int64)
+            (1, input_len), dtype=torch.int64)
     model_nntile.activations[0].value.from_array(input_value.T)
+    if args.kv_cache:
+        model_nntile.reset_kv_cache_async()
     for i in range(args.nwarmup):
-        model_nntile.forward_async()
+        if args.kv_cache:
+            model_nntile.forward_kv_cache_async(i % config.n_positions)
+        else:
+            model_nntile.forward_async()
     nntile.starpu.wait_for_all()
 
 # Prepare input batches
@@ -183,30 +206,55 @@ if args.input == "text":
     input_tokens_start = input_tokens.shape[1]-1
     input_numpy[0, 0:input_tokens_start] = input_tokens[0, :-1]
 
-# Run forward 50 times autoregressively
-output_numpy = np.zeros((config.vocab_size, config.n_positions, 1), \
-        dtype=np.float32, order='F')
-for i in range(args.ntokens):
-    model_nntile.activations[0].value.from_array(input_numpy.T)
-    model_nntile.forward_async()
-    model_nntile.activations[-1].value.to_array(output_numpy)
-    #with torch.no_grad():
-    #    torch_output_numpy = model_torch(torch.tensor(input_numpy))[0].numpy().T
-    #print(np.linalg.norm(torch_output_numpy-output_numpy) /
-    #        np.linalg.norm(torch_output_numpy))
-    #print(output_numpy[input_numpy[0, 0], 0, 0], output_numpy[:, 0, 0].max())
-    new_id = output_numpy[:50257, input_tokens_start+i-1, 0].argmax()
-    #print(new_id, output_numpy[new_id, input_tokens_start+i, 0])
-    input_numpy[0, input_tokens_start+i] = new_id
-    print(tokenizer.decode(input_numpy[0, 0:input_tokens_start+i+1]))
+# Generate tokens one by one, feeding only the last token into the model and
+# reusing keys and values of all previous tokens
+if args.kv_cache:
+    output_numpy = np.zeros((config.vocab_size, 1, 1), dtype=np.float32, \
+            order='F')
+    model_nntile.reset_kv_cache_async()
+    for pos in range(input_tokens_start+args.ntokens-1):
+        model_nntile.activations[0].value.from_array( \
+                input_numpy[:, pos:pos+1].T)
+        model_nntile.forward_kv_cache_async(pos)
+        # Outputs of prompt tokens are not needed
+        if pos < input_tokens_start-1:
+            continue
+        model_nntile.activations[-1].value.to_array(output_numpy)
+        new_id = output_numpy[:50257, 0, 0].argmax()
+        input_numpy[0, pos+1] = new_id
+        print(tokenizer.decode(input_numpy[0, 0:pos+2]))
+else:
+    # Run forward over the entire window autoregressively
+    output_numpy = np.zeros((config.vocab_size, config.n_positions, 1), \
+            dtype=np.float32, order='F')
+    for i in range(args.ntokens):
+        model_nntile.activations[0].value.from_array(input_numpy.T)
+        model_nntile.forward_async()
+        model_nntile.activations[-1].value.to_array(output_numpy)
+        #with torch.no_grad():
+        #    torch_output_numpy = model_torch(torch.tensor(input_numpy))[0].numpy().T
+        #print(np.linalg.norm(torch_output_numpy-output_numpy) /
+        #        np.linalg.norm(torch_output_numpy))
+        #print(output_numpy[input_numpy[0, 0], 0, 0], output_numpy[:, 0, 0].max())
+        new_id = output_numpy[:50257, input_tokens_start+i-1, 0].argmax()
+        #print(new_id, output_numpy[new_id, input_tokens_start+i, 0])
+        input_numpy[0, input_tokens_start+i] = new_id
+        print(tokenizer.decode(input_numpy[0, 0:input_tokens_start+i+1]))
 
 nntile.starpu.wait_for_all()
 time1 = time.time() - time0
 print("Generate time: {} seconds".format(time1))
-print("Generate throughput tokens/sec: {}".format( \
-        args.ntokens * config.n_positions / time1))
-print("Generate performance: {} Tflops/s".format(nflops_seq \
-        * args.ntokens / time1 * 1e-12))
+if args.kv_cache:
+    print("Generate throughput tokens/sec: {}".format( \
+            (input_tokens_start+args.ntokens-1) / time1))
+    nflops_generate = sum(nflops_kv_step(pos) \
+            for pos in range(input_tokens_start+args.ntokens-1))
+else:
+    print("Generate throughput tokens/sec: {}".format( \
+            args.ntokens * config.n_positions / time1))
+    nflops_generate = nflops_seq * args.ntokens
+print("Generate performance: {} Tflops/s".format(nflops_generate \
+        / time1 * 1e-12))
 
 # Unregister intermediate activations to free some space
 for t in model_nntile.activations:
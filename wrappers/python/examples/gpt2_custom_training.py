@@ -61,6 +61,7 @@ parser.add_argument("--seq-tile", type=int, default=-1)
 parser.add_argument("--embd-tile", type=int, default=-1)
 parser.add_argument("--inner-tile", type=int, default=-1)
 parser.add_argument("--head-tile", type=int, default=-1)
+parser.add_argument("--tile-config")
 parser.add_argument("--restrict", choices=["cpu", "cuda", None], \
         default=None)
 parser.add_argument("--flashattention", action="store_true")
@@ -74,9 +75,21 @@ parser.add_argument("--dataset", choices=["WikiText-103", "train.bin"], \
         default="WikiText-103")
 parser.add_argument("--dataset-path", default=".data")
 parser.add_argument("--dataset-select", type=int, default=100)
+parser.add_argument("--loader-buffers", type=int, default=0, \
+        help="Stream train.bin through this number of staging buffers " \
+        "instead of loading entire dataset into tensors")
+parser.add_argument("--lm-head-chunk", type=int, default=-1, \
+        help="Apply LM head within the loss by chunks of this number of " \
+        "classes, so that logits are never stored entirely")
+parser.add_argument("--sparse-embedding", action="store_true", \
+        help="Clear and update only rows of token embeddings, that are " \
+        "touched by a minibatch")
 parser.add_argument("--optimizer", choices=["sgd", "adam", "fusedadamw"], \
         default="fusedadamw")
 parser.add_argument("--optimizer-eps", type=float, default=1e-8)
+parser.add_argument("--optimizer-moments", choices=["fp32", "bf16"], \
+        default="fp32", help="Storage type of moments of fp32 parameters " \
+        "for fusedadamw optimizer")
 parser.add_argument("--weight-decay", type=float, default=0.0)
 parser.add_argument("--loss-reduction", choices=["sum", "mean"], default="sum")
 parser.add_argument("--lr", type=float, default=0.0)
@@ -116,6 +129,15 @@ if args.load_checkpoint is not None:
     model_torch.load_state_dict(checkpoint["model_state_dict"])
     del checkpoint
 
+# Tiles, recommended by gpt2_autotune.py, unless set explicitly
+if args.tile_config is not None:
+    with open(args.tile_config, "r") as fd:
+        tile_config = json.load(fd)
+    for key in ["minibatch_tile", "seq_tile", "embd_tile", "inner_tile", \
+            "head_tile"]:
+        if getattr(args, key) == -1:
+            setattr(args, key, tile_config[key])
+
 # Check sizes
 assert args.batch > 0
 if args.minibatch == -1:
@@ -147,6 +169,12 @@ assert args.nbackward_warmup >= 0
 assert args.nepochs >= 0
 assert args.nepochs_warmup >= 0
 assert args.weight_decay >= 0
+# Only fused optimizer keeps gradients of sparse embeddings zero outside of
+# touched rows, when weight decay is applied
+if args.sparse_embedding and args.optimizer in ["adam", "sgd"] \
+        and args.weight_decay > 0:
+    raise ValueError("--sparse-embedding with --weight-decay requires " \
+            "--optimizer fusedadamw")
 
 # Print altered PyTorch model to be tested
 print("PyTorch model:")
@@ -197,7 +225,9 @@ model_nntile_config = GPT2Config_nntile(config.vocab_size, args.embd_tile, \
         "gelutanh", args.flashattention, args.redux)
 model_nntile, next_tag = GPT2Model_nntile.from_torch(model_torch, \
         args.minibatch, args.minibatch_tile, config.n_positions, \
-        args.seq_tile, model_nntile_config, next_tag, args.fp32_fast_tf32)
+        args.seq_tile, model_nntile_config, next_tag, args.fp32_fast_tf32, \
+        lm_head_chunk=(args.lm_head_chunk if args.lm_head_chunk > 0 \
+        else None), sparse_embedding=args.sparse_embedding)
 del model_torch
 
 # Measure throughput of the forward pass by NNTile
@@ -247,81 +277,97 @@ if args.nbackward > 0:
 
 # Prepare input and output batches if real training is required
 # Read dataset
-if args.dataset == "WikiText-103":
-    train_dataset = load_dataset("wikitext", "wikitext-103-v1", \
-            split='train', cache_dir=args.dataset_path)
-    if args.dataset_select != -1:
-        train_dataset = train_dataset.select(np.arange(args.dataset_select, \
-                dtype=np.int64))
-    test_dataset = load_dataset("wikitext", "wikitext-103-v1", \
-            split='test', cache_dir=args.dataset_path)
-    tokenized = False
-elif args.dataset == "train.bin":
-    train_data = np.memmap(args.dataset_path, dtype=np.uint16, mode='r')
-    train_tokens = np.array(train_data, order='F', dtype=np.int64)
-    tokenized = True
-    del train_data
+# Stream pre-tokenized dataset, while training is in progress
+if args.loader_buffers > 0:
+    if args.dataset != "train.bin":
+        raise ValueError("Only train.bin dataset can be streamed")
+    loader = nntile.dataloader.TokenFileLoader(args.dataset_path, \
+            config.n_positions, args.minibatch, num_minibatch, \
+            args.seq_tile, args.minibatch_tile, next_tag, \
+            nbuffers=args.loader_buffers)
+    next_tag = loader.next_tag
+    num_train_batches = loader.num_batches
+    print("Total train batches: {}".format(num_train_batches), flush=True)
+    batch_input = loader
+    batch_output = None
 else:
-    raise ValueError("{} dataset is not supported yet!".format( \
-            args.dataset))
-# Tokenize and store as a single numpy array
-if not tokenized:
-    tokenizer = GPT2TokenizerFast.from_pretrained(args.tokenizer, \
-            cache_dir=args.tokenizer_path)
-    map_train_tokens = map(lambda x: tokenizer(x["text"])["input_ids"], \
-            train_dataset)
-    list_train_tokens = []
-    for seq in map_train_tokens:
-        list_train_tokens.extend(seq)
-    train_tokens = np.array(list_train_tokens, dtype=np.int64)
+    if args.dataset == "WikiText-103":
+        train_dataset = load_dataset("wikitext", "wikitext-103-v1", \
+                split='train', cache_dir=args.dataset_path)
+        if args.dataset_select != -1:
+            train_dataset = train_dataset.select(np.arange( \
+                    args.dataset_select, dtype=np.int64))
+        test_dataset = load_dataset("wikitext", "wikitext-103-v1", \
+                split='test', cache_dir=args.dataset_path)
+        tokenized = False
+    elif args.dataset == "train.bin":
+        train_data = np.memmap(args.dataset_path, dtype=np.uint16, mode='r')
+        train_tokens = np.array(train_data, order='F', dtype=np.int64)
+        tokenized = True
+        del train_data
+    else:
+        raise ValueError("{} dataset is not supported yet!".format( \
+                args.dataset))
+    # Tokenize and store as a single numpy array
+    if not tokenized:
+        tokenizer = GPT2TokenizerFast.from_pretrained(args.tokenizer, \
+                cache_dir=args.tokenizer_path)
+        map_train_tokens = map(lambda x: tokenizer(x["text"])["input_ids"], \
+                train_dataset)
+        list_train_tokens = []
+        for seq in map_train_tokens:
+            list_train_tokens.extend(seq)
+        train_tokens = np.array(list_train_tokens, dtype=np.int64)
 
-num_train_tokens = train_tokens.shape[0]
-num_train_seq = num_train_tokens // (config.n_positions+1)
-num_train_batches = num_train_seq // args.batch
-num_train_tokens_truncated = num_train_batches * args.batch \
-        * (config.n_positions+1)
-train_tokens = np.array(train_tokens[:num_train_tokens_truncated], \
-        order='F', dtype=np.int64)
-train_tokens = train_tokens.reshape(num_train_batches, \
-        num_minibatch, args.minibatch, config.n_positions+1)
-print("Total train batches: {}".format(num_train_batches))
-print("Total train sequences: {}".format(num_train_batches \
-        * args.batch))
-print("Total train tokens: {}".format(num_train_batches * args.batch \
-        * config.n_positions), flush=True)
+    num_train_tokens = train_tokens.shape[0]
+    num_train_seq = num_train_tokens // (config.n_positions+1)
+    num_train_batches = num_train_seq // args.batch
+    num_train_tokens_truncated = num_train_batches * args.batch \
+            * (config.n_positions+1)
+    train_tokens = np.array(train_tokens[:num_train_tokens_truncated], \
+            order='F', dtype=np.int64)
+    train_tokens = train_tokens.reshape(num_train_batches, \
+            num_minibatch, args.minibatch, config.n_positions+1)
+    print("Total train batches: {}".format(num_train_batches))
+    print("Total train sequences: {}".format(num_train_batches \
+            * args.batch))
+    print("Total train tokens: {}".format(num_train_batches * args.batch \
+            * config.n_positions), flush=True)
 
-# Train neural network by the NNTile
-# Prepare input and output batches for training by NNTile
-time0 = time.time()
-batch_input = []
-batch_output = []
-x_traits = nntile.tensor.TensorTraits( \
-        [config.n_positions, args.minibatch], \
-        [args.seq_tile, args.minibatch_tile])
-x_distr = [0] * x_traits.grid.nelems
-for i in range(num_train_batches):
-    minibatch_input = []
-    minibatch_output = []
-    for j in range(num_minibatch):
-        x = nntile.tensor.Tensor_int64(x_traits, x_distr, next_tag)
-        next_tag = x.next_tag
-        x.from_array(np.asfortranarray(train_tokens[i, j, :, :-1].T))
-        minibatch_input.append(x)
-        y = nntile.tensor.Tensor_int64(x_traits, x_distr, next_tag)
-        next_tag = y.next_tag
-        y.from_array(np.asfortranarray(train_tokens[i, j, :, 1:].T))
-        minibatch_output.append(y)
-    batch_input.append(minibatch_input)
-    batch_output.append(minibatch_output)
-time1 = time.time() - time0
-print("From PyTorch loader to NNTile batches in {} seconds".format(time1), \
-        flush=True)
+    # Train neural network by the NNTile
+    # Prepare input and output batches for training by NNTile
+    time0 = time.time()
+    batch_input = []
+    batch_output = []
+    x_traits = nntile.tensor.TensorTraits( \
+            [config.n_positions, args.minibatch], \
+            [args.seq_tile, args.minibatch_tile])
+    x_distr = [0] * x_traits.grid.nelems
+    for i in range(num_train_batches):
+        minibatch_input = []
+        minibatch_output = []
+        for j in range(num_minibatch):
+            x = nntile.tensor.Tensor_int64(x_traits, x_distr, next_tag)
+            next_tag = x.next_tag
+            x.from_array(np.asfortranarray(train_tokens[i, j, :, :-1].T))
+            minibatch_input.append(x)
+            y = nntile.tensor.Tensor_int64(x_traits, x_distr, next_tag)
+            next_tag = y.next_tag
+            y.from_array(np.asfortranarray(train_tokens[i, j, :, 1:].T))
+            minibatch_output.append(y)
+        batch_input.append(minibatch_input)
+        batch_output.append(minibatch_output)
+    time1 = time.time() - time0
+    print("From PyTorch loader to NNTile batches in {} seconds".format( \
+            time1), flush=True)
 # Set up learning rate and optimizer for training
 if args.optimizer == "fusedadamw":
     optimizer = nntile.optimizer.FusedAdamW(model_nntile.get_parameters(), \
             args.lr, next_tag, eps=args.optimizer_eps, \
             start_lr=args.start_lr, full_lr_iter=args.full_lr_iter, \
-            weight_decay=args.weight_decay)
+            weight_decay=args.weight_decay, \
+            moments_dtype=("bf16" if args.optimizer_moments == "bf16" \
+            else None))
 elif args.optimizer == "adam":
     optimizer = nntile.optimizer.Adam(model_nntile.get_parameters(), \
             args.lr, next_tag, eps=args.optimizer_eps, \
@@ -341,8 +387,14 @@ if args.loss_reduction == "sum":
     loss_scale = 1.0
 elif args.loss_reduction == "mean":
     loss_scale = 1.0 / (args.batch*config.n_positions)
-loss, next_tag = nntile.loss.CrossEntropy.generate_simple( \
-        model_nntile.activations[-1], next_tag, scale=loss_scale)
+if args.lm_head_chunk > 0:
+    loss, next_tag = nntile.loss.LinearCrossEntropy.generate_simple( \
+            model_nntile.activations[-1], model_nntile.lm_head.w, next_tag, \
+            redux=args.redux, scale=loss_scale, \
+            fp32_fast_tf32=args.fp32_fast_tf32)
+else:
+    loss, next_tag = nntile.loss.CrossEntropy.generate_simple( \
+            model_nntile.activations[-1], next_tag, scale=loss_scale)
 # Set up training pipeline
 pipeline = nntile.pipeline.Pipeline(batch_input, batch_output, \
         model_nntile, optimizer, loss, args.nepochs_warmup)
@@ -409,9 +461,12 @@ if args.save_optimizer is not None:
 # Unregister all StarPU buffers
 loss.unregister()
 optimizer.unregister()
-for batch in batch_input+batch_output:
-    for x in batch:
-        x.unregister()
+if args.loader_buffers > 0:
+    loader.unregister()
+else:
+    for batch in batch_input+batch_output:
+        for x in batch:
+            x.unregister()
 
 # Unregister all tensors related to model, that are still registered
 model_nntile.unregister()
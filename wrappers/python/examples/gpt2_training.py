@@ -77,6 +77,8 @@ parser.add_argument("--nntile-restrict", choices=["cpu", "cuda", None], \
         default=None)
 parser.add_argument("--nntile-flashattention", action="store_true")
 parser.add_argument("--nntile-use-redux", action="store_true")
+parser.add_argument("--nntile-memory-plan", action="store_true")
+parser.add_argument("--nntile-trace", type=str, default="")
 parser.add_argument("--nntile-nforward", type=int, default=0)
 parser.add_argument("--nntile-nforward-warmup", type=int, default=0)
 parser.add_argument("--nntile-nbackward", type=int, default=0)
@@ -209,6 +211,11 @@ nntile_model, next_tag = GPT2Model_nntile.from_torch(model_torch, \
         args.minibatch_size, args.minibatch_size_tile, config.n_positions, \
         args.seq_len_tile, nntile_model_config, next_tag)
 
+# Share storage of activations and temporaries with disjoint lifetimes
+if args.nntile_memory_plan:
+    next_tag = nntile_model.plan_memory(next_tag)
+    print(nntile_model.memory_plan.summary())
+
 # Check that to_torch method works
 # base_model_torch = GPT2LMHeadModel(config)
 # base_model_torch.lm_head.weight = nn.Parameter(base_model_torch.lm_head \
@@ -564,6 +571,10 @@ if args.nntile_nepochs > 0:
     # Actual training
     pipeline.n_epochs = args.nntile_nepochs
     nntile.starpu.profiling_enable()
+    # Trace tasks of actual training for Perfetto UI
+    if args.nntile_trace:
+        tracer = nntile.starpu.Tracer()
+        tracer.start()
     #nntile.starpu.pause()
     time0 = time.time()
     pipeline.train_async()
@@ -571,6 +582,14 @@ if args.nntile_nepochs > 0:
     nntile.starpu.wait_for_all()
     nntile.starpu.profiling_disable()
     time1 = time.time() - time0
+    if args.nntile_trace:
+        tracer.stop()
+        tracer.save(args.nntile_trace)
+        totals = sorted(tracer.scope_totals().items(), key=lambda x: -x[1])
+        print("NNTile busy time of the heaviest scopes:")
+        for scope, total in totals[:10]:
+            print("  {}: {:.3f} seconds".format(scope or "none", \
+                    total*1e-6))
     print("NNTile training time: {} seconds".format(time1))
     print("NNTile training throughput tokens/sec: {}".format( \
             args.nntile_nepochs * num_train_batches * args.batch_size \
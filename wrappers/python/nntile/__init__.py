@@ -12,4 +12,5 @@
 # @date 2023-02-22
 
 from .nntile_core import starpu, tile, TransOp, trans, notrans
-from . import layer, loss, model, tensor, pipeline, optimizer
+from . import layer, loss, model, tensor, pipeline, optimizer, amp, autotune, \
+        dataloader
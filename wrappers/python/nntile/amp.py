@@ -0,0 +1,91 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/amp.py
+# Dynamic loss scaling for automatic mixed precision training
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2023-12-19
+
+from nntile.tensor import TensorTraits, TensorMoments, Tensor_bool, \
+        clear_async, amp_unscale_async, amp_nonfinite
+from nntile.nntile_core import starpu as core_starpu
+from typing import List
+
+class GradScaler:
+    params: List[TensorMoments]
+    nonfinite: Tensor_bool
+    scale: float
+    growth_factor: float
+    backoff_factor: float
+    growth_interval: int
+    next_tag: int
+
+    # Gradients are computed for the loss multiplied by scale, so that small
+    # values do not flush to zero in half precision. Before the optimizer step
+    # gradients are unscaled and checked for inf and NaN within a single pass.
+    # The step is skipped and scale is reduced on overflow, while after
+    # growth_interval successful steps in a row scale is increased.
+    def __init__(self, params: List[TensorMoments], next_tag: int, \
+            init_scale: float=2.0**16, growth_factor: float=2.0, \
+            backoff_factor: float=0.5, growth_interval: int=2000):
+        if growth_factor <= 1.0:
+            raise ValueError("growth_factor must be greater than 1")
+        if backoff_factor <= 0.0 or backoff_factor >= 1.0:
+            raise ValueError("backoff_factor must be in range (0, 1)")
+        self.params = params
+        # Flag is gathered over all gradient tiles of a node, while flags of
+        # different nodes are reduced only when they are read
+        mpi_size = core_starpu.mpi_size()
+        flag_traits = TensorTraits([mpi_size], [1])
+        self.nonfinite = Tensor_bool(flag_traits, list(range(mpi_size)), \
+                next_tag)
+        self.next_tag = self.nonfinite.next_tag
+        self.scale = init_scale
+        self.growth_factor = growth_factor
+        self.backoff_factor = backoff_factor
+        self.growth_interval = growth_interval
+        self.growth_tracker = 0
+        self.num_skipped = 0
+
+    def get_next_tag(self):
+        return self.next_tag
+
+    def unregister(self):
+        self.nonfinite.unregister()
+
+    # Make loss produce scaled gradients. Value of the loss is not scaled.
+    def scale_loss(self, loss):
+        loss.loss_scale = self.scale
+
+    # Unscale gradients and check them for inf and NaN values. Returns True
+    # on all nodes if all gradients are finite. Unscale tasks of all gradients
+    # are submitted before the flags are read once, and the read waits only
+    # for these tasks.
+    def unscale(self) -> bool:
+        clear_async(self.nonfinite)
+        inv_scale = 1.0 / self.scale
+        for p in self.params:
+            if p.grad_required:
+                amp_unscale_async(inv_scale, p.grad, self.nonfinite)
+        return not amp_nonfinite(self.nonfinite)
+
+    # Unscale gradients, apply optimizer if they are finite and update scale.
+    # Returns True if optimizer step was applied.
+    def step(self, optimizer) -> bool:
+        if not self.unscale():
+            self.scale *= self.backoff_factor
+            self.growth_tracker = 0
+            self.num_skipped += 1
+            return False
+        optimizer.step()
+        self.growth_tracker += 1
+        if self.growth_tracker == self.growth_interval:
+            self.scale *= self.growth_factor
+            self.growth_tracker = 0
+        return True
+
@@ -0,0 +1,365 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/autotune.py
+# Tile shape autotuner based on calibration of task timings
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2023-12-21
+
+from nntile.nntile_core import starpu as core_starpu, notrans
+from nntile.tensor import TensorTraits, Tensor_fp32, gemm_async, add_async, \
+        clear_async
+import numpy as np
+import itertools
+import json
+import math
+import time
+from typing import Dict, List
+
+class Calibration:
+    nworkers: int
+    gemm_times: Dict[int, float]
+    elementwise_times: Dict[int, float]
+    submit_time: float
+
+    # Timings of tasks are measured with all workers busy, so they include
+    # overheads of StarPU and contention of workers for memory bandwidth.
+    # GEMMs are measured for cubes of given sizes, elementwise tasks are
+    # measured as additions of given numbers of elements. A single size of
+    # each kind is enough, then timings are scaled proportionally to work.
+    def __init__(self, nworkers: int, \
+            gemm_sizes: List[int]=[32, 64, 128, 256, 512, 1024], \
+            elementwise_sizes: List[int]=[1, 2**20]):
+        if nworkers <= 0:
+            raise ValueError("nworkers must be positive")
+        if len(gemm_sizes) == 0 or min(gemm_sizes) <= 0:
+            raise ValueError("gemm_sizes must be a non-empty list of " \
+                    "positive sizes")
+        if len(elementwise_sizes) == 0 or min(elementwise_sizes) <= 0:
+            raise ValueError("elementwise_sizes must be a non-empty list " \
+                    "of positive sizes")
+        self.nworkers = nworkers
+        self.gemm_sizes = sorted(set(gemm_sizes))
+        self.elementwise_sizes = sorted(set(elementwise_sizes))
+        self.gemm_times = {}
+        self.elementwise_times = {}
+        self.submit_time = 0.0
+
+    # Run a wave of independent tasks on all workers until time is enough
+    # for a stable measurement. Returns time of a single wave.
+    @staticmethod
+    def _time_waves(submit_wave, min_time: float) -> float:
+        submit_wave()
+        core_starpu.wait_for_all()
+        nwaves = 1
+        while True:
+            time0 = time.time()
+            for i in range(nwaves):
+                submit_wave()
+            core_starpu.wait_for_all()
+            elapsed = time.time() - time0
+            if elapsed >= min_time:
+                return elapsed / nwaves
+            nwaves *= 2
+
+    # Run calibration sweeps
+    def run(self, next_tag: int, min_time: float=0.05) -> int:
+        for size in self.gemm_sizes:
+            traits = TensorTraits([size, size], [size, size])
+            tensors = []
+            for i in range(self.nworkers+2):
+                tensors.append(Tensor_fp32(traits, [0], next_tag))
+                next_tag = tensors[-1].next_tag
+            for t in tensors:
+                clear_async(t)
+            A, B = tensors[:2]
+            def wave():
+                for C in tensors[2:]:
+                    gemm_async(1.0, notrans, A, notrans, B, 0.0, C, 1, 0)
+            self.gemm_times[size] = self._time_waves(wave, min_time)
+            for t in tensors:
+                t.unregister()
+        for size in self.elementwise_sizes:
+            traits = TensorTraits([size], [size])
+            tensors = []
+            for i in range(self.nworkers+1):
+                tensors.append(Tensor_fp32(traits, [0], next_tag))
+                next_tag = tensors[-1].next_tag
+            for t in tensors:
+                clear_async(t)
+            x = tensors[0]
+            def wave():
+                for y in tensors[1:]:
+                    add_async(1.0, x, 1.0, y)
+            self.elementwise_times[size] = self._time_waves(wave, min_time)
+            for t in tensors:
+                t.unregister()
+        # Submission of tasks is done by a single thread
+        ntiles = 4096
+        traits = TensorTraits([ntiles], [1])
+        t = Tensor_fp32(traits, [0]*ntiles, next_tag)
+        next_tag = t.next_tag
+        clear_async(t)
+        core_starpu.wait_for_all()
+        time0 = time.time()
+        clear_async(t)
+        self.submit_time = (time.time()-time0) / ntiles
+        core_starpu.wait_for_all()
+        t.unregister()
+        return next_tag
+
+    def save(self, path: str):
+        with open(path, "w") as fd:
+            json.dump({"nworkers": self.nworkers, \
+                    "gemm_times": self.gemm_times, \
+                    "elementwise_times": self.elementwise_times, \
+                    "submit_time": self.submit_time}, fd, indent=2)
+
+    @staticmethod
+    def load(path: str):
+        with open(path, "r") as fd:
+            data = json.load(fd)
+        gemm_times = {int(k): v for k, v in data["gemm_times"].items()}
+        elementwise_times = {int(k): v for k, v in \
+                data["elementwise_times"].items()}
+        calib = Calibration(data["nworkers"], list(gemm_times.keys()), \
+                list(elementwise_times.keys()))
+        calib.gemm_times = gemm_times
+        calib.elementwise_times = elementwise_times
+        calib.submit_time = data["submit_time"]
+        return calib
+
+    # Time of a wave of (batched) GEMM tasks of a given shape. Performance
+    # is interpolated over calibrated cubes by geometric mean of sizes, and
+    # the smallest cube gives overhead of a task. A single calibrated cube
+    # gives performance without any overhead.
+    def gemm_time(self, m: int, n: int, k: int, batch: int=1) -> float:
+        sizes = self.gemm_sizes
+        if len(sizes) == 1:
+            s = sizes[0]
+            rate = 2.0*s**3 / max(self.gemm_times[s], 1e-9)
+            return 2.0*m*n*k*batch/rate
+        t0 = self.gemm_times[sizes[0]]
+        rates = [2.0*s**3 / max(self.gemm_times[s]-t0, 1e-9) \
+                for s in sizes[1:]]
+        g = (m*n*k) ** (1.0/3.0)
+        if g <= sizes[1]:
+            rate = rates[0]
+        elif g >= sizes[-1]:
+            rate = rates[-1]
+        else:
+            rate = np.interp(math.log(g), np.log(sizes[1:]), rates)
+        return t0 + 2.0*m*n*k*batch/rate
+
+    # Time of a wave of elementwise tasks on tiles of given number of
+    # elements, interpolated linearly over calibrated sizes
+    def elementwise_time(self, nelems: int) -> float:
+        sizes = self.elementwise_sizes
+        times = [self.elementwise_times[s] for s in sizes]
+        if len(sizes) == 1:
+            return times[0] * nelems / sizes[0]
+        if nelems <= sizes[-1]:
+            return np.interp(nelems, sizes, times)
+        slope = (times[-1]-times[0]) / (sizes[-1]-sizes[0])
+        return times[-1] + slope*(nelems-sizes[-1])
+
+# Divisors of a dimension, that are not less than a given minimum, if any
+def tile_candidates(dim: int, min_tile: int=1) -> List[int]:
+    divisors = [d for d in range(1, dim+1) if dim % d == 0]
+    large = [d for d in divisors if d >= min_tile]
+    return large if len(large) > 0 else [dim]
+
+class GPT2TileTuner:
+    # Tile shapes of a GPT2 model are chosen by a cost model of a training
+    # (or inference) step. Every GEMM of a block is split into waves of
+    # independent output tiles over all workers, times a number of tiles in
+    # the reduction dimension, with timing of a task from calibration.
+    # Elementwise operations cost a wave of tasks per tile of their tensors.
+    # A step can not be faster than submission of all its tasks by a single
+    # thread. Memory is predicted for parameters, gradients, Adam moments and
+    # activations in single precision plus tiles, used by workers at the same
+    # time.
+    def __init__(self, config, seq_len: int, minibatch_size: int, \
+            training: bool=True):
+        self.config = config
+        self.seq_len = seq_len
+        self.minibatch_size = minibatch_size
+        self.training = training
+        embed_dim = config["embed_dim"]
+        n_head = config["n_head"]
+        if embed_dim % n_head != 0:
+            raise ValueError("embed_dim must be divisible by n_head")
+        self.head_size = embed_dim // n_head
+
+    # Candidates for every tile shape
+    def candidates(self) -> Dict[str, List[int]]:
+        return {"seq_tile": tile_candidates(self.seq_len, 32), \
+                "minibatch_tile": tile_candidates(self.minibatch_size), \
+                "embd_tile": tile_candidates(self.config["embed_dim"], 64), \
+                "inner_tile": tile_candidates(self.config["inner_dim"], 64), \
+                "head_tile": tile_candidates(self.config["n_head"])}
+
+    # GEMMs of a block and of LM head as lists of full and tile shapes
+    # (M, N, K, batch) and numbers of such GEMMs
+    def _gemms(self, tiles: Dict[str, int]):
+        E = self.config["embed_dim"]
+        I = self.config["inner_dim"]
+        H = self.config["n_head"]
+        V = self.config["vocab_size"]
+        D = self.head_size
+        S = self.seq_len
+        B = self.minibatch_size
+        T = S * B
+        et = tiles["embd_tile"]
+        it = tiles["inner_tile"]
+        ht = tiles["head_tile"]
+        st = tiles["seq_tile"]
+        tok = st * tiles["minibatch_tile"]
+        hbt = ht * tiles["minibatch_tile"]
+        block = [ \
+                # Projections into queries, keys and values
+                ((H*D, T, E, 1), (ht*D, tok, et, 1), 3), \
+                # Products of queries and keys
+                ((S, S, D, H*B), (st, st, D, hbt), 1), \
+                # Products of attention weights and values
+                ((D, S, S, H*B), (D, st, st, hbt), 1), \
+                # Output projection
+                ((E, T, H*D, 1), (et, tok, ht*D, 1), 1), \
+                # MLP
+                ((I, T, E, 1), (it, tok, et, 1), 1), \
+                ((E, T, I, 1), (et, tok, it, 1), 1)]
+        lm_head = [((V, T, E, 1), (V, tok, et, 1), 1)]
+        return block, lm_head
+
+    # Elementwise operations of a block as lists of full and tile numbers
+    # of elements and numbers of operations
+    def _elementwise(self, tiles: Dict[str, int]):
+        E = self.config["embed_dim"]
+        I = self.config["inner_dim"]
+        H = self.config["n_head"]
+        S = self.seq_len
+        B = self.minibatch_size
+        et = tiles["embd_tile"]
+        it = tiles["inner_tile"]
+        ht = tiles["head_tile"]
+        st = tiles["seq_tile"]
+        bt = tiles["minibatch_tile"]
+        # Layer normalizations, residual additions and biases
+        ops = [(E*S*B, et*st*bt, 16 if self.training else 8), \
+                # Bias and activation of MLP
+                (I*S*B, it*st*bt, 5 if self.training else 2)]
+        # Mask and softmax of attention, fused into GEMMs by flash attention
+        if not self.config["flashattention"]:
+            ops.append((S*S*H*B, st*st*ht*bt, 7 if self.training else 3))
+        return ops
+
+    # Predicted time of a step in seconds
+    def predict_time(self, tiles: Dict[str, int], calib: Calibration) \
+            -> float:
+        nworkers = calib.nworkers
+        exec_time = 0.0
+        ntasks = 0
+        block, lm_head = self._gemms(tiles)
+        def gemm_cost(full, tile, count):
+            nonlocal ntasks
+            M, N, K, batch = full
+            mt, nt, kt, bt = tile
+            nout = math.ceil(M/mt) * math.ceil(N/nt) * math.ceil(batch/bt)
+            nk = math.ceil(K/kt)
+            ntasks += count * nout * nk
+            return count * math.ceil(nout/nworkers) * nk \
+                    * calib.gemm_time(mt, nt, kt, bt)
+        def gemm_step_cost(full, tile, count):
+            cost = gemm_cost(full, tile, count)
+            if self.training:
+                # Gradients over both inputs of C=AB
+                M, N, K, batch = full
+                mt, nt, kt, bt = tile
+                cost += gemm_cost((M, K, N, batch), (mt, kt, nt, bt), count)
+                cost += gemm_cost((K, N, M, batch), (kt, nt, mt, bt), count)
+            return cost
+        nlayers = self.config["num_hidden_layers"]
+        for full, tile, count in block:
+            exec_time += nlayers * gemm_step_cost(full, tile, count)
+        for full, tile, count in lm_head:
+            exec_time += gemm_step_cost(full, tile, count)
+        for nelems, tile_nelems, count in self._elementwise(tiles):
+            ntiles = math.ceil(nelems / tile_nelems)
+            ntasks += nlayers * count * ntiles
+            exec_time += nlayers * count * math.ceil(ntiles/nworkers) \
+                    * calib.elementwise_time(tile_nelems)
+        # Submission overlaps with execution
+        return max(exec_time, ntasks*calib.submit_time)
+
+    # Predicted memory in bytes, that does not depend on tiles
+    def fixed_memory(self) -> int:
+        E = self.config["embed_dim"]
+        I = self.config["inner_dim"]
+        H = self.config["n_head"]
+        V = self.config["vocab_size"]
+        L = self.config["num_hidden_layers"]
+        P = self.config["max_position_embeddings"]
+        T = self.seq_len * self.minibatch_size
+        nparams = L*(4*E*E + 2*E*I + I + 9*E) + (V+P)*E + 2*E
+        # Values, gradients and two moments of Adam
+        param_bytes = 4 * nparams * (4 if self.training else 1)
+        # Activations and temporaries of a block
+        act = 13*E*T + 2*I*T
+        if not self.config["flashattention"]:
+            act += self.seq_len * self.seq_len * H * self.minibatch_size
+        if self.training:
+            act_bytes = 4 * (2*L*act + 2*V*T)
+        else:
+            act_bytes = 4 * (2*act + V*T)
+        return param_bytes + act_bytes
+
+    # Predicted memory in bytes. Every worker holds tiles of the largest
+    # GEMM task and prefetches the next one.
+    def predict_memory(self, tiles: Dict[str, int], nworkers: int) -> int:
+        block, lm_head = self._gemms(tiles)
+        working_set = 0
+        for full, (mt, nt, kt, bt), count in block + lm_head:
+            working_set = max(working_set, 4*bt*(mt*kt + kt*nt + mt*nt))
+        return self.fixed_memory() + 2*nworkers*working_set
+
+    # Predictions for all candidates, that fit into memory budget, sorted
+    # by time. Ties are resolved in favour of larger tiles, that produce
+    # less tasks.
+    def rank(self, calib: Calibration, memory_budget: int=None) \
+            -> List[Dict]:
+        if memory_budget is not None and self.fixed_memory() > memory_budget:
+            raise ValueError("Model does not fit into memory budget with " \
+                    "any tiles")
+        candidates = self.candidates()
+        keys = list(candidates.keys())
+        results = []
+        for values in itertools.product(*[candidates[k] for k in keys]):
+            tiles = dict(zip(keys, values))
+            memory = self.predict_memory(tiles, calib.nworkers)
+            if memory_budget is not None and memory > memory_budget:
+                continue
+            results.append({"tiles": tiles, "memory": memory, \
+                    "time": self.predict_time(tiles, calib)})
+        results.sort(key=lambda x: (x["time"], -np.prod(list( \
+                x["tiles"].values()))))
+        return results
+
+    # The best tiles with their predicted step time and memory
+    def recommend(self, calib: Calibration, memory_budget: int=None) -> Dict:
+        results = self.rank(calib, memory_budget)
+        if len(results) == 0:
+            raise ValueError("No tiles fit into memory budget")
+        return results[0]
+
+# Save tiles in a format of --tile-config of GPT2 examples
+def save_tile_config(result: Dict, path: str):
+    config = dict(result["tiles"])
+    config["predicted_step_time"] = result["time"]
+    config["predicted_memory"] = result["memory"]
+    with open(path, "w") as fd:
+        json.dump(config, fd, indent=2)
@@ -0,0 +1,173 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/dataloader.py
+# Streaming loader of pre-tokenized datasets for training pipeline
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2023-12-21
+
+from nntile.tensor import TensorTraits, Tensor_int64
+import numpy as np
+import queue
+import threading
+from typing import List
+
+class TokenFileLoader(object):
+    """Streaming loader of a flat file of tokens
+
+    The file is read through a memory map, so only minibatches that are
+    currently prepared are read from disk. A background thread converts
+    tokens of the next minibatches into host arrays of a ring of staging
+    buffers and submits asynchronous copies of them into input and target
+    tensors, while the main thread submits tasks of the current minibatch.
+    Memory of staging tiles is allocated by StarPU, that pins it when CUDA
+    workers are present, so uploads of inputs to GPUs are asynchronous
+    copies, scheduled by StarPU as part of the task graph.
+
+    A buffer is reused only after the pipeline has submitted copies from
+    it into the model. Writing into a tile waits for earlier tasks that read
+    it, so the background thread never overwrites data that was not yet
+    consumed. Before a host array is overwritten, the thread waits only for
+    tiles of the same buffer, so neither forward nor backward tasks are
+    waited for.
+
+    If more batches are requested than the file contains, tokens are read
+    cyclically, i.e., a minibatch at the end of the file continues from its
+    beginning.
+    """
+    x: List[Tensor_int64]
+    y: List[Tensor_int64]
+    num_batches: int
+    num_minibatch: int
+
+    def __init__(self, path: str, seq_len: int, minibatch: int, \
+            num_minibatch: int, seq_tile: int, minibatch_tile: int, \
+            next_tag: int, num_batches: int = -1, nbuffers: int = 2, \
+            dtype=np.uint16, offset: int = 0):
+        if nbuffers < 1:
+            raise ValueError("nbuffers must be positive")
+        self.tokens = np.memmap(path, dtype=dtype, mode="r", offset=offset)
+        self.seq_len = seq_len
+        self.minibatch = minibatch
+        self.num_minibatch = num_minibatch
+        # Every minibatch is a contiguous chunk of tokens, as input and
+        # target are shifted by one token
+        self.chunk = minibatch * (seq_len+1)
+        if self.tokens.shape[0] < self.chunk:
+            raise ValueError("File {} is shorter than a minibatch".format( \
+                    path))
+        if num_batches == -1:
+            num_batches = self.tokens.shape[0] // (self.chunk*num_minibatch)
+        if num_batches <= 0:
+            raise ValueError("File {} contains no full batch".format(path))
+        self.num_batches = num_batches
+        # Ring of staging buffers
+        traits = TensorTraits([seq_len, minibatch], [seq_tile, minibatch_tile])
+        distr = [0] * traits.grid.nelems
+        self.x = []
+        self.y = []
+        # Host arrays are read by copy tasks, so they live as long as tensors
+        self.x_host = []
+        self.y_host = []
+        for i in range(nbuffers):
+            self.x.append(Tensor_int64(traits, distr, next_tag))
+            next_tag = self.x[-1].next_tag
+            self.y.append(Tensor_int64(traits, distr, next_tag))
+            next_tag = self.y[-1].next_tag
+            self.x_host.append(np.zeros((seq_len, minibatch), \
+                    dtype=np.int64, order="F"))
+            self.y_host.append(np.zeros((seq_len, minibatch), \
+                    dtype=np.int64, order="F"))
+        self.next_tag = next_tag
+        # Indices of buffers, that can be overwritten and that are ready
+        self.free = queue.Queue()
+        for i in range(nbuffers):
+            self.free.put(i)
+        self.ready = queue.Queue()
+        self.thread = None
+        self.error = None
+
+    def _fill(self):
+        try:
+            for i in range(self.num_batches * self.num_minibatch):
+                slot = self.free.get()
+                # Loader is stopped
+                if slot is None:
+                    return
+                tokens = self._read(i*self.chunk).reshape(self.minibatch, \
+                        self.seq_len+1)
+                # Previous copies from host arrays of the slot shall be
+                # finished before the arrays are overwritten
+                self.x[slot].wait_tiles()
+                self.y[slot].wait_tiles()
+                # Tensors are stored in Fortran order with sequence as the
+                # first dimension
+                self.x_host[slot][...] = tokens[:, :-1].T
+                self.y_host[slot][...] = tokens[:, 1:].T
+                self.x[slot].from_array_async(self.x_host[slot])
+                self.y[slot].from_array_async(self.y_host[slot])
+                self.ready.put(slot)
+        except BaseException as e:
+            self.error = e
+            self.ready.put(None)
+
+    def _read(self, start: int):
+        """Read a chunk of tokens, wrapping around the end of the file"""
+        ntokens = self.tokens.shape[0]
+        start %= ntokens
+        end = start + self.chunk
+        if end <= ntokens:
+            return np.asarray(self.tokens[start:end])
+        return np.concatenate((self.tokens[start:], \
+                self.tokens[:end-ntokens]))
+
+    def start_epoch(self):
+        """Start reading the file from the beginning"""
+        self.stop()
+        self.error = None
+        self.thread = threading.Thread(target=self._fill, daemon=True)
+        self.thread.start()
+
+    def minibatches(self):
+        """Iterate over (input, target) tensors of minibatches of a batch
+
+        A buffer is given back to the loader, when the next minibatch is
+        requested, so tasks reading the buffer must be submitted by then.
+        """
+        for i in range(self.num_minibatch):
+            slot = self.ready.get()
+            if slot is None:
+                raise RuntimeError("Loading of tokens failed") \
+                        from self.error
+            yield self.x[slot], self.y[slot]
+            self.free.put(slot)
+
+    def __len__(self):
+        return self.num_batches
+
+    def __iter__(self):
+        for i in range(self.num_batches):
+            yield self.minibatches()
+
+    def stop(self):
+        """Stop background thread and reset buffers"""
+        if self.thread is None:
+            return
+        self.free.put(None)
+        self.thread.join()
+        self.thread = None
+        self.free = queue.Queue()
+        for i in range(len(self.x)):
+            self.free.put(i)
+        self.ready = queue.Queue()
+
+    def unregister(self):
+        self.stop()
+        # Unregistering waits for copies, that still read host arrays
+        for t in self.x + self.y:
+            t.unregister()
@@ -16,7 +16,8 @@ from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
         TransOp, trans, notrans, clear_async, gemm_async, randn_async, \
         maxsumexp_async, softmax_inplace_async, sumprod_slice_async, \
         add_slice_async, prod_async, mask_scalar_async, add_fiber_async, \
-        sum_fiber_async, transpose_async, copy_async, gemm_ex_async
+        sum_fiber_async, transpose_async, copy_async, gemm_ex_async, \
+        copy_intersection_async
 
 from nntile.layer.base_layer import BaseLayer
 import numpy as np
@@ -49,6 +50,9 @@ class Attention(BaseLayer):
     a_sumprod_slice: Tensor
     b: TensorMoments
     b_transposed: TensorMoments
+    k_cache: TensorOrNone
+    v_cache: TensorOrNone
+    kv_cache_pos: int
     n_head: int
     head_size: int
 
@@ -64,7 +68,9 @@ class Attention(BaseLayer):
             b: TensorMoments, b_transposed: TensorMoments, \
             in_proj_bias_q: TensorMoments, in_proj_bias_k: TensorMoments, \
             in_proj_bias_v: TensorMoments, out_proj_bias: TensorMoments, \
-            mask=None, redux: bool=False, fp32_fast_tf32: bool=False):
+            mask=None, redux: bool=False, fp32_fast_tf32: bool=False, \
+            k_cache: TensorOrNone=None, v_cache: TensorOrNone=None, \
+            kv_views: List[tuple]=None):
         qkv_bias_list = []
         if in_proj_bias_q:
             qkv_bias_list.append(in_proj_bias_q)
@@ -84,7 +90,8 @@ class Attention(BaseLayer):
         super().__init__([x_q, x_k, x_v], [y], [w_q, w_k, w_v] + \
                 qkv_bias_list + [w] + bias_list_out_proj, \
                 [q_transposed, q, k_transposed, k, v_transposed, v, a, \
-                a_maxsumexp, a_sumprod_slice, b, b_transposed])
+                a_maxsumexp, a_sumprod_slice, b, b_transposed, k_cache, \
+                v_cache])
         self.x_q = x_q
         self.x_q.grad.set_reduction_add()
         self.x_k = x_k
@@ -143,13 +150,93 @@ class Attention(BaseLayer):
         else:
             self.redux = 0
         self.fp32_fast_tf32 = fp32_fast_tf32
+        # Key and value caches for incremental decoding
+        self.k_cache = k_cache
+        self.v_cache = v_cache
+        self.kv_cache_pos = 0
+        if kv_views is None:
+            kv_views = []
+        self.kv_views = kv_views
+        for k_view, v_view, a_view, mask_view in kv_views:
+            a_view.set_reduction_add()
+
+    # Tensor of the first ntiles tiles of a given tensor along a given axis,
+    # that shares tiles with the given tensor
+    @staticmethod
+    def generate_prefix_view(t: Tensor, axis: int, ntiles: int, \
+            next_tag: int):
+        shape = list(t.shape)
+        basetile = list(t.basetile_shape)
+        shape[axis] = min(ntiles*basetile[axis], shape[axis])
+        traits = TensorTraits(shape, basetile)
+        grid_shape = traits.grid.shape
+        full_grid_shape = t.grid.shape
+        # Tiles of both tensors are stored in Fortran order
+        tiles = []
+        for i in range(traits.grid.nelems):
+            full_i = 0
+            stride = 1
+            for dim, full_dim in zip(grid_shape, full_grid_shape):
+                full_i += (i%dim) * stride
+                i //= dim
+                stride *= full_dim
+            tiles.append(full_i)
+        distr = [t.distribution[i] for i in tiles]
+        view = type(t)(traits, distr, next_tag)
+        next_tag = view.next_tag
+        handles = t.get_tile_handles()
+        view.alias_tiles([handles[i] for i in tiles])
+        return view, next_tag
+
+    # Views of caches, scores and mask, that cover only the first tiles along
+    # the cached sequence axis, for every number of such tiles. A step of
+    # incremental decoding uses the shortest views, that cover all the tokens
+    # in the caches, so its cost grows with the number of cached tokens,
+    # rounded up to kv_cache_size_tile, instead of the size of the cache.
+    @staticmethod
+    def generate_kv_views(k_cache: Tensor, v_cache: Tensor, a: Tensor, \
+            mask, next_tag: int):
+        kv_views = []
+        for ntiles in range(1, k_cache.grid.shape[1]+1):
+            k_view, next_tag = Attention.generate_prefix_view(k_cache, 1, \
+                    ntiles, next_tag)
+            v_view, next_tag = Attention.generate_prefix_view(v_cache, 1, \
+                    ntiles, next_tag)
+            a_view, next_tag = Attention.generate_prefix_view(a, 0, ntiles, \
+                    next_tag)
+            if mask is None:
+                mask_view = None
+            else:
+                mask_view, next_tag = Attention.generate_prefix_view(mask, \
+                        0, ntiles, next_tag)
+            kv_views.append((k_view, v_view, a_view, mask_view))
+        return kv_views, next_tag
+
+    # Allocate key and value caches for incremental decoding. Caches have
+    # shape (head_size, kv_cache_size, n_batch, n_head) and are tiled along
+    # the sequence axis just like keys and values of a full forward pass.
+    @staticmethod
+    def generate_kv_cache(TensorType, head_size: int, kv_cache_size: int, \
+            kv_cache_size_tile: int, n_batch: int, n_batch_tile: int, \
+            n_head: int, n_head_tile: int, next_tag: int):
+        cache_shape = [head_size, kv_cache_size, n_batch, n_head]
+        cache_basetile = [head_size, kv_cache_size_tile, n_batch_tile, \
+                n_head_tile]
+        cache_traits = TensorTraits(cache_shape, cache_basetile)
+        cache_distr = [0] * cache_traits.grid.nelems
+        k_cache = TensorType(cache_traits, cache_distr, next_tag)
+        next_tag = k_cache.next_tag
+        v_cache = TensorType(cache_traits, cache_distr, next_tag)
+        next_tag = v_cache.next_tag
+        return k_cache, v_cache, next_tag
 
     # Simple generator for the linear layer
     @staticmethod
     def generate_simple(x_q: TensorMoments, x_k: TensorMoments, \
             x_v: TensorMoments, n_head: int, n_head_tile: int, next_tag: int, \
             bias=False, mask=None, redux: bool=False, \
-            fp32_fast_tf32: bool=False):
+            fp32_fast_tf32: bool=False, kv_cache_size: int=None, \
+            kv_cache_size_tile: int=None):
         # Get sizes
         n_emb, n_seq, n_batch = x_q.value.shape
         n_emb_tile, n_seq_tile, n_batch_tile = x_q.value.basetile_shape
@@ -171,6 +258,15 @@ class Attention(BaseLayer):
             raise ValueError("Invalid basetile shape of x_v")
         # Fixed for now
         head_size_tile = head_size
+        # Keys and values span the entire cache in incremental decoding mode
+        if kv_cache_size is None:
+            n_seq_kv = n_seq
+            n_seq_kv_tile = n_seq_tile
+        else:
+            if kv_cache_size_tile is None:
+                kv_cache_size_tile = kv_cache_size
+            n_seq_kv = kv_cache_size
+            n_seq_kv_tile = kv_cache_size_tile
         # Define shape of each tensor
         w_q_shape = [n_head, head_size, n_emb]
         w_k_shape = [n_head, head_size, n_emb_k]
@@ -182,7 +278,7 @@ class Attention(BaseLayer):
         k_shape = [head_size, n_seq, n_batch, n_head]
         v_transposed_shape = [n_head, head_size, n_seq, n_batch]
         v_shape = [head_size, n_seq, n_batch, n_head]
-        a_shape = [n_seq, n_seq, n_batch, n_head]
+        a_shape = [n_seq_kv, n_seq, n_batch, n_head]
         a_maxsumexp_shape = [2, n_seq, n_batch, n_head]
         a_sumprod_slice_shape = [n_seq, n_batch, n_head]
         b_shape = [head_size, n_seq, n_batch, n_head]
@@ -198,7 +294,7 @@ class Attention(BaseLayer):
         k_basetile = [head_size_tile, n_seq_tile, n_batch_tile, n_head_tile]
         v_transposed_basetile = [n_head_tile, head_size_tile, n_seq_tile, n_batch_tile]
         v_basetile = [head_size_tile, n_seq_tile, n_batch_tile, n_head_tile]
-        a_basetile = [n_seq_tile, n_seq_tile, n_batch_tile, n_head_tile]
+        a_basetile = [n_seq_kv_tile, n_seq_tile, n_batch_tile, n_head_tile]
         a_maxsumexp_basetile = [2, n_seq_tile, n_batch_tile, n_head_tile]
         a_sumprod_slice_basetile = [n_seq_tile, n_batch_tile, n_head_tile]
         b_basetile = [head_size_tile, n_seq_tile, n_batch_tile, n_head_tile]
@@ -388,12 +484,25 @@ class Attention(BaseLayer):
         y_grad = type(x_q.value)(y_traits, x_q.value.distribution, next_tag)
         next_tag = y_grad.next_tag
         y = TensorMoments(y_value, y_grad, True)
+        # Allocate key and value caches if needed
+        if kv_cache_size is None:
+            k_cache = None
+            v_cache = None
+            kv_views = []
+        else:
+            k_cache, v_cache, next_tag = Attention.generate_kv_cache( \
+                    type(x_q.value), head_size, kv_cache_size, \
+                    kv_cache_size_tile, n_batch, n_batch_tile, n_head, \
+                    n_head_tile, next_tag)
+            kv_views, next_tag = Attention.generate_kv_views(k_cache, \
+                    v_cache, a.value, mask, next_tag)
         # Create attention layer with all the provided data
         layer = Attention(x_q, x_k, x_v, y, w_q, w_k, w_v, w, q_transposed, \
                 q, k_transposed, k, v_transposed, v, a, a_maxsumexp, \
                 a_sumprod_slice, b, b_transposed, bias_inproj_q, \
                 bias_inproj_k, bias_inproj_v, out_proj_bias, mask, \
-                redux=redux, fp32_fast_tf32=fp32_fast_tf32)
+                redux=redux, fp32_fast_tf32=fp32_fast_tf32, k_cache=k_cache, \
+                v_cache=v_cache, kv_views=kv_views)
         # Return layer and next tag to be used
         return (layer, next_tag)
 
@@ -475,33 +584,46 @@ class Attention(BaseLayer):
             add_fiber_async(1, self.in_proj_bias_v.value, 1, \
                     self.v.value, 0, 1)
             self.in_proj_bias_v.value.wont_use()
+        # In incremental decoding mode new keys and values are appended to
+        # the caches and the softmax runs only over tiles of the caches, that
+        # hold tokens
+        if self.k_cache is None:
+            k_value = self.k.value
+            v_value = self.v.value
+            a_value = self.a.value
+            mask = self.mask
+        else:
+            self.update_kv_cache_async()
+            n_seq_kv = self.kv_cache_pos + self.x_q.value.shape[1]
+            ntiles = (n_seq_kv-1)//self.k_cache.basetile_shape[1] + 1
+            k_value, v_value, a_value, mask = self.kv_views[ntiles-1]
         # Get tensor for softmax
         # A = 1.0/sqrt(head_size) * einsum('jklb,jmlb->kmlb', K, Q)
         # single batched gemm (head_size, n_seq, batch=n_batch, batch=n_head)
         # by (head_size, n_seq, batch=n_batch, batch=n_head) into
         # (n_seq, n_seq, batch=n_batch, batch=n_head)
         if self.fp32_fast_tf32:
-            gemm_ex_async(1.0/self.head_size**0.5, trans, self.k.value, \
-                    notrans, self.q.value, 0.0, self.a.value, 1, 2, \
+            gemm_ex_async(1.0/self.head_size**0.5, trans, k_value, \
+                    notrans, self.q.value, 0.0, a_value, 1, 2, \
                     redux=self.redux)
         else:
-            gemm_async(1.0/self.head_size**0.5, trans, self.k.value, \
-                    notrans, self.q.value, 0.0, self.a.value, 1, 2, \
+            gemm_async(1.0/self.head_size**0.5, trans, k_value, \
+                    notrans, self.q.value, 0.0, a_value, 1, 2, \
                     redux=self.redux)
         clear_async(self.a_maxsumexp)
         # Q and K can be offloaded from GPU
         self.q.value.wont_use()
-        self.k.value.wont_use()
+        k_value.wont_use()
         # Calculate softmax inplace
         # A = softmax(A, axis=0)
         # Apply mask if needed
-        if self.mask:
-            mask_scalar_async(self.mask, self.val, self.a.value, 2)
-            self.mask.wont_use()
+        if mask:
+            mask_scalar_async(mask, self.val, a_value, 2)
+            mask.wont_use()
         # Calculate max and sumexp along axis
-        maxsumexp_async(self.a.value, self.a_maxsumexp, 0, redux=self.redux)
+        maxsumexp_async(a_value, self.a_maxsumexp, 0, redux=self.redux)
         # Finally, get the inplace softmax
-        softmax_inplace_async(self.a_maxsumexp, 1.0, self.a.value, 0)
+        softmax_inplace_async(self.a_maxsumexp, 1.0, a_value, 0)
         # A_maxsumexp can be deleted
         #self.a_maxsumexp.wont_use()
         self.a_maxsumexp.invalidate_submit()
@@ -511,14 +633,14 @@ class Attention(BaseLayer):
         # by (n_seq, n_seq, batch=n_batch, batch=n_head) into
         # (head_size, n_seq, batch=n_batch, batch=n_head)
         if self.fp32_fast_tf32:
-            gemm_ex_async(1.0, notrans, self.v.value, notrans, \
-                    self.a.value, 0.0, self.b.value, 1, 2, redux=self.redux)
+            gemm_ex_async(1.0, notrans, v_value, notrans, \
+                    a_value, 0.0, self.b.value, 1, 2, redux=self.redux)
         else:
-            gemm_async(1.0, notrans, self.v.value, notrans, \
-                    self.a.value, 0.0, self.b.value, 1, 2, redux=self.redux)
+            gemm_async(1.0, notrans, v_value, notrans, \
+                    a_value, 0.0, self.b.value, 1, 2, redux=self.redux)
         # V and A can be offloaded from GPU
-        self.v.value.wont_use()
-        self.a.value.wont_use()
+        v_value.wont_use()
+        a_value.wont_use()
         # Accumulate result from all the heads
         # rotate axes (head_size, n_seq, n_batch, n_head) into
         # (n_head, head_size, n_seq, n_batch) and then
@@ -546,8 +668,53 @@ class Attention(BaseLayer):
             self.out_proj_bias.value.wont_use()
         self.y.value.wont_use()
 
+    # Clear key and value caches before decoding a new sequence
+    def reset_kv_cache_async(self):
+        if self.k_cache is None:
+            raise RuntimeError("Layer was created without key-value cache")
+        # Values of a cleared cache are multiplied by zero probabilities of
+        # masked positions, so they must not contain NaNs
+        clear_async(self.k_cache)
+        clear_async(self.v_cache)
+        self.kv_cache_pos = 0
+
+    # Views of caches share tiles with caches, that stay registered until
+    # caches themselves are unregistered
+    def unregister(self):
+        BaseLayer.unregister(self)
+        for views in self.kv_views:
+            for t in views:
+                if t is not None:
+                    t.unregister()
+
+    # Key and value caches keep their state between forward passes
+    def transient_temporaries(self):
+        return [t for t in self.temporaries if t is not None \
+                and t is not self.k_cache and t is not self.v_cache]
+
+    # Set position of the first token of the next forward pass
+    def set_kv_cache_position(self, pos: int):
+        if self.k_cache is None:
+            raise RuntimeError("Layer was created without key-value cache")
+        n_seq = self.x_q.value.shape[1]
+        if pos < 0 or pos+n_seq > self.k_cache.shape[1]:
+            raise ValueError("Tokens do not fit into the key-value cache")
+        self.kv_cache_pos = pos
+
+    # Copy keys and values of new tokens into caches at the current position
+    def update_kv_cache_async(self):
+        # Only tiles of caches that intersect new tokens are touched
+        offset = [0, self.kv_cache_pos, 0, 0]
+        copy_intersection_async(self.k.value, offset, self.k_cache, \
+                [0, 0, 0, 0])
+        copy_intersection_async(self.v.value, offset, self.v_cache, \
+                [0, 0, 0, 0])
+
     # Backward propagation of the linear layer
     def backward_async(self):
+        if self.k_cache is not None:
+            raise RuntimeError("Backward is not supported in incremental " \
+                    "decoding mode")
         # Apply backward of bias if needed
         if self.out_proj_bias is not None:
             if self.out_proj_bias.grad_required:
@@ -43,6 +43,17 @@ class BaseLayer(object):
             randn_async(p.value, [0]*len(p.value.shape), p.value.shape, \
                     seed, mean, stddev)
 
+    # Switch layer into automatic mixed precision mode. Layers with
+    # half-precision kernels allocate their temporaries here, while all other
+    # layers keep running in their own precision.
+    def enable_amp(self, next_tag: int) -> int:
+        return next_tag
+
+    # Switch layer into int8 inference mode. Layers with int8 kernels
+    # quantize their weights here, while all other layers are left intact.
+    def quantize(self, next_tag: int) -> int:
+        return next_tag
+
     def forward_async(self):
         raise NotImplementedError
 
@@ -57,6 +68,17 @@ class BaseLayer(object):
         self.forward_async()
         starpu.wait_for_all()
 
+    # Temporaries, that are recomputed by every forward pass. Layers, that
+    # keep a state between forward passes in temporaries, shall exclude it.
+    def transient_temporaries(self):
+        return [t for t in self.temporaries if t is not None]
+
+    # Drop temporaries, as the next forward pass recomputes them. It is used
+    # by activation checkpointing of models.
+    def discard_temporaries_submit(self):
+        for t in self.transient_temporaries():
+            t.discard_submit()
+
     # Unregister layer weights and temporary tensors
     def unregister(self):
         for p in self.parameters:
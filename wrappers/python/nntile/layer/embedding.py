@@ -12,7 +12,8 @@
 # @date 2023-09-29
 
 from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
-        Tensor_int64, clear_async, embedding_async, embedding_backward_async
+        RowSparseTensorMoments, Tensor_int64, Tensor_bool, clear_async, \
+        embedding_async, embedding_backward_async, embedding_rows_async
 from nntile.layer.base_layer import BaseLayer
 import numpy as np
 from typing import List
@@ -34,11 +35,14 @@ class Embedding(BaseLayer):
         self.w.grad.set_reduction_add()
         self.axis = axis
 
-    # Simple generator for the embedding layer
+    # Simple generator for the embedding layer. With sparse=True gradient of
+    # embeddings is row-sparse: only rows, touched by tokens, are marked,
+    # cleared and updated by optimizers, while the rest of the gradient stays
+    # zero all the time
     @staticmethod
     def generate_simple(x: Tensor_int64, TensorType, axis: int, \
             vocab_size: int, emb_size: int, y_emb_tile: int, w_emb_tile: int, \
-            next_tag: int):
+            next_tag: int, sparse: bool=False):
         # Check embedding tile sizes
         if y_emb_tile % w_emb_tile != 0:
             raise ValueError("y_emb_tile % w_emb_tile != 0")
@@ -51,7 +55,16 @@ class Embedding(BaseLayer):
         next_tag = w_value.next_tag
         w_grad = TensorType(w_traits, w_distr, next_tag)
         next_tag = w_grad.next_tag
-        w = TensorMoments(w_value, w_grad, True)
+        if sparse:
+            rows_traits = TensorTraits([vocab_size], [vocab_size])
+            rows = Tensor_bool(rows_traits, [w_distr[0]], next_tag)
+            next_tag = rows.next_tag
+            # Row-sparse gradient must be zero outside of marked rows
+            clear_async(w_grad)
+            clear_async(rows)
+            w = RowSparseTensorMoments(w_value, w_grad, True, rows)
+        else:
+            w = TensorMoments(w_value, w_grad, True)
         # Output embeddings
         y_shape = x.shape.copy()
         y_shape.insert(axis, emb_size)
@@ -83,6 +96,9 @@ class Embedding(BaseLayer):
         # sparse operation, but reduction plays with a full dense vocabulary
         embedding_backward_async(self.x, self.y.grad, self.w.grad, self.axis, \
                 redux=0)
+        if type(self.w) is RowSparseTensorMoments:
+            embedding_rows_async(self.x, self.w.rows)
+            self.w.rows.wont_use()
         self.x.wont_use()
         self.y.grad.wont_use()
         self.w.grad.wont_use()
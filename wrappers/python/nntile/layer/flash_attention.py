@@ -21,6 +21,7 @@ from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
         gemm_ex_async
 
 from nntile.layer.base_layer import BaseLayer
+from nntile.layer.attention import Attention
 import numpy as np
 from typing import List
 
@@ -51,6 +52,9 @@ class FlashAttention(BaseLayer):
     a_sumprod_slice: Tensor
     b: TensorMoments
     b_transposed: TensorMoments
+    k_cache: TensorOrNone
+    v_cache: TensorOrNone
+    kv_cache_pos: int
     n_head: int
     head_size: int
 
@@ -66,7 +70,9 @@ class FlashAttention(BaseLayer):
             b: TensorMoments, b_transposed: TensorMoments, \
             in_proj_bias_q: TensorMoments, in_proj_bias_k: TensorMoments, \
             in_proj_bias_v: TensorMoments, out_proj_bias: TensorMoments, \
-            mask=None, redux: bool=False, fp32_fast_tf32: bool=False):
+            mask=None, redux: bool=False, fp32_fast_tf32: bool=False, \
+            k_cache: TensorOrNone=None, v_cache: TensorOrNone=None, \
+            kv_views: List[tuple]=None):
         assert w_q.value.shape[0] % w_q.value.basetile_shape[0] == 0
         qkv_bias_list = []
         if in_proj_bias_q:
@@ -87,7 +93,8 @@ class FlashAttention(BaseLayer):
         super().__init__([x_q, x_k, x_v], [y], [w_q, w_k, w_v] + \
                 qkv_bias_list + [w] + bias_list_out_proj, \
                 [q_transposed, q, k_transposed, k, v_transposed, v, a, \
-                a_maxsumexp, a_sumprod_slice, b, b_transposed])
+                a_maxsumexp, a_sumprod_slice, b, b_transposed, k_cache, \
+                v_cache])
         self.x_q = x_q
         self.x_q.grad.set_reduction_add()
         self.x_k = x_k
@@ -146,13 +153,23 @@ class FlashAttention(BaseLayer):
         else:
             self.redux = 0
         self.fp32_fast_tf32 = fp32_fast_tf32
+        # Key and value caches for incremental decoding
+        self.k_cache = k_cache
+        self.v_cache = v_cache
+        self.kv_cache_pos = 0
+        if kv_views is None:
+            kv_views = []
+        self.kv_views = kv_views
+        for k_view, v_view, a_view, mask_view in kv_views:
+            a_view.set_reduction_add()
 
     # Simple generator for the linear layer
     @staticmethod
     def generate_simple(x_q: TensorMoments, x_k: TensorMoments, \
             x_v: TensorMoments, n_head: int, n_head_tile: int, next_tag: int, \
             bias=False, mask=None, redux: bool=False, \
-            fp32_fast_tf32: bool=False):
+            fp32_fast_tf32: bool=False, kv_cache_size: int=None, \
+            kv_cache_size_tile: int=None):
         # Get sizes
         n_emb, n_seq, n_batch = x_q.value.shape
         n_emb_tile, n_seq_tile, n_batch_tile = x_q.value.basetile_shape
@@ -175,6 +192,15 @@ class FlashAttention(BaseLayer):
         # Head size dimension is never divided into tiles to make Flash
         # Attention work properly without temporarily saved buffers
         head_size_tile = head_size
+        # Keys and values span the entire cache in incremental decoding mode
+        if kv_cache_size is None:
+            n_seq_kv = n_seq
+            n_seq_kv_tile = n_seq_tile
+        else:
+            if kv_cache_size_tile is None:
+                kv_cache_size_tile = kv_cache_size
+            n_seq_kv = kv_cache_size
+            n_seq_kv_tile = kv_cache_size_tile
         # Define shape of each tensor
         w_q_shape = [n_head, head_size, n_emb]
         w_k_shape = [n_head, head_size, n_emb_k]
@@ -186,7 +212,7 @@ class FlashAttention(BaseLayer):
         k_shape = [head_size, n_seq, n_batch, n_head]
         v_transposed_shape = [n_head, head_size, n_seq, n_batch]
         v_shape = [head_size, n_seq, n_batch, n_head]
-        a_shape = [n_seq, n_seq, n_batch, n_head]
+        a_shape = [n_seq_kv, n_seq, n_batch, n_head]
         a_maxsumexp_shape = [2, n_seq, n_batch, n_head]
         a_sumprod_slice_shape = [n_seq, n_batch, n_head]
         b_shape = [head_size, n_seq, n_batch, n_head]
@@ -202,7 +228,7 @@ class FlashAttention(BaseLayer):
         k_basetile = [head_size_tile, n_seq_tile, n_batch_tile, n_head_tile]
         v_transposed_basetile = [n_head_tile, head_size_tile, n_seq_tile, n_batch_tile]
         v_basetile = [head_size_tile, n_seq_tile, n_batch_tile, n_head_tile]
-        a_basetile = [n_seq_tile, n_seq_tile, n_batch_tile, n_head_tile]
+        a_basetile = [n_seq_kv_tile, n_seq_tile, n_batch_tile, n_head_tile]
         a_maxsumexp_basetile = [2, n_seq_tile, n_batch_tile, n_head_tile]
         a_sumprod_slice_basetile = [n_seq_tile, n_batch_tile, n_head_tile]
         b_basetile = [head_size_tile, n_seq_tile, n_batch_tile, n_head_tile]
@@ -392,18 +418,37 @@ class FlashAttention(BaseLayer):
         y_grad = type(x_q.value)(y_traits, x_q.value.distribution, next_tag)
         next_tag = y_grad.next_tag
         y = TensorMoments(y_value, y_grad, True)
+        # Allocate key and value caches if needed
+        if kv_cache_size is None:
+            k_cache = None
+            v_cache = None
+            kv_views = []
+        else:
+            k_cache, v_cache, next_tag = Attention.generate_kv_cache( \
+                    type(x_q.value), head_size, kv_cache_size, \
+                    kv_cache_size_tile, n_batch, n_batch_tile, n_head, \
+                    n_head_tile, next_tag)
+            kv_views, next_tag = Attention.generate_kv_views(k_cache, \
+                    v_cache, a.value, mask, next_tag)
         # Create attention layer with all the provided data
         layer = FlashAttention(x_q, x_k, x_v, y, w_q, w_k, w_v, w, \
                 q_transposed, \
                 q, k_transposed, k, v_transposed, v, a, a_maxsumexp, \
                 a_sumprod_slice, b, b_transposed, bias_inproj_q, \
                 bias_inproj_k, bias_inproj_v, out_proj_bias, mask, \
-                redux=redux, fp32_fast_tf32=fp32_fast_tf32)
+                redux=redux, fp32_fast_tf32=fp32_fast_tf32, k_cache=k_cache, \
+                v_cache=v_cache, kv_views=kv_views)
         # Return layer and next tag to be used
         return (layer, next_tag)
 
     # Forward propagation of the attention layer
     def forward_async(self):
+        # Scores of new tokens against the cache form a thin
+        # (kv_cache_size, n_seq) matrix, that is handled by the usual
+        # attention, as there is no square score tile to avoid
+        if self.k_cache is not None:
+            Attention.forward_async(self)
+            return
         # Compute query, key and value tensors
         # Q_transposed = einsum('jkl,lmn->jkmn', W_Q, X_Q)
         # gemm (n_head, head_size, n_emb) by (n_emb, n_seq, n_batch) into
@@ -550,8 +595,18 @@ class FlashAttention(BaseLayer):
             self.out_proj_bias.value.wont_use()
         self.y.value.wont_use()
 
+    # Key-value cache management is the same as for the usual attention
+    reset_kv_cache_async = Attention.reset_kv_cache_async
+    set_kv_cache_position = Attention.set_kv_cache_position
+    update_kv_cache_async = Attention.update_kv_cache_async
+    unregister = Attention.unregister
+    transient_temporaries = Attention.transient_temporaries
+
     # Backward propagation of the linear layer
     def backward_async(self):
+        if self.k_cache is not None:
+            raise RuntimeError("Backward is not supported in incremental " \
+                    "decoding mode")
         # Apply backward of bias if needed
         if self.out_proj_bias is not None:
             if self.out_proj_bias.grad_required:
@@ -17,8 +17,10 @@ from nntile.tensor import TensorTraits, Tensor_fp32, Tensor_fp64, Tensor, \
         fill_async, pow_async, prod_slice_async, sumprod_slice_async, \
         axpy_async, prod_fiber_async, prod_fiber3_async, add_slice3_async, \
         add_fiber_async, sum_fiber_async, sumprod_fiber_async, \
-        clear_async, copy_async, hypot_scalar_inverse_async
+        clear_async, copy_async, hypot_scalar_inverse_async, \
+        layer_norm_forward_async, layer_norm_backward_async
 from nntile.layer.base_layer import BaseLayer
+from nntile.nntile_core import starpu as core_starpu
 import numpy as np
 from typing import List
 
@@ -33,6 +35,7 @@ class LayerNorm(BaseLayer):
     inv_stddev: Tensor
     axis: int
     eps: float
+    fused: bool
 
     # Construct normalization layer with all the provided data
     def __init__(self, x: TensorMoments, y: TensorMoments, \
@@ -61,6 +64,14 @@ class LayerNorm(BaseLayer):
             self.redux = 1
         else:
             self.redux = 0
+        # Fused kernels process entire fibers along axis within a single task
+        # and accumulate gradients of gamma and beta on a single node. They
+        # are implemented only for CPU, so they are not used with CUDA
+        # workers to keep the layer on GPU.
+        distr = set(x.value.distribution) | set(gamma.value.distribution) \
+                | set(beta.value.distribution)
+        self.fused = x.value.grid.shape[axis] == 1 and len(distr) == 1 \
+                and core_starpu.cuda_worker_count() == 0
 
     # Simple generator for the normalization layer
     @staticmethod
@@ -131,6 +142,9 @@ class LayerNorm(BaseLayer):
 
     # Forward propagation of the normalization layer
     def forward_async(self):
+        if self.fused:
+            self._forward_fused_async()
+            return
         # Get means over given axis
         sum_slice_async(1.0/self.l, self.x.value, 0.0, self.mean, self.axis, \
                 redux=self.redux)
@@ -166,8 +180,28 @@ class LayerNorm(BaseLayer):
         # Y can be offloaded from GPU
         self.y.value.wont_use()
 
+    # Fused forward propagation, that reads X once instead of several passes
+    # over temporary tensors
+    def _forward_fused_async(self):
+        layer_norm_forward_async(self.eps, self.x.value, self.gamma.value, \
+                self.beta.value, self.mean, self.inv_stddev, \
+                self.tmp_y_value, self.y.value, self.axis)
+        # X, gamma, beta and mean can be offloaded from GPU
+        self.x.value.wont_use()
+        self.gamma.value.wont_use()
+        self.beta.value.wont_use()
+        self.mean.wont_use()
+        # inv_stddev and tmp_Y_value are used by the backward phase
+        self.inv_stddev.wont_use()
+        self.tmp_y_value.wont_use()
+        # Y can be offloaded from GPU
+        self.y.value.wont_use()
+
     # Backward propagation of the normalization layer
     def backward_async(self):
+        if self.fused:
+            self._backward_fused_async()
+            return
         # Accumulate gradient over beta
         sum_fiber_async(1.0, self.y.grad, 1.0, self.beta.grad, self.axis, 0,
                 redux=self.redux)
@@ -216,3 +250,19 @@ class LayerNorm(BaseLayer):
         # dX can offloade from GPU
         self.x.grad.wont_use()
 
+    # Fused backward propagation, that does not need tmp_Y_grad
+    def _backward_fused_async(self):
+        layer_norm_backward_async(self.tmp_y_value, self.y.grad, \
+                self.gamma.value, self.inv_stddev, self.x.grad, \
+                self.gamma.grad, self.beta.grad, self.axis, self.redux)
+        # dY, gamma, d_gamma and d_beta can be offloaded from GPU
+        self.y.grad.wont_use()
+        self.gamma.value.wont_use()
+        self.gamma.grad.wont_use()
+        self.beta.grad.wont_use()
+        # mean, inv_stddev and tmp_Y_value can be deleted
+        self.mean.invalidate_submit()
+        self.inv_stddev.invalidate_submit()
+        self.tmp_y_value.invalidate_submit()
+        # dX can offloade from GPU
+        self.x.grad.wont_use()
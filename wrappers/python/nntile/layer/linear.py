@@ -16,7 +16,9 @@ import nntile
 from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
         TransOp, trans, notrans, copy_async, gemm_async, randn_async, \
         add_slice_async, add_fiber_async, sum_slice_async, sum_fiber_async, \
-        gemm_ex_async
+        gemm_ex_async, Tensor_fp16, Tensor_fp32, Tensor_int8, \
+        gemm_int8_async
+from nntile.nntile_core.tensor import fp32_to_fp16_async, fp16_to_fp32_async
 from nntile.layer.base_layer import BaseLayer
 import numpy as np
 from typing import List, Union, Optional
@@ -36,6 +38,8 @@ class Linear(BaseLayer):
     y_fp16: TensorMoments
     w_fp16: TensorMoments
     b: Union[TensorMoments, None]
+    w_int8: Union[Tensor_int8, None]
+    w_scale: Union[Tensor, None]
 
     # Construct linear layer with all the provided data
     def __init__(self, side: str, trans_x: TransOp, x: TensorMoments, \
@@ -77,6 +81,8 @@ class Linear(BaseLayer):
         self.y_fp16 = y_fp16
         self.fp32_fast_tf32 = fp32_fast_tf32
         self.fp32_convert_fp16 = fp32_convert_fp16
+        self.w_int8 = None
+        self.w_scale = None
         if redux:
             self.redux = 1
         else:
@@ -159,34 +165,125 @@ class Linear(BaseLayer):
             fp32_convert_fp16 = False
         if fp32_fast_tf32:
             fp32_convert_fp16 = False
+        layer = Linear(side, trans_x, x, y, w, ndim, b, fp32_fast_tf32, \
+                redux=redux)
         if fp32_convert_fp16:
-            x_traits = TensorTraits(x.value.shape, x.value.basetile_shape)
-            x_distr = x.value.distribution
-            x_fp16_value = Tensor_fp16(x_traits, x_distr, next_tag)
-            next_tag = x_fp16_value.next_tag
-            x_fp16_grad = Tensor_fp16(x_traits, x_distr, next_tag)
-            next_tag = x_fp16_grad.next_tag
-            x_fp16 = TensorMoments(x_fp16_value, x_fp16_grad, True)
-            w_fp16_value = Tensor_fp16(w_traits, w_distr, next_tag)
-            next_tag = w_fp16_value.next_tag
-            w_fp16_grad = Tensor_fp16(w_traits, w_distr, next_tag)
-            next_tag = w_fp16_grad.next_tag
-            w_fp16 = TensorMoments(w_fp16_value, w_fp16_grad, True)
-            y_fp16_value = Tensor_fp16(y_traits, y_distr, next_tag)
-            next_tag = y_fp16_value.next_tag
-            y_fp16_grad = Tensor_fp16(y_traits, y_distr, next_tag)
-            next_tag = y_fp16_grad.next_tag
-            y_fp16 = TensorMoments(y_fp16_value, y_fp16_grad, True)
-            layer = Linear(side, trans_x, x, y, w, ndim, b, fp32_fast_tf32, \
-                    fp32_convert_fp16, x_fp16, w_fp16, y_fp16)
-        else:
-            layer = Linear(side, trans_x, x, y, w, ndim, b, fp32_fast_tf32, \
-                    redux=redux)
+            next_tag = layer.enable_amp(next_tag)
         # Return layer and next tag to be used
         return (layer, next_tag)
 
+    # Run GEMMs in half precision, while X, Y and W stay in single precision
+    def enable_amp(self, next_tag: int) -> int:
+        if type(self.x.value) is not nntile.tensor.Tensor_fp32 \
+                or self.fp32_convert_fp16:
+            return next_tag
+        x_traits = TensorTraits(self.x.value.shape, \
+                self.x.value.basetile_shape)
+        x_distr = self.x.value.distribution
+        x_fp16_value = Tensor_fp16(x_traits, x_distr, next_tag)
+        next_tag = x_fp16_value.next_tag
+        x_fp16_grad = Tensor_fp16(x_traits, x_distr, next_tag)
+        next_tag = x_fp16_grad.next_tag
+        self.x_fp16 = TensorMoments(x_fp16_value, x_fp16_grad, True)
+        w_traits = TensorTraits(self.w.value.shape, \
+                self.w.value.basetile_shape)
+        w_distr = self.w.value.distribution
+        w_fp16_value = Tensor_fp16(w_traits, w_distr, next_tag)
+        next_tag = w_fp16_value.next_tag
+        w_fp16_grad = Tensor_fp16(w_traits, w_distr, next_tag)
+        next_tag = w_fp16_grad.next_tag
+        self.w_fp16 = TensorMoments(w_fp16_value, w_fp16_grad, True)
+        y_traits = TensorTraits(self.y.value.shape, \
+                self.y.value.basetile_shape)
+        y_distr = self.y.value.distribution
+        y_fp16_value = Tensor_fp16(y_traits, y_distr, next_tag)
+        next_tag = y_fp16_value.next_tag
+        y_fp16_grad = Tensor_fp16(y_traits, y_distr, next_tag)
+        next_tag = y_fp16_grad.next_tag
+        self.y_fp16 = TensorMoments(y_fp16_value, y_fp16_grad, True)
+        self.temporaries = [self.x_fp16, self.w_fp16, self.y_fp16]
+        self.fp32_fast_tf32 = False
+        self.fp32_convert_fp16 = True
+        return next_tag
+
+    # Quantize weights into int8 with a scale per output feature for CPU
+    # inference. Inputs are quantized dynamically by every forward pass, while
+    # backward pass is no longer available. Current values of W are used, so
+    # they must be loaded before this call.
+    def quantize(self, next_tag: int) -> int:
+        if type(self.w.value) is not Tensor_fp32 or self.w_int8 is not None:
+            return next_tag
+        if self.trans_x != notrans:
+            raise NotImplementedError("Only trans_x=notrans can be quantized")
+        w_shape = self.w.value.shape
+        w_tile = self.w.value.basetile_shape
+        w_value = np.zeros(w_shape, dtype=np.float32, order='F')
+        self.w.value.to_array(w_value)
+        # Quantized weights are stored as [in..., out...], so that every
+        # output feature is contiguous
+        ndim = self.ndim
+        if self.side == 'L':
+            in_shape, out_shape = w_shape[:ndim], w_shape[ndim:]
+            in_tile, out_tile = w_tile[:ndim], w_tile[ndim:]
+        else:
+            in_shape, out_shape = w_shape[-ndim:], w_shape[:-ndim]
+            in_tile, out_tile = w_tile[-ndim:], w_tile[:-ndim]
+        k, m = int(np.prod(in_shape)), int(np.prod(out_shape))
+        if self.side == 'L':
+            w_mat = w_value.reshape((k, m), order='F')
+        else:
+            w_mat = w_value.reshape((m, k), order='F').T
+        scale = np.abs(w_mat).max(axis=0) / np.float32(127)
+        inv_scale = np.divide(1, scale, out=np.zeros_like(scale), \
+                where=(scale > 0))
+        w_q = np.rint(w_mat * inv_scale).astype(np.int8)
+        w_q = w_q.reshape(in_shape+out_shape, order='F')
+        scale = scale.reshape(out_shape, order='F')
+        # Create int8 weights and scales
+        w_int8_traits = TensorTraits(in_shape+out_shape, in_tile+out_tile)
+        # TODO change distribution
+        w_int8_distr = [0] * w_int8_traits.grid.nelems
+        self.w_int8 = Tensor_int8(w_int8_traits, w_int8_distr, next_tag)
+        next_tag = self.w_int8.next_tag
+        self.w_int8.from_array(np.asfortranarray(w_q))
+        w_scale_traits = TensorTraits(out_shape, out_tile)
+        w_scale_distr = [0] * w_scale_traits.grid.nelems
+        self.w_scale = Tensor_fp32(w_scale_traits, w_scale_distr, next_tag)
+        next_tag = self.w_scale.next_tag
+        self.w_scale.from_array(np.asfortranarray(scale))
+        self.fp32_fast_tf32 = False
+        self.fp32_convert_fp16 = False
+        return next_tag
+
+    # Unregister all tensors of the layer including int8 weights
+    def unregister(self):
+        super().unregister()
+        if self.w_int8 is not None:
+            self.w_int8.unregister()
+            self.w_scale.unregister()
+
     # Forward propagation of the linear layer
     def forward_async(self):
+        # Multiply by int8 weights if the layer is quantized
+        if self.w_int8 is not None:
+            if self.side == 'L':
+                # Y = einsum('ij,jk->ik', X, W)
+                gemm_int8_async(1.0, trans, self.w_int8, self.w_scale, \
+                        self.x.value, 0.0, self.y.value, self.ndim)
+                if self.b is not None:
+                    add_fiber_async(1.0, self.b.value, 1.0, self.y.value,
+                            self.y.value.ndim-1, 0)
+            else:
+                # Y = einsum('ij,jk->ik', W, X)
+                gemm_int8_async(1.0, notrans, self.w_int8, self.w_scale, \
+                        self.x.value, 0.0, self.y.value, self.ndim)
+                if self.b is not None:
+                    add_fiber_async(1.0, self.b.value, 1.0, self.y.value, 0, 0)
+            self.x.value.wont_use()
+            self.y.value.wont_use()
+            if self.b is not None:
+                self.b.value.wont_use()
+            return
         # Convert fp32 to fp16 if needed
         if self.fp32_convert_fp16:
             fp32_to_fp16_async(self.x.value, self.x_fp16.value)
@@ -249,6 +346,8 @@ class Linear(BaseLayer):
 
     # Backward propagation of the linear layer
     def backward_async(self):
+        if self.w_int8 is not None:
+            raise NotImplementedError("Quantized layer is for inference only")
         # Convert fp32 to fp16 if needed
         if self.fp32_convert_fp16:
             fp32_to_fp16_async(self.y.grad, self.y_fp16.grad)
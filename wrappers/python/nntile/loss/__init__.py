@@ -14,3 +14,4 @@
 
 from .frob import Frob
 from .crossentropy import CrossEntropy
+from .linear_crossentropy import LinearCrossEntropy
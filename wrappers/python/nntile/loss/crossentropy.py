@@ -14,9 +14,11 @@
 
 from nntile.tensor import softmax_async, clear_async, copy_async, \
         subtract_indexed_outputs_async, logsumexp_async, maxsumexp_async, \
-        total_sum_accum_async, scal_inplace_async
+        total_sum_accum_async, scal_inplace_async, \
+        cross_entropy_fwd_bwd_async, sum_slice_async
 from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
         Tensor_int64
+from nntile.nntile_core import starpu as core_starpu
 import numpy as np
 
 class CrossEntropy:
@@ -25,14 +27,20 @@ class CrossEntropy:
     val: Tensor
     tmp: Tensor
     maxsumexp: Tensor
+    val_nodes: TensorOrNone
 
     # Constructor of loss with all the provided data
     def __init__(self, model_output: TensorMoments, labels: Tensor_int64, \
             val: Tensor, maxsumexp: Tensor, logsumexp: Tensor, \
-            redux: bool=False, scale: float=1.0):
+            redux: bool=False, scale: float=1.0, \
+            val_nodes: TensorOrNone=None):
         self.model_output = model_output
         self.val = val
         self.val.set_reduction_add()
+        # Partial loss values of nodes, if gradient is distributed
+        self.val_nodes = val_nodes
+        if val_nodes is not None:
+            self.val_nodes.set_reduction_add()
         self.logsumexp = logsumexp
         self.maxsumexp = maxsumexp
         self.maxsumexp.set_reduction_maxsumexp()
@@ -42,6 +50,8 @@ class CrossEntropy:
         else:
             self.redux = 0
         self.scale = scale
+        # Additional factor for gradient only, used by dynamic loss scaling
+        self.loss_scale = 1.0
 
     # Simple generator
     @staticmethod
@@ -63,8 +73,15 @@ class CrossEntropy:
         logsumexp = type(model_output.value)(labels_traits, \
                 model_output.value.distribution, next_tag)
         next_tag = logsumexp.next_tag
+        # Gradient tiles of other nodes accumulate loss into a tile per node
+        val_nodes = None
+        if set(model_output.value.distribution) != {0}:
+            mpi_size = core_starpu.mpi_size()
+            val_nodes = type(model_output.value)(TensorTraits([mpi_size], \
+                    [1]), list(range(mpi_size)), next_tag)
+            next_tag = val_nodes.next_tag
         loss = CrossEntropy(model_output, labels, val, maxsumexp, logsumexp, \
-                redux=redux, scale=scale)
+                redux=redux, scale=scale, val_nodes=val_nodes)
         return loss, next_tag
     
     def unregister(self):
@@ -72,6 +89,8 @@ class CrossEntropy:
         self.maxsumexp.unregister()
         self.val.unregister()
         self.y.unregister()
+        if self.val_nodes is not None:
+            self.val_nodes.unregister()
 
     def get_val(self, val_np):
         self.val.to_array(val_np)
@@ -84,14 +103,27 @@ class CrossEntropy:
         clear_async(self.maxsumexp)
         maxsumexp_async(self.model_output.value, self.maxsumexp, 0, \
                 redux=self.redux)
-        logsumexp_async(self.maxsumexp, self.logsumexp)
-        total_sum_accum_async(self.scale, self.logsumexp, \
-                self.model_output.value, self.y, self.val)
         if self.model_output.grad_required is True:
-            softmax_async(self.maxsumexp, self.model_output.value, \
-                    self.scale, self.model_output.grad, 0)
-            subtract_indexed_outputs_async(self.scale, self.y, \
-                    self.model_output.grad)
+            # Loss value and gradient within a single pass over logits
+            grad_scale = self.scale * self.loss_scale
+            if self.val_nodes is None:
+                cross_entropy_fwd_bwd_async(self.scale, grad_scale, \
+                        self.maxsumexp, self.model_output.value, self.y, \
+                        self.model_output.grad, self.val, redux=self.redux)
+            else:
+                # Tiles of gradient are written on their nodes, that
+                # accumulate partial loss values, summed up afterwards
+                clear_async(self.val_nodes)
+                cross_entropy_fwd_bwd_async(self.scale, grad_scale, \
+                        self.maxsumexp, self.model_output.value, self.y, \
+                        self.model_output.grad, self.val_nodes, \
+                        redux=self.redux)
+                sum_slice_async(1.0, self.val_nodes, 1.0, self.val, 0)
+                self.val_nodes.wont_use()
+        else:
+            logsumexp_async(self.maxsumexp, self.logsumexp)
+            total_sum_accum_async(self.scale, self.logsumexp, \
+                    self.model_output.value, self.y, self.val)
         self.model_output.value.wont_use()
         self.model_output.grad.wont_use()
         self.maxsumexp.wont_use()
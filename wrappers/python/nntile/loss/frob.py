@@ -12,7 +12,8 @@
 # @date 2023-07-02
 
 from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
-        copy_async, axpy_async, nrm2_async, prod_async, scal_inplace_async
+        copy_async, axpy_async, nrm2_async, prod_async, scal_inplace_async, \
+        add_async
 import numpy as np
 
 class Frob:
@@ -29,6 +30,8 @@ class Frob:
         self.val_sqrt = val_sqrt
         self.val = val
         self.tmp = tmp
+        # Additional factor for gradient only, used by dynamic loss scaling
+        self.loss_scale = 1.0
 
     def unregister(self):
         self.y.unregister()
@@ -57,13 +60,17 @@ class Frob:
     # Get value and gradient if needed
     def calc_async(self):
         # Put X into gradient grad X
-        copy_async(self.x.value, self.x.grad)
+        if self.loss_scale == 1.0:
+            copy_async(self.x.value, self.x.grad)
+        else:
+            add_async(self.loss_scale, self.x.value, 0.0, self.x.grad)
         # Define gradient dX as X-Y
-        axpy_async(-1, self.y, self.x.grad)
+        axpy_async(-self.loss_scale, self.y, self.x.grad)
         # Values Y are not needed anymore
         #self.y.invalidate_submit()
         # Get value ||grad X||
-        nrm2_async(1.0, self.x.grad, 0.0, self.val_sqrt, self.tmp)
+        nrm2_async(1.0/self.loss_scale, self.x.grad, 0.0, self.val_sqrt, \
+                self.tmp)
         # Ignore temporary values
         #self.tmp.invalidate_submit()
         # Invalidate gradient if it is unnecessary
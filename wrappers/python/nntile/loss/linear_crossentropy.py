@@ -0,0 +1,226 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/loss/linear_crossentropy.py
+# Crossentropy loss fused with the preceding linear layer, that never
+# materializes all the logits
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2023-12-21
+
+from nntile.tensor import clear_async, gemm_async, gemm_ex_async, \
+        maxsumexp_async, cross_entropy_fwd_bwd_async, notrans, trans
+from nntile.tensor import TensorTraits, Tensor, TensorMoments, Tensor_int64
+import nntile
+from typing import List, Optional
+
+class LinearCrossEntropy:
+    x: TensorMoments
+    w: TensorMoments
+    y: Tensor_int64 # labels
+    val: Tensor
+    maxsumexp: Tensor
+    w_chunks: List[TensorMoments]
+    logits: List[TensorMoments]
+    logits_tail: Optional[TensorMoments]
+
+    # Constructor of loss with all the provided data. Logits W @ X are split
+    # into chunks of vocab_tile classes, where vocab_tile is the tile size of
+    # W along its first axis. Chunk c of W is w_chunks[c], that shares tiles
+    # with W. Logits of a chunk and their gradient are stored in one of the
+    # buffers, that are reused by the chunks in a round-robin manner, while
+    # the last chunk may use its own smaller buffer.
+    def __init__(self, x: TensorMoments, w: TensorMoments, \
+            labels: Tensor_int64, val: Tensor, maxsumexp: Tensor, \
+            w_chunks: List[TensorMoments], logits: List[TensorMoments], \
+            logits_tail: Optional[TensorMoments]=None, redux: bool=False, \
+            scale: float=1.0, fp32_fast_tf32: bool=False):
+        self.x = x
+        self.w = w
+        self.y = labels
+        self.val = val
+        self.val.set_reduction_add()
+        self.maxsumexp = maxsumexp
+        self.maxsumexp.set_reduction_maxsumexp()
+        self.w_chunks = w_chunks
+        self.logits = logits
+        self.logits_tail = logits_tail
+        self.vocab_tile = w.value.basetile_shape[0]
+        if redux:
+            self.redux = 1
+        else:
+            self.redux = 0
+        self.scale = scale
+        if type(x.value) is not nntile.tensor.Tensor_fp32:
+            fp32_fast_tf32 = False
+        self.fp32_fast_tf32 = fp32_fast_tf32
+        # Additional factor for gradient only, used by dynamic loss scaling
+        self.loss_scale = 1.0
+
+    # Simple generator. Input x is of shape [embed, ...] and weight w is of
+    # shape [vocab, embed], which is a weight of Linear layer with side='R',
+    # trans_x=notrans and in_features_ndim=1. Peak memory for logits is
+    # O(nbuffers * vocab_tile * x.nelems / embed) instead of
+    # O(vocab * x.nelems / embed).
+    @staticmethod
+    def generate_simple(x: TensorMoments, w: TensorMoments, next_tag: int, \
+            nbuffers: int=2, redux: bool=False, scale: float=1.0, \
+            fp32_fast_tf32: bool=False) -> tuple:
+        if w.value.ndim != 2 or w.value.shape[1] != x.value.shape[0] \
+                or w.value.basetile_shape[1] != x.value.basetile_shape[0]:
+            raise ValueError("Weight shall be of shape [vocab, embed], " \
+                    "tiled as input along embed")
+        if nbuffers <= 0:
+            raise ValueError("nbuffers must be positive integer")
+        shape = x.value.shape[1:]
+        basetile = x.value.basetile_shape[1:]
+        labels_traits = TensorTraits(shape, basetile)
+        labels_distr = [0] * labels_traits.grid.nelems
+        labels = Tensor_int64(labels_traits, labels_distr, next_tag)
+        next_tag = labels.next_tag
+        maxsumexp_traits = TensorTraits([2]+shape, [2]+basetile)
+        maxsumexp = type(x.value)(maxsumexp_traits, labels_distr, next_tag)
+        next_tag = maxsumexp.next_tag
+        val_traits = TensorTraits([], [])
+        val = type(x.value)(val_traits, [0], next_tag)
+        next_tag = val.next_tag
+        # Chunks of W share tiles with W
+        vocab, embed = w.value.shape
+        vocab_tile, embed_tile = w.value.basetile_shape
+        nchunks, embed_ntiles = w.value.grid.shape
+        w_value_handles = w.value.get_tile_handles()
+        if w.grad is not None:
+            w_grad_handles = w.grad.get_tile_handles()
+        w_chunks = []
+        for c in range(nchunks):
+            chunk_size = min(vocab_tile, vocab-c*vocab_tile)
+            chunk_traits = TensorTraits([chunk_size, embed], \
+                    [vocab_tile, embed_tile])
+            # Tiles of W are stored in Fortran order
+            tiles = [c+nchunks*j for j in range(embed_ntiles)]
+            chunk_distr = [w.value.distribution[i] for i in tiles]
+            chunk_value = type(w.value)(chunk_traits, chunk_distr, next_tag)
+            next_tag = chunk_value.next_tag
+            chunk_value.alias_tiles([w_value_handles[i] for i in tiles])
+            if w.grad is not None:
+                chunk_grad = type(w.grad)(chunk_traits, chunk_distr, \
+                        next_tag)
+                next_tag = chunk_grad.next_tag
+                chunk_grad.set_reduction_add()
+                chunk_grad.alias_tiles([w_grad_handles[i] for i in tiles])
+            else:
+                chunk_grad = None
+            w_chunks.append(TensorMoments(chunk_value, chunk_grad, \
+                    w.grad_required))
+        # Buffers for logits of a chunk and their gradient
+        logits = []
+        for i in range(min(nbuffers, vocab//vocab_tile)):
+            logits_traits = TensorTraits([vocab_tile]+shape, \
+                    [vocab_tile]+basetile)
+            logits_distr = [0] * logits_traits.grid.nelems
+            logits_value = type(x.value)(logits_traits, logits_distr, \
+                    next_tag)
+            next_tag = logits_value.next_tag
+            logits_grad = type(x.value)(logits_traits, logits_distr, \
+                    next_tag)
+            next_tag = logits_grad.next_tag
+            logits.append(TensorMoments(logits_value, logits_grad, True))
+        if vocab % vocab_tile != 0:
+            logits_traits = TensorTraits([vocab%vocab_tile]+shape, \
+                    [vocab_tile]+basetile)
+            logits_distr = [0] * logits_traits.grid.nelems
+            logits_value = type(x.value)(logits_traits, logits_distr, \
+                    next_tag)
+            next_tag = logits_value.next_tag
+            logits_grad = type(x.value)(logits_traits, logits_distr, \
+                    next_tag)
+            next_tag = logits_grad.next_tag
+            logits_tail = TensorMoments(logits_value, logits_grad, True)
+        else:
+            logits_tail = None
+        loss = LinearCrossEntropy(x, w, labels, val, maxsumexp, w_chunks, \
+                logits, logits_tail, redux=redux, scale=scale, \
+                fp32_fast_tf32=fp32_fast_tf32)
+        return loss, next_tag
+
+    def unregister(self):
+        # Tiles of W stay registered, as W owns them as well
+        for w_chunk in self.w_chunks:
+            w_chunk.unregister()
+        for logits in self.logits:
+            logits.unregister()
+        if self.logits_tail is not None:
+            self.logits_tail.unregister()
+        self.maxsumexp.unregister()
+        self.val.unregister()
+        self.y.unregister()
+
+    def get_val(self, val_np):
+        self.val.to_array(val_np)
+
+    def get_grad(self, grad_np):
+        self.x.grad.to_array(grad_np)
+
+    # Buffer for logits of a given chunk
+    def _chunk_logits(self, c: int) -> TensorMoments:
+        if c*self.vocab_tile+self.vocab_tile > self.w.value.shape[0]:
+            return self.logits_tail
+        return self.logits[c % len(self.logits)]
+
+    def _gemm_async(self, alpha: float, trans_A, A: Tensor, trans_B, \
+            B: Tensor, beta: float, C: Tensor, ndim: int):
+        if self.fp32_fast_tf32:
+            gemm_ex_async(alpha, trans_A, A, trans_B, B, beta, C, ndim, 0, \
+                    redux=self.redux)
+        else:
+            gemm_async(alpha, trans_A, A, trans_B, B, beta, C, ndim, 0, \
+                    redux=self.redux)
+
+    # Get value and gradient if needed. Exact gradient of a chunk requires
+    # log-sum-exp over all classes, so the first pass over chunks only
+    # accumulates maximums and sums of exponents, while the second pass
+    # recomputes logits of a chunk, gets loss value and gradient over logits
+    # with a single fused kernel and immediately adds its contribution to
+    # gradients over X and W. Logits of a chunk are dropped right after use.
+    # Gradients over X and W are accumulated, so they shall be cleared by the
+    # caller, as if they were accumulated by the backward of Linear layer.
+    def calc_async(self):
+        clear_async(self.maxsumexp)
+        for c, w_chunk in enumerate(self.w_chunks):
+            logits = self._chunk_logits(c)
+            self._gemm_async(1.0, notrans, w_chunk.value, notrans, \
+                    self.x.value, 0.0, logits.value, 1)
+            maxsumexp_async(logits.value, self.maxsumexp, 0, \
+                    redux=self.redux)
+            logits.value.discard_submit()
+        grad_scale = self.scale * self.loss_scale
+        for c, w_chunk in enumerate(self.w_chunks):
+            logits = self._chunk_logits(c)
+            self._gemm_async(1.0, notrans, w_chunk.value, notrans, \
+                    self.x.value, 0.0, logits.value, 1)
+            cross_entropy_fwd_bwd_async(self.scale, grad_scale, \
+                    self.maxsumexp, logits.value, self.y, logits.grad, \
+                    self.val, redux=self.redux, start=c*self.vocab_tile)
+            logits.value.discard_submit()
+            # dX += einsum('ij,ik->jk', W, dY)
+            if self.x.grad_required:
+                self._gemm_async(1.0, trans, w_chunk.value, notrans, \
+                        logits.grad, 1.0, self.x.grad, 1)
+            # dW += einsum('ik,jk->ij', dY, X)
+            if w_chunk.grad_required:
+                self._gemm_async(1.0, notrans, logits.grad, trans, \
+                        self.x.value, 1.0, w_chunk.grad, \
+                        self.x.value.ndim-1)
+                w_chunk.grad.wont_use()
+            logits.grad.discard_submit()
+            w_chunk.value.wont_use()
+        self.x.value.wont_use()
+        if self.x.grad is not None:
+            self.x.grad.wont_use()
+        self.maxsumexp.wont_use()
+        self.val.wont_use()
+        self.y.wont_use()
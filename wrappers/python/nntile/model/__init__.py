@@ -17,3 +17,4 @@ from .deep_relu import DeepReLU
 from .deep_relu_mp import DeepReLU_mp
 from .gpt2 import GPT2Config, GPT2Model
 from .mlp_mixer import MlpMixer
+from .memory_planner import MemoryPlan
@@ -12,10 +12,15 @@
 # @date 2023-09-20
 
 from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
-        clear_async
+        RowSparseTensorMoments, clear_async, clear_rows_async, save_async, \
+        load_async, save_checkpoint_state
+from nntile.nntile_core import starpu as core_starpu
 from nntile.layer.base_layer import BaseLayer
+from nntile.model.memory_planner import MemoryPlan
 import numpy as np
-from typing import List
+from typing import List, Optional
+import json
+import os
 
 class BaseModel:
     activations: List[TensorMoments]
@@ -30,6 +35,12 @@ class BaseModel:
         self.parameters = []
         for l in layers:
             self.parameters.extend(l.parameters)
+        # Activation checkpointing is disabled by default
+        self.checkpoint_segments = None
+        self.checkpoint_dropped = []
+        self.checkpoint_dropped_ids = set()
+        # Storage of activations and temporaries is not shared by default
+        self.memory_plan = None
 
     # Add a new layer with corresponding new activations
     def append(self, layer: BaseLayer):
@@ -37,15 +48,160 @@ class BaseModel:
         self.layers.append(layer)
         self.parameters.append(layer.parameters)
 
+    # Switch model into automatic mixed precision mode. Parameters stay in
+    # single precision as master weights, while layers run their GEMMs in half
+    # precision. Gradients shall be scaled to avoid underflow, see
+    # nntile.amp.GradScaler. Only Linear layers have half-precision paths so
+    # far, while Attention and FlashAttention keep their Q, K, V and output
+    # projections in their own precision.
+    def enable_amp(self, next_tag: int) -> int:
+        for l in self.layers:
+            next_tag = l.enable_amp(next_tag)
+        return next_tag
+
+    # Switch model into int8 inference mode
+    def quantize(self, next_tag: int) -> int:
+        for l in self.layers:
+            next_tag = l.quantize(next_tag)
+        return next_tag
+
+    # Enable activation checkpointing. Layers are split into contiguous
+    # segments and only activations, that are passed between segments, are
+    # kept after forward pass. All other activations and temporaries of a
+    # segment are dropped and recomputed by its forward pass right before its
+    # backward pass. With default sqrt(len(layers)) segments peak memory for
+    # activations is O(sqrt(len(layers))). Dropped activations, except the
+    # ones of the last segment, are not available after forward pass.
+    def enable_checkpointing(self, num_segments: Optional[int] = None):
+        if self.memory_plan is not None:
+            raise ValueError("Activation checkpointing is not supported " \
+                    "with memory planning")
+        nlayers = len(self.layers)
+        if num_segments is None:
+            num_segments = int(np.ceil(np.sqrt(nlayers)))
+        if num_segments <= 0 or num_segments > nlayers:
+            raise ValueError("num_segments must be in range [1, nlayers]")
+        bounds = [(i*nlayers) // num_segments for i in range(num_segments+1)]
+        self.checkpoint_segments = list(zip(bounds[:-1], bounds[1:]))
+        # Find segments, that produce and consume each activation
+        producer = {}
+        consumer = {}
+        for i_seg, (begin, end) in enumerate(self.checkpoint_segments):
+            for l in self.layers[begin:end]:
+                for t in l.activations_output:
+                    producer[id(t)] = i_seg
+                for t in l.activations_input:
+                    consumer[id(t)] = i_seg
+        # Drop activations, that are used only within a segment, that
+        # produced them. Inputs and outputs of the model are always kept.
+        self.checkpoint_dropped = [[] for _ in self.checkpoint_segments]
+        self.checkpoint_dropped_ids = set()
+        for t in self.activations:
+            i_seg = producer.get(id(t))
+            if i_seg is None or consumer.get(id(t)) != i_seg:
+                continue
+            if id(t) in self.checkpoint_dropped_ids:
+                continue
+            self.checkpoint_dropped[i_seg].append(t)
+            self.checkpoint_dropped_ids.add(id(t))
+
+    # Disable activation checkpointing
+    def disable_checkpointing(self):
+        self.checkpoint_segments = None
+        self.checkpoint_dropped = []
+        self.checkpoint_dropped_ids = set()
+
+    # Drop activations and temporaries of a segment
+    def _discard_segment_submit(self, i_seg: int, grad: bool):
+        begin, end = self.checkpoint_segments[i_seg]
+        for t in self.checkpoint_dropped[i_seg]:
+            t.value.discard_submit()
+            if grad and t.grad is not None:
+                t.grad.discard_submit()
+        for l in self.layers[begin:end]:
+            l.discard_temporaries_submit()
+
+    # Share storage of activations and temporaries, whose live intervals do
+    # not overlap, see MemoryPlan. Intermediate activations and temporaries
+    # are not available after the last forward or backward pass, that uses
+    # them. Backward pass is not supported with training=False.
+    def plan_memory(self, next_tag: int, training: bool=True) -> int:
+        if self.checkpoint_segments is not None:
+            raise ValueError("Memory planning is not supported with " \
+                    "activation checkpointing")
+        if self.memory_plan is not None:
+            raise ValueError("Memory is already planned")
+        self.memory_plan = MemoryPlan(self, training)
+        return self.memory_plan.apply(next_tag)
+
+    # Name of a layer in traces of tasks
+    def layer_name(self, i: int) -> str:
+        return "{}_{}".format(type(self.layers[i]).__name__, i)
+
+    # Forward propagation of a single layer, traced as forward/<layer name>
+    def _forward_layer_async(self, i: int):
+        if not core_starpu.trace_active():
+            self.layers[i].forward_async()
+            return
+        core_starpu.trace_push_scope("forward")
+        core_starpu.trace_push_scope(self.layer_name(i))
+        self.layers[i].forward_async()
+        core_starpu.trace_pop_scope()
+        core_starpu.trace_pop_scope()
+
+    # Backward propagation of a single layer, traced as backward/<layer name>
+    def _backward_layer_async(self, i: int):
+        if not core_starpu.trace_active():
+            self.layers[i].backward_async()
+            return
+        core_starpu.trace_push_scope("backward")
+        core_starpu.trace_push_scope(self.layer_name(i))
+        self.layers[i].backward_async()
+        core_starpu.trace_pop_scope()
+        core_starpu.trace_pop_scope()
+
     # Forward propagation
     def forward_async(self):
-        for l in self.layers:
-            l.forward_async()
+        if self.checkpoint_segments is None:
+            for i in range(len(self.layers)):
+                self._forward_layer_async(i)
+            return
+        # The last segment is not dropped, as backward pass starts with it
+        last_seg = len(self.checkpoint_segments) - 1
+        for i_seg, (begin, end) in enumerate(self.checkpoint_segments):
+            for i in range(begin, end):
+                self._forward_layer_async(i)
+            if i_seg != last_seg:
+                self._discard_segment_submit(i_seg, False)
 
     # Backward propagation
     def backward_async(self):
-        for l in reversed(self.layers):
-            l.backward_async()
+        if self.memory_plan is not None:
+            if not self.memory_plan.training:
+                raise RuntimeError("Memory is planned for inference only")
+            for i in reversed(range(len(self.layers))):
+                self.memory_plan.clear_grads_async(i)
+                self._backward_layer_async(i)
+            return
+        if self.checkpoint_segments is None:
+            for i in reversed(range(len(self.layers))):
+                self._backward_layer_async(i)
+            return
+        last_seg = len(self.checkpoint_segments) - 1
+        for i_seg in reversed(range(last_seg+1)):
+            begin, end = self.checkpoint_segments[i_seg]
+            # Recompute dropped activations and temporaries
+            if i_seg != last_seg:
+                for i in range(begin, end):
+                    self._forward_layer_async(i)
+            # Gradients of dropped activations are skipped by
+            # clear_activations_grads() to avoid allocating them all at once
+            for t in self.checkpoint_dropped[i_seg]:
+                if t.grad is not None and t.grad_required:
+                    clear_async(t.grad)
+            for i in reversed(range(begin, end)):
+                self._backward_layer_async(i)
+            self._discard_segment_submit(i_seg, True)
 
     # Clear all gradients (parameters and inter-layer activations)
     def clear_gradients(self):
@@ -56,12 +212,26 @@ class BaseModel:
     def clear_parameters_grads(self):
         for t in self.parameters:
             if t.grad is not None and t.grad_required:
-                clear_async(t.grad)
+                # Row-sparse gradient is zero outside of marked rows
+                if type(t) is RowSparseTensorMoments:
+                    clear_rows_async(t.rows, t.grad)
+                    clear_async(t.rows)
+                else:
+                    clear_async(t.grad)
+
+    # Check if gradient is cleared by backward pass itself, as it is dropped
+    # by checkpointing or shares storage due to memory planning
+    def grad_cleared_by_backward(self, t: TensorMoments) -> bool:
+        if id(t) in self.checkpoint_dropped_ids:
+            return True
+        return self.memory_plan is not None \
+                and id(t.grad) in self.memory_plan.cleared_grads
 
     # Clear gradients of inter-layer activations
     def clear_activations_grads(self):
         for t in self.activations:
-            if t.grad is not None and t.grad_required:
+            if t.grad is not None and t.grad_required \
+                    and not self.grad_cleared_by_backward(t):
                 clear_async(t.grad)
 
     # Unregister all tensors related to this model
@@ -70,7 +240,29 @@ class BaseModel:
             l.unregister()
         for x in self.activations:
             x.unregister()
+        if self.memory_plan is not None:
+            self.memory_plan.unregister()
 
     def get_parameters(self):
         return self.parameters
 
+    # Save parameters into a directory of tile-aligned checkpoint files, that
+    # are written by StarPU tasks. The state file is written after all of
+    # them are finished and marks the checkpoint as complete.
+    def save_checkpoint(self, path):
+        os.makedirs(path, exist_ok=True)
+        for i, p in enumerate(self.parameters):
+            save_async(p.value, os.path.join(path, \
+                    "parameter_{}.nntile".format(i)))
+        save_checkpoint_state(path, {"num_parameters": len(self.parameters)})
+
+    # Load parameters from a directory of tile-aligned checkpoint files
+    def load_checkpoint(self, path):
+        with open(os.path.join(path, "state.json"), "r") as fp:
+            stored_state = json.load(fp)
+        if stored_state["num_parameters"] != len(self.parameters):
+            raise ValueError("Checkpoint has a different number of "
+                    "parameters")
+        for i, p in enumerate(self.parameters):
+            load_async(p.value, os.path.join(path, \
+                    "parameter_{}.nntile".format(i)))
@@ -16,8 +16,6 @@ from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
 from nntile.model.base_model import BaseModel
 from nntile.layer.linear import Linear
 from nntile.layer.act import Act
-from nntile.layer.fp32_to_fp16 import FP32_to_FP16
-from nntile.layer.fp16_to_fp32 import FP16_to_FP32
 import numpy as np
 from typing import List
 
@@ -37,23 +35,15 @@ class DeepReLU_mp(BaseModel):
         # Check parameter ndim
         if ndim <= 0:
             raise ValueError("ndim must be positive integer")
-        self.fp32_fast_tf32 = fp32_fast_tf32
         # Init activations and list of layers
         activations = [x]
         layers = []
         # Initial linear layer that converts input to internal shape
-        # new_layer, next_tag = FP32_to_FP16.generate_simple(x, next_tag)
-        # layers.append(new_layer)
-        # activations.extend(new_layer.activations_output)
         new_layer, next_tag = Linear.generate_simple(activations[-1], side, \
-                notrans, ndim, [add_shape], [add_basetile_shape], next_tag,
-                fp32_fast_tf32=fp32_fast_tf32)
+                notrans, ndim, [add_shape], [add_basetile_shape], next_tag)
         print("Layer 0 shape", new_layer.w.value.shape, new_layer.y.value.shape)
         layers.append(new_layer)
         activations.extend(new_layer.activations_output)
-        # new_layer, next_tag = FP16_to_FP32.generate_simple(activations[-1], next_tag)
-        # layers.append(new_layer)
-        # activations.extend(new_layer.activations_output)
         new_layer, next_tag = Act.generate_simple(activations[-1], "relu",
                                                   next_tag)
         layers.append(new_layer)
@@ -62,7 +52,7 @@ class DeepReLU_mp(BaseModel):
         for i in range(1, nlayers-1):
             new_layer, next_tag = Linear.generate_simple( \
                     activations[-1], side, notrans, 1, [add_shape], \
-                    [add_basetile_shape], next_tag, fp32_fast_tf32=fp32_fast_tf32)
+                    [add_basetile_shape], next_tag)
             print("Layer {} shape".format(i), new_layer.w.value.shape, new_layer.y.value.shape)
             layers.append(new_layer)
             activations.extend(new_layer.activations_output)
@@ -79,13 +69,15 @@ class DeepReLU_mp(BaseModel):
         #     new_base = x.value.basetile_shape[:ndim]
 
         new_layer, next_tag = Linear.generate_simple(activations[-1], \
-                side, notrans, 1, [n_classes], [n_classes], next_tag, fp32_fast_tf32=fp32_fast_tf32)
+                side, notrans, 1, [n_classes], [n_classes], next_tag)
         print("Last layer shape", new_layer.w.value.shape, new_layer.y.value.shape)
         layers.append(new_layer)
         activations.extend(new_layer.activations_output)
-        self.next_tag = next_tag
         # Fill Base Model with the generated data
         super().__init__(activations, layers)
+        # Linear layers keep single precision weights and activations, but
+        # perform GEMMs in half precision
+        self.next_tag = self.enable_amp(next_tag)
 
     # Randomly init all linear layers
     def init_randn_async(self):
@@ -120,7 +112,7 @@ class DeepReLU_mp(BaseModel):
         x_grad_required = False
         x_moments = TensorMoments(x, x_grad, x_grad_required)
         if nonlinearity == "relu":
-            mlp_nntile = DeepReLU(x_moments, 'L', gemm_ndim, hidden_layer_dim,
+            mlp_nntile = DeepReLU_mp(x_moments, 'L', gemm_ndim, hidden_layer_dim,
             hidden_layer_dim_tile, n_layers, n_classes, next_tag)
             for p, p_torch in zip(mlp_nntile.parameters, torch_mlp.parameters()):
                 p.value.from_array(p_torch.detach().numpy().T)
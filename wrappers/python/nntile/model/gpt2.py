@@ -111,7 +111,9 @@ class GPT2Model(BaseModel):
     # Construct model with all the provided data
     def __init__(self, input_ids: TensorMoments, \
             positional_ids: TensorMoments, config: GPT2Config, next_tag: int, \
-            fp32_fast_tf32: bool=False):
+            fp32_fast_tf32: bool=False, kv_cache_size: int=None, \
+            kv_cache_size_tile: int=None, lm_head_chunk: int=None, \
+            sparse_embedding: bool=False):
         # Check parameter side
         vocab_size = config["vocab_size"]
         vocab_embed_dim_tile = config["vocab_embed_dim_tile"]
@@ -135,18 +137,35 @@ class GPT2Model(BaseModel):
         seq_len_tile = input_ids.value.basetile_shape[0]
         activations = [input_ids, positional_ids]
         layers = []
-        mask_traits = TensorTraits((seq_len, seq_len), \
-                (seq_len_tile, seq_len_tile))
+        # In incremental decoding mode input tokens are only the new ones,
+        # while keys and values of all previous tokens are kept in caches of
+        # attention layers. Mask is then updated on every step.
+        self.positional_ids = positional_ids.value
+        self.kv_cache_size = kv_cache_size
+        if kv_cache_size is None:
+            mask_shape = (seq_len, seq_len)
+            mask_basetile = (seq_len_tile, seq_len_tile)
+        else:
+            if kv_cache_size > max_position_embeddings:
+                raise ValueError("kv_cache_size > max_position_embeddings")
+            if kv_cache_size_tile is None:
+                kv_cache_size_tile = kv_cache_size
+            mask_shape = (kv_cache_size, seq_len)
+            mask_basetile = (kv_cache_size_tile, seq_len_tile)
+        mask_traits = TensorTraits(mask_shape, mask_basetile)
         mask_distr = [0] * mask_traits.grid.nelems
         self.mask = Tensor_bool(mask_traits, mask_distr, next_tag)
         next_tag = self.mask.next_tag
-        mask_np = np.array(np.triu(np.ones((seq_len, seq_len))), dtype=bool, \
-                order="F")
-        self.mask.from_array(mask_np)
+        if kv_cache_size is None:
+            mask_np = np.array(np.triu(np.ones((seq_len, seq_len))), \
+                    dtype=bool, order="F")
+            self.mask.from_array(mask_np)
 
+        # Only rows of token embeddings, that are touched by a minibatch,
+        # are cleared and updated with sparse_embedding
         wte_layer, next_tag = Embedding.generate_simple(input_ids.value, \
                 Tensor_fp32, 0, vocab_size, self.embed_dim, embed_dim_tile, \
-                vocab_embed_dim_tile, next_tag)
+                vocab_embed_dim_tile, next_tag, sparse=sparse_embedding)
         layers.append(wte_layer)
         activations.extend(wte_layer.activations_output)
         
@@ -170,7 +189,9 @@ class GPT2Model(BaseModel):
             attn_layer, next_tag = AttLayer.generate_simple( \
                     activations[-1], activations[-1], activations[-1], \
                     self.n_head, n_head_tile, next_tag, True, self.mask, \
-                    redux=redux, fp32_fast_tf32=fp32_fast_tf32)
+                    redux=redux, fp32_fast_tf32=fp32_fast_tf32, \
+                    kv_cache_size=kv_cache_size, \
+                    kv_cache_size_tile=kv_cache_size_tile)
             layers.append(attn_layer)
             activations.extend(attn_layer.activations_output)
 
@@ -202,16 +223,63 @@ class GPT2Model(BaseModel):
         layers.append(l_norm)
         activations.extend(l_norm.activations_output)
 
+        # With lm_head_chunk the model outputs the final hidden states, while
+        # logits are never stored entirely. The head is then applied by
+        # nntile.loss.LinearCrossEntropy chunk by chunk, whereas its weight is
+        # still the last parameter of the model.
+        if lm_head_chunk is None:
+            lm_head_tile = vocab_size
+        else:
+            lm_head_tile = lm_head_chunk
         lm_head_layer, next_tag = Linear.generate_simple( \
-                activations[-1], "R", notrans, 1, [vocab_size], [vocab_size], \
-                next_tag, False, redux=redux, fp32_fast_tf32=fp32_fast_tf32)
+                activations[-1], "R", notrans, 1, [vocab_size], \
+                [lm_head_tile], next_tag, False, redux=redux, \
+                fp32_fast_tf32=fp32_fast_tf32)
+        self.lm_head = lm_head_layer
+        self.lm_head_chunk = lm_head_chunk
 
-        layers.append(lm_head_layer)
-        activations.extend(lm_head_layer.activations_output)
+        if lm_head_chunk is None:
+            layers.append(lm_head_layer)
+            activations.extend(lm_head_layer.activations_output)
+        else:
+            lm_head_layer.y.unregister()
 
         self.next_tag = next_tag
         # Fill Base Model with the generated data
         super().__init__(activations, layers)
+        if lm_head_chunk is not None:
+            self.parameters.extend(lm_head_layer.parameters)
+
+    # Clear key-value caches of all attention layers to start a new sequence
+    def reset_kv_cache_async(self):
+        if self.kv_cache_size is None:
+            raise RuntimeError("Model was created without key-value cache")
+        for l in self.layers:
+            if type(l) is Attention or type(l) is FlashAttention:
+                l.reset_kv_cache_async()
+
+    # Forward pass of incremental decoding, that processes only new tokens,
+    # stored in input_ids, starting at a given position of the sequence.
+    # Keys and values of previous tokens are taken from caches, so the cost
+    # of a step does not depend on the number of already processed tokens.
+    def forward_kv_cache_async(self, pos: int):
+        if self.kv_cache_size is None:
+            raise RuntimeError("Model was created without key-value cache")
+        seq_len = self.positional_ids.shape[0]
+        if pos < 0 or pos+seq_len > self.kv_cache_size:
+            raise ValueError("Tokens do not fit into the key-value cache")
+        # Positions of new tokens
+        self.positional_ids.from_array(np.array(np.arange(pos, \
+                pos+seq_len), order="F", dtype=np.int64))
+        # Causal mask of new tokens against all cached tokens
+        mask_np = np.array(np.arange(self.kv_cache_size).reshape(-1, 1) \
+                <= np.arange(pos, pos+seq_len).reshape(1, -1), dtype=bool, \
+                order="F")
+        self.mask.from_array(mask_np)
+        for l in self.layers:
+            if type(l) is Attention or type(l) is FlashAttention:
+                l.set_kv_cache_position(pos)
+        self.forward_async()
 
     def to_torch(self, base_torch_model):
         nntile_p_idx = 0
@@ -276,7 +344,9 @@ class GPT2Model(BaseModel):
     @staticmethod
     def from_torch(torch_gpt2, batch_size: int, batch_size_tile: int, \
             seq_len: int, seq_len_tile: int, config: GPT2Config, \
-            next_tag: int, fp32_fast_tf32: bool=False):
+            next_tag: int, fp32_fast_tf32: bool=False, \
+            kv_cache_size: int=None, kv_cache_size_tile: int=None, \
+            lm_head_chunk: int=None, sparse_embedding: bool=False):
         positional_ids_traits = TensorTraits([seq_len], [seq_len_tile])
         positional_ids_distr = [0] * positional_ids_traits.grid.nelems
         positional_ids_value = Tensor_int64(positional_ids_traits, \
@@ -296,7 +366,10 @@ class GPT2Model(BaseModel):
         x_moments = TensorMoments(x, x_grad, x_grad_required)
 
         gpt2_nntile = GPT2Model(x_moments, positional_ids, config, next_tag, \
-                fp32_fast_tf32=fp32_fast_tf32)
+                fp32_fast_tf32=fp32_fast_tf32, kv_cache_size=kv_cache_size, \
+                kv_cache_size_tile=kv_cache_size_tile, \
+                lm_head_chunk=lm_head_chunk, \
+                sparse_embedding=sparse_embedding)
         nntile_p_idx = 0
         attn_embed_dim = config["embed_dim"]
         attn_nheads = config["n_head"]
@@ -350,6 +423,8 @@ class GPT2Model(BaseModel):
     
     def unregister(self):
         super().unregister()
+        if self.lm_head_chunk is not None:
+            self.lm_head.unregister()
         if self.mask:
             self.mask.unregister()
 
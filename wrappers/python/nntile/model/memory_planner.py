@@ -0,0 +1,227 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/nntile/model/memory_planner.py
+# Static memory planner for activations and temporaries of a model
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2023-12-21
+
+from nntile.nntile_core import starpu
+from nntile.tensor import Tensor, TensorMoments, clear_async
+from typing import List, Dict
+
+class MemoryPlan:
+    training: bool
+    tensors: List[Tensor]
+    intervals: List[List[int]]
+    buffers: List[List[int]]
+    tile_buffers: List[List[int]]
+
+    # Liveness is analysed over a schedule, where forward pass of layer i is
+    # step i and its backward pass is step 2*nlayers-1-i. Values of
+    # activations, that are produced and consumed by layers of the model, live
+    # from forward till backward pass of the producer, while their gradients
+    # live from backward pass of the last consumer. Transient temporaries of
+    # a layer live between its forward and backward passes. Inputs and outputs
+    # of the model, parameters and persistent temporaries, like key-value
+    # caches, keep their own storage. Planned gradients are cleared right
+    # before the first backward pass, that accumulates into them. With
+    # training=False only forward pass is planned.
+    def __init__(self, model, training: bool=True):
+        self.training = training
+        self.nlayers = len(model.layers)
+        self.tensors = []
+        self.intervals = []
+        self._index = {}
+        # Gradients to clear before backward pass of each layer
+        self.clear_grads = [[] for _ in model.layers]
+        self.cleared_grads = set()
+        self.handles = []
+        producer = {}
+        last_consumer = {}
+        for i, l in enumerate(model.layers):
+            for t in l.activations_input:
+                last_consumer[id(t)] = i
+            for t in l.activations_output:
+                producer[id(t)] = i
+        for t in model.activations:
+            p = producer.get(id(t))
+            c = last_consumer.get(id(t))
+            if p is None or c is None or c <= p:
+                continue
+            if not training:
+                self._add(t.value, p, c)
+                continue
+            self._add(t.value, p, self._backward_step(p))
+            if t.grad is not None and t.grad_required:
+                self._add(t.grad, self._backward_step(c), \
+                        self._backward_step(p))
+                self._add_clear(c, t.grad)
+        for i, l in enumerate(model.layers):
+            for t in l.transient_temporaries():
+                if type(t) is TensorMoments:
+                    value, grad = t.value, t.grad
+                else:
+                    value, grad = t, None
+                if value is not None:
+                    self._add(value, i, self._backward_step(i) \
+                            if training else i)
+                if training and grad is not None:
+                    self._add(grad, self._backward_step(i), \
+                            self._backward_step(i))
+                    self._add_clear(i, grad)
+        self._assign()
+        self._count_fixed(model)
+
+    def _backward_step(self, i: int) -> int:
+        return 2*self.nlayers - 1 - i
+
+    # Add a tensor or extend its live interval if it is already added
+    def _add(self, t: Tensor, begin: int, end: int):
+        i = self._index.get(id(t))
+        if i is None:
+            self._index[id(t)] = len(self.tensors)
+            self.tensors.append(t)
+            self.intervals.append([begin, end])
+        else:
+            interval = self.intervals[i]
+            interval[0] = min(interval[0], begin)
+            interval[1] = max(interval[1], end)
+
+    def _add_clear(self, i: int, grad: Tensor):
+        if id(grad) in self.cleared_grads:
+            return
+        self.cleared_grads.add(id(grad))
+        self.clear_grads[i].append(grad)
+
+    # Tiles of the same size, owner and reduction methods are assigned to
+    # buffers in order of their live intervals, reusing any buffer, that is
+    # already free. For intervals this greedy coloring is optimal, so the
+    # number of buffers of each kind equals maximal number of simultaneously
+    # live tiles of this kind.
+    def _assign(self):
+        tiles = []
+        for i_tensor, t in enumerate(self.tensors):
+            begin, end = self.intervals[i_tensor]
+            dtype = type(t).__name__ if t.reduction != 0 else None
+            for i_tile in range(t.grid.nelems):
+                key = (t.distribution[i_tile], t.get_tile_nbytes(i_tile), \
+                        t.reduction, dtype)
+                tiles.append((begin, end, key, i_tensor, i_tile))
+        tiles.sort(key=lambda x: x[0])
+        # Buffers as lists of owner rank and size in bytes
+        self.buffers = []
+        self.tile_buffers = [[None]*t.grid.nelems for t in self.tensors]
+        # Free buffers of each kind and busy buffers with their end steps
+        free = {}
+        busy = {}
+        for begin, end, key, i_tensor, i_tile in tiles:
+            key_free = free.setdefault(key, [])
+            key_busy = busy.setdefault(key, [])
+            still_busy = []
+            for buf_end, buf in key_busy:
+                if buf_end < begin:
+                    key_free.append(buf)
+                else:
+                    still_busy.append((buf_end, buf))
+            if len(key_free) > 0:
+                buf = key_free.pop()
+            else:
+                buf = len(self.buffers)
+                self.buffers.append([key[0], key[1]])
+            still_busy.append((end, buf))
+            busy[key] = still_busy
+            self.tile_buffers[i_tensor][i_tile] = buf
+
+    # Count storage of tensors, that are not planned
+    def _count_fixed(self, model):
+        seen = set(self._index.keys())
+        tensors = []
+        def add(t):
+            if t is not None and id(t) not in seen:
+                seen.add(id(t))
+                tensors.append(t)
+        for t in model.activations + model.parameters:
+            add(t.value)
+            add(t.grad)
+        for l in model.layers:
+            for t in l.temporaries:
+                if type(t) is TensorMoments:
+                    add(t.value)
+                    add(t.grad)
+                else:
+                    add(t)
+        self.fixed_nbytes = {}
+        for t in tensors:
+            for i in range(t.grid.nelems):
+                rank = t.distribution[i]
+                self.fixed_nbytes[rank] = self.fixed_nbytes.get(rank, 0) \
+                        + t.get_tile_nbytes(i)
+
+    # Storage of planned tensors without planning, in bytes per MPI rank
+    def naive_nbytes(self) -> Dict[int, int]:
+        nbytes = {}
+        for t in self.tensors:
+            for i in range(t.grid.nelems):
+                rank = t.distribution[i]
+                nbytes[rank] = nbytes.get(rank, 0) + t.get_tile_nbytes(i)
+        return nbytes
+
+    # Storage of shared buffers, in bytes per MPI rank
+    def planned_nbytes(self) -> Dict[int, int]:
+        nbytes = {}
+        for rank, size in self.buffers:
+            nbytes[rank] = nbytes.get(rank, 0) + size
+        return nbytes
+
+    # Predicted peak memory of the model, in bytes per MPI rank. It does not
+    # include loss, optimizer states and data of StarPU itself.
+    def peak_nbytes(self) -> Dict[int, int]:
+        nbytes = dict(self.fixed_nbytes)
+        for rank, size in self.planned_nbytes().items():
+            nbytes[rank] = nbytes.get(rank, 0) + size
+        return nbytes
+
+    # Human-readable report of the plan
+    def summary(self) -> str:
+        mib = 1024.0 * 1024.0
+        naive = self.naive_nbytes()
+        planned = self.planned_nbytes()
+        peak = self.peak_nbytes()
+        lines = ["Memory plan ({}): {} tensors in {} buffers".format( \
+                "training" if self.training else "inference", \
+                len(self.tensors), len(self.buffers))]
+        for rank in sorted(peak.keys()):
+            lines.append(("  rank {}: activations and temporaries {:.2f} " \
+                    "MiB -> {:.2f} MiB, other tensors {:.2f} MiB, predicted " \
+                    "peak {:.2f} MiB").format(rank, naive.get(rank, 0)/mib, \
+                    planned.get(rank, 0)/mib, \
+                    self.fixed_nbytes.get(rank, 0)/mib, peak[rank]/mib))
+        return "\n".join(lines)
+
+    # Allocate shared buffers and store planned tiles in them. Previous
+    # values of planned tensors are lost.
+    def apply(self, next_tag: int) -> int:
+        for rank, size in self.buffers:
+            handle = starpu.VariableHandle(size)
+            handle.mpi_register(next_tag, rank)
+            next_tag += 1
+            self.handles.append(handle)
+        for t, buffers in zip(self.tensors, self.tile_buffers):
+            t.alias_tiles([self.handles[i] for i in buffers])
+        return next_tag
+
+    # Clear planned gradients before backward pass of a given layer
+    def clear_grads_async(self, i: int):
+        for grad in self.clear_grads[i]:
+            clear_async(grad)
+
+    def unregister(self):
+        for handle in self.handles:
+            handle.unregister()
+        self.handles = []
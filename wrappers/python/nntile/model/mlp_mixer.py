@@ -69,16 +69,20 @@ class MlpMixer(BaseModel):
             l.unregister()
         for x in self.activations:
             x.unregister()
+        if self.memory_plan is not None:
+            self.memory_plan.unregister()
 
 
     # Clear gradients of inter-layer activations
     def clear_activations_grads(self):
         for t in self.activations:
-            if t.grad is not None and t.grad_required:
+            if t.grad is not None and t.grad_required \
+                    and not self.grad_cleared_by_backward(t):
                 clear_async(t.grad)
         for l in self.layers:
             for t in l.temporaries:
-                if t is not None and t.grad is not None and t.grad_required:
+                if t is not None and t.grad is not None and t.grad_required \
+                        and not self.grad_cleared_by_backward(t):
                     clear_async(t.grad)
                     
 
@@ -86,7 +90,8 @@ class MlpMixer(BaseModel):
     def clear_tmp_grads(self):
         for l in self.layers:
             for t in l.temporaries:
-                if t is not None and t.grad is not None and t.grad_required:
+                if t is not None and t.grad is not None and t.grad_required \
+                        and not self.grad_cleared_by_backward(t):
                     clear_async(t.grad)
 
 
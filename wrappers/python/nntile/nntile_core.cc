@@ -22,12 +22,82 @@
 #include <sstream>
 #include <cstring>
 #include <thread>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
 
 using namespace nntile;
 namespace py = pybind11;
 
+namespace pybind11
+{
+namespace detail
+{
+
+// Python floats are passed to and from bf16_t through single precision
+template<>
+struct type_caster<bf16_t>
+{
+    PYBIND11_TYPE_CASTER(bf16_t, const_name("float"));
+    bool load(handle src, bool convert)
+    {
+        make_caster<fp32_t> caster;
+        if(!caster.load(src, convert))
+        {
+            return false;
+        }
+        value = cast_op<fp32_t>(caster);
+        return true;
+    }
+    static handle cast(bf16_t src, return_value_policy, handle)
+    {
+        return PyFloat_FromDouble(static_cast<fp32_t>(src));
+    }
+};
+
+} // namespace detail
+} // namespace pybind11
+
+// Type of numpy arrays that exchange data with tensors of type T
+template<typename T>
+struct numpy_type
+{
+    using type = T;
+};
+
+// Numpy has no bfloat16 type, so single precision arrays are used instead
+template<>
+struct numpy_type<bf16_t>
+{
+    using type = fp32_t;
+};
+
+template<typename T>
+using numpy_t = typename numpy_type<T>::type;
+
 constexpr auto _wait_for_all_sleep_time = std::chrono::milliseconds(1);
 
+// Replace tiles of a tensor by tiles of another tensor at replay of a graph
+template<typename T>
+void task_graph_substitute(starpu::TaskGraph &graph,
+        const tensor::Tensor<T> &from, const tensor::Tensor<T> &to)
+{
+    if(from.shape != to.shape)
+    {
+        throw std::runtime_error("from.shape != to.shape");
+    }
+    if(from.basetile_shape != to.basetile_shape)
+    {
+        throw std::runtime_error("from.basetile_shape != to.basetile_shape");
+    }
+    for(Index i = 0; i < from.grid.nelems; ++i)
+    {
+        graph.substitute(
+                static_cast<starpu_data_handle_t>(from.get_tile_handle(i)),
+                static_cast<starpu_data_handle_t>(to.get_tile_handle(i)));
+    }
+}
+
 // Extend (sub)module with nntile::starpu functionality
 void def_mod_starpu(py::module_ &m)
 {
@@ -60,9 +130,58 @@ void def_mod_starpu(py::module_ &m)
                 }
             }
             starpu_mpi_wait_for_all(MPI_COMM_WORLD);});
+    m.def("mpi_rank", [](){return starpu_mpi_world_rank();});
+    m.def("mpi_size", [](){return starpu_mpi_world_size();});
+    m.def("mpi_barrier", [](){starpu_mpi_barrier(MPI_COMM_WORLD);});
     m.def("restrict_cuda", [](){restrict_where(STARPU_CUDA);});
     m.def("restrict_cpu", [](){restrict_where(STARPU_CPU);});
     m.def("restrict_restore", [](){restore_where();});
+    m.def("cpu_worker_count", [](){
+            return starpu_worker_get_count_by_type(STARPU_CPU_WORKER);});
+    m.def("cuda_worker_count", [](){
+            return starpu_worker_get_count_by_type(STARPU_CUDA_WORKER);});
+    // StarPU-allocated buffer, that can store tiles of several tensors
+    py::class_<VariableHandle>(m, "VariableHandle").
+        def(py::init([](size_t size){
+                    return VariableHandle(size, STARPU_R);})).
+        def("mpi_register", &VariableHandle::mpi_register).
+        def("unregister", &VariableHandle::unregister);
+    py::class_<Tracer>(m, "Tracer").
+        def(py::init<>()).
+        def("start", &Tracer::start).
+        def("stop", &Tracer::stop).
+        def("clear", &Tracer::clear).
+        def("push_scope", &Tracer::push_scope).
+        def("pop_scope", &Tracer::pop_scope).
+        def("size", &Tracer::size).
+        def("save", &Tracer::save).
+        def("scope_totals", &Tracer::scope_totals);
+    // Scopes of the active tracer, that do nothing if there is no tracer
+    m.def("trace_active", [](){return Tracer::active() != nullptr;});
+    m.def("trace_push_scope", [](const std::string &name){
+            if(Tracer::active() != nullptr)
+            {
+                Tracer::active()->push_scope(name);
+            }});
+    m.def("trace_pop_scope", [](){
+            if(Tracer::active() != nullptr)
+            {
+                Tracer::active()->pop_scope();
+            }});
+    py::class_<TaskGraph>(m, "TaskGraph").
+        def(py::init<>()).
+        def("begin_capture", &TaskGraph::begin_capture).
+        def("end_capture", &TaskGraph::end_capture).
+        def("replay", &TaskGraph::replay).
+        def("clear", &TaskGraph::clear).
+        def("size", &TaskGraph::size).
+        def("substitute", &task_graph_substitute<fp64_t>).
+        def("substitute", &task_graph_substitute<fp32_t>).
+        def("substitute", &task_graph_substitute<fp16_t>).
+        def("substitute", &task_graph_substitute<bf16_t>).
+        def("substitute", &task_graph_substitute<Index>).
+        def("substitute", &task_graph_substitute<bool_t>).
+        def("substitute", &task_graph_substitute<int8_t>);
     m.def("profiling_init", [](){
             //starpu_profiling_init();
             });
@@ -205,7 +324,8 @@ void def_mod_tile(py::module_ &m)
 // numpy.ndarray -> Tensor
 template<typename T>
 void tensor_from_array(const tensor::Tensor<T> &tensor,
-        const py::array_t<T, py::array::f_style | py::array::forcecast> &array)
+        const py::array_t<numpy_t<T>, py::array::f_style | py::array::forcecast>
+        &array)
 {
     // Treat special 0-dimensional case, where NNTile assumes 1 element in a
     // tensor, while 0-dimensional numpy array assumes there no array elements
@@ -219,13 +339,16 @@ void tensor_from_array(const tensor::Tensor<T> &tensor,
         {
             throw std::runtime_error("array.shape()[0] != 1");
         }
-        // Acquire tile and copy a single element
+        // Acquire tile and copy a single element. Waiting for the tile does
+        // not need the GIL, so other Python threads are not blocked.
+        const numpy_t<T> *data = array.data();
+        py::gil_scoped_release release;
         int mpi_rank = starpu_mpi_world_rank();
         auto tile = tensor.get_tile(0);
         if(mpi_rank == tile.mpi_get_rank())
         {
             auto tile_local = tile.acquire(STARPU_W);
-            std::memcpy(tile_local.get_ptr(), array.data(), sizeof(T));
+            tile_local[0] = data[0];
             tile_local.release();
         }
         tile.mpi_flush();
@@ -243,33 +366,90 @@ void tensor_from_array(const tensor::Tensor<T> &tensor,
             throw std::runtime_error("array.shape()[i] != tensor.shape[i]");
         }
     }
-    // Create temporary single-tile tensor
-    tensor::TensorTraits tmp_traits(tensor.shape, tensor.shape);
-    int64_t tmp_tag = 0;
-    int flag;
-    //starpu_mpi_comm_get_attr(MPI_COMM_WORLD, STARPU_MPI_TAG_UB, &tmp_tag, \
-    //        &flag);
-    std::vector<int> tmp_distr{0};
-    tensor::Tensor<T> tmp(tmp_traits, tmp_distr, tmp_tag);
-    // Acquire tile and copy data
-    int mpi_rank = starpu_mpi_world_rank();
-    auto tile = tmp.get_tile(0);
-    if(mpi_rank == tile.mpi_get_rank())
+    // Tiles are acquired without the GIL, as the array is not accessed
+    // through Python API anymore
+    const numpy_t<T> *data = array.data();
+    Index size = array.size();
+    py::gil_scoped_release release;
+    // Copy data directly from the array into tiles
+    if constexpr(std::is_same_v<T, numpy_t<T>>)
     {
-        auto tile_local = tile.acquire(STARPU_W);
-        std::memcpy(tile_local.get_ptr(), array.data(),
-                tile.nelems*sizeof(T));
-        tile_local.release();
+        tensor::from_array<T>(data, tensor);
+    }
+    // Convert data into a temporary buffer at first
+    else
+    {
+        std::vector<T> buffer(data, data+size);
+        tensor::from_array<T>(buffer.data(), tensor);
     }
-    tensor::scatter<T>(tmp, tensor);
-    tmp.unregister();
     tensor.mpi_flush();
 }
 
+// numpy.ndarray -> Tensor without waiting for the copy. The array is not
+// converted, as it is read by tasks, so a caller must keep it alive and
+// unchanged until the tasks are finished, e.g., by wait_tiles()
+template<typename T>
+void tensor_from_array_async(const tensor::Tensor<T> &tensor,
+        const py::array_t<numpy_t<T>, py::array::f_style> &array)
+{
+    if constexpr(!std::is_same_v<T, numpy_t<T>>)
+    {
+        throw std::runtime_error("Asynchronous copy needs the same type of "
+                "array and tensor");
+    }
+    else
+    {
+        if(tensor.ndim == 0)
+        {
+            if(array.ndim() != 1 or array.shape()[0] != 1)
+            {
+                throw std::runtime_error("array.shape != [1]");
+            }
+        }
+        else
+        {
+            if(tensor.ndim != array.ndim())
+            {
+                throw std::runtime_error("tensor.ndim != array.ndim()");
+            }
+            for(Index i = 0; i < tensor.ndim; ++i)
+            {
+                if(array.shape()[i] != tensor.shape[i])
+                {
+                    throw std::runtime_error("array.shape()[i] != "
+                            "tensor.shape[i]");
+                }
+            }
+        }
+        const T *data = array.data();
+        py::gil_scoped_release release;
+        tensor::from_array_async<T>(data, tensor);
+        tensor.mpi_flush();
+    }
+}
+
+// Wait for tasks, that write local tiles of a tensor. Unlike wait_for_all it
+// does not wait for unrelated tasks and does not involve other MPI nodes.
+template<typename T>
+void tensor_wait_tiles(const tensor::Tensor<T> &tensor)
+{
+    py::gil_scoped_release release;
+    int mpi_rank = starpu_mpi_world_rank();
+    for(Index i = 0; i < tensor.grid.nelems; ++i)
+    {
+        auto tile = tensor.get_tile(i);
+        if(mpi_rank == tile.mpi_get_rank())
+        {
+            auto tile_local = tile.acquire(STARPU_R);
+            tile_local.release();
+        }
+    }
+}
+
 // Tensor -> numpy.ndarray
 template<typename T>
 void tensor_to_array(const tensor::Tensor<T> &tensor,
-        py::array_t<T, py::array::f_style> &array)
+        py::array_t<numpy_t<T>, py::array::f_style> &array)
 {
     // Treat special 0-dimensional case, where NNTile assumes 1 element in a
     // tensor, while 0-dimensional numpy array assumes there no array elements
@@ -283,13 +463,15 @@ void tensor_to_array(const tensor::Tensor<T> &tensor,
         {
             throw std::runtime_error("array.shape()[0] != 1");
         }
-        // Acquire tile and copy a single element
+        // Acquire tile and copy a single element without the GIL
+        numpy_t<T> *data = array.mutable_data();
+        py::gil_scoped_release release;
         int mpi_rank = starpu_mpi_world_rank();
         auto tile = tensor.get_tile(0);
         if(mpi_rank == tile.mpi_get_rank())
         {
             auto tile_local = tile.acquire(STARPU_R);
-            std::memcpy(array.mutable_data(), tile_local.get_ptr(), sizeof(T));
+            data[0] = tile_local[0];
             tile_local.release();
         }
         tile.mpi_flush();
@@ -307,26 +489,22 @@ void tensor_to_array(const tensor::Tensor<T> &tensor,
             throw std::runtime_error("array.shape()[i] != tensor.shape[i]");
         }
     }
-    // Create temporary single-tile tensor
-    tensor::TensorTraits tmp_traits(tensor.shape, tensor.shape);
-    int64_t tmp_tag = 0;
-    int flag;
-    //starpu_mpi_comm_get_attr(MPI_COMM_WORLD, STARPU_MPI_TAG_UB, &tmp_tag, \
-            &flag);
-    std::vector<int> tmp_distr{0};
-    tensor::Tensor<T> tmp(tmp_traits, tmp_distr, tmp_tag);
-    tensor::gather<T>(tensor, tmp);
-    // Acquire tile and copy data
-    int mpi_rank = starpu_mpi_world_rank();
-    auto tile = tmp.get_tile(0);
-    if(mpi_rank == tile.mpi_get_rank())
+    // Tiles are acquired without the GIL
+    numpy_t<T> *data = array.mutable_data();
+    Index size = array.size();
+    py::gil_scoped_release release;
+    // Copy data directly from tiles into the array
+    if constexpr(std::is_same_v<T, numpy_t<T>>)
     {
-        auto tile_local = tile.acquire(STARPU_R);
-        std::memcpy(array.mutable_data(), tile_local.get_ptr(),
-                tile.nelems*sizeof(T));
-        tile_local.release();
+        tensor::to_array<T>(tensor, data);
+    }
+    // Convert data through a temporary buffer
+    else
+    {
+        std::vector<T> buffer(size);
+        tensor::to_array<T>(tensor, buffer.data());
+        std::copy(buffer.begin(), buffer.end(), data);
     }
-    tmp.unregister();
 }
 
 // Extend (sub)module with nntile::tensor::Tensor<T>
@@ -343,7 +521,21 @@ void def_class_tensor(py::module_ &m, const char *name)
         //def("invalidate_submit", &Tensor<T>::invalidate_submit).
         def("invalidate_submit", &Tensor<T>::wont_use).
         def("wont_use", &Tensor<T>::wont_use).
+        def("discard_submit", &Tensor<T>::discard_submit).
+        def("alias_tiles", &Tensor<T>::alias_tiles).
+        // Handles of all tiles, that can be shared with another tensor
+        def("get_tile_handles", [](const Tensor<T> &tensor){
+                return tensor.tile_handles;}).
+        // Size of a tile in bytes
+        def("get_tile_nbytes", [](const Tensor<T> &tensor, Index i){
+                return sizeof(T) * tensor.get_tile_traits(i).nelems;}).
+        // Kind of reduction methods as an integer
+        def_property_readonly("reduction", [](const Tensor<T> &tensor){
+                return static_cast<int>(tensor.reduction);}).
         def("from_array", tensor_from_array<T>).
+        def("from_array_async", tensor_from_array_async<T>,
+                py::arg("array").noconvert()).
+        def("wait_tiles", tensor_wait_tiles<T>).
         def("to_array", tensor_to_array<T>).
         def("set_reduction_add", &Tensor<T>::set_reduction_add).
         def("set_reduction_hypot", &Tensor<T>::set_reduction_hypot).
@@ -392,8 +584,10 @@ void def_mod_tensor(py::module_ &m)
     def_class_tensor<fp64_t>(m, "Tensor_fp64");
     def_class_tensor<fp32_t>(m, "Tensor_fp32");
     def_class_tensor<fp16_t>(m, "Tensor_fp16");
+    def_class_tensor<bf16_t>(m, "Tensor_bf16");
     def_class_tensor<Index>(m, "Tensor_int64");
     def_class_tensor<bool_t>(m, "Tensor_bool");
+    def_class_tensor<int8_t>(m, "Tensor_int8");
     // Add tensor.distributions submodule
     auto distributions = m.def_submodule("distributions");
     def_tensor_distributions(distributions);
@@ -402,9 +596,11 @@ void def_mod_tensor(py::module_ &m)
     m.def("gemm_async_fp64", &gemm_async<fp64_t, fp64_t>);
     m.def("gemm_async_fp32", &gemm_async<fp32_t, fp32_t>);
     m.def("gemm_async_fp16", &gemm_async<fp16_t, fp32_t>);
+    m.def("gemm_async_bf16", &gemm_async<bf16_t, fp32_t>);
     m.def("gemm_fp64", &gemm<fp64_t, fp64_t>);
     m.def("gemm_fp32", &gemm<fp32_t, fp32_t>);
     m.def("gemm_fp16", &gemm<fp16_t, fp32_t>);
+    m.def("gemm_bf16", &gemm<bf16_t, fp32_t>);
     // Mixed precision gemm (FP32_FAST_FP16)
     m.def("gemm_ex_async_fp32", &gemm_ex_async<fp32_t>);
     m.def("gemm_ex_fp32", &gemm_ex<fp32_t>);
@@ -472,8 +668,10 @@ void def_mod_tensor(py::module_ &m)
 
     m.def("softmax_async_fp64", &softmax_async<fp64_t>);
     m.def("softmax_async_fp32", &softmax_async<fp32_t>);
+    m.def("softmax_async_bf16", &softmax_async<bf16_t>);
     m.def("softmax_fp64", &softmax<fp64_t>);
     m.def("softmax_fp32", &softmax<fp32_t>);
+    m.def("softmax_bf16", &softmax<bf16_t>);
 
     m.def("softmax_inplace_async_fp64", &softmax_inplace_async<fp64_t>);
     m.def("softmax_inplace_async_fp32", &softmax_inplace_async<fp32_t>);
@@ -494,8 +692,10 @@ void def_mod_tensor(py::module_ &m)
     m.def("randn_fp32", &randn<fp32_t>);
     m.def("prod_async_fp64", &prod_async<fp64_t>);
     m.def("prod_async_fp32", &prod_async<fp32_t>);
+    m.def("prod_async_bf16", &prod_async<bf16_t>);
     m.def("prod_fp64", &prod<fp64_t>);
     m.def("prod_fp32", &prod<fp32_t>);
+    m.def("prod_bf16", &prod<bf16_t>);
     m.def("nrm2_async_fp64", &nrm2_async<fp64_t>);
     m.def("nrm2_async_fp32", &nrm2_async<fp32_t>);
     m.def("nrm2_fp64", &nrm2<fp64_t>);
@@ -512,8 +712,10 @@ void def_mod_tensor(py::module_ &m)
 
     m.def("maxsumexp_async_fp64", &maxsumexp_async<fp64_t>);
     m.def("maxsumexp_async_fp32", &maxsumexp_async<fp32_t>);
+    m.def("maxsumexp_async_bf16", &maxsumexp_async<bf16_t>);
     m.def("maxsumexp_fp64", &maxsumexp<fp64_t>);
     m.def("maxsumexp_fp32", &maxsumexp<fp32_t>);
+    m.def("maxsumexp_bf16", &maxsumexp<bf16_t>);
 
     m.def("add_slice_async_fp64", &add_slice_async<fp64_t>);
     m.def("add_slice_async_fp32", &add_slice_async<fp32_t>);
@@ -527,8 +729,10 @@ void def_mod_tensor(py::module_ &m)
 
     m.def("add_async_fp64", &add_async<fp64_t>);
     m.def("add_async_fp32", &add_async<fp32_t>);
+    m.def("add_async_bf16", &add_async<bf16_t>);
     m.def("add_fp64", &add<fp64_t>);
     m.def("add_fp32", &add<fp32_t>);
+    m.def("add_bf16", &add<bf16_t>);
 
     m.def("add_scalar_async_fp64", &add_scalar_async<fp64_t>);
     m.def("add_scalar_async_fp32", &add_scalar_async<fp32_t>);
@@ -583,9 +787,15 @@ void def_mod_tensor(py::module_ &m)
     m.def("clear_async_fp64", &clear_async<fp64_t>);
     m.def("clear_async_fp32", &clear_async<fp32_t>);
     m.def("clear_async_fp16", &clear_async<fp16_t>);
+    m.def("clear_async_bf16", &clear_async<bf16_t>);
+    m.def("clear_async_bool", &clear_async<bool_t>);
+    m.def("clear_async_int64", &clear_async<Index>);
     m.def("clear_fp64", &clear<fp64_t>);
     m.def("clear_fp32", &clear<fp32_t>);
     m.def("clear_fp16", &clear<fp16_t>);
+    m.def("clear_bf16", &clear<bf16_t>);
+    m.def("clear_bool", &clear<bool_t>);
+    m.def("clear_int64", &clear<Index>);
         
     m.def("axpy_async_fp64", py::overload_cast<fp64_t, const Tensor<fp64_t>&,
             const Tensor<fp64_t>&>(&axpy_async<fp64_t>));
@@ -657,6 +867,45 @@ void def_mod_tensor(py::module_ &m)
     m.def("adamw_step_fp64", &adamw_step<fp64_t>);
     m.def("adamw_step_fp32", &adamw_step<fp32_t>);
 
+    m.def("amp_unscale_async_fp64", &amp_unscale_async<fp64_t>);
+    m.def("amp_unscale_async_fp32", &amp_unscale_async<fp32_t>);
+    m.def("amp_unscale_fp64", &amp_unscale<fp64_t>);
+    m.def("amp_unscale_fp32", &amp_unscale<fp32_t>);
+    // Waiting for flags does not need the GIL
+    m.def("amp_nonfinite", &amp_nonfinite,
+            py::call_guard<py::gil_scoped_release>());
+
+    m.def("cross_entropy_fwd_bwd_async_fp64",
+            &cross_entropy_fwd_bwd_async<fp64_t>);
+    m.def("cross_entropy_fwd_bwd_async_fp32",
+            &cross_entropy_fwd_bwd_async<fp32_t>);
+    m.def("cross_entropy_fwd_bwd_fp64", &cross_entropy_fwd_bwd<fp64_t>);
+    m.def("cross_entropy_fwd_bwd_fp32", &cross_entropy_fwd_bwd<fp32_t>);
+
+    m.def("embedding_rows_async", &embedding_rows_async);
+    m.def("embedding_rows", &embedding_rows);
+
+    m.def("clear_rows_async_fp64", &clear_rows_async<fp64_t>);
+    m.def("clear_rows_async_fp32", &clear_rows_async<fp32_t>);
+    m.def("clear_rows_fp64", &clear_rows<fp64_t>);
+    m.def("clear_rows_fp32", &clear_rows<fp32_t>);
+
+    m.def("sparse_adam_step_async_fp64", &sparse_adam_step_async<fp64_t>);
+    m.def("sparse_adam_step_async_fp32", &sparse_adam_step_async<fp32_t>);
+    m.def("sparse_adam_step_fp64", &sparse_adam_step<fp64_t>);
+    m.def("sparse_adam_step_fp32", &sparse_adam_step<fp32_t>);
+
+    m.def("multi_adam_step_async_fp64", &multi_adam_step_async<fp64_t>);
+    m.def("multi_adam_step_async_fp32", &multi_adam_step_async<fp32_t>);
+    m.def("multi_adam_step_fp64", &multi_adam_step<fp64_t>);
+    m.def("multi_adam_step_fp32", &multi_adam_step<fp32_t>);
+    m.def("multi_adam_step_async_fp32_bf16",
+            &multi_adam_step_async<fp32_t, bf16_t>);
+    m.def("multi_adam_step_fp32_bf16", &multi_adam_step<fp32_t, bf16_t>);
+
+    m.def("gemm_int8_async_fp32", &gemm_int8_async<fp32_t>);
+    m.def("gemm_int8_fp32", &gemm_int8<fp32_t>);
+
     m.def("scal_inplace_async_fp64", &scal_inplace_async<fp64_t>);
     m.def("scal_inplace_async_fp32", &scal_inplace_async<fp32_t>);
     m.def("scal_inplace_fp64", &scal_inplace<fp64_t>);
@@ -684,8 +933,10 @@ void def_mod_tensor(py::module_ &m)
 
     m.def("gelutanh_async_fp64", &gelutanh_async<fp64_t>);
     m.def("gelutanh_async_fp32", &gelutanh_async<fp32_t>);
+    m.def("gelutanh_async_bf16", &gelutanh_async<bf16_t>);
     m.def("gelutanh_fp64", &gelutanh<fp64_t>);
     m.def("gelutanh_fp32", &gelutanh<fp32_t>);
+    m.def("gelutanh_bf16", &gelutanh<bf16_t>);
     m.def("gelutanh_inplace_async_fp64", &gelutanh_inplace_async<fp64_t>);
     m.def("gelutanh_inplace_async_fp32", &gelutanh_inplace_async<fp32_t>);
     m.def("gelutanh_inplace_fp64", &gelutanh_inplace<fp64_t>);
@@ -707,8 +958,10 @@ void def_mod_tensor(py::module_ &m)
     // Embedding forward pass
     m.def("embedding_async_fp64", &embedding_async<fp64_t>);
     m.def("embedding_async_fp32", &embedding_async<fp32_t>);
+    m.def("embedding_async_bf16", &embedding_async<bf16_t>);
     m.def("embedding_fp64", &embedding<fp64_t>);
     m.def("embedding_fp32", &embedding<fp32_t>);
+    m.def("embedding_bf16", &embedding<bf16_t>);
 
     // Embedding backward pass
     m.def("embedding_backward_async_fp64", &embedding_backward_async<fp64_t>);
@@ -739,6 +992,42 @@ void def_mod_tensor(py::module_ &m)
     m.def("transpose_async_fp32", &transpose_async<fp32_t>);
     m.def("transpose_fp64", &transpose<fp64_t>);
     m.def("transpose_fp32", &transpose<fp32_t>);
+
+    m.def("layer_norm_forward_async_fp64",
+            &layer_norm_forward_async<fp64_t>);
+    m.def("layer_norm_forward_async_fp32",
+            &layer_norm_forward_async<fp32_t>);
+    m.def("layer_norm_forward_fp64", &layer_norm_forward<fp64_t>);
+    m.def("layer_norm_forward_fp32", &layer_norm_forward<fp32_t>);
+
+    m.def("layer_norm_backward_async_fp64",
+            &layer_norm_backward_async<fp64_t>);
+    m.def("layer_norm_backward_async_fp32",
+            &layer_norm_backward_async<fp32_t>);
+    m.def("layer_norm_backward_fp64", &layer_norm_backward<fp64_t>);
+    m.def("layer_norm_backward_fp32", &layer_norm_backward<fp32_t>);
+
+    m.def("save_async_fp64", &save_async<fp64_t>);
+    m.def("save_async_fp32", &save_async<fp32_t>);
+    m.def("save_async_bf16", &save_async<bf16_t>);
+    m.def("save_async_int64", &save_async<Index>);
+    m.def("save_async_bool", &save_async<bool_t>);
+    m.def("save_fp64", &save<fp64_t>);
+    m.def("save_fp32", &save<fp32_t>);
+    m.def("save_bf16", &save<bf16_t>);
+    m.def("save_int64", &save<Index>);
+    m.def("save_bool", &save<bool_t>);
+
+    m.def("load_async_fp64", &load_async<fp64_t>);
+    m.def("load_async_fp32", &load_async<fp32_t>);
+    m.def("load_async_bf16", &load_async<bf16_t>);
+    m.def("load_async_int64", &load_async<Index>);
+    m.def("load_async_bool", &load_async<bool_t>);
+    m.def("load_fp64", &load<fp64_t>);
+    m.def("load_fp32", &load<fp32_t>);
+    m.def("load_bf16", &load<bf16_t>);
+    m.def("load_int64", &load<Index>);
+    m.def("load_bool", &load<bool_t>);
 }
 
 // Main extension module with all wrappers
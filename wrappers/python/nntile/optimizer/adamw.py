@@ -14,28 +14,57 @@
 
 import nntile
 import numpy as np
-from nntile.tensor import TensorTraits
+from nntile.tensor import TensorTraits, Tensor_int64, Tensor_fp32, \
+        Tensor_bf16, RowSparseTensorMoments
 import pickle
 import torch
+import json
+import os
 
 class FusedAdamW:
     def __init__(self, params, lr, next_tag, beta1=0.9, beta2=0.999, \
             weight_decay=0., eps=1e-8, dtype=np.float32, start_lr=None, \
-            full_lr_iter=None):
+            full_lr_iter=None, pack_nelems=65536, moments_dtype=None):
         self.params = params
+        # Small tiles of parameters are packed into tasks of about this
+        # number of elements
+        self.pack_nelems = pack_nelems
+        # Moments of dense fp32 parameters can be kept in bf16, that are
+        # rounded stochastically by the fused step
+        if moments_dtype not in (None, "bf16"):
+            raise ValueError("moments_dtype must be None or 'bf16'")
+        self.moments_dtype = moments_dtype
         self.next_tag = next_tag
         self.num_iter = 1
         self.dtype=dtype
         self.first_moments = []
         self.second_moments = []
+        # Row-sparse parameters are updated lazily, so every tile of them
+        # keeps its own numbers of steps for its rows
+        self.row_steps = []
         for p in self.params:
             p_traits = TensorTraits(p.value.shape, p.value.basetile_shape)
-            self.first_moments.append(type(p.value)(p_traits, \
+            moments_type = type(p.value)
+            if moments_dtype == "bf16" and type(p.value) is Tensor_fp32 \
+                    and type(p) is not RowSparseTensorMoments:
+                moments_type = Tensor_bf16
+            self.first_moments.append(moments_type(p_traits, \
                     p.value.distribution, self.next_tag))
             self.next_tag = self.first_moments[-1].next_tag
-            self.second_moments.append(type(p.value)(p_traits, \
+            self.second_moments.append(moments_type(p_traits, \
                     p.value.distribution, self.next_tag))
             self.next_tag = self.second_moments[-1].next_tag
+            if type(p) is RowSparseTensorMoments:
+                row_step_traits = TensorTraits( \
+                        [p.value.grid.shape[0], p.value.shape[1]], \
+                        [1, p.value.basetile_shape[1]])
+                row_step = Tensor_int64(row_step_traits, \
+                        p.value.distribution, self.next_tag)
+                self.next_tag = row_step.next_tag
+                nntile.tensor.clear_async(row_step)
+                self.row_steps.append(row_step)
+            else:
+                self.row_steps.append(None)
         self.lr = lr
         self.start_lr = start_lr
         self.full_lr_iter = full_lr_iter
@@ -51,6 +80,8 @@ class FusedAdamW:
         for i in range(len(self.first_moments)):
             self.first_moments[i].unregister()
             self.second_moments[i].unregister()
+            if self.row_steps[i] is not None:
+                self.row_steps[i].unregister()
 
     def step(self):
         cur_lr = self.lr
@@ -58,23 +89,59 @@ class FusedAdamW:
             if self.num_iter < self.full_lr_iter and self.full_lr_iter > 1:
                 cur_lr = (self.lr-self.start_lr) / (self.full_lr_iter-1)
                 cur_lr = cur_lr*(self.num_iter-1) + self.start_lr
+        dense = {}
         for i, p in enumerate(self.params):
-            nntile.tensor.fused_adamw_step(p.value, p.grad, \
-                    self.first_moments[i], self.second_moments[i], cur_lr, \
+            if self.row_steps[i] is not None:
+                # Only marked rows are updated and the gradient is kept, as
+                # it must stay zero outside of marked rows
+                nntile.tensor.fused_sparse_adam_step(p.value, p.grad, \
+                        self.first_moments[i], self.second_moments[i], \
+                        p.rows, self.row_steps[i], cur_lr, self.eps, \
+                        self.beta1, self.beta2, self.weight_decay, \
+                        decoupled=True)
+                p.value.wont_use()
+                p.grad.wont_use()
+                p.rows.wont_use()
+                self.row_steps[i].wont_use()
+                self.first_moments[i].wont_use()
+                self.second_moments[i].wont_use()
+                continue
+            key = (type(p.value), type(self.first_moments[i]))
+            dense.setdefault(key, []).append(i)
+        # Dense parameters of the same type with moments of the same type are
+        # updated at once, so that their small tiles are packed into a few
+        # tasks
+        for ind in dense.values():
+            nntile.tensor.fused_multi_adam_step( \
+                    [self.params[i].value for i in ind], \
+                    [self.params[i].grad for i in ind], \
+                    [self.first_moments[i] for i in ind], \
+                    [self.second_moments[i] for i in ind], cur_lr, \
                     self.eps, self.beta1, self.beta2, self.weight_decay, \
-                    self.num_iter)
-            p.value.wont_use()
-            # dP can be deleted
-            #p.grad.wont_use()
-            p.grad.invalidate_submit()
-            self.first_moments[i].wont_use()
-            self.second_moments[i].wont_use()
+                    self.num_iter, decoupled=True, \
+                    pack_nelems=self.pack_nelems)
+            for i in ind:
+                p = self.params[i]
+                p.value.wont_use()
+                # dP can be deleted
+                #p.grad.wont_use()
+                p.grad.invalidate_submit()
+                self.first_moments[i].wont_use()
+                self.second_moments[i].wont_use()
         self.num_iter += 1
 
     def save_state(self, path, dtype="fp32"):
         first_moments = []
         second_moments = []
+        row_steps = []
         for i in range(len(self.first_moments)):
+            if self.row_steps[i] is not None:
+                r_s = np.zeros(self.row_steps[i].shape, dtype=np.int64, \
+                        order="F")
+                self.row_steps[i].to_array(r_s)
+                row_steps.append(r_s)
+            else:
+                row_steps.append(None)
             f_m = np.array(np.zeros(self.first_moments[i].shape, dtype=self.dtype), order="F")
             self.first_moments[i].to_array(f_m)
             s_m = np.array(np.zeros(self.second_moments[i].shape, dtype=self.dtype), order="F")
@@ -92,6 +159,7 @@ class FusedAdamW:
         stored_data = {
             "first_moments": first_moments,
             "second_moments": second_moments,
+            "row_steps": row_steps,
             "num_iter": self.num_iter,
             "beta1": self.beta1,
             "beta2": self.beta2,
@@ -119,6 +187,10 @@ class FusedAdamW:
         
         first_moments = stored_states["first_moments"]
         second_moments = stored_states["second_moments"]
+        row_steps = stored_states.get("row_steps", [])
+        for i in range(len(row_steps)):
+            if row_steps[i] is not None:
+                self.row_steps[i].from_array(row_steps[i])
         for i in range(len(first_moments)):
             f = first_moments[i].to(torch.float32)
             self.first_moments[i].from_array(f)
@@ -128,3 +200,48 @@ class FusedAdamW:
             del s
         del stored_states, first_moments, second_moments
 
+    # Save state into a directory of tile-aligned checkpoint files. Moments
+    # are written by StarPU tasks, and the state file is written after all
+    # of them are finished.
+    def save_checkpoint(self, path):
+        os.makedirs(path, exist_ok=True)
+        for i in range(len(self.first_moments)):
+            nntile.tensor.save_async(self.first_moments[i], \
+                    os.path.join(path, "first_moment_{}.nntile".format(i)))
+            nntile.tensor.save_async(self.second_moments[i], \
+                    os.path.join(path, "second_moment_{}.nntile".format(i)))
+            if self.row_steps[i] is not None:
+                nntile.tensor.save_async(self.row_steps[i], \
+                        os.path.join(path, "row_step_{}.nntile".format(i)))
+        stored_data = {
+            "num_iter": self.num_iter,
+            "beta1": self.beta1,
+            "beta2": self.beta2,
+            "lr": self.lr,
+            "start_lr": self.start_lr,
+            "full_lr_iter": self.full_lr_iter,
+            "eps": self.eps,
+            "weight_decay": self.weight_decay
+        }
+        nntile.tensor.save_checkpoint_state(path, stored_data)
+
+    # Load state from a directory of tile-aligned checkpoint files
+    def load_checkpoint(self, path):
+        with open(os.path.join(path, "state.json"), "r") as fp:
+            stored_states = json.load(fp)
+        self.lr = stored_states["lr"]
+        self.start_lr = stored_states["start_lr"]
+        self.full_lr_iter = stored_states["full_lr_iter"]
+        self.beta1 = stored_states["beta1"]
+        self.beta2 = stored_states["beta2"]
+        self.eps = stored_states["eps"]
+        self.num_iter = stored_states["num_iter"]
+        self.weight_decay = stored_states["weight_decay"]
+        for i in range(len(self.first_moments)):
+            nntile.tensor.load_async(self.first_moments[i], \
+                    os.path.join(path, "first_moment_{}.nntile".format(i)))
+            nntile.tensor.load_async(self.second_moments[i], \
+                    os.path.join(path, "second_moment_{}.nntile".format(i)))
+            if self.row_steps[i] is not None:
+                nntile.tensor.load_async(self.row_steps[i], \
+                        os.path.join(path, "row_step_{}.nntile".format(i)))
@@ -14,12 +14,19 @@
 
 import nntile
 import numpy as np
-from nntile.tensor import TensorTraits
+from nntile.tensor import TensorTraits, RowSparseTensorMoments
 
 class SGD:
     def __init__(self, params, lr, next_tag,
                  momentum=0., nesterov=False,
                  weight_decay=0., damping=0., dtype=np.float32):
+        # Weight decay and momentum are written into the whole gradient,
+        # while gradient of a row-sparse parameter must stay zero outside
+        # of marked rows
+        if (weight_decay != 0. or momentum > 0) and any( \
+                type(p) is RowSparseTensorMoments for p in params):
+            raise ValueError("SGD supports neither weight decay nor " \
+                    "momentum of row-sparse parameters")
         self.params = params
         self.nesterov = nesterov
         self.num_iter = 0
@@ -14,22 +14,34 @@
 
 from nntile.tensor import TensorTraits, Tensor, TensorOrNone, TensorMoments, \
         copy_async, axpy_async, clear_async
+from nntile.nntile_core import starpu as core_starpu
 from nntile.layer.base_layer import BaseLayer
 from nntile.model.base_model import BaseModel
 import numpy as np
 from typing import List, Any
 
 class Pipeline(object):
-    x: List[List[Tensor]]
-    y: List[List[Tensor]]
+    x: Any
+    y: Any
     model: BaseModel
     opt: Any
     loss: Any
     n_epochs: int
     lr: float
+    capture_graph: bool
 
-    def __init__(self, x: List[List[Tensor]], y: List[List[Tensor]], \
-            model: BaseModel, opt, loss, n_epochs):
+    # Inputs and targets are either lists of batches of minibatches, or x
+    # is a nntile.dataloader.TokenFileLoader and y is None
+    def __init__(self, x: Any, y: Any, model: BaseModel, opt, loss, \
+            n_epochs, capture_graph=False, grad_scaler=None):
+        # Captured tasks keep the loss scale they were submitted with
+        if capture_graph and grad_scaler is not None:
+            raise ValueError("capture_graph is not supported with dynamic " \
+                    "loss scaling")
+        # Dropping of checkpointed activations is not a task
+        if capture_graph and model.checkpoint_segments is not None:
+            raise ValueError("capture_graph is not supported with " \
+                    "activation checkpointing")
         self.x = x
         self.y = y
         self.model = model
@@ -37,6 +49,57 @@ class Pipeline(object):
         self.loss = loss
         self.n_epochs = n_epochs
         self.loss_hist = []
+        # Tasks of the first minibatch are recorded and then replayed for
+        # all other minibatches, that only differ by input and target
+        self.capture_graph = capture_graph
+        self.graph = None
+        self.graph_x = None
+        self.graph_y = None
+        # Optional nntile.amp.GradScaler for mixed precision training
+        self.grad_scaler = grad_scaler
+
+    def minibatch_async(self, x_minibatch: Tensor, y_minibatch: Tensor):
+        # Clear gradients of inter-layer activations
+        self.model.clear_activations_grads()
+        # Copy input batch into activation[0] of the model
+        copy_async(x_minibatch, self.model.activations[0].value)
+        # Perform forward pass
+        self.model.forward_async()
+        # Copy true result into loss function
+        copy_async(y_minibatch, self.loss.y)
+        # Loss function shall be instatiated to read X from
+        # activations[-1].value of the model and write gradient
+        # into activations[-1].grad
+        core_starpu.trace_push_scope("loss")
+        self.loss.calc_async()
+        core_starpu.trace_pop_scope()
+        # Print value asynchronously
+        #self.loss.val.print_scalar_async()
+        # Now do the backward pass
+        self.model.backward_async()
+
+    def minibatch_graph_async(self, x_minibatch: Tensor, y_minibatch: Tensor):
+        if self.graph is None:
+            self.graph = core_starpu.TaskGraph()
+            self.graph_x = x_minibatch
+            self.graph_y = y_minibatch
+            self.graph.begin_capture()
+            try:
+                self.minibatch_async(x_minibatch, y_minibatch)
+            finally:
+                self.graph.end_capture()
+        else:
+            self.graph.substitute(self.graph_x, x_minibatch)
+            self.graph.substitute(self.graph_y, y_minibatch)
+            self.graph.replay()
+
+    def batches(self):
+        # Streaming loader prepares pairs of input and target in background
+        if self.y is None:
+            self.x.start_epoch()
+            return iter(self.x)
+        return (zip(x_batch, y_batch) for x_batch, y_batch \
+                in zip(self.x, self.y))
 
     def train_async(self):
         batch_counter = 0
@@ -44,31 +107,26 @@ class Pipeline(object):
         for i_epoch in range(self.n_epochs):
             # print("Epoch ", i_epoch)
             num_batches = len(self.x)
-            for i_batch, (x_batch, y_batch) in enumerate(zip(self.x, self.y)):
+            for i_batch, minibatches in enumerate(self.batches()):
                 # Zero out gradients of all weights and activations
                 self.model.clear_parameters_grads()
                 clear_async(self.loss.val)
+                if self.grad_scaler is not None:
+                    self.grad_scaler.scale_loss(self.loss)
                 # Accumulate gradients from subbatches
-                for x_minibatch, y_minibatch in zip(x_batch, y_batch):
-                    # Clear gradients of inter-layer activations
-                    self.model.clear_activations_grads()
-                    # Copy input batch into activation[0] of the model
-                    copy_async(x_minibatch, self.model.activations[0].value)
-                    # Perform forward pass
-                    self.model.forward_async()
-                    # Copy true result into loss function
-                    copy_async(y_minibatch, self.loss.y)
-                    # Loss function shall be instatiated to read X from
-                    # activations[-1].value of the model and write gradient
-                    # into activations[-1].grad
-                    self.loss.calc_async()
-                    # Print value asynchronously
-                    #self.loss.val.print_scalar_async()
-                    # Now do the backward pass
-                    self.model.backward_async()
+                for x_minibatch, y_minibatch in minibatches:
+                    if self.capture_graph:
+                        self.minibatch_graph_async(x_minibatch, y_minibatch)
+                    else:
+                        self.minibatch_async(x_minibatch, y_minibatch)
                 # Apply optimizer after gradients for entire batch are
                 # accumulated
-                self.opt.step()
+                core_starpu.trace_push_scope("optimizer")
+                if self.grad_scaler is not None:
+                    self.grad_scaler.step(self.opt)
+                else:
+                    self.opt.step()
+                core_starpu.trace_pop_scope()
                 # Invalidate gradients of parameters
                 for p in self.model.parameters:
                     p.value.wont_use()
@@ -14,9 +14,12 @@
 
 from .nntile_core import tensor as core_tensor
 from .nntile_core.tensor import TensorTraits, Tensor_fp32, Tensor_fp64, \
-        Tensor_int64, Tensor_fp16, Tensor_bool
+        Tensor_int64, Tensor_fp16, Tensor_bf16, Tensor_bool, Tensor_int8
 from .nntile_core import TransOp, notrans, trans
+from .nntile_core import starpu as core_starpu
 from typing import Union, List
+import json
+import os
 
 # Multiprecision tensor as a union type for all precisions
 Tensor = Union[core_tensor.Tensor_fp32, core_tensor.Tensor_fp64]
@@ -47,6 +50,28 @@ class TensorMoments(object):
         if self.grad is not None:
             self.grad.unregister()
 
+    # Drop value and gradient, that are recomputed before their next use
+    def discard_submit(self):
+        if self.value is not None:
+            self.value.discard_submit()
+        if self.grad is not None:
+            self.grad.discard_submit()
+
+# Tensor moments with a row-sparse gradient. Rows of the value are indexed by
+# its last axis, as in a table of embeddings, and the gradient is zero outside
+# of the rows, marked in the rows tensor
+class RowSparseTensorMoments(TensorMoments):
+    rows: Tensor_bool
+
+    def __init__(self, value: TensorOrNone, grad: TensorOrNone,
+            grad_required: bool, rows: Tensor_bool):
+        super().__init__(value, grad, grad_required)
+        self.rows = rows
+
+    def unregister(self):
+        super().unregister()
+        self.rows.unregister()
+
 
 # Wrapper for multiprecision gemm
 def gemm_async(alpha: float, trans_A: TransOp, A: Tensor, trans_B: TransOp, \
@@ -63,6 +88,9 @@ def gemm_async(alpha: float, trans_A: TransOp, A: Tensor, trans_B: TransOp, \
     elif type(A) is core_tensor.Tensor_fp16:
         core_tensor.gemm_async_fp16(alpha, trans_A, A, trans_B, B, beta, C,
                 ndim, batch_ndim, redux)
+    elif type(A) is core_tensor.Tensor_bf16:
+        core_tensor.gemm_async_bf16(alpha, trans_A, A, trans_B, B, beta, C,
+                ndim, batch_ndim, redux)
     else:
         raise TypeError
 
@@ -149,6 +177,8 @@ def gelutanh_async(x: Tensor, y: Tensor) -> None:
         core_tensor.gelutanh_async_fp32(x, y)
     elif type(x) is core_tensor.Tensor_fp64:
         core_tensor.gelutanh_async_fp64(x, y)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.gelutanh_async_bf16(x, y)
     else:
         raise TypeError
 
@@ -316,6 +346,8 @@ def softmax_async(maxsumexp: Tensor, x: Tensor, alpha: float, y: Tensor, \
         core_tensor.softmax_async_fp32(maxsumexp, x, alpha, y, axis)
     elif type(x) is core_tensor.Tensor_fp64:
         core_tensor.softmax_async_fp64(maxsumexp, x, alpha, y, axis)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.softmax_async_bf16(maxsumexp, x, alpha, y, axis)
     else:
         raise TypeError
 
@@ -364,6 +396,8 @@ def prod_async(x: Tensor, y: Tensor) -> None:
         core_tensor.prod_async_fp32(x, y)
     elif type(x) is core_tensor.Tensor_fp64:
         core_tensor.prod_async_fp64(x, y)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.prod_async_bf16(x, y)
     else:
         raise TypeError
     
@@ -375,6 +409,8 @@ def add_async(alpha: float, x: Tensor, beta: float, y: Tensor) -> None:
         core_tensor.add_async_fp32(alpha, x, beta, y)
     elif type(x) is core_tensor.Tensor_fp64:
         core_tensor.add_async_fp64(alpha, x, beta, y)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.add_async_bf16(alpha, x, beta, y)
     else:
         raise TypeError
 
@@ -430,6 +466,8 @@ def maxsumexp_async(x: Tensor, maxsumexp: Tensor, axis: int, \
         core_tensor.maxsumexp_async_fp32(x, maxsumexp, axis, redux)
     elif type(x) is core_tensor.Tensor_fp64:
         core_tensor.maxsumexp_async_fp64(x, maxsumexp, axis, redux)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.maxsumexp_async_bf16(x, maxsumexp, axis, redux)
     else:
         raise TypeError
 
@@ -568,6 +606,12 @@ def clear_async(x: Tensor) -> None:
         core_tensor.clear_async_fp32(x)
     elif type(x) is core_tensor.Tensor_fp64:
         core_tensor.clear_async_fp64(x)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.clear_async_bf16(x)
+    elif type(x) is core_tensor.Tensor_bool:
+        core_tensor.clear_async_bool(x)
+    elif type(x) is core_tensor.Tensor_int64:
+        core_tensor.clear_async_int64(x)
     else:
         raise TypeError
 
@@ -738,6 +782,8 @@ def embedding_async(index: Tensor_int64, vocab: Tensor, embed: Tensor, \
         core_tensor.embedding_async_fp32(index, vocab, embed, axis)
     elif type(embed) is core_tensor.Tensor_fp64:
         core_tensor.embedding_async_fp64(index, vocab, embed, axis)
+    elif type(embed) is core_tensor.Tensor_bf16:
+        core_tensor.embedding_async_bf16(index, vocab, embed, axis)
     else:
         raise TypeError
 
@@ -809,6 +855,117 @@ def fused_adamw_step(p: Tensor, grad: Tensor, first_moment: Tensor, second_momen
     else:
         raise TypeError
 
+# Wrapper for multiprecision fused Adam step over many tensors, that packs
+# small tiles into a few tasks. All tensors must be of the same type.
+def fused_multi_adam_step(p: List[Tensor], grad: List[Tensor], \
+        first_moment: List[Tensor], second_moment: List[Tensor], lr: float, \
+        eps: float, beta1: float, beta2: float, weight_decay: float, \
+        num_iter: int, decoupled: bool=False, pack_nelems: int=65536) \
+        -> None:
+    if len(p) == 0:
+        return
+    for x in grad + p:
+        if type(x) is not type(p[0]):
+            raise TypeError
+    # Moments are either of the same type as parameters or in bf16 for fp32
+    # parameters
+    for x in first_moment + second_moment:
+        if type(x) is not type(first_moment[0]):
+            raise TypeError
+    if type(first_moment[0]) is core_tensor.Tensor_bf16:
+        if type(p[0]) is core_tensor.Tensor_fp32:
+            core_tensor.multi_adam_step_async_fp32_bf16(num_iter, beta1, \
+                    beta2, eps, lr, weight_decay, int(decoupled), grad, \
+                    first_moment, second_moment, p, pack_nelems)
+        else:
+            raise TypeError
+    elif type(first_moment[0]) is not type(p[0]):
+        raise TypeError
+    elif type(p[0]) is core_tensor.Tensor_fp32:
+        core_tensor.multi_adam_step_async_fp32(num_iter, beta1, beta2, eps, \
+                lr, weight_decay, int(decoupled), grad, first_moment, \
+                second_moment, p, pack_nelems)
+    elif type(p[0]) is core_tensor.Tensor_fp64:
+        core_tensor.multi_adam_step_async_fp64(num_iter, beta1, beta2, eps, \
+                lr, weight_decay, int(decoupled), grad, first_moment, \
+                second_moment, p, pack_nelems)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision unscaling of gradients with inf/NaN check
+def amp_unscale_async(inv_scale: float, x: Tensor, nonfinite: Tensor_bool) \
+        -> None:
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.amp_unscale_async_fp32(inv_scale, x, nonfinite)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.amp_unscale_async_fp64(inv_scale, x, nonfinite)
+    else:
+        raise TypeError
+
+# Check flags of amp_unscale_async on all MPI nodes
+def amp_nonfinite(nonfinite: Tensor_bool) -> bool:
+    return core_tensor.amp_nonfinite(nonfinite)
+
+# Wrapper for fused cross entropy loss and its gradient over logits
+def cross_entropy_fwd_bwd_async(scale: float, grad_scale: float, \
+        maxsumexp: Tensor, src: Tensor, labels: Tensor_int64, grad: Tensor, \
+        val: Tensor, redux: int=0, start: int=0) -> None:
+    if type(src) is core_tensor.Tensor_fp32:
+        core_tensor.cross_entropy_fwd_bwd_async_fp32(scale, grad_scale, \
+                maxsumexp, src, labels, grad, val, redux, start)
+    elif type(src) is core_tensor.Tensor_fp64:
+        core_tensor.cross_entropy_fwd_bwd_async_fp64(scale, grad_scale, \
+                maxsumexp, src, labels, grad, val, redux, start)
+    else:
+        raise TypeError
+
+# Wrapper for marking rows of embeddings, that are touched by tokens
+def embedding_rows_async(index: Tensor_int64, rows: Tensor_bool) -> None:
+    core_tensor.embedding_rows_async(index, rows)
+
+# Wrapper for multiprecision clear of marked rows
+def clear_rows_async(rows: Tensor_bool, x: Tensor) -> None:
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.clear_rows_async_fp32(rows, x)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.clear_rows_async_fp64(rows, x)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision lazy Adam step over marked rows
+def fused_sparse_adam_step(p: Tensor, grad: Tensor, first_moment: Tensor, \
+        second_moment: Tensor, rows: Tensor_bool, row_step: Tensor_int64, \
+        lr: float, eps: float, beta1: float, beta2: float, \
+        weight_decay: float, decoupled: bool=False) -> None:
+    if type(p) is not type(grad):
+        raise TypeError
+    if type(p) is not type(first_moment):
+        raise TypeError
+    if type(p) is not type(second_moment):
+        raise TypeError
+    if type(p) is core_tensor.Tensor_fp32:
+        core_tensor.sparse_adam_step_async_fp32(beta1, beta2, eps, lr, \
+                weight_decay, int(decoupled), rows, row_step, grad, \
+                first_moment, second_moment, p)
+    elif type(p) is core_tensor.Tensor_fp64:
+        core_tensor.sparse_adam_step_async_fp64(beta1, beta2, eps, lr, \
+                weight_decay, int(decoupled), rows, row_step, grad, \
+                first_moment, second_moment, p)
+    else:
+        raise TypeError
+
+# Wrapper for multiplication by int8 weights with dynamic quantization of x
+def gemm_int8_async(alpha: float, trans: TransOp, w: Tensor_int8, \
+        w_scale: Tensor, x: Tensor, beta: float, y: Tensor, ndim: int) \
+        -> None:
+    if type(x) is not type(y) or type(x) is not type(w_scale):
+        raise TypeError
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.gemm_int8_async_fp32(alpha, trans, w, w_scale, x, beta, \
+                y, ndim)
+    else:
+        raise TypeError
+
 # Wrapper for multiprecision transpose
 def transpose_async(alpha: float, src: Tensor, dst: Tensor, ndim: int) -> None:
     if type(src) is not type(dst):
@@ -820,3 +977,103 @@ def transpose_async(alpha: float, src: Tensor, dst: Tensor, ndim: int) -> None:
     else:
         raise TypeError
 
+
+def layer_norm_forward_async(eps: float, x: Tensor, gamma: Tensor, \
+        beta: Tensor, mean: Tensor, inv_stddev: Tensor, \
+        x_normalized: Tensor, y: Tensor, axis: int) -> None:
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.layer_norm_forward_async_fp32(eps, x, gamma, beta, mean, \
+                inv_stddev, x_normalized, y, axis)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.layer_norm_forward_async_fp64(eps, x, gamma, beta, mean, \
+                inv_stddev, x_normalized, y, axis)
+    else:
+        raise TypeError
+
+def layer_norm_backward_async(x_normalized: Tensor, dy: Tensor, \
+        gamma: Tensor, inv_stddev: Tensor, dx: Tensor, dgamma: Tensor, \
+        dbeta: Tensor, axis: int, redux: int=0) -> None:
+    if type(x_normalized) is core_tensor.Tensor_fp32:
+        core_tensor.layer_norm_backward_async_fp32(x_normalized, dy, gamma, \
+                inv_stddev, dx, dgamma, dbeta, axis, redux)
+    elif type(x_normalized) is core_tensor.Tensor_fp64:
+        core_tensor.layer_norm_backward_async_fp64(x_normalized, dy, gamma, \
+                inv_stddev, dx, dgamma, dbeta, axis, redux)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision save into a checkpoint file
+def save_async(x: TensorFloatOrInt, filename: str) -> None:
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.save_async_fp32(x, filename)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.save_async_fp64(x, filename)
+    elif type(x) is core_tensor.Tensor_int64:
+        core_tensor.save_async_int64(x, filename)
+    elif type(x) is core_tensor.Tensor_bool:
+        core_tensor.save_async_bool(x, filename)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.save_async_bf16(x, filename)
+    else:
+        raise TypeError
+
+def save(x: TensorFloatOrInt, filename: str) -> None:
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.save_fp32(x, filename)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.save_fp64(x, filename)
+    elif type(x) is core_tensor.Tensor_int64:
+        core_tensor.save_int64(x, filename)
+    elif type(x) is core_tensor.Tensor_bool:
+        core_tensor.save_bool(x, filename)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.save_bf16(x, filename)
+    else:
+        raise TypeError
+
+# Wrapper for multiprecision load from a checkpoint file
+def load_async(x: TensorFloatOrInt, filename: str) -> None:
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.load_async_fp32(x, filename)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.load_async_fp64(x, filename)
+    elif type(x) is core_tensor.Tensor_int64:
+        core_tensor.load_async_int64(x, filename)
+    elif type(x) is core_tensor.Tensor_bool:
+        core_tensor.load_async_bool(x, filename)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.load_async_bf16(x, filename)
+    else:
+        raise TypeError
+
+def load(x: TensorFloatOrInt, filename: str) -> None:
+    if type(x) is core_tensor.Tensor_fp32:
+        core_tensor.load_fp32(x, filename)
+    elif type(x) is core_tensor.Tensor_fp64:
+        core_tensor.load_fp64(x, filename)
+    elif type(x) is core_tensor.Tensor_int64:
+        core_tensor.load_int64(x, filename)
+    elif type(x) is core_tensor.Tensor_bool:
+        core_tensor.load_bool(x, filename)
+    elif type(x) is core_tensor.Tensor_bf16:
+        core_tensor.load_bf16(x, filename)
+    else:
+        raise TypeError
+
+# Finish a checkpoint directory, written by save_async, with a state file.
+# Waits for all the tile writes on all MPI nodes, so that the state file
+# appears only after the whole checkpoint is on disk. The root node writes
+# the state into a temporary file and renames it, so a partially written
+# state file is never observed.
+def save_checkpoint_state(path: str, state: dict) -> None:
+    core_starpu.wait_for_all()
+    core_starpu.mpi_barrier()
+    if core_starpu.mpi_rank() == 0:
+        filename = os.path.join(path, "state.json")
+        tmp_filename = filename + ".tmp"
+        with open(tmp_filename, "w") as fp:
+            json.dump(state, fp)
+            fp.flush()
+            os.fsync(fp.fileno())
+        os.replace(tmp_filename, filename)
+    core_starpu.mpi_barrier()
@@ -23,8 +23,9 @@ dtypes = [np.float32, np.float64]
 # Define mapping between numpy and nntile types
 Tensor = {np.float32: nntile.tensor.Tensor_fp32,
         np.float64: nntile.tensor.Tensor_fp64}
-# Get attention layer
+# Get attention layers
 Attention = nntile.layer.Attention
+FlashAttention = nntile.layer.FlashAttention
 # Get attention from PyTorch
 import torch
 from torch.nn import MultiheadAttention
@@ -257,10 +258,91 @@ def helper(dtype: np.dtype):
     layer.unregister()
     return True
 
+# Helper function checks incremental decoding with key-value cache against
+# a forward pass over the entire sequence with a causal mask
+def helper_kv_cache(dtype: np.dtype, layer_type=Attention):
+    n_emb = 64
+    n_seq = 16
+    n_seq_tile = 4
+    n_batch = 3
+    n_head = 4
+    n_head_tile = 2
+    next_tag = 0
+    # Full sequence with a causal mask
+    X_shape = [n_emb, n_seq, n_batch]
+    X_traits = nntile.tensor.TensorTraits(X_shape, [n_emb, n_seq_tile, \
+            n_batch])
+    X_distr = [0] * X_traits.grid.nelems
+    X_value = Tensor[dtype](X_traits, X_distr, next_tag)
+    next_tag = X_value.next_tag
+    X_grad = Tensor[dtype](X_traits, X_distr, next_tag)
+    next_tag = X_grad.next_tag
+    X = nntile.tensor.TensorMoments(X_value, X_grad, False)
+    mask_traits = nntile.tensor.TensorTraits([n_seq, n_seq], \
+            [n_seq_tile, n_seq_tile])
+    mask_distr = [0] * mask_traits.grid.nelems
+    mask = nntile.tensor.Tensor_bool(mask_traits, mask_distr, next_tag)
+    next_tag = mask.next_tag
+    mask.from_array(np.array(np.triu(np.ones((n_seq, n_seq))), dtype=bool, \
+            order='F'))
+    layer, next_tag = Attention.generate_simple(X, X, X, n_head, \
+            n_head_tile, next_tag, True, mask)
+    # Single new token against the cache
+    X_new_shape = [n_emb, 1, n_batch]
+    X_new_traits = nntile.tensor.TensorTraits(X_new_shape, X_new_shape)
+    X_new_value = Tensor[dtype](X_new_traits, [0], next_tag)
+    next_tag = X_new_value.next_tag
+    X_new_grad = Tensor[dtype](X_new_traits, [0], next_tag)
+    next_tag = X_new_grad.next_tag
+    X_new = nntile.tensor.TensorMoments(X_new_value, X_new_grad, False)
+    mask_new_traits = nntile.tensor.TensorTraits([n_seq, 1], [n_seq_tile, 1])
+    mask_new_distr = [0] * mask_new_traits.grid.nelems
+    mask_new = nntile.tensor.Tensor_bool(mask_new_traits, mask_new_distr, \
+            next_tag)
+    next_tag = mask_new.next_tag
+    layer_kv, next_tag = layer_type.generate_simple(X_new, X_new, X_new, \
+            n_head, n_head_tile, next_tag, True, mask_new, \
+            kv_cache_size=n_seq, kv_cache_size_tile=n_seq_tile)
+    # Set the same parameters for both layers
+    for p, p_kv in zip(layer.parameters, layer_kv.parameters):
+        np_p = np.array(np.random.randn(*p.value.shape), dtype=dtype, \
+                order='F')
+        p.value.from_array(np_p)
+        p_kv.value.from_array(np_p)
+    np_X = np.array(np.random.randn(*X_shape), dtype=dtype, order='F')
+    X_value.from_array(np_X)
+    layer.forward_async()
+    np_Y = np.zeros(X_shape, dtype=dtype, order='F')
+    layer.y.value.to_array(np_Y)
+    # Decode tokens one by one
+    layer_kv.reset_kv_cache_async()
+    np_Y_new = np.zeros(X_new_shape, dtype=dtype, order='F')
+    for pos in range(n_seq):
+        X_new_value.from_array(np.array(np_X[:, pos:pos+1, :], order='F'))
+        mask_new.from_array(np.array(np.arange(n_seq).reshape(-1, 1) <= pos, \
+                dtype=bool, order='F'))
+        layer_kv.set_kv_cache_position(pos)
+        layer_kv.forward_async()
+        layer_kv.y.value.to_array(np_Y_new)
+        norm = np.linalg.norm(np_Y[:, pos, :])
+        diff = np.linalg.norm(np_Y[:, pos, :] - np_Y_new[:, 0, :])
+        if diff > norm*1e-4:
+            return False
+    # Unregister
+    X.unregister()
+    X_new.unregister()
+    mask.unregister()
+    mask_new.unregister()
+    layer.unregister()
+    layer_kv.unregister()
+    return True
+
 # Test runner for different precisions
 def test():
     for dtype in dtypes:
         assert helper(dtype)
+        assert helper_kv_cache(dtype, Attention)
+        assert helper_kv_cache(dtype, FlashAttention)
 
 # Repeat tests
 def test_repeat():
@@ -28,13 +28,12 @@ import torch
 from torch.nn import LayerNorm
 
 # Helper function returns bool value true if test passes
-def helper(dtype: np.dtype):
-    # Describe single-tile tensor, located at node 0
-    A_shape = [20, 30]
+def helper(dtype: np.dtype, A_shape: list, A_basetile: list, redux: bool):
+    # Describe tensor, located at node 0
     ndim = len(A_shape)
     eps = 1e-5
-    A_traits = nntile.tensor.TensorTraits(A_shape, A_shape)
-    mpi_distr = [0]
+    A_traits = nntile.tensor.TensorTraits(A_shape, A_basetile)
+    mpi_distr = [0] * A_traits.grid.nelems
     next_tag = 0
     # Tensor objects
     A_value = Tensor[dtype](A_traits, mpi_distr, next_tag)
@@ -55,7 +54,7 @@ def helper(dtype: np.dtype):
     np_beta = np.array(rand_beta, dtype=dtype, order='F')
     # Init NNTile LayerNorm
     nntile_layer, next_tag = nntile.layer.LayerNorm.generate_simple(A, \
-            ndim-1, eps, next_tag)
+            ndim-1, eps, next_tag, redux=redux)
     nntile_layer.gamma.value.from_array(np_gamma)
     nntile_layer.beta.value.from_array(np_beta)
     # Init PyTorch LayerNorm
@@ -106,15 +105,24 @@ def helper(dtype: np.dtype):
     A.unregister()
     return True
 
+# Shapes and tiles of input with reduction flags. Fused kernels are used,
+# when the normalized axis is a single tile, and a sequence of operations is
+# used, when the normalized axis is split into several tiles.
+cases = [([20, 30], [20, 30], False),
+        ([4, 5, 30], [2, 3, 30], True),
+        ([4, 5, 30], [2, 3, 10], False)]
+
 # Test runner for different precisions
 def test():
     for dtype in dtypes:
-        assert helper(dtype)
+        for A_shape, A_basetile, redux in cases:
+            assert helper(dtype, A_shape, A_basetile, redux)
 
 # Repeat tests
 def test_repeat():
     for dtype in dtypes:
-        assert helper(dtype)
+        for A_shape, A_basetile, redux in cases:
+            assert helper(dtype, A_shape, A_basetile, redux)
 
 if __name__ == "__main__":
     test()
@@ -142,6 +142,39 @@ def helper_r(dtype: np.dtype):
     layer.unregister()
     return True
 
+# Helper function returns bool value true if test passes
+def helper_quantize(side: str):
+    # Describe multi-tile tensor, located at node 0
+    A_shape = [4, 5, 6]
+    A_basetile = [2, 3, 4]
+    A_traits = nntile.tensor.TensorTraits(A_shape, A_basetile)
+    mpi_distr = [0] * A_traits.grid.nelems
+    next_tag = 0
+    A = nntile.tensor.Tensor_fp32(A_traits, mpi_distr, next_tag)
+    next_tag = A.next_tag
+    A_moments = nntile.tensor.TensorMoments(A, None, False)
+    layer, next_tag = Linear.generate_simple(A_moments, side,
+            nntile.tensor.notrans, 2, [7], [3], next_tag, bias=True)
+    np_A = np.array(np.random.randn(*A_shape), dtype=np.float32, order='F')
+    np_W = np.array(np.random.randn(*layer.w.value.shape), dtype=np.float32,
+            order='F')
+    np_b = np.array(np.random.randn(7), dtype=np.float32, order='F')
+    A.from_array(np_A)
+    layer.w.value.from_array(np_W)
+    layer.b.value.from_array(np_b)
+    # Forward pass with int8 weights approximates the full precision one
+    next_tag = layer.quantize(next_tag)
+    layer.forward_async()
+    if side == 'L':
+        np_Y = np.tensordot(np_A, np_W, 2) + np_b
+    else:
+        np_Y = np.tensordot(np_W, np_A, 2) + np_b.reshape(7, 1)
+    np_Y2 = np.zeros_like(np_Y, order='F')
+    layer.y.value.to_array(np_Y2)
+    A_moments.unregister()
+    layer.unregister()
+    return np.linalg.norm(np_Y-np_Y2)/np.linalg.norm(np_Y) < 2e-2
+
 # Helper function returns bool value true if test passes
 def helper_l_fp32_fast_fp16():
     dtype = np.float32
@@ -482,6 +515,8 @@ def test():
     for dtype in dtypes:
         assert helper_l(dtype)
         assert helper_r(dtype)
+    assert helper_quantize('L')
+    assert helper_quantize('R')
     #assert helper_l_fp32_fast_fp16()
 
 # Repeat tests
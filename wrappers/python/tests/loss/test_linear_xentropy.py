@@ -0,0 +1,121 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/loss/test_linear_xentropy.py
+# Test for nntile.loss.LinearCrossEntropy
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2023-12-21
+
+# All necesary imports
+import nntile
+import numpy as np
+import scipy.special as spsp
+
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+# Define list of tested types
+dtypes = [np.float32, np.float64]
+# Define mapping between numpy and nntile types
+Tensor = {np.float32: nntile.tensor.Tensor_fp32,
+        np.float64: nntile.tensor.Tensor_fp64}
+# Get multiprecision loss function
+linear_cross_entropy = nntile.loss.LinearCrossEntropy
+
+# Helper function returns bool value true if test passes
+def helper(dtype: np.dtype, vocab_tile: int, nbuffers: int):
+    # Last chunk of classes is smaller than others for vocab_tile=4
+    vocab = 10
+    embed, embed_tile = 6, 4
+    seq, seq_tile = 5, 3
+    batch, batch_tile = 2, 1
+    scale = 0.5
+    next_tag = 0
+    x_traits = nntile.tensor.TensorTraits([embed, seq, batch], \
+            [embed_tile, seq_tile, batch_tile])
+    x_distr = [0] * x_traits.grid.nelems
+    x_value = Tensor[dtype](x_traits, x_distr, next_tag)
+    next_tag = x_value.next_tag
+    x_grad = Tensor[dtype](x_traits, x_distr, next_tag)
+    next_tag = x_grad.next_tag
+    x = nntile.tensor.TensorMoments(x_value, x_grad, True)
+    w_traits = nntile.tensor.TensorTraits([vocab, embed], \
+            [vocab_tile, embed_tile])
+    w_distr = [0] * w_traits.grid.nelems
+    w_value = Tensor[dtype](w_traits, w_distr, next_tag)
+    next_tag = w_value.next_tag
+    w_grad = Tensor[dtype](w_traits, w_distr, next_tag)
+    next_tag = w_grad.next_tag
+    w = nntile.tensor.TensorMoments(w_value, w_grad, True)
+    loss, next_tag = linear_cross_entropy.generate_simple(x, w, next_tag, \
+            nbuffers=nbuffers, scale=scale)
+    # Init data
+    np_x = np.array(np.random.randn(embed, seq, batch), dtype=dtype, \
+            order="F")
+    np_w = np.array(np.random.randn(vocab, embed), dtype=dtype, order="F")
+    np_labels = np.array(np.random.randint(0, vocab, (seq, batch)), \
+            dtype=np.int64, order="F")
+    x_value.from_array(np_x)
+    w_value.from_array(np_w)
+    loss.y.from_array(np_labels)
+    nntile.tensor.clear_async(x_grad)
+    nntile.tensor.clear_async(w_grad)
+    nntile.tensor.clear_async(loss.val)
+    loss.calc_async()
+    np_val = np.zeros((1,), dtype=dtype, order="F")
+    loss.get_val(np_val)
+    np_x_grad = np.zeros_like(np_x)
+    loss.get_grad(np_x_grad)
+    np_w_grad = np.zeros_like(np_w)
+    w_grad.to_array(np_w_grad)
+    loss.unregister()
+    x.unregister()
+    w.unregister()
+    # Reference values
+    np_logits = np.einsum("ve,esb->vsb", np_w, np_x)
+    lse = spsp.logsumexp(np_logits, axis=0)
+    np_label_logits = np.take_along_axis(np_logits, np_labels[None], \
+            axis=0)[0]
+    val_ref = scale * np.sum(lse-np_label_logits)
+    logits_grad = spsp.softmax(np_logits, axis=0)
+    np.put_along_axis(logits_grad, np_labels[None], \
+            np.take_along_axis(logits_grad, np_labels[None], axis=0)-1, \
+            axis=0)
+    logits_grad *= scale
+    x_grad_ref = np.einsum("ve,vsb->esb", np_w, logits_grad)
+    w_grad_ref = np.einsum("vsb,esb->ve", logits_grad, np_x)
+    if dtype == np.float32:
+        tol = 1e-5
+    elif dtype == np.float64:
+        tol = 1e-10
+    if np.abs(np_val[0]-val_ref) > tol*np.abs(val_ref):
+        return False
+    if np.linalg.norm(np_x_grad-x_grad_ref) \
+            > tol*np.linalg.norm(x_grad_ref):
+        return False
+    if np.linalg.norm(np_w_grad-w_grad_ref) \
+            > tol*np.linalg.norm(w_grad_ref):
+        return False
+    return True
+
+# Test runner for different precisions
+def test():
+    for dtype in dtypes:
+        assert helper(dtype, 10, 2)
+        assert helper(dtype, 4, 1)
+        assert helper(dtype, 3, 2)
+
+# Repeat tests
+def test_repeat():
+    for dtype in dtypes:
+        assert helper(dtype, 4, 2)
+
+if __name__ == "__main__":
+    test()
+    test_repeat()
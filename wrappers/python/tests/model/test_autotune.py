@@ -0,0 +1,113 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/model/test_autotune.py
+# Test for nntile.autotune on synthetic calibration data
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2023-12-21
+
+# All necesary imports
+import nntile
+from nntile.autotune import Calibration, GPT2TileTuner
+import numpy as np
+import os
+import tempfile
+
+# Synthetic timings: every task has an overhead and a fixed performance.
+# The smallest GEMM is treated as a pure overhead.
+overhead = 1e-5
+gemm_rate = 1e11
+elementwise_rate = 1e9
+
+def synthetic_calibration(gemm_sizes, elementwise_sizes):
+    calib = Calibration(4, gemm_sizes, elementwise_sizes)
+    for s in calib.gemm_sizes:
+        calib.gemm_times[s] = overhead + 2.0*s**3/gemm_rate
+    calib.gemm_times[calib.gemm_sizes[0]] = overhead
+    for s in calib.elementwise_sizes:
+        calib.elementwise_times[s] = overhead + s/elementwise_rate
+    calib.submit_time = 1e-6
+    return calib
+
+# Calibration reproduces the synthetic model of timings
+def helper_calibration():
+    calib = synthetic_calibration([32, 64, 128, 256], [1, 2**20])
+    for m, n, k in [(64, 64, 64), (100, 200, 300), (1024, 64, 512)]:
+        ref = overhead + 2.0*m*n*k/gemm_rate
+        if not np.isclose(calib.gemm_time(m, n, k), ref):
+            return False
+    for nelems in [1, 1000, 2**20, 2**22]:
+        ref = overhead + nelems/elementwise_rate
+        if not np.isclose(calib.elementwise_time(nelems), ref):
+            return False
+    # Timings survive saving and loading
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        path = os.path.join(tmp_dir, "calibration.json")
+        calib.save(path)
+        calib2 = Calibration.load(path)
+    if calib2.gemm_times != calib.gemm_times \
+            or calib2.elementwise_times != calib.elementwise_times:
+        return False
+    return True
+
+# A single size is scaled proportionally to the amount of work
+def helper_single_size():
+    calib = Calibration(4, [64], [1024])
+    calib.gemm_times[64] = 2.0*64**3/gemm_rate
+    calib.elementwise_times[1024] = 1024/elementwise_rate
+    if not np.isclose(calib.gemm_time(128, 128, 128), \
+            2.0*128**3/gemm_rate):
+        return False
+    if not np.isclose(calib.elementwise_time(4096), 4096/elementwise_rate):
+        return False
+    # Empty or non-positive sizes are rejected
+    for gemm_sizes, elementwise_sizes in [([], [1]), ([64], []), \
+            ([0, 64], [1])]:
+        try:
+            Calibration(4, gemm_sizes, elementwise_sizes)
+            return False
+        except ValueError:
+            pass
+    return True
+
+# Tuner recommends tiles, that divide dimensions, and respects memory budget
+def helper_tuner():
+    calib = synthetic_calibration([32, 64, 128, 256], [1, 2**20])
+    config = nntile.model.GPT2Config(1024, 256, 256, 256, 128, 1024, 1024, \
+            1e-5, 2, 8, 8, "gelutanh", False)
+    tuner = GPT2TileTuner(config, 128, 4)
+    results = tuner.rank(calib)
+    if len(results) == 0:
+        return False
+    times = [r["time"] for r in results]
+    if times != sorted(times):
+        return False
+    best = tuner.recommend(calib)
+    if 128 % best["tiles"]["seq_tile"] != 0 \
+            or 256 % best["tiles"]["embd_tile"] != 0 \
+            or 1024 % best["tiles"]["inner_tile"] != 0:
+        return False
+    budget = min(r["memory"] for r in results)
+    best = tuner.recommend(calib, budget)
+    if best["memory"] > budget:
+        return False
+    try:
+        tuner.recommend(calib, tuner.fixed_memory()-1)
+        return False
+    except ValueError:
+        pass
+    return True
+
+# Test runner
+def test():
+    assert helper_calibration()
+    assert helper_single_size()
+    assert helper_tuner()
+
+if __name__ == "__main__":
+    test()
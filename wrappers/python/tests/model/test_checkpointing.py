@@ -0,0 +1,163 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/model/test_checkpointing.py
+# Test for activation checkpointing of BaseModel
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2023-12-21
+
+# All necesary imports
+import nntile
+import numpy as np
+from nntile.layer.add import Add
+
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+
+# Run forward and backward passes and get gradients of all parameters
+def get_grads(model, np_y_grad):
+    model.clear_gradients()
+    model.forward_async()
+    model.activations[-1].grad.from_array(np_y_grad)
+    model.backward_async()
+    grads = []
+    for p in model.parameters:
+        np_grad = np.zeros(p.grad.shape, dtype=np.float32, order='F')
+        p.grad.to_array(np_grad)
+        grads.append(np_grad)
+    return grads
+
+# Helper function returns bool value true if test passes
+def helper(num_segments):
+    # Describe input tensor with several tiles along batch dimension
+    x_shape = [5, 12]
+    x_basetile = [5, 4]
+    next_tag = 0
+    x_traits = nntile.tensor.TensorTraits(x_shape, x_basetile)
+    x_distr = [0] * x_traits.grid.nelems
+    x = nntile.tensor.Tensor_fp32(x_traits, x_distr, next_tag)
+    next_tag = x.next_tag
+    x_moments = nntile.tensor.TensorMoments(x, None, False)
+    np_x = np.array(np.random.randn(*x_shape), dtype=np.float32, order='F')
+    x.from_array(np_x)
+    # Deep ReLU model with 9 layers
+    model = nntile.model.DeepReLU(x_moments, 'R', 1, 8, 4, 5, 3, next_tag,
+            bias=True)
+    next_tag = model.next_tag
+    model.init_randn_async()
+    y_shape = model.activations[-1].value.shape
+    np_y_grad = np.array(np.random.randn(*y_shape), dtype=np.float32,
+            order='F')
+    # Reference gradients without checkpointing
+    grads_ref = get_grads(model, np_y_grad)
+    # Gradients with checkpointing. Run twice to check that dropped data is
+    # properly recomputed on every iteration.
+    model.enable_checkpointing(num_segments)
+    grads = get_grads(model, np_y_grad)
+    grads2 = get_grads(model, np_y_grad)
+    # Output of the model is kept
+    np_y = np.zeros(y_shape, dtype=np.float32, order='F')
+    model.activations[-1].value.to_array(np_y)
+    model.disable_checkpointing()
+    np_y_ref = np.zeros(y_shape, dtype=np.float32, order='F')
+    model.forward_async()
+    model.activations[-1].value.to_array(np_y_ref)
+    nntile.starpu.wait_for_all()
+    model.unregister()
+    if (np_y != np_y_ref).any():
+        return False
+    for g_ref, g, g2 in zip(grads_ref, grads, grads2):
+        if not np.allclose(g, g_ref, rtol=1e-5, atol=1e-6):
+            return False
+        if (g != g2).any():
+            return False
+    return True
+
+# Helper function for a small GPT2 block, that has layers with temporaries
+# (layer normalization and attention) and a residual connection, that crosses
+# boundaries of segments
+def helper_gpt2_block(num_segments):
+    n_emb = 16
+    n_seq = 8
+    n_seq_tile = 4
+    n_batch = 3
+    n_head = 4
+    next_tag = 0
+    x_traits = nntile.tensor.TensorTraits([n_emb, n_seq, n_batch], \
+            [n_emb, n_seq_tile, n_batch])
+    x_distr = [0] * x_traits.grid.nelems
+    x = nntile.tensor.Tensor_fp32(x_traits, x_distr, next_tag)
+    next_tag = x.next_tag
+    x_moments = nntile.tensor.TensorMoments(x, None, False)
+    np_x = np.array(np.random.randn(*x.shape), dtype=np.float32, order='F')
+    x.from_array(np_x)
+    mask_traits = nntile.tensor.TensorTraits([n_seq, n_seq], \
+            [n_seq_tile, n_seq_tile])
+    mask_distr = [0] * mask_traits.grid.nelems
+    mask = nntile.tensor.Tensor_bool(mask_traits, mask_distr, next_tag)
+    next_tag = mask.next_tag
+    mask.from_array(np.array(np.triu(np.ones((n_seq, n_seq))), dtype=bool, \
+            order='F'))
+    # Input projection, pre-normalized attention with a residual connection
+    # and output projection
+    proj_in, next_tag = nntile.layer.Linear.generate_simple(x_moments, 'R', \
+            nntile.tensor.notrans, 1, [n_emb], [n_emb], next_tag)
+    h0 = proj_in.activations_output[0]
+    ln, next_tag = nntile.layer.LayerNorm.generate_simple(h0, 0, 1e-5, \
+            next_tag)
+    h1 = ln.activations_output[0]
+    attn, next_tag = nntile.layer.Attention.generate_simple(h1, h1, h1, \
+            n_head, n_head, next_tag, True, mask)
+    h2 = attn.activations_output[0]
+    residual, next_tag = Add.generate_simple(h0, h2, next_tag)
+    h3 = residual.activations_output[0]
+    ln_out, next_tag = nntile.layer.LayerNorm.generate_simple(h3, 0, 1e-5, \
+            next_tag)
+    h4 = ln_out.activations_output[0]
+    proj_out, next_tag = nntile.layer.Linear.generate_simple(h4, 'R', \
+            nntile.tensor.notrans, 1, [n_emb], [n_emb], next_tag)
+    y = proj_out.activations_output[0]
+    model = nntile.model.BaseModel([x_moments, h0, h1, h2, h3, h4, y], \
+            [proj_in, ln, attn, residual, ln_out, proj_out])
+    for p in model.parameters:
+        np_p = np.array(np.random.randn(*p.value.shape), dtype=np.float32, \
+                order='F')
+        p.value.from_array(np_p)
+    np_y_grad = np.array(np.random.randn(*y.value.shape), dtype=np.float32, \
+            order='F')
+    # Reference gradients without checkpointing
+    grads_ref = get_grads(model, np_y_grad)
+    # Gradients with checkpointing, that recomputes normalization and
+    # attention temporaries
+    model.enable_checkpointing(num_segments)
+    grads = get_grads(model, np_y_grad)
+    grads2 = get_grads(model, np_y_grad)
+    model.disable_checkpointing()
+    nntile.starpu.wait_for_all()
+    model.unregister()
+    mask.unregister()
+    for g_ref, g, g2 in zip(grads_ref, grads, grads2):
+        if not np.allclose(g, g_ref, rtol=1e-4, atol=1e-5):
+            return False
+        if not np.allclose(g2, g_ref, rtol=1e-4, atol=1e-5):
+            return False
+    return True
+
+# Test runner
+def test():
+    assert helper(None)
+    assert helper(1)
+    assert helper(4)
+    assert helper_gpt2_block(None)
+    assert helper_gpt2_block(2)
+    assert helper_gpt2_block(6)
+
+if __name__ == "__main__":
+    test()
@@ -0,0 +1,74 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/model/test_dataloader.py
+# Test for nntile.dataloader.TokenFileLoader on a small file of tokens
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2023-12-21
+
+# All necesary imports
+import nntile
+from nntile.dataloader import TokenFileLoader
+import numpy as np
+import os
+import tempfile
+
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+
+# Helper function returns bool value true if test passes
+def helper(num_batches: int, nbuffers: int):
+    seq_len = 4
+    minibatch = 3
+    num_minibatch = 2
+    chunk = minibatch * (seq_len+1)
+    # File holds one full batch and a part of the next one
+    ntokens = chunk*num_minibatch + 7
+    tokens = np.arange(ntokens, dtype=np.uint16)
+    result = True
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        path = os.path.join(tmp_dir, "tokens.bin")
+        tokens.tofile(path)
+        loader = TokenFileLoader(path, seq_len, minibatch, num_minibatch, \
+                2, 2, 0, num_batches=num_batches, nbuffers=nbuffers)
+        if num_batches == -1 and len(loader) != 1:
+            result = False
+        x = np.zeros((seq_len, minibatch), dtype=np.int64, order="F")
+        y = np.zeros_like(x)
+        # Two epochs must read the same tokens
+        for epoch in range(2):
+            loader.start_epoch()
+            i = 0
+            for batch in loader:
+                for x_tensor, y_tensor in batch:
+                    x_tensor.to_array(x)
+                    y_tensor.to_array(y)
+                    # Tokens are read cyclically
+                    ref = tokens[np.arange(i*chunk, (i+1)*chunk) \
+                            % ntokens].reshape(minibatch, seq_len+1)
+                    if not np.array_equal(x, ref[:, :-1].T) \
+                            or not np.array_equal(y, ref[:, 1:].T):
+                        result = False
+                    i += 1
+            if i != len(loader)*num_minibatch:
+                result = False
+        loader.unregister()
+    return result
+
+# Test runner
+def test():
+    # Batches of a file
+    assert helper(-1, 2)
+    # Wrap around the end of the file with different number of buffers
+    assert helper(4, 1)
+    assert helper(4, 3)
+
+if __name__ == "__main__":
+    test()
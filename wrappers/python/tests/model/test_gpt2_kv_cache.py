@@ -0,0 +1,87 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/model/test_gpt2_kv_cache.py
+# Test for incremental decoding of GPT2 with key-value cache
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2023-12-21
+
+# All necesary imports
+import nntile
+import numpy as np
+import torch
+import torch.nn as nn
+from transformers import GPT2LMHeadModel, GPT2Config
+from nntile.model.gpt2 import GPT2Config as GPT2Config_nntile, \
+        GPT2Model as GPT2Model_nntile
+
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+
+# Helper function returns bool value true if test passes
+def helper(flashattention: bool):
+    n_seq = 16
+    n_seq_tile = 4
+    n_batch = 2
+    torch_config = GPT2Config(vocab_size=64, n_positions=n_seq, n_embd=32, \
+            n_layer=2, n_head=4, n_inner=64, activation_function="gelu_new", \
+            attn_pdrop=0, embd_pdrop=0, resid_pdrop=0)
+    torch.manual_seed(0)
+    model_torch = GPT2LMHeadModel(torch_config)
+    model_torch.lm_head.weight = nn.Parameter(model_torch.lm_head \
+            .weight.detach().clone())
+    next_tag = 0
+    # Reference model processes the whole sequence without any cache
+    config_full = GPT2Config_nntile(torch_config.vocab_size, 32, 32, 32, \
+            n_seq, 64, 64, torch_config.layer_norm_epsilon, 2, 4, 4, \
+            "gelutanh", False)
+    model_full, next_tag = GPT2Model_nntile.from_torch(model_torch, n_batch, \
+            n_batch, n_seq, n_seq_tile, config_full, next_tag)
+    # Model for incremental decoding processes a single token at a time
+    config_kv = GPT2Config_nntile(torch_config.vocab_size, 32, 32, 32, \
+            n_seq, 64, 64, torch_config.layer_norm_epsilon, 2, 4, 4, \
+            "gelutanh", flashattention)
+    model_kv, next_tag = GPT2Model_nntile.from_torch(model_torch, n_batch, \
+            n_batch, 1, 1, config_kv, next_tag, kv_cache_size=n_seq, \
+            kv_cache_size_tile=n_seq_tile)
+    np_x = np.array(np.random.randint(torch_config.vocab_size, \
+            size=(n_seq, n_batch)), dtype=np.int64, order='F')
+    model_full.activations[0].value.from_array(np_x)
+    model_full.forward_async()
+    np_y = np.zeros(model_full.activations[-1].value.shape, \
+            dtype=np.float32, order='F')
+    model_full.activations[-1].value.to_array(np_y)
+    # Decode tokens one by one and compare logits of every position
+    model_kv.reset_kv_cache_async()
+    np_y_kv = np.zeros(model_kv.activations[-1].value.shape, \
+            dtype=np.float32, order='F')
+    result = True
+    for pos in range(n_seq):
+        model_kv.activations[0].value.from_array(np.array(np_x[pos:pos+1, \
+                :], order='F'))
+        model_kv.forward_kv_cache_async(pos)
+        model_kv.activations[-1].value.to_array(np_y_kv)
+        norm = np.linalg.norm(np_y[:, pos, :])
+        diff = np.linalg.norm(np_y[:, pos, :] - np_y_kv[:, 0, :])
+        if diff > norm*1e-4:
+            result = False
+            break
+    # Unregister
+    model_full.unregister()
+    model_kv.unregister()
+    return result
+
+# Test runner for both attention layers
+def test():
+    assert helper(False)
+    assert helper(True)
+
+if __name__ == "__main__":
+    test()
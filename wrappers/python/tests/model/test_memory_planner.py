@@ -0,0 +1,92 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/model/test_memory_planner.py
+# Test for static memory planner of activations and temporaries
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2023-12-21
+
+# All necesary imports
+import nntile
+import numpy as np
+
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+
+# Run forward and backward passes and get output and gradients of parameters
+def run(model, np_y_grad):
+    model.clear_gradients()
+    model.forward_async()
+    y_shape = model.activations[-1].value.shape
+    np_y = np.zeros(y_shape, dtype=np.float32, order='F')
+    model.activations[-1].value.to_array(np_y)
+    model.activations[-1].grad.from_array(np_y_grad)
+    model.backward_async()
+    grads = []
+    for p in model.parameters:
+        np_grad = np.zeros(p.grad.shape, dtype=np.float32, order='F')
+        p.grad.to_array(np_grad)
+        grads.append(np_grad)
+    return np_y, grads
+
+# Helper function returns bool value true if test passes
+def helper():
+    # Describe input tensor with several tiles along batch dimension
+    x_shape = [5, 12]
+    x_basetile = [5, 4]
+    next_tag = 0
+    x_traits = nntile.tensor.TensorTraits(x_shape, x_basetile)
+    x_distr = [0] * x_traits.grid.nelems
+    x = nntile.tensor.Tensor_fp32(x_traits, x_distr, next_tag)
+    next_tag = x.next_tag
+    x_moments = nntile.tensor.TensorMoments(x, None, False)
+    np_x = np.array(np.random.randn(*x_shape), dtype=np.float32, order='F')
+    x.from_array(np_x)
+    # Deep ReLU model with 11 layers
+    model = nntile.model.DeepReLU(x_moments, 'R', 1, 8, 4, 6, 3, next_tag,
+            bias=True)
+    next_tag = model.next_tag
+    model.init_randn_async()
+    y_shape = model.activations[-1].value.shape
+    np_y_grad = np.array(np.random.randn(*y_shape), dtype=np.float32,
+            order='F')
+    # Reference output and gradients without planning
+    np_y_ref, grads_ref = run(model, np_y_grad)
+    # Inference plan is not applied, it only predicts memory
+    plan = nntile.model.MemoryPlan(model, training=False)
+    inference_nbytes = plan.planned_nbytes()[0]
+    # Apply training plan and run twice to check that shared buffers do not
+    # leak values between iterations
+    next_tag = model.plan_memory(next_tag)
+    plan = model.memory_plan
+    naive_nbytes = plan.naive_nbytes()[0]
+    planned_nbytes = plan.planned_nbytes()[0]
+    np_y, grads = run(model, np_y_grad)
+    np_y2, grads2 = run(model, np_y_grad)
+    nntile.starpu.wait_for_all()
+    model.unregister()
+    # Activations of a deep model shall share storage
+    if planned_nbytes >= naive_nbytes or inference_nbytes > planned_nbytes:
+        return False
+    if (np_y != np_y_ref).any() or (np_y2 != np_y_ref).any():
+        return False
+    for g_ref, g, g2 in zip(grads_ref, grads, grads2):
+        if not np.allclose(g, g_ref, rtol=1e-5, atol=1e-6):
+            return False
+        if (g != g2).any():
+            return False
+    return True
+
+# Test runner
+def test():
+    assert helper()
+
+if __name__ == "__main__":
+    test()
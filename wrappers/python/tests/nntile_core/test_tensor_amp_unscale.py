@@ -0,0 +1,94 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_tensor_amp_unscale.py
+# Test for tensor::amp_unscale<T> Python wrapper and dynamic loss scaling
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2023-12-19
+
+# All necesary imports
+import nntile
+import numpy as np
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+# Define list of tested types
+dtypes = [np.float32, np.float64]
+# Define mapping between numpy and nntile types
+Tensor = {np.float32: nntile.tensor.Tensor_fp32,
+        np.float64: nntile.tensor.Tensor_fp64}
+
+# Optimizer, that only counts its steps
+class CountingOptimizer:
+    def __init__(self):
+        self.num_steps = 0
+
+    def step(self):
+        self.num_steps += 1
+
+# Helper function returns bool value true if test passes
+def helper(dtype):
+    # Describe multi-tile tensor, located at node 0
+    shape = [4, 6]
+    basetile = [2, 3]
+    mpi_distr = [0] * 4
+    next_tag = 0
+    traits = nntile.tensor.TensorTraits(shape, basetile)
+    A = Tensor[dtype](traits, mpi_distr, next_tag)
+    next_tag = A.next_tag
+    params = [nntile.tensor.TensorMoments(None, A, True)]
+    scaler = nntile.amp.GradScaler(params, next_tag, init_scale=1024.0, \
+            growth_interval=2)
+    next_tag = scaler.get_next_tag()
+    opt = CountingOptimizer()
+    # Finite gradients are unscaled and optimizer is applied
+    np_A = np.array(np.random.randn(*shape), dtype=dtype, order='F')
+    A.from_array(1024 * np_A)
+    if not scaler.step(opt) or opt.num_steps != 1:
+        return False
+    np_res = np.zeros_like(np_A)
+    A.to_array(np_res)
+    if (np_res != np_A).any():
+        return False
+    # Scale grows after growth_interval steps in a row
+    if not scaler.step(opt) or scaler.scale != 2048.0:
+        return False
+    # Overflow in a single tile skips the step and reduces scale
+    np_A[3, 5] = np.inf
+    A.from_array(np_A)
+    if scaler.step(opt) or opt.num_steps != 2 or scaler.scale != 1024.0:
+        return False
+    np_A[3, 5] = 1.0
+    np_A[0, 0] = np.nan
+    A.from_array(np_A)
+    if scaler.step(opt) or scaler.scale != 512.0:
+        return False
+    # Flag is cleared before every check
+    np_A[0, 0] = 1.0
+    A.from_array(np_A)
+    if not scaler.step(opt) or opt.num_steps != 3:
+        return False
+    nntile.starpu.wait_for_all()
+    scaler.unregister()
+    A.unregister()
+    return True
+
+# Test runner for different precisions
+def test():
+    for dtype in dtypes:
+        assert helper(dtype)
+
+# Repeat tests
+def test_repeat():
+    for dtype in dtypes:
+        assert helper(dtype)
+
+if __name__ == "__main__":
+    test()
+    test_repeat()
@@ -0,0 +1,80 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_tensor_bf16.py
+# Test for Tensor_bf16 and operations on it
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2023-12-18
+
+# All necesary imports
+import nntile
+import numpy as np
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+# Restrict computations to CPU, as bf16 has only CPU kernels
+nntile.starpu.restrict_cpu()
+
+# Round single precision array to nearest even bfloat16 value
+def round_bf16(x):
+    bits = np.array(x, dtype=np.float32, order='F').view(np.uint32)
+    bits = bits + np.uint32(0x7fff) + ((bits >> 16) & np.uint32(1))
+    bits &= np.uint32(0xffff0000)
+    return bits.view(np.float32)
+
+# Helper function returns bool value true if test passes
+def helper():
+    # Describe tensors with several tiles, located at node 0
+    shape = [4, 6]
+    basetile = [2, 3]
+    mpi_distr = [0] * 4
+    next_tag = 0
+    traits = nntile.tensor.TensorTraits(shape, basetile)
+    A = nntile.tensor.Tensor_bf16(traits, mpi_distr, next_tag)
+    next_tag = A.next_tag
+    B = nntile.tensor.Tensor_bf16(traits, mpi_distr, next_tag)
+    next_tag = B.next_tag
+    C_traits = nntile.tensor.TensorTraits([4, 4], [2, 2])
+    C = nntile.tensor.Tensor_bf16(C_traits, mpi_distr, next_tag)
+    # Values are exchanged through single precision arrays
+    np_A = np.array(np.random.randn(*shape), dtype=np.float32, order='F')
+    np_B = np.array(np.random.randn(*shape), dtype=np.float32, order='F')
+    A.from_array(np_A)
+    B.from_array(np_B)
+    np_A_bf16 = np.zeros(shape, dtype=np.float32, order='F')
+    A.to_array(np_A_bf16)
+    if (np_A_bf16 != round_bf16(np_A)).any():
+        return False
+    np_A = np_A_bf16
+    np_B = round_bf16(np_B)
+    # Add is computed in single precision and rounded once
+    nntile.tensor.add_async(2.0, A, -0.5, B)
+    np_res = np.zeros(shape, dtype=np.float32, order='F')
+    B.to_array(np_res)
+    if (np_res != round_bf16(np.float32(2.0)*np_A \
+            - np.float32(0.5)*np_B)).any():
+        return False
+    # Gemm accumulates in single precision
+    nntile.tensor.gemm_async(1.0, nntile.notrans, A, nntile.trans, A, 0.0, C,
+            1, 0)
+    np_C = np.zeros([4, 4], dtype=np.float32, order='F')
+    C.to_array(np_C)
+    np_C_ref = np_A @ np_A.T
+    nntile.starpu.wait_for_all()
+    A.unregister()
+    B.unregister()
+    C.unregister()
+    return np.allclose(np_C, np_C_ref, rtol=1e-2, atol=1e-2)
+
+# Test runner
+def test():
+    assert helper()
+
+if __name__ == "__main__":
+    test()
@@ -0,0 +1,122 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_tensor_cross_entropy_fwd_bwd.py
+# Test for tensor::cross_entropy_fwd_bwd<T> Python wrapper
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2023-12-21
+
+# All necesary imports
+import nntile
+import numpy as np
+import scipy.special as spsp
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+# Define list of tested types
+dtypes = [np.float32, np.float64]
+# Define mapping between numpy and nntile types
+Tensor = {np.float32: nntile.tensor.Tensor_fp32,
+        np.float64: nntile.tensor.Tensor_fp64}
+
+# Helper function returns bool value true if test passes
+def helper(dtype, redux, per_node):
+    # Logits are split into tiles along classes and outputs
+    shape = [10, 3, 4]
+    basetile = [4, 2, 3]
+    scale = 0.5
+    grad_scale = 3.0
+    next_tag = 0
+    traits = nntile.tensor.TensorTraits(shape, basetile)
+    mpi_size = nntile.starpu.mpi_size()
+    # Tiles of gradient of all nodes update partial loss values of their
+    # nodes, while a scalar loss value requires all tiles on its node
+    if per_node:
+        mpi_distr = [i % mpi_size for i in range(traits.grid.nelems)]
+        val_traits = nntile.tensor.TensorTraits([mpi_size], [1])
+        val_distr = list(range(mpi_size))
+    else:
+        mpi_distr = [0] * traits.grid.nelems
+        val_traits = nntile.tensor.TensorTraits([], [])
+        val_distr = [0]
+    src = Tensor[dtype](traits, mpi_distr, next_tag)
+    next_tag = src.next_tag
+    grad = Tensor[dtype](traits, mpi_distr, next_tag)
+    next_tag = grad.next_tag
+    labels_traits = nntile.tensor.TensorTraits(shape[1:], basetile[1:])
+    labels_distr = [0] * labels_traits.grid.nelems
+    labels = nntile.tensor.Tensor_int64(labels_traits, labels_distr, \
+            next_tag)
+    next_tag = labels.next_tag
+    maxsumexp_traits = nntile.tensor.TensorTraits([2]+shape[1:], \
+            [2]+basetile[1:])
+    maxsumexp = Tensor[dtype](maxsumexp_traits, labels_distr, next_tag)
+    next_tag = maxsumexp.next_tag
+    val = Tensor[dtype](val_traits, val_distr, next_tag)
+    next_tag = val.next_tag
+    val.set_reduction_add()
+    maxsumexp.set_reduction_maxsumexp()
+    # Init data
+    np_src = np.array(np.random.randn(*shape), dtype=dtype, order='F')
+    np_labels = np.array(np.random.randint(0, shape[0], shape[1:]), \
+            dtype=np.int64, order='F')
+    src.from_array(np_src)
+    labels.from_array(np_labels)
+    nntile.tensor.clear_async(maxsumexp)
+    nntile.tensor.clear_async(val)
+    nntile.tensor.maxsumexp_async(src, maxsumexp, 0, redux=redux)
+    nntile.tensor.cross_entropy_fwd_bwd_async(scale, grad_scale, maxsumexp, \
+            src, labels, grad, val, redux=redux)
+    np_grad = np.zeros_like(np_src)
+    grad.to_array(np_grad)
+    np_val = np.zeros((len(val_distr),), dtype=dtype, order='F')
+    val.to_array(np_val)
+    np_val = np.array([np.sum(np_val)], dtype=dtype)
+    nntile.starpu.wait_for_all()
+    src.unregister()
+    grad.unregister()
+    labels.unregister()
+    maxsumexp.unregister()
+    val.unregister()
+    # Reference values
+    lse = spsp.logsumexp(np_src, axis=0)
+    np_label_src = np.take_along_axis(np_src, np_labels[None], axis=0)[0]
+    val_ref = scale * np.sum(lse-np_label_src)
+    grad_ref = spsp.softmax(np_src, axis=0)
+    np.put_along_axis(grad_ref, np_labels[None], \
+            np.take_along_axis(grad_ref, np_labels[None], axis=0)-1, axis=0)
+    grad_ref *= grad_scale
+    if dtype == np.float32:
+        tol = 1e-5
+    else:
+        tol = 1e-10
+    if np.max(np.abs(np_grad-grad_ref)) > tol:
+        return False
+    if np.abs(np_val[0]-val_ref) > tol*np.abs(val_ref):
+        return False
+    return True
+
+# Test runner for different precisions
+def test():
+    for dtype in dtypes:
+        for per_node in [False, True]:
+            assert helper(dtype, 0, per_node)
+            assert helper(dtype, 1, per_node)
+
+# Repeat tests
+def test_repeat():
+    for dtype in dtypes:
+        for per_node in [False, True]:
+            assert helper(dtype, 0, per_node)
+            assert helper(dtype, 1, per_node)
+
+if __name__ == "__main__":
+    test()
+    test_repeat()
+
@@ -0,0 +1,159 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_tensor_multi_adam_step.py
+# Test for tensor::multi_adam_step<T> Python wrapper
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2023-12-21
+
+# All necesary imports
+import nntile
+import numpy as np
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+# Define list of tested types
+dtypes = [np.float32, np.float64]
+# Define mapping between numpy and nntile types
+Tensor = {np.float32: nntile.tensor.Tensor_fp32,
+        np.float64: nntile.tensor.Tensor_fp64}
+
+# Helper function returns bool value true if test passes
+def helper(dtype, decoupled, pack_nelems):
+    # Parameters of different shapes with tiny and large tiles
+    shapes = [[7], [5, 6], [20, 3], [1]]
+    basetiles = [[2], [5, 2], [20, 3], [1]]
+    nsteps = 3
+    lr, eps, beta1, beta2, weight_decay = 1e-2, 1e-8, 0.9, 0.999, 0.1
+    next_tag = 0
+    # Packed step is applied to tensors[0], per-tensor step to tensors[1]
+    tensors = [[], []]
+    for shape, basetile in zip(shapes, basetiles):
+        traits = nntile.tensor.TensorTraits(shape, basetile)
+        distr = [0] * traits.grid.nelems
+        np_p = np.array(np.random.randn(*shape), dtype=dtype, order='F')
+        for k in range(2):
+            ts = []
+            for i in range(4):
+                ts.append(Tensor[dtype](traits, distr, next_tag))
+                next_tag = ts[-1].next_tag
+            ts[3].from_array(np_p)
+            tensors[k].append(ts)
+    for num_iter in range(1, nsteps+1):
+        for j, shape in enumerate(shapes):
+            np_grad = np.array(np.random.randn(*shape), dtype=dtype, \
+                    order='F')
+            tensors[0][j][0].from_array(np_grad)
+            tensors[1][j][0].from_array(np_grad)
+        grad, first, second, p = [[ts[i] for ts in tensors[0]] \
+                for i in range(4)]
+        nntile.tensor.fused_multi_adam_step(p, grad, first, second, lr, \
+                eps, beta1, beta2, weight_decay, num_iter, \
+                decoupled=decoupled, pack_nelems=pack_nelems)
+        for ts in tensors[1]:
+            if decoupled:
+                nntile.tensor.fused_adamw_step(ts[3], ts[0], ts[1], ts[2], \
+                        lr, eps, beta1, beta2, weight_decay, num_iter)
+            else:
+                nntile.tensor.fused_adam_step(ts[3], ts[0], ts[1], ts[2], \
+                        lr, eps, beta1, beta2, weight_decay, num_iter)
+    if dtype == np.float32:
+        tol = 1e-5
+    else:
+        tol = 1e-10
+    result = True
+    for j, shape in enumerate(shapes):
+        for i in range(1, 4):
+            np_val = np.zeros(shape, dtype=dtype, order='F')
+            np_ref = np.zeros(shape, dtype=dtype, order='F')
+            tensors[0][j][i].to_array(np_val)
+            tensors[1][j][i].to_array(np_ref)
+            if np.linalg.norm(np_val-np_ref) > tol*np.linalg.norm(np_ref):
+                result = False
+    for k in range(2):
+        for ts in tensors[k]:
+            for t in ts:
+                t.unregister()
+    return result
+
+# Helper function for moments of fp32 parameters stored in bf16
+def helper_bf16(decoupled):
+    shapes = [[7], [5, 6], [20, 3]]
+    basetiles = [[2], [5, 2], [20, 3]]
+    nsteps = 3
+    lr, eps, beta1, beta2, weight_decay = 1e-2, 1e-8, 0.9, 0.999, 0.1
+    next_tag = 0
+    # Moments of tensors[0] are in bf16, while moments of tensors[1] are in
+    # fp32
+    tensors = [[], []]
+    for shape, basetile in zip(shapes, basetiles):
+        traits = nntile.tensor.TensorTraits(shape, basetile)
+        distr = [0] * traits.grid.nelems
+        np_p = np.array(np.random.randn(*shape), dtype=np.float32, \
+                order='F')
+        for k in range(2):
+            ts = []
+            for i in range(4):
+                if k == 0 and i in (1, 2):
+                    ts.append(nntile.tensor.Tensor_bf16(traits, distr, \
+                            next_tag))
+                else:
+                    ts.append(nntile.tensor.Tensor_fp32(traits, distr, \
+                            next_tag))
+                next_tag = ts[-1].next_tag
+            ts[3].from_array(np_p)
+            tensors[k].append(ts)
+    for num_iter in range(1, nsteps+1):
+        for j, shape in enumerate(shapes):
+            np_grad = np.array(np.random.randn(*shape), dtype=np.float32, \
+                    order='F')
+            tensors[0][j][0].from_array(np_grad)
+            tensors[1][j][0].from_array(np_grad)
+        for k in range(2):
+            grad, first, second, p = [[ts[i] for ts in tensors[k]] \
+                    for i in range(4)]
+            nntile.tensor.fused_multi_adam_step(p, grad, first, second, lr, \
+                    eps, beta1, beta2, weight_decay, num_iter, \
+                    decoupled=decoupled, pack_nelems=16)
+    # Moments are rounded to 8 bits of mantissa, that slightly changes
+    # updates of parameters
+    result = True
+    for j, shape in enumerate(shapes):
+        for i, tol in ((1, 1e-2), (2, 1e-2), (3, 1e-3)):
+            np_val = np.zeros(shape, dtype=np.float32, order='F')
+            np_ref = np.zeros(shape, dtype=np.float32, order='F')
+            tensors[0][j][i].to_array(np_val)
+            tensors[1][j][i].to_array(np_ref)
+            if np.linalg.norm(np_val-np_ref) > tol*np.linalg.norm(np_ref):
+                result = False
+    for k in range(2):
+        for ts in tensors[k]:
+            for t in ts:
+                t.unregister()
+    return result
+
+# Test runner for different precisions
+def test():
+    for dtype in dtypes:
+        assert helper(dtype, False, 16)
+        assert helper(dtype, True, 16)
+        assert helper(dtype, False, 0)
+    assert helper_bf16(False)
+    assert helper_bf16(True)
+
+# Repeat tests
+def test_repeat():
+    for dtype in dtypes:
+        assert helper(dtype, False, 1000)
+        assert helper(dtype, True, 1000)
+
+if __name__ == "__main__":
+    test()
+    test_repeat()
+
@@ -0,0 +1,137 @@
+# @copyright (c) 2022-2023 Skolkovo Institute of Science and Technology
+#                           (Skoltech). All rights reserved.
+#
+# NNTile is software framework for fast training of big neural networks on
+# distributed-memory heterogeneous systems based on StarPU runtime system.
+#
+# @file wrappers/python/tests/nntile_core/test_tensor_sparse_adam_step.py
+# Test for tensor::sparse_adam_step<T> Python wrapper
+#
+# @version 1.0.0
+# @author Aleksandr Mikhalev
+# @date 2023-12-21
+
+# All necesary imports
+import nntile
+import numpy as np
+# Set up StarPU configuration and init it
+config = nntile.starpu.Config(1, 0, 0)
+# Init all NNTile-StarPU codelets
+nntile.starpu.init()
+# Define list of tested types
+dtypes = [np.float32, np.float64]
+# Define mapping between numpy and nntile types
+Tensor = {np.float32: nntile.tensor.Tensor_fp32,
+        np.float64: nntile.tensor.Tensor_fp64}
+
+# Helper function returns bool value true if test passes
+def helper(dtype, decoupled):
+    # Table of embeddings of shape [embed, vocab] is split into tiles along
+    # embed only, as in the Embedding layer
+    embed, embed_tile = 5, 3
+    vocab, vocab_tile = 12, 12
+    ntokens, ntokens_tile = 6, 4
+    nsteps = 3
+    lr, eps, beta1, beta2, weight_decay = 1e-2, 1e-8, 0.9, 0.999, 0.1
+    next_tag = 0
+    traits = nntile.tensor.TensorTraits([embed, vocab], \
+            [embed_tile, vocab_tile])
+    distr = [0] * traits.grid.nelems
+    tensors = []
+    for i in range(4):
+        tensors.append(Tensor[dtype](traits, distr, next_tag))
+        next_tag = tensors[-1].next_tag
+    p, grad, first_moment, second_moment = tensors
+    rows_traits = nntile.tensor.TensorTraits([vocab], [vocab_tile])
+    rows = nntile.tensor.Tensor_bool(rows_traits, [0], next_tag)
+    next_tag = rows.next_tag
+    row_step_traits = nntile.tensor.TensorTraits( \
+            [traits.grid.shape[0], vocab], [1, vocab_tile])
+    row_step = nntile.tensor.Tensor_int64(row_step_traits, distr, next_tag)
+    next_tag = row_step.next_tag
+    index_traits = nntile.tensor.TensorTraits([ntokens], [ntokens_tile])
+    index = nntile.tensor.Tensor_int64(index_traits, \
+            [0]*index_traits.grid.nelems, next_tag)
+    next_tag = index.next_tag
+    # Init data
+    np_p = np.array(np.random.randn(embed, vocab), dtype=dtype, order='F')
+    p.from_array(np_p)
+    nntile.tensor.clear_async(grad)
+    nntile.tensor.clear_async(rows)
+    nntile.tensor.clear_async(row_step)
+    # Reference lazy Adam keeps a step counter per row
+    p_ref = np_p.copy()
+    first_ref = np.zeros_like(np_p)
+    second_ref = np.zeros_like(np_p)
+    step_ref = np.zeros(vocab, dtype=np.int64)
+    for step in range(nsteps):
+        np_index = np.array(np.random.randint(0, vocab, ntokens), \
+                dtype=np.int64, order='F')
+        np_rows = np.zeros(vocab, dtype=bool)
+        np_rows[np_index] = True
+        np_grad = np.array(np.random.randn(embed, vocab), dtype=dtype, \
+                order='F')
+        np_grad[:, ~np_rows] = 0
+        index.from_array(np_index)
+        grad.from_array(np_grad)
+        nntile.tensor.embedding_rows_async(index, rows)
+        nntile.tensor.fused_sparse_adam_step(p, grad, first_moment, \
+                second_moment, rows, row_step, lr, eps, beta1, beta2, \
+                weight_decay, decoupled)
+        # Gradient of marked rows is cleared and marks are dropped
+        nntile.tensor.clear_rows_async(rows, grad)
+        nntile.tensor.clear_async(rows)
+        np_grad_cleared = np.ones_like(np_grad)
+        grad.to_array(np_grad_cleared)
+        if np.any(np_grad_cleared != 0):
+            return False
+        for j in np.nonzero(np_rows)[0]:
+            step_ref[j] += 1
+            t = step_ref[j]
+            g = np_grad[:, j].copy()
+            if decoupled:
+                p_ref[:, j] *= 1 - lr*weight_decay
+            else:
+                g += weight_decay * p_ref[:, j]
+            first_ref[:, j] = beta1*first_ref[:, j] + (1-beta1)*g
+            second_ref[:, j] = np.hypot(np.sqrt(beta2)*second_ref[:, j], \
+                    np.sqrt(1-beta2)*g)
+            denom = second_ref[:, j]/np.sqrt(1-beta2**t) + eps
+            p_ref[:, j] -= lr / (1-beta1**t) * first_ref[:, j] / denom
+    np_row_step = np.zeros(row_step.shape, dtype=np.int64, order='F')
+    row_step.to_array(np_row_step)
+    p.to_array(np_p)
+    nntile.starpu.wait_for_all()
+    for t in tensors:
+        t.unregister()
+    rows.unregister()
+    row_step.unregister()
+    index.unregister()
+    # Every tile row of parameters counts steps on its own
+    for i in range(np_row_step.shape[0]):
+        if np.any(np_row_step[i] != step_ref):
+            return False
+    if dtype == np.float32:
+        tol = 1e-5
+    else:
+        tol = 1e-10
+    if np.linalg.norm(np_p-p_ref) > tol*np.linalg.norm(p_ref):
+        return False
+    return True
+
+# Test runner for different precisions
+def test():
+    for dtype in dtypes:
+        assert helper(dtype, False)
+        assert helper(dtype, True)
+
+# Repeat tests
+def test_repeat():
+    for dtype in dtypes:
+        assert helper(dtype, False)
+        assert helper(dtype, True)
+
+if __name__ == "__main__":
+    test()
+    test_repeat()
+